@@ -7,6 +7,7 @@
 #include <string.h>
 #include <limits.h>
 #include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/agenttime.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/xlogging.h"
@@ -35,12 +36,46 @@
 /*Codes_SRS_HTTPAPI_COMPACT_21_079: [ The HTTPAPI_ExecuteRequest shall wait, at least, 20 seconds to send a buffer using the SSL connection. ]*/
 #define MAX_SEND_RETRY   200
 /*Codes_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-#define MAX_RECEIVE_RETRY   200
-/*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-#define RETRY_INTERVAL_IN_MICROSECONDS  100
+#define RECEIVE_TIMEOUT_IN_MILLISECONDS   20000
+/*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries to open, send or close the connection. ]*/
+#define RETRY_INTERVAL_IN_MILLISECONDS  100
+/*Codes_SRS_HTTPAPI_COMPACT_21_096: [ While waiting for the response, the HTTPAPI_ExecuteRequest shall wait 1 millisecond after a dowork that delivered no bytes, and double the wait after each further such dowork, up to 100 milliseconds. ]*/
+#define RECEIVE_FIRST_WAIT_IN_MILLISECONDS  1
 
 DEFINE_ENUM_STRINGS(HTTPAPI_RESULT, HTTPAPI_RESULT_VALUES)
 
+typedef enum RESPONSE_PARSER_STATE_TAG
+{
+    RESPONSE_PARSER_STATE_IDLE,
+    RESPONSE_PARSER_STATE_STATUS_LINE,
+    RESPONSE_PARSER_STATE_HEADERS,
+    RESPONSE_PARSER_STATE_BODY,
+    RESPONSE_PARSER_STATE_CHUNK_SIZE,
+    RESPONSE_PARSER_STATE_CHUNK_DATA,
+    RESPONSE_PARSER_STATE_CHUNK_DATA_END,
+    RESPONSE_PARSER_STATE_CHUNK_TRAILER,
+    RESPONSE_PARSER_STATE_DONE,
+    RESPONSE_PARSER_STATE_ERROR
+} RESPONSE_PARSER_STATE;
+
+/* The response is parsed incrementally as the bytes arrive from the xio, so nothing is buffered except a partial line. */
+typedef struct RESPONSE_PARSER_TAG
+{
+    RESPONSE_PARSER_STATE   state;
+    HTTPAPI_RESULT          error;
+    unsigned int*           statusCode;
+    HTTP_HEADERS_HANDLE     responseHeadersHandle;
+    BUFFER_HANDLE           responseContent;
+    size_t                  bodyLength;
+    size_t                  remaining;
+    size_t                  contentOffset;
+    bool                    chunked;
+    bool                    connectionClose;
+    unsigned int            keepAliveTimeout;
+    size_t                  lineLength;
+    char                    line[TEMP_BUFFER_SIZE];
+} RESPONSE_PARSER;
+
 typedef struct HTTP_HANDLE_DATA_TAG
 {
     char*           certificate;
@@ -48,10 +83,15 @@ typedef struct HTTP_HANDLE_DATA_TAG
     char*           x509ClientPrivateKey;
     XIO_HANDLE      xio_handle;
     size_t          received_bytes_count;
-    unsigned char*  received_bytes;
+    RESPONSE_PARSER response_parser;
+    unsigned int    keep_alive_idle_timeout;
+    unsigned int    connection_idle_timeout;
+    time_t          last_response_time;
     unsigned int    is_io_error : 1;
     unsigned int    is_connected : 1;
     unsigned int    send_completed : 1;
+    unsigned int    keep_alive : 1;
+    unsigned int    must_reconnect : 1;
 } HTTP_HANDLE_DATA;
 
 /*the following function does the same as sscanf(pos2, "%d", &sec)*/
@@ -239,7 +279,12 @@ HTTP_HANDLE HTTPAPI_CreateConnection(const char* hostName)
                 http_instance->is_connected = 0;
                 http_instance->is_io_error = 0;
                 http_instance->received_bytes_count = 0;
-                http_instance->received_bytes = NULL;
+                http_instance->response_parser.state = RESPONSE_PARSER_STATE_IDLE;
+                http_instance->keep_alive = 1;
+                http_instance->must_reconnect = 0;
+                http_instance->keep_alive_idle_timeout = 0;
+                http_instance->connection_idle_timeout = 0;
+                http_instance->last_response_time = (time_t)0;
                 http_instance->certificate = NULL;
                 http_instance->x509ClientCertificate = NULL;
                 http_instance->x509ClientPrivateKey = NULL;
@@ -261,6 +306,45 @@ static void on_io_close_complete(void* context)
     }
 }
 
+static void CloseXIOConnection(HTTP_HANDLE_DATA* http_instance)
+{
+    http_instance->is_io_error = 0;
+    /*Codes_SRS_HTTPAPI_COMPACT_21_017: [ The HTTPAPI_CloseConnection shall close the connection previously created in HTTPAPI_ExecuteRequest. ]*/
+    if (xio_close(http_instance->xio_handle, on_io_close_complete, http_instance) != 0)
+    {
+        LogError("The SSL got error closing the connection");
+        /*Codes_SRS_HTTPAPI_COMPACT_21_087: [ If the xio return anything different than 0, the HTTPAPI_CloseConnection shall destroy the connection anyway. ]*/
+        http_instance->is_connected = 0;
+    }
+    else
+    {
+        /*Codes_SRS_HTTPAPI_COMPACT_21_084: [ The HTTPAPI_CloseConnection shall wait, at least, 10 seconds for the SSL close process. ]*/
+        int countRetry = MAX_CLOSE_RETRY;
+        while (http_instance->is_connected == 1)
+        {
+            xio_dowork(http_instance->xio_handle);
+            if ((countRetry--) < 0)
+            {
+                /*Codes_SRS_HTTPAPI_COMPACT_21_085: [ If the HTTPAPI_CloseConnection retries 10 seconds to close the connection without success, it shall destroy the connection anyway. ]*/
+                LogError("Close timeout. The SSL didn't close the connection");
+                http_instance->is_connected = 0;
+            }
+            else if (http_instance->is_io_error == 1)
+            {
+                LogError("The SSL got error closing the connection");
+                http_instance->is_connected = 0;
+            }
+            else if (http_instance->is_connected == 1)
+            {
+                LogInfo("Waiting for TLS close connection");
+                /*Codes_SRS_HTTPAPI_COMPACT_21_086: [ The HTTPAPI_CloseConnection shall wait, at least, 100 milliseconds between retries. ]*/
+                ThreadAPI_Sleep(RETRY_INTERVAL_IN_MILLISECONDS);
+            }
+        }
+    }
+    http_instance->must_reconnect = 0;
+}
+
 void HTTPAPI_CloseConnection(HTTP_HANDLE handle)
 {
     HTTP_HANDLE_DATA* http_instance = (HTTP_HANDLE_DATA*)handle;
@@ -271,40 +355,7 @@ void HTTPAPI_CloseConnection(HTTP_HANDLE handle)
         /*Codes_SRS_HTTPAPI_COMPACT_21_019: [ If there is no previous connection, the HTTPAPI_CloseConnection shall not do anything. ]*/
         if (http_instance->xio_handle != NULL)
         {
-            http_instance->is_io_error = 0;
-            /*Codes_SRS_HTTPAPI_COMPACT_21_017: [ The HTTPAPI_CloseConnection shall close the connection previously created in HTTPAPI_ExecuteRequest. ]*/
-            if (xio_close(http_instance->xio_handle, on_io_close_complete, http_instance) != 0)
-            {
-                LogError("The SSL got error closing the connection");
-                /*Codes_SRS_HTTPAPI_COMPACT_21_087: [ If the xio return anything different than 0, the HTTPAPI_CloseConnection shall destroy the connection anyway. ]*/
-                http_instance->is_connected = 0;
-            }
-            else
-            {
-                /*Codes_SRS_HTTPAPI_COMPACT_21_084: [ The HTTPAPI_CloseConnection shall wait, at least, 10 seconds for the SSL close process. ]*/
-                int countRetry = MAX_CLOSE_RETRY;
-                while (http_instance->is_connected == 1)
-                {
-                    xio_dowork(http_instance->xio_handle);
-                    if ((countRetry--) < 0)
-                    {
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_085: [ If the HTTPAPI_CloseConnection retries 10 seconds to close the connection without success, it shall destroy the connection anyway. ]*/
-                        LogError("Close timeout. The SSL didn't close the connection");
-                        http_instance->is_connected = 0;
-                    }
-                    else if (http_instance->is_io_error == 1)
-                    {
-                        LogError("The SSL got error closing the connection");
-                        http_instance->is_connected = 0;
-                    }
-                    else if (http_instance->is_connected == 1)
-                    {
-                        LogInfo("Waiting for TLS close connection");
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_086: [ The HTTPAPI_CloseConnection shall wait, at least, 100 milliseconds between retries. ]*/
-                        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MICROSECONDS);
-                    }
-                }
-            }
+            CloseXIOConnection(http_instance);
             /*Codes_SRS_HTTPAPI_COMPACT_21_076: [ After close the connection, The HTTPAPI_CloseConnection shall destroy the connection previously created in HTTPAPI_CreateConnection. ]*/
             xio_destroy(http_instance->xio_handle);
         }
@@ -394,298 +445,361 @@ static int InternStrnicmp(const char* s1, const char* s2, size_t n)
     return result;
 }
 
-static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+static void SetResponseParserError(RESPONSE_PARSER* parser, HTTPAPI_RESULT error)
 {
-    unsigned char* new_received_bytes;
-    HTTP_HANDLE_DATA* http_instance = (HTTP_HANDLE_DATA*)context;
-
-    if (http_instance != NULL)
-    {
+    parser->state = RESPONSE_PARSER_STATE_ERROR;
+    parser->error = error;
+}
 
-        if (buffer == NULL)
-        {
-            http_instance->is_io_error = 1;
-            LogError("NULL pointer error");
-        }
-        else
-        {
-            /* Here we got some bytes so we'll buffer them so the receive functions can consumer it */
-            new_received_bytes = (unsigned char*)realloc(http_instance->received_bytes, http_instance->received_bytes_count + size);
-            if (new_received_bytes == NULL)
-            {
-                http_instance->is_io_error = 1;
-                LogError("Error allocating memory for received data");
-            }
-            else
-            {
-                http_instance->received_bytes = new_received_bytes;
-                if (memcpy(http_instance->received_bytes + http_instance->received_bytes_count, buffer, size) == NULL)
-                {
-                    http_instance->is_io_error = 1;
-                    LogError("Error copping received data to the HTTP bufffer");
-                }
-                else
-                {
-                    http_instance->received_bytes_count += size;
-                }
-            }
-        }
-    }
+static void StartResponseParser(HTTP_HANDLE_DATA* http_instance, unsigned int* statusCode, HTTP_HEADERS_HANDLE responseHeadersHandle, BUFFER_HANDLE responseContent)
+{
+    RESPONSE_PARSER* parser = &http_instance->response_parser;
+
+    parser->state = RESPONSE_PARSER_STATE_STATUS_LINE;
+    parser->error = HTTPAPI_OK;
+    parser->statusCode = statusCode;
+    parser->responseHeadersHandle = responseHeadersHandle;
+    parser->responseContent = responseContent;
+    parser->bodyLength = 0;
+    parser->remaining = 0;
+    parser->contentOffset = 0;
+    parser->chunked = false;
+    parser->connectionClose = false;
+    parser->keepAliveTimeout = 0;
+    parser->lineLength = 0;
 }
 
-static void on_io_error(void* context)
+static bool IsResponseParserFinished(const RESPONSE_PARSER* parser)
 {
-    HTTP_HANDLE_DATA* http_instance = (HTTP_HANDLE_DATA*)context;
-    if (http_instance != NULL)
-    {
-        http_instance->is_io_error = 1;
-        LogError("Error signalled by underlying IO");
-    }
+    return ((parser->state == RESPONSE_PARSER_STATE_IDLE) ||
+        (parser->state == RESPONSE_PARSER_STATE_DONE) ||
+        (parser->state == RESPONSE_PARSER_STATE_ERROR));
 }
 
-static int conn_receive(HTTP_HANDLE_DATA* http_instance, char* buffer, int count)
+/*Codes_SRS_HTTPAPI_COMPACT_21_073: [ The message received by the HTTPAPI_ExecuteRequest shall starts with a valid header. ]*/
+static void ParseStatusLine(RESPONSE_PARSER* parser)
 {
-    int result;
+    int ret;
 
-    if ((http_instance == NULL) || (buffer == NULL) || (count < 0))
+    if (ParseHttpResponse(parser->line, &ret) != 1)
     {
-        LogError("conn_receive: %s", ((http_instance == NULL) ? "Invalid HTTP instance" : "Invalid HTTP buffer"));
-        result = -1;
+        //Cannot match string, error
+        /*Codes_SRS_HTTPAPI_COMPACT_21_055: [ If the HTTPAPI_ExecuteRequest cannot parser the received message, it shall return HTTPAPI_RECEIVE_RESPONSE_FAILED. ]*/
+        LogInfo("Not a correct HTTP answer");
+        SetResponseParserError(parser, HTTPAPI_RECEIVE_RESPONSE_FAILED);
     }
     else
     {
-        result = 0;
-        while (result < count)
+        /*Codes_SRS_HTTPAPI_COMPACT_21_046: [ The HTTPAPI_ExecuteRequest shall return the http status reported by the host in the received response. ]*/
+        /*Codes_SRS_HTTPAPI_COMPACT_21_048: [ If the statusCode is NULL, the HTTPAPI_ExecuteRequest shall report not report any status. ]*/
+        if (parser->statusCode)
         {
-            xio_dowork(http_instance->xio_handle);
-
-            /* if any error was detected while receiving then simply break and report it */
-            if (http_instance->is_io_error != 0)
-            {
-                LogError("xio reported error on dowork");
-                result = -1;
-                break;
-            }
-
-            if (http_instance->received_bytes_count >= (size_t)count)
-            {
-                /* Consuming bytes from the receive buffer */
-                (void)memcpy(buffer, http_instance->received_bytes, count);
-                (void)memmove(http_instance->received_bytes, http_instance->received_bytes + count, http_instance->received_bytes_count - count);
-                http_instance->received_bytes_count -= count;
-
-                /* we're not reallocating at each consumption so that we don't trash due to byte by byte consumption */
-                if (http_instance->received_bytes_count == 0)
-                {
-                    free(http_instance->received_bytes);
-                    http_instance->received_bytes = NULL;
-                }
-
-                result = count;
-                break;
-            }
-
-            /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-            ThreadAPI_Sleep(RETRY_INTERVAL_IN_MICROSECONDS);
+            /*Codes_SRS_HTTPAPI_COMPACT_21_047: [ The HTTPAPI_ExecuteRequest shall report the status in the statusCode parameter. ]*/
+            *parser->statusCode = ret;
         }
+        /* HTTP/1.0 hosts close the connection unless they say otherwise in a Connection header */
+        parser->connectionClose = (strncmp(parser->line, "HTTP/1.0", 8) == 0);
+        parser->state = RESPONSE_PARSER_STATE_HEADERS;
     }
-
-    return result;
 }
 
-static void conn_receive_discard_buffer(HTTP_HANDLE_DATA* http_instance)
+/*Codes_SRS_HTTPAPI_COMPACT_21_075: [ The message received by the HTTPAPI_ExecuteRequest can contain a body with the message content. ]*/
+static void StartResponseBody(RESPONSE_PARSER* parser)
 {
-    if (http_instance != NULL)
+    if (parser->chunked)
     {
-        if (http_instance->received_bytes != NULL)
-        {
-            free(http_instance->received_bytes);
-            http_instance->received_bytes = NULL;
-        }
-        http_instance->received_bytes_count = 0;
+        parser->state = RESPONSE_PARSER_STATE_CHUNK_SIZE;
+    }
+    else if (parser->bodyLength == 0)
+    {
+        /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
+        parser->state = RESPONSE_PARSER_STATE_DONE;
+    }
+    else if ((parser->responseContent != NULL) &&
+        (BUFFER_pre_build(parser->responseContent, parser->bodyLength) != 0))
+    {
+        /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
+        SetResponseParserError(parser, HTTPAPI_ALLOC_FAILED);
+    }
+    else
+    {
+        parser->remaining = parser->bodyLength;
+        parser->state = RESPONSE_PARSER_STATE_BODY;
     }
 }
 
-static int readLine(HTTP_HANDLE_DATA* http_instance, char* buf, const size_t maxBufSize)
+/*Codes_SRS_HTTPAPI_COMPACT_21_074: [ After the header, the message received by the HTTPAPI_ExecuteRequest can contain addition information about the content. ]*/
+static void ParseHeaderLine(RESPONSE_PARSER* parser)
 {
-    int resultLineSize;
+    char* buf = parser->line;
+    const char* substr;
+    char* whereIsColon;
+    int lengthInMsg;
+    const char ContentLength[] = "content-length:";
+    const size_t ContentLengthSize = sizeof(ContentLength) - 1;
+    const char TransferEncoding[] = "transfer-encoding:";
+    const size_t TransferEncodingSize = sizeof(TransferEncoding) - 1;
+    const char Chunked[] = "chunked";
+    const size_t ChunkedSize = sizeof(Chunked) - 1;
+    const char Connection[] = "connection:";
+    const size_t ConnectionSize = sizeof(Connection) - 1;
+    const char KeepAlive[] = "keep-alive:";
+    const size_t KeepAliveSize = sizeof(KeepAlive) - 1;
 
-    if ((http_instance == NULL) || (buf == NULL) || (maxBufSize == 0))
+    if (*buf == '\0')
     {
-        LogError("%s", ((http_instance == NULL) ? "Invalid HTTP instance" : "Invalid HTTP buffer"));
-        resultLineSize = -1;
+        StartResponseBody(parser);
     }
     else
     {
-        char* destByte = buf;
-        /*Codes_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-        int countRetry = MAX_RECEIVE_RETRY;
-        bool endOfSearch = false;
-        resultLineSize = -1;
-        while (!endOfSearch)
+        if (InternStrnicmp(buf, ContentLength, ContentLengthSize) == 0)
         {
-            xio_dowork(http_instance->xio_handle);
-
-            /* if any error was detected while receiving then simply break and report it */
-            if (http_instance->is_io_error != 0)
+            substr = buf + ContentLengthSize;
+            if ((ParseStringToDecimal(substr, &lengthInMsg) != 1) || (lengthInMsg < 0))
             {
-                LogError("xio reported error on dowork");
-                endOfSearch = true;
+                /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
+                SetResponseParserError(parser, HTTPAPI_READ_DATA_FAILED);
             }
             else
             {
-                unsigned char* receivedByte = http_instance->received_bytes;
-                while (receivedByte < (http_instance->received_bytes + http_instance->received_bytes_count))
-                {
-                    if ((*receivedByte) != '\r')
-                    {
-                        (*destByte) = (*receivedByte);
-                        destByte++;
-                        receivedByte++;
-
-                        if (destByte >= (buf + maxBufSize - 1))
-                        {
-                            LogError("Received message is bigger than the http buffer");
-                            receivedByte = http_instance->received_bytes + http_instance->received_bytes_count;
-                            endOfSearch = true;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        receivedByte++;
-                        if ((receivedByte < (http_instance->received_bytes + http_instance->received_bytes_count)) && ((*receivedByte) == '\n'))
-                        {
-                            receivedByte++;
-                        }
-                        (*destByte) = '\0';
-                        resultLineSize = (int)(destByte - buf);
-                        endOfSearch = true;
-                        break;
-                    }
-                }
+                parser->bodyLength = (size_t)lengthInMsg;
+            }
+        }
+        else if (InternStrnicmp(buf, TransferEncoding, TransferEncodingSize) == 0)
+        {
+            substr = buf + TransferEncodingSize;
 
-                http_instance->received_bytes_count -= (receivedByte - http_instance->received_bytes);
-                if (http_instance->received_bytes_count != 0)
-                {
-                    (void)memmove(http_instance->received_bytes, receivedByte, http_instance->received_bytes_count);
-                }
-                else
-                {
-                    conn_receive_discard_buffer(http_instance);
-                }
+            while (isspace(*substr)) substr++;
+
+            if (InternStrnicmp(substr, Chunked, ChunkedSize) == 0)
+            {
+                parser->chunked = true;
             }
+        }
+        /*Codes_SRS_HTTPAPI_COMPACT_21_090: [ If the response contains the header `Connection: close`, the HTTPAPI_ExecuteRequest shall close the connection before the next request. ]*/
+        else if (InternStrnicmp(buf, Connection, ConnectionSize) == 0)
+        {
+            substr = buf + ConnectionSize;
 
-            if (!endOfSearch)
+            while (isspace(*substr)) substr++;
+
+            if (InternStrnicmp(substr, "close", 5) == 0)
             {
-                if ((countRetry--) > 0)
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                    ThreadAPI_Sleep(RETRY_INTERVAL_IN_MICROSECONDS);
-                }
-                else
+                parser->connectionClose = true;
+            }
+            else if (InternStrnicmp(substr, "keep-alive", 10) == 0)
+            {
+                parser->connectionClose = false;
+            }
+        }
+        /*Codes_SRS_HTTPAPI_COMPACT_21_091: [ If the response contains a `Keep-Alive` header with a `timeout` parameter, the HTTPAPI_ExecuteRequest shall not reuse the connection once it was idle for that many seconds. ]*/
+        else if (InternStrnicmp(buf, KeepAlive, KeepAliveSize) == 0)
+        {
+            for (substr = buf + KeepAliveSize; *substr != '\0'; substr++)
+            {
+                if ((InternStrnicmp(substr, "timeout=", 8) == 0) &&
+                    (ParseStringToDecimal(substr + 8, &lengthInMsg) == 1) &&
+                    (lengthInMsg > 0))
                 {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-                    LogError("Receive timeout. The HTTP request is incomplete");
-                    endOfSearch = true;
+                    parser->keepAliveTimeout = (unsigned int)lengthInMsg;
+                    break;
                 }
             }
         }
-    }
 
-    return resultLineSize;
+        if (parser->state != RESPONSE_PARSER_STATE_ERROR)
+        {
+            whereIsColon = strchr(buf, ':');
+            /*Codes_SRS_HTTPAPI_COMPACT_21_049: [ If responseHeadersHandle is provide, the HTTPAPI_ExecuteRequest shall prepare a Response Header usign the HTTPHeaders_AddHeaderNameValuePair. ]*/
+            if (whereIsColon && (parser->responseHeadersHandle != NULL))
+            {
+                *whereIsColon = '\0';
+                HTTPHeaders_AddHeaderNameValuePair(parser->responseHeadersHandle, buf, whereIsColon + 1);
+            }
+        }
+    }
 }
 
-static int readChunk(HTTP_HANDLE_DATA* http_instance, char* buf, size_t size)
+static void ParseChunkSizeLine(RESPONSE_PARSER* parser)
 {
-    int cur, offset;
+    size_t chunkSize;
+
+    if (ParseStringToHexadecimal(parser->line, &chunkSize) != 1)     // chunkSize is length of next line (/r/n is not counted)
+    {
+        //Cannot match string, error
+        /*Codes_SRS_HTTPAPI_COMPACT_21_055: [ If the HTTPAPI_ExecuteRequest cannot parser the received message, it shall return HTTPAPI_RECEIVE_RESPONSE_FAILED. ]*/
+        SetResponseParserError(parser, HTTPAPI_RECEIVE_RESPONSE_FAILED);
+    }
+    else if (chunkSize == 0)
+    {
+        // 0 length means the chunks are over; only the (empty) trailer is left
+        parser->state = RESPONSE_PARSER_STATE_CHUNK_TRAILER;
+    }
+    else if ((parser->responseContent != NULL) &&
+        (BUFFER_enlarge(parser->responseContent, chunkSize) != 0))
+    {
+        (void)BUFFER_unbuild(parser->responseContent);
 
-    // read content with specified length, even if it is received
-    // only in chunks due to fragmentation in the networking layer.
-    // returns -1 in case of error.
-    offset = 0;
-    while (size > (size_t)0)
+        /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
+        SetResponseParserError(parser, HTTPAPI_ALLOC_FAILED);
+    }
+    else
     {
-        cur = conn_receive(http_instance, buf + offset, (int)size);
+        parser->remaining = chunkSize;
+        parser->state = RESPONSE_PARSER_STATE_CHUNK_DATA;
+    }
+}
 
-        // end of stream reached
-        if (cur == 0)
+static void ParseResponseLine(RESPONSE_PARSER* parser)
+{
+    switch (parser->state)
+    {
+    case RESPONSE_PARSER_STATE_STATUS_LINE:
+        ParseStatusLine(parser);
+        break;
+    case RESPONSE_PARSER_STATE_HEADERS:
+        ParseHeaderLine(parser);
+        break;
+    case RESPONSE_PARSER_STATE_CHUNK_SIZE:
+        ParseChunkSizeLine(parser);
+        break;
+    case RESPONSE_PARSER_STATE_CHUNK_DATA_END:
+        if (parser->line[0] != '\0') // skip /r/n
         {
-            break;
+            SetResponseParserError(parser, HTTPAPI_READ_DATA_FAILED);
         }
-
-        // read cur bytes (might be less than requested)
-        size -= (size_t)cur;
-        offset += cur;
+        else
+        {
+            parser->state = RESPONSE_PARSER_STATE_CHUNK_SIZE;
+        }
+        break;
+    case RESPONSE_PARSER_STATE_CHUNK_TRAILER:
+        if (parser->line[0] == '\0')
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
+            parser->state = RESPONSE_PARSER_STATE_DONE;
+        }
+        break;
+    default:
+        break;
     }
-
-    return offset;
 }
 
-static int skipN(HTTP_HANDLE_DATA* http_instance, size_t n)
+/*Codes_SRS_HTTPAPI_COMPACT_21_050: [ If there is a content in the response, the HTTPAPI_ExecuteRequest shall copy it in the responseContent buffer. ]*/
+static size_t ParseResponseContent(RESPONSE_PARSER* parser, const unsigned char* buffer, size_t size)
 {
-    // read and abandon response content with specified length
-    // returns -1 in case of error.
+    size_t consumed = (size < parser->remaining) ? size : parser->remaining;
+    const unsigned char* receivedContent;
 
-    int result;
+    /*Codes_SRS_HTTPAPI_COMPACT_21_051: [ If the responseContent is NULL, the HTTPAPI_ExecuteRequest shall ignore any content in the response. ]*/
+    if (parser->responseContent != NULL)
+    {
+        if ((BUFFER_content(parser->responseContent, &receivedContent) != 0) || (receivedContent == NULL))
+        {
+            (void)BUFFER_unbuild(parser->responseContent);
 
-    if (http_instance == NULL)
+            /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
+            SetResponseParserError(parser, HTTPAPI_ALLOC_FAILED);
+        }
+        else
+        {
+            (void)memcpy((unsigned char*)receivedContent + parser->contentOffset, buffer, consumed);
+        }
+    }
+
+    if (parser->state != RESPONSE_PARSER_STATE_ERROR)
     {
-        LogError("Invalid HTTP instance");
-        result = -1;
+        parser->contentOffset += consumed;
+        parser->remaining -= consumed;
+        if (parser->remaining == 0)
+        {
+            parser->state = (parser->state == RESPONSE_PARSER_STATE_BODY) ? RESPONSE_PARSER_STATE_DONE : RESPONSE_PARSER_STATE_CHUNK_DATA_END;
+        }
     }
-    else
+
+    return consumed;
+}
+
+static void ParseResponseBytes(RESPONSE_PARSER* parser, const unsigned char* buffer, size_t size)
+{
+    size_t position = 0;
+
+    while ((position < size) && !IsResponseParserFinished(parser))
     {
-        /*Codes_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-        int countRetry = MAX_RECEIVE_RETRY;
-        result = (int)n;
-        while (n > 0)
+        if ((parser->state == RESPONSE_PARSER_STATE_BODY) ||
+            (parser->state == RESPONSE_PARSER_STATE_CHUNK_DATA))
         {
-            xio_dowork(http_instance->xio_handle);
+            position += ParseResponseContent(parser, buffer + position, size - position);
+        }
+        else
+        {
+            const unsigned char* endOfLine = (const unsigned char*)memchr(buffer + position, '\n', size - position);
+            size_t segmentSize = (endOfLine == NULL) ? (size - position) : (size_t)(endOfLine - (buffer + position));
 
-            /* if any error was detected while receiving then simply break and report it */
-            if (http_instance->is_io_error != 0)
+            if ((parser->lineLength + segmentSize) >= sizeof(parser->line))
             {
-                LogError("xio reported error on dowork");
-                result = -1;
-                n = 0;
+                LogError("Received message is bigger than the http buffer");
+                SetResponseParserError(parser, HTTPAPI_READ_DATA_FAILED);
             }
             else
             {
-                if (http_instance->received_bytes_count <= n)
-                {
-                    n -= http_instance->received_bytes_count;
-                    http_instance->received_bytes_count = 0;
-                }
-                else
-                {
-                    http_instance->received_bytes_count -= n;
-                    (void)memmove(http_instance->received_bytes, http_instance->received_bytes + n, http_instance->received_bytes_count);
-                    n = 0;
-                }
+                (void)memcpy(parser->line + parser->lineLength, buffer + position, segmentSize);
+                parser->lineLength += segmentSize;
+                position += segmentSize;
 
-                if (n > 0)
+                if (endOfLine != NULL)
                 {
-                    if ((countRetry--) > 0)
-                    {
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MICROSECONDS);
-                    }
-                    else
+                    position++;
+                    if ((parser->lineLength > 0) && (parser->line[parser->lineLength - 1] == '\r'))
                     {
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-                        LogError("Receive timeout. The HTTP request is incomplete");
-                        n = 0;
-                        result = -1;
+                        parser->lineLength--;
                     }
+                    parser->line[parser->lineLength] = '\0';
+                    parser->lineLength = 0;
+                    ParseResponseLine(parser);
                 }
             }
         }
     }
+}
 
-    return result;
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    HTTP_HANDLE_DATA* http_instance = (HTTP_HANDLE_DATA*)context;
+
+    if (http_instance != NULL)
+    {
+
+        if (buffer == NULL)
+        {
+            http_instance->is_io_error = 1;
+            LogError("NULL pointer error");
+        }
+        else
+        {
+            /* Here we got some bytes, so we feed them straight into the response parser */
+            http_instance->received_bytes_count += size;
+            if (IsResponseParserFinished(&http_instance->response_parser))
+            {
+                LogInfo("Discarding %lu bytes received outside of a response", (unsigned long)size);
+            }
+            else
+            {
+                ParseResponseBytes(&http_instance->response_parser, buffer, size);
+            }
+        }
+    }
 }
 
+static void on_io_error(void* context)
+{
+    HTTP_HANDLE_DATA* http_instance = (HTTP_HANDLE_DATA*)context;
+    if (http_instance != NULL)
+    {
+        http_instance->is_io_error = 1;
+        LogError("Error signalled by underlying IO");
+    }
+}
 
 /*Codes_SRS_HTTPAPI_COMPACT_21_021: [ The HTTPAPI_ExecuteRequest shall execute the http communtication with the provided host, sending a request and reciving the response. ]*/
 static HTTPAPI_RESULT OpenXIOConnection(HTTP_HANDLE_DATA* http_instance)
@@ -754,8 +868,8 @@ static HTTPAPI_RESULT OpenXIOConnection(HTTP_HANDLE_DATA* http_instance)
                     }
                     else
                     {
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MICROSECONDS);
+                        /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries to open, send or close the connection. ]*/
+                        ThreadAPI_Sleep(RETRY_INTERVAL_IN_MILLISECONDS);
                     }
                 }
             }
@@ -805,8 +919,8 @@ static HTTPAPI_RESULT conn_send_all(HTTP_HANDLE_DATA* http_instance, const unsig
             }
             else
             {
-                /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-                ThreadAPI_Sleep(RETRY_INTERVAL_IN_MICROSECONDS);
+                /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries to open, send or close the connection. ]*/
+                ThreadAPI_Sleep(RETRY_INTERVAL_IN_MILLISECONDS);
             }
         }
     }
@@ -892,279 +1006,191 @@ static HTTPAPI_RESULT SendContentToXIO(HTTP_HANDLE_DATA* http_instance, const un
 }
 
 /*Codes_SRS_HTTPAPI_COMPACT_21_030: [ At the end of the transmission, the HTTPAPI_ExecuteRequest shall receive the response from the host. ]*/
-static HTTPAPI_RESULT ReceiveHeaderFromXIO(HTTP_HANDLE_DATA* http_instance, unsigned int* statusCode)
+static HTTPAPI_RESULT ReceiveResponseFromXIO(HTTP_HANDLE_DATA* http_instance)
 {
     HTTPAPI_RESULT result;
-    char    buf[TEMP_BUFFER_SIZE];
-    int     ret;
+    RESPONSE_PARSER* parser = &http_instance->response_parser;
+    /*Codes_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
+    unsigned int idleTime = 0;
+    unsigned int wait = RECEIVE_FIRST_WAIT_IN_MILLISECONDS;
+
+    /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
+    result = HTTPAPI_OK;
+    while ((result == HTTPAPI_OK) && !IsResponseParserFinished(parser))
+    {
+        size_t receivedBytesBefore = http_instance->received_bytes_count;
 
-    http_instance->is_io_error = 0;
+        xio_dowork(http_instance->xio_handle);
+
+        /* if any error was detected while receiving then simply break and report it */
+        if (http_instance->is_io_error != 0)
+        {
+            LogError("xio reported error on dowork");
+            /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
+            result = HTTPAPI_READ_DATA_FAILED;
+        }
+        else if (http_instance->received_bytes_count != receivedBytesBefore)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_088: [ If the xio delivered bytes during the last dowork, the HTTPAPI_ExecuteRequest shall call the xio dowork again without waiting. ]*/
+            /*Codes_SRS_HTTPAPI_COMPACT_21_097: [ Once the xio delivered bytes, the HTTPAPI_ExecuteRequest shall restart both the wait and the 20 seconds receive timeout. ]*/
+            idleTime = 0;
+            wait = RECEIVE_FIRST_WAIT_IN_MILLISECONDS;
+        }
+        else if (!IsResponseParserFinished(parser))
+        {
+            if (idleTime < RECEIVE_TIMEOUT_IN_MILLISECONDS)
+            {
+                /*Codes_SRS_HTTPAPI_COMPACT_21_096: [ While waiting for the response, the HTTPAPI_ExecuteRequest shall wait 1 millisecond after a dowork that delivered no bytes, and double the wait after each further such dowork, up to 100 milliseconds. ]*/
+                ThreadAPI_Sleep(wait);
+                idleTime += wait;
+                wait = ((wait * 2) < RETRY_INTERVAL_IN_MILLISECONDS) ? (wait * 2) : RETRY_INTERVAL_IN_MILLISECONDS;
+            }
+            else
+            {
+                /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
+                LogError("Receive timeout. The HTTP request is incomplete");
+                result = HTTPAPI_READ_DATA_FAILED;
+            }
+        }
+    }
 
-    //Receive response
-    if (readLine(http_instance, buf, TEMP_BUFFER_SIZE) < 0)
+    if ((result == HTTPAPI_OK) && (parser->state == RESPONSE_PARSER_STATE_ERROR))
     {
-        /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
-        /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-        result = HTTPAPI_READ_DATA_FAILED;
+        result = parser->error;
     }
-    //Parse HTTP response
-    else if (ParseHttpResponse(buf, &ret) != 1)
+
+    return result;
+}
+
+/*Codes_SRS_HTTPAPI_COMPACT_21_037: [ If the request type is unknown, the HTTPAPI_ExecuteRequest shall return HTTPAPI_INVALID_ARG. ]*/
+static bool validRequestType(HTTPAPI_REQUEST_TYPE requestType)
+{
+    bool result;
+
+    if ((requestType == HTTPAPI_REQUEST_GET) ||
+        (requestType == HTTPAPI_REQUEST_POST) ||
+        (requestType == HTTPAPI_REQUEST_PUT) ||
+        (requestType == HTTPAPI_REQUEST_DELETE) ||
+        (requestType == HTTPAPI_REQUEST_PATCH))
     {
-        //Cannot match string, error
-        /*Codes_SRS_HTTPAPI_COMPACT_21_055: [ If the HTTPAPI_ExecuteRequest cannot parser the received message, it shall return HTTPAPI_RECEIVE_RESPONSE_FAILED. ]*/
-        LogInfo("Not a correct HTTP answer");
-        result = HTTPAPI_RECEIVE_RESPONSE_FAILED;
+        result = true;
     }
     else
     {
-        /*Codes_SRS_HTTPAPI_COMPACT_21_046: [ The HTTPAPI_ExecuteRequest shall return the http status reported by the host in the received response. ]*/
-        /*Codes_SRS_HTTPAPI_COMPACT_21_048: [ If the statusCode is NULL, the HTTPAPI_ExecuteRequest shall report not report any status. ]*/
-        if (statusCode)
-        {
-            /*Codes_SRS_HTTPAPI_COMPACT_21_047: [ The HTTPAPI_ExecuteRequest shall report the status in the statusCode parameter. ]*/
-            *statusCode = ret;
-        }
-        /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
-        result = HTTPAPI_OK;
+        result = false;
     }
 
     return result;
 }
 
-static HTTPAPI_RESULT ReceiveContentInfoFromXIO(HTTP_HANDLE_DATA* http_instance, HTTP_HEADERS_HANDLE responseHeadersHandle, size_t* bodyLength, bool* chunked)
+/*Codes_SRS_HTTPAPI_COMPACT_21_098: [ If the request was completely sent, the HTTPAPI_ExecuteRequest shall only retry it when the request type is `GET` or `DELETE`. ]*/
+static bool isRetriableRequestType(HTTPAPI_REQUEST_TYPE requestType)
 {
-    HTTPAPI_RESULT result;
-    char    buf[TEMP_BUFFER_SIZE];
-    const char* substr;
-    char* whereIsColon;
-    int lengthInMsg;
-    const char ContentLength[] = "content-length:";
-    const size_t ContentLengthSize = sizeof(ContentLength) - 1;
-    const char TransferEncoding[] = "transfer-encoding:";
-    const size_t TransferEncodingSize = sizeof(TransferEncoding) - 1;
-    const char Chunked[] = "chunked";
-    const size_t ChunkedSize = sizeof(Chunked) - 1;
-
-    http_instance->is_io_error = 0;
+    bool result;
 
-    //Read HTTP response headers
-    if (readLine(http_instance, buf, sizeof(buf)) < 0)
+    if ((requestType == HTTPAPI_REQUEST_GET) ||
+        (requestType == HTTPAPI_REQUEST_DELETE))
     {
-        /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
-        /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-        result = HTTPAPI_READ_DATA_FAILED;
+        result = true;
     }
     else
     {
-        /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
-        result = HTTPAPI_OK;
-
-        while (*buf && (result == HTTPAPI_OK))
-        {
-            if (InternStrnicmp(buf, ContentLength, ContentLengthSize) == 0)
-            {
-                substr = buf + ContentLengthSize;
-                if (ParseStringToDecimal(substr, &lengthInMsg) != 1)
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
-                    result = HTTPAPI_READ_DATA_FAILED;
-                }
-                else
-                {
-                    (*bodyLength) = (size_t)lengthInMsg;
-                }
-            }
-            else if (InternStrnicmp(buf, TransferEncoding, TransferEncodingSize) == 0)
-            {
-                substr = buf + TransferEncodingSize;
-
-                while (isspace(*substr)) substr++;
-
-                if (InternStrnicmp(substr, Chunked, ChunkedSize) == 0)
-                {
-                    (*chunked) = true;
-                }
-            }
-
-            if (result == HTTPAPI_OK)
-            {
-                whereIsColon = strchr((char*)buf, ':');
-                /*Codes_SRS_HTTPAPI_COMPACT_21_049: [ If responseHeadersHandle is provide, the HTTPAPI_ExecuteRequest shall prepare a Response Header usign the HTTPHeaders_AddHeaderNameValuePair. ]*/
-                if (whereIsColon && (responseHeadersHandle != NULL))
-                {
-                    *whereIsColon = '\0';
-                    HTTPHeaders_AddHeaderNameValuePair(responseHeadersHandle, buf, whereIsColon + 1);
-                }
-
-                if (readLine(http_instance, buf, sizeof(buf)) < 0)
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-                    result = HTTPAPI_READ_DATA_FAILED;
-                }
-            }
-        }
+        result = false;
     }
 
     return result;
 }
 
-static HTTPAPI_RESULT ReadHTTPResponseBodyFromXIO(HTTP_HANDLE_DATA* http_instance, size_t bodyLength, bool chunked, BUFFER_HANDLE responseContent)
+static void PrepareXIOConnectionForRequest(HTTP_HANDLE_DATA* http_instance)
 {
-    HTTPAPI_RESULT result;
-    char    buf[TEMP_BUFFER_SIZE];
-    const unsigned char* receivedContent;
-
-    http_instance->is_io_error = 0;
-
-    //Read HTTP response body
-    if (!chunked)
+    if (http_instance->is_connected != 0)
     {
-        if (bodyLength)
+        if (http_instance->must_reconnect != 0)
         {
-            if (responseContent != NULL)
-            {
-                if (BUFFER_pre_build(responseContent, bodyLength) != 0)
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
-                    result = HTTPAPI_ALLOC_FAILED;
-                }
-                else if (BUFFER_content(responseContent, &receivedContent) != 0)
-                {
-                    (void)BUFFER_unbuild(responseContent);
-
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
-                    result = HTTPAPI_ALLOC_FAILED;
-                }
-                else if (readChunk(http_instance, (char*)receivedContent, bodyLength) < 0)
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
-                    result = HTTPAPI_READ_DATA_FAILED;
-                }
-                else
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
-                    result = HTTPAPI_OK;
-                }
-            }
-            else
-            {
-                /*Codes_SRS_HTTPAPI_COMPACT_21_051: [ If the responseContent is NULL, the HTTPAPI_ExecuteRequest shall ignore any content in the response. ]*/
-                if (skipN(http_instance, bodyLength) < 0)
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-                    result = HTTPAPI_READ_DATA_FAILED;
-                }
-                else
-                {
-                    result = HTTPAPI_OK;
-                }
-            }
+            /*Codes_SRS_HTTPAPI_COMPACT_21_090: [ If the response contains the header `Connection: close`, the HTTPAPI_ExecuteRequest shall close the connection before the next request. ]*/
+            CloseXIOConnection(http_instance);
         }
-        else
+        else if (http_instance->connection_idle_timeout > 0)
         {
-            /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
-            result = HTTPAPI_OK;
+            /*Codes_SRS_HTTPAPI_COMPACT_21_091: [ If the response contains a `Keep-Alive` header with a `timeout` parameter, the HTTPAPI_ExecuteRequest shall not reuse the connection once it was idle for that many seconds. ]*/
+            time_t now = get_time(NULL);
+            if ((now == (time_t)-1) ||
+                (get_difftime(now, http_instance->last_response_time) >= (double)http_instance->connection_idle_timeout))
+            {
+                LogInfo("The HTTP connection was idle for too long, opening a new one");
+                CloseXIOConnection(http_instance);
+            }
         }
     }
+}
+
+static void UpdateXIOConnectionAfterResponse(HTTP_HANDLE_DATA* http_instance, HTTPAPI_RESULT result)
+{
+    RESPONSE_PARSER* parser = &(http_instance->response_parser);
+
+    /* a failed request may leave part of its response on the wire, so the connection cannot be reused */
+    if ((result != HTTPAPI_OK) || parser->connectionClose || (http_instance->keep_alive == 0))
+    {
+        http_instance->must_reconnect = 1;
+        http_instance->connection_idle_timeout = 0;
+    }
     else
     {
-        size_t size = 0;
-        /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
-        result = HTTPAPI_OK;
-        while (result == HTTPAPI_OK)
+        /*Codes_SRS_HTTPAPI_COMPACT_21_092: [ If the option `OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT` is set, the HTTPAPI_ExecuteRequest shall not reuse a connection idle for longer than the smaller of this value and the host `Keep-Alive` timeout. ]*/
+        unsigned int idleTimeout = http_instance->keep_alive_idle_timeout;
+        if ((parser->keepAliveTimeout > 0) && ((idleTimeout == 0) || (parser->keepAliveTimeout < idleTimeout)))
         {
-            size_t chunkSize;
-            if (readLine(http_instance, buf, sizeof(buf)) < 0)    // read [length in hex]/r/n
-            {
-                /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
-                /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-                result = HTTPAPI_READ_DATA_FAILED;
-            }
-            else if (ParseStringToHexadecimal(buf, &chunkSize) != 1)     // chunkSize is length of next line (/r/n is not counted)
-            {
-                //Cannot match string, error
-                /*Codes_SRS_HTTPAPI_COMPACT_21_055: [ If the HTTPAPI_ExecuteRequest cannot parser the received message, it shall return HTTPAPI_RECEIVE_RESPONSE_FAILED. ]*/
-                result = HTTPAPI_RECEIVE_RESPONSE_FAILED;
-            }
-            else if (chunkSize == 0)
-            {
-                // 0 length means next line is just '\r\n' and end of chunks
-                if (readChunk(http_instance, (char*)buf, (size_t)2) < 0
-                    || buf[0] != '\r' || buf[1] != '\n') // skip /r/n
-                {
-                    (void)BUFFER_unbuild(responseContent);
-
-                    result = HTTPAPI_READ_DATA_FAILED;
-                }
-                break;
-            }
-            else
-            {
-                if (responseContent != NULL)
-                {
-                    if (BUFFER_enlarge(responseContent, chunkSize) != 0)
-                    {
-                        (void)BUFFER_unbuild(responseContent);
-
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
-                        result = HTTPAPI_ALLOC_FAILED;
-                    }
-                    else if (BUFFER_content(responseContent, &receivedContent) != 0)
-                    {
-                        (void)BUFFER_unbuild(responseContent);
-
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
-                        result = HTTPAPI_ALLOC_FAILED;
-                    }
-                    else if (readChunk(http_instance, (char*)receivedContent + size, chunkSize) < 0)
-                    {
-                        result = HTTPAPI_READ_DATA_FAILED;
-                    }
-                }
-                else
-                {
-                    /*Codes_SRS_HTTPAPI_COMPACT_21_051: [ If the responseContent is NULL, the HTTPAPI_ExecuteRequest shall ignore any content in the response. ]*/
-                    if (skipN(http_instance, chunkSize) < 0)
-                    {
-                        /*Codes_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-                        result = HTTPAPI_READ_DATA_FAILED;
-                    }
-                }
-
-                if (result == HTTPAPI_OK)
-                {
-                    if (readChunk(http_instance, (char*)buf, (size_t)2) < 0
-                        || buf[0] != '\r' || buf[1] != '\n') // skip /r/n
-                    {
-                        result = HTTPAPI_READ_DATA_FAILED;
-                    }
-                    size += chunkSize;
-                }
-            }
+            idleTimeout = parser->keepAliveTimeout;
         }
 
+        http_instance->connection_idle_timeout = idleTimeout;
+        if (idleTimeout > 0)
+        {
+            http_instance->last_response_time = get_time(NULL);
+        }
     }
-    return result;
 }
 
-
-/*Codes_SRS_HTTPAPI_COMPACT_21_037: [ If the request type is unknown, the HTTPAPI_ExecuteRequest shall return HTTPAPI_INVALID_ARG. ]*/
-static bool validRequestType(HTTPAPI_REQUEST_TYPE requestType)
+static HTTPAPI_RESULT SendRequestAndReceiveResponse(HTTP_HANDLE_DATA* http_instance, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+    HTTP_HEADERS_HANDLE httpHeadersHandle, size_t headersCount, const unsigned char* content, size_t contentLength,
+    unsigned int* statusCode, HTTP_HEADERS_HANDLE responseHeadersHandle, BUFFER_HANDLE responseContent, bool* isRequestSent)
 {
-    bool result;
+    HTTPAPI_RESULT result;
 
-    if ((requestType == HTTPAPI_REQUEST_GET) ||
-        (requestType == HTTPAPI_REQUEST_POST) ||
-        (requestType == HTTPAPI_REQUEST_PUT) ||
-        (requestType == HTTPAPI_REQUEST_DELETE) ||
-        (requestType == HTTPAPI_REQUEST_PATCH))
+    *isRequestSent = false;
+
+    /*Codes_SRS_HTTPAPI_COMPACT_21_024: [ The HTTPAPI_ExecuteRequest shall open the transport connection with the host to send the request. ]*/
+    if ((result = OpenXIOConnection(http_instance)) != HTTPAPI_OK)
     {
-        result = true;
+        LogError("Open HTTP connection failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
     }
     else
     {
-        result = false;
+        /*Codes_SRS_HTTPAPI_COMPACT_21_089: [ The HTTPAPI_ExecuteRequest shall parse the response incrementally, as the bytes are delivered by the xio, including bytes received while the request is still being sent. ]*/
+        StartResponseParser(http_instance, statusCode, responseHeadersHandle, responseContent);
+
+        /*Codes_SRS_HTTPAPI_COMPACT_21_026: [ If the open process succeed, the HTTPAPI_ExecuteRequest shall send the request message to the host. ]*/
+        if ((result = SendHeadsToXIO(http_instance, requestType, relativePath, httpHeadersHandle, headersCount)) != HTTPAPI_OK)
+        {
+            LogError("Send heads to HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+        }
+        /*Codes_SRS_HTTPAPI_COMPACT_21_042: [ The request can contain the a content message, provided in content parameter. ]*/
+        else if ((result = SendContentToXIO(http_instance, content, contentLength)) != HTTPAPI_OK)
+        {
+            LogError("Send content to HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+        }
+        else
+        {
+            *isRequestSent = true;
+
+            /*Codes_SRS_HTTPAPI_COMPACT_21_030: [ At the end of the transmission, the HTTPAPI_ExecuteRequest shall receive the response from the host. ]*/
+            if ((result = ReceiveResponseFromXIO(http_instance)) != HTTPAPI_OK)
+            {
+                LogError("Receive response from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+            }
+        }
+
+        http_instance->response_parser.state = RESPONSE_PARSER_STATE_IDLE;
     }
 
     return result;
@@ -1181,8 +1207,6 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
 {
     HTTPAPI_RESULT result = HTTPAPI_ERROR;
     size_t  headersCount;
-    size_t  bodyLength = 0;
-    bool    chunked = false;
     HTTP_HANDLE_DATA* http_instance = (HTTP_HANDLE_DATA*)handle;
 
     /*Codes_SRS_HTTPAPI_COMPACT_21_034: [ If there is no previous connection, the HTTPAPI_ExecuteRequest shall return HTTPAPI_INVALID_ARG. ]*/
@@ -1201,40 +1225,34 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
         result = HTTPAPI_INVALID_ARG;
         LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
     }
-    /*Codes_SRS_HTTPAPI_COMPACT_21_024: [ The HTTPAPI_ExecuteRequest shall open the transport connection with the host to send the request. ]*/
-    else if ((result = OpenXIOConnection(http_instance)) != HTTPAPI_OK)
-    {
-        LogError("Open HTTP connection failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-    }
-    /*Codes_SRS_HTTPAPI_COMPACT_21_026: [ If the open process succeed, the HTTPAPI_ExecuteRequest shall send the request message to the host. ]*/
-    else if ((result = SendHeadsToXIO(http_instance, requestType, relativePath, httpHeadersHandle, headersCount)) != HTTPAPI_OK)
-    {
-        LogError("Send heads to HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-    }
-    /*Codes_SRS_HTTPAPI_COMPACT_21_042: [ The request can contain the a content message, provided in content parameter. ]*/
-    else if ((result = SendContentToXIO(http_instance, content, contentLength)) != HTTPAPI_OK)
-    {
-        LogError("Send content to HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-    }
-    /*Codes_SRS_HTTPAPI_COMPACT_21_030: [ At the end of the transmission, the HTTPAPI_ExecuteRequest shall receive the response from the host. ]*/
-    /*Codes_SRS_HTTPAPI_COMPACT_21_073: [ The message received by the HTTPAPI_ExecuteRequest shall starts with a valid header. ]*/
-    else if ((result = ReceiveHeaderFromXIO(http_instance, statusCode)) != HTTPAPI_OK)
-    {
-        LogError("Receive header from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-    }
-    /*Codes_SRS_HTTPAPI_COMPACT_21_074: [ After the header, the message received by the HTTPAPI_ExecuteRequest can contain addition information about the content. ]*/
-    else if ((result = ReceiveContentInfoFromXIO(http_instance, responseHeadersHandle, &bodyLength, &chunked)) != HTTPAPI_OK)
-    {
-        LogError("Receive content information from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-    }
-    /*Codes_SRS_HTTPAPI_COMPACT_21_075: [ The message received by the HTTPAPI_ExecuteRequest can contain a body with the message content. ]*/
-    else if ((result = ReadHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, responseContent)) != HTTPAPI_OK)
+    else
     {
-        LogError("Read HTTP response body from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-    }
-
-    conn_receive_discard_buffer(http_instance);
+        bool isReusedConnection;
+        bool isRequestSent;
+        size_t receivedBytesBefore;
+
+        PrepareXIOConnectionForRequest(http_instance);
+        isReusedConnection = (http_instance->is_connected != 0);
+        receivedBytesBefore = http_instance->received_bytes_count;
+
+        result = SendRequestAndReceiveResponse(http_instance, requestType, relativePath, httpHeadersHandle, headersCount,
+            content, contentLength, statusCode, responseHeadersHandle, responseContent, &isRequestSent);
+
+        /*Codes_SRS_HTTPAPI_COMPACT_21_093: [ If a reused connection fails to send the request or to receive the response before any byte of the response arrived, the HTTPAPI_ExecuteRequest shall close it and retry the request once on a new connection. ]*/
+        /*Codes_SRS_HTTPAPI_COMPACT_21_098: [ If the request was completely sent, the HTTPAPI_ExecuteRequest shall only retry it when the request type is `GET` or `DELETE`. ]*/
+        if (((result == HTTPAPI_SEND_REQUEST_FAILED) || (result == HTTPAPI_READ_DATA_FAILED)) &&
+            isReusedConnection &&
+            (http_instance->received_bytes_count == receivedBytesBefore) &&
+            (!isRequestSent || isRetriableRequestType(requestType)))
+        {
+            LogInfo("The reused HTTP connection was dropped by the host, retrying on a new connection");
+            CloseXIOConnection(http_instance);
+            result = SendRequestAndReceiveResponse(http_instance, requestType, relativePath, httpHeadersHandle, headersCount,
+                content, contentLength, statusCode, responseHeadersHandle, responseContent, &isRequestSent);
+        }
 
+        UpdateXIOConnectionAfterResponse(http_instance, result);
+    }
 
     return result;
 }
@@ -1328,6 +1346,20 @@ HTTPAPI_RESULT HTTPAPI_SetOption(HTTP_HANDLE handle, const char* optionName, con
             result = HTTPAPI_OK;
         }
     }
+    /*Codes_SRS_HTTPAPI_COMPACT_21_094: [ If the optionName is `OPTION_HTTP_KEEP_ALIVE`, the HTTPAPI_SetOption shall enable or disable the reuse of the connection according to the provided `bool` value. ]*/
+    else if (strcmp(OPTION_HTTP_KEEP_ALIVE, optionName) == 0)
+    {
+        http_instance->keep_alive = (*(const bool*)value) ? 1 : 0;
+        /*Codes_SRS_HTTPAPI_COMPACT_21_064: [ If the HTTPAPI_SetOption get success setting the option, it shall return HTTPAPI_OK. ]*/
+        result = HTTPAPI_OK;
+    }
+    /*Codes_SRS_HTTPAPI_COMPACT_21_095: [ If the optionName is `OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT`, the HTTPAPI_SetOption shall store the provided `unsigned int` value as the maximum idle time, in seconds, of a reused connection. ]*/
+    else if (strcmp(OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT, optionName) == 0)
+    {
+        http_instance->keep_alive_idle_timeout = *(const unsigned int*)value;
+        /*Codes_SRS_HTTPAPI_COMPACT_21_064: [ If the HTTPAPI_SetOption get success setting the option, it shall return HTTPAPI_OK. ]*/
+        result = HTTPAPI_OK;
+    }
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_063: [ If the HTTP do not support the optionName, the HTTPAPI_SetOption shall return HTTPAPI_INVALID_ARG. ]*/
@@ -1407,6 +1439,38 @@ HTTPAPI_RESULT HTTPAPI_CloneOption(const char* optionName, const void* value, co
             result = HTTPAPI_OK;
         }
     }
+    else if (strcmp(OPTION_HTTP_KEEP_ALIVE, optionName) == 0)
+    {
+        bool* tempBool = (bool*)malloc(sizeof(bool));
+        if (tempBool == NULL)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_070: [ If any memory allocation get fail, the HTTPAPI_CloneOption shall return HTTPAPI_ALLOC_FAILED. ]*/
+            result = HTTPAPI_ALLOC_FAILED;
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_072: [ If the HTTPAPI_CloneOption get success setting the option, it shall return HTTPAPI_OK. ]*/
+            *tempBool = *(const bool*)value;
+            *savedValue = tempBool;
+            result = HTTPAPI_OK;
+        }
+    }
+    else if (strcmp(OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT, optionName) == 0)
+    {
+        unsigned int* tempTimeout = (unsigned int*)malloc(sizeof(unsigned int));
+        if (tempTimeout == NULL)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_070: [ If any memory allocation get fail, the HTTPAPI_CloneOption shall return HTTPAPI_ALLOC_FAILED. ]*/
+            result = HTTPAPI_ALLOC_FAILED;
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_072: [ If the HTTPAPI_CloneOption get success setting the option, it shall return HTTPAPI_OK. ]*/
+            *tempTimeout = *(const unsigned int*)value;
+            *savedValue = tempTimeout;
+            result = HTTPAPI_OK;
+        }
+    }
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_071: [ If the HTTP do not support the optionName, the HTTPAPI_CloneOption shall return HTTPAPI_INVALID_ARG. ]*/
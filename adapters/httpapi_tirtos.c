@@ -7,6 +7,7 @@
 
 #include <ti/net/http/httpcli.h>
 
+#include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/httpapi.h"
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/xlogging.h"
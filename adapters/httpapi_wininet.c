@@ -6,6 +6,7 @@
 #include "windows.h"
 #include "wininet.h"
 #include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/httpapi.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/xlogging.h"
@@ -22,6 +22,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
@@ -38,7 +39,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
-#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/doublylinkedlist.h"
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/optionhandler.h"
@@ -68,13 +69,14 @@ typedef enum IO_STATE_TAG
     IO_STATE_ERROR
 } IO_STATE;
 
+/* a pending send and the bytes left to send are one allocation, linked in the pending list through entry */
 typedef struct PENDING_SOCKET_IO_TAG
 {
+    DLIST_ENTRY entry;
     unsigned char* bytes;
     size_t size;
     ON_SEND_COMPLETE on_send_complete;
     void* callback_context;
-    SINGLYLINKEDLIST_HANDLE pending_io_list;
 } PENDING_SOCKET_IO;
 
 typedef struct SOCKET_IO_INSTANCE_TAG
@@ -88,7 +90,7 @@ typedef struct SOCKET_IO_INSTANCE_TAG
     int port;
     char* target_mac_address;
     IO_STATE io_state;
-    SINGLYLINKEDLIST_HANDLE pending_io_list;
+    DLIST_ENTRY pending_io_list;
     unsigned char recv_bytes[RECEIVE_BYTES_VALUE];
 } SOCKET_IO_INSTANCE;
 
@@ -203,40 +205,28 @@ static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
 static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned char* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
 {
     int result;
-    PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)malloc(sizeof(PENDING_SOCKET_IO));
-    if (pending_socket_io == NULL)
+    PENDING_SOCKET_IO* pending_socket_io;
+
+    if (size > SIZE_MAX - sizeof(PENDING_SOCKET_IO))
+    {
+        LogError("Failure: pending send of %u bytes is too large.", (unsigned int)size);
+        result = __FAILURE__;
+    }
+    else if ((pending_socket_io = (PENDING_SOCKET_IO*)malloc(sizeof(PENDING_SOCKET_IO) + size)) == NULL)
     {
+        LogError("Allocation Failure: Unable to allocate pending send.");
         result = __FAILURE__;
     }
     else
     {
-        pending_socket_io->bytes = (unsigned char*)malloc(size);
-        if (pending_socket_io->bytes == NULL)
-        {
-            LogError("Allocation Failure: Unable to allocate pending list.");
-            free(pending_socket_io);
-            result = __FAILURE__;
-        }
-        else
-        {
-            pending_socket_io->size = size;
-            pending_socket_io->on_send_complete = on_send_complete;
-            pending_socket_io->callback_context = callback_context;
-            pending_socket_io->pending_io_list = socket_io_instance->pending_io_list;
-            (void)memcpy(pending_socket_io->bytes, buffer, size);
+        pending_socket_io->bytes = (unsigned char*)(pending_socket_io + 1);
+        pending_socket_io->size = size;
+        pending_socket_io->on_send_complete = on_send_complete;
+        pending_socket_io->callback_context = callback_context;
+        (void)memcpy(pending_socket_io->bytes, buffer, size);
 
-            if (singlylinkedlist_add(socket_io_instance->pending_io_list, pending_socket_io) == NULL)
-            {
-                LogError("Failure: Unable to add socket to pending list.");
-                free(pending_socket_io->bytes);
-                free(pending_socket_io);
-                result = __FAILURE__;
-            }
-            else
-            {
-                result = 0;
-            }
-        }
+        DList_InsertTailList(&socket_io_instance->pending_io_list, &pending_socket_io->entry);
+        result = 0;
     }
 
     return result;
@@ -479,48 +469,39 @@ CONCRETE_IO_HANDLE socketio_create(void* io_create_parameters)
         result = malloc(sizeof(SOCKET_IO_INSTANCE));
         if (result != NULL)
         {
-            result->pending_io_list = singlylinkedlist_create();
-            if (result->pending_io_list == NULL)
+            DList_InitializeListHead(&result->pending_io_list);
+
+            if (socket_io_config->hostname != NULL)
+            {
+                result->hostname = (char*)malloc(strlen(socket_io_config->hostname) + 1);
+                if (result->hostname != NULL)
+                {
+                    (void)strcpy(result->hostname, socket_io_config->hostname);
+                }
+
+                result->socket = INVALID_SOCKET;
+            }
+            else
+            {
+                result->hostname = NULL;
+                result->socket = *((int*)socket_io_config->accepted_socket);
+            }
+
+            if ((result->hostname == NULL) && (result->socket == INVALID_SOCKET))
             {
-                LogError("Failure: singlylinkedlist_create unable to create pending list.");
+                LogError("Failure: hostname == NULL and socket is invalid.");
                 free(result);
                 result = NULL;
             }
             else
             {
-                if (socket_io_config->hostname != NULL)
-                {
-                    result->hostname = (char*)malloc(strlen(socket_io_config->hostname) + 1);
-                    if (result->hostname != NULL)
-                    {
-                        (void)strcpy(result->hostname, socket_io_config->hostname);
-                    }
-
-                    result->socket = INVALID_SOCKET;
-                }
-                else
-                {
-                    result->hostname = NULL;
-                    result->socket = *((int*)socket_io_config->accepted_socket);
-                }
-
-                if ((result->hostname == NULL) && (result->socket == INVALID_SOCKET))
-                {
-                    LogError("Failure: hostname == NULL and socket is invalid.");
-                    singlylinkedlist_destroy(result->pending_io_list);
-                    free(result);
-                    result = NULL;
-                }
-                else
-                {
-                    result->port = socket_io_config->port;
-                    result->target_mac_address = NULL;
-                    result->on_bytes_received = NULL;
-                    result->on_io_error = NULL;
-                    result->on_bytes_received_context = NULL;
-                    result->on_io_error_context = NULL;
-                    result->io_state = IO_STATE_CLOSED;
-                }
+                result->port = socket_io_config->port;
+                result->target_mac_address = NULL;
+                result->on_bytes_received = NULL;
+                result->on_io_error = NULL;
+                result->on_bytes_received_context = NULL;
+                result->on_io_error_context = NULL;
+                result->io_state = IO_STATE_CLOSED;
             }
         }
         else
@@ -544,21 +525,12 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
         }
 
         /* clear allpending IOs */
-        LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-        while (first_pending_io != NULL)
+        while (!DList_IsListEmpty(&socket_io_instance->pending_io_list))
         {
-            PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
-            if (pending_socket_io != NULL)
-            {
-                free(pending_socket_io->bytes);
-                free(pending_socket_io);
-            }
-
-            (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
-            first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
+            PDLIST_ENTRY first_pending_io = DList_RemoveHeadList(&socket_io_instance->pending_io_list);
+            free(containingRecord(first_pending_io, PENDING_SOCKET_IO, entry));
         }
 
-        singlylinkedlist_destroy(socket_io_instance->pending_io_list);
         free(socket_io_instance->hostname);
         free(socket_io_instance->target_mac_address);
         free(socket_io);
@@ -786,8 +758,7 @@ int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size,
         }
         else
         {
-            LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-            if (first_pending_io != NULL)
+            if (!DList_IsListEmpty(&socket_io_instance->pending_io_list))
             {
                 if (add_pending_io(socket_io_instance, buffer, size, on_send_complete, callback_context) != 0)
                 {
@@ -855,17 +826,9 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
     if (socket_io != NULL)
     {
         SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
-        LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-        while (first_pending_io != NULL)
+        while (!DList_IsListEmpty(&socket_io_instance->pending_io_list))
         {
-            PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
-            if (pending_socket_io == NULL)
-            {
-                socket_io_instance->io_state = IO_STATE_ERROR;
-                indicate_error(socket_io_instance);
-                LogError("Failure: retrieving socket from list");
-                break;
-            }
+            PENDING_SOCKET_IO* pending_socket_io = containingRecord(socket_io_instance->pending_io_list.Flink, PENDING_SOCKET_IO, entry);
 
             int send_result = send(socket_io_instance->socket, pending_socket_io->bytes, pending_socket_io->size, 0);
             if (send_result != pending_socket_io->size)
@@ -879,9 +842,8 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
                     }
                     else
                     {
-                        free(pending_socket_io->bytes);
+                        (void)DList_RemoveEntryList(&pending_socket_io->entry);
                         free(pending_socket_io);
-                        (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
 
                         LogError("Failure: sending Socket information. errno=%d (%s).", errno, strerror(errno));
                         socket_io_instance->io_state = IO_STATE_ERROR;
@@ -891,7 +853,7 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
                 else
                 {
                     /* simply wait until next dowork */
-                    (void)memmove(pending_socket_io->bytes, pending_socket_io->bytes + send_result, pending_socket_io->size - send_result);
+                    pending_socket_io->bytes += send_result;
                     pending_socket_io->size -= send_result;
                     break;
                 }
@@ -903,17 +865,9 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
                     pending_socket_io->on_send_complete(pending_socket_io->callback_context, IO_SEND_OK);
                 }
 
-                free(pending_socket_io->bytes);
+                (void)DList_RemoveEntryList(&pending_socket_io->entry);
                 free(pending_socket_io);
-                if (singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io) != 0)
-                {
-                    socket_io_instance->io_state = IO_STATE_ERROR;
-                    indicate_error(socket_io_instance);
-                    LogError("Failure: unable to remove socket from list");
-                }
             }
-
-            first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
         }
 
         if (socket_io_instance->io_state == IO_STATE_OPEN)
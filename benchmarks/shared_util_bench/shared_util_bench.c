@@ -0,0 +1,1072 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * shared_util_bench measures the throughput and the latency of the hashing and encoding functions, for every
+ * implementation the CPU supports, and of building a request's STRING and BUFFER temporaries on the heap, in an
+ * arena or through the allocators installed with gballoc_setAllocator, of building short STRINGs and BUFFERs with
+ * their content in a block of its own or in the allocation of the handle, of freezing a BUFFER in a CONSTBUFFER, of
+ * splitting a CONSTBUFFER in copies or in views and of filling and draining a VECTOR, for payloads from 16 bytes to
+ * 16 MB, and writes one CSV line (or one JSON object) per benchmark, implementation and payload size:
+ *
+ *     benchmark,implementation,size,iterations,ns_per_op_min,ns_per_op_median,ns_per_op_max,mb_per_s
+ *
+ * The throughput is computed from the median and counts the bytes of the payload (the text for the decoders,
+ * before it was encoded), in millions of bytes per second. Run with --help for the options.
+ *
+ * Build with optimizations (e.g. -DCMAKE_BUILD_TYPE=Release -Dbuild_benchmarks=ON), the intrinsics of the
+ * vectorized paths are much slower than the reference code when they are not optimized. The installed allocators
+ * only reach STRING and BUFFER when the library is built with use_allocator_hooks (or memory_trace).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/sha.h"
+#include "azure_c_shared_utility/hmac.h"
+#include "azure_c_shared_utility/hmacsha256.h"
+#include "azure_c_shared_utility/base64.h"
+#include "azure_c_shared_utility/base32.h"
+#include "azure_c_shared_utility/urlencode.h"
+#include "azure_c_shared_utility/utf8_checker.h"
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/arena.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/vector.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define BENCH_DEFAULT_MIN_SIZE      16
+#define BENCH_DEFAULT_MAX_SIZE      (16 * 1024 * 1024)
+#define BENCH_DEFAULT_SAMPLES       7
+#define BENCH_DEFAULT_SAMPLE_MS     20
+#define BENCH_MAX_SAMPLES           101
+
+/* request_scratch builds its temporaries from pieces of this many bytes of the payload */
+#define BENCH_SCRATCH_PIECE_SIZE    64
+
+/* short_values cuts the input in values of this many bytes, the size of a typical header value */
+#define BENCH_SHORT_VALUE_SIZE      16
+
+/* constbuffer_split hands out the payload in pieces of this many bytes */
+#define BENCH_SPLIT_PIECE_SIZE      1024
+
+/* vector_queue queues the payload in items of this many bytes */
+#define BENCH_QUEUE_ITEM_SIZE       16
+
+/* the bump allocator serves the blocks of one operation from a region of this many bytes, with a header of
+BENCH_BUMP_HEADER_SIZE bytes that holds the size of the block */
+#define BENCH_BUMP_SIZE             (4 * 1024 * 1024)
+#define BENCH_BUMP_HEADER_SIZE      16
+
+/* the encoders write at most 3 characters per byte of their input (URL encoding of the text payload) */
+#define BENCH_BUFFER_SIZE(size)     (4 * (size) + 64)
+
+typedef enum BENCH_FORMAT_TAG
+{
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+} BENCH_FORMAT;
+
+/* selects the implementation to measure, returns 0 when it can run on this CPU */
+typedef int(*BENCH_SELECT)(void);
+/* turns the random payload into the input of the operation and returns the size of the input */
+typedef size_t(*BENCH_PREPARE)(const unsigned char* payload, size_t size, unsigned char* input);
+/* one operation; returns something that depends on the output so that the work cannot be optimized away */
+typedef size_t(*BENCH_RUN)(const unsigned char* input, size_t input_size, unsigned char* output);
+
+typedef struct BENCH_CASE_TAG
+{
+    const char* benchmark;
+    const char* implementation;
+    BENCH_SELECT select;
+    BENCH_PREPARE prepare;
+    BENCH_RUN run;
+} BENCH_CASE;
+
+static const unsigned char bench_key[32] =
+{
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b
+};
+
+static HMACSHA256_KEY_HANDLE bench_hmacsha256_key = NULL;
+static ARENA_HANDLE bench_arena = NULL;
+static GBALLOC_ALLOCATOR bench_default_allocator;
+static size_t bench_allocation_count = 0;
+static unsigned char* bench_bump = NULL;
+static size_t bench_bump_used = 0;
+
+/* the size of the buffer the operations write to */
+static size_t bench_output_size = 0;
+
+static double now_ns(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0)
+    {
+        (void)QueryPerformanceFrequency(&frequency);
+    }
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+#endif
+}
+
+/* implementations */
+
+static int select_none(void) { return 0; }
+static int select_sha256_portable(void) { return SHA256SelectImplementation(sha256Portable); }
+static int select_sha256_sha_ni(void) { return SHA256SelectImplementation(sha256X86ShaExtensions); }
+static int select_sha256_armv8(void) { return SHA256SelectImplementation(sha256ArmV8Crypto); }
+static int select_sha512_portable(void) { return SHA512SelectImplementation(sha512Portable); }
+static int select_sha512_unrolled(void) { return SHA512SelectImplementation(sha512Unrolled); }
+static int select_sha512_avx2(void) { return SHA512SelectImplementation(sha512X86Avx2); }
+static int select_base64_table(void) { return Base64_SelectImplementation(BASE64_IMPLEMENTATION_TABLE); }
+static int select_base64_ssse3(void) { return Base64_SelectImplementation(BASE64_IMPLEMENTATION_SSSE3); }
+static int select_base64_avx2(void) { return Base64_SelectImplementation(BASE64_IMPLEMENTATION_AVX2); }
+static int select_base64_neon(void) { return Base64_SelectImplementation(BASE64_IMPLEMENTATION_NEON); }
+static int select_utf8_scalar(void) { return utf8_checker_select_implementation(UTF8_CHECKER_IMPLEMENTATION_SCALAR); }
+static int select_utf8_ssse3(void) { return utf8_checker_select_implementation(UTF8_CHECKER_IMPLEMENTATION_SSSE3); }
+static int select_utf8_avx2(void) { return utf8_checker_select_implementation(UTF8_CHECKER_IMPLEMENTATION_AVX2); }
+static int select_utf8_neon(void) { return utf8_checker_select_implementation(UTF8_CHECKER_IMPLEMENTATION_NEON); }
+
+/* inputs */
+
+static size_t prepare_bytes(const unsigned char* payload, size_t size, unsigned char* input)
+{
+    (void)memcpy(input, payload, size);
+    return size;
+}
+
+/* text with the mix of characters of a query string: mostly unreserved, some reserved, no control characters */
+static size_t prepare_text(const unsigned char* payload, size_t size, unsigned char* input)
+{
+    static const char alphabet[64] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 /";
+    size_t i;
+    for (i = 0; i < size; i++)
+    {
+        input[i] = (unsigned char)alphabet[payload[i] & 0x3F];
+    }
+    input[size] = '\0';
+    return size;
+}
+
+/* text in several languages: 1, 2, 3 and 4 byte sequences */
+static size_t prepare_utf8(const unsigned char* payload, size_t size, unsigned char* input)
+{
+    static const char* const pieces[8] = { "a", "b", "0", " ", "\xC3\xA9", "\xD0\xB6", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+    size_t pos = 0;
+    size_t i = 0;
+    while (pos < size)
+    {
+        const char* piece = pieces[payload[i++ % size] & 0x07];
+        size_t piece_length = strlen(piece);
+        if (pos + piece_length > size)
+        {
+            piece = "a";
+            piece_length = 1;
+        }
+        (void)memcpy(input + pos, piece, piece_length);
+        pos += piece_length;
+    }
+    return size;
+}
+
+static size_t prepare_base64(const unsigned char* payload, size_t size, unsigned char* input)
+{
+    size_t encoded_length = 0;
+    (void)Base64_Encode_Into(payload, size, (char*)input, BENCH_BUFFER_SIZE(size), &encoded_length);
+    input[encoded_length] = '\0';
+    return encoded_length;
+}
+
+static size_t prepare_base32(const unsigned char* payload, size_t size, unsigned char* input)
+{
+    size_t result = 0;
+    char* encoded = Base32_Encode_Bytes(payload, size);
+    if (encoded != NULL)
+    {
+        result = strlen(encoded);
+        (void)memcpy(input, encoded, result + 1);
+        free(encoded);
+    }
+    return result;
+}
+
+static size_t prepare_url_encoded(const unsigned char* payload, size_t size, unsigned char* input)
+{
+    size_t encoded_length = 0;
+    unsigned char* text = (unsigned char*)malloc(size + 1);
+    if (text != NULL)
+    {
+        (void)prepare_text(payload, size, text);
+        (void)URL_Encode_Into((const char*)text, size, (char*)input, BENCH_BUFFER_SIZE(size), &encoded_length);
+        free(text);
+    }
+    input[encoded_length] = '\0';
+    return encoded_length;
+}
+
+/* operations */
+
+static size_t run_sha1(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    SHA1Context context;
+    (void)SHA1Reset(&context);
+    (void)SHA1Input(&context, input, (unsigned int)input_size);
+    (void)SHA1Result(&context, output);
+    return output[0];
+}
+
+static size_t run_sha224(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    SHA224Context context;
+    (void)SHA224Reset(&context);
+    (void)SHA224Input(&context, input, (unsigned int)input_size);
+    (void)SHA224Result(&context, output);
+    return output[0];
+}
+
+static size_t run_sha256(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    SHA256Context context;
+    (void)SHA256Reset(&context);
+    (void)SHA256Input(&context, input, (unsigned int)input_size);
+    (void)SHA256Result(&context, output);
+    return output[0];
+}
+
+static size_t run_sha384(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    SHA384Context context;
+    (void)SHA384Reset(&context);
+    (void)SHA384Input(&context, input, (unsigned int)input_size);
+    (void)SHA384Result(&context, output);
+    return output[0];
+}
+
+static size_t run_sha512(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    SHA512Context context;
+    (void)SHA512Reset(&context);
+    (void)SHA512Input(&context, input, (unsigned int)input_size);
+    (void)SHA512Result(&context, output);
+    return output[0];
+}
+
+static size_t run_hmac_sha1(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)hmac(SHA1, input, (int)input_size, bench_key, (int)sizeof(bench_key), output);
+    return output[0];
+}
+
+static size_t run_hmac_sha256(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)hmac(SHA256, input, (int)input_size, bench_key, (int)sizeof(bench_key), output);
+    return output[0];
+}
+
+static size_t run_hmacsha256(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t result = 0;
+    BUFFER_HANDLE hash = BUFFER_new();
+    if (hash != NULL)
+    {
+        if (HMACSHA256_ComputeHash(bench_key, sizeof(bench_key), input, input_size, hash) == HMACSHA256_OK)
+        {
+            result = BUFFER_u_char(hash)[0];
+        }
+        BUFFER_delete(hash);
+    }
+    (void)output;
+    return result;
+}
+
+static size_t run_hmacsha256_with_key(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)HMACSHA256_ComputeHashWithKey(bench_hmacsha256_key, input, input_size, output);
+    return output[0];
+}
+
+static size_t run_base64_encode(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t encoded_length = 0;
+    (void)Base64_Encode_Into(input, input_size, (char*)output, bench_output_size, &encoded_length);
+    return encoded_length;
+}
+
+static size_t run_base64_decode(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t decoded_length = 0;
+    (void)Base64_Decode_Into((const char*)input, input_size, output, bench_output_size, &decoded_length);
+    return decoded_length;
+}
+
+static size_t run_base32_encode(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t result = 0;
+    char* encoded = Base32_Encode_Bytes(input, input_size);
+    if (encoded != NULL)
+    {
+        result = (unsigned char)encoded[0];
+        free(encoded);
+    }
+    (void)output;
+    return result;
+}
+
+static size_t run_base32_decode(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t result = 0;
+    BUFFER_HANDLE decoded = Base32_Decode_String((const char*)input);
+    if (decoded != NULL)
+    {
+        result = BUFFER_length(decoded);
+        BUFFER_delete(decoded);
+    }
+    (void)input_size;
+    (void)output;
+    return result;
+}
+
+static size_t run_url_encode(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t encoded_length = 0;
+    (void)URL_Encode_Into((const char*)input, input_size, (char*)output, bench_output_size, &encoded_length);
+    return encoded_length;
+}
+
+static size_t run_url_decode(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t result = 0;
+    STRING_HANDLE decoded = URL_DecodeString((const char*)input);
+    if (decoded != NULL)
+    {
+        result = STRING_length(decoded);
+        STRING_delete(decoded);
+    }
+    (void)input_size;
+    (void)output;
+    return result;
+}
+
+static size_t run_utf8_validate(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return utf8_checker_is_valid_utf8(input, input_size) ? 1 : 0;
+}
+
+/* the temporaries of a request: for every piece of the input a STRING, its quoted form and a BUFFER copy, all
+deleted again; from the heap when arena is NULL, otherwise from the arena */
+static size_t request_scratch(const unsigned char* input, size_t input_size, ARENA_HANDLE arena)
+{
+    size_t result = 0;
+    size_t offset;
+    char piece[BENCH_SCRATCH_PIECE_SIZE + 1];
+
+    for (offset = 0; offset < input_size; offset += BENCH_SCRATCH_PIECE_SIZE)
+    {
+        size_t piece_size = (input_size - offset < BENCH_SCRATCH_PIECE_SIZE) ? input_size - offset : BENCH_SCRATCH_PIECE_SIZE;
+        STRING_HANDLE text;
+
+        (void)memcpy(piece, input + offset, piece_size);
+        piece[piece_size] = '\0';
+        text = (arena == NULL) ? STRING_construct(piece) : STRING_construct_in_arena(arena, piece);
+        if (text != NULL)
+        {
+            if (STRING_quote(text) == 0)
+            {
+                BUFFER_HANDLE copy = (arena == NULL) ?
+                    BUFFER_create((const unsigned char*)STRING_c_str(text), STRING_length(text)) :
+                    BUFFER_create_in_arena(arena, (const unsigned char*)STRING_c_str(text), STRING_length(text));
+                if (copy != NULL)
+                {
+                    result += BUFFER_length(copy);
+                    BUFFER_delete(copy);
+                }
+            }
+            STRING_delete(text);
+        }
+    }
+
+    return result;
+}
+
+static size_t run_request_scratch_heap(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return request_scratch(input, input_size, NULL);
+}
+
+static size_t run_request_scratch_arena(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t result = request_scratch(input, input_size, bench_arena);
+    ARENA_reset(bench_arena);
+    (void)output;
+    return result;
+}
+
+/* the short values of a message, header values and property names: for every value a STRING, its quoted form and
+a BUFFER copy, all deleted again; with the content in a block of its own or in the allocation of the handle */
+static size_t short_values(const unsigned char* input, size_t input_size, int use_inline)
+{
+    size_t result = 0;
+    size_t offset;
+    char value[BENCH_SHORT_VALUE_SIZE + 1];
+
+    for (offset = 0; offset < input_size; offset += BENCH_SHORT_VALUE_SIZE)
+    {
+        size_t value_size = (input_size - offset < BENCH_SHORT_VALUE_SIZE) ? input_size - offset : BENCH_SHORT_VALUE_SIZE;
+        STRING_HANDLE text;
+
+        (void)memcpy(value, input + offset, value_size);
+        value[value_size] = '\0';
+        text = use_inline ? STRING_construct_inline(value) : STRING_construct(value);
+        if (text != NULL)
+        {
+            if (STRING_quote(text) == 0)
+            {
+                BUFFER_HANDLE copy = use_inline ?
+                    BUFFER_create_inline((const unsigned char*)STRING_c_str(text), STRING_length(text)) :
+                    BUFFER_create((const unsigned char*)STRING_c_str(text), STRING_length(text));
+                if (copy != NULL)
+                {
+                    result += BUFFER_length(copy);
+                    BUFFER_delete(copy);
+                }
+            }
+            STRING_delete(text);
+        }
+    }
+
+    return result;
+}
+
+static size_t run_short_values_separate(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return short_values(input, input_size, 0);
+}
+
+static size_t run_short_values_inline(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return short_values(input, input_size, 1);
+}
+
+/* builds a BUFFER out of the payload and freezes it in a CONSTBUFFER, copying its content or taking it over */
+static size_t constbuffer_freeze(const unsigned char* input, size_t input_size, int copy)
+{
+    size_t result = 0;
+    BUFFER_HANDLE buffer = BUFFER_create(input, input_size);
+
+    if (buffer != NULL)
+    {
+        CONSTBUFFER_HANDLE frozen = copy ?
+            CONSTBUFFER_CreateFromBuffer(buffer) :
+            CONSTBUFFER_CreateFromBufferWithMove(buffer);
+        BUFFER_delete(buffer);
+        if (frozen != NULL)
+        {
+            result = CONSTBUFFER_GetContent(frozen)->size;
+            CONSTBUFFER_Destroy(frozen);
+        }
+    }
+
+    return result;
+}
+
+static size_t run_constbuffer_freeze_copy(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return constbuffer_freeze(input, input_size, 1);
+}
+
+static size_t run_constbuffer_freeze_move(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return constbuffer_freeze(input, input_size, 0);
+}
+
+/* splits the payload in pieces of BENCH_SPLIT_PIECE_SIZE bytes, as when a received payload is handed to several
+consumers; copying every piece or sharing the memory of the payload */
+static size_t constbuffer_split(const unsigned char* input, size_t input_size, int copy)
+{
+    size_t result = 0;
+    CONSTBUFFER_HANDLE payload = CONSTBUFFER_Create(input, input_size);
+
+    if (payload != NULL)
+    {
+        size_t offset;
+        for (offset = 0; offset < input_size; offset += BENCH_SPLIT_PIECE_SIZE)
+        {
+            size_t piece_size = (input_size - offset < BENCH_SPLIT_PIECE_SIZE) ? input_size - offset : BENCH_SPLIT_PIECE_SIZE;
+            CONSTBUFFER_HANDLE piece = copy ?
+                CONSTBUFFER_Create(CONSTBUFFER_GetContent(payload)->buffer + offset, piece_size) :
+                CONSTBUFFER_CreateFromOffsetAndSize(payload, offset, piece_size);
+            if (piece != NULL)
+            {
+                result += CONSTBUFFER_GetContent(piece)->buffer[0];
+                CONSTBUFFER_Destroy(piece);
+            }
+        }
+        CONSTBUFFER_Destroy(payload);
+    }
+
+    return result;
+}
+
+static size_t run_constbuffer_split_copy(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return constbuffer_split(input, input_size, 1);
+}
+
+static size_t run_constbuffer_split_view(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return constbuffer_split(input, input_size, 0);
+}
+
+/* forwards to the default allocator and counts the calls, the cost of going through an installed allocator */
+static void* counting_malloc(void* context, size_t size)
+{
+    (*(size_t*)context)++;
+    return bench_default_allocator.malloc_function(bench_default_allocator.context, size);
+}
+
+static void* counting_calloc(void* context, size_t nmemb, size_t size)
+{
+    (*(size_t*)context)++;
+    return bench_default_allocator.calloc_function(bench_default_allocator.context, nmemb, size);
+}
+
+static void* counting_realloc(void* context, void* ptr, size_t size)
+{
+    (*(size_t*)context)++;
+    return bench_default_allocator.realloc_function(bench_default_allocator.context, ptr, size);
+}
+
+static void counting_free(void* context, void* ptr)
+{
+    (void)context;
+    bench_default_allocator.free_function(bench_default_allocator.context, ptr);
+}
+
+/* serves the blocks from bench_bump and never frees them, the region is emptied after every operation; what does
+not fit in the region goes to the default allocator */
+static int is_bump_block(const void* ptr)
+{
+    return ((uintptr_t)ptr >= (uintptr_t)bench_bump) && ((uintptr_t)ptr < (uintptr_t)bench_bump + BENCH_BUMP_SIZE);
+}
+
+static void* bump_malloc(void* context, size_t size)
+{
+    void* result;
+    size_t needed = BENCH_BUMP_HEADER_SIZE + ((size + (BENCH_BUMP_HEADER_SIZE - 1)) & ~(size_t)(BENCH_BUMP_HEADER_SIZE - 1));
+
+    (void)context;
+    if ((size > BENCH_BUMP_SIZE) || (needed > BENCH_BUMP_SIZE - bench_bump_used))
+    {
+        result = bench_default_allocator.malloc_function(bench_default_allocator.context, size);
+    }
+    else
+    {
+        unsigned char* block = bench_bump + bench_bump_used;
+        (void)memcpy(block, &size, sizeof(size));
+        bench_bump_used += needed;
+        result = block + BENCH_BUMP_HEADER_SIZE;
+    }
+
+    return result;
+}
+
+static void* bump_realloc(void* context, void* ptr, size_t size)
+{
+    void* result;
+
+    if (ptr == NULL)
+    {
+        result = bump_malloc(context, size);
+    }
+    else if (!is_bump_block(ptr))
+    {
+        result = bench_default_allocator.realloc_function(bench_default_allocator.context, ptr, size);
+    }
+    else
+    {
+        size_t old_size;
+        (void)memcpy(&old_size, (unsigned char*)ptr - BENCH_BUMP_HEADER_SIZE, sizeof(old_size));
+        result = bump_malloc(context, size);
+        if (result != NULL)
+        {
+            (void)memcpy(result, ptr, (old_size < size) ? old_size : size);
+        }
+    }
+
+    return result;
+}
+
+static void bump_free(void* context, void* ptr)
+{
+    (void)context;
+    if ((ptr != NULL) && !is_bump_block(ptr))
+    {
+        bench_default_allocator.free_function(bench_default_allocator.context, ptr);
+    }
+}
+
+static int select_allocator_default(void)
+{
+    return gballoc_setAllocator(NULL);
+}
+
+static int select_allocator_counting(void)
+{
+    GBALLOC_ALLOCATOR allocator;
+    allocator.malloc_function = counting_malloc;
+    allocator.realloc_function = counting_realloc;
+    allocator.free_function = counting_free;
+    allocator.calloc_function = counting_calloc;
+    allocator.aligned_malloc_function = NULL;
+    allocator.aligned_free_function = NULL;
+    allocator.context = &bench_allocation_count;
+    return gballoc_setAllocator(&allocator);
+}
+
+static int select_allocator_bump(void)
+{
+    GBALLOC_ALLOCATOR allocator;
+    allocator.malloc_function = bump_malloc;
+    allocator.realloc_function = bump_realloc;
+    allocator.free_function = bump_free;
+    allocator.calloc_function = NULL;
+    allocator.aligned_malloc_function = NULL;
+    allocator.aligned_free_function = NULL;
+    allocator.context = NULL;
+    return gballoc_setAllocator(&allocator);
+}
+
+/* queues every item of the payload one at a time, as the pending sends of a connection, then takes them off the
+back one at a time; growing the vector as it goes or reserving room for every item first */
+static size_t vector_queue(const unsigned char* input, size_t input_size, int reserve)
+{
+    size_t result = 0;
+    size_t item_count = input_size / BENCH_QUEUE_ITEM_SIZE;
+    VECTOR_HANDLE queue = VECTOR_create(BENCH_QUEUE_ITEM_SIZE);
+
+    if (queue != NULL)
+    {
+        if (!reserve || VECTOR_reserve(queue, item_count) == 0)
+        {
+            size_t i;
+            for (i = 0; i < item_count; i++)
+            {
+                if (VECTOR_push_back(queue, input + (i * BENCH_QUEUE_ITEM_SIZE), 1) != 0)
+                {
+                    break;
+                }
+            }
+
+            while (VECTOR_size(queue) > 0)
+            {
+                unsigned char* item = (unsigned char*)VECTOR_back(queue);
+                result += item[0];
+                VECTOR_erase(queue, item, 1);
+            }
+        }
+        VECTOR_destroy(queue);
+    }
+
+    return result;
+}
+
+static size_t run_vector_queue_grow(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return vector_queue(input, input_size, 0);
+}
+
+static size_t run_vector_queue_reserve(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    (void)output;
+    return vector_queue(input, input_size, 1);
+}
+
+static size_t run_request_scratch_bump(const unsigned char* input, size_t input_size, unsigned char* output)
+{
+    size_t result = request_scratch(input, input_size, NULL);
+    bench_bump_used = 0;
+    (void)output;
+    return result;
+}
+
+static const BENCH_CASE bench_cases[] =
+{
+    { "sha1", "portable", select_none, prepare_bytes, run_sha1 },
+    { "sha224", "portable", select_sha256_portable, prepare_bytes, run_sha224 },
+    { "sha224", "sha-ni", select_sha256_sha_ni, prepare_bytes, run_sha224 },
+    { "sha224", "armv8", select_sha256_armv8, prepare_bytes, run_sha224 },
+    { "sha256", "portable", select_sha256_portable, prepare_bytes, run_sha256 },
+    { "sha256", "sha-ni", select_sha256_sha_ni, prepare_bytes, run_sha256 },
+    { "sha256", "armv8", select_sha256_armv8, prepare_bytes, run_sha256 },
+    { "sha384", "portable", select_sha512_portable, prepare_bytes, run_sha384 },
+    { "sha384", "unrolled", select_sha512_unrolled, prepare_bytes, run_sha384 },
+    { "sha384", "avx2", select_sha512_avx2, prepare_bytes, run_sha384 },
+    { "sha512", "portable", select_sha512_portable, prepare_bytes, run_sha512 },
+    { "sha512", "unrolled", select_sha512_unrolled, prepare_bytes, run_sha512 },
+    { "sha512", "avx2", select_sha512_avx2, prepare_bytes, run_sha512 },
+    { "hmac_sha1", "portable", select_none, prepare_bytes, run_hmac_sha1 },
+    { "hmac_sha256", "portable", select_sha256_portable, prepare_bytes, run_hmac_sha256 },
+    { "hmac_sha256", "sha-ni", select_sha256_sha_ni, prepare_bytes, run_hmac_sha256 },
+    { "hmac_sha256", "armv8", select_sha256_armv8, prepare_bytes, run_hmac_sha256 },
+    { "hmacsha256", "portable", select_sha256_portable, prepare_bytes, run_hmacsha256 },
+    { "hmacsha256", "sha-ni", select_sha256_sha_ni, prepare_bytes, run_hmacsha256 },
+    { "hmacsha256", "armv8", select_sha256_armv8, prepare_bytes, run_hmacsha256 },
+    { "hmacsha256_with_key", "portable", select_sha256_portable, prepare_bytes, run_hmacsha256_with_key },
+    { "hmacsha256_with_key", "sha-ni", select_sha256_sha_ni, prepare_bytes, run_hmacsha256_with_key },
+    { "hmacsha256_with_key", "armv8", select_sha256_armv8, prepare_bytes, run_hmacsha256_with_key },
+    { "base64_encode", "table", select_base64_table, prepare_bytes, run_base64_encode },
+    { "base64_encode", "ssse3", select_base64_ssse3, prepare_bytes, run_base64_encode },
+    { "base64_encode", "avx2", select_base64_avx2, prepare_bytes, run_base64_encode },
+    { "base64_encode", "neon", select_base64_neon, prepare_bytes, run_base64_encode },
+    { "base64_decode", "table", select_base64_table, prepare_base64, run_base64_decode },
+    { "base64_decode", "ssse3", select_base64_ssse3, prepare_base64, run_base64_decode },
+    { "base64_decode", "avx2", select_base64_avx2, prepare_base64, run_base64_decode },
+    { "base64_decode", "neon", select_base64_neon, prepare_base64, run_base64_decode },
+    { "base32_encode", "portable", select_none, prepare_bytes, run_base32_encode },
+    { "base32_decode", "portable", select_none, prepare_base32, run_base32_decode },
+    { "url_encode", "portable", select_none, prepare_text, run_url_encode },
+    { "url_decode", "portable", select_none, prepare_url_encoded, run_url_decode },
+    { "utf8_validate", "scalar", select_utf8_scalar, prepare_utf8, run_utf8_validate },
+    { "utf8_validate", "ssse3", select_utf8_ssse3, prepare_utf8, run_utf8_validate },
+    { "utf8_validate", "avx2", select_utf8_avx2, prepare_utf8, run_utf8_validate },
+    { "utf8_validate", "neon", select_utf8_neon, prepare_utf8, run_utf8_validate },
+    { "request_scratch", "heap", select_none, prepare_text, run_request_scratch_heap },
+    { "request_scratch", "arena", select_none, prepare_text, run_request_scratch_arena },
+    { "short_values", "separate", select_none, prepare_text, run_short_values_separate },
+    { "short_values", "inline", select_none, prepare_text, run_short_values_inline },
+    { "constbuffer_freeze", "copy", select_none, prepare_bytes, run_constbuffer_freeze_copy },
+    { "constbuffer_freeze", "move", select_none, prepare_bytes, run_constbuffer_freeze_move },
+    { "constbuffer_split", "copy", select_none, prepare_bytes, run_constbuffer_split_copy },
+    { "constbuffer_split", "view", select_none, prepare_bytes, run_constbuffer_split_view },
+    { "vector_queue", "grow", select_none, prepare_bytes, run_vector_queue_grow },
+    { "vector_queue", "reserve", select_none, prepare_bytes, run_vector_queue_reserve },
+    /* these install an allocator, the default one is installed again once every case ran */
+    { "request_scratch", "allocator_default", select_allocator_default, prepare_text, run_request_scratch_heap },
+    { "request_scratch", "allocator_counting", select_allocator_counting, prepare_text, run_request_scratch_heap },
+    { "request_scratch", "allocator_bump", select_allocator_bump, prepare_text, run_request_scratch_bump }
+};
+
+#define BENCH_CASE_COUNT (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+typedef struct BENCH_OPTIONS_TAG
+{
+    BENCH_FORMAT format;
+    const char* filter;
+    size_t min_size;
+    size_t max_size;
+    unsigned int samples;
+    unsigned int sample_ms;
+} BENCH_OPTIONS;
+
+static int compare_doubles(const void* left, const void* right)
+{
+    double l = *(const double*)left;
+    double r = *(const double*)right;
+    return (l < r) ? -1 : ((l > r) ? 1 : 0);
+}
+
+static void print_usage(const char* program)
+{
+    (void)printf(
+        "usage: %s [options]\n"
+        "  --format csv|json   output format (default csv)\n"
+        "  --filter TEXT       only the benchmarks whose name contains TEXT (e.g. sha256, base64)\n"
+        "  --min-size BYTES    smallest payload (default %d)\n"
+        "  --max-size BYTES    largest payload (default %d); sizes grow 4 times at a time\n"
+        "  --samples N         timed samples per measure (default %d)\n"
+        "  --sample-ms N       minimum duration of a sample in milliseconds (default %d)\n"
+        "  --list              list the benchmarks and whether they can run on this CPU\n",
+        program, BENCH_DEFAULT_MIN_SIZE, BENCH_DEFAULT_MAX_SIZE, BENCH_DEFAULT_SAMPLES, BENCH_DEFAULT_SAMPLE_MS);
+}
+
+/* returns 0 when the options are valid, 1 when the program should stop without error and a negative value on error */
+static int parse_options(int argc, char** argv, BENCH_OPTIONS* options)
+{
+    int result = 0;
+    int i;
+
+    options->format = BENCH_FORMAT_CSV;
+    options->filter = NULL;
+    options->min_size = BENCH_DEFAULT_MIN_SIZE;
+    options->max_size = BENCH_DEFAULT_MAX_SIZE;
+    options->samples = BENCH_DEFAULT_SAMPLES;
+    options->sample_ms = BENCH_DEFAULT_SAMPLE_MS;
+
+    for (i = 1; (result == 0) && (i < argc); i++)
+    {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--help") == 0)
+        {
+            print_usage(argv[0]);
+            result = 1;
+        }
+        else if (strcmp(argv[i], "--list") == 0)
+        {
+            size_t c;
+            for (c = 0; c < BENCH_CASE_COUNT; c++)
+            {
+                (void)printf("%s,%s,%s\n", bench_cases[c].benchmark, bench_cases[c].implementation,
+                    (bench_cases[c].select() == 0) ? "supported" : "not supported");
+            }
+            (void)gballoc_setAllocator(NULL);
+            result = 1;
+        }
+        else if (value == NULL)
+        {
+            (void)fprintf(stderr, "missing value after %s\n", argv[i]);
+            result = -1;
+        }
+        else
+        {
+            if (strcmp(argv[i], "--format") == 0)
+            {
+                if (strcmp(value, "csv") == 0)
+                {
+                    options->format = BENCH_FORMAT_CSV;
+                }
+                else if (strcmp(value, "json") == 0)
+                {
+                    options->format = BENCH_FORMAT_JSON;
+                }
+                else
+                {
+                    result = -1;
+                }
+            }
+            else if (strcmp(argv[i], "--filter") == 0)
+            {
+                options->filter = value;
+            }
+            else if (strcmp(argv[i], "--min-size") == 0)
+            {
+                options->min_size = (size_t)strtoul(value, NULL, 10);
+            }
+            else if (strcmp(argv[i], "--max-size") == 0)
+            {
+                options->max_size = (size_t)strtoul(value, NULL, 10);
+            }
+            else if (strcmp(argv[i], "--samples") == 0)
+            {
+                options->samples = (unsigned int)strtoul(value, NULL, 10);
+            }
+            else if (strcmp(argv[i], "--sample-ms") == 0)
+            {
+                options->sample_ms = (unsigned int)strtoul(value, NULL, 10);
+            }
+            else
+            {
+                result = -1;
+            }
+
+            if (result != 0)
+            {
+                (void)fprintf(stderr, "invalid option %s %s\n", argv[i], value);
+            }
+            i++;
+        }
+    }
+
+    if ((result == 0) &&
+        ((options->min_size == 0) || (options->max_size < options->min_size) ||
+         (options->samples == 0) || (options->samples > BENCH_MAX_SAMPLES)))
+    {
+        (void)fprintf(stderr, "invalid sizes or number of samples\n");
+        result = -1;
+    }
+
+    if (result < 0)
+    {
+        print_usage(argv[0]);
+    }
+
+    return result;
+}
+
+static size_t bench_sink = 0;
+
+/* times the operation on one input: finds how many iterations last a sample, then takes the samples */
+static void measure(const BENCH_CASE* bench_case, const BENCH_OPTIONS* options, size_t size,
+    const unsigned char* input, size_t input_size, unsigned char* output, int* is_first_result)
+{
+    double sample_ns[BENCH_MAX_SAMPLES];
+    double sample_target_ns = (double)options->sample_ms * 1e6;
+    size_t iterations = 1;
+    size_t sink = 0;
+    unsigned int s;
+    double median;
+
+    /* warm up, then double the iterations until a sample is long enough */
+    sink += bench_case->run(input, input_size, output);
+    for (;;)
+    {
+        double start = now_ns();
+        size_t i;
+        double elapsed;
+        for (i = 0; i < iterations; i++)
+        {
+            sink += bench_case->run(input, input_size, output);
+        }
+        elapsed = now_ns() - start;
+        if (elapsed >= sample_target_ns)
+        {
+            break;
+        }
+        iterations = (elapsed * 4 < sample_target_ns) ? iterations * 4 : iterations * 2;
+    }
+
+    for (s = 0; s < options->samples; s++)
+    {
+        double start = now_ns();
+        size_t i;
+        for (i = 0; i < iterations; i++)
+        {
+            sink += bench_case->run(input, input_size, output);
+        }
+        sample_ns[s] = (now_ns() - start) / (double)iterations;
+    }
+    bench_sink += sink;
+
+    qsort(sample_ns, options->samples, sizeof(double), compare_doubles);
+    median = sample_ns[options->samples / 2];
+
+    if (options->format == BENCH_FORMAT_JSON)
+    {
+        (void)printf("%s    { \"benchmark\": \"%s\", \"implementation\": \"%s\", \"size\": %lu, \"iterations\": %lu, "
+            "\"ns_per_op_min\": %.1f, \"ns_per_op_median\": %.1f, \"ns_per_op_max\": %.1f, \"mb_per_s\": %.1f }",
+            (*is_first_result) ? "" : ",\n", bench_case->benchmark, bench_case->implementation, (unsigned long)size, (unsigned long)iterations,
+            sample_ns[0], median, sample_ns[options->samples - 1], (double)size * 1e3 / median);
+    }
+    else
+    {
+        (void)printf("%s,%s,%lu,%lu,%.1f,%.1f,%.1f,%.1f\n",
+            bench_case->benchmark, bench_case->implementation, (unsigned long)size, (unsigned long)iterations,
+            sample_ns[0], median, sample_ns[options->samples - 1], (double)size * 1e3 / median);
+    }
+    (void)fflush(stdout);
+    *is_first_result = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int result;
+    BENCH_OPTIONS options;
+    int parsed;
+
+    /* the library logs to stdout, which is where the results go; selecting an implementation the CPU does not have logs an error */
+    xlogging_set_log_function(NULL);
+
+#if defined(__GNUC__) && !defined(__OPTIMIZE__)
+    (void)fprintf(stderr, "warning: shared_util_bench is built without optimizations\n");
+#endif
+
+    parsed = parse_options(argc, argv, &options);
+
+    if (parsed != 0)
+    {
+        result = (parsed > 0) ? 0 : 1;
+    }
+    else
+    {
+        unsigned char* payload = (unsigned char*)malloc(options.max_size);
+        unsigned char* input = (unsigned char*)malloc(BENCH_BUFFER_SIZE(options.max_size));
+        unsigned char* output = (unsigned char*)malloc(BENCH_BUFFER_SIZE(options.max_size));
+
+        bench_output_size = BENCH_BUFFER_SIZE(options.max_size);
+        bench_hmacsha256_key = HMACSHA256_CreateKey(bench_key, sizeof(bench_key));
+        bench_arena = ARENA_create(0);
+        gballoc_getAllocator(&bench_default_allocator);
+        bench_bump = (unsigned char*)malloc(BENCH_BUMP_SIZE);
+
+        if ((payload == NULL) || (input == NULL) || (output == NULL) || (bench_hmacsha256_key == NULL) || (bench_arena == NULL) || (bench_bump == NULL))
+        {
+            (void)fprintf(stderr, "cannot allocate the buffers for %lu bytes payloads\n", (unsigned long)options.max_size);
+            result = 1;
+        }
+        else
+        {
+            uint32_t random_state = 0x2545F491;
+            int is_first_result = 1;
+            size_t c;
+            size_t i;
+
+            /* the same payload for every run, so that the results can be compared */
+            for (i = 0; i < options.max_size; i++)
+            {
+                random_state ^= random_state << 13;
+                random_state ^= random_state >> 17;
+                random_state ^= random_state << 5;
+                payload[i] = (unsigned char)random_state;
+            }
+
+            if (options.format == BENCH_FORMAT_JSON)
+            {
+                (void)printf("{ \"results\": [\n");
+            }
+            else
+            {
+                (void)printf("benchmark,implementation,size,iterations,ns_per_op_min,ns_per_op_median,ns_per_op_max,mb_per_s\n");
+            }
+
+            for (c = 0; c < BENCH_CASE_COUNT; c++)
+            {
+                if (((options.filter == NULL) || (strstr(bench_cases[c].benchmark, options.filter) != NULL)) &&
+                    (bench_cases[c].select() == 0))
+                {
+                    size_t size;
+                    for (size = options.min_size; size <= options.max_size; size = (size > options.max_size / 4) ? options.max_size + 1 : size * 4)
+                    {
+                        size_t input_size = bench_cases[c].prepare(payload, size, input);
+                        measure(&bench_cases[c], &options, size, input, input_size, output, &is_first_result);
+                    }
+                }
+            }
+
+            (void)gballoc_setAllocator(NULL);
+
+            if (options.format == BENCH_FORMAT_JSON)
+            {
+                (void)printf("\n] }\n");
+            }
+
+            result = (bench_sink == (size_t)-1) ? 1 : 0;
+        }
+
+        if (bench_hmacsha256_key != NULL)
+        {
+            HMACSHA256_DestroyKey(bench_hmacsha256_key);
+        }
+        ARENA_destroy(bench_arena);
+        free(bench_bump);
+        free(output);
+        free(input);
+        free(payload);
+    }
+
+    return result;
+}
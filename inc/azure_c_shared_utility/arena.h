@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/* An arena hands out memory by bumping a pointer through chunks obtained from malloc. Memory taken from an arena is
+never freed one block at a time: ARENA_reset gives all of it back at once and keeps the first chunk for reuse,
+ARENA_destroy releases everything. This fits scratch memory whose lifetime is one request or one operation.
+An arena is not thread safe. */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+typedef struct ARENA_TAG* ARENA_HANDLE;
+
+MOCKABLE_FUNCTION(, ARENA_HANDLE, ARENA_create, size_t, chunk_size);
+MOCKABLE_FUNCTION(, void, ARENA_destroy, ARENA_HANDLE, arena);
+MOCKABLE_FUNCTION(, void*, ARENA_malloc, ARENA_HANDLE, arena, size_t, size);
+MOCKABLE_FUNCTION(, void*, ARENA_realloc, ARENA_HANDLE, arena, void*, ptr, size_t, old_size, size_t, new_size);
+MOCKABLE_FUNCTION(, void, ARENA_reset, ARENA_HANDLE, arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -19,8 +19,43 @@ extern "C" {
 #include <stddef.h>
 #endif
 
+#include "azure_c_shared_utility/macro_utils.h"
 #include "azure_c_shared_utility/umock_c_prod.h"
 
+/**
+ * @brief	The implementations of the base64 encoding and decoding loops. The fastest one
+ * 			supported by the CPU is picked the first time something is encoded or decoded;
+ * 			@c Base64_SelectImplementation overrides that choice.
+ */
+#define BASE64_IMPLEMENTATION_VALUES    \
+    BASE64_IMPLEMENTATION_TABLE,        \
+    BASE64_IMPLEMENTATION_SSSE3,        \
+    BASE64_IMPLEMENTATION_AVX2,         \
+    BASE64_IMPLEMENTATION_NEON
+
+DEFINE_ENUM(BASE64_IMPLEMENTATION, BASE64_IMPLEMENTATION_VALUES);
+
+/**
+ * @brief	The state of a streaming encoding: the bytes of the group of 3 not encoded yet.
+ * 			The context is owned by the caller, usually on the stack; its fields are private.
+ */
+typedef struct BASE64_ENCODE_CONTEXT_TAG
+{
+    unsigned char pending[2];
+    size_t pendingSize;
+} BASE64_ENCODE_CONTEXT;
+
+/**
+ * @brief	The state of a streaming decoding: the characters of the group of 4 not decoded yet,
+ * 			and whether the padding was seen. The context is owned by the caller, usually on the
+ * 			stack; its fields are private.
+ */
+typedef struct BASE64_DECODE_CONTEXT_TAG
+{
+    char pending[3];
+    size_t pendingLength;
+    int isPadded;
+} BASE64_DECODE_CONTEXT;
 
 /**
  * @brief	Base64 encodes a buffer and returns the resulting string.
@@ -76,6 +111,141 @@ MOCKABLE_FUNCTION(, STRING_HANDLE, Base64_Encode_Bytes, const unsigned char*, so
  */
 MOCKABLE_FUNCTION(, BUFFER_HANDLE, Base64_Decoder, const char*, source);
 
+/**
+ * @brief	Returns the number of characters of the base64 encoding of @p size bytes.
+ *
+ * @param	size	The number of bytes to encode.
+ *
+ * @return	The number of characters, not counting a null terminator, or 0 if @p size is
+ * 			too large for the encoding to fit in a @c size_t.
+ */
+MOCKABLE_FUNCTION(, size_t, Base64_Encode_Length, size_t, size);
+
+/**
+ * @brief	Returns the number of bytes @p source decodes to.
+ *
+ * @param	source      	A base64 encoded string, not necessarily null terminated.
+ * @param	sourceLength	The number of characters in @p source.
+ *
+ * 			Only the length of @p source and its padding are looked at, not the other characters.
+ *
+ * @return	The number of bytes, or 0 if @p source is @c NULL or @p sourceLength is not a
+ * 			multiple of 4.
+ */
+MOCKABLE_FUNCTION(, size_t, Base64_Decode_Length, const char*, source, size_t, sourceLength);
+
+/**
+ * @brief	Base64 encodes @p size bytes into a buffer provided by the caller.
+ *
+ * @param	source         	The bytes to encode.
+ * @param	size           	The number of bytes to encode.
+ * @param	destination    	Where the encoding is written. No null terminator is added.
+ * @param	destinationSize	The size of @p destination, at least @c Base64_Encode_Length(size).
+ * @param	encodedLength  	Receives the number of characters written.
+ *
+ * @return	0 on success, a non-zero value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Encode_Into, const unsigned char*, source, size_t, size, char*, destination, size_t, destinationSize, size_t*, encodedLength);
+
+/**
+ * @brief	Base64 decodes @p sourceLength characters into a buffer provided by the caller.
+ *
+ * @param	source         	A base64 encoded string, not necessarily null terminated.
+ * @param	sourceLength   	The number of characters in @p source.
+ * @param	destination    	Where the decoded bytes are written.
+ * @param	destinationSize	The size of @p destination, at least @c Base64_Decode_Length(source, sourceLength).
+ * @param	decodedLength  	Receives the number of bytes written.
+ *
+ * @return	0 on success, a non-zero value if the arguments are invalid or @p source is not
+ * 			a valid base64 encoding.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Decode_Into, const char*, source, size_t, sourceLength, unsigned char*, destination, size_t, destinationSize, size_t*, decodedLength);
+
+/**
+ * @brief	Forces the implementation of the encoding and decoding loops.
+ *
+ * @param	implementation	The implementation.
+ *
+ * @return	0 on success, a non-zero value if this build or this CPU does not support
+ * 			@p implementation.
+ */
+MOCKABLE_FUNCTION(, int, Base64_SelectImplementation, BASE64_IMPLEMENTATION, implementation);
+
+/**
+ * @brief	Returns the implementation of the encoding and decoding loops in use.
+ */
+MOCKABLE_FUNCTION(, BASE64_IMPLEMENTATION, Base64_GetImplementation);
+
+/**
+ * @brief	Starts a streaming encoding, for input that is not all in memory at once.
+ *
+ * @param	context	The context to initialize.
+ *
+ * @return	0 on success, a non-zero value if @p context is @c NULL.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Encode_Init, BASE64_ENCODE_CONTEXT*, context);
+
+/**
+ * @brief	Encodes the next @p size bytes of a streaming encoding. The bytes that do not make
+ * 			a whole group of 3 are kept in @p context until the next call.
+ *
+ * @param	context        	A context initialized by @c Base64_Encode_Init.
+ * @param	source         	The next bytes to encode. May be @c NULL if @p size is 0.
+ * @param	size           	The number of bytes.
+ * @param	destination    	Where the encoding is written. No null terminator is added.
+ * @param	destinationSize	The size of @p destination, at least @c Base64_Encode_Length(size).
+ * @param	encodedLength  	Receives the number of characters written, which may be 0.
+ *
+ * @return	0 on success, a non-zero value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Encode_Update, BASE64_ENCODE_CONTEXT*, context, const unsigned char*, source, size_t, size, char*, destination, size_t, destinationSize, size_t*, encodedLength);
+
+/**
+ * @brief	Ends a streaming encoding, writing the last, padded, group.
+ *
+ * @param	context        	A context initialized by @c Base64_Encode_Init.
+ * @param	destination    	Where the last group is written. No null terminator is added.
+ * @param	destinationSize	The size of @p destination, at least 4.
+ * @param	encodedLength  	Receives the number of characters written, 0 or 4.
+ *
+ * @return	0 on success, a non-zero value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Encode_Final, BASE64_ENCODE_CONTEXT*, context, char*, destination, size_t, destinationSize, size_t*, encodedLength);
+
+/**
+ * @brief	Starts a streaming decoding, for input that is not all in memory at once.
+ *
+ * @param	context	The context to initialize.
+ *
+ * @return	0 on success, a non-zero value if @p context is @c NULL.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Decode_Init, BASE64_DECODE_CONTEXT*, context);
+
+/**
+ * @brief	Decodes the next @p sourceLength characters of a streaming decoding. The characters
+ * 			that do not make a whole group of 4 are kept in @p context until the next call.
+ *
+ * @param	context        	A context initialized by @c Base64_Decode_Init.
+ * @param	source         	The next characters to decode. May be @c NULL if @p sourceLength is 0.
+ * @param	sourceLength   	The number of characters.
+ * @param	destination    	Where the decoded bytes are written.
+ * @param	destinationSize	The size of @p destination, at least <tt>(sourceLength + 3) / 4 * 3</tt>.
+ * @param	decodedLength  	Receives the number of bytes written, which may be 0.
+ *
+ * @return	0 on success, a non-zero value if the arguments are invalid or the characters are
+ * 			not a valid base64 encoding. The decoding cannot go on after a failure.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Decode_Update, BASE64_DECODE_CONTEXT*, context, const char*, source, size_t, sourceLength, unsigned char*, destination, size_t, destinationSize, size_t*, decodedLength);
+
+/**
+ * @brief	Ends a streaming decoding.
+ *
+ * @param	context	A context initialized by @c Base64_Decode_Init.
+ *
+ * @return	0 if all the characters given made whole groups of 4, a non-zero value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Decode_Final, BASE64_DECODE_CONTEXT*, context);
+
 #ifdef __cplusplus
 }
 #endif
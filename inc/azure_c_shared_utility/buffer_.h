@@ -14,16 +14,21 @@ extern "C"
 #endif
 
 #include "azure_c_shared_utility/umock_c_prod.h"
+#include "azure_c_shared_utility/arena.h"
 
 typedef struct BUFFER_TAG* BUFFER_HANDLE;
 
 MOCKABLE_FUNCTION(, BUFFER_HANDLE, BUFFER_new);
 MOCKABLE_FUNCTION(, BUFFER_HANDLE, BUFFER_create, const unsigned char*, source, size_t, size);
+MOCKABLE_FUNCTION(, BUFFER_HANDLE, BUFFER_new_in_arena, ARENA_HANDLE, arena);
+MOCKABLE_FUNCTION(, BUFFER_HANDLE, BUFFER_create_in_arena, ARENA_HANDLE, arena, const unsigned char*, source, size_t, size);
+MOCKABLE_FUNCTION(, BUFFER_HANDLE, BUFFER_create_inline, const unsigned char*, source, size_t, size);
 MOCKABLE_FUNCTION(, void, BUFFER_delete, BUFFER_HANDLE, handle);
 MOCKABLE_FUNCTION(, int, BUFFER_pre_build, BUFFER_HANDLE, handle, size_t, size);
 MOCKABLE_FUNCTION(, int, BUFFER_build, BUFFER_HANDLE, handle, const unsigned char*, source, size_t, size);
 MOCKABLE_FUNCTION(, int, BUFFER_append_build, BUFFER_HANDLE, handle, const unsigned char*, source, size_t, size);
 MOCKABLE_FUNCTION(, int, BUFFER_unbuild, BUFFER_HANDLE, handle);
+MOCKABLE_FUNCTION(, int, BUFFER_detach, BUFFER_HANDLE, handle, unsigned char**, content, size_t*, size);
 MOCKABLE_FUNCTION(, int, BUFFER_enlarge, BUFFER_HANDLE, handle, size_t, enlargeSize);
 MOCKABLE_FUNCTION(, int, BUFFER_shrink, BUFFER_HANDLE, handle, size_t, decreaseSize, bool, fromEnd);
 MOCKABLE_FUNCTION(, int, BUFFER_content, BUFFER_HANDLE, handle, const unsigned char**, content);
@@ -5,15 +5,21 @@
 #define GBALLOC_H
 
 #include "azure_c_shared_utility/umock_c_prod.h"
+#include "azure_c_shared_utility/gballoc_allocator.h"
+#ifdef GB_USE_POOL
+#include "azure_c_shared_utility/gballoc_pool.h"
+#endif
 
 #ifdef __cplusplus
 #include <cstddef>
 #include <cstdlib>
+#include <cstdio>
 extern "C"
 {
 #else
 #include <stddef.h>
 #include <stdlib.h>
+#include <stdio.h>
 #endif
 
 /* all translation units that need memory measurement need to have GB_MEASURE_MEMORY_FOR_THIS defined */
@@ -32,6 +38,12 @@ MOCKABLE_FUNCTION(, size_t, gballoc_getCurrentMemoryUsed);
 MOCKABLE_FUNCTION(, size_t, gballoc_getAllocationCount);
 MOCKABLE_FUNCTION(, void, gballoc_resetMetrics);
 
+/* site profiling accounts every tracked block to the code address that allocated it, see gballoc_requirements.md */
+MOCKABLE_FUNCTION(, int, gballoc_startSiteProfiling);
+MOCKABLE_FUNCTION(, void, gballoc_stopSiteProfiling);
+MOCKABLE_FUNCTION(, int, gballoc_dumpSiteReport, FILE*, destination);
+MOCKABLE_FUNCTION(, int, gballoc_dumpHeapProfile, FILE*, destination);
+
 /* if GB_MEASURE_MEMORY_FOR_THIS is defined then we want to redirect memory allocation functions to gballoc_xxx functions */
 #ifdef GB_MEASURE_MEMORY_FOR_THIS
 /* Unfortunately this is still needed here for things to still compile when using _CRTDBG_MAP_ALLOC.
@@ -55,14 +67,38 @@ That is because there is a rogue component (most likely CppUnitTest) including c
 
 #else /* GB_DEBUG_ALLOC */
 
+#ifdef GB_USE_POOL
+/* with GB_USE_POOL the size-class pools serve the memory allocation functions from gballoc_init to gballoc_deinit */
+#define gballoc_init() gballoc_pool_init()
+#define gballoc_deinit() gballoc_pool_deinit()
+#else
 #define gballoc_init() 0
 #define gballoc_deinit() ((void)0)
+#endif
 
 #define gballoc_getMaximumMemoryUsed() SIZE_MAX
 #define gballoc_getCurrentMemoryUsed() SIZE_MAX
 #define gballoc_getAllocationCount() SIZE_MAX
 #define gballoc_resetMetrics() ((void)0)
 
+#define gballoc_startSiteProfiling() 1
+#define gballoc_stopSiteProfiling() ((void)0)
+#define gballoc_dumpSiteReport(destination) 1
+#define gballoc_dumpHeapProfile(destination) 1
+
+/* with GB_USE_ALLOCATOR_HOOKS the memory allocation functions go through the allocator installed with gballoc_setAllocator */
+#ifdef GB_USE_ALLOCATOR_HOOKS
+#define malloc gballoc_allocatorMalloc
+#define calloc gballoc_allocatorCalloc
+#define realloc gballoc_allocatorRealloc
+#define free gballoc_allocatorFree
+#elif defined(GB_USE_POOL)
+#define malloc gballoc_pool_malloc
+#define calloc gballoc_pool_calloc
+#define realloc gballoc_pool_realloc
+#define free gballoc_pool_free
+#endif
+
 #endif /* GB_DEBUG_ALLOC */
 
 #ifdef __cplusplus
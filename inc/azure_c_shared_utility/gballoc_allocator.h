@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/* The allocator gballoc gets its memory from can be replaced at run time, for example to route the library onto
+another general purpose allocator or onto per-connection arenas. When the library is built with use_allocator_hooks
+(GB_USE_ALLOCATOR_HOOKS) every module that includes gballoc.h calls malloc, calloc, realloc and free through the
+installed allocator; otherwise only gballoc_malloc and friends use it. See gballoc_requirements.md. */
+
+#ifndef GBALLOC_ALLOCATOR_H
+#define GBALLOC_ALLOCATOR_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+typedef void*(*GBALLOC_MALLOC_FUNCTION)(void* context, size_t size);
+typedef void*(*GBALLOC_CALLOC_FUNCTION)(void* context, size_t nmemb, size_t size);
+typedef void*(*GBALLOC_REALLOC_FUNCTION)(void* context, void* ptr, size_t size);
+typedef void(*GBALLOC_FREE_FUNCTION)(void* context, void* ptr);
+typedef void*(*GBALLOC_ALIGNED_MALLOC_FUNCTION)(void* context, size_t alignment, size_t size);
+typedef void(*GBALLOC_ALIGNED_FREE_FUNCTION)(void* context, void* ptr);
+
+typedef struct GBALLOC_ALLOCATOR_TAG
+{
+    GBALLOC_MALLOC_FUNCTION malloc_function;
+    GBALLOC_REALLOC_FUNCTION realloc_function;
+    GBALLOC_FREE_FUNCTION free_function;
+    /* optional, gballoc falls back to malloc_function and clears the block when NULL */
+    GBALLOC_CALLOC_FUNCTION calloc_function;
+    /* optional, both or neither; gballoc over-allocates from malloc_function when NULL */
+    GBALLOC_ALIGNED_MALLOC_FUNCTION aligned_malloc_function;
+    GBALLOC_ALIGNED_FREE_FUNCTION aligned_free_function;
+    /* passed as is to every function above */
+    void* context;
+} GBALLOC_ALLOCATOR;
+
+MOCKABLE_FUNCTION(, int, gballoc_setAllocator, const GBALLOC_ALLOCATOR*, allocator);
+MOCKABLE_FUNCTION(, void, gballoc_getAllocator, GBALLOC_ALLOCATOR*, allocator);
+
+MOCKABLE_FUNCTION(, void*, gballoc_allocatorMalloc, size_t, size);
+MOCKABLE_FUNCTION(, void*, gballoc_allocatorCalloc, size_t, nmemb, size_t, size);
+MOCKABLE_FUNCTION(, void*, gballoc_allocatorRealloc, void*, ptr, size_t, size);
+MOCKABLE_FUNCTION(, void, gballoc_allocatorFree, void*, ptr);
+MOCKABLE_FUNCTION(, void*, gballoc_allocatorAlignedMalloc, size_t, alignment, size_t, size);
+MOCKABLE_FUNCTION(, void, gballoc_allocatorAlignedFree, void*, ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GBALLOC_ALLOCATOR_H */
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/* gballoc_pool serves small allocations from fixed size classes carved out of slabs, with a per thread cache in front
+of a shared free list. Requests larger than the largest class go to malloc. Every block carries a small header, so
+any pointer returned by this module can be given back to gballoc_pool_free or gballoc_pool_realloc.
+When the library is built with use_gballoc_pool (GB_USE_POOL), gballoc.h maps malloc & co. onto this module, gballoc_init
+and gballoc_deinit start and stop the pools, and the pools are the default allocator of gballoc_malloc & co. and of the
+allocator hooks. Every block the library hands out then carries a pool header, also before gballoc_init, so it has to
+be given back with free from a module that includes gballoc.h and is built with GB_USE_POOL (the aziotsharedutil target
+exports the define to the targets linking it) or with gballoc_pool_free; the C runtime free cannot release it.
+Otherwise gballoc_pool_getAllocator gives an allocator that can be installed with gballoc_setAllocator. */
+
+#ifndef GBALLOC_POOL_H
+#define GBALLOC_POOL_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+#include "azure_c_shared_utility/gballoc_allocator.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+#define GBALLOC_POOL_CLASS_COUNT 8
+
+typedef struct GBALLOC_POOL_CLASS_STATISTICS_TAG
+{
+    /* largest request served by the class */
+    size_t block_size;
+    size_t slab_count;
+    /* blocks carved out of the slabs of the class */
+    size_t block_count;
+    /* blocks handed out to callers */
+    size_t used_block_count;
+    /* blocks in the shared free list or in a thread cache */
+    size_t free_block_count;
+    /* bytes asked for by the callers holding the used blocks */
+    size_t requested_bytes;
+    /* used_block_count * block_size - requested_bytes, lost to rounding requests up to the class size */
+    size_t wasted_bytes;
+    /* allocations served by the class since gballoc_pool_init */
+    size_t allocation_count;
+} GBALLOC_POOL_CLASS_STATISTICS;
+
+/* Counters kept by a thread cache reach the shared statistics whenever the cache exchanges blocks with the shared
+free list and when that thread calls gballoc_pool_get_statistics, so the numbers seen from one thread can be behind
+the activity of other threads by at most one cache worth of blocks per class. */
+typedef struct GBALLOC_POOL_STATISTICS_TAG
+{
+    GBALLOC_POOL_CLASS_STATISTICS classes[GBALLOC_POOL_CLASS_COUNT];
+    /* allocations too large for any class, served by malloc since gballoc_pool_init */
+    size_t large_allocation_count;
+} GBALLOC_POOL_STATISTICS;
+
+MOCKABLE_FUNCTION(, int, gballoc_pool_init);
+MOCKABLE_FUNCTION(, void, gballoc_pool_deinit);
+MOCKABLE_FUNCTION(, void*, gballoc_pool_malloc, size_t, size);
+MOCKABLE_FUNCTION(, void*, gballoc_pool_calloc, size_t, nmemb, size_t, size);
+MOCKABLE_FUNCTION(, void*, gballoc_pool_realloc, void*, ptr, size_t, size);
+MOCKABLE_FUNCTION(, void, gballoc_pool_free, void*, ptr);
+MOCKABLE_FUNCTION(, int, gballoc_pool_get_statistics, GBALLOC_POOL_STATISTICS*, statistics);
+MOCKABLE_FUNCTION(, void, gballoc_pool_getAllocator, GBALLOC_ALLOCATOR*, allocator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GBALLOC_POOL_H */
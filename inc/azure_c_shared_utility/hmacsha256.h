@@ -6,6 +6,7 @@
 
 #include "azure_c_shared_utility/macro_utils.h"
 #include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/sha.h"
 #include "azure_c_shared_utility/umock_c_prod.h"
 
 #ifdef __cplusplus
@@ -19,8 +20,28 @@ extern "C" {
 
 DEFINE_ENUM(HMACSHA256_RESULT, HMACSHA256_RESULT_VALUES)
 
+#define HMACSHA256_HASH_SIZE SHA256HashSize
+
+/* A key whose inner and outer padded blocks are hashed once, so that signing a payload only hashes the payload and the inner digest. */
+typedef struct HMACSHA256_KEY_TAG* HMACSHA256_KEY_HANDLE;
+
+/* One of the independent HMACs computed by HMACSHA256_ComputeHashBatch. */
+typedef struct HMACSHA256_BATCH_ITEM_TAG
+{
+    const unsigned char* key;
+    size_t keyLen;
+    const unsigned char* payload;
+    size_t payloadLen;
+    unsigned char hash[HMACSHA256_HASH_SIZE];
+} HMACSHA256_BATCH_ITEM;
+
 MOCKABLE_FUNCTION(, HMACSHA256_RESULT, HMACSHA256_ComputeHash, const unsigned char*, key, size_t, keyLen, const unsigned char*, payload, size_t, payloadLen, BUFFER_HANDLE, hash);
 
+MOCKABLE_FUNCTION(, HMACSHA256_KEY_HANDLE, HMACSHA256_CreateKey, const unsigned char*, key, size_t, keyLen);
+MOCKABLE_FUNCTION(, void, HMACSHA256_DestroyKey, HMACSHA256_KEY_HANDLE, keyHandle);
+MOCKABLE_FUNCTION(, HMACSHA256_RESULT, HMACSHA256_ComputeHashBatch, HMACSHA256_BATCH_ITEM*, items, size_t, itemCount);
+MOCKABLE_FUNCTION(, HMACSHA256_RESULT, HMACSHA256_ComputeHashWithKey, HMACSHA256_KEY_HANDLE, keyHandle, const unsigned char*, payload, size_t, payloadLen, unsigned char, hash[HMACSHA256_HASH_SIZE]);
+
 #ifdef __cplusplus
 }
 #endif
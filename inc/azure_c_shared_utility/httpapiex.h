@@ -18,6 +18,7 @@
 
 #include "azure_c_shared_utility/macro_utils.h"
 #include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/tickcounter.h"
 #include "azure_c_shared_utility/umock_c_prod.h"
  
 #ifdef __cplusplus
@@ -40,6 +41,36 @@ typedef struct HTTPAPIEX_HANDLE_DATA_TAG* HTTPAPIEX_HANDLE;
 */
 DEFINE_ENUM(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
 
+/** @brief Describes how failed requests are retried.
+*
+*	@details	An attempt is the whole recovery sequence performed by
+*				@c HTTPAPIEX_ExecuteRequest (HTTPAPI_Init, HTTPAPI_CreateConnection,
+*				HTTPAPI_ExecuteRequest). When an attempt ends in
+*				@c HTTPAPIEX_RECOVERYFAILED another one is started after a delay that
+*				doubles every time, starting at @c initial_delay_ms and never exceeding
+*				@c max_delay_ms. Up to @c jitter_percent percent of each delay is
+*				randomly removed so that clients that failed together do not retry
+*				together.
+*/
+typedef struct HTTPAPIEX_RETRY_POLICY_TAG
+{
+    /** Total number of attempts, including the first one. Must be at least 1. */
+    size_t max_attempts;
+    /** Delay before the second attempt. */
+    tickcounter_ms_t initial_delay_ms;
+    /** Upper bound of the delay between two attempts. Must not be lower than @c initial_delay_ms. */
+    tickcounter_ms_t max_delay_ms;
+    /** Percentage (0 to 100) of each delay that may be randomly removed. */
+    unsigned int jitter_percent;
+    /** No attempt is started once this many milliseconds passed since the first one. 0 means no deadline. */
+    tickcounter_ms_t deadline_ms;
+} HTTPAPIEX_RETRY_POLICY;
+
+/** @brief Called by @c HTTPAPIEX_DoWork when a request started by
+*	@c HTTPAPIEX_ExecuteRequestAsync succeeded or ran out of attempts.
+*/
+typedef void(*ON_HTTPAPIEX_EXECUTE_REQUEST_COMPLETE)(void* context, HTTPAPIEX_RESULT result, unsigned int statusCode);
+
 /**
  * @brief	Creates an @c HTTPAPIEX_HANDLE that can be used in further calls.
  *
@@ -99,6 +130,47 @@ MOCKABLE_FUNCTION(, void, HTTPAPIEX_Destroy, HTTPAPIEX_HANDLE, handle);
  */
 MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_SetOption, HTTPAPIEX_HANDLE, handle, const char*, optionName, const void*, value);
 
+/**
+ * @brief	Sets the policy used to retry failed requests.
+ *
+ * @param	handle	  	The @c HTTPAPIEX_HANDLE representing this session.
+ * @param	retryPolicy	The policy to be copied. By default a request is attempted once.
+ *
+ * @return	An @c HTTPAPIEX_RESULT indicating the status of the call.
+ */
+MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_SetRetryPolicy, HTTPAPIEX_HANDLE, handle, const HTTPAPIEX_RETRY_POLICY*, retryPolicy);
+
+/**
+ * @brief	Queues an HTTP request that is executed, and retried according to the
+ *			retry policy, by subsequent calls to @c HTTPAPIEX_DoWork.
+ *
+ * @param	handle					 	A valid @c HTTPAPIEX_HANDLE value.
+ * @param	requestType				 	A value from the ::HTTPAPI_REQUEST_TYPE enum.
+ * @param	relativePath			 	Relative path to send the request to on the server.
+ * @param	requestHttpHeadersHandle 	Handle to the request HTTP headers.
+ * @param	requestContent			 	The request content.
+ * @param	responseHttpHeadersHandle	Handle to the response HTTP headers.
+ * @param	responseContent			 	The response content.
+ * @param	on_execute_complete		 	Called once the request completed.
+ * @param	callback_context		 	Context passed to @p on_execute_complete.
+ *
+ * 			The handles passed to @c HTTPAPIEX_ExecuteRequestAsync shall stay valid
+ * 			until @p on_execute_complete is called. Only one request can be pending on
+ * 			a handle. No waiting happens between attempts; @c HTTPAPIEX_DoWork simply
+ * 			does nothing until the next attempt is due.
+ *
+ * @return	An @c HTTPAPIEX_RESULT indicating the status of the call.
+ */
+MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_ExecuteRequestAsync, HTTPAPIEX_HANDLE, handle, HTTPAPI_REQUEST_TYPE, requestType, const char*, relativePath, HTTP_HEADERS_HANDLE, requestHttpHeadersHandle, BUFFER_HANDLE, requestContent, HTTP_HEADERS_HANDLE, responseHttpHeadersHandle, BUFFER_HANDLE, responseContent, ON_HTTPAPIEX_EXECUTE_REQUEST_COMPLETE, on_execute_complete, void*, callback_context);
+
+/**
+ * @brief	Executes the request queued by @c HTTPAPIEX_ExecuteRequestAsync when its
+ *			next attempt is due.
+ *
+ * @param	handle	The @c HTTPAPIEX_HANDLE representing this session.
+ */
+MOCKABLE_FUNCTION(, void, HTTPAPIEX_DoWork, HTTPAPIEX_HANDLE, handle);
+
 #ifdef __cplusplus
 }
 #endif
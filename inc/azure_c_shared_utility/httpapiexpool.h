@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file httpapiexpool.h
+*	@brief		Keeps a bounded number of @c HTTPAPIEX_HANDLE objects per host so
+*				that their connections can be reused by several threads.
+*
+*	@details	A handle is checked out by one caller at a time. Checking it back in
+*				keeps its connection open for the next caller, unless the caller
+*				reports it as unhealthy, in which case it is destroyed. Handles that
+*				stay checked in for longer than the idle timeout are destroyed.
+*/
+
+#ifndef HTTPAPIEX_POOL_H
+#define HTTPAPIEX_POOL_H
+
+#include "azure_c_shared_utility/httpapiex.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C" {
+#else
+#include <stddef.h>
+#include <stdbool.h>
+#endif
+
+typedef struct HTTPAPIEX_POOL_TAG* HTTPAPIEX_POOL_HANDLE;
+
+/**
+ * @brief	Creates an empty pool.
+ *
+ * @param	maxHandlesPerHost	Maximum number of handles, checked in or out, for one host.
+ * @param	idleTimeoutInMs	 	Checked in handles are destroyed after this many
+ * 								milliseconds. 0 means never.
+ *
+ * @return	A handle to the pool or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, HTTPAPIEX_POOL_HANDLE, HTTPAPIEX_POOL_Create, size_t, maxHandlesPerHost, tickcounter_ms_t, idleTimeoutInMs);
+
+/**
+ * @brief	Destroys the pool and all its handles. No handle shall be checked out.
+ */
+MOCKABLE_FUNCTION(, void, HTTPAPIEX_POOL_Destroy, HTTPAPIEX_POOL_HANDLE, pool);
+
+/**
+ * @brief	Gets a handle for @p hostName for the exclusive use of the caller.
+ *
+ * 			The most recently checked in handle is preferred since its connection is
+ * 			the least likely to have been closed by the server. A new handle is created
+ * 			when none is checked in and the limit for the host is not reached. This
+ * 			call does not wait for a handle to be checked in.
+ *
+ * @return	An @c HTTPAPIEX_HANDLE or @c NULL if none is available.
+ */
+MOCKABLE_FUNCTION(, HTTPAPIEX_HANDLE, HTTPAPIEX_POOL_Checkout, HTTPAPIEX_POOL_HANDLE, pool, const char*, hostName);
+
+/**
+ * @brief	Gives back a handle obtained from @c HTTPAPIEX_POOL_Checkout.
+ *
+ * @param	isHealthy	@c false when the last request on @p handle failed, in which
+ * 						case the handle is destroyed instead of being reused.
+ */
+MOCKABLE_FUNCTION(, void, HTTPAPIEX_POOL_Checkin, HTTPAPIEX_POOL_HANDLE, pool, HTTPAPIEX_HANDLE, handle, bool, isHealthy);
+
+/**
+ * @brief	Destroys the handles that stayed checked in for longer than the idle timeout.
+ */
+MOCKABLE_FUNCTION(, void, HTTPAPIEX_POOL_EvictIdle, HTTPAPIEX_POOL_HANDLE, pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTTPAPIEX_POOL_H */
@@ -17,10 +17,23 @@ extern "C" {
 
 typedef struct HTTPAPIEX_SAS_STATE_TAG* HTTPAPIEX_SAS_HANDLE;
 
+typedef struct HTTPAPIEX_SAS_TOKEN_STATISTICS_TAG
+{
+    /* number of tokens created by SASToken_Create */
+    size_t regenerations;
+    /* number of requests that reused the previously created token */
+    size_t reuses;
+} HTTPAPIEX_SAS_TOKEN_STATISTICS;
+
 MOCKABLE_FUNCTION(, HTTPAPIEX_SAS_HANDLE, HTTPAPIEX_SAS_Create, STRING_HANDLE, key, STRING_HANDLE, uriResource, STRING_HANDLE, keyName);
 
 MOCKABLE_FUNCTION(, void, HTTPAPIEX_SAS_Destroy, HTTPAPIEX_SAS_HANDLE, handle);
 
+/* A SAS token is reused until refreshPercent percent of its lifetime passed. refreshPercent 0 creates a token for every request. */
+MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_SAS_SetTokenLifetime, HTTPAPIEX_SAS_HANDLE, sasHandle, size_t, tokenLifetimeInSeconds, unsigned int, refreshPercent);
+
+MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_SAS_GetTokenStatistics, HTTPAPIEX_SAS_HANDLE, sasHandle, HTTPAPIEX_SAS_TOKEN_STATISTICS*, statistics);
+
 MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_SAS_ExecuteRequest, HTTPAPIEX_SAS_HANDLE, sasHandle, HTTPAPIEX_HANDLE, handle, HTTPAPI_REQUEST_TYPE, requestType, const char*, relativePath, HTTP_HEADERS_HANDLE, requestHttpHeadersHandle, BUFFER_HANDLE, requestContent, unsigned int*, statusCode, HTTP_HEADERS_HANDLE, responseHeadersHandle, BUFFER_HANDLE, responseContent);
 
 #ifdef __cplusplus
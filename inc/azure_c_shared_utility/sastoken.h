@@ -12,9 +12,20 @@
 extern "C" {
 #endif
 
+    /* One of the tokens created by SASToken_CreateBatch; token is set by SASToken_CreateBatch and owned by the caller. */
+    typedef struct SASTOKEN_BATCH_ITEM_TAG
+    {
+        const char* key;
+        const char* scope;
+        const char* keyName;
+        size_t expiry;
+        STRING_HANDLE token;
+    } SASTOKEN_BATCH_ITEM;
+
     MOCKABLE_FUNCTION(, bool, SASToken_Validate, STRING_HANDLE, sasToken);
     MOCKABLE_FUNCTION(, STRING_HANDLE, SASToken_Create, STRING_HANDLE, key, STRING_HANDLE, scope, STRING_HANDLE, keyName, size_t, expiry);
     MOCKABLE_FUNCTION(, STRING_HANDLE, SASToken_CreateString, const char*, key, const char*, scope, const char*, keyName, size_t, expiry);
+    MOCKABLE_FUNCTION(, int, SASToken_CreateBatch, SASTOKEN_BATCH_ITEM*, items, size_t, itemCount);
 
 #ifdef __cplusplus
 }
@@ -5,6 +5,9 @@
 /********************** See RFC 4634 for details *********************/
 #ifndef _SHA_PRIVATE__H
 #define _SHA_PRIVATE__H
+
+#include <stddef.h>
+#include "azure_c_shared_utility/sha.h"
 /*
 * These definitions are defined in FIPS-180-2, section 4.1.
 * Ch() and Maj() are defined identically in sections 4.1.1,
@@ -29,5 +32,63 @@
 
 #define SHA_Parity(x, y, z)  ((x) ^ (y) ^ (z))
 
+/*
+ * A SHA-224/SHA-256 block function: hashes blockCount consecutive
+ * 64 byte blocks into the 8 word intermediate hash.
+ */
+typedef void (*SHA256ProcessBlocksFunction)(uint32_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount);
+
+/*
+ * Returns the hardware accelerated block function for implementation,
+ * or NULL if this build or this CPU does not support it (sha256_hw.c).
+ */
+extern SHA256ProcessBlocksFunction SHA256GetHardwareProcessBlocks(
+    SHA256Implementation implementation);
+
+/*
+ * A SHA-384/SHA-512 block function: hashes blockCount consecutive
+ * 128 byte blocks into the 8 word intermediate hash.
+ */
+typedef void (*SHA512ProcessBlocksFunction)(uint64_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount);
+
+/*
+ * Returns the hardware accelerated block function for implementation,
+ * or NULL if this build or this CPU does not support it (sha512_hw.c).
+ */
+extern SHA512ProcessBlocksFunction SHA512GetHardwareProcessBlocks(
+    SHA512Implementation implementation);
+
+/*
+ * A multi-buffer SHA-256 block function: hashes one 64 byte block
+ * per lane. state holds the 8 words of the intermediate hashes word
+ * by word: state[word * laneCount + lane].
+ */
+typedef void (*SHA256ProcessLanesFunction)(uint32_t *state,
+    const uint8_t *const blocks[]);
+
+/*
+ * Returns the multi-buffer block function for implementation and its
+ * lane count, or NULL if this build or this CPU does not support it
+ * (sha256_hw.c).
+ */
+extern SHA256ProcessLanesFunction SHA256GetHardwareProcessLanes(
+    SHA256BatchImplementation implementation, size_t *laneCount);
+
+/*
+ * A message hashed by SHA256ProcessBatch: the optional 64 byte
+ * prefix block followed by length bytes of data. HMAC uses the
+ * prefix for the padded key.
+ */
+typedef struct SHA256BatchJob {
+    const uint8_t *prefix;
+    const uint8_t *data;
+    size_t length;
+    uint8_t *digest;
+} SHA256BatchJob;
+
+extern int SHA256ProcessBatch(const SHA256BatchJob *jobs, size_t jobCount);
+
 #endif /* _SHA_PRIVATE__H */
 
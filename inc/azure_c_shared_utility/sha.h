@@ -32,6 +32,7 @@ extern "C"
  *              SHA-512         64 byte / 512 bit
  */
 
+#include <stddef.h>
 #include <stdint.h>
 /*
  * If you do not have the ISO standard stdint.h header file, then you
@@ -211,6 +212,43 @@ extern int SHA256FinalBits(SHA256Context *, const uint8_t bits,
 extern int SHA256Result(SHA256Context *,
                         uint8_t Message_Digest[SHA256HashSize]);
 
+/*
+ *  These are the implementations of the SHA-224/SHA-256 block
+ *  function. The fastest one supported by the CPU is picked the
+ *  first time a block is hashed; SHA256SelectImplementation
+ *  overrides that choice (it returns shaBadParam when the
+ *  implementation is not supported by this build or by this CPU).
+ */
+typedef enum SHA256Implementation {
+    sha256Portable,         /* RFC 4634 reference code, always available */
+    sha256X86ShaExtensions, /* Intel SHA extensions (SHA-NI) */
+    sha256ArmV8Crypto       /* ARMv8 SHA-256 instructions */
+} SHA256Implementation;
+
+extern int SHA256IsImplementationSupported(SHA256Implementation);
+extern int SHA256SelectImplementation(SHA256Implementation);
+extern SHA256Implementation SHA256GetImplementation(void);
+
+/*
+ *  SHA256HashBatch hashes messageCount independent messages, several
+ *  at once when the CPU has wide enough vector units: each message
+ *  is given a lane and lanes are refilled as messages complete.
+ *  These are the implementations; the fastest one supported by the
+ *  CPU is picked the first time a batch is hashed.
+ */
+typedef enum SHA256BatchImplementation {
+    sha256BatchSerial,      /* one message after the other */
+    sha256BatchAvx2,        /* 8 messages at once (AVX2) */
+    sha256BatchAvx512       /* 16 messages at once (AVX-512F) */
+} SHA256BatchImplementation;
+
+extern int SHA256HashBatch(const uint8_t *const messages[],
+                           const unsigned int lengths[], size_t messageCount,
+                           uint8_t digests[][SHA256HashSize]);
+extern int SHA256BatchIsImplementationSupported(SHA256BatchImplementation);
+extern int SHA256BatchSelectImplementation(SHA256BatchImplementation);
+extern SHA256BatchImplementation SHA256BatchGetImplementation(void);
+
 /* SHA-384 */
 extern int SHA384Reset(SHA384Context *);
 extern int SHA384Input(SHA384Context *, const uint8_t *bytes,
@@ -229,6 +267,24 @@ extern int SHA512FinalBits(SHA512Context *, const uint8_t bits,
 extern int SHA512Result(SHA512Context *,
                         uint8_t Message_Digest[SHA512HashSize]);
 
+/*
+ *  These are the implementations of the SHA-384/SHA-512 block
+ *  function. The fastest one supported by the CPU is picked the
+ *  first time a block is hashed, and runs of fewer than 4 blocks
+ *  still use sha512Unrolled; SHA512SelectImplementation overrides
+ *  that choice for every run (it returns shaBadParam when the
+ *  implementation is not supported by this build or by this CPU).
+ */
+typedef enum SHA512Implementation {
+    sha512Portable,         /* RFC 4634 reference code, always available */
+    sha512Unrolled,         /* unrolled rounds, always available */
+    sha512X86Avx2           /* unrolled rounds, AVX2 message schedule */
+} SHA512Implementation;
+
+extern int SHA512IsImplementationSupported(SHA512Implementation);
+extern int SHA512SelectImplementation(SHA512Implementation);
+extern SHA512Implementation SHA512GetImplementation(void);
+
 /* Unified SHA functions, chosen by whichSha */
 extern int USHAReset(USHAContext *, SHAversion whichSha);
 extern int USHAInput(USHAContext *,
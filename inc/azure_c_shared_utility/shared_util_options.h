@@ -19,6 +19,8 @@ extern "C"
 
     static const char* OPTION_HTTP_PROXY = "proxy_data";
     static const char* OPTION_HTTP_TIMEOUT = "timeout";
+    static const char* OPTION_HTTP_KEEP_ALIVE = "http_keep_alive";
+    static const char* OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT = "http_keep_alive_idle_timeout";
 
     static const char* OPTION_TRUSTED_CERT = "TrustedCerts";
 
@@ -6,6 +6,7 @@
 
 #include "azure_c_shared_utility/umock_c_prod.h"
 #include "azure_c_shared_utility/strings_types.h"
+#include "azure_c_shared_utility/arena.h"
 
 #ifdef __cplusplus
 #include <cstddef>
@@ -18,6 +19,9 @@ extern "C"
 MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_new);
 MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_clone, STRING_HANDLE, handle);
 MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_construct, const char*, psz);
+MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_new_in_arena, ARENA_HANDLE, arena);
+MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_construct_in_arena, ARENA_HANDLE, arena, const char*, psz);
+MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_construct_inline, const char*, psz);
 MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_construct_n, const char*, psz, size_t, n);
 MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_new_with_memory, const char*, memory);
 MOCKABLE_FUNCTION(, STRING_HANDLE, STRING_new_quoted, const char*, source);
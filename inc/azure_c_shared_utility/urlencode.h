@@ -14,6 +14,13 @@ extern "C" {
 
     MOCKABLE_FUNCTION(, STRING_HANDLE, URL_EncodeString, const char*, textEncode);
     MOCKABLE_FUNCTION(, STRING_HANDLE, URL_Encode, STRING_HANDLE, input);
+    MOCKABLE_FUNCTION(, int, URL_EncodeAppend, STRING_HANDLE, destination, const char*, textEncode);
+    MOCKABLE_FUNCTION(, size_t, URL_Encode_Length, const char*, text, size_t, length);
+    MOCKABLE_FUNCTION(, int, URL_Encode_Into, const char*, text, size_t, length, char*, destination, size_t, destinationSize, size_t*, encodedLength);
+    /* URL_Decode only reverses URL_Encode for ASCII text: URL_Encode takes the bytes from 0x80 as Latin-1 and
+    escapes their UTF-8 encoding, which URL_Decode gives back as the 2 UTF-8 bytes. */
+    MOCKABLE_FUNCTION(, STRING_HANDLE, URL_DecodeString, const char*, textDecode);
+    MOCKABLE_FUNCTION(, STRING_HANDLE, URL_Decode, STRING_HANDLE, input);
 
 #ifdef __cplusplus
 }
@@ -13,10 +13,36 @@ extern "C" {
 #include <stddef.h>
 #endif
 
+#include "azure_c_shared_utility/macro_utils.h"
 #include "azure_c_shared_utility/umock_c_prod.h"
 
+/* the fastest implementation supported by the CPU is picked on first use, utf8_checker_select_implementation overrides the choice */
+#define UTF8_CHECKER_IMPLEMENTATION_VALUES      \
+    UTF8_CHECKER_IMPLEMENTATION_SCALAR,         \
+    UTF8_CHECKER_IMPLEMENTATION_SSSE3,          \
+    UTF8_CHECKER_IMPLEMENTATION_AVX2,           \
+    UTF8_CHECKER_IMPLEMENTATION_NEON
+
+DEFINE_ENUM(UTF8_CHECKER_IMPLEMENTATION, UTF8_CHECKER_IMPLEMENTATION_VALUES);
+
+/* the state of an incremental validation, for text that arrives in pieces (fragmented WebSocket frames);
+   owned by the caller, usually on the stack; its fields are private */
+typedef struct UTF8_CHECKER_CONTEXT_TAG
+{
+    unsigned char pending[3];
+    size_t pending_length;
+    bool is_valid;
+} UTF8_CHECKER_CONTEXT;
+
 MOCKABLE_FUNCTION(, bool, utf8_checker_is_valid_utf8, const unsigned char*, utf8_str, size_t, length);
 
+MOCKABLE_FUNCTION(, int, utf8_checker_select_implementation, UTF8_CHECKER_IMPLEMENTATION, implementation);
+MOCKABLE_FUNCTION(, UTF8_CHECKER_IMPLEMENTATION, utf8_checker_get_implementation);
+
+MOCKABLE_FUNCTION(, int, utf8_checker_init, UTF8_CHECKER_CONTEXT*, context);
+MOCKABLE_FUNCTION(, bool, utf8_checker_update, UTF8_CHECKER_CONTEXT*, context, const unsigned char*, utf8_str, size_t, length);
+MOCKABLE_FUNCTION(, bool, utf8_checker_final, UTF8_CHECKER_CONTEXT*, context);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -18,6 +18,9 @@ extern "C" {
 
 typedef unsigned char UUID[16];
 
+#define UUID_STRING_LENGTH  36
+#define UUID_STRING_SIZE    (UUID_STRING_LENGTH + 1)
+
 /* @brief               Generates a true UUID
 *  @param uuid          A pre-allocated buffer for the bytes of the generated UUID
 *  @returns             Zero if no failures occur, non-zero otherwise.
@@ -37,6 +40,29 @@ MOCKABLE_FUNCTION(, int, UUID_from_string, const char*, uuid_string, UUID*, uuid
 */
 MOCKABLE_FUNCTION(, char*, UUID_to_string, UUID*, uuid);
 
+/* @brief                   Writes the string representation of the UUID value into a buffer provided by the caller.
+*  @param uuid              Sequence of bytes representing an UUID.
+*  @param uuid_string       Receives the null-terminated string representation (e.g., "7f907d75-5e13-44cf-a1a3-19a01a2b4528").
+*  @param uuid_string_size  The size of `uuid_string`, at least UUID_STRING_SIZE.
+*  @returns                 Zero if no failures occur, non-zero otherwise.
+*/
+MOCKABLE_FUNCTION(, int, UUID_to_string_into, UUID*, uuid, char*, uuid_string, size_t, uuid_string_size);
+
+/* @brief               Generates a random (version 4) UUID without a call to the platform for each UUID.
+*                       The bits come from a generator private to the calling thread and seeded from UUID_generate's
+*                       source, so the UUIDs are unique but, unlike UUID_generate's, can be predicted from earlier ones.
+*  @param uuid          A pre-allocated buffer for the bytes of the generated UUID
+*  @returns             Zero if no failures occur, non-zero otherwise.
+*/
+MOCKABLE_FUNCTION(, int, UUID_generate_fast, UUID*, uuid);
+
+/* @brief               Generates `count` random (version 4) UUIDs the way UUID_generate_fast does.
+*  @param uuids         A pre-allocated array of `count` UUIDs
+*  @param count         The number of UUIDs to generate.
+*  @returns             Zero if no failures occur, non-zero otherwise.
+*/
+MOCKABLE_FUNCTION(, int, UUID_generate_batch, UUID*, uuids, size_t, count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,14 +30,21 @@ MOCKABLE_FUNCTION(, int, VECTOR_push_back, VECTOR_HANDLE, handle, const void*, e
 MOCKABLE_FUNCTION(, void, VECTOR_erase, VECTOR_HANDLE, handle, void*, elements, size_t, numElements);
 MOCKABLE_FUNCTION(, void, VECTOR_clear, VECTOR_HANDLE, handle);
 
+/* ordering */
+MOCKABLE_FUNCTION(, void, VECTOR_sort, VECTOR_HANDLE, handle, VECTOR_COMPARE_FUNCTION, compare);
+
 /* access */
 MOCKABLE_FUNCTION(, void*, VECTOR_element, VECTOR_HANDLE, handle, size_t, index);
 MOCKABLE_FUNCTION(, void*, VECTOR_front, VECTOR_HANDLE, handle);
 MOCKABLE_FUNCTION(, void*, VECTOR_back, VECTOR_HANDLE, handle);
 MOCKABLE_FUNCTION(, void*, VECTOR_find_if, VECTOR_HANDLE, handle, PREDICATE_FUNCTION, pred, const void*, value);
+MOCKABLE_FUNCTION(, void*, VECTOR_binary_search, VECTOR_HANDLE, handle, const void*, value, VECTOR_COMPARE_FUNCTION, compare);
 
 /* capacity */
 MOCKABLE_FUNCTION(, size_t, VECTOR_size, VECTOR_HANDLE, handle);
+MOCKABLE_FUNCTION(, size_t, VECTOR_capacity, VECTOR_HANDLE, handle);
+MOCKABLE_FUNCTION(, int, VECTOR_reserve, VECTOR_HANDLE, handle, size_t, numElements);
+MOCKABLE_FUNCTION(, int, VECTOR_shrink_to_fit, VECTOR_HANDLE, handle);
 
 #ifdef __cplusplus
 }
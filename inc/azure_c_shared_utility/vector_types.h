@@ -15,6 +15,7 @@ extern "C"
 typedef struct VECTOR_TAG* VECTOR_HANDLE;
 
 typedef bool(*PREDICATE_FUNCTION)(const void* element, const void* value);
+typedef int(*VECTOR_COMPARE_FUNCTION)(const void* left, const void* right);
 
 #ifdef __cplusplus
 }
@@ -14,6 +14,8 @@ typedef struct VECTOR_TAG
 {
     void* storage;
     size_t count;
+    /* number of elements storage has room for */
+    size_t capacity;
     size_t elementSize;
 } VECTOR;
 
@@ -0,0 +1,275 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "azure_c_shared_utility/arena.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_DEFAULT_CHUNK_SIZE 4096
+#define ARENA_ALIGN(size) (((size) + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+typedef struct ARENA_CHUNK_TAG
+{
+    struct ARENA_CHUNK_TAG* next;
+    /* bytes available after the chunk header */
+    size_t size;
+    size_t used;
+} ARENA_CHUNK;
+
+typedef struct ARENA_TAG
+{
+    /* the chunk small requests are served from comes first, the first chunk is always last */
+    ARENA_CHUNK* chunks;
+    ARENA_CHUNK* first_chunk;
+    size_t chunk_size;
+    /* last block served from the current chunk, the only one that can grow in place */
+    unsigned char* last_block;
+} ARENA;
+
+#define ARENA_HEADER_SIZE ARENA_ALIGN(sizeof(ARENA))
+#define ARENA_CHUNK_HEADER_SIZE ARENA_ALIGN(sizeof(ARENA_CHUNK))
+
+static unsigned char* chunk_data(ARENA_CHUNK* chunk)
+{
+    return (unsigned char*)chunk + ARENA_CHUNK_HEADER_SIZE;
+}
+
+static ARENA_CHUNK* new_chunk(size_t size)
+{
+    ARENA_CHUNK* result;
+    if (size > SIZE_MAX - ARENA_CHUNK_HEADER_SIZE)
+    {
+        LogError("chunk size %u too large", (unsigned int)size);
+        result = NULL;
+    }
+    else if ((result = (ARENA_CHUNK*)malloc(ARENA_CHUNK_HEADER_SIZE + size)) == NULL)
+    {
+        LogError("failure allocating a chunk of %u bytes", (unsigned int)size);
+    }
+    else
+    {
+        result->next = NULL;
+        result->size = size;
+        result->used = 0;
+    }
+    return result;
+}
+
+static void* allocate(ARENA* arena, size_t size)
+{
+    void* result;
+    ARENA_CHUNK* current = arena->chunks;
+    size_t aligned_size;
+
+    if (size == 0)
+    {
+        size = 1;
+    }
+
+    if (size > SIZE_MAX - ARENA_ALIGNMENT)
+    {
+        /* Codes_SRS_ARENA_99_010: [ If size cannot be served, or allocating the chunk fails, ARENA_malloc shall return NULL. ]*/
+        LogError("size %u too large", (unsigned int)size);
+        result = NULL;
+    }
+    else if ((aligned_size = ARENA_ALIGN(size)) <= current->size - current->used)
+    {
+        /* Codes_SRS_ARENA_99_007: [ ARENA_malloc shall return the next free block of the current chunk, with size rounded up to a multiple of 16 bytes and aligned to 16 bytes. ]*/
+        arena->last_block = chunk_data(current) + current->used;
+        current->used += aligned_size;
+        result = arena->last_block;
+    }
+    else if (aligned_size > arena->chunk_size)
+    {
+        /* Codes_SRS_ARENA_99_009: [ A request larger than the chunk size shall get a chunk of its own, and the current chunk shall stay current. ]*/
+        ARENA_CHUNK* chunk = new_chunk(aligned_size);
+        if (chunk == NULL)
+        {
+            /* Codes_SRS_ARENA_99_010: [ If size cannot be served, or allocating the chunk fails, ARENA_malloc shall return NULL. ]*/
+            result = NULL;
+        }
+        else
+        {
+            chunk->used = aligned_size;
+            chunk->next = current->next;
+            current->next = chunk;
+            result = chunk_data(chunk);
+        }
+    }
+    else
+    {
+        /* Codes_SRS_ARENA_99_008: [ When the current chunk does not have room for the request, ARENA_malloc shall allocate a new chunk of the arena's chunk size and make it the current chunk. ]*/
+        ARENA_CHUNK* chunk = new_chunk(arena->chunk_size);
+        if (chunk == NULL)
+        {
+            /* Codes_SRS_ARENA_99_010: [ If size cannot be served, or allocating the chunk fails, ARENA_malloc shall return NULL. ]*/
+            result = NULL;
+        }
+        else
+        {
+            chunk->used = aligned_size;
+            chunk->next = current;
+            arena->chunks = chunk;
+            arena->last_block = chunk_data(chunk);
+            result = arena->last_block;
+        }
+    }
+
+    return result;
+}
+
+ARENA_HANDLE ARENA_create(size_t chunk_size)
+{
+    ARENA* result;
+
+    if (chunk_size == 0)
+    {
+        /* Codes_SRS_ARENA_99_002: [ If chunk_size is 0, ARENA_create shall use a chunk size of 4096 bytes. ]*/
+        chunk_size = ARENA_DEFAULT_CHUNK_SIZE;
+    }
+
+    if (chunk_size > SIZE_MAX - ARENA_HEADER_SIZE - ARENA_CHUNK_HEADER_SIZE - ARENA_ALIGNMENT)
+    {
+        /* Codes_SRS_ARENA_99_003: [ If chunk_size is too large or the allocation fails, ARENA_create shall return NULL. ]*/
+        LogError("chunk size %u too large", (unsigned int)chunk_size);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_ARENA_99_001: [ ARENA_create shall allocate the arena together with its first chunk of chunk_size bytes, rounded up to a multiple of 16, in a single allocation and return a handle to it. ]*/
+        chunk_size = ARENA_ALIGN(chunk_size);
+        result = (ARENA*)malloc(ARENA_HEADER_SIZE + ARENA_CHUNK_HEADER_SIZE + chunk_size);
+        if (result == NULL)
+        {
+            /* Codes_SRS_ARENA_99_003: [ If chunk_size is too large or the allocation fails, ARENA_create shall return NULL. ]*/
+            LogError("failure allocating arena");
+        }
+        else
+        {
+            result->first_chunk = (ARENA_CHUNK*)((unsigned char*)result + ARENA_HEADER_SIZE);
+            result->first_chunk->next = NULL;
+            result->first_chunk->size = chunk_size;
+            result->first_chunk->used = 0;
+            result->chunks = result->first_chunk;
+            result->chunk_size = chunk_size;
+            result->last_block = NULL;
+        }
+    }
+
+    return result;
+}
+
+static void free_extra_chunks(ARENA* arena)
+{
+    while (arena->chunks != arena->first_chunk)
+    {
+        ARENA_CHUNK* chunk = arena->chunks;
+        arena->chunks = chunk->next;
+        free(chunk);
+    }
+
+    /* chunks of their own are linked after the first chunk while it is current */
+    while (arena->first_chunk->next != NULL)
+    {
+        ARENA_CHUNK* chunk = arena->first_chunk->next;
+        arena->first_chunk->next = chunk->next;
+        free(chunk);
+    }
+}
+
+void ARENA_destroy(ARENA_HANDLE arena)
+{
+    /* Codes_SRS_ARENA_99_004: [ If arena is NULL, ARENA_destroy shall do nothing. ]*/
+    if (arena != NULL)
+    {
+        /* Codes_SRS_ARENA_99_005: [ ARENA_destroy shall free every chunk and the arena itself. ]*/
+        free_extra_chunks(arena);
+        free(arena);
+    }
+}
+
+void* ARENA_malloc(ARENA_HANDLE arena, size_t size)
+{
+    void* result;
+
+    if (arena == NULL)
+    {
+        /* Codes_SRS_ARENA_99_006: [ If arena is NULL, ARENA_malloc shall return NULL. ]*/
+        LogError("NULL arena");
+        result = NULL;
+    }
+    else
+    {
+        result = allocate(arena, size);
+    }
+
+    return result;
+}
+
+void* ARENA_realloc(ARENA_HANDLE arena, void* ptr, size_t old_size, size_t new_size)
+{
+    void* result;
+
+    if (arena == NULL)
+    {
+        /* Codes_SRS_ARENA_99_011: [ If arena is NULL, ARENA_realloc shall return NULL. ]*/
+        LogError("NULL arena");
+        result = NULL;
+    }
+    else if (ptr == NULL)
+    {
+        /* Codes_SRS_ARENA_99_012: [ If ptr is NULL, ARENA_realloc shall behave like ARENA_malloc. ]*/
+        result = allocate(arena, new_size);
+    }
+    else
+    {
+        ARENA_CHUNK* current = arena->chunks;
+
+        if (((unsigned char*)ptr == arena->last_block) &&
+            (new_size <= current->size - (size_t)(arena->last_block - chunk_data(current))))
+        {
+            /* Codes_SRS_ARENA_99_013: [ If ptr is the last block served from the current chunk and new_size fits in what is left of the chunk, ARENA_realloc shall resize the block in place and return ptr. ]*/
+            current->used = (size_t)(arena->last_block - chunk_data(current)) + ARENA_ALIGN((new_size == 0) ? 1 : new_size);
+            result = ptr;
+        }
+        else if (new_size <= old_size)
+        {
+            /* Codes_SRS_ARENA_99_014: [ Otherwise, if new_size is not larger than old_size, ARENA_realloc shall return ptr. ]*/
+            result = ptr;
+        }
+        else
+        {
+            /* Codes_SRS_ARENA_99_015: [ Otherwise ARENA_realloc shall take a new block of new_size bytes from the arena, copy old_size bytes from ptr to it and return it. ]*/
+            result = allocate(arena, new_size);
+            if (result == NULL)
+            {
+                /* Codes_SRS_ARENA_99_016: [ If the new block cannot be obtained, ARENA_realloc shall return NULL and leave ptr untouched. ]*/
+                LogError("failure growing block to %u bytes", (unsigned int)new_size);
+            }
+            else
+            {
+                (void)memcpy(result, ptr, old_size);
+            }
+        }
+    }
+
+    return result;
+}
+
+void ARENA_reset(ARENA_HANDLE arena)
+{
+    /* Codes_SRS_ARENA_99_017: [ If arena is NULL, ARENA_reset shall do nothing. ]*/
+    if (arena != NULL)
+    {
+        /* Codes_SRS_ARENA_99_018: [ ARENA_reset shall free every chunk but the first one and make the whole first chunk available again. ]*/
+        free_extra_chunks(arena);
+        arena->first_chunk->used = 0;
+        arena->last_block = NULL;
+    }
+}
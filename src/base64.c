@@ -5,183 +5,903 @@
 #include "azure_c_shared_utility/gballoc.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "azure_c_shared_utility/base64.h"
 #include "azure_c_shared_utility/xlogging.h"
 
+/*the vectorized loops are only compiled when the compiler can generate the instructions, and only used when the CPU has them*/
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && \
+    ((defined(__GNUC__) && !defined(__clang__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || \
+     (defined(__clang__) && ((__clang_major__ > 3) || ((__clang_major__ == 3) && (__clang_minor__ >= 4)))) || \
+     (defined(_MSC_VER) && (_MSC_VER >= 1900)))
+#define BASE64_HAS_X86_SSSE3
+#define BASE64_HAS_X86_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BASE64_X86_TARGET(features)
+#else
+#include <cpuid.h>
+#define BASE64_X86_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
 
-#define splitInt(intVal, bytePos)   (char)((intVal >> (bytePos << 3)) & 0xFF)
-#define joinChars(a, b, c, d) (uint32_t)((uint32_t)a + ((uint32_t)b << 8) + ((uint32_t)c << 16) + ((uint32_t)d << 24))
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define BASE64_HAS_NEON
+#include <arm_neon.h>
+#endif
 
-static char base64char(unsigned char val)
+DEFINE_ENUM_STRINGS(BASE64_IMPLEMENTATION, BASE64_IMPLEMENTATION_VALUES);
+
+#define BASE64_INVALID 0xFF
+
+static const char base64EncodeTable[64] =
 {
-    char result;
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+/*the 6 bit value of each base64 character, BASE64_INVALID for all the other characters*/
+static const unsigned char base64DecodeTable[256] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+/*encodes as many whole groups of 3 bytes as it likes and returns the number of bytes consumed (a multiple of 3)*/
+typedef size_t(*BASE64_ENCODE_GROUPS)(const unsigned char* source, size_t size, char* destination);
+/*decodes as many whole groups of 4 characters as it likes, stopping before a group that has a character that is not base64, and returns the number of characters consumed (a multiple of 4). destinationSize is the room left in destination*/
+typedef size_t(*BASE64_DECODE_GROUPS)(const char* source, size_t length, unsigned char* destination, size_t destinationSize);
 
-    if (val < 26)
+typedef struct BASE64_KERNELS_TAG
+{
+    BASE64_IMPLEMENTATION implementation;
+    BASE64_ENCODE_GROUPS encodeGroups;
+    BASE64_DECODE_GROUPS decodeGroups;
+} BASE64_KERNELS;
+
+/*the loops in use, picked on first use; concurrent first uses all store the same value*/
+static const BASE64_KERNELS* base64Kernels = NULL;
+
+static size_t base64_encode_groups_table(const unsigned char* source, size_t size, char* destination)
+{
+    /*b0            b1(+1)          b2(+2)
+    7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0
+    |----c1---| |----c2---| |----c3---| |----c4---|
+    */
+    size_t consumed = 0;
+    while (size - consumed >= 3)
     {
-        result = 'A' + (char)val;
+        uint32_t group = ((uint32_t)source[consumed] << 16) | ((uint32_t)source[consumed + 1] << 8) | (uint32_t)source[consumed + 2];
+        destination[0] = base64EncodeTable[(group >> 18) & 0x3F];
+        destination[1] = base64EncodeTable[(group >> 12) & 0x3F];
+        destination[2] = base64EncodeTable[(group >> 6) & 0x3F];
+        destination[3] = base64EncodeTable[group & 0x3F];
+        destination += 4;
+        consumed += 3;
     }
-    else if (val < 52)
+    return consumed;
+}
+
+static size_t base64_decode_groups_table(const char* source, size_t length, unsigned char* destination, size_t destinationSize)
+{
+    size_t consumed = 0;
+    (void)destinationSize;
+    while (length - consumed >= 4)
     {
-        result = 'a' + ((char)val - 26);
+        uint32_t c1 = base64DecodeTable[(unsigned char)source[consumed]];
+        uint32_t c2 = base64DecodeTable[(unsigned char)source[consumed + 1]];
+        uint32_t c3 = base64DecodeTable[(unsigned char)source[consumed + 2]];
+        uint32_t c4 = base64DecodeTable[(unsigned char)source[consumed + 3]];
+        uint32_t group;
+        if (((c1 | c2 | c3 | c4) & 0x80) != 0)
+        {
+            break;
+        }
+        group = (c1 << 18) | (c2 << 12) | (c3 << 6) | c4;
+        destination[0] = (unsigned char)(group >> 16);
+        destination[1] = (unsigned char)(group >> 8);
+        destination[2] = (unsigned char)group;
+        destination += 3;
+        consumed += 4;
     }
-    else if (val < 62)
+    return consumed;
+}
+
+static const BASE64_KERNELS base64KernelsTable = { BASE64_IMPLEMENTATION_TABLE, base64_encode_groups_table, base64_decode_groups_table };
+
+#ifdef BASE64_HAS_X86_SSSE3
+#define BASE64_X86_ECX1_SSSE3        (1u << 9)
+#define BASE64_X86_ECX1_OSXSAVE      (1u << 27)
+#define BASE64_X86_ECX1_AVX          (1u << 28)
+#define BASE64_X86_EBX7_AVX2         (1u << 5)
+#define BASE64_X86_XCR0_YMM          0x06u  /* SSE and AVX state */
+
+/*reads ECX of CPUID leaf 1, EBX of leaf 7 and, when the OS saves the extended states, XCR0*/
+static void base64_x86_get_features(unsigned int* ecx1, unsigned int* ebx7, unsigned int* xcr0)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        *ecx1 = *ebx7 = *xcr0 = 0;
+        return;
+    }
+    __cpuid(info, 1);
+    *ecx1 = (unsigned int)info[2];
+    __cpuidex(info, 7, 0);
+    *ebx7 = (unsigned int)info[1];
+    *xcr0 = ((*ecx1 & BASE64_X86_ECX1_OSXSAVE) != 0) ? (unsigned int)_xgetbv(0) : 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, NULL) < 7)
     {
-        result = '0' + ((char)val - 52);
+        *ecx1 = *ebx7 = *xcr0 = 0;
+        return;
     }
-    else if (val == 62)
+    __cpuid_count(1, 0, eax, ebx, ecx, edx);
+    *ecx1 = ecx;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    *ebx7 = ebx;
+    if ((*ecx1 & BASE64_X86_ECX1_OSXSAVE) != 0)
     {
-        result = '+';
+        /* xgetbv, spelled out for assemblers that do not know it */
+        __asm__ volatile (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+        *xcr0 = eax;
     }
     else
     {
-        result = '/';
+        *xcr0 = 0;
+    }
+#endif
+}
+
+/*
+ * The SSSE3 and AVX2 loops work on 12 bytes / 16 characters per 128 bit lane (W. Mula, D. Lemire, "Faster Base64 Encoding and Decoding
+ * Using AVX2 Instructions"). Encoding spreads each group of 3 bytes over 4 bytes and isolates the 6 bit values with multiplications;
+ * the values are turned into characters by adding an offset that depends on the range the value is in. Decoding looks the
+ * characters up by nibbles to validate them and find the offset back to their values, then packs the values with multiply-adds.
+ */
+#define BASE64_SSSE3_ENCODE_LANE(in, lookup)                                                                  \
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));               \
+    in = _mm_or_si128(                                                                                        \
+        _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040)),          \
+        _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010)));         \
+    lookup = _mm_subs_epu8(in, _mm_set1_epi8(51));                                                            \
+    lookup = _mm_or_si128(lookup, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), in), _mm_set1_epi8(13)));   \
+    in = _mm_add_epi8(in, _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,     \
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0), lookup))
+
+BASE64_X86_TARGET("ssse3")
+static size_t base64_encode_groups_ssse3(const unsigned char* source, size_t size, char* destination)
+{
+    size_t consumed = 0;
+    /*each step reads 16 bytes and encodes the first 12*/
+    while (size - consumed >= 16)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i*)(source + consumed));
+        __m128i lookup;
+        BASE64_SSSE3_ENCODE_LANE(in, lookup);
+        _mm_storeu_si128((__m128i*)destination, in);
+        destination += 16;
+        consumed += 12;
+    }
+    return consumed;
+}
+
+#define BASE64_SSSE3_DECODE_LANE(in, hiNibbles, invalid)                                                          \
+    hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x2F));                                        \
+    invalid = _mm_and_si128(                                                                                      \
+        _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,                            \
+            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), _mm_and_si128(in, _mm_set1_epi8(0x2F))),             \
+        _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,                            \
+            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hiNibbles));                                         \
+    in = _mm_add_epi8(in, _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), \
+        _mm_add_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')), hiNibbles)));                                       \
+    in = _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));            \
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1))
+
+BASE64_X86_TARGET("ssse3")
+static size_t base64_decode_groups_ssse3(const char* source, size_t length, unsigned char* destination, size_t destinationSize)
+{
+    size_t consumed = 0;
+    /*each step decodes 16 characters and writes 16 bytes, the first 12 of which are the result*/
+    while ((length - consumed >= 16) && (destinationSize >= 16))
+    {
+        __m128i in = _mm_loadu_si128((const __m128i*)(source + consumed));
+        __m128i hiNibbles;
+        __m128i invalid;
+        BASE64_SSSE3_DECODE_LANE(in, hiNibbles, invalid);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xFFFF)
+        {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)destination, in);
+        destination += 12;
+        destinationSize -= 12;
+        consumed += 16;
+    }
+    return consumed;
+}
+
+static const BASE64_KERNELS base64KernelsSsse3 = { BASE64_IMPLEMENTATION_SSSE3, base64_encode_groups_ssse3, base64_decode_groups_ssse3 };
+
+static int base64_ssse3_supported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+    base64_x86_get_features(&ecx1, &ebx7, &xcr0);
+    return (ecx1 & BASE64_X86_ECX1_SSSE3) != 0;
+}
+#endif /* BASE64_HAS_X86_SSSE3 */
+
+#ifdef BASE64_HAS_X86_AVX2
+BASE64_X86_TARGET("avx2")
+static size_t base64_encode_groups_avx2(const unsigned char* source, size_t size, char* destination)
+{
+    size_t consumed = 0;
+    /*each step encodes 24 bytes, 12 per lane, reading 16 bytes for each lane*/
+    while (size - consumed >= 28)
+    {
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(source + consumed))),
+            _mm_loadu_si128((const __m128i*)(source + consumed + 12)), 1);
+        __m256i lookup;
+        in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        in = _mm256_or_si256(
+            _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040)),
+            _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010)));
+        lookup = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+        lookup = _mm256_or_si256(lookup, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), in), _mm256_set1_epi8(13)));
+        in = _mm256_add_epi8(in, _mm256_shuffle_epi8(_mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0), lookup));
+        _mm256_storeu_si256((__m256i*)destination, in);
+        destination += 32;
+        consumed += 24;
+    }
+    return consumed;
+}
+
+BASE64_X86_TARGET("avx2")
+static size_t base64_decode_groups_avx2(const char* source, size_t length, unsigned char* destination, size_t destinationSize)
+{
+    size_t consumed = 0;
+    /*each step decodes 32 characters and writes 32 bytes, the first 24 of which are the result*/
+    while ((length - consumed >= 32) && (destinationSize >= 32))
+    {
+        __m256i in = _mm256_loadu_si256((const __m256i*)(source + consumed));
+        __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x2F));
+        __m256i invalid = _mm256_and_si256(
+            _mm256_shuffle_epi8(_mm256_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), _mm256_and_si256(in, _mm256_set1_epi8(0x2F))),
+            _mm256_shuffle_epi8(_mm256_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hiNibbles));
+        if (!_mm256_testz_si256(invalid, invalid))
+        {
+            break;
+        }
+        in = _mm256_add_epi8(in, _mm256_shuffle_epi8(_mm256_setr_epi8(
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+            _mm256_add_epi8(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')), hiNibbles)));
+        in = _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+        in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        in = _mm256_permutevar8x32_epi32(in, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256((__m256i*)destination, in);
+        destination += 24;
+        destinationSize -= 24;
+        consumed += 32;
+    }
+    return consumed;
+}
+
+static const BASE64_KERNELS base64KernelsAvx2 = { BASE64_IMPLEMENTATION_AVX2, base64_encode_groups_avx2, base64_decode_groups_avx2 };
+
+static int base64_avx2_supported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+    base64_x86_get_features(&ecx1, &ebx7, &xcr0);
+    return ((ecx1 & BASE64_X86_ECX1_AVX) != 0) &&
+        ((ebx7 & BASE64_X86_EBX7_AVX2) != 0) &&
+        ((xcr0 & BASE64_X86_XCR0_YMM) == BASE64_X86_XCR0_YMM);
+}
+#endif /* BASE64_HAS_X86_AVX2 */
+
+#ifdef BASE64_HAS_NEON
+/*the NEON loops de-interleave 48 bytes / 64 characters with the structure loads and stores and use the 64 byte table lookups*/
+static size_t base64_encode_groups_neon(const unsigned char* source, size_t size, char* destination)
+{
+    size_t consumed = 0;
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8((const uint8_t*)base64EncodeTable);
+    table.val[1] = vld1q_u8((const uint8_t*)base64EncodeTable + 16);
+    table.val[2] = vld1q_u8((const uint8_t*)base64EncodeTable + 32);
+    table.val[3] = vld1q_u8((const uint8_t*)base64EncodeTable + 48);
+
+    while (size - consumed >= 48)
+    {
+        uint8x16x3_t in = vld3q_u8(source + consumed);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), vdupq_n_u8(0x3F));
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), vdupq_n_u8(0x3F));
+        out.val[3] = vandq_u8(in.val[2], vdupq_n_u8(0x3F));
+        out.val[0] = vqtbl4q_u8(table, out.val[0]);
+        out.val[1] = vqtbl4q_u8(table, out.val[1]);
+        out.val[2] = vqtbl4q_u8(table, out.val[2]);
+        out.val[3] = vqtbl4q_u8(table, out.val[3]);
+        vst4q_u8((uint8_t*)destination, out);
+        destination += 64;
+        consumed += 48;
+    }
+    return consumed;
+}
+
+static size_t base64_decode_groups_neon(const char* source, size_t length, unsigned char* destination, size_t destinationSize)
+{
+    size_t consumed = 0;
+    uint8x16x4_t tableLow;
+    uint8x16x4_t tableHigh;
+    (void)destinationSize;
+    tableLow.val[0] = vld1q_u8(base64DecodeTable);
+    tableLow.val[1] = vld1q_u8(base64DecodeTable + 16);
+    tableLow.val[2] = vld1q_u8(base64DecodeTable + 32);
+    tableLow.val[3] = vld1q_u8(base64DecodeTable + 48);
+    tableHigh.val[0] = vld1q_u8(base64DecodeTable + 64);
+    tableHigh.val[1] = vld1q_u8(base64DecodeTable + 80);
+    tableHigh.val[2] = vld1q_u8(base64DecodeTable + 96);
+    tableHigh.val[3] = vld1q_u8(base64DecodeTable + 112);
+
+    while (length - consumed >= 64)
+    {
+        uint8x16x4_t in = vld4q_u8((const uint8_t*)source + consumed);
+        uint8x16_t invalid = vdupq_n_u8(0);
+        uint8x16x3_t out;
+        int i;
+        for (i = 0; i < 4; i++)
+        {
+            /*characters 0 to 63 are looked up in the first table, 64 to 127 in the second; the lookups give 0 out of range*/
+            uint8x16_t c = in.val[i];
+            in.val[i] = vorrq_u8(vqtbl4q_u8(tableLow, c), vqtbl4q_u8(tableHigh, vsubq_u8(c, vdupq_n_u8(64))));
+            invalid = vorrq_u8(invalid, vorrq_u8(in.val[i], c));
+        }
+        /*BASE64_INVALID and the characters above 127 both have the top bit set*/
+        if ((vmaxvq_u8(invalid) & 0x80) != 0)
+        {
+            break;
+        }
+        out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+        vst3q_u8(destination, out);
+        destination += 48;
+        consumed += 64;
     }
+    return consumed;
+}
 
+static const BASE64_KERNELS base64KernelsNeon = { BASE64_IMPLEMENTATION_NEON, base64_encode_groups_neon, base64_decode_groups_neon };
+#endif /* BASE64_HAS_NEON */
+
+static const BASE64_KERNELS* get_supported_kernels(BASE64_IMPLEMENTATION implementation)
+{
+    const BASE64_KERNELS* result;
+    switch (implementation)
+    {
+    case BASE64_IMPLEMENTATION_TABLE:
+        result = &base64KernelsTable;
+        break;
+#ifdef BASE64_HAS_X86_SSSE3
+    case BASE64_IMPLEMENTATION_SSSE3:
+        result = base64_ssse3_supported() ? &base64KernelsSsse3 : NULL;
+        break;
+#endif
+#ifdef BASE64_HAS_X86_AVX2
+    case BASE64_IMPLEMENTATION_AVX2:
+        result = base64_avx2_supported() ? &base64KernelsAvx2 : NULL;
+        break;
+#endif
+#ifdef BASE64_HAS_NEON
+    case BASE64_IMPLEMENTATION_NEON:
+        result = &base64KernelsNeon;
+        break;
+#endif
+    default:
+        result = NULL;
+        break;
+    }
     return result;
 }
 
-static char base64b16(unsigned char val)
+static const BASE64_KERNELS* get_kernels(void)
 {
-    const uint32_t base64b16values[4] = {
-        joinChars('A', 'E', 'I', 'M'),
-        joinChars('Q', 'U', 'Y', 'c'),
-        joinChars('g', 'k', 'o', 's'),
-        joinChars('w', '0', '4', '8')
-    };
-    return splitInt(base64b16values[val >> 2], (val & 0x03));
+    if (base64Kernels == NULL)
+    {
+        const BASE64_KERNELS* kernels;
+        if (((kernels = get_supported_kernels(BASE64_IMPLEMENTATION_AVX2)) == NULL) &&
+            ((kernels = get_supported_kernels(BASE64_IMPLEMENTATION_SSSE3)) == NULL) &&
+            ((kernels = get_supported_kernels(BASE64_IMPLEMENTATION_NEON)) == NULL))
+        {
+            kernels = &base64KernelsTable;
+        }
+        base64Kernels = kernels;
+    }
+    return base64Kernels;
 }
 
-static char base64b8(unsigned char val)
+/*returns the number of '=' at the end of source, 0 to 2*/
+static size_t number_of_padding_characters(const char* source, size_t sourceLength)
 {
-    const uint32_t base64b8values = joinChars('A', 'Q', 'g', 'w');
-    return splitInt(base64b8values, val);
+    size_t result = 0;
+    if ((sourceLength >= 4) && (source[sourceLength - 1] == '='))
+    {
+        result = (source[sourceLength - 2] == '=') ? 2 : 1;
+    }
+    return result;
 }
 
-static int base64toValue(char base64character, unsigned char* value)
+size_t Base64_Encode_Length(size_t size)
 {
-    int result = 0;
-    if (('A' <= base64character) && (base64character <= 'Z'))
+    size_t result;
+    /*Codes_SRS_BASE64_99_002: [ If the encoding of size bytes does not fit in a size_t, Base64_Encode_Length shall return 0. ]*/
+    if (size / 3 >= (((size_t)-1) / 4))
     {
-        *value = base64character - 'A';
+        result = 0;
     }
-    else if (('a' <= base64character) && (base64character <= 'z'))
+    else
     {
-        *value = ('Z' - 'A') + 1 + (base64character - 'a');
+        /*Codes_SRS_BASE64_99_001: [ Base64_Encode_Length shall return 4 characters for each started group of 3 bytes. ]*/
+        result = ((size / 3) + ((size % 3 != 0) ? 1 : 0)) * 4;
     }
-    else if (('0' <= base64character) && (base64character <= '9'))
+    return result;
+}
+
+size_t Base64_Decode_Length(const char* source, size_t sourceLength)
+{
+    size_t result;
+    /*Codes_SRS_BASE64_99_003: [ If source is NULL or sourceLength is not a multiple of 4, Base64_Decode_Length shall return 0. ]*/
+    if ((source == NULL) || ((sourceLength % 4) != 0))
     {
-        *value = ('Z' - 'A') + 1 + ('z' - 'a') + 1 + (base64character - '0');
+        result = 0;
     }
-    else if ('+' == base64character)
+    else
     {
-        *value = 62;
+        /*Codes_SRS_BASE64_99_004: [ Otherwise Base64_Decode_Length shall return 3 bytes for each group of 4 characters, minus 1 byte for each '=' padding character at the end of source. ]*/
+        result = (sourceLength / 4 * 3) - number_of_padding_characters(source, sourceLength);
     }
-    else if ('/' == base64character)
+    return result;
+}
+
+int Base64_Encode_Into(const unsigned char* source, size_t size, char* destination, size_t destinationSize, size_t* encodedLength)
+{
+    int result;
+    size_t neededSize = Base64_Encode_Length(size);
+
+    /*Codes_SRS_BASE64_99_005: [ If source, destination or encodedLength is NULL, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+    if ((source == NULL) || (destination == NULL) || (encodedLength == NULL))
+    {
+        LogError("invalid argument const unsigned char* source=%p, char* destination=%p, size_t* encodedLength=%p", source, destination, encodedLength);
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_BASE64_99_006: [ If destinationSize is smaller than Base64_Encode_Length(size), or if that length does not fit in a size_t, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+    else if (((neededSize == 0) && (size != 0)) || (destinationSize < neededSize))
     {
-        *value = 63;
+        LogError("destination too small: %lu characters needed, %lu available", (unsigned long)neededSize, (unsigned long)destinationSize);
+        result = __FAILURE__;
     }
     else
     {
-        *value = 0;
-        result = -1;
+        const BASE64_KERNELS* kernels = get_kernels();
+        size_t consumed;
+        char* position = destination;
+
+        /*Codes_SRS_BASE64_99_007: [ Base64_Encode_Into shall write the base64 encoding of the size bytes at source in destination, padded with '=', without a null terminator. ]*/
+        consumed = kernels->encodeGroups(source, size, position);
+        position += consumed / 3 * 4;
+        consumed += base64_encode_groups_table(source + consumed, size - consumed, position);
+        position = destination + consumed / 3 * 4;
+
+        if (size - consumed == 2)
+        {
+            uint32_t group = ((uint32_t)source[consumed] << 16) | ((uint32_t)source[consumed + 1] << 8);
+            position[0] = base64EncodeTable[(group >> 18) & 0x3F];
+            position[1] = base64EncodeTable[(group >> 12) & 0x3F];
+            position[2] = base64EncodeTable[(group >> 6) & 0x3F];
+            position[3] = '=';
+        }
+        else if (size - consumed == 1)
+        {
+            uint32_t group = (uint32_t)source[consumed] << 16;
+            position[0] = base64EncodeTable[(group >> 18) & 0x3F];
+            position[1] = base64EncodeTable[(group >> 12) & 0x3F];
+            position[2] = '=';
+            position[3] = '=';
+        }
+
+        /*Codes_SRS_BASE64_99_008: [ On success Base64_Encode_Into shall set encodedLength to the number of characters written and return 0. ]*/
+        *encodedLength = neededSize;
+        result = 0;
     }
     return result;
 }
 
-static size_t numberOfBase64Characters(const char* encodedString)
+int Base64_Decode_Into(const char* source, size_t sourceLength, unsigned char* destination, size_t destinationSize, size_t* decodedLength)
 {
-    size_t length = 0;
-    unsigned char junkChar;
-    while (base64toValue(encodedString[length],&junkChar) != -1)
+    int result;
+
+    /*Codes_SRS_BASE64_99_009: [ If source, destination or decodedLength is NULL, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+    if ((source == NULL) || (destination == NULL) || (decodedLength == NULL))
+    {
+        LogError("invalid argument const char* source=%p, unsigned char* destination=%p, size_t* decodedLength=%p", source, destination, decodedLength);
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_BASE64_99_010: [ If sourceLength is not a multiple of 4, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+    else if ((sourceLength % 4) != 0)
     {
-        length++;
+        LogError("Invalid length Base64 string!");
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_BASE64_99_011: [ If destinationSize is smaller than Base64_Decode_Length(source, sourceLength), Base64_Decode_Into shall fail and return a non-zero value. ]*/
+    else if (destinationSize < Base64_Decode_Length(source, sourceLength))
+    {
+        LogError("destination too small: %lu bytes needed, %lu available", (unsigned long)Base64_Decode_Length(source, sourceLength), (unsigned long)destinationSize);
+        result = __FAILURE__;
+    }
+    else
+    {
+        const BASE64_KERNELS* kernels = get_kernels();
+        size_t padding = number_of_padding_characters(source, sourceLength);
+        /*the last group is decoded apart when it is padded*/
+        size_t unpaddedLength = (padding == 0) ? sourceLength : sourceLength - 4;
+        size_t consumed;
+
+        consumed = kernels->decodeGroups(source, unpaddedLength, destination, destinationSize);
+        consumed += base64_decode_groups_table(source + consumed, unpaddedLength - consumed, destination + consumed / 4 * 3, destinationSize - consumed / 4 * 3);
+
+        /*Codes_SRS_BASE64_99_012: [ If source has a character that is not in the base64 alphabet, other than 1 or 2 '=' padding characters at the end, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+        if (consumed != unpaddedLength)
+        {
+            LogError("Invalid character in Base64 string at %lu", (unsigned long)consumed);
+            result = __FAILURE__;
+        }
+        else if (padding == 0)
+        {
+            /*Codes_SRS_BASE64_99_013: [ Otherwise Base64_Decode_Into shall write the decoded bytes in destination, set decodedLength to their number and return 0. ]*/
+            *decodedLength = consumed / 4 * 3;
+            result = 0;
+        }
+        else
+        {
+            uint32_t c1 = base64DecodeTable[(unsigned char)source[consumed]];
+            uint32_t c2 = base64DecodeTable[(unsigned char)source[consumed + 1]];
+            uint32_t c3 = (padding == 1) ? base64DecodeTable[(unsigned char)source[consumed + 2]] : 0;
+            unsigned char* position = destination + consumed / 4 * 3;
+
+            /*Codes_SRS_BASE64_99_012: [ If source has a character that is not in the base64 alphabet, other than 1 or 2 '=' padding characters at the end, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+            if (((c1 | c2 | c3) & 0x80) != 0)
+            {
+                LogError("Invalid character in Base64 string at %lu", (unsigned long)consumed);
+                result = __FAILURE__;
+            }
+            else
+            {
+                uint32_t group = (c1 << 18) | (c2 << 12) | (c3 << 6);
+                position[0] = (unsigned char)(group >> 16);
+                if (padding == 1)
+                {
+                    position[1] = (unsigned char)(group >> 8);
+                }
+
+                /*Codes_SRS_BASE64_99_013: [ Otherwise Base64_Decode_Into shall write the decoded bytes in destination, set decodedLength to their number and return 0. ]*/
+                *decodedLength = consumed / 4 * 3 + (3 - padding);
+                result = 0;
+            }
+        }
     }
-    return length;
+    return result;
 }
 
-/*returns the count of original bytes before being base64 encoded*/
-/*notice NO validation of the content of encodedString. Its length is validated to be a multiple of 4.*/
-static size_t Base64decode_len(const char *encodedString)
+int Base64_SelectImplementation(BASE64_IMPLEMENTATION implementation)
 {
-    size_t result;
-    size_t sourceLength = strlen(encodedString);
-    
-    if (sourceLength == 0)
+    int result;
+    const BASE64_KERNELS* kernels = get_supported_kernels(implementation);
+
+    /*Codes_SRS_BASE64_99_014: [ If implementation is not supported by this build or by this CPU, Base64_SelectImplementation shall fail and return a non-zero value. ]*/
+    if (kernels == NULL)
     {
+        LogError("base64 implementation %s is not supported", ENUM_TO_STRING(BASE64_IMPLEMENTATION, implementation));
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_99_015: [ Otherwise Base64_SelectImplementation shall make all the encoding and decoding functions use implementation and return 0. ]*/
+        base64Kernels = kernels;
         result = 0;
     }
+    return result;
+}
+
+BASE64_IMPLEMENTATION Base64_GetImplementation(void)
+{
+    /*Codes_SRS_BASE64_99_016: [ Base64_GetImplementation shall return the implementation in use, picking the fastest one supported by the CPU if none is selected yet. ]*/
+    return get_kernels()->implementation;
+}
+
+int Base64_Encode_Init(BASE64_ENCODE_CONTEXT* context)
+{
+    int result;
+    /*Codes_SRS_BASE64_99_018: [ If context is NULL, Base64_Encode_Init shall fail and return a non-zero value. ]*/
+    if (context == NULL)
+    {
+        LogError("invalid argument BASE64_ENCODE_CONTEXT* context=%p", context);
+        result = __FAILURE__;
+    }
     else
     {
-        result = sourceLength / 4 * 3;
-        if (encodedString[sourceLength - 1] == '=')
+        /*Codes_SRS_BASE64_99_019: [ Otherwise Base64_Encode_Init shall start a new encoding in context and return 0. ]*/
+        context->pendingSize = 0;
+        result = 0;
+    }
+    return result;
+}
+
+int Base64_Encode_Update(BASE64_ENCODE_CONTEXT* context, const unsigned char* source, size_t size, char* destination, size_t destinationSize, size_t* encodedLength)
+{
+    int result;
+    /*Codes_SRS_BASE64_99_020: [ If context, destination or encodedLength is NULL, or if source is NULL and size is not 0, Base64_Encode_Update shall fail and return a non-zero value. ]*/
+    if ((context == NULL) || ((source == NULL) && (size != 0)) || (destination == NULL) || (encodedLength == NULL))
+    {
+        LogError("invalid argument BASE64_ENCODE_CONTEXT* context=%p, const unsigned char* source=%p, size_t size=%lu, char* destination=%p, size_t* encodedLength=%p",
+            context, source, (unsigned long)size, destination, encodedLength);
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_BASE64_99_021: [ If destinationSize is smaller than the number of characters for the whole groups of 3 made by the pending bytes and source, Base64_Encode_Update shall fail and return a non-zero value. ]*/
+    else if (destinationSize / 4 < (size / 3) + ((context->pendingSize + (size % 3)) / 3))
+    {
+        LogError("destination too small: %lu characters available", (unsigned long)destinationSize);
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t consumed = 0;
+        size_t written = 0;
+        size_t groupLength;
+        result = 0;
+
+        /*Codes_SRS_BASE64_99_022: [ Base64_Encode_Update shall encode the bytes pending in context followed by the bytes at source, 3 at a time, in destination. ]*/
+        if ((context->pendingSize > 0) && (context->pendingSize + size >= 3))
         {
-            if (encodedString[sourceLength - 2] == '=')
+            unsigned char group[3];
+            (void)memcpy(group, context->pending, context->pendingSize);
+            consumed = 3 - context->pendingSize;
+            (void)memcpy(group + context->pendingSize, source, consumed);
+            context->pendingSize = 0;
+            if (Base64_Encode_Into(group, 3, destination, destinationSize, &groupLength) != 0)
             {
-                result --;
+                result = __FAILURE__;
+            }
+            else
+            {
+                written = groupLength;
             }
-            result--;
         }
+
+        if ((result == 0) && ((size - consumed) >= 3))
+        {
+            size_t wholeGroups = (size - consumed) / 3 * 3;
+            if (Base64_Encode_Into(source + consumed, wholeGroups, destination + written, destinationSize - written, &groupLength) != 0)
+            {
+                result = __FAILURE__;
+            }
+            else
+            {
+                written += groupLength;
+                consumed += wholeGroups;
+            }
+        }
+
+        if (result != 0)
+        {
+            LogError("Base64_Encode_Into failed");
+        }
+        else
+        {
+            /*Codes_SRS_BASE64_99_023: [ Base64_Encode_Update shall keep the bytes that do not make a whole group of 3 in context. ]*/
+            if (consumed < size)
+            {
+                (void)memcpy(context->pending + context->pendingSize, source + consumed, size - consumed);
+                context->pendingSize += size - consumed;
+            }
+
+            /*Codes_SRS_BASE64_99_024: [ On success Base64_Encode_Update shall set encodedLength to the number of characters written and return 0. ]*/
+            *encodedLength = written;
+        }
+    }
+    return result;
+}
+
+int Base64_Encode_Final(BASE64_ENCODE_CONTEXT* context, char* destination, size_t destinationSize, size_t* encodedLength)
+{
+    int result;
+    /*Codes_SRS_BASE64_99_025: [ If context, destination or encodedLength is NULL, Base64_Encode_Final shall fail and return a non-zero value. ]*/
+    if ((context == NULL) || (destination == NULL) || (encodedLength == NULL))
+    {
+        LogError("invalid argument BASE64_ENCODE_CONTEXT* context=%p, char* destination=%p, size_t* encodedLength=%p", context, destination, encodedLength);
+        result = __FAILURE__;
+    }
+    else if (context->pendingSize == 0)
+    {
+        /*Codes_SRS_BASE64_99_027: [ If there are no bytes pending in context, Base64_Encode_Final shall set encodedLength to 0 and return 0. ]*/
+        *encodedLength = 0;
+        result = 0;
+    }
+    /*Codes_SRS_BASE64_99_026: [ Otherwise Base64_Encode_Final shall write the 4 characters of the padded encoding of the bytes pending in context, set encodedLength to 4 and return 0; it shall fail and return a non-zero value if destinationSize is smaller than 4. ]*/
+    else if (Base64_Encode_Into(context->pending, context->pendingSize, destination, destinationSize, encodedLength) != 0)
+    {
+        LogError("Base64_Encode_Into failed");
+        result = __FAILURE__;
+    }
+    else
+    {
+        context->pendingSize = 0;
+        result = 0;
     }
     return result;
 }
 
-static void Base64decode(unsigned char *decodedString, const char *base64String)
-{
-
-    size_t numberOfEncodedChars;
-    size_t indexOfFirstEncodedChar;
-    size_t decodedIndex;
-
-    //
-    // We can only operate on individual bytes.  If we attempt to work
-    // on anything larger we could get an alignment fault on some
-    // architectures
-    //
-
-    numberOfEncodedChars = numberOfBase64Characters(base64String);
-    indexOfFirstEncodedChar = 0;
-    decodedIndex = 0;
-    while (numberOfEncodedChars >= 4)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        unsigned char c3;
-        unsigned char c4;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 2], &c3);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 3], &c4);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c2 & 0x0f) << 4) | (c3 >> 2);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c3 & 0x03) << 6) | c4;
-        decodedIndex++;
-        numberOfEncodedChars -= 4;
-        indexOfFirstEncodedChar += 4;
-
-    }
-
-    if (numberOfEncodedChars == 2)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-    }
-    else if (numberOfEncodedChars == 3)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        unsigned char c3;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 2], &c3);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c2 & 0x0f) << 4) | (c3 >> 2);
+int Base64_Decode_Init(BASE64_DECODE_CONTEXT* context)
+{
+    int result;
+    /*Codes_SRS_BASE64_99_028: [ If context is NULL, Base64_Decode_Init shall fail and return a non-zero value. ]*/
+    if (context == NULL)
+    {
+        LogError("invalid argument BASE64_DECODE_CONTEXT* context=%p", context);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_99_029: [ Otherwise Base64_Decode_Init shall start a new decoding in context and return 0. ]*/
+        context->pendingLength = 0;
+        context->isPadded = 0;
+        result = 0;
     }
+    return result;
+}
+
+int Base64_Decode_Update(BASE64_DECODE_CONTEXT* context, const char* source, size_t sourceLength, unsigned char* destination, size_t destinationSize, size_t* decodedLength)
+{
+    int result;
+    /*Codes_SRS_BASE64_99_030: [ If context, destination or decodedLength is NULL, or if source is NULL and sourceLength is not 0, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+    if ((context == NULL) || ((source == NULL) && (sourceLength != 0)) || (destination == NULL) || (decodedLength == NULL))
+    {
+        LogError("invalid argument BASE64_DECODE_CONTEXT* context=%p, const char* source=%p, size_t sourceLength=%lu, unsigned char* destination=%p, size_t* decodedLength=%p",
+            context, source, (unsigned long)sourceLength, destination, decodedLength);
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_BASE64_99_031: [ If the padding was already decoded and sourceLength is not 0, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+    else if (context->isPadded && (sourceLength != 0))
+    {
+        LogError("Base64 characters after the padding");
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_BASE64_99_032: [ If destinationSize is smaller than 3 bytes for each whole group of 4 made by the pending characters and source, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+    else if (destinationSize / 3 < (sourceLength / 4) + ((context->pendingLength + (sourceLength % 4)) / 4))
+    {
+        LogError("destination too small: %lu bytes available", (unsigned long)destinationSize);
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t consumed = 0;
+        size_t written = 0;
+        size_t groupLength;
+        result = 0;
+
+        /*Codes_SRS_BASE64_99_033: [ Base64_Decode_Update shall decode the characters pending in context followed by the characters at source, 4 at a time, in destination. ]*/
+        if ((context->pendingLength > 0) && (context->pendingLength + sourceLength >= 4))
+        {
+            char group[4];
+            (void)memcpy(group, context->pending, context->pendingLength);
+            consumed = 4 - context->pendingLength;
+            (void)memcpy(group + context->pendingLength, source, consumed);
+            context->pendingLength = 0;
+            if (Base64_Decode_Into(group, 4, destination, destinationSize, &groupLength) != 0)
+            {
+                result = __FAILURE__;
+            }
+            else
+            {
+                context->isPadded = (group[3] == '=');
+                written = groupLength;
+            }
+        }
+
+        if ((result == 0) && ((sourceLength - consumed) >= 4))
+        {
+            size_t wholeGroups = (sourceLength - consumed) / 4 * 4;
+            /*Codes_SRS_BASE64_99_034: [ If source has a character that is not in the base64 alphabet, or if '=' is anywhere but at the end of a group of 4 that ends the encoding, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+            if (context->isPadded ||
+                (Base64_Decode_Into(source + consumed, wholeGroups, destination + written, destinationSize - written, &groupLength) != 0))
+            {
+                result = __FAILURE__;
+            }
+            else
+            {
+                context->isPadded = (source[consumed + wholeGroups - 1] == '=');
+                written += groupLength;
+                consumed += wholeGroups;
+            }
+        }
+
+        /*Codes_SRS_BASE64_99_034: [ If source has a character that is not in the base64 alphabet, or if '=' is anywhere but at the end of a group of 4 that ends the encoding, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+        if ((result == 0) && context->isPadded && (consumed < sourceLength))
+        {
+            result = __FAILURE__;
+        }
+
+        if (result != 0)
+        {
+            LogError("Invalid Base64 characters");
+        }
+        else
+        {
+            /*Codes_SRS_BASE64_99_035: [ Base64_Decode_Update shall keep the characters that do not make a whole group of 4 in context. ]*/
+            if (consumed < sourceLength)
+            {
+                (void)memcpy(context->pending + context->pendingLength, source + consumed, sourceLength - consumed);
+                context->pendingLength += sourceLength - consumed;
+            }
+
+            /*Codes_SRS_BASE64_99_036: [ On success Base64_Decode_Update shall set decodedLength to the number of bytes written and return 0. ]*/
+            *decodedLength = written;
+        }
+    }
+    return result;
+}
+
+int Base64_Decode_Final(BASE64_DECODE_CONTEXT* context)
+{
+    int result;
+    /*Codes_SRS_BASE64_99_037: [ If context is NULL, Base64_Decode_Final shall fail and return a non-zero value. ]*/
+    if (context == NULL)
+    {
+        LogError("invalid argument BASE64_DECODE_CONTEXT* context=%p", context);
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_BASE64_99_038: [ If characters that do not make a whole group of 4 are pending in context, Base64_Decode_Final shall fail and return a non-zero value. ]*/
+    else if (context->pendingLength != 0)
+    {
+        LogError("Invalid length Base64 string!");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_99_039: [ Otherwise Base64_Decode_Final shall return 0. ]*/
+        result = 0;
+    }
+    return result;
 }
 
 BUFFER_HANDLE Base64_Decoder(const char* source)
@@ -195,7 +915,8 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
     }
     else
     {
-        if ((strlen(source) % 4) != 0)
+        size_t sourceLength = strlen(source);
+        if ((sourceLength % 4) != 0)
         {
             /*Codes_SRS_BASE64_06_011: [If the source string has an invalid length for a base 64 encoded string then Base64_Decode shall return NULL.]*/
             LogError("Invalid length Base64 string!");
@@ -210,10 +931,11 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
             }
             else
             {
-                size_t sizeOfOutputBuffer = Base64decode_len(source);
+                size_t sizeOfOutputBuffer = Base64_Decode_Length(source, sourceLength);
                 /*Codes_SRS_BASE64_06_009: [If the string pointed to by source is zero length then the handle returned shall refer to a zero length buffer.]*/
                 if (sizeOfOutputBuffer > 0)
                 {
+                    size_t decodedLength;
                     if (BUFFER_pre_build(result, sizeOfOutputBuffer) != 0)
                     {
                         /*Codes_SRS_BASE64_06_010: [If there is any memory allocation failure during the decode then Base64_Decode shall return NULL.]*/
@@ -221,9 +943,12 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
                         BUFFER_delete(result);
                         result = NULL;
                     }
-                    else
+                    /*Codes_SRS_BASE64_99_017: [ If source has a character that is not in the base64 alphabet, other than 1 or 2 '=' padding characters at the end, Base64_Decoder shall return NULL. ]*/
+                    else if (Base64_Decode_Into(source, sourceLength, BUFFER_u_char(result), sizeOfOutputBuffer, &decodedLength) != 0)
                     {
-                        Base64decode(BUFFER_u_char(result), source);
+                        LogError("Could not decode the Base64 string.");
+                        BUFFER_delete(result);
+                        result = NULL;
                     }
                 }
             }
@@ -236,78 +961,35 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
 static STRING_HANDLE Base64_Encode_Internal(const unsigned char* source, size_t size)
 {
     STRING_HANDLE result;
-    size_t neededSize = 0;
+    size_t encodedLength = Base64_Encode_Length(size);
     char* encoded;
-    size_t currentPosition = 0;
-    neededSize += (size == 0) ? (0) : ((((size - 1) / 3) + 1) * 4);
-    neededSize += 1; /*+1 because \0 at the end of the string*/
     /*Codes_SRS_BASE64_06_006: [If when allocating memory to produce the encoding a failure occurs then Base64_Encoder shall return NULL.]*/
-    encoded = (char*)malloc(neededSize);
-    if (encoded == NULL)
+    if (((encodedLength == 0) && (size != 0)) ||
+        ((encoded = (char*)malloc(encodedLength + 1)) == NULL)) /*+1 because \0 at the end of the string*/
     {
         result = NULL;
         LogError("Base64_Encoder:: Allocation failed.");
     }
     else
     {
-        /*b0            b1(+1)          b2(+2)
-        7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0
-        |----c1---| |----c2---| |----c3---| |----c4---|
-        */
-
-        size_t destinationPosition = 0;
-        while (size - currentPosition >= 3)
+        /*an empty BUFFER has no content to encode*/
+        if ((size != 0) && (Base64_Encode_Into(source, size, encoded, encodedLength, &encodedLength) != 0))
         {
-            char c1 = base64char(source[currentPosition] >> 2);
-            char c2 = base64char(
-                ((source[currentPosition] & 3) << 4) |
-                    (source[currentPosition + 1] >> 4)
-            );
-            char c3 = base64char(
-                ((source[currentPosition + 1] & 0x0F) << 2) |
-                    ((source[currentPosition + 2] >> 6) & 3)
-            );
-            char c4 = base64char(
-                source[currentPosition + 2] & 0x3F
-            );
-            currentPosition += 3;
-            encoded[destinationPosition++] = c1;
-            encoded[destinationPosition++] = c2;
-            encoded[destinationPosition++] = c3;
-            encoded[destinationPosition++] = c4;
-
-        }
-        if (size - currentPosition == 2)
-        {
-            char c1 = base64char(source[currentPosition] >> 2);
-            char c2 = base64char(
-                ((source[currentPosition] & 0x03) << 4) |
-                    (source[currentPosition + 1] >> 4)
-            );
-            char c3 = base64b16(source[currentPosition + 1] & 0x0F);
-            encoded[destinationPosition++] = c1;
-            encoded[destinationPosition++] = c2;
-            encoded[destinationPosition++] = c3;
-            encoded[destinationPosition++] = '=';
-        }
-        else if (size - currentPosition == 1)
-        {
-            char c1 = base64char(source[currentPosition] >> 2);
-            char c2 = base64b8(source[currentPosition] & 0x03);
-            encoded[destinationPosition++] = c1;
-            encoded[destinationPosition++] = c2;
-            encoded[destinationPosition++] = '=';
-            encoded[destinationPosition++] = '=';
+            free(encoded);
+            result = NULL;
+            LogError("Base64_Encoder:: encoding failed.");
         }
-
-        /*null terminating the string*/
-        encoded[destinationPosition] = '\0';
-        /*Codes_SRS_BASE64_06_007: [Otherwise Base64_Encoder shall return a pointer to STRING, that string contains the base 64 encoding of input.]*/
-        result = STRING_new_with_memory(encoded);
-        if (result == NULL)
+        else
         {
-            free(encoded);
-            LogError("Base64_Encoder:: Allocation failed for return value.");
+            /*null terminating the string*/
+            encoded[encodedLength] = '\0';
+            /*Codes_SRS_BASE64_06_007: [Otherwise Base64_Encoder shall return a pointer to STRING, that string contains the base 64 encoding of input.]*/
+            result = STRING_new_with_memory(encoded);
+            if (result == NULL)
+            {
+                free(encoded);
+                LogError("Base64_Encoder:: Allocation failed for return value.");
+            }
         }
     }
     return result;
@@ -3,19 +3,100 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/arena.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 
+/* content up to this many bytes fits in the allocation of a BUFFER made by BUFFER_create_inline */
+#define BUFFER_INLINE_MIN_SIZE 32
+
 typedef struct BUFFER_TAG
 {
     unsigned char* buffer;
     size_t size;
+    /* NULL for BUFFERs on the heap, otherwise the arena both the BUFFER and its content come from */
+    ARENA_HANDLE arena;
+    /* bytes available right after the BUFFER in its own allocation, 0 unless made by BUFFER_create_inline */
+    size_t inline_size;
 } BUFFER;
 
+static unsigned char* inline_data(BUFFER* b)
+{
+    return (unsigned char*)b + sizeof(BUFFER);
+}
+
+static bool is_inline(BUFFER* b, const unsigned char* memory)
+{
+    return (b->inline_size != 0) && (memory == inline_data(b));
+}
+
+static bool fits_inline(BUFFER* b, size_t size)
+{
+    return (b->inline_size != 0) && (size <= b->inline_size);
+}
+
+/* Codes_SRS_BUFFER_99_005: [ The functions that change the content of a BUFFER built in an arena shall take the memory for the new content from that arena. ]*/
+static unsigned char* buffer_malloc(BUFFER* b, size_t size)
+{
+    unsigned char* result;
+    if (b->arena != NULL)
+    {
+        result = (unsigned char*)ARENA_malloc(b->arena, size);
+    }
+    else if (fits_inline(b, size) && !is_inline(b, b->buffer))
+    {
+        /* Codes_SRS_BUFFER_99_016: [ The functions that change the content of a BUFFER made by BUFFER_create_inline shall keep the content in the allocation of the BUFFER while it fits and move it to memory of its own when it does not. ]*/
+        result = inline_data(b);
+    }
+    else
+    {
+        result = (unsigned char*)malloc(size);
+    }
+    return result;
+}
+
+static unsigned char* buffer_realloc(BUFFER* b, size_t size)
+{
+    unsigned char* result;
+    if (b->arena != NULL)
+    {
+        result = (unsigned char*)ARENA_realloc(b->arena, b->buffer, b->size, size);
+    }
+    else if (fits_inline(b, size) && ((b->buffer == NULL) || is_inline(b, b->buffer)))
+    {
+        /* Codes_SRS_BUFFER_99_016: [ The functions that change the content of a BUFFER made by BUFFER_create_inline shall keep the content in the allocation of the BUFFER while it fits and move it to memory of its own when it does not. ]*/
+        result = inline_data(b);
+    }
+    else if (is_inline(b, b->buffer))
+    {
+        /* the inline storage cannot grow, the content moves out of it */
+        result = (unsigned char*)malloc(size);
+        if (result != NULL)
+        {
+            (void)memcpy(result, b->buffer, (b->size < size) ? b->size : size);
+        }
+    }
+    else
+    {
+        result = (unsigned char*)realloc(b->buffer, size);
+    }
+    return result;
+}
+
+/* memory taken from an arena goes back to it when the arena is reset, inline storage goes with the BUFFER */
+static void buffer_free(BUFFER* b, unsigned char* memory)
+{
+    if ((b->arena == NULL) && !is_inline(b, memory))
+    {
+        free(memory);
+    }
+}
+
 /* Codes_SRS_BUFFER_07_001: [BUFFER_new shall allocate a BUFFER_HANDLE that will contain a NULL unsigned char*.] */
 BUFFER_HANDLE BUFFER_new(void)
 {
@@ -25,6 +106,8 @@ BUFFER_HANDLE BUFFER_new(void)
     {
         temp->buffer = NULL;
         temp->size = 0;
+        temp->arena = NULL;
+        temp->inline_size = 0;
     }
     return (BUFFER_HANDLE)temp;
 }
@@ -37,7 +120,7 @@ static int BUFFER_safemalloc(BUFFER* handleptr, size_t size)
     {
         sizetomalloc = 1;
     }
-    handleptr->buffer = (unsigned char*)malloc(sizetomalloc);
+    handleptr->buffer = buffer_malloc(handleptr, sizetomalloc);
     if (handleptr->buffer == NULL)
     {
         /*Codes_SRS_BUFFER_02_003: [If allocating memory fails, then BUFFER_create shall return NULL.]*/
@@ -74,6 +157,8 @@ BUFFER_HANDLE BUFFER_create(const unsigned char* source, size_t size)
         }
         else
         {
+            result->arena = NULL;
+            result->inline_size = 0;
             /* Codes_SRS_BUFFER_02_005: [If size parameter is 0 then 1 byte of memory shall be allocated yet size of the buffer shall be set to 0.]*/
             if (BUFFER_safemalloc(result, size) != 0)
             {
@@ -91,6 +176,93 @@ BUFFER_HANDLE BUFFER_create(const unsigned char* source, size_t size)
     return (BUFFER_HANDLE)result;
 }
 
+/* Codes_SRS_BUFFER_99_001: [ BUFFER_new_in_arena shall take from arena a BUFFER_HANDLE that will contain a NULL unsigned char*. ]*/
+BUFFER_HANDLE BUFFER_new_in_arena(ARENA_HANDLE arena)
+{
+    BUFFER* result;
+    if (arena == NULL)
+    {
+        /* Codes_SRS_BUFFER_99_002: [ If arena is NULL or taking memory from it fails, BUFFER_new_in_arena shall return NULL. ]*/
+        LogError("invalid parameter arena: %p", arena);
+        result = NULL;
+    }
+    else if ((result = (BUFFER*)ARENA_malloc(arena, sizeof(BUFFER))) == NULL)
+    {
+        /* Codes_SRS_BUFFER_99_002: [ If arena is NULL or taking memory from it fails, BUFFER_new_in_arena shall return NULL. ]*/
+        LogError("Failure taking a BUFFER from the arena");
+    }
+    else
+    {
+        result->buffer = NULL;
+        result->size = 0;
+        result->arena = arena;
+        result->inline_size = 0;
+    }
+    return (BUFFER_HANDLE)result;
+}
+
+BUFFER_HANDLE BUFFER_create_in_arena(ARENA_HANDLE arena, const unsigned char* source, size_t size)
+{
+    BUFFER* result;
+    if ((arena == NULL) || (source == NULL))
+    {
+        /* Codes_SRS_BUFFER_99_004: [ If arena or source is NULL, or taking memory from arena fails, BUFFER_create_in_arena shall return NULL. ]*/
+        LogError("invalid parameter arena: %p, source: %p", arena, source);
+        result = NULL;
+    }
+    else if ((result = (BUFFER*)BUFFER_new_in_arena(arena)) == NULL)
+    {
+        /* Codes_SRS_BUFFER_99_004: [ If arena or source is NULL, or taking memory from arena fails, BUFFER_create_in_arena shall return NULL. ]*/
+        LogError("Failure taking a BUFFER from the arena");
+    }
+    else if (BUFFER_safemalloc(result, size) != 0)
+    {
+        /* Codes_SRS_BUFFER_99_004: [ If arena or source is NULL, or taking memory from arena fails, BUFFER_create_in_arena shall return NULL. ]*/
+        LogError("unable to BUFFER_safemalloc ");
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_BUFFER_99_003: [ BUFFER_create_in_arena shall take size bytes from arena, copy size bytes from source into them and return a non-NULL handle. ]*/
+        (void)memcpy(result->buffer, source, size);
+    }
+    return (BUFFER_HANDLE)result;
+}
+
+BUFFER_HANDLE BUFFER_create_inline(const unsigned char* source, size_t size)
+{
+    BUFFER* result;
+    size_t inline_size = (size < BUFFER_INLINE_MIN_SIZE) ? BUFFER_INLINE_MIN_SIZE : size;
+    if (source == NULL)
+    {
+        /* Codes_SRS_BUFFER_99_013: [ If source is NULL, size is too large or allocating memory fails, BUFFER_create_inline shall return NULL. ]*/
+        LogError("invalid parameter source: %p", source);
+        result = NULL;
+    }
+    else if (inline_size > SIZE_MAX - sizeof(BUFFER))
+    {
+        /* Codes_SRS_BUFFER_99_013: [ If source is NULL, size is too large or allocating memory fails, BUFFER_create_inline shall return NULL. ]*/
+        LogError("size %u too large", (unsigned int)size);
+        result = NULL;
+    }
+    /* Codes_SRS_BUFFER_99_014: [ BUFFER_create_inline shall allocate the BUFFER and room for at least 32 bytes of content, or size bytes when size is larger, in a single allocation. ]*/
+    else if ((result = (BUFFER*)malloc(sizeof(BUFFER) + inline_size)) == NULL)
+    {
+        /* Codes_SRS_BUFFER_99_013: [ If source is NULL, size is too large or allocating memory fails, BUFFER_create_inline shall return NULL. ]*/
+        LogError("Failure allocating BUFFER structure");
+    }
+    else
+    {
+        /* Codes_SRS_BUFFER_99_015: [ BUFFER_create_inline shall copy size bytes from source into the room that follows the BUFFER and return a non-NULL handle. ]*/
+        result->arena = NULL;
+        result->inline_size = inline_size;
+        result->buffer = inline_data(result);
+        result->size = size;
+        (void)memcpy(result->buffer, source, size);
+    }
+    return (BUFFER_HANDLE)result;
+}
+
 /* Codes_SRS_BUFFER_07_003: [BUFFER_delete shall delete the data associated with the BUFFER_HANDLE along with the Buffer.] */
 void BUFFER_delete(BUFFER_HANDLE handle)
 {
@@ -98,12 +270,16 @@ void BUFFER_delete(BUFFER_HANDLE handle)
     if (handle != NULL)
     {
         BUFFER* b = (BUFFER*)handle;
-        if (b->buffer != NULL)
+        /* Codes_SRS_BUFFER_99_006: [ BUFFER_delete shall not free a BUFFER built in an arena, its memory goes back to the arena when the arena is reset or destroyed. ]*/
+        if (b->arena == NULL)
         {
-            /* Codes_SRS_BUFFER_07_003: [BUFFER_delete shall delete the data associated with the BUFFER_HANDLE along with the Buffer.] */
-            free(b->buffer);
+            if (b->buffer != NULL)
+            {
+                /* Codes_SRS_BUFFER_07_003: [BUFFER_delete shall delete the data associated with the BUFFER_HANDLE along with the Buffer.] */
+                buffer_free(b, b->buffer);
+            }
+            free(b);
         }
-        free(b);
     }
 }
 
@@ -123,7 +299,7 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
     {
         /* Codes_SRS_BUFFER_01_003: [If size is zero, source can be NULL.] */
         BUFFER* b = (BUFFER*)handle;
-        free(b->buffer);
+        buffer_free(b, b->buffer);
         b->buffer = NULL;
         b->size = 0;
 
@@ -140,7 +316,7 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
         {
             BUFFER* b = (BUFFER*)handle;
             /* Codes_SRS_BUFFER_07_011: [BUFFER_build shall overwrite previous contents if the buffer has been previously allocated.] */
-            unsigned char* newBuffer = (unsigned char*)realloc(b->buffer, size);
+            unsigned char* newBuffer = buffer_realloc(b, size);
             if (newBuffer == NULL)
             {
                 /* Codes_SRS_BUFFER_07_010: [BUFFER_build shall return nonzero if any error is encountered.] */
@@ -193,7 +369,7 @@ int BUFFER_append_build(BUFFER_HANDLE handle, const unsigned char* source, size_
         else
         {
             /* Codes_SRS_BUFFER_07_032: [ if handle->buffer is not NULL BUFFER_append_build shall realloc the buffer to be the handle->size + size ] */
-            unsigned char* temp = (unsigned char*)realloc(handle->buffer, handle->size + size);
+            unsigned char* temp = buffer_realloc(handle, handle->size + size);
             if (temp == NULL)
             {
                 /* Codes_SRS_BUFFER_07_035: [ If any error is encountered BUFFER_append_build shall return a non-null value. ] */
@@ -242,7 +418,7 @@ int BUFFER_pre_build(BUFFER_HANDLE handle, size_t size)
         }
         else
         {
-            if ((b->buffer = (unsigned char*)malloc(size)) == NULL)
+            if ((b->buffer = buffer_malloc(b, size)) == NULL)
             {
                 /* Codes_SRS_BUFFER_07_013: [BUFFER_pre_build shall return nonzero if any error is encountered.] */
                 LogError("Failure allocating buffer");
@@ -292,7 +468,7 @@ extern int BUFFER_unbuild(BUFFER_HANDLE handle)
         if (b->buffer != NULL)
         {
             LogError("Failure buffer data is NULL");
-            free(b->buffer);
+            buffer_free(b, b->buffer);
             b->buffer = NULL;
             b->size = 0;
             result = 0;
@@ -306,6 +482,63 @@ extern int BUFFER_unbuild(BUFFER_HANDLE handle)
     return result;
 }
 
+int BUFFER_detach(BUFFER_HANDLE handle, unsigned char** content, size_t* size)
+{
+    int result;
+    if ((handle == NULL) || (content == NULL) || (size == NULL))
+    {
+        /* Codes_SRS_BUFFER_99_007: [ If handle, content or size is NULL, BUFFER_detach shall return a nonzero value. ]*/
+        LogError("invalid parameter handle: %p, content: %p, size: %p", handle, content, size);
+        result = __FAILURE__;
+    }
+    else
+    {
+        BUFFER* b = (BUFFER*)handle;
+        if (b->size == 0)
+        {
+            /* Codes_SRS_BUFFER_99_010: [ If the BUFFER is empty, BUFFER_detach shall set *content to NULL and *size to 0 and release whatever memory the BUFFER holds. ]*/
+            buffer_free(b, b->buffer);
+            *content = NULL;
+            *size = 0;
+            result = 0;
+        }
+        else if ((b->arena == NULL) && !is_inline(b, b->buffer))
+        {
+            /* Codes_SRS_BUFFER_99_008: [ BUFFER_detach shall hand the memory of the BUFFER over to the caller, who frees it with free, without copying it, and set *size to the size of the BUFFER. ]*/
+            *content = b->buffer;
+            *size = b->size;
+            result = 0;
+        }
+        else
+        {
+            /* Codes_SRS_BUFFER_99_009: [ The content of a BUFFER built in an arena shall be copied to memory obtained with malloc, since the arena memory cannot outlive the arena. ]*/
+            /* Codes_SRS_BUFFER_99_017: [ Content kept in the allocation of a BUFFER made by BUFFER_create_inline shall be copied to memory obtained with malloc as well. ]*/
+            unsigned char* copy = (unsigned char*)malloc(b->size);
+            if (copy == NULL)
+            {
+                /* Codes_SRS_BUFFER_99_012: [ If copying the content fails, BUFFER_detach shall return a nonzero value and leave the BUFFER unchanged. ]*/
+                LogError("Failure copying %u bytes out of the BUFFER", (unsigned int)b->size);
+                result = __FAILURE__;
+            }
+            else
+            {
+                (void)memcpy(copy, b->buffer, b->size);
+                *content = copy;
+                *size = b->size;
+                result = 0;
+            }
+        }
+
+        if (result == 0)
+        {
+            /* Codes_SRS_BUFFER_99_011: [ On success BUFFER_detach shall leave the BUFFER empty and return zero. ]*/
+            b->buffer = NULL;
+            b->size = 0;
+        }
+    }
+    return result;
+}
+
 /* Codes_SRS_BUFFER_07_016: [BUFFER_enlarge shall increase the size of the unsigned char* referenced by BUFFER_HANDLE.] */
 int BUFFER_enlarge(BUFFER_HANDLE handle, size_t enlargeSize)
 {
@@ -325,7 +558,7 @@ int BUFFER_enlarge(BUFFER_HANDLE handle, size_t enlargeSize)
     else
     {
         BUFFER* b = (BUFFER*)handle;
-        unsigned char* temp = (unsigned char*)realloc(b->buffer, b->size + enlargeSize);
+        unsigned char* temp = buffer_realloc(b, b->size + enlargeSize);
         if (temp == NULL)
         {
             /* Codes_SRS_BUFFER_07_018: [BUFFER_enlarge shall return a nonzero result if any error is encountered.] */
@@ -370,14 +603,14 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
         if (alloc_size == 0)
         {
             /* Codes_SRS_BUFFER_07_043: [ If the decreaseSize is equal the buffer size , BUFFER_shrink shall deallocate the buffer and set the size to zero. ] */
-            free(handle->buffer);
+            buffer_free(handle, handle->buffer);
             handle->buffer = NULL;
             handle->size = 0;
             result = 0;
         }
         else
         {
-            unsigned char* tmp = malloc(alloc_size);
+            unsigned char* tmp = buffer_malloc(handle, alloc_size);
             if (tmp == NULL)
             {
                 /* Codes_SRS_BUFFER_07_042: [ If a failure is encountered, BUFFER_shrink shall return a non-null value ] */
@@ -390,7 +623,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
                 {
                     /* Codes_SRS_BUFFER_07_040: [ if the fromEnd variable is true, BUFFER_shrink shall remove the end of the buffer of size decreaseSize. ] */
                     memcpy(tmp, handle->buffer, alloc_size);
-                    free(handle->buffer);
+                    buffer_free(handle, handle->buffer);
                     handle->buffer = tmp;
                     handle->size = alloc_size;
                     result = 0;
@@ -399,7 +632,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
                 {
                     /* Codes_SRS_BUFFER_07_041: [ if the fromEnd variable is false, BUFFER_shrink shall remove the beginning of the buffer of size decreaseSize. ] */
                     memcpy(tmp, handle->buffer + decreaseSize, alloc_size);
-                    free(handle->buffer);
+                    buffer_free(handle, handle->buffer);
                     handle->buffer = tmp;
                     handle->size = alloc_size;
                     result = 0;
@@ -461,7 +694,7 @@ int BUFFER_append(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
             else
             {
                 // b2->size != 0, whatever b1->size is
-                unsigned char* temp = (unsigned char*)realloc(b1->buffer, b1->size + b2->size);
+                unsigned char* temp = buffer_realloc(b1, b1->size + b2->size);
                 if (temp == NULL)
                 {
                     /* Codes_SRS_BUFFER_07_023: [BUFFER_append shall return a nonzero upon any error that is encountered.] */
@@ -516,7 +749,7 @@ int BUFFER_prepend(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
             else
             {
                 // b2->size != 0
-                unsigned char* temp = (unsigned char*)malloc(b1->size + b2->size);
+                unsigned char* temp = buffer_malloc(b1, b1->size + b2->size);
                 if (temp == NULL)
                 {
                     /* Codes_SRS_BUFFER_01_005: [ BUFFER_prepend shall return a non-zero upon value any error that is encountered. ]*/
@@ -530,7 +763,7 @@ int BUFFER_prepend(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
                     (void)memcpy(temp, b2->buffer, b2->size);
                     // start from b1->size to append b1
                     (void)memcpy(&temp[b2->size], b1->buffer, b1->size);
-                    free(b1->buffer);
+                    buffer_free(b1, b1->buffer);
                     b1->buffer = temp;
                     b1->size += b2->size;
                     result = 0;
@@ -613,6 +846,8 @@ BUFFER_HANDLE BUFFER_clone(BUFFER_HANDLE handle)
         BUFFER* b = (BUFFER*)malloc(sizeof(BUFFER));
         if (b != NULL)
         {
+            b->arena = NULL;
+            b->inline_size = 0;
             if (BUFFER_safemalloc(b, suppliedBuff->size) != 0)
             {
                 LogError("Failure: allocating temp buffer.");
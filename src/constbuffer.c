@@ -11,9 +11,23 @@
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/refcount.h"
 
+typedef enum CONSTBUFFER_TYPE_TAG
+{
+    CONSTBUFFER_TYPE_COPIED,
+    CONSTBUFFER_TYPE_MEMORY_MOVED,
+    CONSTBUFFER_TYPE_WITH_CUSTOM_FREE,
+    CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE
+} CONSTBUFFER_TYPE;
+
 typedef struct CONSTBUFFER_HANDLE_DATA_TAG
 {
     CONSTBUFFER alias;
+    CONSTBUFFER_TYPE bufferType;
+    /*only for CONSTBUFFER_TYPE_WITH_CUSTOM_FREE*/
+    CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc;
+    void* customFreeFuncContext;
+    /*only for CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE: the constbuffer that owns the memory, a reference to it is held*/
+    CONSTBUFFER_HANDLE originalHandle;
 }CONSTBUFFER_HANDLE_DATA;
 
 DEFINE_REFCOUNT_TYPE(CONSTBUFFER_HANDLE_DATA);
@@ -35,6 +49,7 @@ static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* sourc
     {
         /*Codes_SRS_CONSTBUFFER_02_002: [Otherwise, CONSTBUFFER_Create shall create a copy of the memory area pointed to by source having size bytes.]*/
         result->alias.size = size;
+        result->bufferType = CONSTBUFFER_TYPE_COPIED;
         if (size == 0)
         {
             result->alias.buffer = NULL;
@@ -102,6 +117,164 @@ CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromBuffer(BUFFER_HANDLE buffer)
     return (CONSTBUFFER_HANDLE)result;
 }
 
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromBufferWithMove(BUFFER_HANDLE buffer)
+{
+    CONSTBUFFER_HANDLE_DATA* result;
+
+    if (buffer == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_99_016: [If buffer is NULL then CONSTBUFFER_CreateFromBufferWithMove shall fail and return NULL.]*/
+        LogError("invalid arg passed to CONSTBUFFER_CreateFromBufferWithMove");
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_99_019: [The non-NULL handle returned by CONSTBUFFER_CreateFromBufferWithMove shall have its ref count set to "1".]*/
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_HANDLE_DATA);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_99_018: [If allocating the handle or BUFFER_detach fails, CONSTBUFFER_CreateFromBufferWithMove shall return NULL and leave buffer unchanged.]*/
+            LogError("unable to malloc");
+        }
+        else
+        {
+            /*the handle is allocated first so that nothing is left to fail once buffer has been emptied*/
+            unsigned char* content;
+            size_t size;
+            if (BUFFER_detach(buffer, &content, &size) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_99_018: [If allocating the handle or BUFFER_detach fails, CONSTBUFFER_CreateFromBufferWithMove shall return NULL and leave buffer unchanged.]*/
+                LogError("unable to detach the content of the buffer");
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_99_017: [Otherwise CONSTBUFFER_CreateFromBufferWithMove shall take the content of buffer by calling BUFFER_detach and return a non-NULL handle whose content is that memory.]*/
+                result->alias.buffer = content;
+                result->alias.size = size;
+                result->bufferType = CONSTBUFFER_TYPE_MEMORY_MOVED;
+            }
+        }
+    }
+
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateWithMoveMemory(unsigned char* source, size_t size)
+{
+    CONSTBUFFER_HANDLE_DATA* result;
+
+    if ((source == NULL) && (size != 0))
+    {
+        /*Codes_SRS_CONSTBUFFER_99_001: [If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithMoveMemory shall fail and return NULL.]*/
+        LogError("invalid arguments passed to CONSTBUFFER_CreateWithMoveMemory: source=%p, size=%u", source, (unsigned int)size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_99_004: [The non-NULL handle returned by CONSTBUFFER_CreateWithMoveMemory shall have its ref count set to "1".]*/
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_HANDLE_DATA);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_99_003: [If allocating the handle fails, CONSTBUFFER_CreateWithMoveMemory shall return NULL and leave source to the caller.]*/
+            LogError("unable to malloc");
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_99_002: [Otherwise CONSTBUFFER_CreateWithMoveMemory shall return a non-NULL handle whose content is the memory pointed to by source, without copying it, and take ownership of source.]*/
+            result->alias.buffer = source;
+            result->alias.size = size;
+            result->bufferType = CONSTBUFFER_TYPE_MEMORY_MOVED;
+        }
+    }
+
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateWithCustomFree(const unsigned char* source, size_t size, CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc, void* customFreeFuncContext)
+{
+    CONSTBUFFER_HANDLE_DATA* result;
+
+    if (
+        ((source == NULL) && (size != 0)) ||
+        (customFreeFunc == NULL)
+        )
+    {
+        /*Codes_SRS_CONSTBUFFER_99_005: [If source is NULL and size is different than 0, or customFreeFunc is NULL, then CONSTBUFFER_CreateWithCustomFree shall fail and return NULL.]*/
+        LogError("invalid arguments passed to CONSTBUFFER_CreateWithCustomFree: source=%p, size=%u, customFreeFuncContext=%p",
+            source, (unsigned int)size, customFreeFuncContext);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_99_008: [The non-NULL handle returned by CONSTBUFFER_CreateWithCustomFree shall have its ref count set to "1".]*/
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_HANDLE_DATA);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_99_007: [If allocating the handle fails, CONSTBUFFER_CreateWithCustomFree shall return NULL and not call customFreeFunc.]*/
+            LogError("unable to malloc");
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_99_006: [Otherwise CONSTBUFFER_CreateWithCustomFree shall return a non-NULL handle whose content is the memory pointed to by source, without copying it, and remember customFreeFunc and customFreeFuncContext.]*/
+            result->alias.buffer = source;
+            result->alias.size = size;
+            result->bufferType = CONSTBUFFER_TYPE_WITH_CUSTOM_FREE;
+            result->customFreeFunc = customFreeFunc;
+            result->customFreeFuncContext = customFreeFuncContext;
+        }
+    }
+
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromOffsetAndSize(CONSTBUFFER_HANDLE handle, size_t offset, size_t size)
+{
+    CONSTBUFFER_HANDLE_DATA* result;
+    CONSTBUFFER_HANDLE_DATA* original = (CONSTBUFFER_HANDLE_DATA*)handle;
+
+    if (
+        (handle == NULL) ||
+        (offset > original->alias.size) ||
+        (size > original->alias.size - offset)
+        )
+    {
+        /*Codes_SRS_CONSTBUFFER_99_009: [If handle is NULL, or offset + size is larger than the size of handle, then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+        LogError("invalid arguments passed to CONSTBUFFER_CreateFromOffsetAndSize: handle=%p, offset=%u, size=%u", handle, (unsigned int)offset, (unsigned int)size);
+        result = NULL;
+    }
+    else if ((offset == 0) && (size == original->alias.size))
+    {
+        /*Codes_SRS_CONSTBUFFER_99_010: [If offset is 0 and size is the size of handle, CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle and return handle.]*/
+        INC_REF(CONSTBUFFER_HANDLE_DATA, handle);
+        result = original;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_99_013: [The non-NULL handle returned by CONSTBUFFER_CreateFromOffsetAndSize shall have its ref count set to "1".]*/
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_HANDLE_DATA);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_99_012: [If allocating the handle fails, CONSTBUFFER_CreateFromOffsetAndSize shall return NULL.]*/
+            LogError("unable to malloc");
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_99_011: [Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall return a non-NULL handle whose content is the size bytes at offset of the content of handle, without copying them, and hold a reference to the constbuffer that owns that memory until it is destroyed.]*/
+            /*a range of a range refers to the owner directly, so that chains of ranges do not build up*/
+            CONSTBUFFER_HANDLE owner = (original->bufferType == CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE) ? original->originalHandle : handle;
+            INC_REF(CONSTBUFFER_HANDLE_DATA, owner);
+            result->alias.buffer = original->alias.buffer + offset;
+            result->alias.size = size;
+            result->bufferType = CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE;
+            result->originalHandle = owner;
+        }
+    }
+
+    return (CONSTBUFFER_HANDLE)result;
+}
+
 CONSTBUFFER_HANDLE CONSTBUFFER_Clone(CONSTBUFFER_HANDLE constbufferHandle)
 {
     if (constbufferHandle == NULL)
@@ -144,7 +317,20 @@ void CONSTBUFFER_Destroy(CONSTBUFFER_HANDLE constbufferHandle)
         {
             /*Codes_SRS_CONSTBUFFER_02_017: [If the refcount reaches zero, then CONSTBUFFER_Destroy shall deallocate all resources used by the CONSTBUFFER_HANDLE.]*/
             CONSTBUFFER_HANDLE_DATA* constbufferHandleData = (CONSTBUFFER_HANDLE_DATA*)constbufferHandle;
-            free((void*)constbufferHandleData->alias.buffer);
+            switch (constbufferHandleData->bufferType)
+            {
+            case CONSTBUFFER_TYPE_WITH_CUSTOM_FREE:
+                /*Codes_SRS_CONSTBUFFER_99_014: [If the constbuffer was created with CONSTBUFFER_CreateWithCustomFree, CONSTBUFFER_Destroy shall call customFreeFunc with customFreeFuncContext instead of freeing the content.]*/
+                constbufferHandleData->customFreeFunc(constbufferHandleData->customFreeFuncContext);
+                break;
+            case CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE:
+                /*Codes_SRS_CONSTBUFFER_99_015: [If the constbuffer was created with CONSTBUFFER_CreateFromOffsetAndSize, CONSTBUFFER_Destroy shall release its reference to the constbuffer that owns the content instead of freeing the content.]*/
+                CONSTBUFFER_Destroy(constbufferHandleData->originalHandle);
+                break;
+            default:
+                free((void*)constbufferHandleData->alias.buffer);
+                break;
+            }
             free(constbufferHandleData);
         }
     }
@@ -4,35 +4,431 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <time.h>
 #include "azure_c_shared_utility/lock.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/gballoc_allocator.h"
+#ifdef GB_USE_POOL
+#include "azure_c_shared_utility/gballoc_pool.h"
+#endif
 
 #ifndef SIZE_MAX
 #define SIZE_MAX ((size_t)~(size_t)0)
 #endif
 
+/* The default allocator hands out blocks from the size-class pools when the library is built with use_gballoc_pool
+and from the C99 functions otherwise; the tracking table itself always comes from malloc */
+#ifdef GB_USE_POOL
+#define GBALLOC_DEFAULT_MALLOC(size)            gballoc_pool_malloc(size)
+#define GBALLOC_DEFAULT_CALLOC(nmemb, size)     gballoc_pool_calloc(nmemb, size)
+#define GBALLOC_DEFAULT_REALLOC(ptr, size)      gballoc_pool_realloc(ptr, size)
+#define GBALLOC_DEFAULT_FREE(ptr)               gballoc_pool_free(ptr)
+#else
+#define GBALLOC_DEFAULT_MALLOC(size)            malloc(size)
+#define GBALLOC_DEFAULT_CALLOC(nmemb, size)     calloc(nmemb, size)
+#define GBALLOC_DEFAULT_REALLOC(ptr, size)      realloc(ptr, size)
+#define GBALLOC_DEFAULT_FREE(ptr)               free(ptr)
+#endif
+
+/* Tracked blocks live in an open addressed hash table keyed by the block address, so that looking a block up
+on free/realloc does not depend on the number of live blocks and tracking does not need an extra allocation per block */
 typedef struct ALLOCATION_TAG
 {
-    size_t size;
     void* ptr;
-    void* next;
+    size_t size;
+    /* code address that allocated the block, NULL when site profiling was off */
+    const void* site;
 } ALLOCATION;
 
+/* Sites live in their own open addressed table keyed by the code address, they are only dropped when profiling stops */
+typedef struct ALLOCATION_SITE_TAG
+{
+    const void* site;
+    size_t live_bytes;
+    size_t live_count;
+    size_t allocation_count;
+    size_t allocated_bytes;
+} ALLOCATION_SITE;
+
+/* the address the public functions return to identifies the code that asked for the memory */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#define GBALLOC_CALL_SITE()     ((const void*)_ReturnAddress())
+#elif defined(__GNUC__) || defined(__clang__)
+#define GBALLOC_CALL_SITE()     ((const void*)__builtin_return_address(0))
+#else
+/* every block is accounted to a single unknown site */
+#define GBALLOC_CALL_SITE()     ((const void*)1)
+#endif
+
 typedef enum GBALLOC_STATE_TAG
 {
     GBALLOC_STATE_INIT,
     GBALLOC_STATE_NOT_INIT
 } GBALLOC_STATE;
 
-static ALLOCATION* head = NULL;
+/* must be a power of 2 */
+#define GBALLOC_INITIAL_TABLE_SIZE 64
+
+static ALLOCATION* allocations = NULL;
+static size_t allocationsCapacity = 0;
+static size_t allocationsCount = 0;
+/* set when gballoc_deinit kept the blocks still allocated in the table, which may then hold blocks freed while not initialized */
+static bool allocationsKept = false;
 static size_t totalSize = 0;
 static size_t maxSize = 0;
 static size_t g_allocations = 0;
 static GBALLOC_STATE gballocState = GBALLOC_STATE_NOT_INIT;
 
+static ALLOCATION_SITE* sites = NULL;
+static size_t sitesCapacity = 0;
+static size_t sitesCount = 0;
+static bool siteProfiling = false;
+static time_t siteProfilingStart;
+
 static LOCK_HANDLE gballocThreadSafeLock = NULL;
 
+static size_t hash_pointer(const void* ptr)
+{
+    /* the low bits of a block address are mostly alignment, fold the higher bits into them */
+    size_t hash = (size_t)(uintptr_t)ptr;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3b;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static void insert_allocation(ALLOCATION* table, size_t capacity, void* ptr, size_t size, const void* site)
+{
+    size_t index = hash_pointer(ptr) & (capacity - 1);
+    while (table[index].ptr != NULL)
+    {
+        index = (index + 1) & (capacity - 1);
+    }
+
+    table[index].ptr = ptr;
+    table[index].size = size;
+    table[index].site = site;
+}
+
+static ALLOCATION* find_allocation(const void* ptr)
+{
+    ALLOCATION* result = NULL;
+
+    if ((allocations != NULL) && (ptr != NULL))
+    {
+        size_t index = hash_pointer(ptr) & (allocationsCapacity - 1);
+        while (allocations[index].ptr != NULL)
+        {
+            if (allocations[index].ptr == ptr)
+            {
+                result = &allocations[index];
+                break;
+            }
+
+            index = (index + 1) & (allocationsCapacity - 1);
+        }
+    }
+
+    return result;
+}
+
+static void remove_allocation(ALLOCATION* allocation)
+{
+    size_t hole = (size_t)(allocation - allocations);
+    size_t index = (hole + 1) & (allocationsCapacity - 1);
+
+    /* shift back the entries that follow in the same probe run, so that no tombstones are needed */
+    while (allocations[index].ptr != NULL)
+    {
+        size_t home = hash_pointer(allocations[index].ptr) & (allocationsCapacity - 1);
+        if (((index - home) & (allocationsCapacity - 1)) >= ((index - hole) & (allocationsCapacity - 1)))
+        {
+            allocations[hole] = allocations[index];
+            hole = index;
+        }
+
+        index = (index + 1) & (allocationsCapacity - 1);
+    }
+
+    allocations[hole].ptr = NULL;
+    allocations[hole].size = 0;
+    allocations[hole].site = NULL;
+    allocationsCount--;
+}
+
+/* makes room for one more tracked block, keeping the table at most half full */
+static int reserve_allocation(void)
+{
+    int result;
+
+    if ((allocationsCount + 1) * 2 <= allocationsCapacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t newCapacity = (allocationsCapacity == 0) ? GBALLOC_INITIAL_TABLE_SIZE : allocationsCapacity * 2;
+        ALLOCATION* newAllocations;
+
+        if ((newCapacity < allocationsCapacity) || (newCapacity > SIZE_MAX / sizeof(ALLOCATION)))
+        {
+            result = __FAILURE__;
+        }
+        else if ((newAllocations = (ALLOCATION*)malloc(newCapacity * sizeof(ALLOCATION))) == NULL)
+        {
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t i;
+            (void)memset(newAllocations, 0, newCapacity * sizeof(ALLOCATION));
+
+            for (i = 0; i < allocationsCapacity; i++)
+            {
+                if (allocations[i].ptr != NULL)
+                {
+                    insert_allocation(newAllocations, newCapacity, allocations[i].ptr, allocations[i].size, allocations[i].site);
+                }
+            }
+
+            if (allocations != NULL)
+            {
+                free(allocations);
+            }
+
+            allocations = newAllocations;
+            allocationsCapacity = newCapacity;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static size_t hash_site(const void* site)
+{
+    size_t hash = (size_t)(uintptr_t)site;
+    hash ^= hash >> 15;
+    hash *= 0x2c1b3c6d;
+    hash ^= hash >> 12;
+    return hash;
+}
+
+static ALLOCATION_SITE* find_site(const void* site)
+{
+    ALLOCATION_SITE* result = NULL;
+
+    if (sites != NULL)
+    {
+        size_t index = hash_site(site) & (sitesCapacity - 1);
+        while (sites[index].site != NULL)
+        {
+            if (sites[index].site == site)
+            {
+                result = &sites[index];
+                break;
+            }
+
+            index = (index + 1) & (sitesCapacity - 1);
+        }
+    }
+
+    return result;
+}
+
+/* makes room for one more site, keeping the table at most half full */
+static int reserve_site(void)
+{
+    int result;
+
+    if ((sitesCount + 1) * 2 <= sitesCapacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t newCapacity = (sitesCapacity == 0) ? GBALLOC_INITIAL_TABLE_SIZE : sitesCapacity * 2;
+        ALLOCATION_SITE* newSites;
+
+        if ((newCapacity < sitesCapacity) || (newCapacity > SIZE_MAX / sizeof(ALLOCATION_SITE)))
+        {
+            result = __FAILURE__;
+        }
+        else if ((newSites = (ALLOCATION_SITE*)malloc(newCapacity * sizeof(ALLOCATION_SITE))) == NULL)
+        {
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t i;
+            (void)memset(newSites, 0, newCapacity * sizeof(ALLOCATION_SITE));
+
+            for (i = 0; i < sitesCapacity; i++)
+            {
+                if (sites[i].site != NULL)
+                {
+                    size_t index = hash_site(sites[i].site) & (newCapacity - 1);
+                    while (newSites[index].site != NULL)
+                    {
+                        index = (index + 1) & (newCapacity - 1);
+                    }
+                    newSites[index] = sites[i];
+                }
+            }
+
+            if (sites != NULL)
+            {
+                free(sites);
+            }
+
+            sites = newSites;
+            sitesCapacity = newCapacity;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+/* returns the entry of site, adding it if needed */
+static ALLOCATION_SITE* get_site(const void* site)
+{
+    ALLOCATION_SITE* result = find_site(site);
+
+    if (result == NULL)
+    {
+        if (reserve_site() != 0)
+        {
+            LogError("Cannot grow the allocation site table, the block is tracked without its site");
+        }
+        else
+        {
+            size_t index = hash_site(site) & (sitesCapacity - 1);
+            while (sites[index].site != NULL)
+            {
+                index = (index + 1) & (sitesCapacity - 1);
+            }
+
+            result = &sites[index];
+            result->site = site;
+            sitesCount++;
+        }
+    }
+
+    return result;
+}
+
+/* drops the site of every tracked block, their sites belong to a previous profiling session */
+static void clear_sites(void)
+{
+    size_t i;
+
+    if (sites != NULL)
+    {
+        free(sites);
+        sites = NULL;
+    }
+    sitesCapacity = 0;
+    sitesCount = 0;
+
+    for (i = 0; i < allocationsCapacity; i++)
+    {
+        allocations[i].site = NULL;
+    }
+}
+
+static void track_allocation(void* ptr, size_t size, const void* site)
+{
+    ALLOCATION_SITE* allocationSite = NULL;
+
+    if (allocationsKept)
+    {
+        /* Codes_SRS_GBALLOC_99_043: [A kept block freed while gballoc is not initialized shall be dropped from the table when its address is tracked again.] */
+        /* the underlying allocator only hands out the address of a kept block again once it was freed while gballoc was not initialized */
+        ALLOCATION* staleAllocation = find_allocation(ptr);
+        if (staleAllocation != NULL)
+        {
+            remove_allocation(staleAllocation);
+        }
+    }
+
+    if (siteProfiling)
+    {
+        /* Codes_SRS_GBALLOC_99_010: [While site profiling is on, every block tracked by gballoc_malloc, gballoc_calloc or gballoc_realloc shall be accounted to the code address that called them: one more allocation of size bytes and size more live bytes in one more live block.] */
+        /* Codes_SRS_GBALLOC_99_012: [If the site table cannot be grown, the block shall be tracked without a site.] */
+        allocationSite = get_site(site);
+        if (allocationSite != NULL)
+        {
+            allocationSite->allocation_count++;
+            allocationSite->allocated_bytes += size;
+            allocationSite->live_count++;
+            allocationSite->live_bytes += size;
+        }
+    }
+
+    insert_allocation(allocations, allocationsCapacity, ptr, size, (allocationSite == NULL) ? NULL : site);
+    allocationsCount++;
+
+    g_allocations++;
+    totalSize += size;
+    /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
+    if (maxSize < totalSize)
+    {
+        maxSize = totalSize;
+    }
+}
+
+static void untrack_site(const ALLOCATION* allocation)
+{
+    if (allocation->site != NULL)
+    {
+        /* Codes_SRS_GBALLOC_99_011: [When a block accounted to a site is freed or reallocated, its size and the block shall be removed from the live bytes and live blocks of that site.] */
+        ALLOCATION_SITE* allocationSite = find_site(allocation->site);
+        if (allocationSite != NULL)
+        {
+            allocationSite->live_count--;
+            allocationSite->live_bytes -= allocation->size;
+        }
+    }
+}
+
+/* the block was handed out by the underlying allocator outside of the lock, only its tracking needs the lock */
+static int track_new_block(void* ptr, size_t size, const void* site)
+{
+    int result;
+
+    /* Codes_SRS_GBALLOC_01_030: [gballoc_malloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+    /* Codes_SRS_GBALLOC_01_031: [gballoc_calloc shall ensure thread safety by using the lock created by gballoc_Init]  */
+    if (LOCK_OK != Lock(gballocThreadSafeLock))
+    {
+        LogError("Failed to get the Lock.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_99_002: [Before tracking a new block gballoc shall make sure the tracking table is at most half full, allocating it on first use and doubling its size when needed.] */
+        if (reserve_allocation() != 0)
+        {
+            result = __FAILURE__;
+        }
+        else
+        {
+            track_allocation(ptr, size, site);
+            result = 0;
+        }
+
+        (void)Unlock(gballocThreadSafeLock);
+    }
+
+    return result;
+}
+
 int gballoc_init(void)
 {
     int result;
@@ -48,6 +444,16 @@ int gballoc_init(void)
         /* Codes_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.]*/
         result = __FAILURE__;
     }
+#ifdef GB_USE_POOL
+    /* Codes_SRS_GBALLOC_99_004: [When built with GB_USE_POOL, gballoc_init shall initialize the size-class pools by calling gballoc_pool_init.] */
+    else if (gballoc_pool_init() != 0)
+    {
+        /* Codes_SRS_GBALLOC_99_005: [If gballoc_pool_init fails, gballoc_init shall free the lock and return a non-zero value.] */
+        LogError("Failed to initialize the size-class pools.");
+        (void)Lock_Deinit(gballocThreadSafeLock);
+        result = __FAILURE__;
+    }
+#endif
     else
     {
         gballocState = GBALLOC_STATE_INIT;
@@ -68,6 +474,39 @@ void gballoc_deinit(void)
 {
     if (gballocState == GBALLOC_STATE_INIT)
     {
+        if (allocationsCount == 0)
+        {
+            /* Codes_SRS_GBALLOC_99_003: [gballoc_deinit shall free the table used for tracking allocations when it tracks no block.] */
+            if (allocations != NULL)
+            {
+                free(allocations);
+                allocations = NULL;
+            }
+            allocationsCapacity = 0;
+            allocationsKept = false;
+        }
+        else
+        {
+            size_t i;
+
+            /* Codes_SRS_GBALLOC_99_042: [The blocks still tracked shall stay in the table, so that gballoc_free and gballoc_realloc recognize them after the next gballoc_init, and shall no longer count towards the memory used.] */
+            LogError("%u blocks are still allocated, they stay tracked", (unsigned int)allocationsCount);
+            for (i = 0; i < allocationsCapacity; i++)
+            {
+                allocations[i].size = 0;
+            }
+            allocationsKept = true;
+        }
+
+        /* Codes_SRS_GBALLOC_99_021: [gballoc_deinit shall stop site profiling and free the site table.] */
+        clear_sites();
+        siteProfiling = false;
+
+#ifdef GB_USE_POOL
+        /* Codes_SRS_GBALLOC_99_006: [When built with GB_USE_POOL, gballoc_deinit shall call gballoc_pool_deinit.] */
+        gballoc_pool_deinit();
+#endif
+
         /* Codes_SRS_GBALLOC_01_028: [gballoc_deinit shall free all resources allocated by gballoc_init.] */
         (void)Lock_Deinit(gballocThreadSafeLock);
     }
@@ -78,55 +517,30 @@ void gballoc_deinit(void)
 void* gballoc_malloc(size_t size)
 {
     void* result;
+    const void* site = GBALLOC_CALL_SITE();
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_039: [If gballoc was not initialized gballoc_malloc shall simply call malloc without any memory tracking being performed.] */
-        result = malloc(size);
-    }
-    /* Codes_SRS_GBALLOC_01_030: [gballoc_malloc shall ensure thread safety by using the lock created by gballoc_Init.] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
-        LogError("Failed to get the Lock.");
-        result = NULL;
-    }
-    else
-    {
-    ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-    if (allocation == NULL)
-    {
-        result = NULL;
+        result = gballoc_allocatorMalloc(size);
     }
     else
     {
         /* Codes_SRS_GBALLOC_01_003: [gb_malloc shall call the C99 malloc function and return its result.] */
-        result = malloc(size);
-        if (result == NULL)
-        {
-            /* Codes_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
-            free(allocation);
-        }
-        else
-        {
+        /* Codes_SRS_GBALLOC_99_039: [gballoc_malloc and gballoc_calloc shall call the underlying allocator before acquiring the lock, so that only the tracking of the block is serialized.] */
+        result = gballoc_allocatorMalloc(size);
+        /* Codes_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
+        if ((result != NULL) &&
             /* Codes_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gb_malloc shall increment the total memory used with the amount indicated by size.] */
-            allocation->ptr = result;
-            allocation->size = size;
-            allocation->next = head;
-            head = allocation;
-
-            g_allocations++;
-            totalSize += size;
-            /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-            if (maxSize < totalSize)
-            {
-                maxSize = totalSize;
-            }
+            (track_new_block(result, size, site) != 0))
+        {
+            /* Codes_SRS_GBALLOC_01_013: [When gballoc_malloc fails allocating memory for its internal use, gballoc_malloc shall return NULL.] */
+            /* Codes_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
+            /* Codes_SRS_GBALLOC_99_040: [If the block cannot be tracked, gballoc_malloc and gballoc_calloc shall give it back to the underlying allocator.] */
+            gballoc_allocatorFree(result);
+            result = NULL;
         }
     }
-
-        (void)Unlock(gballocThreadSafeLock);
-    }
     
     return result;
 }
@@ -134,54 +548,29 @@ void* gballoc_malloc(size_t size)
 void* gballoc_calloc(size_t nmemb, size_t size)
 {
     void* result;
+    const void* site = GBALLOC_CALL_SITE();
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_040: [If gballoc was not initialized gballoc_calloc shall simply call calloc without any memory tracking being performed.] */
-        result = calloc(nmemb, size);
-    }
-    /* Codes_SRS_GBALLOC_01_031: [gballoc_calloc shall ensure thread safety by using the lock created by gballoc_Init]  */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_046: [If acquiring the lock fails, gballoc_calloc shall return NULL.] */
-        LogError("Failed to get the Lock.");
-        result = NULL;
-    }
-    else
-    {
-    ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-    if (allocation == NULL)
-    {
-        result = NULL;
+        result = gballoc_allocatorCalloc(nmemb, size);
     }
     else
     {
         /* Codes_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
-        result = calloc(nmemb, size);
-        if (result == NULL)
-        {
-            /* Codes_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
-            free(allocation);
-        }
-        else
-        {
+        /* Codes_SRS_GBALLOC_99_039: [gballoc_malloc and gballoc_calloc shall call the underlying allocator before acquiring the lock, so that only the tracking of the block is serialized.] */
+        result = gballoc_allocatorCalloc(nmemb, size);
+        /* Codes_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
+        if ((result != NULL) &&
             /* Codes_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
-            allocation->ptr = result;
-            allocation->size = nmemb * size;
-            allocation->next = head;
-            head = allocation;
-            g_allocations++;
-
-            totalSize += allocation->size;
-            /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-            if (maxSize < totalSize)
-            {
-                maxSize = totalSize;
-            }
-        }
+            (track_new_block(result, nmemb * size, site) != 0))
+        {
+            /* Codes_SRS_GBALLOC_01_023: [When gballoc_calloc fails allocating memory for its internal use, gballoc_calloc shall return NULL.] */
+            /* Codes_SRS_GBALLOC_01_046: [If acquiring the lock fails, gballoc_calloc shall return NULL.] */
+            /* Codes_SRS_GBALLOC_99_040: [If the block cannot be tracked, gballoc_malloc and gballoc_calloc shall give it back to the underlying allocator.] */
+            gballoc_allocatorFree(result);
+            result = NULL;
         }
-
-        (void)Unlock(gballocThreadSafeLock);
     }
 
     return result;
@@ -189,92 +578,72 @@ void* gballoc_calloc(size_t nmemb, size_t size)
 
 void* gballoc_realloc(void* ptr, size_t size)
 {
-    ALLOCATION* curr;
     void* result;
-    ALLOCATION* allocation = NULL;
+    const void* site = GBALLOC_CALL_SITE();
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_041: [If gballoc was not initialized gballoc_realloc shall shall simply call realloc without any memory tracking being performed.] */
-        result = realloc(ptr, size);
+        result = gballoc_allocatorRealloc(ptr, size);
     }
     /* Codes_SRS_GBALLOC_01_032: [gballoc_realloc shall ensure thread safety by using the lock created by gballoc_Init.] */
     else if (LOCK_OK != Lock(gballocThreadSafeLock))
     {
-        /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
-        LogError("Failed to get the Lock.");
-        result = NULL;
-    }
-    else
-    {
-    if (ptr == NULL)
-    {
-        /* Codes_SRS_GBALLOC_01_017: [When ptr is NULL, gballoc_realloc shall call the underlying realloc with ptr being NULL and the realloc result shall be tracked by gballoc.] */
-        allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-    }
-    else
-    {
-        curr = head;
-        while (curr != NULL)
-        {
-            if (curr->ptr == ptr)
-            {
-                allocation = curr;
-                break;
-            }
-            else
-            {
-                curr = (ALLOCATION*)curr->next;
-            }
-        }
-    }
-
-    if (allocation == NULL)
-    {
-        /* Codes_SRS_GBALLOC_01_015: [When allocating memory used for tracking by gballoc_realloc fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
-        /* Codes_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
+        /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
+        LogError("Failed to get the Lock.");
         result = NULL;
     }
     else
     {
-        result = realloc(ptr, size);
-        if (result == NULL)
+        /* unlike malloc and free, the underlying realloc is called under the lock: the old block has to stay tracked
+        until the underlying realloc says whether it was released, or another thread could get its address and track it first */
+        if (ptr == NULL)
         {
-            /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
-            if (ptr == NULL)
+            /* Codes_SRS_GBALLOC_99_002: [Before tracking a new block gballoc shall make sure the tracking table is at most half full, allocating it on first use and doubling its size when needed.] */
+            if (reserve_allocation() != 0)
+            {
+                /* Codes_SRS_GBALLOC_01_015: [When allocating memory used for tracking by gballoc_realloc fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+                result = NULL;
+            }
+            else
             {
-                free(allocation);
+                /* Codes_SRS_GBALLOC_01_017: [When ptr is NULL, gballoc_realloc shall call the underlying realloc with ptr being NULL and the realloc result shall be tracked by gballoc.] */
+                result = gballoc_allocatorRealloc(NULL, size);
+                /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+                if (result != NULL)
+                {
+                    /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
+                    track_allocation(result, size, site);
+                }
             }
         }
         else
         {
-            if (ptr != NULL)
+            /* Codes_SRS_GBALLOC_99_001: [gballoc shall look up tracked blocks in a hash table indexed by the block address.] */
+            ALLOCATION* allocation = find_allocation(ptr);
+            if (allocation == NULL)
             {
-                /* Codes_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
-                allocation->ptr = result;
-                totalSize -= allocation->size;
-                allocation->size = size;
+                /* Codes_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
+                LogError("Could not reallocate allocation for address %p (not found)", ptr);
+                result = NULL;
             }
             else
             {
-                /* add block */
-                allocation->ptr = result;
-                allocation->size = size;
-                allocation->next = head;
-                head = allocation;
-            }
-
-            /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
-            totalSize += size;
-            g_allocations++;
+                /* Codes_SRS_GBALLOC_01_005: [gballoc_realloc shall call the C99 realloc function and return its result.] */
+                result = gballoc_allocatorRealloc(ptr, size);
+                /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+                if (result != NULL)
+                {
+                    /* Codes_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
+                    totalSize -= allocation->size;
+                    untrack_site(allocation);
+                    remove_allocation(allocation);
 
-            /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-            if (maxSize < totalSize)
-            {
-                maxSize = totalSize;
+                    /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
+                    track_allocation(result, size, site);
+                }
             }
         }
-        }
 
         (void)Unlock(gballocThreadSafeLock);
     }
@@ -284,13 +653,10 @@ void* gballoc_realloc(void* ptr, size_t size)
 
 void gballoc_free(void* ptr)
 {
-    ALLOCATION* curr = head;
-    ALLOCATION* prev = NULL;
-
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_042: [If gballoc was not initialized gballoc_free shall shall simply call free.] */
-        free(ptr);
+        gballoc_allocatorFree(ptr);
     }
     /* Codes_SRS_GBALLOC_01_033: [gballoc_free shall ensure thread safety by using the lock created by gballoc_Init.] */
     else if (LOCK_OK != Lock(gballocThreadSafeLock))
@@ -300,39 +666,36 @@ void gballoc_free(void* ptr)
     }
     else
     {
-    /* Codes_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
-    while (curr != NULL)
-    {
-        if (curr->ptr == ptr)
+        bool tracked;
+
+        /* Codes_SRS_GBALLOC_99_001: [gballoc shall look up tracked blocks in a hash table indexed by the block address.] */
+        ALLOCATION* allocation = find_allocation(ptr);
+        if (allocation != NULL)
         {
-            /* Codes_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
-            free(ptr);
-            totalSize -= curr->size;
-            if (prev != NULL)
-            {
-                prev->next = curr->next;
-            }
-            else
+            /* Codes_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
+            totalSize -= allocation->size;
+            untrack_site(allocation);
+            remove_allocation(allocation);
+            tracked = true;
+        }
+        else
+        {
+            if (ptr != NULL)
             {
-                head = (ALLOCATION*)curr->next;
+                /* Codes_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
+                LogError("Could not free allocation for address %p (not found)", ptr);
             }
-
-            free(curr);
-            break;
+            tracked = false;
         }
 
-        prev = curr;
-        curr = (ALLOCATION*)curr->next;
-    }
-
-        if ((curr == NULL) && (ptr != NULL))
-    {
-        /* Codes_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
-
-        /* could not find the allocation */
-        LogError("Could not free allocation for address %p (not found)", ptr);
-    }
         (void)Unlock(gballocThreadSafeLock);
+
+        if (tracked)
+        {
+            /* Codes_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
+            /* Codes_SRS_GBALLOC_99_041: [gballoc_free shall call the underlying free after releasing the lock, once the block is no longer tracked.] */
+            gballoc_allocatorFree(ptr);
+        }
     }
 }
 
@@ -439,3 +802,417 @@ void gballoc_resetMetrics()
         (void)Unlock(gballocThreadSafeLock);
     }
 }
+
+int gballoc_startSiteProfiling(void)
+{
+    int result;
+
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        /* Codes_SRS_GBALLOC_99_007: [If gballoc was not initialized gballoc_startSiteProfiling shall fail and return a non-zero value.] */
+        LogError("gballoc is not initialized.");
+        result = __FAILURE__;
+    }
+    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    {
+        /* Codes_SRS_GBALLOC_99_008: [If the lock cannot be acquired, gballoc_startSiteProfiling shall fail and return a non-zero value.] */
+        LogError("Failed to get the Lock.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_99_009: [gballoc_startSiteProfiling shall discard the sites recorded so far, start recording allocation sites and return 0.] */
+        clear_sites();
+        siteProfiling = true;
+        siteProfilingStart = time(NULL);
+        (void)Unlock(gballocThreadSafeLock);
+        result = 0;
+    }
+
+    return result;
+}
+
+void gballoc_stopSiteProfiling(void)
+{
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        /* Codes_SRS_GBALLOC_99_014: [If gballoc was not initialized gballoc_stopSiteProfiling shall do nothing.] */
+        LogError("gballoc is not initialized.");
+    }
+    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    {
+        LogError("Failed to get the Lock.");
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_99_013: [gballoc_stopSiteProfiling shall stop recording allocation sites and free the site table.] */
+        siteProfiling = false;
+        clear_sites();
+        (void)Unlock(gballocThreadSafeLock);
+    }
+}
+
+static int compare_sites(const void* left, const void* right)
+{
+    const ALLOCATION_SITE* leftSite = *(const ALLOCATION_SITE* const*)left;
+    const ALLOCATION_SITE* rightSite = *(const ALLOCATION_SITE* const*)right;
+    int result;
+
+    if (leftSite->live_bytes != rightSite->live_bytes)
+    {
+        result = (leftSite->live_bytes > rightSite->live_bytes) ? -1 : 1;
+    }
+    else if (leftSite->allocated_bytes != rightSite->allocated_bytes)
+    {
+        result = (leftSite->allocated_bytes > rightSite->allocated_bytes) ? -1 : 1;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static void write_site_report(FILE* destination, ALLOCATION_SITE** sorted, const ALLOCATION_SITE* total)
+{
+    size_t i;
+    double seconds = difftime(time(NULL), siteProfilingStart);
+
+    if (seconds < 1)
+    {
+        seconds = 1;
+    }
+
+    (void)fprintf(destination, "gballoc allocation sites: %llu live bytes in %llu blocks, %llu allocations of %llu bytes in %.0f s\n",
+        (unsigned long long)total->live_bytes, (unsigned long long)total->live_count,
+        (unsigned long long)total->allocation_count, (unsigned long long)total->allocated_bytes, seconds);
+    (void)fprintf(destination, "  live bytes  live blocks  allocations  allocated bytes  allocations/s  site\n");
+
+    for (i = 0; i < sitesCount; i++)
+    {
+        (void)fprintf(destination, "%12llu %12llu %12llu %16llu %14.1f  0x%llx\n",
+            (unsigned long long)sorted[i]->live_bytes, (unsigned long long)sorted[i]->live_count,
+            (unsigned long long)sorted[i]->allocation_count, (unsigned long long)sorted[i]->allocated_bytes,
+            (double)sorted[i]->allocation_count / seconds, (unsigned long long)(uintptr_t)sorted[i]->site);
+    }
+}
+
+/* the legacy heap profile format read by pprof, the sites are return addresses which is what pprof expects */
+static void write_heap_profile(FILE* destination, ALLOCATION_SITE** sorted, const ALLOCATION_SITE* total)
+{
+    size_t i;
+
+    (void)fprintf(destination, "heap profile: %llu: %llu [%llu: %llu] @ heapprofile\n",
+        (unsigned long long)total->live_count, (unsigned long long)total->live_bytes,
+        (unsigned long long)total->allocation_count, (unsigned long long)total->allocated_bytes);
+
+    for (i = 0; i < sitesCount; i++)
+    {
+        (void)fprintf(destination, "%llu: %llu [%llu: %llu] @ 0x%llx\n",
+            (unsigned long long)sorted[i]->live_count, (unsigned long long)sorted[i]->live_bytes,
+            (unsigned long long)sorted[i]->allocation_count, (unsigned long long)sorted[i]->allocated_bytes,
+            (unsigned long long)(uintptr_t)sorted[i]->site);
+    }
+
+#if defined(__linux__)
+    {
+        /* pprof needs the mappings to symbolize the addresses of a position independent executable */
+        FILE* maps = fopen("/proc/self/maps", "r");
+        if (maps != NULL)
+        {
+            char buffer[512];
+            size_t bytesRead;
+
+            (void)fprintf(destination, "\nMAPPED_LIBRARIES:\n");
+            while ((bytesRead = fread(buffer, 1, sizeof(buffer), maps)) > 0)
+            {
+                (void)fwrite(buffer, 1, bytesRead, destination);
+            }
+            (void)fclose(maps);
+        }
+    }
+#endif
+}
+
+static int dump_sites(FILE* destination, bool heapProfile)
+{
+    int result;
+
+    if (destination == NULL)
+    {
+        /* Codes_SRS_GBALLOC_99_015: [If destination is NULL, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+        LogError("Invalid argument: destination = %p", destination);
+        result = __FAILURE__;
+    }
+    else if (gballocState != GBALLOC_STATE_INIT)
+    {
+        /* Codes_SRS_GBALLOC_99_016: [If gballoc was not initialized or site profiling is not on, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+        LogError("gballoc is not initialized.");
+        result = __FAILURE__;
+    }
+    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    {
+        /* Codes_SRS_GBALLOC_99_017: [If the lock cannot be acquired, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+        LogError("Failed to get the Lock.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        ALLOCATION_SITE** sorted;
+
+        if (!siteProfiling)
+        {
+            /* Codes_SRS_GBALLOC_99_016: [If gballoc was not initialized or site profiling is not on, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+            LogError("Site profiling is not on.");
+            result = __FAILURE__;
+        }
+        else if ((sorted = (ALLOCATION_SITE**)malloc((sitesCount + 1) * sizeof(ALLOCATION_SITE*))) == NULL)
+        {
+            /* Codes_SRS_GBALLOC_99_020: [If the memory needed to sort the sites cannot be allocated, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+            LogError("Cannot allocate the sorted site list.");
+            result = __FAILURE__;
+        }
+        else
+        {
+            ALLOCATION_SITE total;
+            size_t i;
+            size_t count = 0;
+
+            (void)memset(&total, 0, sizeof(total));
+            for (i = 0; i < sitesCapacity; i++)
+            {
+                if (sites[i].site != NULL)
+                {
+                    sorted[count++] = &sites[i];
+                    total.live_bytes += sites[i].live_bytes;
+                    total.live_count += sites[i].live_count;
+                    total.allocation_count += sites[i].allocation_count;
+                    total.allocated_bytes += sites[i].allocated_bytes;
+                }
+            }
+            qsort(sorted, count, sizeof(ALLOCATION_SITE*), compare_sites);
+
+            if (heapProfile)
+            {
+                /* Codes_SRS_GBALLOC_99_019: [gballoc_dumpHeapProfile shall write the sites to destination in the legacy heap profile format read by pprof, followed on Linux by the memory mappings of the process, and return 0.] */
+                write_heap_profile(destination, sorted, &total);
+            }
+            else
+            {
+                /* Codes_SRS_GBALLOC_99_018: [gballoc_dumpSiteReport shall write to destination the totals and, for every site sorted by live bytes, its live bytes, live blocks, allocations, allocated bytes, allocations per second and code address, and return 0.] */
+                write_site_report(destination, sorted, &total);
+            }
+
+            free(sorted);
+            result = 0;
+        }
+
+        (void)Unlock(gballocThreadSafeLock);
+    }
+
+    return result;
+}
+
+int gballoc_dumpSiteReport(FILE* destination)
+{
+    return dump_sites(destination, false);
+}
+
+int gballoc_dumpHeapProfile(FILE* destination)
+{
+    return dump_sites(destination, true);
+}
+
+static void* default_malloc(void* context, size_t size)
+{
+    (void)context;
+    return GBALLOC_DEFAULT_MALLOC(size);
+}
+
+static void* default_calloc(void* context, size_t nmemb, size_t size)
+{
+    (void)context;
+    return GBALLOC_DEFAULT_CALLOC(nmemb, size);
+}
+
+static void* default_realloc(void* context, void* ptr, size_t size)
+{
+    (void)context;
+    return GBALLOC_DEFAULT_REALLOC(ptr, size);
+}
+
+static void default_free(void* context, void* ptr)
+{
+    (void)context;
+    GBALLOC_DEFAULT_FREE(ptr);
+}
+
+static const GBALLOC_ALLOCATOR defaultAllocator =
+{
+    default_malloc,
+    default_realloc,
+    default_free,
+    default_calloc,
+    NULL,
+    NULL,
+    NULL
+};
+
+/* not guarded by the lock: the allocator is meant to be installed once, before the library allocates anything */
+static GBALLOC_ALLOCATOR gballocAllocator =
+{
+    default_malloc,
+    default_realloc,
+    default_free,
+    default_calloc,
+    NULL,
+    NULL,
+    NULL
+};
+
+int gballoc_setAllocator(const GBALLOC_ALLOCATOR* allocator)
+{
+    int result;
+
+    if (allocator == NULL)
+    {
+        /* Codes_SRS_GBALLOC_99_022: [If allocator is NULL, gballoc_setAllocator shall install the default allocator, which calls the C99 malloc, calloc, realloc and free, or the gballoc_pool functions when built with GB_USE_POOL, and return 0.] */
+        gballocAllocator = defaultAllocator;
+        result = 0;
+    }
+    else if ((allocator->malloc_function == NULL) ||
+        (allocator->realloc_function == NULL) ||
+        (allocator->free_function == NULL) ||
+        ((allocator->aligned_malloc_function == NULL) != (allocator->aligned_free_function == NULL)))
+    {
+        /* Codes_SRS_GBALLOC_99_023: [If malloc_function, realloc_function or free_function is NULL, or only one of aligned_malloc_function and aligned_free_function is NULL, gballoc_setAllocator shall fail, keep the installed allocator and return a non-zero value.] */
+        LogError("Invalid allocator: malloc_function, realloc_function and free_function are required, aligned_malloc_function and aligned_free_function go together");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_99_024: [Otherwise gballoc_setAllocator shall copy allocator, use it for every later allocation and return 0.] */
+        gballocAllocator = *allocator;
+        result = 0;
+    }
+
+    return result;
+}
+
+void gballoc_getAllocator(GBALLOC_ALLOCATOR* allocator)
+{
+    /* Codes_SRS_GBALLOC_99_025: [If allocator is NULL, gballoc_getAllocator shall do nothing.] */
+    if (allocator != NULL)
+    {
+        /* Codes_SRS_GBALLOC_99_026: [gballoc_getAllocator shall copy the installed allocator to allocator.] */
+        *allocator = gballocAllocator;
+    }
+}
+
+void* gballoc_allocatorMalloc(size_t size)
+{
+    /* Codes_SRS_GBALLOC_99_027: [gballoc_allocatorMalloc, gballoc_allocatorRealloc and gballoc_allocatorFree shall call the malloc_function, realloc_function and free_function of the installed allocator with its context.] */
+    return gballocAllocator.malloc_function(gballocAllocator.context, size);
+}
+
+void* gballoc_allocatorCalloc(size_t nmemb, size_t size)
+{
+    void* result;
+
+    if (gballocAllocator.calloc_function != NULL)
+    {
+        /* Codes_SRS_GBALLOC_99_028: [gballoc_allocatorCalloc shall call the calloc_function of the installed allocator with its context.] */
+        result = gballocAllocator.calloc_function(gballocAllocator.context, nmemb, size);
+    }
+    else if ((size != 0) && (nmemb > SIZE_MAX / size))
+    {
+        /* Codes_SRS_GBALLOC_99_030: [If nmemb * size overflows, gballoc_allocatorCalloc shall return NULL.] */
+        LogError("Invalid calloc size: nmemb=%u, size=%u", (unsigned int)nmemb, (unsigned int)size);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_99_029: [If the installed allocator has no calloc_function, gballoc_allocatorCalloc shall get nmemb * size bytes from its malloc_function and set them to 0.] */
+        result = gballocAllocator.malloc_function(gballocAllocator.context, nmemb * size);
+        if (result != NULL)
+        {
+            (void)memset(result, 0, nmemb * size);
+        }
+    }
+
+    return result;
+}
+
+void* gballoc_allocatorRealloc(void* ptr, size_t size)
+{
+    return gballocAllocator.realloc_function(gballocAllocator.context, ptr, size);
+}
+
+void gballoc_allocatorFree(void* ptr)
+{
+    gballocAllocator.free_function(gballocAllocator.context, ptr);
+}
+
+void* gballoc_allocatorAlignedMalloc(size_t alignment, size_t size)
+{
+    void* result;
+
+    if ((alignment == 0) || ((alignment & (alignment - 1)) != 0))
+    {
+        /* Codes_SRS_GBALLOC_99_031: [If alignment is not a power of 2, gballoc_allocatorAlignedMalloc shall return NULL.] */
+        LogError("Invalid alignment %u", (unsigned int)alignment);
+        result = NULL;
+    }
+    else if (gballocAllocator.aligned_malloc_function != NULL)
+    {
+        /* Codes_SRS_GBALLOC_99_032: [gballoc_allocatorAlignedMalloc shall call the aligned_malloc_function of the installed allocator with its context.] */
+        result = gballocAllocator.aligned_malloc_function(gballocAllocator.context, alignment, size);
+    }
+    else
+    {
+        /* the block that was really allocated is remembered just below the aligned one */
+        if (alignment < sizeof(void*))
+        {
+            alignment = sizeof(void*);
+        }
+
+        if (size > SIZE_MAX - alignment - sizeof(void*))
+        {
+            /* Codes_SRS_GBALLOC_99_034: [If size is too large, gballoc_allocatorAlignedMalloc shall return NULL.] */
+            LogError("Invalid aligned allocation size %u", (unsigned int)size);
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_GBALLOC_99_033: [If the installed allocator has no aligned_malloc_function, gballoc_allocatorAlignedMalloc shall get size + alignment + sizeof(void*) bytes from its malloc_function and return the first address in them that is aligned and leaves room for a pointer before it.] */
+            unsigned char* block = (unsigned char*)gballocAllocator.malloc_function(gballocAllocator.context, size + alignment + sizeof(void*));
+            if (block == NULL)
+            {
+                result = NULL;
+            }
+            else
+            {
+                uintptr_t aligned = ((uintptr_t)(block + sizeof(void*)) + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+                ((void**)aligned)[-1] = block;
+                result = (void*)aligned;
+            }
+        }
+    }
+
+    return result;
+}
+
+void gballoc_allocatorAlignedFree(void* ptr)
+{
+    if (gballocAllocator.aligned_free_function != NULL)
+    {
+        /* Codes_SRS_GBALLOC_99_035: [gballoc_allocatorAlignedFree shall call the aligned_free_function of the installed allocator with its context.] */
+        gballocAllocator.aligned_free_function(gballocAllocator.context, ptr);
+    }
+    /* Codes_SRS_GBALLOC_99_036: [If the installed allocator has no aligned_free_function, gballoc_allocatorAlignedFree shall do nothing when ptr is NULL and otherwise give the block that was really allocated back to its free_function.] */
+    else if (ptr != NULL)
+    {
+        gballocAllocator.free_function(gballocAllocator.context, ((void**)ptr)[-1]);
+    }
+}
@@ -0,0 +1,780 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+#include "azure_c_shared_utility/gballoc_pool.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+/* the thread caches live in thread local storage and go back to the shared free lists when their thread exits, from
+a fiber local storage callback on Windows and from a pthread key destructor elsewhere; without both every block comes
+from the shared free lists */
+#if defined(_WIN32)
+#include "windows.h"
+#if defined(_MSC_VER)
+#define GBALLOC_POOL_THREAD_LOCAL   __declspec(thread)
+#else
+#define GBALLOC_POOL_THREAD_LOCAL   __thread
+#endif
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__linux__) || defined(__APPLE__))
+#include <pthread.h>
+#define GBALLOC_POOL_THREAD_LOCAL   __thread
+#endif
+
+/* keeps the returned memory aligned the way malloc aligns it */
+#define GBALLOC_POOL_HEADER_SIZE    16
+#define GBALLOC_POOL_SLAB_SIZE      16384
+#define GBALLOC_POOL_MAX_SIZE       256
+/* blocks a thread keeps per class, and how many it moves at once from or to the shared free list */
+#define GBALLOC_POOL_CACHE_SIZE     32
+#define GBALLOC_POOL_BATCH_SIZE     (GBALLOC_POOL_CACHE_SIZE / 2)
+/* class index of the blocks that come straight from malloc */
+#define GBALLOC_POOL_LARGE          ((size_t)GBALLOC_POOL_CLASS_COUNT)
+
+typedef struct GBALLOC_POOL_HEADER_TAG
+{
+    size_t class_index;
+    size_t requested_size;
+} GBALLOC_POOL_HEADER;
+
+typedef struct GBALLOC_POOL_SLAB_TAG
+{
+    struct GBALLOC_POOL_SLAB_TAG* next;
+} GBALLOC_POOL_SLAB;
+
+typedef struct GBALLOC_POOL_CLASS_TAG
+{
+    GBALLOC_POOL_HEADER* free_list;
+    GBALLOC_POOL_SLAB* slabs;
+    size_t slab_count;
+    size_t block_count;
+    size_t free_count;
+    /* blocks held by thread caches, as last reported by them */
+    size_t cached_count;
+    size_t requested_bytes;
+    size_t allocation_count;
+} GBALLOC_POOL_CLASS;
+
+typedef enum GBALLOC_POOL_STATE_TAG
+{
+    GBALLOC_POOL_STATE_INIT,
+    GBALLOC_POOL_STATE_NOT_INIT
+} GBALLOC_POOL_STATE;
+
+static const size_t pool_class_sizes[GBALLOC_POOL_CLASS_COUNT] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+/* class serving a request of size bytes, indexed by (size + 15) / 16 */
+static const unsigned char pool_class_of[GBALLOC_POOL_MAX_SIZE / 16 + 1] = { 0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7 };
+
+static GBALLOC_POOL_CLASS pool_classes[GBALLOC_POOL_CLASS_COUNT];
+static size_t pool_large_allocation_count = 0;
+static GBALLOC_POOL_STATE poolState = GBALLOC_POOL_STATE_NOT_INIT;
+static LOCK_HANDLE poolLock = NULL;
+
+/* a free block keeps the next free block of its class in its payload */
+static GBALLOC_POOL_HEADER** next_free_block(GBALLOC_POOL_HEADER* header)
+{
+    return (GBALLOC_POOL_HEADER**)((unsigned char*)header + GBALLOC_POOL_HEADER_SIZE);
+}
+
+static void push_free_block(GBALLOC_POOL_CLASS* pool_class, GBALLOC_POOL_HEADER* header)
+{
+    *next_free_block(header) = pool_class->free_list;
+    pool_class->free_list = header;
+    pool_class->free_count++;
+}
+
+static GBALLOC_POOL_HEADER* pop_free_block(GBALLOC_POOL_CLASS* pool_class)
+{
+    GBALLOC_POOL_HEADER* result = pool_class->free_list;
+    pool_class->free_list = *next_free_block(result);
+    pool_class->free_count--;
+    return result;
+}
+
+/* carves a new slab into free blocks of the class, called with the lock held */
+static int add_slab(size_t class_index)
+{
+    int result;
+    GBALLOC_POOL_SLAB* slab = (GBALLOC_POOL_SLAB*)malloc(GBALLOC_POOL_SLAB_SIZE);
+
+    if (slab == NULL)
+    {
+        LogError("Cannot allocate a slab for the %u bytes class", (unsigned int)pool_class_sizes[class_index]);
+        result = __FAILURE__;
+    }
+    else
+    {
+        GBALLOC_POOL_CLASS* pool_class = &pool_classes[class_index];
+        size_t block_size = GBALLOC_POOL_HEADER_SIZE + pool_class_sizes[class_index];
+        /* the slab link takes a header worth of room at the start of the slab, so that the blocks stay aligned */
+        size_t block_count = (GBALLOC_POOL_SLAB_SIZE - GBALLOC_POOL_HEADER_SIZE) / block_size;
+        size_t i;
+
+        slab->next = pool_class->slabs;
+        pool_class->slabs = slab;
+        pool_class->slab_count++;
+
+        /* pushed from the end, so that the blocks at the start of the slab are handed out first */
+        for (i = block_count; i > 0; i--)
+        {
+            push_free_block(pool_class, (GBALLOC_POOL_HEADER*)((unsigned char*)slab + GBALLOC_POOL_HEADER_SIZE + (i - 1) * block_size));
+        }
+        pool_class->block_count += block_count;
+
+        result = 0;
+    }
+
+    return result;
+}
+
+/* Thread caches are allocated on the first pooled allocation of a thread and chained together, so that
+gballoc_pool_deinit can give back the blocks held by the threads still running; a thread that exits unlinks its own */
+typedef struct GBALLOC_POOL_CACHE_TAG
+{
+    struct GBALLOC_POOL_CACHE_TAG* next;
+    struct GBALLOC_POOL_CACHE_TAG* previous;
+    GBALLOC_POOL_HEADER* blocks[GBALLOC_POOL_CLASS_COUNT][GBALLOC_POOL_CACHE_SIZE];
+    size_t count[GBALLOC_POOL_CLASS_COUNT];
+    size_t reported_count[GBALLOC_POOL_CLASS_COUNT];
+    /* activity not reported to the shared statistics yet */
+    size_t requested_bytes[GBALLOC_POOL_CLASS_COUNT];
+    size_t allocation_count[GBALLOC_POOL_CLASS_COUNT];
+    size_t large_allocation_count;
+} GBALLOC_POOL_CACHE;
+
+static GBALLOC_POOL_CACHE* poolCaches = NULL;
+/* bumped by every gballoc_pool_init, tells a thread that the cache it points to was freed by gballoc_pool_deinit */
+static size_t poolGeneration = 0;
+
+#ifdef GBALLOC_POOL_THREAD_LOCAL
+static GBALLOC_POOL_THREAD_LOCAL GBALLOC_POOL_CACHE* pool_cache = NULL;
+static GBALLOC_POOL_THREAD_LOCAL size_t pool_cache_generation = 0;
+
+/* created once and never deleted, its callback runs on the exit of every thread that set it */
+#if defined(_WIN32)
+static DWORD poolCacheKey = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t poolCacheKey;
+#endif
+static bool poolCacheKeyCreated = false;
+#endif
+
+/* returns NULL when the calling thread cannot have a cache, the shared free lists are used directly then */
+static GBALLOC_POOL_CACHE* get_cache(void)
+{
+    GBALLOC_POOL_CACHE* result;
+#ifdef GBALLOC_POOL_THREAD_LOCAL
+    if (pool_cache_generation == poolGeneration)
+    {
+        result = pool_cache;
+    }
+    else if (!poolCacheKeyCreated)
+    {
+        /* without a thread exit callback the blocks cached by an exiting thread would be stranded */
+        result = NULL;
+    }
+    else if ((result = (GBALLOC_POOL_CACHE*)malloc(sizeof(GBALLOC_POOL_CACHE))) == NULL)
+    {
+        LogError("Cannot allocate the thread cache");
+    }
+    else if (Lock(poolLock) != LOCK_OK)
+    {
+        LogError("Failed to get the Lock.");
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        (void)memset(result, 0, sizeof(GBALLOC_POOL_CACHE));
+        result->next = poolCaches;
+        if (poolCaches != NULL)
+        {
+            poolCaches->previous = result;
+        }
+        poolCaches = result;
+        (void)Unlock(poolLock);
+
+        pool_cache = result;
+        pool_cache_generation = poolGeneration;
+
+#if defined(_WIN32)
+        if (!FlsSetValue(poolCacheKey, result))
+#else
+        if (pthread_setspecific(poolCacheKey, result) != 0)
+#endif
+        {
+            LogError("Cannot register the thread cache, its blocks are only given back by gballoc_pool_deinit");
+        }
+    }
+#else
+    result = NULL;
+#endif
+    return result;
+}
+
+/* called with the lock held */
+static void report_cache(GBALLOC_POOL_CACHE* cache, size_t class_index)
+{
+    GBALLOC_POOL_CLASS* pool_class = &pool_classes[class_index];
+
+    pool_class->cached_count += cache->count[class_index] - cache->reported_count[class_index];
+    cache->reported_count[class_index] = cache->count[class_index];
+    pool_class->requested_bytes += cache->requested_bytes[class_index];
+    cache->requested_bytes[class_index] = 0;
+    pool_class->allocation_count += cache->allocation_count[class_index];
+    cache->allocation_count[class_index] = 0;
+
+    pool_large_allocation_count += cache->large_allocation_count;
+    cache->large_allocation_count = 0;
+}
+
+/* called with the lock held */
+static void drain_cache(GBALLOC_POOL_CACHE* cache, size_t class_index, size_t keep_count)
+{
+    while (cache->count[class_index] > keep_count)
+    {
+        push_free_block(&pool_classes[class_index], cache->blocks[class_index][--cache->count[class_index]]);
+    }
+
+    report_cache(cache, class_index);
+}
+
+#ifdef GBALLOC_POOL_THREAD_LOCAL
+/* runs on the exiting thread, whose thread local variables are still there */
+static void release_cache(GBALLOC_POOL_CACHE* cache)
+{
+    /* a cache of an earlier generation was already freed by gballoc_pool_deinit */
+    if ((cache != NULL) && (cache == pool_cache) && (pool_cache_generation == poolGeneration) && (poolState == GBALLOC_POOL_STATE_INIT))
+    {
+        if (Lock(poolLock) != LOCK_OK)
+        {
+            LogError("Failed to get the Lock, the blocks cached by the exiting thread are only given back by gballoc_pool_deinit");
+        }
+        else
+        {
+            size_t i;
+
+            for (i = 0; i < GBALLOC_POOL_CLASS_COUNT; i++)
+            {
+                drain_cache(cache, i, 0);
+            }
+
+            if (cache->previous == NULL)
+            {
+                poolCaches = cache->next;
+            }
+            else
+            {
+                cache->previous->next = cache->next;
+            }
+            if (cache->next != NULL)
+            {
+                cache->next->previous = cache->previous;
+            }
+            (void)Unlock(poolLock);
+
+            free(cache);
+            pool_cache = NULL;
+            pool_cache_generation = 0;
+        }
+    }
+}
+
+#if defined(_WIN32)
+static VOID WINAPI on_thread_exit(PVOID value)
+#else
+static void on_thread_exit(void* value)
+#endif
+{
+    release_cache((GBALLOC_POOL_CACHE*)value);
+}
+#endif
+
+static GBALLOC_POOL_HEADER* take_block(size_t class_index, size_t size)
+{
+    GBALLOC_POOL_HEADER* result;
+    GBALLOC_POOL_CACHE* cache = get_cache();
+
+    if ((cache != NULL) && (cache->count[class_index] > 0))
+    {
+        result = cache->blocks[class_index][--cache->count[class_index]];
+        cache->requested_bytes[class_index] += size;
+        cache->allocation_count[class_index]++;
+    }
+    else if (Lock(poolLock) != LOCK_OK)
+    {
+        LogError("Failed to get the Lock.");
+        result = NULL;
+    }
+    else
+    {
+        GBALLOC_POOL_CLASS* pool_class = &pool_classes[class_index];
+
+        if ((pool_class->free_list == NULL) && (add_slab(class_index) != 0))
+        {
+            result = NULL;
+        }
+        else
+        {
+            result = pop_free_block(pool_class);
+            pool_class->requested_bytes += size;
+            pool_class->allocation_count++;
+
+            if (cache != NULL)
+            {
+                /* take a batch while holding the lock anyway */
+                while ((cache->count[class_index] < GBALLOC_POOL_BATCH_SIZE) && (pool_class->free_list != NULL))
+                {
+                    cache->blocks[class_index][cache->count[class_index]++] = pop_free_block(pool_class);
+                }
+                report_cache(cache, class_index);
+            }
+        }
+
+        (void)Unlock(poolLock);
+    }
+
+    if (result != NULL)
+    {
+        result->class_index = class_index;
+        result->requested_size = size;
+    }
+
+    return result;
+}
+
+static void give_block(GBALLOC_POOL_HEADER* header)
+{
+    size_t class_index = header->class_index;
+    GBALLOC_POOL_CACHE* cache = get_cache();
+
+    if ((cache != NULL) && (cache->count[class_index] < GBALLOC_POOL_CACHE_SIZE))
+    {
+        cache->blocks[class_index][cache->count[class_index]++] = header;
+        cache->requested_bytes[class_index] -= header->requested_size;
+    }
+    else if (Lock(poolLock) != LOCK_OK)
+    {
+        LogError("Failed to get the Lock, a block of the %u bytes class is lost", (unsigned int)pool_class_sizes[class_index]);
+    }
+    else
+    {
+        push_free_block(&pool_classes[class_index], header);
+        pool_classes[class_index].requested_bytes -= header->requested_size;
+
+        if (cache != NULL)
+        {
+            /* the cache is full, keep half of it for the next allocations */
+            drain_cache(cache, class_index, GBALLOC_POOL_BATCH_SIZE);
+        }
+
+        (void)Unlock(poolLock);
+    }
+}
+
+static void count_large_allocation(void)
+{
+    if (poolState == GBALLOC_POOL_STATE_INIT)
+    {
+        GBALLOC_POOL_CACHE* cache = get_cache();
+
+        if (cache != NULL)
+        {
+            cache->large_allocation_count++;
+        }
+        else if (Lock(poolLock) == LOCK_OK)
+        {
+            pool_large_allocation_count++;
+            (void)Unlock(poolLock);
+        }
+    }
+}
+
+/* called with the lock held, or from gballoc_pool_deinit */
+static void release_unused_slabs(size_t class_index)
+{
+    GBALLOC_POOL_CLASS* pool_class = &pool_classes[class_index];
+
+    if ((pool_class->slabs != NULL) && (pool_class->free_count == pool_class->block_count))
+    {
+        while (pool_class->slabs != NULL)
+        {
+            GBALLOC_POOL_SLAB* slab = pool_class->slabs;
+            pool_class->slabs = slab->next;
+            free(slab);
+        }
+
+        (void)memset(pool_class, 0, sizeof(GBALLOC_POOL_CLASS));
+    }
+}
+
+int gballoc_pool_init(void)
+{
+    int result;
+
+    if (poolState != GBALLOC_POOL_STATE_NOT_INIT)
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_002: [ If the pool is already initialized, gballoc_pool_init shall fail and return a non-zero value. ]*/
+        LogError("gballoc_pool is already initialized.");
+        result = __FAILURE__;
+    }
+    /* Codes_SRS_GBALLOC_POOL_99_025: [ If gballoc_pool_deinit kept the lock for the slabs still in use, gballoc_pool_init shall use that lock. ]*/
+    else if ((poolLock == NULL) && ((poolLock = Lock_Init()) == NULL))
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_003: [ If creating the lock fails, gballoc_pool_init shall fail and return a non-zero value. ]*/
+        LogError("Failed to create the lock.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t i;
+
+        /* Codes_SRS_GBALLOC_POOL_99_001: [ gballoc_pool_init shall create the lock protecting the shared free lists, reset the statistics and return 0. ]*/
+        /* Codes_SRS_GBALLOC_POOL_99_026: [ The slabs kept by gballoc_pool_deinit shall stay in their classes, so that their free blocks are reused. ]*/
+        for (i = 0; i < GBALLOC_POOL_CLASS_COUNT; i++)
+        {
+            pool_classes[i].allocation_count = 0;
+        }
+        pool_large_allocation_count = 0;
+
+#ifdef GBALLOC_POOL_THREAD_LOCAL
+        if (!poolCacheKeyCreated)
+        {
+            /* Codes_SRS_GBALLOC_POOL_99_029: [ When a thread exits, the blocks held by its cache shall go back to the shared free lists and the cache shall be freed. ]*/
+#if defined(_WIN32)
+            poolCacheKeyCreated = ((poolCacheKey = FlsAlloc(on_thread_exit)) != FLS_OUT_OF_INDEXES);
+#else
+            poolCacheKeyCreated = (pthread_key_create(&poolCacheKey, on_thread_exit) == 0);
+#endif
+            if (!poolCacheKeyCreated)
+            {
+                /* Codes_SRS_GBALLOC_POOL_99_030: [ If the thread exit callback cannot be set up, the threads shall not have caches and shall use the shared free lists. ]*/
+                LogError("Cannot set up the thread exit callback, the thread caches are disabled");
+            }
+        }
+#endif
+
+        poolGeneration++;
+        poolState = GBALLOC_POOL_STATE_INIT;
+        result = 0;
+    }
+
+    return result;
+}
+
+void gballoc_pool_deinit(void)
+{
+    if (poolState == GBALLOC_POOL_STATE_INIT)
+    {
+        size_t i;
+        bool keptSlabs;
+
+        /* Codes_SRS_GBALLOC_POOL_99_004: [ gballoc_pool_deinit shall give the blocks held by every thread cache back to the shared free lists and free the caches. ]*/
+        while (poolCaches != NULL)
+        {
+            GBALLOC_POOL_CACHE* cache = poolCaches;
+            poolCaches = cache->next;
+
+            for (i = 0; i < GBALLOC_POOL_CLASS_COUNT; i++)
+            {
+                drain_cache(cache, i, 0);
+            }
+            free(cache);
+        }
+
+        keptSlabs = false;
+        for (i = 0; i < GBALLOC_POOL_CLASS_COUNT; i++)
+        {
+            GBALLOC_POOL_CLASS* pool_class = &pool_classes[i];
+
+            /* Codes_SRS_GBALLOC_POOL_99_005: [ gballoc_pool_deinit shall free the slabs of every class whose blocks have all been given back. ]*/
+            release_unused_slabs(i);
+
+            if (pool_class->slabs != NULL)
+            {
+                /* Codes_SRS_GBALLOC_POOL_99_006: [ The slabs of a class that still has blocks in use shall be kept, so that those blocks stay valid. ]*/
+                LogError("%u blocks of the %u bytes class are still in use, their slabs are kept",
+                    (unsigned int)(pool_class->block_count - pool_class->free_count), (unsigned int)pool_class_sizes[i]);
+                keptSlabs = true;
+            }
+        }
+
+        if (!keptSlabs)
+        {
+            /* Codes_SRS_GBALLOC_POOL_99_007: [ gballoc_pool_deinit shall free the lock created by gballoc_pool_init, unless slabs were kept. ]*/
+            (void)Lock_Deinit(poolLock);
+            poolLock = NULL;
+        }
+        poolState = GBALLOC_POOL_STATE_NOT_INIT;
+    }
+}
+
+void* gballoc_pool_malloc(size_t size)
+{
+    void* result;
+    GBALLOC_POOL_HEADER* header;
+
+    if ((size <= GBALLOC_POOL_MAX_SIZE) && (poolState == GBALLOC_POOL_STATE_INIT))
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_008: [ While the pool is initialized, gballoc_pool_malloc shall serve requests of up to 256 bytes from the smallest size class that fits them, taking the block from the thread cache when it has one. ]*/
+        /* Codes_SRS_GBALLOC_POOL_99_009: [ When the class has no free block left, a new slab shall be allocated and carved into blocks of the class. ]*/
+        header = take_block(pool_class_of[(size + 15) / 16], size);
+    }
+    else if (size > SIZE_MAX - GBALLOC_POOL_HEADER_SIZE)
+    {
+        LogError("Invalid size %u", (unsigned int)size);
+        header = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_010: [ Larger requests, and every request while the pool is not initialized, shall be served by malloc with room for the block header. ]*/
+        header = (GBALLOC_POOL_HEADER*)malloc(GBALLOC_POOL_HEADER_SIZE + size);
+        if (header != NULL)
+        {
+            header->class_index = GBALLOC_POOL_LARGE;
+            header->requested_size = size;
+            count_large_allocation();
+        }
+    }
+
+    if (header == NULL)
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_011: [ If getting the memory fails, gballoc_pool_malloc shall return NULL. ]*/
+        result = NULL;
+    }
+    else
+    {
+        result = (unsigned char*)header + GBALLOC_POOL_HEADER_SIZE;
+    }
+
+    return result;
+}
+
+void* gballoc_pool_calloc(size_t nmemb, size_t size)
+{
+    void* result;
+
+    if ((size != 0) && (nmemb > SIZE_MAX / size))
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_013: [ If nmemb * size overflows, gballoc_pool_calloc shall return NULL. ]*/
+        LogError("Invalid arguments: nmemb = %u, size = %u", (unsigned int)nmemb, (unsigned int)size);
+        result = NULL;
+    }
+    /* Codes_SRS_GBALLOC_POOL_99_012: [ gballoc_pool_calloc shall allocate nmemb * size bytes like gballoc_pool_malloc and zero them. ]*/
+    else if ((result = gballoc_pool_malloc(nmemb * size)) != NULL)
+    {
+        (void)memset(result, 0, nmemb * size);
+    }
+
+    return result;
+}
+
+void* gballoc_pool_realloc(void* ptr, size_t size)
+{
+    void* result;
+
+    if (ptr == NULL)
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_014: [ If ptr is NULL, gballoc_pool_realloc shall behave like gballoc_pool_malloc. ]*/
+        result = gballoc_pool_malloc(size);
+    }
+    else
+    {
+        GBALLOC_POOL_HEADER* header = (GBALLOC_POOL_HEADER*)((unsigned char*)ptr - GBALLOC_POOL_HEADER_SIZE);
+
+        if (header->class_index == GBALLOC_POOL_LARGE)
+        {
+            /* Codes_SRS_GBALLOC_POOL_99_015: [ A block that came from malloc shall be resized with realloc. ]*/
+            GBALLOC_POOL_HEADER* new_header = (size > SIZE_MAX - GBALLOC_POOL_HEADER_SIZE) ? NULL : (GBALLOC_POOL_HEADER*)realloc(header, GBALLOC_POOL_HEADER_SIZE + size);
+            if (new_header == NULL)
+            {
+                /* Codes_SRS_GBALLOC_POOL_99_018: [ If the new memory cannot be obtained, gballoc_pool_realloc shall return NULL and leave ptr untouched. ]*/
+                LogError("Cannot reallocate %u bytes", (unsigned int)size);
+                result = NULL;
+            }
+            else
+            {
+                new_header->requested_size = size;
+                result = (unsigned char*)new_header + GBALLOC_POOL_HEADER_SIZE;
+            }
+        }
+        else if ((size <= GBALLOC_POOL_MAX_SIZE) && (pool_class_of[(size + 15) / 16] == header->class_index) && (poolState == GBALLOC_POOL_STATE_INIT))
+        {
+            /* Codes_SRS_GBALLOC_POOL_99_016: [ When the new size is served by the class of the block, gballoc_pool_realloc shall return ptr. ]*/
+            GBALLOC_POOL_CACHE* cache = get_cache();
+            if (cache != NULL)
+            {
+                cache->requested_bytes[header->class_index] += size - header->requested_size;
+            }
+            else if (Lock(poolLock) == LOCK_OK)
+            {
+                pool_classes[header->class_index].requested_bytes += size - header->requested_size;
+                (void)Unlock(poolLock);
+            }
+            header->requested_size = size;
+            result = ptr;
+        }
+        /* Codes_SRS_GBALLOC_POOL_99_017: [ Otherwise gballoc_pool_realloc shall allocate a new block, copy the contents that fit and free ptr. ]*/
+        else if ((result = gballoc_pool_malloc(size)) == NULL)
+        {
+            /* Codes_SRS_GBALLOC_POOL_99_018: [ If the new memory cannot be obtained, gballoc_pool_realloc shall return NULL and leave ptr untouched. ]*/
+            LogError("Cannot reallocate %u bytes", (unsigned int)size);
+        }
+        else
+        {
+            (void)memcpy(result, ptr, (header->requested_size < size) ? header->requested_size : size);
+            gballoc_pool_free(ptr);
+        }
+    }
+
+    return result;
+}
+
+void gballoc_pool_free(void* ptr)
+{
+    if (ptr != NULL)
+    {
+        GBALLOC_POOL_HEADER* header = (GBALLOC_POOL_HEADER*)((unsigned char*)ptr - GBALLOC_POOL_HEADER_SIZE);
+
+        if (header->class_index == GBALLOC_POOL_LARGE)
+        {
+            /* Codes_SRS_GBALLOC_POOL_99_019: [ gballoc_pool_free shall give a block that came from malloc back to free. ]*/
+            free(header);
+        }
+        else if (poolState != GBALLOC_POOL_STATE_INIT)
+        {
+            /* the slab of the block was kept by gballoc_pool_deinit, and so was the lock */
+            if (Lock(poolLock) != LOCK_OK)
+            {
+                LogError("Failed to get the Lock, a block of the %u bytes class is lost", (unsigned int)pool_class_sizes[header->class_index]);
+            }
+            else
+            {
+                /* Codes_SRS_GBALLOC_POOL_99_021: [ A pooled block freed after gballoc_pool_deinit shall go back to the shared free list of its class, and the slabs of the class shall be freed once all its blocks are back. ]*/
+                push_free_block(&pool_classes[header->class_index], header);
+                pool_classes[header->class_index].requested_bytes -= header->requested_size;
+                release_unused_slabs(header->class_index);
+                (void)Unlock(poolLock);
+            }
+        }
+        else
+        {
+            /* Codes_SRS_GBALLOC_POOL_99_020: [ gballoc_pool_free shall put a pooled block in the thread cache, moving half of the cache to the shared free list when the cache is full. ]*/
+            give_block(header);
+        }
+    }
+}
+
+int gballoc_pool_get_statistics(GBALLOC_POOL_STATISTICS* statistics)
+{
+    int result;
+
+    if (statistics == NULL)
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_022: [ If statistics is NULL, gballoc_pool_get_statistics shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: statistics = %p", statistics);
+        result = __FAILURE__;
+    }
+    else if (poolState != GBALLOC_POOL_STATE_INIT)
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_023: [ If the pool is not initialized, gballoc_pool_get_statistics shall fail and return a non-zero value. ]*/
+        LogError("gballoc_pool is not initialized.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* taken before the lock, registering a new cache takes the lock too */
+        GBALLOC_POOL_CACHE* cache = get_cache();
+
+        if (Lock(poolLock) != LOCK_OK)
+        {
+            LogError("Failed to get the Lock.");
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t i;
+
+            /* Codes_SRS_GBALLOC_POOL_99_024: [ gballoc_pool_get_statistics shall fill in, for every class, the slab and block counts, the blocks in use and free, the bytes requested by the blocks in use and the bytes lost to rounding, and return 0. ]*/
+            for (i = 0; i < GBALLOC_POOL_CLASS_COUNT; i++)
+            {
+                GBALLOC_POOL_CLASS* pool_class = &pool_classes[i];
+                GBALLOC_POOL_CLASS_STATISTICS* class_statistics = &statistics->classes[i];
+                size_t unused_count;
+
+                if (cache != NULL)
+                {
+                    report_cache(cache, i);
+                }
+                unused_count = pool_class->free_count + pool_class->cached_count;
+
+                class_statistics->block_size = pool_class_sizes[i];
+                class_statistics->slab_count = pool_class->slab_count;
+                class_statistics->block_count = pool_class->block_count;
+                /* the counts reported by other threads may lag behind */
+                class_statistics->free_block_count = (unused_count < pool_class->block_count) ? unused_count : pool_class->block_count;
+                class_statistics->used_block_count = pool_class->block_count - class_statistics->free_block_count;
+                class_statistics->requested_bytes = pool_class->requested_bytes;
+                class_statistics->wasted_bytes = (class_statistics->used_block_count * pool_class_sizes[i] > pool_class->requested_bytes) ?
+                    class_statistics->used_block_count * pool_class_sizes[i] - pool_class->requested_bytes : 0;
+                class_statistics->allocation_count = pool_class->allocation_count;
+            }
+
+            statistics->large_allocation_count = pool_large_allocation_count;
+            (void)Unlock(poolLock);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static void* pool_allocator_malloc(void* context, size_t size)
+{
+    (void)context;
+    return gballoc_pool_malloc(size);
+}
+
+static void* pool_allocator_calloc(void* context, size_t nmemb, size_t size)
+{
+    (void)context;
+    return gballoc_pool_calloc(nmemb, size);
+}
+
+static void* pool_allocator_realloc(void* context, void* ptr, size_t size)
+{
+    (void)context;
+    return gballoc_pool_realloc(ptr, size);
+}
+
+static void pool_allocator_free(void* context, void* ptr)
+{
+    (void)context;
+    gballoc_pool_free(ptr);
+}
+
+void gballoc_pool_getAllocator(GBALLOC_ALLOCATOR* allocator)
+{
+    /* Codes_SRS_GBALLOC_POOL_99_027: [ If allocator is NULL, gballoc_pool_getAllocator shall do nothing. ]*/
+    if (allocator != NULL)
+    {
+        /* Codes_SRS_GBALLOC_POOL_99_028: [ gballoc_pool_getAllocator shall fill in allocator with functions that call gballoc_pool_malloc, gballoc_pool_calloc, gballoc_pool_realloc and gballoc_pool_free, without aligned functions and with a NULL context. ]*/
+        allocator->malloc_function = pool_allocator_malloc;
+        allocator->realloc_function = pool_allocator_realloc;
+        allocator->free_function = pool_allocator_free;
+        allocator->calloc_function = pool_allocator_calloc;
+        allocator->aligned_malloc_function = NULL;
+        allocator->aligned_free_function = NULL;
+        allocator->context = NULL;
+    }
+}
@@ -1,9 +1,13 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/hmacsha256.h"
 #include "azure_c_shared_utility/hmac.h"
+#include "azure_c_shared_utility/sha-private.h"
 #include "azure_c_shared_utility/buffer_.h"
 
 HMACSHA256_RESULT HMACSHA256_ComputeHash(const unsigned char* key, size_t keyLen, const unsigned char* payload, size_t payloadLen, BUFFER_HANDLE hash)
@@ -33,3 +37,220 @@ HMACSHA256_RESULT HMACSHA256_ComputeHash(const unsigned char* key, size_t keyLen
 
     return result;
 }
+
+/* the number of HMACs prepared at once by HMACSHA256_ComputeHashBatch, a few lane fills of the widest multi-buffer SHA-256 */
+#define HMACSHA256_BATCH_CHUNK 32
+
+static int buildPads(const unsigned char* key, size_t keyLen, unsigned char k_ipad[SHA256_Message_Block_Size], unsigned char k_opad[SHA256_Message_Block_Size])
+{
+    int result = shaSuccess;
+    unsigned char hashedKey[SHA256HashSize];
+    size_t i;
+
+    /* keys longer than a block are replaced by their hash, as in RFC 2104 */
+    if (keyLen > SHA256_Message_Block_Size)
+    {
+        SHA256Context keyContext;
+        result = SHA256Reset(&keyContext) ||
+            SHA256Input(&keyContext, key, (unsigned int)keyLen) ||
+            SHA256Result(&keyContext, hashedKey);
+        key = hashedKey;
+        keyLen = SHA256HashSize;
+    }
+
+    for (i = 0; i < keyLen; i++)
+    {
+        k_ipad[i] = key[i] ^ 0x36;
+        k_opad[i] = key[i] ^ 0x5c;
+    }
+    for (; i < SHA256_Message_Block_Size; i++)
+    {
+        k_ipad[i] = 0x36;
+        k_opad[i] = 0x5c;
+    }
+
+    (void)memset(hashedKey, 0, sizeof(hashedKey));
+    return result;
+}
+
+HMACSHA256_RESULT HMACSHA256_ComputeHashBatch(HMACSHA256_BATCH_ITEM* items, size_t itemCount)
+{
+    HMACSHA256_RESULT result;
+    size_t i;
+
+    if (items == NULL ||
+        itemCount == 0)
+    {
+        result = HMACSHA256_INVALID_ARG;
+    }
+    else
+    {
+        result = HMACSHA256_OK;
+        for (i = 0; i < itemCount; i++)
+        {
+            if (items[i].key == NULL ||
+                items[i].keyLen == 0 ||
+                items[i].payload == NULL ||
+                items[i].payloadLen == 0)
+            {
+                result = HMACSHA256_INVALID_ARG;
+                break;
+            }
+        }
+
+        if (result == HMACSHA256_OK)
+        {
+            unsigned char k_ipad[HMACSHA256_BATCH_CHUNK][SHA256_Message_Block_Size];
+            unsigned char k_opad[HMACSHA256_BATCH_CHUNK][SHA256_Message_Block_Size];
+            unsigned char innerHash[HMACSHA256_BATCH_CHUNK][SHA256HashSize];
+            SHA256BatchJob jobs[HMACSHA256_BATCH_CHUNK];
+            size_t chunkStart;
+            size_t chunkSize;
+
+            /* SHA(K XOR opad, SHA(K XOR ipad, text)), each of the 2 passes over a whole chunk at once */
+            for (chunkStart = 0; (chunkStart < itemCount) && (result == HMACSHA256_OK); chunkStart += chunkSize)
+            {
+                chunkSize = itemCount - chunkStart;
+                if (chunkSize > HMACSHA256_BATCH_CHUNK)
+                {
+                    chunkSize = HMACSHA256_BATCH_CHUNK;
+                }
+
+                for (i = 0; (i < chunkSize) && (result == HMACSHA256_OK); i++)
+                {
+                    HMACSHA256_BATCH_ITEM* item = &items[chunkStart + i];
+                    if (buildPads(item->key, item->keyLen, k_ipad[i], k_opad[i]) != shaSuccess)
+                    {
+                        result = HMACSHA256_ERROR;
+                    }
+                    else
+                    {
+                        jobs[i].prefix = k_ipad[i];
+                        jobs[i].data = item->payload;
+                        jobs[i].length = item->payloadLen;
+                        jobs[i].digest = innerHash[i];
+                    }
+                }
+
+                if ((result == HMACSHA256_OK) &&
+                    (SHA256ProcessBatch(jobs, chunkSize) != shaSuccess))
+                {
+                    result = HMACSHA256_ERROR;
+                }
+
+                if (result == HMACSHA256_OK)
+                {
+                    for (i = 0; i < chunkSize; i++)
+                    {
+                        jobs[i].prefix = k_opad[i];
+                        jobs[i].data = innerHash[i];
+                        jobs[i].length = SHA256HashSize;
+                        jobs[i].digest = items[chunkStart + i].hash;
+                    }
+
+                    if (SHA256ProcessBatch(jobs, chunkSize) != shaSuccess)
+                    {
+                        result = HMACSHA256_ERROR;
+                    }
+                }
+            }
+
+            /* do not leave key material on the stack */
+            (void)memset(k_ipad, 0, sizeof(k_ipad));
+            (void)memset(k_opad, 0, sizeof(k_opad));
+            (void)memset(innerHash, 0, sizeof(innerHash));
+        }
+    }
+
+    return result;
+}
+
+typedef struct HMACSHA256_KEY_TAG
+{
+    /* SHA-256 of (key XOR ipad) and of (key XOR opad), each one block long */
+    SHA256Context innerContext;
+    SHA256Context outerContext;
+} HMACSHA256_KEY;
+
+HMACSHA256_KEY_HANDLE HMACSHA256_CreateKey(const unsigned char* key, size_t keyLen)
+{
+    HMACSHA256_KEY* result;
+
+    if (key == NULL ||
+        keyLen == 0)
+    {
+        result = NULL;
+    }
+    else if ((result = (HMACSHA256_KEY*)malloc(sizeof(HMACSHA256_KEY))) != NULL)
+    {
+        unsigned char k_ipad[SHA256_Message_Block_Size];
+        unsigned char k_opad[SHA256_Message_Block_Size];
+        int shaResult = buildPads(key, keyLen, k_ipad, k_opad);
+
+        if ((shaResult != shaSuccess) ||
+            (SHA256Reset(&result->innerContext) != shaSuccess) ||
+            (SHA256Input(&result->innerContext, k_ipad, SHA256_Message_Block_Size) != shaSuccess) ||
+            (SHA256Reset(&result->outerContext) != shaSuccess) ||
+            (SHA256Input(&result->outerContext, k_opad, SHA256_Message_Block_Size) != shaSuccess))
+        {
+            free(result);
+            result = NULL;
+        }
+
+        /* do not leave key material on the stack */
+        (void)memset(k_ipad, 0, sizeof(k_ipad));
+        (void)memset(k_opad, 0, sizeof(k_opad));
+    }
+
+    return result;
+}
+
+void HMACSHA256_DestroyKey(HMACSHA256_KEY_HANDLE keyHandle)
+{
+    if (keyHandle != NULL)
+    {
+        (void)memset(keyHandle, 0, sizeof(HMACSHA256_KEY));
+        free(keyHandle);
+    }
+}
+
+HMACSHA256_RESULT HMACSHA256_ComputeHashWithKey(HMACSHA256_KEY_HANDLE keyHandle, const unsigned char* payload, size_t payloadLen, unsigned char hash[HMACSHA256_HASH_SIZE])
+{
+    HMACSHA256_RESULT result;
+
+    if (keyHandle == NULL ||
+        payload == NULL ||
+        payloadLen == 0 ||
+        hash == NULL)
+    {
+        result = HMACSHA256_INVALID_ARG;
+    }
+    else
+    {
+        /* the contexts are copied so that the key can sign again, possibly from several threads */
+        SHA256Context context = keyHandle->innerContext;
+
+        if ((SHA256Input(&context, payload, (unsigned int)payloadLen) != shaSuccess) ||
+            (SHA256Result(&context, hash) != shaSuccess))
+        {
+            result = HMACSHA256_ERROR;
+        }
+        else
+        {
+            context = keyHandle->outerContext;
+            if ((SHA256Input(&context, hash, SHA256HashSize) != shaSuccess) ||
+                (SHA256Result(&context, hash) != shaSuccess))
+            {
+                result = HMACSHA256_ERROR;
+            }
+            else
+            {
+                result = HMACSHA256_OK;
+            }
+        }
+
+        (void)memset(&context, 0, sizeof(context));
+    }
+
+    return result;
+}
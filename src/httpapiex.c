@@ -9,6 +9,8 @@
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/vector.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/gb_rand.h"
 
 typedef struct HTTPAPIEX_SAVED_OPTION_TAG
 {
@@ -16,12 +18,31 @@ typedef struct HTTPAPIEX_SAVED_OPTION_TAG
     const void* value;
 }HTTPAPIEX_SAVED_OPTION;
 
+typedef struct HTTPAPIEX_PENDING_REQUEST_TAG
+{
+    HTTPAPI_REQUEST_TYPE requestType;
+    char* relativePath;
+    HTTP_HEADERS_HANDLE requestHttpHeadersHandle;
+    BUFFER_HANDLE requestContent;
+    HTTP_HEADERS_HANDLE responseHttpHeadersHandle;
+    BUFFER_HANDLE responseContent;
+    unsigned int statusCode;
+    ON_HTTPAPIEX_EXECUTE_REQUEST_COMPLETE on_execute_complete;
+    void* callback_context;
+    size_t attempts;
+    tickcounter_ms_t startTime;
+    tickcounter_ms_t nextAttemptTime;
+}HTTPAPIEX_PENDING_REQUEST;
+
 typedef struct HTTPAPIEX_HANDLE_DATA_TAG
 {
     STRING_HANDLE hostName;
     int k;
     HTTP_HANDLE httpHandle;
     VECTOR_HANDLE savedOptions;
+    HTTPAPIEX_RETRY_POLICY retryPolicy;
+    TICK_COUNTER_HANDLE tickCounter;
+    HTTPAPIEX_PENDING_REQUEST* pendingRequest;
 }HTTPAPIEX_HANDLE_DATA;
 
 DEFINE_ENUM_STRINGS(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
@@ -70,6 +91,14 @@ HTTPAPIEX_HANDLE HTTPAPIEX_Create(const char* hostName)
                 {
                     handleData->k = -1;
                     handleData->httpHandle = NULL;
+                    /*Codes_SRS_HTTPAPIEX_02_044: [By default a request shall be attempted only once.]*/
+                    handleData->retryPolicy.max_attempts = 1;
+                    handleData->retryPolicy.initial_delay_ms = 0;
+                    handleData->retryPolicy.max_delay_ms = 0;
+                    handleData->retryPolicy.jitter_percent = 0;
+                    handleData->retryPolicy.deadline_ms = 0;
+                    handleData->tickCounter = NULL;
+                    handleData->pendingRequest = NULL;
                     result = handleData;
                 }
             }
@@ -294,209 +323,457 @@ static int buildAllRequests(HTTPAPIEX_HANDLE_DATA* handle, HTTPAPI_REQUEST_TYPE
     return result;
 }
 
-HTTPAPIEX_RESULT HTTPAPIEX_ExecuteRequest(HTTPAPIEX_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+/*executes the request, going through the recovery sequence at most once*/
+static HTTPAPIEX_RESULT executeRequestWithRecovery(HTTPAPIEX_HANDLE_DATA* handleData, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
     HTTP_HEADERS_HANDLE requestHttpHeadersHandle, BUFFER_HANDLE requestContent, unsigned int* statusCode,
     HTTP_HEADERS_HANDLE responseHttpHeadersHandle, BUFFER_HANDLE responseContent)
 {
     HTTPAPIEX_RESULT result;
-    /*Codes_SRS_HTTPAPIEX_02_006: [If parameter handle is NULL then HTTPAPIEX_ExecuteRequest shall fail and return HTTPAPIEX_INVALID_ARG.]*/
-    if (handle == NULL)
+
+    /*call to buildAll*/
+    const char* toBeUsedRelativePath;
+    HTTP_HEADERS_HANDLE toBeUsedRequestHttpHeadersHandle; bool isOriginalRequestHttpHeadersHandle;
+    BUFFER_HANDLE toBeUsedRequestContent; bool isOriginalRequestContent;
+    unsigned int* toBeUsedStatusCode;
+    HTTP_HEADERS_HANDLE toBeUsedResponseHttpHeadersHandle; bool isOriginalResponseHttpHeadersHandle;
+    BUFFER_HANDLE toBeUsedResponseContent;  bool isOriginalResponseContent;
+
+    if (buildAllRequests(handleData, requestType, relativePath, requestHttpHeadersHandle, requestContent, statusCode, responseHttpHeadersHandle, responseContent,
+        &toBeUsedRelativePath,
+        &toBeUsedRequestHttpHeadersHandle, &isOriginalRequestHttpHeadersHandle,
+        &toBeUsedRequestContent, &isOriginalRequestContent,
+        &toBeUsedStatusCode,
+        &toBeUsedResponseHttpHeadersHandle, &isOriginalResponseHttpHeadersHandle,
+        &toBeUsedResponseContent, &isOriginalResponseContent) != 0)
     {
-        result = HTTPAPIEX_INVALID_ARG;
+        result = HTTPAPIEX_ERROR;
         LOG_HTTAPIEX_ERROR();
     }
     else
     {
-        /*Codes_SRS_HTTPAPIEX_02_007: [If parameter requestType does not indicate a valid request, HTTPAPIEX_ExecuteRequest shall fail and return HTTPAPIEX_INVALID_ARG.] */
-        if (requestType >= COUNT_ARG(HTTPAPI_REQUEST_TYPE_VALUES))
+
+        /*Codes_SRS_HTTPAPIEX_02_023: [HTTPAPIEX_ExecuteRequest shall try to execute the HTTP call by ensuring the following API call sequence is respected:]*/
+        /*Codes_SRS_HTTPAPIEX_02_024: [If any point in the sequence fails, HTTPAPIEX_ExecuteRequest shall attempt to recover by going back to the previous step and retrying that step.]*/
+        /*Codes_SRS_HTTPAPIEX_02_025: [If the first step fails, then the sequence fails.]*/
+        /*Codes_SRS_HTTPAPIEX_02_026: [A step shall be retried at most once.]*/
+        /*Codes_SRS_HTTPAPIEX_02_027: [If a step has been retried then all subsequent steps shall be retried too.]*/
+        bool st[3] = { false, false, false }; /*the three levels of possible failure in resilient send: HTTAPI_Init, HTTPAPI_CreateConnection, HTTPAPI_ExecuteRequest*/
+        if (handleData->k == -1)
         {
-            result = HTTPAPIEX_INVALID_ARG;
-            LOG_HTTAPIEX_ERROR();
+            handleData->k = 0;
         }
-        else
+
+        do
         {
-            HTTPAPIEX_HANDLE_DATA *handleData = (HTTPAPIEX_HANDLE_DATA *)handle;
+            bool goOn;
 
-            /*call to buildAll*/
-            const char* toBeUsedRelativePath;
-            HTTP_HEADERS_HANDLE toBeUsedRequestHttpHeadersHandle; bool isOriginalRequestHttpHeadersHandle;
-            BUFFER_HANDLE toBeUsedRequestContent; bool isOriginalRequestContent;
-            unsigned int* toBeUsedStatusCode;
-            HTTP_HEADERS_HANDLE toBeUsedResponseHttpHeadersHandle; bool isOriginalResponseHttpHeadersHandle;
-            BUFFER_HANDLE toBeUsedResponseContent;  bool isOriginalResponseContent;
-
-            if (buildAllRequests(handleData, requestType, relativePath, requestHttpHeadersHandle, requestContent, statusCode, responseHttpHeadersHandle, responseContent,
-                &toBeUsedRelativePath,
-                &toBeUsedRequestHttpHeadersHandle, &isOriginalRequestHttpHeadersHandle,
-                &toBeUsedRequestContent, &isOriginalRequestContent,
-                &toBeUsedStatusCode,
-                &toBeUsedResponseHttpHeadersHandle, &isOriginalResponseHttpHeadersHandle,
-                &toBeUsedResponseContent, &isOriginalResponseContent) != 0)
+            if (handleData->k > 2)
             {
-                result = HTTPAPIEX_ERROR;
-                LOG_HTTAPIEX_ERROR();
+                /* error */
+                break;
+            }
+
+            if (st[handleData->k] == true) /*already been tried*/
+            {
+                goOn = false;
             }
             else
             {
-
-                /*Codes_SRS_HTTPAPIEX_02_023: [HTTPAPIEX_ExecuteRequest shall try to execute the HTTP call by ensuring the following API call sequence is respected:]*/
-                /*Codes_SRS_HTTPAPIEX_02_024: [If any point in the sequence fails, HTTPAPIEX_ExecuteRequest shall attempt to recover by going back to the previous step and retrying that step.]*/
-                /*Codes_SRS_HTTPAPIEX_02_025: [If the first step fails, then the sequence fails.]*/
-                /*Codes_SRS_HTTPAPIEX_02_026: [A step shall be retried at most once.]*/
-                /*Codes_SRS_HTTPAPIEX_02_027: [If a step has been retried then all subsequent steps shall be retried too.]*/
-                bool st[3] = { false, false, false }; /*the three levels of possible failure in resilient send: HTTAPI_Init, HTTPAPI_CreateConnection, HTTPAPI_ExecuteRequest*/
-                if (handleData->k == -1)
+                switch (handleData->k)
                 {
-                    handleData->k = 0;
-                }
-
-                do
+                case 0:
                 {
-                    bool goOn;
-
-                    if (handleData->k > 2)
+                    if (HTTPAPI_Init() != HTTPAPI_OK)
                     {
-                        /* error */
-                        break;
+                        goOn = false;
                     }
-
-                    if (st[handleData->k] == true) /*already been tried*/
+                    else
+                    {
+                        goOn = true;
+                    }
+                    break;
+                }
+                case 1:
+                {
+                    if ((handleData->httpHandle = HTTPAPI_CreateConnection(STRING_c_str(handleData->hostName))) == NULL)
                     {
                         goOn = false;
                     }
                     else
                     {
-                        switch (handleData->k)
-                        {
-                        case 0:
-                        {
-                            if (HTTPAPI_Init() != HTTPAPI_OK)
-                            {
-                                goOn = false;
-                            }
-                            else
-                            {
-                                goOn = true;
-                            }
-                            break;
-                        }
-                        case 1:
+                        size_t i;
+                        size_t vectorSize = VECTOR_size(handleData->savedOptions);
+                        for (i = 0; i < vectorSize; i++)
                         {
-                            if ((handleData->httpHandle = HTTPAPI_CreateConnection(STRING_c_str(handleData->hostName))) == NULL)
-                            {
-                                goOn = false;
-                            }
-                            else
-                            {
-                                size_t i;
-                                size_t vectorSize = VECTOR_size(handleData->savedOptions);
-                                for (i = 0; i < vectorSize; i++)
-                                {
-                                    /*Codes_SRS_HTTPAPIEX_02_035: [HTTPAPIEX_ExecuteRequest shall pass all the saved options (see HTTPAPIEX_SetOption) to the newly create HTTPAPI_HANDLE in step 2 by calling HTTPAPI_SetOption.]*/
-                                    /*Codes_SRS_HTTPAPIEX_02_036: [If setting the option fails, then the failure shall be ignored.] */
-                                    HTTPAPIEX_SAVED_OPTION* option = (HTTPAPIEX_SAVED_OPTION*)VECTOR_element(handleData->savedOptions, i);
-                                    if (HTTPAPI_SetOption(handleData->httpHandle, option->optionName, option->value) != HTTPAPI_OK)
-                                    {
-                                        LogError("HTTPAPI_SetOption failed when called for option %s", option->optionName);
-                                    }
-                                }
-                                goOn = true;
-                            }
-                            break;
-                        }
-                        case 2:
-                        {
-                            size_t length = BUFFER_length(toBeUsedRequestContent);
-                            unsigned char* buffer = BUFFER_u_char(toBeUsedRequestContent);
-                            if (HTTPAPI_ExecuteRequest(handleData->httpHandle, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, buffer, length, toBeUsedStatusCode, toBeUsedResponseHttpHeadersHandle, toBeUsedResponseContent) != HTTPAPI_OK)
-                            {
-                                goOn = false;
-                            }
-                            else
+                            /*Codes_SRS_HTTPAPIEX_02_035: [HTTPAPIEX_ExecuteRequest shall pass all the saved options (see HTTPAPIEX_SetOption) to the newly create HTTPAPI_HANDLE in step 2 by calling HTTPAPI_SetOption.]*/
+                            /*Codes_SRS_HTTPAPIEX_02_036: [If setting the option fails, then the failure shall be ignored.] */
+                            HTTPAPIEX_SAVED_OPTION* option = (HTTPAPIEX_SAVED_OPTION*)VECTOR_element(handleData->savedOptions, i);
+                            if (HTTPAPI_SetOption(handleData->httpHandle, option->optionName, option->value) != HTTPAPI_OK)
                             {
-                                goOn = true;
+                                LogError("HTTPAPI_SetOption failed when called for option %s", option->optionName);
                             }
-                            break;
-                        }
-                        default:
-                        {
-                            /*serious error*/
-                            goOn = false;
-                            break;
-                        }
                         }
+                        goOn = true;
                     }
-
-                    if (goOn)
+                    break;
+                }
+                case 2:
+                {
+                    size_t length = BUFFER_length(toBeUsedRequestContent);
+                    unsigned char* buffer = BUFFER_u_char(toBeUsedRequestContent);
+                    if (HTTPAPI_ExecuteRequest(handleData->httpHandle, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, buffer, length, toBeUsedStatusCode, toBeUsedResponseHttpHeadersHandle, toBeUsedResponseContent) != HTTPAPI_OK)
                     {
-                        if (handleData->k == 2)
-                        {
-                            /*Codes_SRS_HTTPAPIEX_02_028: [HTTPAPIEX_ExecuteRequest shall return HTTPAPIEX_OK when a call to HTTPAPI_ExecuteRequest has been completed successfully.]*/
-                            result = HTTPAPIEX_OK;
-                            goto out;
-                        }
-                        else
-                        {
-                            st[handleData->k] = true;
-                            handleData->k++;
-                            st[handleData->k] = false;
-                        }
+                        goOn = false;
                     }
                     else
                     {
-                        st[handleData->k] = false;
-                        handleData->k--;
-                        switch (handleData->k)
-                        {
-                        case 0:
-                        {
-                            HTTPAPI_Deinit();
-                            break;
-                        }
-                        case 1:
-                        {
-                            HTTPAPI_CloseConnection(handleData->httpHandle);
-                            handleData->httpHandle = NULL;
-                            break;
-                        }
-                        case 2:
-                        {
-                            break;
-                        }
-                        default:
-                        {
-                            break;
-                        }
-                        }
+                        goOn = true;
                     }
-                } while (handleData->k >= 0);
-                /*Codes_SRS_HTTPAPIEX_02_029: [Otherwise, HTTAPIEX_ExecuteRequest shall return HTTPAPIEX_RECOVERYFAILED.] */
-                result = HTTPAPIEX_RECOVERYFAILED;
-                LogError("unable to recover sending to a working state");
-            out:;
-                /*in all cases, unbuild the temporaries*/
-                if (isOriginalRequestContent == false)
+                    break;
+                }
+                default:
+                {
+                    /*serious error*/
+                    goOn = false;
+                    break;
+                }
+                }
+            }
+
+            if (goOn)
+            {
+                if (handleData->k == 2)
+                {
+                    /*Codes_SRS_HTTPAPIEX_02_028: [HTTPAPIEX_ExecuteRequest shall return HTTPAPIEX_OK when a call to HTTPAPI_ExecuteRequest has been completed successfully.]*/
+                    result = HTTPAPIEX_OK;
+                    goto out;
+                }
+                else
                 {
-                    BUFFER_delete(toBeUsedRequestContent);
+                    st[handleData->k] = true;
+                    handleData->k++;
+                    st[handleData->k] = false;
                 }
-                if (isOriginalRequestHttpHeadersHandle == false)
+            }
+            else
+            {
+                st[handleData->k] = false;
+                handleData->k--;
+                switch (handleData->k)
                 {
-                    HTTPHeaders_Free(toBeUsedRequestHttpHeadersHandle);
+                case 0:
+                {
+                    HTTPAPI_Deinit();
+                    break;
                 }
-                if (isOriginalResponseContent == false)
+                case 1:
                 {
-                    BUFFER_delete(toBeUsedResponseContent);
+                    HTTPAPI_CloseConnection(handleData->httpHandle);
+                    handleData->httpHandle = NULL;
+                    break;
                 }
-                if (isOriginalResponseHttpHeadersHandle == false)
+                case 2:
                 {
-                    HTTPHeaders_Free(toBeUsedResponseHttpHeadersHandle);
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
                 }
             }
+        } while (handleData->k >= 0);
+        /*Codes_SRS_HTTPAPIEX_02_029: [Otherwise, HTTAPIEX_ExecuteRequest shall return HTTPAPIEX_RECOVERYFAILED.] */
+        result = HTTPAPIEX_RECOVERYFAILED;
+        LogError("unable to recover sending to a working state");
+    out:;
+        /*in all cases, unbuild the temporaries*/
+        if (isOriginalRequestContent == false)
+        {
+            BUFFER_delete(toBeUsedRequestContent);
+        }
+        if (isOriginalRequestHttpHeadersHandle == false)
+        {
+            HTTPHeaders_Free(toBeUsedRequestHttpHeadersHandle);
+        }
+        if (isOriginalResponseContent == false)
+        {
+            BUFFER_delete(toBeUsedResponseContent);
+        }
+        if (isOriginalResponseHttpHeadersHandle == false)
+        {
+            HTTPHeaders_Free(toBeUsedResponseHttpHeadersHandle);
         }
     }
     return result;
 }
 
+/*computes the delay before the next attempt, returns false if no other attempt shall be made*/
+static bool getNextRetryDelay(HTTPAPIEX_HANDLE_DATA* handleData, size_t attempts, tickcounter_ms_t startTime, tickcounter_ms_t* delay)
+{
+    bool result;
+    const HTTPAPIEX_RETRY_POLICY* retryPolicy = &handleData->retryPolicy;
+
+    /*Codes_SRS_HTTPAPIEX_02_049: [No more than max_attempts attempts shall be made.]*/
+    if (attempts >= retryPolicy->max_attempts)
+    {
+        result = false;
+    }
+    else
+    {
+        size_t i;
+
+        /*Codes_SRS_HTTPAPIEX_02_050: [The delay before an attempt shall be initial_delay_ms doubled for every attempt after the second one, and shall not exceed max_delay_ms.]*/
+        *delay = retryPolicy->initial_delay_ms;
+        for (i = 1; (i < attempts) && (*delay < retryPolicy->max_delay_ms); i++)
+        {
+            *delay = (*delay > retryPolicy->max_delay_ms / 2) ? retryPolicy->max_delay_ms : (*delay * 2);
+        }
+
+        /*Codes_SRS_HTTPAPIEX_02_051: [A random part of the delay, up to jitter_percent percent of it, shall be removed.]*/
+        if (retryPolicy->jitter_percent > 0)
+        {
+            uint64_t jitterRange = ((uint64_t)*delay * retryPolicy->jitter_percent) / 100;
+            *delay -= (tickcounter_ms_t)((jitterRange * (uint64_t)gb_rand()) / RAND_MAX);
+        }
+
+        if (retryPolicy->deadline_ms == 0)
+        {
+            result = true;
+        }
+        else
+        {
+            tickcounter_ms_t now;
+            if (tickcounter_get_current_ms(handleData->tickCounter, &now) != 0)
+            {
+                LogError("unable to get the current time, not retrying");
+                result = false;
+            }
+            /*Codes_SRS_HTTPAPIEX_02_052: [If deadline_ms is not 0, no attempt shall start later than deadline_ms milliseconds after the first one.]*/
+            else if ((now - startTime) + *delay > retryPolicy->deadline_ms)
+            {
+                LogError("retry deadline of %lu ms reached", (unsigned long)retryPolicy->deadline_ms);
+                result = false;
+            }
+            else
+            {
+                result = true;
+            }
+        }
+    }
+    return result;
+}
+
+HTTPAPIEX_RESULT HTTPAPIEX_ExecuteRequest(HTTPAPIEX_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+    HTTP_HEADERS_HANDLE requestHttpHeadersHandle, BUFFER_HANDLE requestContent, unsigned int* statusCode,
+    HTTP_HEADERS_HANDLE responseHttpHeadersHandle, BUFFER_HANDLE responseContent)
+{
+    HTTPAPIEX_RESULT result;
+    /*Codes_SRS_HTTPAPIEX_02_006: [If parameter handle is NULL then HTTPAPIEX_ExecuteRequest shall fail and return HTTPAPIEX_INVALID_ARG.]*/
+    if (handle == NULL)
+    {
+        result = HTTPAPIEX_INVALID_ARG;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else
+    {
+        /*Codes_SRS_HTTPAPIEX_02_007: [If parameter requestType does not indicate a valid request, HTTPAPIEX_ExecuteRequest shall fail and return HTTPAPIEX_INVALID_ARG.] */
+        if (requestType >= COUNT_ARG(HTTPAPI_REQUEST_TYPE_VALUES))
+        {
+            result = HTTPAPIEX_INVALID_ARG;
+            LOG_HTTAPIEX_ERROR();
+        }
+        else
+        {
+            HTTPAPIEX_HANDLE_DATA *handleData = (HTTPAPIEX_HANDLE_DATA *)handle;
+            size_t attempts = 1;
+            tickcounter_ms_t startTime = 0;
+            tickcounter_ms_t delay;
+
+            if ((handleData->retryPolicy.deadline_ms > 0) &&
+                (tickcounter_get_current_ms(handleData->tickCounter, &startTime) != 0))
+            {
+                LogError("unable to get the current time, the request will not be retried");
+                attempts = handleData->retryPolicy.max_attempts;
+            }
+
+            result = executeRequestWithRecovery(handleData, requestType, relativePath, requestHttpHeadersHandle, requestContent, statusCode, responseHttpHeadersHandle, responseContent);
+
+            /*Codes_SRS_HTTPAPIEX_02_048: [If the recovery sequence fails, HTTPAPIEX_ExecuteRequest shall wait for the delay given by the retry policy and start it again.]*/
+            while ((result == HTTPAPIEX_RECOVERYFAILED) && getNextRetryDelay(handleData, attempts, startTime, &delay))
+            {
+                LogInfo("retrying the request in %lu ms", (unsigned long)delay);
+                ThreadAPI_Sleep((unsigned int)delay);
+                attempts++;
+                result = executeRequestWithRecovery(handleData, requestType, relativePath, requestHttpHeadersHandle, requestContent, statusCode, responseHttpHeadersHandle, responseContent);
+            }
+        }
+    }
+    return result;
+}
+
+HTTPAPIEX_RESULT HTTPAPIEX_SetRetryPolicy(HTTPAPIEX_HANDLE handle, const HTTPAPIEX_RETRY_POLICY* retryPolicy)
+{
+    HTTPAPIEX_RESULT result;
+    /*Codes_SRS_HTTPAPIEX_02_045: [If parameter handle or retryPolicy is NULL, or if retryPolicy has max_attempts 0, a max_delay_ms lower than initial_delay_ms or a jitter_percent greater than 100, then HTTPAPIEX_SetRetryPolicy shall return HTTPAPIEX_INVALID_ARG.]*/
+    if (
+        (handle == NULL) ||
+        (retryPolicy == NULL) ||
+        (retryPolicy->max_attempts == 0) ||
+        (retryPolicy->max_delay_ms < retryPolicy->initial_delay_ms) ||
+        (retryPolicy->jitter_percent > 100)
+        )
+    {
+        result = HTTPAPIEX_INVALID_ARG;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else
+    {
+        HTTPAPIEX_HANDLE_DATA* handleData = (HTTPAPIEX_HANDLE_DATA*)handle;
+        /*Codes_SRS_HTTPAPIEX_02_046: [HTTPAPIEX_SetRetryPolicy shall create a tick counter if none exists.]*/
+        if ((handleData->tickCounter == NULL) &&
+            ((handleData->tickCounter = tickcounter_create()) == NULL))
+        {
+            /*Codes_SRS_HTTPAPIEX_02_047: [If creating the tick counter fails then HTTPAPIEX_SetRetryPolicy shall return HTTPAPIEX_ERROR.]*/
+            result = HTTPAPIEX_ERROR;
+            LOG_HTTAPIEX_ERROR();
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPIEX_02_053: [Otherwise HTTPAPIEX_SetRetryPolicy shall copy retryPolicy and return HTTPAPIEX_OK.]*/
+            handleData->retryPolicy = *retryPolicy;
+            result = HTTPAPIEX_OK;
+        }
+    }
+    return result;
+}
+
+HTTPAPIEX_RESULT HTTPAPIEX_ExecuteRequestAsync(HTTPAPIEX_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+    HTTP_HEADERS_HANDLE requestHttpHeadersHandle, BUFFER_HANDLE requestContent,
+    HTTP_HEADERS_HANDLE responseHttpHeadersHandle, BUFFER_HANDLE responseContent,
+    ON_HTTPAPIEX_EXECUTE_REQUEST_COMPLETE on_execute_complete, void* callback_context)
+{
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_HANDLE_DATA* handleData = (HTTPAPIEX_HANDLE_DATA*)handle;
+    /*Codes_SRS_HTTPAPIEX_02_054: [If parameter handle or on_execute_complete is NULL, or if requestType is not valid, then HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_INVALID_ARG.]*/
+    if (
+        (handleData == NULL) ||
+        (on_execute_complete == NULL) ||
+        (requestType >= COUNT_ARG(HTTPAPI_REQUEST_TYPE_VALUES))
+        )
+    {
+        result = HTTPAPIEX_INVALID_ARG;
+        LOG_HTTAPIEX_ERROR();
+    }
+    /*Codes_SRS_HTTPAPIEX_02_055: [If a request is already pending then HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_ERROR.]*/
+    else if (handleData->pendingRequest != NULL)
+    {
+        result = HTTPAPIEX_ERROR;
+        LogError("a request is already pending");
+    }
+    /*Codes_SRS_HTTPAPIEX_02_056: [HTTPAPIEX_ExecuteRequestAsync shall create a tick counter if none exists.]*/
+    else if ((handleData->tickCounter == NULL) &&
+        ((handleData->tickCounter = tickcounter_create()) == NULL))
+    {
+        /*Codes_SRS_HTTPAPIEX_02_058: [If any failure occurs, HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_ERROR.]*/
+        result = HTTPAPIEX_ERROR;
+        LogError("unable to tickcounter_create");
+    }
+    else
+    {
+        HTTPAPIEX_PENDING_REQUEST* pendingRequest = (HTTPAPIEX_PENDING_REQUEST*)malloc(sizeof(HTTPAPIEX_PENDING_REQUEST));
+        if (pendingRequest == NULL)
+        {
+            /*Codes_SRS_HTTPAPIEX_02_058: [If any failure occurs, HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_ERROR.]*/
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to malloc");
+        }
+        /*Codes_SRS_HTTPAPIEX_02_057: [HTTPAPIEX_ExecuteRequestAsync shall save a copy of relativePath and the other parameters, and shall schedule the first attempt immediately.]*/
+        else if (mallocAndStrcpy_s(&pendingRequest->relativePath, (relativePath == NULL) ? "" : relativePath) != 0)
+        {
+            /*Codes_SRS_HTTPAPIEX_02_058: [If any failure occurs, HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_ERROR.]*/
+            free(pendingRequest);
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to copy the relative path");
+        }
+        else if (tickcounter_get_current_ms(handleData->tickCounter, &pendingRequest->startTime) != 0)
+        {
+            /*Codes_SRS_HTTPAPIEX_02_058: [If any failure occurs, HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_ERROR.]*/
+            free(pendingRequest->relativePath);
+            free(pendingRequest);
+            result = HTTPAPIEX_ERROR;
+            LogError("unable to get the current time");
+        }
+        else
+        {
+            pendingRequest->requestType = requestType;
+            pendingRequest->requestHttpHeadersHandle = requestHttpHeadersHandle;
+            pendingRequest->requestContent = requestContent;
+            pendingRequest->responseHttpHeadersHandle = responseHttpHeadersHandle;
+            pendingRequest->responseContent = responseContent;
+            pendingRequest->statusCode = 0;
+            pendingRequest->on_execute_complete = on_execute_complete;
+            pendingRequest->callback_context = callback_context;
+            pendingRequest->attempts = 0;
+            pendingRequest->nextAttemptTime = pendingRequest->startTime;
+            handleData->pendingRequest = pendingRequest;
+            result = HTTPAPIEX_OK;
+        }
+    }
+    return result;
+}
+
+static void completePendingRequest(HTTPAPIEX_HANDLE_DATA* handleData, HTTPAPIEX_RESULT result)
+{
+    HTTPAPIEX_PENDING_REQUEST* pendingRequest = handleData->pendingRequest;
+
+    /*detached before calling back, so the callback can queue a new request*/
+    handleData->pendingRequest = NULL;
+    pendingRequest->on_execute_complete(pendingRequest->callback_context, result, pendingRequest->statusCode);
+    free(pendingRequest->relativePath);
+    free(pendingRequest);
+}
+
+void HTTPAPIEX_DoWork(HTTPAPIEX_HANDLE handle)
+{
+    HTTPAPIEX_HANDLE_DATA* handleData = (HTTPAPIEX_HANDLE_DATA*)handle;
+    /*Codes_SRS_HTTPAPIEX_02_059: [If parameter handle is NULL or if no request is pending, HTTPAPIEX_DoWork shall do nothing.]*/
+    if ((handleData != NULL) && (handleData->pendingRequest != NULL))
+    {
+        HTTPAPIEX_PENDING_REQUEST* pendingRequest = handleData->pendingRequest;
+        tickcounter_ms_t now;
+
+        if (tickcounter_get_current_ms(handleData->tickCounter, &now) != 0)
+        {
+            /*Codes_SRS_HTTPAPIEX_02_063: [Otherwise HTTPAPIEX_DoWork shall call on_execute_complete with the result of the attempt and the HTTP status code. If getting the current time fails, HTTPAPIEX_DoWork shall complete the request with HTTPAPIEX_ERROR.]*/
+            LogError("unable to get the current time");
+            completePendingRequest(handleData, HTTPAPIEX_ERROR);
+        }
+        /*Codes_SRS_HTTPAPIEX_02_060: [HTTPAPIEX_DoWork shall not do anything before the next attempt of the pending request is due.]*/
+        else if (now >= pendingRequest->nextAttemptTime)
+        {
+            tickcounter_ms_t delay;
+
+            /*Codes_SRS_HTTPAPIEX_02_061: [When the next attempt is due, HTTPAPIEX_DoWork shall execute the request the same way HTTPAPIEX_ExecuteRequest executes one attempt.]*/
+            HTTPAPIEX_RESULT result = executeRequestWithRecovery(handleData, pendingRequest->requestType, pendingRequest->relativePath,
+                pendingRequest->requestHttpHeadersHandle, pendingRequest->requestContent, &pendingRequest->statusCode,
+                pendingRequest->responseHttpHeadersHandle, pendingRequest->responseContent);
+            pendingRequest->attempts++;
+
+            if ((result == HTTPAPIEX_RECOVERYFAILED) && getNextRetryDelay(handleData, pendingRequest->attempts, pendingRequest->startTime, &delay))
+            {
+                /*Codes_SRS_HTTPAPIEX_02_062: [If the attempt failed and the retry policy allows another one, HTTPAPIEX_DoWork shall schedule it after the delay given by the retry policy.]*/
+                LogInfo("retrying the request in %lu ms", (unsigned long)delay);
+                pendingRequest->nextAttemptTime = now + delay;
+            }
+            else
+            {
+                /*Codes_SRS_HTTPAPIEX_02_063: [Otherwise HTTPAPIEX_DoWork shall call on_execute_complete with the result of the attempt and the HTTP status code. If getting the current time fails, HTTPAPIEX_DoWork shall complete the request with HTTPAPIEX_ERROR.]*/
+                completePendingRequest(handleData, result);
+            }
+        }
+    }
+}
 
 void HTTPAPIEX_Destroy(HTTPAPIEX_HANDLE handle)
 {
@@ -507,6 +784,12 @@ void HTTPAPIEX_Destroy(HTTPAPIEX_HANDLE handle)
         size_t vectorSize;
         HTTPAPIEX_HANDLE_DATA* handleData = (HTTPAPIEX_HANDLE_DATA*)handle;
         
+        /*Codes_SRS_HTTPAPIEX_02_064: [If a request is pending, HTTPAPIEX_Destroy shall call its on_execute_complete with HTTPAPIEX_ERROR.]*/
+        if (handleData->pendingRequest != NULL)
+        {
+            completePendingRequest(handleData, HTTPAPIEX_ERROR);
+        }
+
         if (handleData->k == 2)
         {
             HTTPAPI_CloseConnection(handleData->httpHandle);
@@ -514,6 +797,11 @@ void HTTPAPIEX_Destroy(HTTPAPIEX_HANDLE handle)
         }
         STRING_delete(handleData->hostName);
 
+        if (handleData->tickCounter != NULL)
+        {
+            tickcounter_destroy(handleData->tickCounter);
+        }
+
         vectorSize = VECTOR_size(handleData->savedOptions);
         for (i = 0; i < vectorSize; i++)
         {
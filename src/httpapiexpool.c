@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/httpapiexpool.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/vector.h"
+#include "azure_c_shared_utility/lock.h"
+
+typedef struct HTTPAPIEX_POOL_ENTRY_TAG
+{
+    char* hostName;
+    HTTPAPIEX_HANDLE handle;
+    bool isCheckedOut;
+    tickcounter_ms_t lastCheckinTime;
+} HTTPAPIEX_POOL_ENTRY;
+
+typedef struct HTTPAPIEX_POOL_TAG
+{
+    size_t maxHandlesPerHost;
+    tickcounter_ms_t idleTimeoutInMs;
+    TICK_COUNTER_HANDLE tickCounter;
+    LOCK_HANDLE lock;
+    VECTOR_HANDLE entries;
+} HTTPAPIEX_POOL;
+
+static bool isSameHandle(const void* element, const void* value)
+{
+    return (((const HTTPAPIEX_POOL_ENTRY*)element)->handle == (HTTPAPIEX_HANDLE)value) ? true : false;
+}
+
+static void destroyEntry(HTTPAPIEX_POOL_ENTRY* entry)
+{
+    HTTPAPIEX_Destroy(entry->handle);
+    free(entry->hostName);
+}
+
+HTTPAPIEX_POOL_HANDLE HTTPAPIEX_POOL_Create(size_t maxHandlesPerHost, tickcounter_ms_t idleTimeoutInMs)
+{
+    HTTPAPIEX_POOL* result;
+    /*Codes_SRS_HTTPAPIEX_POOL_99_001: [If maxHandlesPerHost is 0 then HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+    if (maxHandlesPerHost == 0)
+    {
+        LogError("invalid argument maxHandlesPerHost = 0");
+        result = NULL;
+    }
+    else if ((result = (HTTPAPIEX_POOL*)malloc(sizeof(HTTPAPIEX_POOL))) == NULL)
+    {
+        /*Codes_SRS_HTTPAPIEX_POOL_99_003: [If any failure occurs, HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+        LogError("unable to malloc");
+    }
+    else
+    {
+        /*Codes_SRS_HTTPAPIEX_POOL_99_002: [HTTPAPIEX_POOL_Create shall create a tick counter, a lock and an empty set of pooled handles.]*/
+        if ((result->tickCounter = tickcounter_create()) == NULL)
+        {
+            /*Codes_SRS_HTTPAPIEX_POOL_99_003: [If any failure occurs, HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+            LogError("unable to tickcounter_create");
+            free(result);
+            result = NULL;
+        }
+        else if ((result->lock = Lock_Init()) == NULL)
+        {
+            /*Codes_SRS_HTTPAPIEX_POOL_99_003: [If any failure occurs, HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+            LogError("unable to Lock_Init");
+            tickcounter_destroy(result->tickCounter);
+            free(result);
+            result = NULL;
+        }
+        else if ((result->entries = VECTOR_create(sizeof(HTTPAPIEX_POOL_ENTRY))) == NULL)
+        {
+            /*Codes_SRS_HTTPAPIEX_POOL_99_003: [If any failure occurs, HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+            LogError("unable to VECTOR_create");
+            (void)Lock_Deinit(result->lock);
+            tickcounter_destroy(result->tickCounter);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->maxHandlesPerHost = maxHandlesPerHost;
+            result->idleTimeoutInMs = idleTimeoutInMs;
+        }
+    }
+    return result;
+}
+
+void HTTPAPIEX_POOL_Destroy(HTTPAPIEX_POOL_HANDLE pool)
+{
+    /*Codes_SRS_HTTPAPIEX_POOL_99_004: [If pool is NULL then HTTPAPIEX_POOL_Destroy shall do nothing.]*/
+    if (pool != NULL)
+    {
+        size_t i;
+        size_t entryCount = VECTOR_size(pool->entries);
+
+        /*Codes_SRS_HTTPAPIEX_POOL_99_005: [HTTPAPIEX_POOL_Destroy shall destroy all the pooled handles and free all the resources used by the pool.]*/
+        for (i = 0; i < entryCount; i++)
+        {
+            HTTPAPIEX_POOL_ENTRY* entry = (HTTPAPIEX_POOL_ENTRY*)VECTOR_element(pool->entries, i);
+            if (entry->isCheckedOut)
+            {
+                LogError("destroying a pool while a handle for %s is checked out", entry->hostName);
+            }
+            destroyEntry(entry);
+        }
+        VECTOR_destroy(pool->entries);
+        (void)Lock_Deinit(pool->lock);
+        tickcounter_destroy(pool->tickCounter);
+        free(pool);
+    }
+}
+
+/*removes at most one idle entry that expired, returns true if one was found*/
+/*the handle is destroyed outside of the lock because closing a connection can take a while*/
+static bool evictOneIdleEntry(HTTPAPIEX_POOL* pool)
+{
+    bool result = false;
+    tickcounter_ms_t now;
+
+    if (tickcounter_get_current_ms(pool->tickCounter, &now) != 0)
+    {
+        LogError("unable to get the current time, no handle is evicted");
+    }
+    else if (Lock(pool->lock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+    }
+    else
+    {
+        HTTPAPIEX_POOL_ENTRY evicted;
+        size_t i;
+        size_t entryCount = VECTOR_size(pool->entries);
+
+        for (i = 0; i < entryCount; i++)
+        {
+            HTTPAPIEX_POOL_ENTRY* entry = (HTTPAPIEX_POOL_ENTRY*)VECTOR_element(pool->entries, i);
+            if ((!entry->isCheckedOut) && (now - entry->lastCheckinTime >= pool->idleTimeoutInMs))
+            {
+                evicted = *entry;
+                VECTOR_erase(pool->entries, entry, 1);
+                result = true;
+                break;
+            }
+        }
+        (void)Unlock(pool->lock);
+
+        if (result)
+        {
+            LogInfo("evicting a handle for %s that was idle for too long", evicted.hostName);
+            destroyEntry(&evicted);
+        }
+    }
+    return result;
+}
+
+void HTTPAPIEX_POOL_EvictIdle(HTTPAPIEX_POOL_HANDLE pool)
+{
+    /*Codes_SRS_HTTPAPIEX_POOL_99_016: [If pool is NULL or if its idleTimeoutInMs is 0, HTTPAPIEX_POOL_EvictIdle shall do nothing.]*/
+    if ((pool != NULL) && (pool->idleTimeoutInMs > 0))
+    {
+        /*Codes_SRS_HTTPAPIEX_POOL_99_017: [HTTPAPIEX_POOL_EvictIdle shall destroy all the handles that were checked in at least idleTimeoutInMs milliseconds ago and not checked out since.]*/
+        while (evictOneIdleEntry(pool))
+        {
+            /*keep evicting*/
+        }
+    }
+}
+
+HTTPAPIEX_HANDLE HTTPAPIEX_POOL_Checkout(HTTPAPIEX_POOL_HANDLE pool, const char* hostName)
+{
+    HTTPAPIEX_HANDLE result;
+    /*Codes_SRS_HTTPAPIEX_POOL_99_006: [If pool or hostName is NULL then HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+    if ((pool == NULL) || (hostName == NULL))
+    {
+        LogError("invalid argument pool=%p, hostName=%p", pool, hostName);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_HTTPAPIEX_POOL_99_007: [HTTPAPIEX_POOL_Checkout shall first evict the idle handles as HTTPAPIEX_POOL_EvictIdle does.]*/
+        HTTPAPIEX_POOL_EvictIdle(pool);
+
+        if (Lock(pool->lock) != LOCK_OK)
+        {
+            /*Codes_SRS_HTTPAPIEX_POOL_99_011: [If any failure occurs, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+            LogError("unable to Lock");
+            result = NULL;
+        }
+        else
+        {
+            HTTPAPIEX_POOL_ENTRY* warmest = NULL;
+            size_t hostHandleCount = 0;
+            size_t i;
+            size_t entryCount = VECTOR_size(pool->entries);
+
+            for (i = 0; i < entryCount; i++)
+            {
+                HTTPAPIEX_POOL_ENTRY* entry = (HTTPAPIEX_POOL_ENTRY*)VECTOR_element(pool->entries, i);
+                if (strcmp(entry->hostName, hostName) == 0)
+                {
+                    hostHandleCount++;
+                    if ((!entry->isCheckedOut) &&
+                        ((warmest == NULL) || (entry->lastCheckinTime > warmest->lastCheckinTime)))
+                    {
+                        warmest = entry;
+                    }
+                }
+            }
+
+            if (warmest != NULL)
+            {
+                /*Codes_SRS_HTTPAPIEX_POOL_99_008: [If a handle for hostName is checked in, HTTPAPIEX_POOL_Checkout shall check out and return the most recently checked in one.]*/
+                warmest->isCheckedOut = true;
+                result = warmest->handle;
+            }
+            else if (hostHandleCount >= pool->maxHandlesPerHost)
+            {
+                /*Codes_SRS_HTTPAPIEX_POOL_99_010: [If maxHandlesPerHost handles for hostName are already checked out, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+                LogError("all the %lu handles for %s are checked out", (unsigned long)pool->maxHandlesPerHost, hostName);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_HTTPAPIEX_POOL_99_009: [Otherwise HTTPAPIEX_POOL_Checkout shall create a new handle by calling HTTPAPIEX_Create, add it to the pool as checked out and return it.]*/
+                HTTPAPIEX_POOL_ENTRY newEntry;
+                newEntry.isCheckedOut = true;
+                newEntry.lastCheckinTime = 0;
+                if (mallocAndStrcpy_s(&newEntry.hostName, hostName) != 0)
+                {
+                    /*Codes_SRS_HTTPAPIEX_POOL_99_011: [If any failure occurs, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+                    LogError("unable to copy the host name");
+                    result = NULL;
+                }
+                else if ((newEntry.handle = HTTPAPIEX_Create(hostName)) == NULL)
+                {
+                    /*Codes_SRS_HTTPAPIEX_POOL_99_011: [If any failure occurs, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+                    LogError("unable to HTTPAPIEX_Create");
+                    free(newEntry.hostName);
+                    result = NULL;
+                }
+                else if (VECTOR_push_back(pool->entries, &newEntry, 1) != 0)
+                {
+                    /*Codes_SRS_HTTPAPIEX_POOL_99_011: [If any failure occurs, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+                    LogError("unable to VECTOR_push_back");
+                    destroyEntry(&newEntry);
+                    result = NULL;
+                }
+                else
+                {
+                    result = newEntry.handle;
+                }
+            }
+            (void)Unlock(pool->lock);
+        }
+    }
+    return result;
+}
+
+void HTTPAPIEX_POOL_Checkin(HTTPAPIEX_POOL_HANDLE pool, HTTPAPIEX_HANDLE handle, bool isHealthy)
+{
+    /*Codes_SRS_HTTPAPIEX_POOL_99_012: [If pool or handle is NULL then HTTPAPIEX_POOL_Checkin shall do nothing.]*/
+    if ((pool == NULL) || (handle == NULL))
+    {
+        LogError("invalid argument pool=%p, handle=%p", pool, handle);
+    }
+    else if (Lock(pool->lock) != LOCK_OK)
+    {
+        LogError("unable to Lock");
+    }
+    else
+    {
+        HTTPAPIEX_POOL_ENTRY removed;
+        bool isRemoved = false;
+        HTTPAPIEX_POOL_ENTRY* entry = (HTTPAPIEX_POOL_ENTRY*)VECTOR_find_if(pool->entries, isSameHandle, handle);
+
+        if ((entry == NULL) || (!entry->isCheckedOut))
+        {
+            /*Codes_SRS_HTTPAPIEX_POOL_99_013: [If handle is not checked out from pool, HTTPAPIEX_POOL_Checkin shall do nothing.]*/
+            LogError("the handle %p is not checked out from this pool", handle);
+        }
+        else if (!isHealthy)
+        {
+            /*Codes_SRS_HTTPAPIEX_POOL_99_014: [If isHealthy is false, HTTPAPIEX_POOL_Checkin shall remove the handle from the pool and destroy it.]*/
+            removed = *entry;
+            VECTOR_erase(pool->entries, entry, 1);
+            isRemoved = true;
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPIEX_POOL_99_015: [Otherwise HTTPAPIEX_POOL_Checkin shall mark the handle as checked in and record the time of the checkin.]*/
+            tickcounter_ms_t now;
+            if (tickcounter_get_current_ms(pool->tickCounter, &now) != 0)
+            {
+                LogError("unable to get the current time");
+                now = entry->lastCheckinTime;
+            }
+            entry->isCheckedOut = false;
+            entry->lastCheckinTime = now;
+        }
+        (void)Unlock(pool->lock);
+
+        if (isRemoved)
+        {
+            destroyEntry(&removed);
+        }
+    }
+}
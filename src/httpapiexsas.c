@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include <stddef.h>
+#include <stdbool.h>
 #include <time.h>
 #include "azure_c_shared_utility/agenttime.h"
 #include "azure_c_shared_utility/strings.h"
@@ -12,15 +13,51 @@
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/httpapiex.h"
 #include "azure_c_shared_utility/httpapiexsas.h"
+#include "azure_c_shared_utility/lock.h"
 #include "azure_c_shared_utility/xlogging.h"
 
+#define DEFAULT_TOKEN_LIFETIME_IN_SECONDS 3600
+#define DEFAULT_TOKEN_REFRESH_PERCENT 80
+
 typedef struct HTTPAPIEX_SAS_STATE_TAG
 {
     STRING_HANDLE key;
     STRING_HANDLE uriResource;
     STRING_HANDLE keyName;
+    size_t tokenLifetimeInSeconds;
+    unsigned int tokenRefreshPercent;
+    STRING_HANDLE cachedToken;
+    time_t cachedTokenCreationTime;
+    HTTPAPIEX_SAS_TOKEN_STATISTICS statistics;
+    LOCK_HANDLE lock;
 }HTTPAPIEX_SAS_STATE;
 
+static void discardCachedToken(HTTPAPIEX_SAS_STATE* state)
+{
+    if (state->cachedToken != NULL)
+    {
+        STRING_delete(state->cachedToken);
+        state->cachedToken = NULL;
+    }
+}
+
+/*the cached token is reused until tokenRefreshPercent of its lifetime passed, so it is never sent close to its expiry*/
+static bool isCachedTokenYoungerThan(const HTTPAPIEX_SAS_STATE* state, time_t currentTime, unsigned int percentOfLifetime)
+{
+    bool result;
+    if (state->cachedToken == NULL)
+    {
+        result = false;
+    }
+    else
+    {
+        double elapsed = difftime(currentTime, state->cachedTokenCreationTime);
+        /*a clock that went backwards is not trusted*/
+        result = ((elapsed >= 0) && (elapsed * 100 < (double)state->tokenLifetimeInSeconds * percentOfLifetime)) ? true : false;
+    }
+    return result;
+}
+
 
 HTTPAPIEX_SAS_HANDLE HTTPAPIEX_SAS_Create(STRING_HANDLE key, STRING_HANDLE uriResource, STRING_HANDLE keyName)
 {
@@ -50,6 +87,14 @@ HTTPAPIEX_SAS_HANDLE HTTPAPIEX_SAS_Create(STRING_HANDLE key, STRING_HANDLE uriRe
             state->key = NULL;
             state->uriResource = NULL;
             state->keyName = NULL;
+            /*Codes_SRS_HTTPAPIEXSAS_06_020: [HTTPAPIEX_SAS_Create shall set the token lifetime to 3600 seconds and the refresh percentage to 80.]*/
+            state->tokenLifetimeInSeconds = DEFAULT_TOKEN_LIFETIME_IN_SECONDS;
+            state->tokenRefreshPercent = DEFAULT_TOKEN_REFRESH_PERCENT;
+            state->cachedToken = NULL;
+            state->cachedTokenCreationTime = 0;
+            state->statistics.regenerations = 0;
+            state->statistics.reuses = 0;
+            state->lock = NULL;
             if (((state->key = STRING_clone(key)) == NULL) ||
                 ((state->uriResource = STRING_clone(uriResource)) == NULL) ||
                 ((state->keyName = STRING_clone(keyName)) == NULL))
@@ -58,6 +103,13 @@ HTTPAPIEX_SAS_HANDLE HTTPAPIEX_SAS_Create(STRING_HANDLE key, STRING_HANDLE uriRe
                 LogError("Unable to clone the arguments.");
                 HTTPAPIEX_SAS_Destroy(state);
             }
+            /*Codes_SRS_HTTPAPIEXSAS_06_027: [HTTPAPIEX_SAS_Create shall create a lock by calling Lock_Init, which guards the kept token.]*/
+            else if ((state->lock = Lock_Init()) == NULL)
+            {
+                /*Codes_SRS_HTTPAPIEXSAS_06_004: [If there are any other errors in the instantiation of this handle then HTTPAPIEX_SAS_Create shall return NULL.]*/
+                LogError("unable to Lock_Init");
+                HTTPAPIEX_SAS_Destroy(state);
+            }
             else
             {
                 result = state;
@@ -86,6 +138,11 @@ void HTTPAPIEX_SAS_Destroy(HTTPAPIEX_SAS_HANDLE handle)
         {
             STRING_delete(state->keyName);
         }
+        discardCachedToken(state);
+        if (state->lock != NULL)
+        {
+            (void)Lock_Deinit(state->lock);
+        }
         free(state);
     }
 }
@@ -112,24 +169,68 @@ HTTPAPIEX_RESULT HTTPAPIEX_SAS_ExecuteRequest(HTTPAPIEX_SAS_HANDLE sasHandle, HT
                 }
                 else
                 {
-                    /*Codes_SRS_HTTPAPIEXSAS_06_011: [SASToken_Create shall be invoked.]*/
-                    /*Codes_SRS_HTTPAPIEXSAS_06_012: [If the return result of SASToken_Create is NULL then fallthrough.]*/
-                    size_t expiry = (size_t)(difftime(currentTime, 0) + 3600);
-                    STRING_HANDLE newSASToken = SASToken_Create(state->key, state->uriResource, state->keyName, expiry);
-                    if (newSASToken != NULL)
+                    STRING_HANDLE sasToken = NULL;
+                    /*Codes_SRS_HTTPAPIEXSAS_06_028: [The kept token shall only be read or replaced while holding the lock.]*/
+                    if (Lock(state->lock) != LOCK_OK)
+                    {
+                        /*Codes_SRS_HTTPAPIEXSAS_06_029: [If Lock fails then fallthrough.]*/
+                        LogError("unable to Lock");
+                    }
+                    else
+                    {
+                        STRING_HANDLE keptToken;
+                        if (isCachedTokenYoungerThan(state, currentTime, state->tokenRefreshPercent))
+                        {
+                            /*Codes_SRS_HTTPAPIEXSAS_06_021: [If a token was created less than refreshPercent percent of the token lifetime ago, it shall be used instead of creating a new one.]*/
+                            keptToken = state->cachedToken;
+                            state->statistics.reuses++;
+                        }
+                        else
+                        {
+                            /*Codes_SRS_HTTPAPIEXSAS_06_011: [SASToken_Create shall be invoked.]*/
+                            /*Codes_SRS_HTTPAPIEXSAS_06_012: [If the return result of SASToken_Create is NULL then fallthrough.]*/
+                            size_t expiry = (size_t)(difftime(currentTime, 0) + state->tokenLifetimeInSeconds);
+                            keptToken = SASToken_Create(state->key, state->uriResource, state->keyName, expiry);
+                            if (keptToken != NULL)
+                            {
+                                /*Codes_SRS_HTTPAPIEXSAS_06_015: [The new SAS token shall replace, and STRING_delete, the previously kept one.]*/
+                                discardCachedToken(state);
+                                state->cachedToken = keptToken;
+                                state->cachedTokenCreationTime = currentTime;
+                                state->statistics.regenerations++;
+                            }
+                            else if (isCachedTokenYoungerThan(state, currentTime, 100))
+                            {
+                                /*Codes_SRS_HTTPAPIEXSAS_06_026: [If SASToken_Create fails while the kept token has not expired yet, the kept token shall be used.]*/
+                                LogError("Unable to create a new SAS token, reusing the previous one until it expires.");
+                                keptToken = state->cachedToken;
+                                state->statistics.reuses++;
+                            }
+                            else
+                            {
+                                LogError("Unable to create a new SAS token.");
+                            }
+                        }
+
+                        /*Codes_SRS_HTTPAPIEXSAS_06_030: [The token used by the request shall be a STRING_clone of the kept token taken while holding the lock, so that a concurrent request replacing the kept token cannot delete it while it is in use.]*/
+                        if ((keptToken != NULL) &&
+                            ((sasToken = STRING_clone(keptToken)) == NULL))
+                        {
+                            /*Codes_SRS_HTTPAPIEXSAS_06_031: [If STRING_clone fails then fallthrough.]*/
+                            LogError("Unable to clone the SAS token.");
+                        }
+                        (void)Unlock(state->lock);
+                    }
+
+                    if (sasToken != NULL)
                     {
                         /*Codes_SRS_HTTPAPIEXSAS_06_013: [HTTPHeaders_ReplaceHeaderNameValuePair shall be invoked with "Authorization" as its second argument and STRING_c_str (newSASToken) as its third argument.]*/
-                        if (HTTPHeaders_ReplaceHeaderNameValuePair(requestHttpHeadersHandle, "Authorization", STRING_c_str(newSASToken)) != HTTP_HEADERS_OK)
+                        if (HTTPHeaders_ReplaceHeaderNameValuePair(requestHttpHeadersHandle, "Authorization", STRING_c_str(sasToken)) != HTTP_HEADERS_OK)
                         {
                             /*Codes_SRS_HTTPAPIEXSAS_06_014: [If the result of the invocation of HTTPHeaders_ReplaceHeaderNameValuePair is NOT HTTP_HEADERS_OK then fallthrough.]*/
                             LogError("Unable to replace the old SAS Token.");
                         }
-                        /*Codes_SRS_HTTPAPIEXSAS_06_015: [STRING_delete(newSASToken) will be invoked.]*/
-                        STRING_delete(newSASToken);
-                    }
-                    else
-                    {
-                        LogError("Unable to create a new SAS token.");
+                        STRING_delete(sasToken);
                     }
                 }
             }
@@ -138,3 +239,63 @@ HTTPAPIEX_RESULT HTTPAPIEX_SAS_ExecuteRequest(HTTPAPIEX_SAS_HANDLE sasHandle, HT
     /*Codes_SRS_HTTPAPIEXSAS_06_016: [HTTPAPIEX_ExecuteRequest with the remaining parameters (following sasHandle) as its arguments will be invoked and the result of that call is the result of HTTPAPIEX_SAS_ExecuteRequest.]*/
     return HTTPAPIEX_ExecuteRequest(handle,requestType,relativePath,requestHttpHeadersHandle,requestContent,statusCode,responseHeadersHandle,responseContent);
 }
+
+HTTPAPIEX_RESULT HTTPAPIEX_SAS_SetTokenLifetime(HTTPAPIEX_SAS_HANDLE sasHandle, size_t tokenLifetimeInSeconds, unsigned int refreshPercent)
+{
+    HTTPAPIEX_RESULT result;
+    /*Codes_SRS_HTTPAPIEXSAS_06_022: [If sasHandle is NULL, tokenLifetimeInSeconds is 0 or refreshPercent is greater than 100 then HTTPAPIEX_SAS_SetTokenLifetime shall return HTTPAPIEX_INVALID_ARG.]*/
+    if ((sasHandle == NULL) || (tokenLifetimeInSeconds == 0) || (refreshPercent > 100))
+    {
+        LogError("invalid argument sasHandle=%p, tokenLifetimeInSeconds=%lu, refreshPercent=%u", sasHandle, (unsigned long)tokenLifetimeInSeconds, refreshPercent);
+        result = HTTPAPIEX_INVALID_ARG;
+    }
+    else
+    {
+        HTTPAPIEX_SAS_STATE* state = (HTTPAPIEX_SAS_STATE*)sasHandle;
+        if (Lock(state->lock) != LOCK_OK)
+        {
+            /*Codes_SRS_HTTPAPIEXSAS_06_032: [If Lock fails then HTTPAPIEX_SAS_SetTokenLifetime shall return HTTPAPIEX_ERROR.]*/
+            LogError("unable to Lock");
+            result = HTTPAPIEX_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPIEXSAS_06_023: [HTTPAPIEX_SAS_SetTokenLifetime shall save tokenLifetimeInSeconds and refreshPercent, discard the kept token and return HTTPAPIEX_OK.]*/
+            state->tokenLifetimeInSeconds = tokenLifetimeInSeconds;
+            state->tokenRefreshPercent = refreshPercent;
+            discardCachedToken(state);
+            (void)Unlock(state->lock);
+            result = HTTPAPIEX_OK;
+        }
+    }
+    return result;
+}
+
+HTTPAPIEX_RESULT HTTPAPIEX_SAS_GetTokenStatistics(HTTPAPIEX_SAS_HANDLE sasHandle, HTTPAPIEX_SAS_TOKEN_STATISTICS* statistics)
+{
+    HTTPAPIEX_RESULT result;
+    /*Codes_SRS_HTTPAPIEXSAS_06_024: [If sasHandle or statistics is NULL then HTTPAPIEX_SAS_GetTokenStatistics shall return HTTPAPIEX_INVALID_ARG.]*/
+    if ((sasHandle == NULL) || (statistics == NULL))
+    {
+        LogError("invalid argument sasHandle=%p, statistics=%p", sasHandle, statistics);
+        result = HTTPAPIEX_INVALID_ARG;
+    }
+    else
+    {
+        HTTPAPIEX_SAS_STATE* state = (HTTPAPIEX_SAS_STATE*)sasHandle;
+        if (Lock(state->lock) != LOCK_OK)
+        {
+            /*Codes_SRS_HTTPAPIEXSAS_06_033: [If Lock fails then HTTPAPIEX_SAS_GetTokenStatistics shall return HTTPAPIEX_ERROR.]*/
+            LogError("unable to Lock");
+            result = HTTPAPIEX_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPIEXSAS_06_025: [HTTPAPIEX_SAS_GetTokenStatistics shall copy the number of tokens created and the number of tokens reused by HTTPAPIEX_SAS_ExecuteRequest to statistics and return HTTPAPIEX_OK.]*/
+            *statistics = state->statistics;
+            (void)Unlock(state->lock);
+            result = HTTPAPIEX_OK;
+        }
+    }
+    return result;
+}
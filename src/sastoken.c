@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
@@ -346,3 +347,198 @@ STRING_HANDLE SASToken_CreateString(const char* key, const char* scope, const ch
     }
     return result;
 }
+
+typedef struct SASTOKEN_BATCH_WORK_TAG
+{
+    BUFFER_HANDLE decodedKey;
+    STRING_HANDLE toBeHashed;
+    char tokenExpirationTime[32];
+} SASTOKEN_BATCH_WORK;
+
+static int prepare_batch_item(const SASTOKEN_BATCH_ITEM* item, SASTOKEN_BATCH_WORK* work, HMACSHA256_BATCH_ITEM* hmacItem)
+{
+    int result;
+
+    /*Codes_SRS_SASTOKEN_99_004: [ For each item SASToken_CreateBatch shall decode the key from base64, convert expiry to a string and build scope + "\n" + expiry, as SASToken_Create does. ]*/
+    if ((work->decodedKey = Base64_Decoder(item->key)) == NULL)
+    {
+        LogError("Unable to decode the key for generating the SAS.");
+        result = __FAILURE__;
+    }
+    else if (size_tToString(work->tokenExpirationTime, sizeof(work->tokenExpirationTime), item->expiry) != 0)
+    {
+        LogError("For some reason converting seconds to a string failed.  No SAS can be generated.");
+        result = __FAILURE__;
+    }
+    else if (((work->toBeHashed = STRING_new()) == NULL) ||
+        (STRING_concat(work->toBeHashed, item->scope) != 0) ||
+        (STRING_concat(work->toBeHashed, "\n") != 0) ||
+        (STRING_concat(work->toBeHashed, work->tokenExpirationTime) != 0))
+    {
+        LogError("Unable to build the input to the HMAC to prepare SAS token.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        hmacItem->key = BUFFER_u_char(work->decodedKey);
+        hmacItem->keyLen = BUFFER_length(work->decodedKey);
+        hmacItem->payload = (const unsigned char*)STRING_c_str(work->toBeHashed);
+        hmacItem->payloadLen = STRING_length(work->toBeHashed);
+        result = 0;
+    }
+
+    return result;
+}
+
+static STRING_HANDLE build_batch_token(const SASTOKEN_BATCH_ITEM* item, const SASTOKEN_BATCH_WORK* work, const HMACSHA256_BATCH_ITEM* hmacItem)
+{
+    STRING_HANDLE result;
+    STRING_HANDLE base64Signature = NULL;
+    STRING_HANDLE urlEncodedSignature = NULL;
+
+    /*Codes_SRS_SASTOKEN_99_006: [ Each token shall be built from its hash as SASToken_Create builds it. ]*/
+    if (((base64Signature = Base64_Encode_Bytes(hmacItem->hash, sizeof(hmacItem->hash))) == NULL) ||
+        ((urlEncodedSignature = URL_Encode(base64Signature)) == NULL) ||
+        ((result = STRING_construct("SharedAccessSignature sr=")) == NULL))
+    {
+        LogError("Unable to build the SAS token.");
+        result = NULL;
+    }
+    else if ((STRING_concat(result, item->scope) != 0) ||
+        (STRING_concat(result, "&sig=") != 0) ||
+        (STRING_concat_with_STRING(result, urlEncodedSignature) != 0) ||
+        (STRING_concat(result, "&se=") != 0) ||
+        (STRING_concat(result, work->tokenExpirationTime) != 0) ||
+        (STRING_concat(result, "&skn=") != 0) ||
+        (STRING_concat(result, item->keyName) != 0))
+    {
+        LogError("Unable to build the SAS token.");
+        STRING_delete(result);
+        result = NULL;
+    }
+    else
+    {
+        /* everything OK */
+    }
+
+    STRING_delete(base64Signature);
+    STRING_delete(urlEncodedSignature);
+    return result;
+}
+
+int SASToken_CreateBatch(SASTOKEN_BATCH_ITEM* items, size_t itemCount)
+{
+    int result;
+    size_t i;
+
+    /*Codes_SRS_SASTOKEN_99_001: [ If items is NULL or itemCount is 0 then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+    if ((items == NULL) ||
+        (itemCount == 0))
+    {
+        LogError("Invalid Parameter to SASToken_CreateBatch. items: %p, itemCount: %zu", items, itemCount);
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_SASTOKEN_99_009: [ If the working memory for itemCount items cannot be sized without overflowing then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+    else if ((itemCount > SIZE_MAX / sizeof(SASTOKEN_BATCH_WORK)) ||
+        (itemCount > SIZE_MAX / sizeof(HMACSHA256_BATCH_ITEM)))
+    {
+        LogError("Too many items for SASToken_CreateBatch. itemCount: %zu", itemCount);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_SASTOKEN_99_010: [ SASToken_CreateBatch shall set the token of every item to NULL before checking the items. ]*/
+        for (i = 0; i < itemCount; i++)
+        {
+            items[i].token = NULL;
+        }
+
+        result = 0;
+        for (i = 0; i < itemCount; i++)
+        {
+            /*Codes_SRS_SASTOKEN_99_002: [ If the key, scope or keyName of any item is NULL then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+            if ((items[i].key == NULL) ||
+                (items[i].scope == NULL) ||
+                (items[i].keyName == NULL))
+            {
+                LogError("Invalid Parameter to SASToken_CreateBatch. item %zu: key: %p, scope: %p, keyName: %p", i, items[i].key, items[i].scope, items[i].keyName);
+                result = __FAILURE__;
+                break;
+            }
+        }
+
+        if (result == 0)
+        {
+            SASTOKEN_BATCH_WORK* work;
+            HMACSHA256_BATCH_ITEM* hmacItems;
+
+            /*Codes_SRS_SASTOKEN_99_003: [ SASToken_CreateBatch shall allocate the working memory for all the items at once. ]*/
+            if ((work = (SASTOKEN_BATCH_WORK*)malloc(itemCount * sizeof(SASTOKEN_BATCH_WORK))) == NULL)
+            {
+                LogError("Unable to allocate memory to prepare SAS tokens.");
+                result = __FAILURE__;
+            }
+            else
+            {
+                if ((hmacItems = (HMACSHA256_BATCH_ITEM*)malloc(itemCount * sizeof(HMACSHA256_BATCH_ITEM))) == NULL)
+                {
+                    LogError("Unable to allocate memory to prepare SAS tokens.");
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    for (i = 0; i < itemCount; i++)
+                    {
+                        work[i].decodedKey = NULL;
+                        work[i].toBeHashed = NULL;
+                    }
+
+                    for (i = 0; (i < itemCount) && (result == 0); i++)
+                    {
+                        result = prepare_batch_item(&items[i], &work[i], &hmacItems[i]);
+                    }
+
+                    /*Codes_SRS_SASTOKEN_99_005: [ SASToken_CreateBatch shall compute all the HMAC-SHA256 hashes with one call to HMACSHA256_ComputeHashBatch. ]*/
+                    if ((result == 0) &&
+                        (HMACSHA256_ComputeHashBatch(hmacItems, itemCount) != HMACSHA256_OK))
+                    {
+                        LogError("Unable to compute the HMACs of the SAS tokens.");
+                        result = __FAILURE__;
+                    }
+
+                    for (i = 0; (i < itemCount) && (result == 0); i++)
+                    {
+                        if ((items[i].token = build_batch_token(&items[i], &work[i], &hmacItems[i])) == NULL)
+                        {
+                            result = __FAILURE__;
+                        }
+                    }
+
+                    for (i = 0; i < itemCount; i++)
+                    {
+                        /*Codes_SRS_SASTOKEN_99_007: [ If any failure occurs, SASToken_CreateBatch shall delete the tokens it created, set all the tokens to NULL and return a non-zero value. ]*/
+                        if ((result != 0) && (items[i].token != NULL))
+                        {
+                            STRING_delete(items[i].token);
+                            items[i].token = NULL;
+                        }
+                        if (work[i].toBeHashed != NULL)
+                        {
+                            STRING_delete(work[i].toBeHashed);
+                        }
+                        if (work[i].decodedKey != NULL)
+                        {
+                            BUFFER_delete(work[i].decodedKey);
+                        }
+                    }
+
+                    free(hmacItems);
+                }
+                free(work);
+            }
+        }
+    }
+
+    /*Codes_SRS_SASTOKEN_99_008: [ Otherwise SASToken_CreateBatch shall store each token in its item and return 0. ]*/
+    return result;
+}
@@ -75,6 +75,9 @@ static void SHA224_256Finalize(SHA256Context *context,
 static void SHA224_256PadMessage(SHA256Context *context,
     uint8_t Pad_Byte);
 static void SHA224_256ProcessMessageBlock(SHA256Context *context);
+static void SHA224_256ProcessBlocksPortable(uint32_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount);
+static SHA256ProcessBlocksFunction SHA224_256GetProcessBlocks(void);
 static int SHA224_256Reset(SHA256Context *context, uint32_t *H0);
 static int SHA224_256ResultN(SHA256Context *context,
     uint8_t Message_Digest[], int HashSize);
@@ -91,6 +94,13 @@ static uint32_t SHA256_H0[SHA256HashSize / 4] = {
     0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
 };
 
+/*
+ * The block function in use. It is picked on first use; concurrent
+ * first uses all store the same values.
+ */
+static SHA256ProcessBlocksFunction SHA224_256ProcessBlocks = NULL;
+static SHA256Implementation SHA224_256Implementation = sha256Portable;
+
 /*
 * SHA224Reset
 *
@@ -241,15 +251,31 @@ int SHA256Input(SHA256Context *context, const uint8_t *message_array,
     if (context->Corrupted)
         return context->Corrupted;
 
-    while (length-- && !context->Corrupted) {
-        context->Message_Block[context->Message_Block_Index++] =
-            (*message_array & 0xFF);
-
-        if (!SHA224_256AddLength(context, 8) &&
-            (context->Message_Block_Index == SHA256_Message_Block_Size))
-            SHA224_256ProcessMessageBlock(context);
-
-        message_array++;
+    while (length && !context->Corrupted) {
+        if ((context->Message_Block_Index == 0) &&
+            (length >= SHA256_Message_Block_Size)) {
+            /* hash the whole blocks straight from message_array */
+            unsigned int blockCount = length / SHA256_Message_Block_Size;
+            unsigned int processed = 0;
+            while ((processed < blockCount) &&
+                !SHA224_256AddLength(context, 8 * SHA256_Message_Block_Size))
+                processed++;
+
+            SHA224_256GetProcessBlocks()(context->Intermediate_Hash,
+                message_array, processed);
+            message_array += processed * SHA256_Message_Block_Size;
+            length -= processed * SHA256_Message_Block_Size;
+        } else {
+            context->Message_Block[context->Message_Block_Index++] =
+                (*message_array & 0xFF);
+
+            if (!SHA224_256AddLength(context, 8) &&
+                (context->Message_Block_Index == SHA256_Message_Block_Size))
+                SHA224_256ProcessMessageBlock(context);
+
+            message_array++;
+            length--;
+        }
     }
 
     return shaSuccess;
@@ -441,13 +467,41 @@ static void SHA224_256PadMessage(SHA256Context *context,
 *
 * Returns:
 *   Nothing.
+*/
+static void SHA224_256ProcessMessageBlock(SHA256Context *context)
+{
+    SHA224_256GetProcessBlocks()(context->Intermediate_Hash,
+        context->Message_Block, 1);
+
+    context->Message_Block_Index = 0;
+}
+
+/*
+* SHA224_256ProcessBlocksPortable
+*
+* Description:
+*   This function will process blockCount consecutive 512 bit
+*   blocks. It is the reference implementation, used when the CPU
+*   has no SHA-256 instructions.
+*
+* Parameters:
+*   Intermediate_Hash: [in/out]
+*     The intermediate hash to update
+*   blocks: [in]
+*     The message blocks
+*   blockCount: [in]
+*     The number of blocks
+*
+* Returns:
+*   Nothing.
 *
 * Comments:
 *   Many of the variable names in this code, especially the
 *   single character names, were used because those were the
 *   names used in the publication.
 */
-static void SHA224_256ProcessMessageBlock(SHA256Context *context)
+static void SHA224_256ProcessBlocksPortable(uint32_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount)
 {
     /* Constants defined in FIPS-180-2, section 4.2.2 */
     static const uint32_t K[64] = {
@@ -470,27 +524,28 @@ static void SHA224_256ProcessMessageBlock(SHA256Context *context)
     uint32_t   W[64];                   /* Word sequence */
     uint32_t   A, B, C, D, E, F, G, H;  /* Word buffers */
 
+    for (; blockCount > 0; blockCount--, blocks += SHA256_Message_Block_Size) {
     /*
     * Initialize the first 16 words in the array W
     */
     for (t = t4 = 0; t < 16; t++, t4 += 4)
-        W[t] = (((uint32_t)context->Message_Block[t4]) << 24) |
-        (((uint32_t)context->Message_Block[t4 + 1]) << 16) |
-        (((uint32_t)context->Message_Block[t4 + 2]) << 8) |
-        (((uint32_t)context->Message_Block[t4 + 3]));
+        W[t] = (((uint32_t)blocks[t4]) << 24) |
+        (((uint32_t)blocks[t4 + 1]) << 16) |
+        (((uint32_t)blocks[t4 + 2]) << 8) |
+        (((uint32_t)blocks[t4 + 3]));
 
     for (t = 16; t < 64; t++)
         W[t] = SHA256_sigma1(W[t - 2]) + W[t - 7] +
         SHA256_sigma0(W[t - 15]) + W[t - 16];
 
-    A = context->Intermediate_Hash[0];
-    B = context->Intermediate_Hash[1];
-    C = context->Intermediate_Hash[2];
-    D = context->Intermediate_Hash[3];
-    E = context->Intermediate_Hash[4];
-    F = context->Intermediate_Hash[5];
-    G = context->Intermediate_Hash[6];
-    H = context->Intermediate_Hash[7];
+    A = Intermediate_Hash[0];
+    B = Intermediate_Hash[1];
+    C = Intermediate_Hash[2];
+    D = Intermediate_Hash[3];
+    E = Intermediate_Hash[4];
+    F = Intermediate_Hash[5];
+    G = Intermediate_Hash[6];
+    H = Intermediate_Hash[7];
 
     for (t = 0; t < 64; t++) {
         temp1 = H + SHA256_SIGMA1(E) + SHA_Ch(E, F, G) + K[t] + W[t];
@@ -505,18 +560,110 @@ static void SHA224_256ProcessMessageBlock(SHA256Context *context)
         A = temp1 + temp2;
     }
 
-    context->Intermediate_Hash[0] += A;
-    context->Intermediate_Hash[1] += B;
-    context->Intermediate_Hash[2] += C;
-    context->Intermediate_Hash[3] += D;
-    context->Intermediate_Hash[4] += E;
-    context->Intermediate_Hash[5] += F;
-    context->Intermediate_Hash[6] += G;
-    context->Intermediate_Hash[7] += H;
+    Intermediate_Hash[0] += A;
+    Intermediate_Hash[1] += B;
+    Intermediate_Hash[2] += C;
+    Intermediate_Hash[3] += D;
+    Intermediate_Hash[4] += E;
+    Intermediate_Hash[5] += F;
+    Intermediate_Hash[6] += G;
+    Intermediate_Hash[7] += H;
+    }
+}
 
-    context->Message_Block_Index = 0;
+/*
+* SHA224_256GetProcessBlocks
+*
+* Description:
+*   This function returns the block function in use, picking the
+*   fastest one supported by the CPU the first time it is called.
+*
+* Returns:
+*   The block function.
+*/
+static SHA256ProcessBlocksFunction SHA224_256GetProcessBlocks(void)
+{
+    if (SHA224_256ProcessBlocks == NULL) {
+        SHA256ProcessBlocksFunction hardwareProcessBlocks;
+        if ((hardwareProcessBlocks = SHA256GetHardwareProcessBlocks(sha256X86ShaExtensions)) != NULL)
+            SHA224_256Implementation = sha256X86ShaExtensions;
+        else if ((hardwareProcessBlocks = SHA256GetHardwareProcessBlocks(sha256ArmV8Crypto)) != NULL)
+            SHA224_256Implementation = sha256ArmV8Crypto;
+        else
+            SHA224_256Implementation = sha256Portable;
+
+        SHA224_256ProcessBlocks = (hardwareProcessBlocks != NULL) ?
+            hardwareProcessBlocks : SHA224_256ProcessBlocksPortable;
+    }
+
+    return SHA224_256ProcessBlocks;
+}
+
+/*
+* SHA256IsImplementationSupported
+*
+* Description:
+*   This function tells whether an implementation of the block
+*   function can be used by this build on this CPU.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   1 if it is supported, 0 otherwise.
+*/
+int SHA256IsImplementationSupported(SHA256Implementation implementation)
+{
+    return ((implementation == sha256Portable) ||
+        (SHA256GetHardwareProcessBlocks(implementation) != NULL)) ? 1 : 0;
+}
+
+/*
+* SHA256SelectImplementation
+*
+* Description:
+*   This function forces the implementation of the block function
+*   used by all the SHA-224/SHA-256 contexts.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   sha Error Code.
+*/
+int SHA256SelectImplementation(SHA256Implementation implementation)
+{
+    SHA256ProcessBlocksFunction processBlocks;
+
+    if (implementation == sha256Portable)
+        processBlocks = SHA224_256ProcessBlocksPortable;
+    else if ((processBlocks = SHA256GetHardwareProcessBlocks(implementation)) == NULL)
+        return shaBadParam;
+
+    SHA224_256Implementation = implementation;
+    SHA224_256ProcessBlocks = processBlocks;
+    return shaSuccess;
 }
 
+/*
+* SHA256GetImplementation
+*
+* Description:
+*   This function returns the implementation of the block function
+*   in use.
+*
+* Returns:
+*   The implementation.
+*/
+SHA256Implementation SHA256GetImplementation(void)
+{
+    (void)SHA224_256GetProcessBlocks();
+    return SHA224_256Implementation;
+}
+
+
 /*
 * SHA224_256Reset
 *
@@ -0,0 +1,338 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*************************** sha256_batch.c ***************************/
+/*
+* Description:
+*   This file hashes several independent messages with SHA-256 at
+*   once. Each message is given a lane of a multi-buffer block
+*   function (sha256_hw.c); a lane that completes its message is
+*   refilled with the next one, so messages of different lengths
+*   keep all the lanes busy. The whole blocks of a message are
+*   hashed straight from the caller's buffer, the padded tail from
+*   a per lane copy.
+*
+*   When the CPU has no suitable vector unit the messages are hashed
+*   one after the other with SHA256Input, which still uses the SHA
+*   instructions when the CPU has them.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "azure_c_shared_utility/sha.h"
+#include "azure_c_shared_utility/sha-private.h"
+
+#define SHA256_MAX_LANES 16
+
+/* Initial Hash Values: FIPS-180-2 section 5.3.2 */
+static const uint32_t SHA256_H0[SHA256HashSize / 4] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+/* What idle lanes hash; nobody reads the result */
+static const uint8_t SHA256IdleBlock[SHA256_Message_Block_Size] = { 0 };
+
+/*
+ * The lane function in use. It is picked on first use; concurrent
+ * first uses all store the same values.
+ */
+static int SHA256BatchInitialized = 0;
+static SHA256BatchImplementation SHA256BatchImplementationInUse = sha256BatchSerial;
+static SHA256ProcessLanesFunction SHA256BatchProcessLanes = NULL;
+static size_t SHA256BatchLaneCount = 1;
+
+/* The progress of the message hashed in a lane */
+typedef struct SHA256Lane {
+    const SHA256BatchJob *job;
+    size_t block;                       /* next block to hash */
+    size_t prefixBlocks;                /* 0 or 1 */
+    size_t dataBlocks;                  /* whole blocks of data */
+    size_t blockCount;                  /* all the blocks, padding included */
+    uint8_t tail[2 * SHA256_Message_Block_Size];
+} SHA256Lane;
+
+/*
+* SHA256BatchInitialize
+*
+* Description:
+*   This function picks the widest multi-buffer implementation
+*   supported by the CPU, the first time it is called.
+*/
+static void SHA256BatchInitialize(void)
+{
+    if (!SHA256BatchInitialized) {
+        if (SHA256BatchSelectImplementation(sha256BatchAvx512) != shaSuccess &&
+            SHA256BatchSelectImplementation(sha256BatchAvx2) != shaSuccess)
+            (void)SHA256BatchSelectImplementation(sha256BatchSerial);
+    }
+}
+
+/*
+* SHA256LaneStart
+*
+* Description:
+*   This function assigns a message to a lane: it resets the lane's
+*   intermediate hash and prepares the padded tail of the message.
+*/
+static void SHA256LaneStart(SHA256Lane *lane, uint32_t *state,
+    size_t laneIndex, size_t laneCount, const SHA256BatchJob *job)
+{
+    size_t remainder = job->length % SHA256_Message_Block_Size;
+    size_t tailBlocks = (remainder + 9 > SHA256_Message_Block_Size) ? 2 : 1;
+    uint64_t bitLength;
+    size_t i;
+
+    lane->job = job;
+    lane->block = 0;
+    lane->prefixBlocks = (job->prefix != NULL) ? 1 : 0;
+    lane->dataBlocks = job->length / SHA256_Message_Block_Size;
+    lane->blockCount = lane->prefixBlocks + lane->dataBlocks + tailBlocks;
+
+    /* the remaining bytes, a 1 bit, zeroes and the length in bits */
+    if (remainder > 0)
+        (void)memcpy(lane->tail, job->data + lane->dataBlocks * SHA256_Message_Block_Size, remainder);
+    lane->tail[remainder] = 0x80;
+    (void)memset(lane->tail + remainder + 1, 0,
+        tailBlocks * SHA256_Message_Block_Size - remainder - 1);
+    bitLength = ((uint64_t)lane->prefixBlocks * SHA256_Message_Block_Size + job->length) * 8;
+    for (i = 0; i < 8; i++)
+        lane->tail[tailBlocks * SHA256_Message_Block_Size - 1 - i] = (uint8_t)(bitLength >> (8 * i));
+
+    for (i = 0; i < SHA256HashSize / 4; i++)
+        state[i * laneCount + laneIndex] = SHA256_H0[i];
+}
+
+/*
+* SHA256LaneBlock
+*
+* Description:
+*   This function returns the next block a lane hashes.
+*/
+static const uint8_t *SHA256LaneBlock(const SHA256Lane *lane)
+{
+    const uint8_t *result;
+    size_t block = lane->block;
+
+    if (block < lane->prefixBlocks) {
+        result = lane->job->prefix;
+    } else if ((block -= lane->prefixBlocks) < lane->dataBlocks) {
+        result = lane->job->data + block * SHA256_Message_Block_Size;
+    } else {
+        result = lane->tail + (block - lane->dataBlocks) * SHA256_Message_Block_Size;
+    }
+
+    return result;
+}
+
+/*
+* SHA256ProcessBatchSerial
+*
+* Description:
+*   This function hashes the messages one after the other.
+*/
+static int SHA256ProcessBatchSerial(const SHA256BatchJob *jobs, size_t jobCount)
+{
+    int result = shaSuccess;
+    size_t i;
+
+    for (i = 0; (i < jobCount) && (result == shaSuccess); i++) {
+        SHA256Context context;
+        result = SHA256Reset(&context) ||
+            ((jobs[i].prefix != NULL) &&
+                SHA256Input(&context, jobs[i].prefix, SHA256_Message_Block_Size)) ||
+            SHA256Input(&context, jobs[i].data, (unsigned int)jobs[i].length) ||
+            SHA256Result(&context, jobs[i].digest);
+    }
+
+    return result;
+}
+
+/*
+* SHA256ProcessBatch
+*
+* Description:
+*   This function computes the digests of jobCount messages.
+*
+* Parameters:
+*   jobs: [in]
+*     The messages and where to write their digests.
+*   jobCount: [in]
+*     The number of messages.
+*
+* Returns:
+*   sha Error Code.
+*/
+int SHA256ProcessBatch(const SHA256BatchJob *jobs, size_t jobCount)
+{
+    int result;
+
+    SHA256BatchInitialize();
+
+    if ((jobCount < 2) || (SHA256BatchProcessLanes == NULL)) {
+        result = SHA256ProcessBatchSerial(jobs, jobCount);
+    } else {
+        SHA256ProcessLanesFunction processLanes = SHA256BatchProcessLanes;
+        size_t laneCount = SHA256BatchLaneCount;
+        SHA256Lane lanes[SHA256_MAX_LANES];
+        uint32_t state[(SHA256HashSize / 4) * SHA256_MAX_LANES];
+        const uint8_t *blocks[SHA256_MAX_LANES];
+        size_t nextJob = 0;
+        size_t activeLanes = 0;
+        size_t i, j;
+
+        for (i = 0; i < laneCount; i++) {
+            if (nextJob < jobCount) {
+                SHA256LaneStart(&lanes[i], state, i, laneCount, &jobs[nextJob++]);
+                activeLanes++;
+            } else {
+                lanes[i].job = NULL;
+            }
+        }
+
+        while (activeLanes > 0) {
+            for (i = 0; i < laneCount; i++) {
+                blocks[i] = (lanes[i].job != NULL) ? SHA256LaneBlock(&lanes[i]) : SHA256IdleBlock;
+            }
+
+            processLanes(state, blocks);
+
+            for (i = 0; i < laneCount; i++) {
+                if ((lanes[i].job != NULL) && (++lanes[i].block == lanes[i].blockCount)) {
+                    for (j = 0; j < SHA256HashSize; j++)
+                        lanes[i].job->digest[j] =
+                            (uint8_t)(state[(j >> 2) * laneCount + i] >> (8 * (3 - (j & 0x03))));
+
+                    if (nextJob < jobCount) {
+                        SHA256LaneStart(&lanes[i], state, i, laneCount, &jobs[nextJob++]);
+                    } else {
+                        lanes[i].job = NULL;
+                        activeLanes--;
+                    }
+                }
+            }
+        }
+
+        result = shaSuccess;
+    }
+
+    return result;
+}
+
+/*
+* SHA256HashBatch
+*
+* Description:
+*   This function computes the SHA-256 digests of messageCount
+*   independent messages.
+*
+* Parameters:
+*   messages: [in]
+*     The messages.
+*   lengths: [in]
+*     The length of each message.
+*   messageCount: [in]
+*     The number of messages.
+*   digests: [out]
+*     Where the digest of each message is returned.
+*
+* Returns:
+*   sha Error Code.
+*/
+int SHA256HashBatch(const uint8_t *const messages[],
+    const unsigned int lengths[], size_t messageCount,
+    uint8_t digests[][SHA256HashSize])
+{
+    int result = shaSuccess;
+    SHA256BatchJob jobs[SHA256_MAX_LANES * 4];
+    size_t i, j;
+
+    if (messageCount == 0)
+        return shaSuccess;
+
+    if (!messages || !lengths || !digests)
+        return shaNull;
+
+    for (i = 0; i < messageCount; i++)
+        if (!messages[i] && lengths[i])
+            return shaNull;
+
+    /* several lane fills per chunk so that lanes get refilled */
+    for (i = 0; (i < messageCount) && (result == shaSuccess); i += j) {
+        for (j = 0; (j < sizeof(jobs) / sizeof(jobs[0])) && (i + j < messageCount); j++) {
+            jobs[j].prefix = NULL;
+            jobs[j].data = messages[i + j];
+            jobs[j].length = lengths[i + j];
+            jobs[j].digest = digests[i + j];
+        }
+        result = SHA256ProcessBatch(jobs, j);
+    }
+
+    return result;
+}
+
+/*
+* SHA256BatchIsImplementationSupported
+*
+* Description:
+*   This function tells whether a multi-buffer implementation can
+*   be used by this build on this CPU.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   1 if it is supported, 0 otherwise.
+*/
+int SHA256BatchIsImplementationSupported(SHA256BatchImplementation implementation)
+{
+    size_t laneCount;
+    return ((implementation == sha256BatchSerial) ||
+        (SHA256GetHardwareProcessLanes(implementation, &laneCount) != NULL)) ? 1 : 0;
+}
+
+/*
+* SHA256BatchSelectImplementation
+*
+* Description:
+*   This function forces the multi-buffer implementation used by
+*   SHA256HashBatch and the batch HMAC.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   sha Error Code.
+*/
+int SHA256BatchSelectImplementation(SHA256BatchImplementation implementation)
+{
+    SHA256ProcessLanesFunction processLanes = NULL;
+    size_t laneCount = 1;
+
+    if ((implementation != sha256BatchSerial) &&
+        ((processLanes = SHA256GetHardwareProcessLanes(implementation, &laneCount)) == NULL))
+        return shaBadParam;
+
+    SHA256BatchImplementationInUse = implementation;
+    SHA256BatchProcessLanes = processLanes;
+    SHA256BatchLaneCount = laneCount;
+    SHA256BatchInitialized = 1;
+    return shaSuccess;
+}
+
+/*
+* SHA256BatchGetImplementation
+*
+* Description:
+*   This function returns the multi-buffer implementation in use.
+*
+* Returns:
+*   The implementation.
+*/
+SHA256BatchImplementation SHA256BatchGetImplementation(void)
+{
+    SHA256BatchInitialize();
+    return SHA256BatchImplementationInUse;
+}
@@ -0,0 +1,571 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*************************** sha256_hw.c ***************************/
+/*
+* Description:
+*   This file implements the SHA-224/SHA-256 block function with
+*   the SHA-256 instructions found in recent CPUs:
+*     - the Intel SHA extensions (x86 and x64),
+*     - the ARMv8 cryptographic extension (AArch64).
+*
+*   It also implements multi-buffer block functions that hash one
+*   block of 8 (AVX2) or 16 (AVX-512F) independent messages at once,
+*   one message per 32 bit vector lane.
+*
+*   Each implementation is only compiled when the compiler can
+*   generate the instructions, and is only handed out by
+*   SHA256GetHardwareProcessBlocks/SHA256GetHardwareProcessLanes when
+*   the CPU running the code supports them. sha224.c and
+*   sha256_batch.c fall back to the RFC 4634 reference code
+*   otherwise.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "azure_c_shared_utility/sha.h"
+#include "azure_c_shared_utility/sha-private.h"
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && \
+    ((defined(__GNUC__) && !defined(__clang__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || \
+     (defined(__clang__) && ((__clang_major__ > 3) || ((__clang_major__ == 3) && (__clang_minor__ >= 4)))) || \
+     (defined(_MSC_VER) && (_MSC_VER >= 1900)))
+#define SHA256_HAS_X86_SHA_EXTENSIONS
+#define SHA256_HAS_X86_AVX2
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && \
+    ((defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 5)) || \
+     (defined(__clang__) && (__clang_major__ >= 4)) || \
+     (defined(_MSC_VER) && (_MSC_VER >= 1910)))
+#define SHA256_HAS_X86_AVX512
+#endif
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA256_HAS_ARMV8_CRYPTO
+#endif
+
+#if defined(SHA256_HAS_X86_SHA_EXTENSIONS) || defined(SHA256_HAS_X86_AVX2) || \
+    defined(SHA256_HAS_X86_AVX512) || defined(SHA256_HAS_ARMV8_CRYPTO)
+/* Constants defined in FIPS-180-2, section 4.2.2 */
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b,
+    0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+    0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+    0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152,
+    0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
+    0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
+    0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+    0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+#if defined(SHA256_HAS_X86_SHA_EXTENSIONS) || defined(SHA256_HAS_X86_AVX2) || \
+    defined(SHA256_HAS_X86_AVX512)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SHA256_X86_TARGET(features)
+#else
+#include <cpuid.h>
+#define SHA256_X86_TARGET(features) __attribute__((target(features)))
+#endif
+
+#define SHA256_X86_ECX1_SSSE3        (1u << 9)
+#define SHA256_X86_ECX1_SSE4_1       (1u << 19)
+#define SHA256_X86_ECX1_OSXSAVE      (1u << 27)
+#define SHA256_X86_ECX1_AVX          (1u << 28)
+#define SHA256_X86_EBX7_AVX2         (1u << 5)
+#define SHA256_X86_EBX7_AVX512F      (1u << 16)
+#define SHA256_X86_EBX7_SHA          (1u << 29)
+#define SHA256_X86_XCR0_YMM          0x06u  /* SSE and AVX state */
+#define SHA256_X86_XCR0_ZMM          0xE6u  /* and opmask and ZMM state */
+
+/*
+* SHA256X86GetFeatures
+*
+* Description:
+*   This function reads the CPUID feature flags used here: ECX of
+*   leaf 1, EBX of leaf 7 and, when the OS saves the extended
+*   states, XCR0.
+*/
+static void SHA256X86GetFeatures(unsigned int *ecx1, unsigned int *ebx7,
+    unsigned int *xcr0)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        *ecx1 = *ebx7 = *xcr0 = 0;
+        return;
+    }
+    __cpuid(info, 1);
+    *ecx1 = (unsigned int)info[2];
+    __cpuidex(info, 7, 0);
+    *ebx7 = (unsigned int)info[1];
+    *xcr0 = ((*ecx1 & SHA256_X86_ECX1_OSXSAVE) != 0) ? (unsigned int)_xgetbv(0) : 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, NULL) < 7) {
+        *ecx1 = *ebx7 = *xcr0 = 0;
+        return;
+    }
+    __cpuid_count(1, 0, eax, ebx, ecx, edx);
+    *ecx1 = ecx;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    *ebx7 = ebx;
+    if ((*ecx1 & SHA256_X86_ECX1_OSXSAVE) != 0) {
+        /* xgetbv, spelled out for assemblers that do not know it */
+        __asm__ volatile (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+        *xcr0 = eax;
+    } else {
+        *xcr0 = 0;
+    }
+#endif
+}
+#endif
+
+#ifdef SHA256_HAS_X86_SHA_EXTENSIONS
+/*
+* SHA256X86ShaExtensionsSupported
+*
+* Description:
+*   This function tells whether the CPU has the SHA extensions and
+*   the SSSE3 and SSE4.1 instructions used along with them.
+*/
+static int SHA256X86ShaExtensionsSupported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+    SHA256X86GetFeatures(&ecx1, &ebx7, &xcr0);
+
+    return ((ebx7 & SHA256_X86_EBX7_SHA) != 0) &&
+        ((ecx1 & SHA256_X86_ECX1_SSSE3) != 0) &&
+        ((ecx1 & SHA256_X86_ECX1_SSE4_1) != 0);
+}
+
+/*
+* SHA256X86ProcessBlocks
+*
+* Description:
+*   This function will process blockCount consecutive 512 bit
+*   blocks with the SHA256RNDS2, SHA256MSG1 and SHA256MSG2
+*   instructions. Each SHA256RNDS2 performs two rounds; the message
+*   schedule is computed four words at a time, interleaved with the
+*   rounds that consume it.
+*/
+SHA256_X86_TARGET("sha,sse4.1,ssse3")
+static void SHA256X86ProcessBlocks(uint32_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount)
+{
+    const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i STATE0, STATE1, ABEF_SAVE, CDGH_SAVE, MSG, TMP;
+    __m128i M[4];
+    int g;
+
+    /* load the state as ABEF and CDGH, the layout SHA256RNDS2 uses */
+    TMP = _mm_loadu_si128((const __m128i*)&Intermediate_Hash[0]);
+    STATE1 = _mm_loadu_si128((const __m128i*)&Intermediate_Hash[4]);
+    TMP = _mm_shuffle_epi32(TMP, 0xB1);          /* CDAB */
+    STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);    /* EFGH */
+    STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);    /* ABEF */
+    STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); /* CDGH */
+
+    for (; blockCount > 0; blockCount--, blocks += SHA256_Message_Block_Size) {
+        ABEF_SAVE = STATE0;
+        CDGH_SAVE = STATE1;
+
+        for (g = 0; g < 4; g++)
+            M[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 16 * g)), MASK);
+
+        for (g = 0; g < 16; g++) {
+            MSG = _mm_add_epi32(M[g & 3], _mm_loadu_si128((const __m128i*)&SHA256_K[4 * g]));
+            STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+
+            /* W[4g+16..4g+19], needed 4 groups from now */
+            if ((g >= 3) && (g <= 14)) {
+                TMP = _mm_alignr_epi8(M[g & 3], M[(g - 1) & 3], 4);
+                M[(g + 1) & 3] = _mm_add_epi32(M[(g + 1) & 3], TMP);
+                M[(g + 1) & 3] = _mm_sha256msg2_epu32(M[(g + 1) & 3], M[g & 3]);
+            }
+
+            MSG = _mm_shuffle_epi32(MSG, 0x0E);
+            STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+
+            if ((g >= 1) && (g <= 12))
+                M[(g - 1) & 3] = _mm_sha256msg1_epu32(M[(g - 1) & 3], M[g & 3]);
+        }
+
+        STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+        STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+    }
+
+    /* back to ABCD and EFGH */
+    TMP = _mm_shuffle_epi32(STATE0, 0x1B);       /* FEBA */
+    STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);    /* DCHG */
+    STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0); /* DCBA */
+    STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);    /* HGFE */
+
+    _mm_storeu_si128((__m128i*)&Intermediate_Hash[0], STATE0);
+    _mm_storeu_si128((__m128i*)&Intermediate_Hash[4], STATE1);
+}
+#endif /* SHA256_HAS_X86_SHA_EXTENSIONS */
+
+/*
+* The multi-buffer block functions run the FIPS-180-2 rounds on
+* vectors holding the same word of 8 or 16 messages. The message
+* words are transposed into that layout through a small buffer.
+*/
+#define SHA256_LOAD_BE32(p) \
+    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+     ((uint32_t)(p)[2] << 8) | ((uint32_t)(p)[3]))
+
+#ifdef SHA256_HAS_X86_AVX2
+#define SHA256_AVX2_LANES 8
+
+#define AVX2_ROTR(x, n)  _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define AVX2_XOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256((x), (y)), (z))
+#define AVX2_SIGMA0(x)   AVX2_XOR3(AVX2_ROTR((x), 2), AVX2_ROTR((x), 13), AVX2_ROTR((x), 22))
+#define AVX2_SIGMA1(x)   AVX2_XOR3(AVX2_ROTR((x), 6), AVX2_ROTR((x), 11), AVX2_ROTR((x), 25))
+#define AVX2_sigma0(x)   AVX2_XOR3(AVX2_ROTR((x), 7), AVX2_ROTR((x), 18), _mm256_srli_epi32((x), 3))
+#define AVX2_sigma1(x)   AVX2_XOR3(AVX2_ROTR((x), 17), AVX2_ROTR((x), 19), _mm256_srli_epi32((x), 10))
+#define AVX2_Ch(x, y, z) _mm256_xor_si256(_mm256_and_si256((x), (y)), _mm256_andnot_si256((x), (z)))
+#define AVX2_Maj(x, y, z) _mm256_or_si256(_mm256_and_si256((x), (y)), _mm256_and_si256((z), _mm256_or_si256((x), (y))))
+
+/*
+* SHA256X86Avx2Supported
+*
+* Description:
+*   This function tells whether the CPU has AVX2 and the OS saves
+*   the YMM registers.
+*/
+static int SHA256X86Avx2Supported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+    SHA256X86GetFeatures(&ecx1, &ebx7, &xcr0);
+
+    return ((ecx1 & SHA256_X86_ECX1_AVX) != 0) &&
+        ((ebx7 & SHA256_X86_EBX7_AVX2) != 0) &&
+        ((xcr0 & SHA256_X86_XCR0_YMM) == SHA256_X86_XCR0_YMM);
+}
+
+/*
+* SHA256X86Avx2ProcessLanes
+*
+* Description:
+*   This function will process one 512 bit block of 8 messages.
+*/
+SHA256_X86_TARGET("avx2")
+static void SHA256X86Avx2ProcessLanes(uint32_t *state,
+    const uint8_t *const blocks[])
+{
+    uint32_t transposed[16][SHA256_AVX2_LANES];
+    __m256i W[16];
+    __m256i A, B, C, D, E, F, G, H, temp1, temp2;
+    int t, lane;
+
+    for (t = 0; t < 16; t++)
+        for (lane = 0; lane < SHA256_AVX2_LANES; lane++)
+            transposed[t][lane] = SHA256_LOAD_BE32(blocks[lane] + 4 * t);
+
+    A = _mm256_loadu_si256((const __m256i*)&state[0 * SHA256_AVX2_LANES]);
+    B = _mm256_loadu_si256((const __m256i*)&state[1 * SHA256_AVX2_LANES]);
+    C = _mm256_loadu_si256((const __m256i*)&state[2 * SHA256_AVX2_LANES]);
+    D = _mm256_loadu_si256((const __m256i*)&state[3 * SHA256_AVX2_LANES]);
+    E = _mm256_loadu_si256((const __m256i*)&state[4 * SHA256_AVX2_LANES]);
+    F = _mm256_loadu_si256((const __m256i*)&state[5 * SHA256_AVX2_LANES]);
+    G = _mm256_loadu_si256((const __m256i*)&state[6 * SHA256_AVX2_LANES]);
+    H = _mm256_loadu_si256((const __m256i*)&state[7 * SHA256_AVX2_LANES]);
+
+    for (t = 0; t < 64; t++) {
+        if (t < 16)
+            W[t] = _mm256_loadu_si256((const __m256i*)transposed[t]);
+        else
+            W[t & 15] = _mm256_add_epi32(
+                _mm256_add_epi32(AVX2_sigma1(W[(t - 2) & 15]), W[(t - 7) & 15]),
+                _mm256_add_epi32(AVX2_sigma0(W[(t - 15) & 15]), W[t & 15]));
+
+        temp1 = _mm256_add_epi32(
+            _mm256_add_epi32(H, AVX2_SIGMA1(E)),
+            _mm256_add_epi32(AVX2_Ch(E, F, G),
+                _mm256_add_epi32(_mm256_set1_epi32((int)SHA256_K[t]), W[t & 15])));
+        temp2 = _mm256_add_epi32(AVX2_SIGMA0(A), AVX2_Maj(A, B, C));
+        H = G;
+        G = F;
+        F = E;
+        E = _mm256_add_epi32(D, temp1);
+        D = C;
+        C = B;
+        B = A;
+        A = _mm256_add_epi32(temp1, temp2);
+    }
+
+#define AVX2_ADD_STATE(i, X) \
+    _mm256_storeu_si256((__m256i*)&state[(i) * SHA256_AVX2_LANES], \
+        _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)&state[(i) * SHA256_AVX2_LANES]), (X)))
+    AVX2_ADD_STATE(0, A);
+    AVX2_ADD_STATE(1, B);
+    AVX2_ADD_STATE(2, C);
+    AVX2_ADD_STATE(3, D);
+    AVX2_ADD_STATE(4, E);
+    AVX2_ADD_STATE(5, F);
+    AVX2_ADD_STATE(6, G);
+    AVX2_ADD_STATE(7, H);
+#undef AVX2_ADD_STATE
+}
+#endif /* SHA256_HAS_X86_AVX2 */
+
+#ifdef SHA256_HAS_X86_AVX512
+#define SHA256_AVX512_LANES 16
+
+/* 0x96 is x ^ y ^ z, 0xCA is x ? y : z, 0xE8 is the majority */
+#define AVX512_XOR3(x, y, z) _mm512_ternarylogic_epi32((x), (y), (z), 0x96)
+#define AVX512_SIGMA0(x) AVX512_XOR3(_mm512_ror_epi32((x), 2), _mm512_ror_epi32((x), 13), _mm512_ror_epi32((x), 22))
+#define AVX512_SIGMA1(x) AVX512_XOR3(_mm512_ror_epi32((x), 6), _mm512_ror_epi32((x), 11), _mm512_ror_epi32((x), 25))
+#define AVX512_sigma0(x) AVX512_XOR3(_mm512_ror_epi32((x), 7), _mm512_ror_epi32((x), 18), _mm512_srli_epi32((x), 3))
+#define AVX512_sigma1(x) AVX512_XOR3(_mm512_ror_epi32((x), 17), _mm512_ror_epi32((x), 19), _mm512_srli_epi32((x), 10))
+#define AVX512_Ch(x, y, z)  _mm512_ternarylogic_epi32((x), (y), (z), 0xCA)
+#define AVX512_Maj(x, y, z) _mm512_ternarylogic_epi32((x), (y), (z), 0xE8)
+
+/*
+* SHA256X86Avx512Supported
+*
+* Description:
+*   This function tells whether the CPU has AVX-512F and the OS
+*   saves the opmask and ZMM registers.
+*/
+static int SHA256X86Avx512Supported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+    SHA256X86GetFeatures(&ecx1, &ebx7, &xcr0);
+
+    return ((ebx7 & SHA256_X86_EBX7_AVX512F) != 0) &&
+        ((xcr0 & SHA256_X86_XCR0_ZMM) == SHA256_X86_XCR0_ZMM);
+}
+
+/*
+* SHA256X86Avx512ProcessLanes
+*
+* Description:
+*   This function will process one 512 bit block of 16 messages.
+*/
+SHA256_X86_TARGET("avx512f")
+static void SHA256X86Avx512ProcessLanes(uint32_t *state,
+    const uint8_t *const blocks[])
+{
+    uint32_t transposed[16][SHA256_AVX512_LANES];
+    __m512i W[16];
+    __m512i A, B, C, D, E, F, G, H, temp1, temp2;
+    int t, lane;
+
+    for (t = 0; t < 16; t++)
+        for (lane = 0; lane < SHA256_AVX512_LANES; lane++)
+            transposed[t][lane] = SHA256_LOAD_BE32(blocks[lane] + 4 * t);
+
+    A = _mm512_loadu_si512(&state[0 * SHA256_AVX512_LANES]);
+    B = _mm512_loadu_si512(&state[1 * SHA256_AVX512_LANES]);
+    C = _mm512_loadu_si512(&state[2 * SHA256_AVX512_LANES]);
+    D = _mm512_loadu_si512(&state[3 * SHA256_AVX512_LANES]);
+    E = _mm512_loadu_si512(&state[4 * SHA256_AVX512_LANES]);
+    F = _mm512_loadu_si512(&state[5 * SHA256_AVX512_LANES]);
+    G = _mm512_loadu_si512(&state[6 * SHA256_AVX512_LANES]);
+    H = _mm512_loadu_si512(&state[7 * SHA256_AVX512_LANES]);
+
+    for (t = 0; t < 64; t++) {
+        if (t < 16)
+            W[t] = _mm512_loadu_si512(transposed[t]);
+        else
+            W[t & 15] = _mm512_add_epi32(
+                _mm512_add_epi32(AVX512_sigma1(W[(t - 2) & 15]), W[(t - 7) & 15]),
+                _mm512_add_epi32(AVX512_sigma0(W[(t - 15) & 15]), W[t & 15]));
+
+        temp1 = _mm512_add_epi32(
+            _mm512_add_epi32(H, AVX512_SIGMA1(E)),
+            _mm512_add_epi32(AVX512_Ch(E, F, G),
+                _mm512_add_epi32(_mm512_set1_epi32((int)SHA256_K[t]), W[t & 15])));
+        temp2 = _mm512_add_epi32(AVX512_SIGMA0(A), AVX512_Maj(A, B, C));
+        H = G;
+        G = F;
+        F = E;
+        E = _mm512_add_epi32(D, temp1);
+        D = C;
+        C = B;
+        B = A;
+        A = _mm512_add_epi32(temp1, temp2);
+    }
+
+#define AVX512_ADD_STATE(i, X) \
+    _mm512_storeu_si512(&state[(i) * SHA256_AVX512_LANES], \
+        _mm512_add_epi32(_mm512_loadu_si512(&state[(i) * SHA256_AVX512_LANES]), (X)))
+    AVX512_ADD_STATE(0, A);
+    AVX512_ADD_STATE(1, B);
+    AVX512_ADD_STATE(2, C);
+    AVX512_ADD_STATE(3, D);
+    AVX512_ADD_STATE(4, E);
+    AVX512_ADD_STATE(5, F);
+    AVX512_ADD_STATE(6, G);
+    AVX512_ADD_STATE(7, H);
+#undef AVX512_ADD_STATE
+}
+#endif /* SHA256_HAS_X86_AVX512 */
+
+#ifdef SHA256_HAS_ARMV8_CRYPTO
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+/*
+* SHA256ArmV8CryptoSupported
+*
+* Description:
+*   This function tells whether the CPU has the SHA-256 instructions
+*   of the ARMv8 cryptographic extension.
+*/
+static int SHA256ArmV8CryptoSupported(void)
+{
+#if defined(__APPLE__)
+    /* every 64 bit Apple CPU has them */
+    return 1;
+#elif defined(__linux__) && defined(HWCAP_SHA2)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+    /* the compiler was told to assume them */
+    return 1;
+#endif
+}
+
+/*
+* SHA256ArmV8ProcessBlocks
+*
+* Description:
+*   This function will process blockCount consecutive 512 bit
+*   blocks with the SHA256H, SHA256H2, SHA256SU0 and SHA256SU1
+*   instructions. Each SHA256H/SHA256H2 pair performs four rounds.
+*/
+static void SHA256ArmV8ProcessBlocks(uint32_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount)
+{
+    uint32x4_t STATE0, STATE1, ABCD_SAVE, EFGH_SAVE, WK, TMP;
+    uint32x4_t M[4];
+    int g;
+
+    STATE0 = vld1q_u32(&Intermediate_Hash[0]);
+    STATE1 = vld1q_u32(&Intermediate_Hash[4]);
+
+    for (; blockCount > 0; blockCount--, blocks += SHA256_Message_Block_Size) {
+        ABCD_SAVE = STATE0;
+        EFGH_SAVE = STATE1;
+
+        for (g = 0; g < 4; g++)
+            M[g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 16 * g)));
+
+        for (g = 0; g < 16; g++) {
+            WK = vaddq_u32(M[g & 3], vld1q_u32(&SHA256_K[4 * g]));
+
+            /* W[4g+16..4g+19] replace W[4g..4g+3] */
+            if (g < 12)
+                M[g & 3] = vsha256su1q_u32(vsha256su0q_u32(M[g & 3], M[(g + 1) & 3]),
+                    M[(g + 2) & 3], M[(g + 3) & 3]);
+
+            TMP = STATE0;
+            STATE0 = vsha256hq_u32(STATE0, STATE1, WK);
+            STATE1 = vsha256h2q_u32(STATE1, TMP, WK);
+        }
+
+        STATE0 = vaddq_u32(STATE0, ABCD_SAVE);
+        STATE1 = vaddq_u32(STATE1, EFGH_SAVE);
+    }
+
+    vst1q_u32(&Intermediate_Hash[0], STATE0);
+    vst1q_u32(&Intermediate_Hash[4], STATE1);
+}
+#endif /* SHA256_HAS_ARMV8_CRYPTO */
+
+/*
+* SHA256GetHardwareProcessBlocks
+*
+* Description:
+*   This function returns the block function of a hardware
+*   implementation.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   The block function, or NULL if this build or this CPU does not
+*   support the implementation.
+*/
+SHA256ProcessBlocksFunction SHA256GetHardwareProcessBlocks(SHA256Implementation implementation)
+{
+    SHA256ProcessBlocksFunction result;
+
+    switch (implementation)
+    {
+#ifdef SHA256_HAS_X86_SHA_EXTENSIONS
+    case sha256X86ShaExtensions:
+        result = SHA256X86ShaExtensionsSupported() ? SHA256X86ProcessBlocks : NULL;
+        break;
+#endif
+#ifdef SHA256_HAS_ARMV8_CRYPTO
+    case sha256ArmV8Crypto:
+        result = SHA256ArmV8CryptoSupported() ? SHA256ArmV8ProcessBlocks : NULL;
+        break;
+#endif
+    default:
+        result = NULL;
+        break;
+    }
+
+    return result;
+}
+
+/*
+* SHA256GetHardwareProcessLanes
+*
+* Description:
+*   This function returns the multi-buffer block function of an
+*   implementation.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*   laneCount: [out]
+*     The number of messages the block function hashes at once.
+*
+* Returns:
+*   The block function, or NULL if this build or this CPU does not
+*   support the implementation.
+*/
+SHA256ProcessLanesFunction SHA256GetHardwareProcessLanes(SHA256BatchImplementation implementation, size_t *laneCount)
+{
+    SHA256ProcessLanesFunction result;
+
+    switch (implementation)
+    {
+#ifdef SHA256_HAS_X86_AVX2
+    case sha256BatchAvx2:
+        result = SHA256X86Avx2Supported() ? SHA256X86Avx2ProcessLanes : NULL;
+        *laneCount = SHA256_AVX2_LANES;
+        break;
+#endif
+#ifdef SHA256_HAS_X86_AVX512
+    case sha256BatchAvx512:
+        result = SHA256X86Avx512Supported() ? SHA256X86Avx512ProcessLanes : NULL;
+        *laneCount = SHA256_AVX512_LANES;
+        break;
+#endif
+    default:
+        result = NULL;
+        *laneCount = 1;
+        break;
+    }
+
+    return result;
+}
@@ -306,6 +306,11 @@ static void SHA384_512Finalize(SHA512Context *context,
 static void SHA384_512PadMessage(SHA512Context *context,
     uint8_t Pad_Byte);
 static void SHA384_512ProcessMessageBlock(SHA512Context *context);
+static void SHA384_512ProcessBlocksPortable(uint64_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount);
+static void SHA384_512ProcessBlocksUnrolled(uint64_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount);
+static SHA512ProcessBlocksFunction SHA384_512GetProcessBlocks(void);
 static int SHA384_512Reset(SHA512Context *context, uint64_t H0[]);
 static int SHA384_512ResultN(SHA512Context *context,
     uint8_t Message_Digest[], int HashSize);
@@ -322,6 +327,52 @@ static uint64_t SHA512_H0[] = {
     0x1F83D9ABFB41BD6Bull, 0x5BE0CD19137E2179ull
 };
 
+/* Constants defined in FIPS-180-2, section 4.2.3 */
+static const uint64_t SHA512_K[80] = {
+    0x428A2F98D728AE22ull, 0x7137449123EF65CDull, 0xB5C0FBCFEC4D3B2Full,
+    0xE9B5DBA58189DBBCull, 0x3956C25BF348B538ull, 0x59F111F1B605D019ull,
+    0x923F82A4AF194F9Bull, 0xAB1C5ED5DA6D8118ull, 0xD807AA98A3030242ull,
+    0x12835B0145706FBEull, 0x243185BE4EE4B28Cull, 0x550C7DC3D5FFB4E2ull,
+    0x72BE5D74F27B896Full, 0x80DEB1FE3B1696B1ull, 0x9BDC06A725C71235ull,
+    0xC19BF174CF692694ull, 0xE49B69C19EF14AD2ull, 0xEFBE4786384F25E3ull,
+    0x0FC19DC68B8CD5B5ull, 0x240CA1CC77AC9C65ull, 0x2DE92C6F592B0275ull,
+    0x4A7484AA6EA6E483ull, 0x5CB0A9DCBD41FBD4ull, 0x76F988DA831153B5ull,
+    0x983E5152EE66DFABull, 0xA831C66D2DB43210ull, 0xB00327C898FB213Full,
+    0xBF597FC7BEEF0EE4ull, 0xC6E00BF33DA88FC2ull, 0xD5A79147930AA725ull,
+    0x06CA6351E003826Full, 0x142929670A0E6E70ull, 0x27B70A8546D22FFCull,
+    0x2E1B21385C26C926ull, 0x4D2C6DFC5AC42AEDull, 0x53380D139D95B3DFull,
+    0x650A73548BAF63DEull, 0x766A0ABB3C77B2A8ull, 0x81C2C92E47EDAEE6ull,
+    0x92722C851482353Bull, 0xA2BFE8A14CF10364ull, 0xA81A664BBC423001ull,
+    0xC24B8B70D0F89791ull, 0xC76C51A30654BE30ull, 0xD192E819D6EF5218ull,
+    0xD69906245565A910ull, 0xF40E35855771202Aull, 0x106AA07032BBD1B8ull,
+    0x19A4C116B8D2D0C8ull, 0x1E376C085141AB53ull, 0x2748774CDF8EEB99ull,
+    0x34B0BCB5E19B48A8ull, 0x391C0CB3C5C95A63ull, 0x4ED8AA4AE3418ACBull,
+    0x5B9CCA4F7763E373ull, 0x682E6FF3D6B2B8A3ull, 0x748F82EE5DEFB2FCull,
+    0x78A5636F43172F60ull, 0x84C87814A1F0AB72ull, 0x8CC702081A6439ECull,
+    0x90BEFFFA23631E28ull, 0xA4506CEBDE82BDE9ull, 0xBEF9A3F7B2C67915ull,
+    0xC67178F2E372532Bull, 0xCA273ECEEA26619Cull, 0xD186B8C721C0C207ull,
+    0xEADA7DD6CDE0EB1Eull, 0xF57D4F7FEE6ED178ull, 0x06F067AA72176FBAull,
+    0x0A637DC5A2C898A6ull, 0x113F9804BEF90DAEull, 0x1B710B35131C471Bull,
+    0x28DB77F523047D84ull, 0x32CAAB7B40C72493ull, 0x3C9EBE0A15C9BEBCull,
+    0x431D67C49C100D4Cull, 0x4CC5D4BECB3E42B6ull, 0x597F299CFC657E2Aull,
+    0x5FCB6FAB3AD6FAECull, 0x6C44198C4A475817ull
+};
+
+/*
+ * The block function in use. It is picked on first use; concurrent
+ * first uses all store the same values.
+ */
+static SHA512ProcessBlocksFunction SHA384_512ProcessBlocks = NULL;
+static SHA512Implementation SHA384_512Implementation = sha512Unrolled;
+
+/*
+ * The hardware block function picked by default. Runs shorter than
+ * SHA512_HARDWARE_MIN_BLOCKS leave most of the AVX2 lanes idle and
+ * are faster with the unrolled rounds.
+ */
+#define SHA512_HARDWARE_MIN_BLOCKS 4
+static SHA512ProcessBlocksFunction SHA384_512HardwareProcessBlocks = NULL;
+
 #endif /* USE_32BIT_ONLY */
 
 /*
@@ -480,7 +531,25 @@ int SHA512Input(SHA512Context *context,
     if (context->Corrupted)
         return context->Corrupted;
 
-    while (length-- && !context->Corrupted) {
+    while (length && !context->Corrupted) {
+#ifndef USE_32BIT_ONLY
+        if ((context->Message_Block_Index == 0) &&
+            (length >= SHA512_Message_Block_Size)) {
+            /* hash the whole blocks straight from message_array */
+            unsigned int blockCount = length / SHA512_Message_Block_Size;
+            unsigned int processed = 0;
+            while ((processed < blockCount) &&
+                !SHA384_512AddLength(context, 8 * SHA512_Message_Block_Size))
+                processed++;
+
+            SHA384_512GetProcessBlocks()(context->Intermediate_Hash,
+                message_array, processed);
+            message_array += processed * SHA512_Message_Block_Size;
+            length -= processed * SHA512_Message_Block_Size;
+            continue;
+        }
+#endif /* USE_32BIT_ONLY */
+
         context->Message_Block[context->Message_Block_Index++] =
             (*message_array & 0xFF);
 
@@ -489,6 +558,7 @@ int SHA512Input(SHA512Context *context,
             SHA384_512ProcessMessageBlock(context);
 
         message_array++;
+        length--;
     }
 
     return shaSuccess;
@@ -728,8 +798,8 @@ static void SHA384_512PadMessage(SHA512Context *context,
 */
 static void SHA384_512ProcessMessageBlock(SHA512Context *context)
 {
-    /* Constants defined in FIPS-180-2, section 4.2.3 */
 #ifdef USE_32BIT_ONLY
+    /* Constants defined in FIPS-180-2, section 4.2.3 */
     static const uint32_t K[80 * 2] = {
         0x428A2F98, 0xD728AE22, 0x71374491, 0x23EF65CD, 0xB5C0FBCF,
         0xEC4D3B2F, 0xE9B5DBA5, 0x8189DBBC, 0x3956C25B, 0xF348B538,
@@ -850,68 +920,74 @@ static void SHA384_512ProcessMessageBlock(SHA512Context *context)
     SHA512_ADDTO2(&context->Intermediate_Hash[14], H);
 
 #else /* !USE_32BIT_ONLY */
-    static const uint64_t K[80] = {
-        0x428A2F98D728AE22ull, 0x7137449123EF65CDull, 0xB5C0FBCFEC4D3B2Full,
-        0xE9B5DBA58189DBBCull, 0x3956C25BF348B538ull, 0x59F111F1B605D019ull,
-        0x923F82A4AF194F9Bull, 0xAB1C5ED5DA6D8118ull, 0xD807AA98A3030242ull,
-        0x12835B0145706FBEull, 0x243185BE4EE4B28Cull, 0x550C7DC3D5FFB4E2ull,
-        0x72BE5D74F27B896Full, 0x80DEB1FE3B1696B1ull, 0x9BDC06A725C71235ull,
-        0xC19BF174CF692694ull, 0xE49B69C19EF14AD2ull, 0xEFBE4786384F25E3ull,
-        0x0FC19DC68B8CD5B5ull, 0x240CA1CC77AC9C65ull, 0x2DE92C6F592B0275ull,
-        0x4A7484AA6EA6E483ull, 0x5CB0A9DCBD41FBD4ull, 0x76F988DA831153B5ull,
-        0x983E5152EE66DFABull, 0xA831C66D2DB43210ull, 0xB00327C898FB213Full,
-        0xBF597FC7BEEF0EE4ull, 0xC6E00BF33DA88FC2ull, 0xD5A79147930AA725ull,
-        0x06CA6351E003826Full, 0x142929670A0E6E70ull, 0x27B70A8546D22FFCull,
-        0x2E1B21385C26C926ull, 0x4D2C6DFC5AC42AEDull, 0x53380D139D95B3DFull,
-        0x650A73548BAF63DEull, 0x766A0ABB3C77B2A8ull, 0x81C2C92E47EDAEE6ull,
-        0x92722C851482353Bull, 0xA2BFE8A14CF10364ull, 0xA81A664BBC423001ull,
-        0xC24B8B70D0F89791ull, 0xC76C51A30654BE30ull, 0xD192E819D6EF5218ull,
-        0xD69906245565A910ull, 0xF40E35855771202Aull, 0x106AA07032BBD1B8ull,
-        0x19A4C116B8D2D0C8ull, 0x1E376C085141AB53ull, 0x2748774CDF8EEB99ull,
-        0x34B0BCB5E19B48A8ull, 0x391C0CB3C5C95A63ull, 0x4ED8AA4AE3418ACBull,
-        0x5B9CCA4F7763E373ull, 0x682E6FF3D6B2B8A3ull, 0x748F82EE5DEFB2FCull,
-        0x78A5636F43172F60ull, 0x84C87814A1F0AB72ull, 0x8CC702081A6439ECull,
-        0x90BEFFFA23631E28ull, 0xA4506CEBDE82BDE9ull, 0xBEF9A3F7B2C67915ull,
-        0xC67178F2E372532Bull, 0xCA273ECEEA26619Cull, 0xD186B8C721C0C207ull,
-        0xEADA7DD6CDE0EB1Eull, 0xF57D4F7FEE6ED178ull, 0x06F067AA72176FBAull,
-        0x0A637DC5A2C898A6ull, 0x113F9804BEF90DAEull, 0x1B710B35131C471Bull,
-        0x28DB77F523047D84ull, 0x32CAAB7B40C72493ull, 0x3C9EBE0A15C9BEBCull,
-        0x431D67C49C100D4Cull, 0x4CC5D4BECB3E42B6ull, 0x597F299CFC657E2Aull,
-        0x5FCB6FAB3AD6FAECull, 0x6C44198C4A475817ull
-    };
+    SHA384_512GetProcessBlocks()(context->Intermediate_Hash,
+        context->Message_Block, 1);
+#endif /* USE_32BIT_ONLY */
+
+    context->Message_Block_Index = 0;
+}
+
+#ifndef USE_32BIT_ONLY
+/*
+* SHA384_512ProcessBlocksPortable
+*
+* Description:
+*   This function will process blockCount consecutive 1024 bit
+*   blocks. It is the reference implementation.
+*
+* Parameters:
+*   Intermediate_Hash: [in/out]
+*     The intermediate hash to update
+*   blocks: [in]
+*     The message blocks
+*   blockCount: [in]
+*     The number of blocks
+*
+* Returns:
+*   Nothing.
+*
+* Comments:
+*   Many of the variable names in this code, especially the
+*   single character names, were used because those were the
+*   names used in the publication.
+*/
+static void SHA384_512ProcessBlocksPortable(uint64_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount)
+{
     int        t, t8;                   /* Loop counter */
     uint64_t   temp1, temp2;            /* Temporary word value */
     uint64_t   W[80];                   /* Word sequence */
     uint64_t   A, B, C, D, E, F, G, H;  /* Word buffers */
 
+    for (; blockCount > 0; blockCount--, blocks += SHA512_Message_Block_Size) {
     /*
     * Initialize the first 16 words in the array W
     */
     for (t = t8 = 0; t < 16; t++, t8 += 8)
-        W[t] = ((uint64_t)(context->Message_Block[t8]) << 56) |
-        ((uint64_t)(context->Message_Block[t8 + 1]) << 48) |
-        ((uint64_t)(context->Message_Block[t8 + 2]) << 40) |
-        ((uint64_t)(context->Message_Block[t8 + 3]) << 32) |
-        ((uint64_t)(context->Message_Block[t8 + 4]) << 24) |
-        ((uint64_t)(context->Message_Block[t8 + 5]) << 16) |
-        ((uint64_t)(context->Message_Block[t8 + 6]) << 8) |
-        ((uint64_t)(context->Message_Block[t8 + 7]));
+        W[t] = ((uint64_t)(blocks[t8]) << 56) |
+        ((uint64_t)(blocks[t8 + 1]) << 48) |
+        ((uint64_t)(blocks[t8 + 2]) << 40) |
+        ((uint64_t)(blocks[t8 + 3]) << 32) |
+        ((uint64_t)(blocks[t8 + 4]) << 24) |
+        ((uint64_t)(blocks[t8 + 5]) << 16) |
+        ((uint64_t)(blocks[t8 + 6]) << 8) |
+        ((uint64_t)(blocks[t8 + 7]));
 
     for (t = 16; t < 80; t++)
         W[t] = SHA512_sigma1(W[t - 2]) + W[t - 7] +
         SHA512_sigma0(W[t - 15]) + W[t - 16];
 
-    A = context->Intermediate_Hash[0];
-    B = context->Intermediate_Hash[1];
-    C = context->Intermediate_Hash[2];
-    D = context->Intermediate_Hash[3];
-    E = context->Intermediate_Hash[4];
-    F = context->Intermediate_Hash[5];
-    G = context->Intermediate_Hash[6];
-    H = context->Intermediate_Hash[7];
+    A = Intermediate_Hash[0];
+    B = Intermediate_Hash[1];
+    C = Intermediate_Hash[2];
+    D = Intermediate_Hash[3];
+    E = Intermediate_Hash[4];
+    F = Intermediate_Hash[5];
+    G = Intermediate_Hash[6];
+    H = Intermediate_Hash[7];
 
     for (t = 0; t < 80; t++) {
-        temp1 = H + SHA512_SIGMA1(E) + SHA_Ch(E, F, G) + K[t] + W[t];
+        temp1 = H + SHA512_SIGMA1(E) + SHA_Ch(E, F, G) + SHA512_K[t] + W[t];
         temp2 = SHA512_SIGMA0(A) + SHA_Maj(A, B, C);
         H = G;
         G = F;
@@ -923,19 +999,232 @@ static void SHA384_512ProcessMessageBlock(SHA512Context *context)
         A = temp1 + temp2;
     }
 
-    context->Intermediate_Hash[0] += A;
-    context->Intermediate_Hash[1] += B;
-    context->Intermediate_Hash[2] += C;
-    context->Intermediate_Hash[3] += D;
-    context->Intermediate_Hash[4] += E;
-    context->Intermediate_Hash[5] += F;
-    context->Intermediate_Hash[6] += G;
-    context->Intermediate_Hash[7] += H;
-#endif /* USE_32BIT_ONLY */
+    Intermediate_Hash[0] += A;
+    Intermediate_Hash[1] += B;
+    Intermediate_Hash[2] += C;
+    Intermediate_Hash[3] += D;
+    Intermediate_Hash[4] += E;
+    Intermediate_Hash[5] += F;
+    Intermediate_Hash[6] += G;
+    Intermediate_Hash[7] += H;
+    }
+}
 
-    context->Message_Block_Index = 0;
+/*
+* One round of SHA384_512ProcessBlocksUnrolled. Instead of moving
+* the working variables down after each round, the next round is
+* given them in rotated order: h becomes the new a and d the new e.
+*/
+#define SHA512_ROUND(a, b, c, d, e, f, g, h, t, Wt)                    \
+    h += SHA512_SIGMA1(e) + SHA_Ch(e, f, g) + SHA512_K[t] + (Wt);      \
+    d += h;                                                            \
+    h += SHA512_SIGMA0(a) + SHA_Maj(a, b, c)
+
+/* Word i of the first 16, and the next word of the message schedule,
+ * computed in place in a ring of 16 words */
+#define SHA512_WORD(i)      (W[(i)])
+#define SHA512_SCHEDULE(i)  (W[(i)] += SHA512_sigma1(W[((i) + 14) & 15]) + \
+    W[((i) + 9) & 15] + SHA512_sigma0(W[((i) + 1) & 15]))
+
+#define SHA512_16_ROUNDS(t, WORD)                                       \
+    SHA512_ROUND(A, B, C, D, E, F, G, H, (t) + 0, WORD(0));             \
+    SHA512_ROUND(H, A, B, C, D, E, F, G, (t) + 1, WORD(1));             \
+    SHA512_ROUND(G, H, A, B, C, D, E, F, (t) + 2, WORD(2));             \
+    SHA512_ROUND(F, G, H, A, B, C, D, E, (t) + 3, WORD(3));             \
+    SHA512_ROUND(E, F, G, H, A, B, C, D, (t) + 4, WORD(4));             \
+    SHA512_ROUND(D, E, F, G, H, A, B, C, (t) + 5, WORD(5));             \
+    SHA512_ROUND(C, D, E, F, G, H, A, B, (t) + 6, WORD(6));             \
+    SHA512_ROUND(B, C, D, E, F, G, H, A, (t) + 7, WORD(7));             \
+    SHA512_ROUND(A, B, C, D, E, F, G, H, (t) + 8, WORD(8));             \
+    SHA512_ROUND(H, A, B, C, D, E, F, G, (t) + 9, WORD(9));             \
+    SHA512_ROUND(G, H, A, B, C, D, E, F, (t) + 10, WORD(10));           \
+    SHA512_ROUND(F, G, H, A, B, C, D, E, (t) + 11, WORD(11));           \
+    SHA512_ROUND(E, F, G, H, A, B, C, D, (t) + 12, WORD(12));           \
+    SHA512_ROUND(D, E, F, G, H, A, B, C, (t) + 13, WORD(13));           \
+    SHA512_ROUND(C, D, E, F, G, H, A, B, (t) + 14, WORD(14));           \
+    SHA512_ROUND(B, C, D, E, F, G, H, A, (t) + 15, WORD(15))
+
+/*
+* SHA384_512ProcessBlocksUnrolled
+*
+* Description:
+*   This function will process blockCount consecutive 1024 bit
+*   blocks, like SHA384_512ProcessBlocksPortable, with the rounds
+*   unrolled 16 at a time and the message schedule computed as the
+*   rounds go, in 16 words.
+*
+* Parameters:
+*   Intermediate_Hash: [in/out]
+*     The intermediate hash to update
+*   blocks: [in]
+*     The message blocks
+*   blockCount: [in]
+*     The number of blocks
+*
+* Returns:
+*   Nothing.
+*/
+static void SHA384_512ProcessBlocksUnrolled(uint64_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount)
+{
+    int        t;                       /* Loop counter */
+    uint64_t   W[16];                   /* Word sequence */
+    uint64_t   A, B, C, D, E, F, G, H;  /* Word buffers */
+
+    for (; blockCount > 0; blockCount--, blocks += SHA512_Message_Block_Size) {
+        for (t = 0; t < 16; t++)
+            W[t] = ((uint64_t)(blocks[8 * t]) << 56) |
+            ((uint64_t)(blocks[8 * t + 1]) << 48) |
+            ((uint64_t)(blocks[8 * t + 2]) << 40) |
+            ((uint64_t)(blocks[8 * t + 3]) << 32) |
+            ((uint64_t)(blocks[8 * t + 4]) << 24) |
+            ((uint64_t)(blocks[8 * t + 5]) << 16) |
+            ((uint64_t)(blocks[8 * t + 6]) << 8) |
+            ((uint64_t)(blocks[8 * t + 7]));
+
+        A = Intermediate_Hash[0];
+        B = Intermediate_Hash[1];
+        C = Intermediate_Hash[2];
+        D = Intermediate_Hash[3];
+        E = Intermediate_Hash[4];
+        F = Intermediate_Hash[5];
+        G = Intermediate_Hash[6];
+        H = Intermediate_Hash[7];
+
+        SHA512_16_ROUNDS(0, SHA512_WORD);
+        for (t = 16; t < 80; t += 16) {
+            SHA512_16_ROUNDS(t, SHA512_SCHEDULE);
+        }
+
+        Intermediate_Hash[0] += A;
+        Intermediate_Hash[1] += B;
+        Intermediate_Hash[2] += C;
+        Intermediate_Hash[3] += D;
+        Intermediate_Hash[4] += E;
+        Intermediate_Hash[5] += F;
+        Intermediate_Hash[6] += G;
+        Intermediate_Hash[7] += H;
+    }
 }
 
+#undef SHA512_16_ROUNDS
+#undef SHA512_SCHEDULE
+#undef SHA512_WORD
+#undef SHA512_ROUND
+
+/*
+* SHA384_512ProcessBlocksDefault
+*
+* Description:
+*   This function is the block function picked by default when the
+*   CPU has a hardware implementation. It hands runs of fewer than
+*   SHA512_HARDWARE_MIN_BLOCKS blocks to the unrolled rounds and
+*   longer runs to the hardware implementation.
+*/
+static void SHA384_512ProcessBlocksDefault(uint64_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount)
+{
+    if (blockCount < SHA512_HARDWARE_MIN_BLOCKS)
+        SHA384_512ProcessBlocksUnrolled(Intermediate_Hash, blocks, blockCount);
+    else
+        SHA384_512HardwareProcessBlocks(Intermediate_Hash, blocks, blockCount);
+}
+
+/*
+* SHA384_512GetProcessBlocks
+*
+* Description:
+*   This function returns the block function in use, picking the
+*   fastest one supported by the CPU the first time it is called.
+*
+* Returns:
+*   The block function.
+*/
+static SHA512ProcessBlocksFunction SHA384_512GetProcessBlocks(void)
+{
+    if (SHA384_512ProcessBlocks == NULL) {
+        SHA512ProcessBlocksFunction hardwareProcessBlocks;
+        if ((hardwareProcessBlocks = SHA512GetHardwareProcessBlocks(sha512X86Avx2)) != NULL)
+            SHA384_512Implementation = sha512X86Avx2;
+        else
+            SHA384_512Implementation = sha512Unrolled;
+
+        SHA384_512HardwareProcessBlocks = hardwareProcessBlocks;
+        SHA384_512ProcessBlocks = (hardwareProcessBlocks != NULL) ?
+            SHA384_512ProcessBlocksDefault : SHA384_512ProcessBlocksUnrolled;
+    }
+
+    return SHA384_512ProcessBlocks;
+}
+
+/*
+* SHA512IsImplementationSupported
+*
+* Description:
+*   This function tells whether an implementation of the block
+*   function can be used by this build on this CPU.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   1 if it is supported, 0 otherwise.
+*/
+int SHA512IsImplementationSupported(SHA512Implementation implementation)
+{
+    return ((implementation == sha512Portable) ||
+        (implementation == sha512Unrolled) ||
+        (SHA512GetHardwareProcessBlocks(implementation) != NULL)) ? 1 : 0;
+}
+
+/*
+* SHA512SelectImplementation
+*
+* Description:
+*   This function forces the implementation of the block function
+*   used by all the SHA-384/SHA-512 contexts.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   sha Error Code.
+*/
+int SHA512SelectImplementation(SHA512Implementation implementation)
+{
+    SHA512ProcessBlocksFunction processBlocks;
+
+    if (implementation == sha512Portable)
+        processBlocks = SHA384_512ProcessBlocksPortable;
+    else if (implementation == sha512Unrolled)
+        processBlocks = SHA384_512ProcessBlocksUnrolled;
+    else if ((processBlocks = SHA512GetHardwareProcessBlocks(implementation)) == NULL)
+        return shaBadParam;
+
+    SHA384_512Implementation = implementation;
+    SHA384_512ProcessBlocks = processBlocks;
+    return shaSuccess;
+}
+
+/*
+* SHA512GetImplementation
+*
+* Description:
+*   This function returns the implementation of the block function
+*   in use.
+*
+* Returns:
+*   The implementation.
+*/
+SHA512Implementation SHA512GetImplementation(void)
+{
+    (void)SHA384_512GetProcessBlocks();
+    return SHA384_512Implementation;
+}
+#endif /* USE_32BIT_ONLY */
+
 /*
 * SHA384_512Reset
 *
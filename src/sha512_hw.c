@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*************************** sha512_hw.c ***************************/
+/*
+* Description:
+*   This file implements the SHA-384/SHA-512 block function with
+*   AVX2 (x86 and x64). The message schedule of 4 consecutive blocks
+*   is computed at once, one block per 64 bit vector lane, and the
+*   rounds of each block then run on the general purpose registers
+*   with the BMI2 rotate instruction.
+*
+*   The implementation is only compiled when the compiler can
+*   generate the instructions, and is only handed out by
+*   SHA512GetHardwareProcessBlocks when the CPU running the code
+*   supports them. sha384-512.c falls back to portable code
+*   otherwise.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "azure_c_shared_utility/sha.h"
+#include "azure_c_shared_utility/sha-private.h"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && \
+    ((defined(__GNUC__) && !defined(__clang__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || \
+     (defined(__clang__) && ((__clang_major__ > 3) || ((__clang_major__ == 3) && (__clang_minor__ >= 4)))) || \
+     (defined(_MSC_VER) && (_MSC_VER >= 1900)))
+#define SHA512_HAS_X86_AVX2
+#endif
+
+#ifdef SHA512_HAS_X86_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SHA512_X86_TARGET(features)
+#else
+#include <cpuid.h>
+#define SHA512_X86_TARGET(features) __attribute__((target(features)))
+#endif
+
+#define SHA512_X86_ECX1_OSXSAVE      (1u << 27)
+#define SHA512_X86_ECX1_AVX          (1u << 28)
+#define SHA512_X86_EBX7_AVX2         (1u << 5)
+#define SHA512_X86_EBX7_BMI2         (1u << 8)
+#define SHA512_X86_XCR0_YMM          0x06u  /* SSE and AVX state */
+
+#define SHA512_AVX2_LANES 4
+
+/* Constants defined in FIPS-180-2, section 4.2.3 */
+static const uint64_t SHA512_K[80] = {
+    0x428A2F98D728AE22ull, 0x7137449123EF65CDull, 0xB5C0FBCFEC4D3B2Full,
+    0xE9B5DBA58189DBBCull, 0x3956C25BF348B538ull, 0x59F111F1B605D019ull,
+    0x923F82A4AF194F9Bull, 0xAB1C5ED5DA6D8118ull, 0xD807AA98A3030242ull,
+    0x12835B0145706FBEull, 0x243185BE4EE4B28Cull, 0x550C7DC3D5FFB4E2ull,
+    0x72BE5D74F27B896Full, 0x80DEB1FE3B1696B1ull, 0x9BDC06A725C71235ull,
+    0xC19BF174CF692694ull, 0xE49B69C19EF14AD2ull, 0xEFBE4786384F25E3ull,
+    0x0FC19DC68B8CD5B5ull, 0x240CA1CC77AC9C65ull, 0x2DE92C6F592B0275ull,
+    0x4A7484AA6EA6E483ull, 0x5CB0A9DCBD41FBD4ull, 0x76F988DA831153B5ull,
+    0x983E5152EE66DFABull, 0xA831C66D2DB43210ull, 0xB00327C898FB213Full,
+    0xBF597FC7BEEF0EE4ull, 0xC6E00BF33DA88FC2ull, 0xD5A79147930AA725ull,
+    0x06CA6351E003826Full, 0x142929670A0E6E70ull, 0x27B70A8546D22FFCull,
+    0x2E1B21385C26C926ull, 0x4D2C6DFC5AC42AEDull, 0x53380D139D95B3DFull,
+    0x650A73548BAF63DEull, 0x766A0ABB3C77B2A8ull, 0x81C2C92E47EDAEE6ull,
+    0x92722C851482353Bull, 0xA2BFE8A14CF10364ull, 0xA81A664BBC423001ull,
+    0xC24B8B70D0F89791ull, 0xC76C51A30654BE30ull, 0xD192E819D6EF5218ull,
+    0xD69906245565A910ull, 0xF40E35855771202Aull, 0x106AA07032BBD1B8ull,
+    0x19A4C116B8D2D0C8ull, 0x1E376C085141AB53ull, 0x2748774CDF8EEB99ull,
+    0x34B0BCB5E19B48A8ull, 0x391C0CB3C5C95A63ull, 0x4ED8AA4AE3418ACBull,
+    0x5B9CCA4F7763E373ull, 0x682E6FF3D6B2B8A3ull, 0x748F82EE5DEFB2FCull,
+    0x78A5636F43172F60ull, 0x84C87814A1F0AB72ull, 0x8CC702081A6439ECull,
+    0x90BEFFFA23631E28ull, 0xA4506CEBDE82BDE9ull, 0xBEF9A3F7B2C67915ull,
+    0xC67178F2E372532Bull, 0xCA273ECEEA26619Cull, 0xD186B8C721C0C207ull,
+    0xEADA7DD6CDE0EB1Eull, 0xF57D4F7FEE6ED178ull, 0x06F067AA72176FBAull,
+    0x0A637DC5A2C898A6ull, 0x113F9804BEF90DAEull, 0x1B710B35131C471Bull,
+    0x28DB77F523047D84ull, 0x32CAAB7B40C72493ull, 0x3C9EBE0A15C9BEBCull,
+    0x431D67C49C100D4Cull, 0x4CC5D4BECB3E42B6ull, 0x597F299CFC657E2Aull,
+    0x5FCB6FAB3AD6FAECull, 0x6C44198C4A475817ull
+};
+
+/* Define the SHA SIGMA and sigma macros, scalar and on 4 lanes */
+#define SHA512_ROTR(bits, word) (((word) >> (bits)) | ((word) << (64 - (bits))))
+#define SHA512_SIGMA0(word) \
+    (SHA512_ROTR(28, word) ^ SHA512_ROTR(34, word) ^ SHA512_ROTR(39, word))
+#define SHA512_SIGMA1(word) \
+    (SHA512_ROTR(14, word) ^ SHA512_ROTR(18, word) ^ SHA512_ROTR(41, word))
+
+#define AVX2_ROTR64(x, n) _mm256_or_si256(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+#define AVX2_XOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256((x), (y)), (z))
+#define AVX2_sigma0(x)    AVX2_XOR3(AVX2_ROTR64((x), 1), AVX2_ROTR64((x), 8), _mm256_srli_epi64((x), 7))
+#define AVX2_sigma1(x)    AVX2_XOR3(AVX2_ROTR64((x), 19), AVX2_ROTR64((x), 61), _mm256_srli_epi64((x), 6))
+
+/*
+* SHA512X86Avx2Supported
+*
+* Description:
+*   This function tells whether the CPU has AVX2 and BMI2 and the OS
+*   saves the YMM registers.
+*/
+static int SHA512X86Avx2Supported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return 0;
+    __cpuid(info, 1);
+    ecx1 = (unsigned int)info[2];
+    __cpuidex(info, 7, 0);
+    ebx7 = (unsigned int)info[1];
+    xcr0 = ((ecx1 & SHA512_X86_ECX1_OSXSAVE) != 0) ? (unsigned int)_xgetbv(0) : 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, NULL) < 7)
+        return 0;
+    __cpuid_count(1, 0, eax, ebx, ecx, edx);
+    ecx1 = ecx;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    ebx7 = ebx;
+    if ((ecx1 & SHA512_X86_ECX1_OSXSAVE) != 0) {
+        /* xgetbv, spelled out for assemblers that do not know it */
+        __asm__ volatile (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+        xcr0 = eax;
+    } else {
+        xcr0 = 0;
+    }
+#endif
+
+    return ((ecx1 & SHA512_X86_ECX1_AVX) != 0) &&
+        ((ebx7 & SHA512_X86_EBX7_AVX2) != 0) &&
+        ((ebx7 & SHA512_X86_EBX7_BMI2) != 0) &&
+        ((xcr0 & SHA512_X86_XCR0_YMM) == SHA512_X86_XCR0_YMM);
+}
+
+/*
+* SHA512X86Avx2Schedule
+*
+* Description:
+*   This function computes W[t] + K[t] for the 80 rounds of 4
+*   blocks; WK[t][lane] is for the block at blocks[lane].
+*/
+SHA512_X86_TARGET("avx2")
+static void SHA512X86Avx2Schedule(uint64_t WK[80][SHA512_AVX2_LANES],
+    const uint8_t *const blocks[SHA512_AVX2_LANES])
+{
+    /* swaps the bytes of each 64 bit word */
+    const __m256i byteSwap = _mm256_set_epi8(
+        8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+        8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i W[16];
+    int t;
+
+    /* words t to t + 3 of the 4 blocks, transposed to one block per lane */
+    for (t = 0; t < 16; t += 4) {
+        __m256i x0 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(blocks[0] + 8 * t)), byteSwap);
+        __m256i x1 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(blocks[1] + 8 * t)), byteSwap);
+        __m256i x2 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(blocks[2] + 8 * t)), byteSwap);
+        __m256i x3 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(blocks[3] + 8 * t)), byteSwap);
+        __m256i t0 = _mm256_unpacklo_epi64(x0, x1);
+        __m256i t1 = _mm256_unpackhi_epi64(x0, x1);
+        __m256i t2 = _mm256_unpacklo_epi64(x2, x3);
+        __m256i t3 = _mm256_unpackhi_epi64(x2, x3);
+        W[t] = _mm256_permute2x128_si256(t0, t2, 0x20);
+        W[t + 1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+        W[t + 2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+        W[t + 3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+    }
+
+    for (t = 0; t < 80; t++) {
+        if (t >= 16)
+            W[t & 15] = _mm256_add_epi64(
+                _mm256_add_epi64(AVX2_sigma1(W[(t - 2) & 15]), W[(t - 7) & 15]),
+                _mm256_add_epi64(AVX2_sigma0(W[(t - 15) & 15]), W[t & 15]));
+
+        _mm256_storeu_si256((__m256i*)WK[t],
+            _mm256_add_epi64(W[t & 15], _mm256_set1_epi64x((long long)SHA512_K[t])));
+    }
+}
+
+/*
+* One round. Instead of moving the working variables down after each
+* round, the next round is given them in rotated order: h becomes the
+* new a and d the new e.
+*/
+#define SHA512_ROUND(a, b, c, d, e, f, g, h, t)                          \
+    h += SHA512_SIGMA1(e) + (((e) & (f)) ^ (~(e) & (g))) + WK[(t)][lane]; \
+    d += h;                                                              \
+    h += SHA512_SIGMA0(a) + (((a) & ((b) | (c))) | ((b) & (c)))
+
+#define SHA512_8_ROUNDS(t)                                               \
+    SHA512_ROUND(A, B, C, D, E, F, G, H, (t) + 0);                       \
+    SHA512_ROUND(H, A, B, C, D, E, F, G, (t) + 1);                       \
+    SHA512_ROUND(G, H, A, B, C, D, E, F, (t) + 2);                       \
+    SHA512_ROUND(F, G, H, A, B, C, D, E, (t) + 3);                       \
+    SHA512_ROUND(E, F, G, H, A, B, C, D, (t) + 4);                       \
+    SHA512_ROUND(D, E, F, G, H, A, B, C, (t) + 5);                       \
+    SHA512_ROUND(C, D, E, F, G, H, A, B, (t) + 6);                       \
+    SHA512_ROUND(B, C, D, E, F, G, H, A, (t) + 7)
+
+/*
+* SHA512X86Avx2Rounds
+*
+* Description:
+*   This function runs the 80 rounds of the block in lane and adds
+*   the result to the intermediate hash.
+*/
+SHA512_X86_TARGET("avx2,bmi2")
+static void SHA512X86Avx2Rounds(uint64_t Intermediate_Hash[8],
+    const uint64_t WK[80][SHA512_AVX2_LANES], int lane)
+{
+    uint64_t A = Intermediate_Hash[0];
+    uint64_t B = Intermediate_Hash[1];
+    uint64_t C = Intermediate_Hash[2];
+    uint64_t D = Intermediate_Hash[3];
+    uint64_t E = Intermediate_Hash[4];
+    uint64_t F = Intermediate_Hash[5];
+    uint64_t G = Intermediate_Hash[6];
+    uint64_t H = Intermediate_Hash[7];
+    int t;
+
+    for (t = 0; t < 80; t += 8) {
+        SHA512_8_ROUNDS(t);
+    }
+
+    Intermediate_Hash[0] += A;
+    Intermediate_Hash[1] += B;
+    Intermediate_Hash[2] += C;
+    Intermediate_Hash[3] += D;
+    Intermediate_Hash[4] += E;
+    Intermediate_Hash[5] += F;
+    Intermediate_Hash[6] += G;
+    Intermediate_Hash[7] += H;
+}
+
+#undef SHA512_8_ROUNDS
+#undef SHA512_ROUND
+
+/*
+* SHA512X86Avx2ProcessBlocks
+*
+* Description:
+*   This function will process blockCount consecutive 1024 bit
+*   blocks, 4 at a time. When fewer than 4 blocks are left, the
+*   last one fills the unused lanes.
+*/
+SHA512_X86_TARGET("avx2,bmi2")
+static void SHA512X86Avx2ProcessBlocks(uint64_t Intermediate_Hash[8],
+    const uint8_t *blocks, size_t blockCount)
+{
+    uint64_t WK[80][SHA512_AVX2_LANES];
+    const uint8_t *lanes[SHA512_AVX2_LANES];
+    int laneCount, lane;
+
+    while (blockCount > 0) {
+        laneCount = (blockCount < SHA512_AVX2_LANES) ? (int)blockCount : SHA512_AVX2_LANES;
+        for (lane = 0; lane < SHA512_AVX2_LANES; lane++)
+            lanes[lane] = blocks + ((lane < laneCount) ? lane : laneCount - 1) * SHA512_Message_Block_Size;
+
+        SHA512X86Avx2Schedule(WK, lanes);
+        for (lane = 0; lane < laneCount; lane++)
+            SHA512X86Avx2Rounds(Intermediate_Hash, (const uint64_t (*)[SHA512_AVX2_LANES])WK, lane);
+
+        blocks += laneCount * SHA512_Message_Block_Size;
+        blockCount -= laneCount;
+    }
+}
+#endif /* SHA512_HAS_X86_AVX2 */
+
+/*
+* SHA512GetHardwareProcessBlocks
+*
+* Description:
+*   This function returns the block function of a hardware
+*   implementation.
+*
+* Parameters:
+*   implementation: [in]
+*     The implementation.
+*
+* Returns:
+*   The block function, or NULL if this build or this CPU does not
+*   support the implementation.
+*/
+SHA512ProcessBlocksFunction SHA512GetHardwareProcessBlocks(SHA512Implementation implementation)
+{
+    SHA512ProcessBlocksFunction result;
+
+    switch (implementation)
+    {
+#ifdef SHA512_HAS_X86_AVX2
+    case sha512X86Avx2:
+        result = SHA512X86Avx2Supported() ? SHA512X86Avx2ProcessBlocks : NULL;
+        break;
+#endif
+    default:
+        result = NULL;
+        break;
+    }
+
+    return result;
+}
@@ -16,16 +16,64 @@
 //
 
 #include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/arena.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 
 static const char hexToASCII[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
 
+/* strings up to this many characters, '\0' included, fit in the allocation of a STRING made by STRING_construct_inline */
+#define STRING_INLINE_MIN_SIZE 32
+
 typedef struct STRING_TAG
 {
     char* s;
+    /* NULL for STRINGs on the heap, otherwise the arena both the STRING and its characters come from */
+    ARENA_HANDLE arena;
+    /* bytes available right after the STRING in its own allocation, 0 unless made by STRING_construct_inline */
+    size_t inline_size;
 } STRING;
 
+static char* inline_chars(STRING* str)
+{
+    return (char*)str + sizeof(STRING);
+}
+
+static int is_inline(STRING* str)
+{
+    return (str->inline_size != 0) && (str->s == inline_chars(str));
+}
+
+static char* string_realloc(STRING* str, size_t size)
+{
+    char* result;
+    if (str->arena != NULL)
+    {
+        /* Codes_SRS_STRING_99_005: [ The functions that change the content of a STRING built in an arena shall take the memory for the new content from that arena. ]*/
+        result = (char*)ARENA_realloc(str->arena, str->s, strlen(str->s) + 1, size);
+    }
+    else if (!is_inline(str))
+    {
+        result = (char*)realloc(str->s, size);
+    }
+    else if (size <= str->inline_size)
+    {
+        /* Codes_SRS_STRING_99_010: [ The functions that change the content of a STRING made by STRING_construct_inline shall keep the characters in the allocation of the STRING while they fit and move them to memory of their own when they do not. ]*/
+        result = str->s;
+    }
+    else
+    {
+        /* Codes_SRS_STRING_99_010: [ The functions that change the content of a STRING made by STRING_construct_inline shall keep the characters in the allocation of the STRING while they fit and move them to memory of their own when they do not. ]*/
+        size_t length = strlen(str->s) + 1;
+        result = (char*)malloc(size);
+        if (result != NULL)
+        {
+            (void)memcpy(result, str->s, (length < size) ? length : size);
+        }
+    }
+    return result;
+}
+
 /*this function will allocate a new string with just '\0' in it*/
 /*return NULL if it fails*/
 /* Codes_SRS_STRING_07_001: [STRING_new shall allocate a new STRING_HANDLE pointing to an empty string.] */
@@ -34,6 +82,8 @@ STRING_HANDLE STRING_new(void)
     STRING* result;
     if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
     {
+        result->arena = NULL;
+        result->inline_size = 0;
         if ((result->s = (char*)malloc(1)) != NULL)
         {
             result->s[0] = '\0';
@@ -63,6 +113,8 @@ STRING_HANDLE STRING_clone(STRING_HANDLE handle)
         if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
         {
             STRING* source = (STRING*)handle;
+            result->arena = NULL;
+            result->inline_size = 0;
             /*Codes_SRS_STRING_02_003: [If STRING_clone fails for any reason, it shall return NULL.] */
             size_t sourceLen = strlen(source->s);
             if ((result->s = (char*)malloc(sourceLen + 1)) == NULL)
@@ -98,6 +150,8 @@ STRING_HANDLE STRING_construct(const char* psz)
         if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
         {
             size_t nLen = strlen(psz) + 1;
+            str->arena = NULL;
+            str->inline_size = 0;
             if ((str->s = (char*)malloc(nLen)) != NULL)
             {
                 (void)memcpy(str->s, psz, nLen);
@@ -119,6 +173,94 @@ STRING_HANDLE STRING_construct(const char* psz)
     return result;
 }
 
+STRING_HANDLE STRING_construct_inline(const char* psz)
+{
+    STRING* result;
+    if (psz == NULL)
+    {
+        /* Codes_SRS_STRING_99_007: [ If psz is NULL, or allocating memory fails, STRING_construct_inline shall return NULL. ]*/
+        LogError("invalid arg (NULL)");
+        result = NULL;
+    }
+    else
+    {
+        size_t nLen = strlen(psz) + 1;
+        /* Codes_SRS_STRING_99_008: [ STRING_construct_inline shall allocate the STRING and room for at least 32 characters, or for psz and its terminating '\0' when it is longer, in a single allocation. ]*/
+        size_t inline_size = (nLen < STRING_INLINE_MIN_SIZE) ? STRING_INLINE_MIN_SIZE : nLen;
+        if ((result = (STRING*)malloc(sizeof(STRING) + inline_size)) == NULL)
+        {
+            /* Codes_SRS_STRING_99_007: [ If psz is NULL, or allocating memory fails, STRING_construct_inline shall return NULL. ]*/
+            LogError("failure allocating STRING");
+        }
+        else
+        {
+            /* Codes_SRS_STRING_99_009: [ STRING_construct_inline shall copy psz into the room that follows the STRING and return a non-NULL handle. ]*/
+            result->arena = NULL;
+            result->inline_size = inline_size;
+            result->s = inline_chars(result);
+            (void)memcpy(result->s, psz, nLen);
+        }
+    }
+    return (STRING_HANDLE)result;
+}
+
+/* Codes_SRS_STRING_99_001: [ STRING_new_in_arena shall take a new STRING pointing to an empty string from arena. ]*/
+STRING_HANDLE STRING_new_in_arena(ARENA_HANDLE arena)
+{
+    STRING_HANDLE result;
+    if (arena == NULL)
+    {
+        /* Codes_SRS_STRING_99_002: [ If arena is NULL or taking memory from it fails, STRING_new_in_arena shall return NULL. ]*/
+        LogError("invalid arg (NULL)");
+        result = NULL;
+    }
+    else
+    {
+        result = STRING_construct_in_arena(arena, "");
+    }
+    return result;
+}
+
+/* Codes_SRS_STRING_99_003: [ STRING_construct_in_arena shall take a new STRING holding a copy of psz from arena. ]*/
+STRING_HANDLE STRING_construct_in_arena(ARENA_HANDLE arena, const char* psz)
+{
+    STRING_HANDLE result;
+    if ((arena == NULL) || (psz == NULL))
+    {
+        /* Codes_SRS_STRING_99_004: [ If arena or psz is NULL, or taking memory from arena fails, STRING_construct_in_arena shall return NULL. ]*/
+        LogError("invalid arg (NULL)");
+        result = NULL;
+    }
+    else
+    {
+        STRING* str;
+        if ((str = (STRING*)ARENA_malloc(arena, sizeof(STRING))) != NULL)
+        {
+            size_t nLen = strlen(psz) + 1;
+            str->arena = arena;
+            str->inline_size = 0;
+            if ((str->s = (char*)ARENA_malloc(arena, nLen)) != NULL)
+            {
+                (void)memcpy(str->s, psz, nLen);
+                result = (STRING_HANDLE)str;
+            }
+            else
+            {
+                /* Codes_SRS_STRING_99_004: [ If arena or psz is NULL, or taking memory from arena fails, STRING_construct_in_arena shall return NULL. ]*/
+                LogError("failure taking %u bytes from the arena", (unsigned int)nLen);
+                result = NULL;
+            }
+        }
+        else
+        {
+            /* Codes_SRS_STRING_99_004: [ If arena or psz is NULL, or taking memory from arena fails, STRING_construct_in_arena shall return NULL. ]*/
+            LogError("failure taking a STRING from the arena");
+            result = NULL;
+        }
+    }
+    return result;
+}
+
 #if defined(__GNUC__)
 __attribute__ ((format (printf, 1, 2)))
 #endif
@@ -148,6 +290,8 @@ STRING_HANDLE STRING_construct_sprintf(const char* format, ...)
             result = (STRING*)malloc(sizeof(STRING));
             if (result != NULL)
             {
+                result->arena = NULL;
+                result->inline_size = 0;
                 result->s = (char*)malloc(length+1);
                 if (result->s != NULL)
                 {
@@ -212,6 +356,8 @@ STRING_HANDLE STRING_new_with_memory(const char* memory)
         if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
         {
             result->s = (char*)memory;
+            result->arena = NULL;
+            result->inline_size = 0;
         }
     }
     return (STRING_HANDLE)result;
@@ -229,6 +375,8 @@ STRING_HANDLE STRING_new_quoted(const char* source)
     else if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
     {
         size_t sourceLength = strlen(source);
+        result->arena = NULL;
+        result->inline_size = 0;
         if ((result->s = (char*)malloc(sourceLength + 3)) != NULL)
         {
             result->s[0] = '"';
@@ -311,6 +459,8 @@ STRING_HANDLE STRING_new_JSON(const char* source)
             else
             {
                 size_t pos = 0;
+                result->arena = NULL;
+                result->inline_size = 0;
                 /*Codes_SRS_STRING_02_012: [The string shall begin with the quote character.] */
                 result->s[pos++] = '"';
                 for (i = 0; i < vlen; i++)
@@ -377,7 +527,7 @@ int STRING_concat(STRING_HANDLE handle, const char* s2)
         STRING* s1 = (STRING*)handle;
         size_t s1Length = strlen(s1->s);
         size_t s2Length = strlen(s2);
-        char* temp = (char*)realloc(s1->s, s1Length + s2Length + 1);
+        char* temp = string_realloc(s1, s1Length + s2Length + 1);
         if (temp == NULL)
         {
             /* Codes_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if an error is encountered.] */
@@ -412,7 +562,7 @@ int STRING_concat_with_STRING(STRING_HANDLE s1, STRING_HANDLE s2)
 
         size_t s1Length = strlen(dest->s);
         size_t s2Length = strlen(src->s);
-        char* temp = (char*)realloc(dest->s, s1Length + s2Length + 1);
+        char* temp = string_realloc(dest, s1Length + s2Length + 1);
         if (temp == NULL)
         {
             /* Codes_SRS_STRING_07_035: [String_Concat_with_STRING shall return a nonzero number if an error is encountered.] */
@@ -448,7 +598,7 @@ int STRING_copy(STRING_HANDLE handle, const char* s2)
         if (s1->s != s2)
         {
             size_t s2Length = strlen(s2);
-            char* temp = (char*)realloc(s1->s, s2Length + 1);
+            char* temp = string_realloc(s1, s2Length + 1);
             if (temp == NULL)
             {
                 /* Codes_SRS_STRING_07_027: [STRING_copy shall return a nonzero value if any error is encountered.] */
@@ -492,7 +642,7 @@ int STRING_copy_n(STRING_HANDLE handle, const char* s2, size_t n)
             s2Length = n;
         }
 
-        temp = (char*)realloc(s1->s, s2Length + 1);
+        temp = string_realloc(s1, s2Length + 1);
         if (temp == NULL)
         {
             /* Codes_SRS_STRING_07_028: [STRING_copy_n shall return a nonzero value if any error is encountered.] */
@@ -555,7 +705,7 @@ int STRING_sprintf(STRING_HANDLE handle, const char* format, ...)
             STRING* s1 = (STRING*)handle;
             char* temp;
             size_t s1Length = strlen(s1->s);
-            temp = (char*)realloc(s1->s, s1Length + s2Length + 1);
+            temp = string_realloc(s1, s1Length + s2Length + 1);
             if (temp != NULL)
             {
                 s1->s = temp;
@@ -601,7 +751,7 @@ int STRING_quote(STRING_HANDLE handle)
     {
         STRING* s1 = (STRING*)handle;
         size_t s1Length = strlen(s1->s);
-        char* temp = (char*)realloc(s1->s, s1Length + 2 + 1);/*2 because 2 quotes, 1 because '\0'*/
+        char* temp = string_realloc(s1, s1Length + 2 + 1);/*2 because 2 quotes, 1 because '\0'*/
         if (temp == NULL)
         {
             /* Codes_SRS_STRING_07_029: [STRING_quote shall return a nonzero value if any error is encountered.] */
@@ -633,7 +783,7 @@ int STRING_empty(STRING_HANDLE handle)
     else
     {
         STRING* s1 = (STRING*)handle;
-        char* temp = (char*)realloc(s1->s, 1);
+        char* temp = string_realloc(s1, 1);
         if (temp == NULL)
         {
             /* Codes_SRS_STRING_07_030: [STRING_empty shall return a nonzero value if the STRING_HANDLE is NULL.] */
@@ -657,9 +807,16 @@ void STRING_delete(STRING_HANDLE handle)
     if (handle != NULL)
     {
         STRING* value = (STRING*)handle;
-        free(value->s);
-        value->s = NULL;
-        free(value);
+        /* Codes_SRS_STRING_99_006: [ STRING_delete shall not free a STRING built in an arena, its memory goes back to the arena when the arena is reset or destroyed. ]*/
+        if (value->arena == NULL)
+        {
+            if (!is_inline(value))
+            {
+                free(value->s);
+            }
+            value->s = NULL;
+            free(value);
+        }
     }
 }
 
@@ -716,6 +873,8 @@ STRING_HANDLE STRING_construct_n(const char* psz, size_t n)
             STRING* str;
             if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
             {
+                str->arena = NULL;
+                str->inline_size = 0;
                 if ((str->s = (char*)malloc(len + 1)) != NULL)
                 {
                     (void)memcpy(str->s, psz, n);
@@ -790,6 +949,8 @@ STRING_HANDLE STRING_from_byte_array(const unsigned char* source, size_t size)
         else
         {
             /*Codes_SRS_STRING_02_023: [ Otherwise, STRING_from_BUFFER shall build a string that has the same content (byte-by-byte) as source and return a non-NULL handle. ]*/
+            result->arena = NULL;
+            result->inline_size = 0;
             result->s = (char*)malloc(size + 1);
             if (result->s == NULL)
             {
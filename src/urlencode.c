@@ -9,89 +9,280 @@
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/strings.h"
 
-#define NIBBLE_STR(c) (char)(c < 10 ? c + '0' : c - 10 + 'a')
-#define IS_PRINTABLE(c) (                           \
-    (c == 0) ||                                     \
-    (c == '!') ||                                   \
-    (c == '(') || (c == ')') || (c == '*') ||       \
-    (c == '-') || (c == '.') ||                     \
-    ((c >= '0') && (c <= '9')) ||                   \
-    ((c >= 'A') && (c <= 'Z')) ||                   \
-    (c == '_') ||                                   \
-    ((c >= 'a') && (c <= 'z'))                      \
-)
-
-static size_t URL_PrintableChar(unsigned char charVal, char* buffer)
-{
-    size_t size;
-    if (IS_PRINTABLE(charVal))
-    {
-        buffer[0] = (char)charVal;
-        size = 1;
+/*runs of characters that are not encoded are found 16 at a time with the vector instructions every CPU of the architecture has*/
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define URL_ENCODE_HAS_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define URL_ENCODE_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*the number of characters each byte encodes to: 1 for the characters .net HttpUtility.UrlEncode leaves alone, 3 for "%xx", 6 for the "%c2%xx" or "%c3%xx" of the bytes above 127*/
+static const unsigned char urlEncodedSize[256] =
+{
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 1, 3, 3, 3, 3, 3, 3, 1, 1, 1, 3, 3, 1, 1, 3,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3,
+    3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 1,
+    3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6
+};
+
+static const char urlHexDigits[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+/*the room left on the stack for URL_EncodeAppend before it allocates*/
+#define URL_ENCODE_APPEND_STACK_SIZE 256
+
+#if defined(URL_ENCODE_HAS_SSE2)
+static unsigned int url_count_trailing_zeros(unsigned int value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    (void)_BitScanForward(&index, value);
+    return (unsigned int)index;
+#else
+    return (unsigned int)__builtin_ctz(value);
+#endif
+}
+
+/*0xFF in the bytes that are between low and high, both included. The characters compared are all below 0x80, so the signed compares do*/
+#define URL_SSE2_IN_RANGE(chars, low, high) \
+    _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8((char)((low) - 1))), _mm_cmplt_epi8(chars, _mm_set1_epi8((char)((high) + 1))))
+
+/*returns the number of characters at the start of text that are not encoded*/
+static size_t url_unreserved_run(const unsigned char* text, size_t length)
+{
+    size_t result = 0;
+    while (length - result >= 16)
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i*)(text + result));
+        __m128i unreserved = _mm_or_si128(
+            _mm_or_si128(
+                _mm_or_si128(URL_SSE2_IN_RANGE(chars, '0', '9'), URL_SSE2_IN_RANGE(chars, 'A', 'Z')),
+                _mm_or_si128(URL_SSE2_IN_RANGE(chars, 'a', 'z'), URL_SSE2_IN_RANGE(chars, '(', '*'))),
+            _mm_or_si128(
+                _mm_or_si128(URL_SSE2_IN_RANGE(chars, '-', '.'), _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'))),
+                _mm_cmpeq_epi8(chars, _mm_set1_epi8('!'))));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(unreserved);
+        if (mask != 0xFFFF)
+        {
+            return result + url_count_trailing_zeros(~mask);
+        }
+        result += 16;
     }
-    else
+    while ((result < length) && (urlEncodedSize[text[result]] == 1))
     {
-        char bigNibbleStr;
-        char littleNibbleStr;
-        unsigned char bigNibbleVal = charVal >> 4;
-        unsigned char littleNibbleVal = charVal & 0x0F;
+        result++;
+    }
+    return result;
+}
+#elif defined(URL_ENCODE_HAS_NEON)
+#define URL_NEON_IN_RANGE(chars, low, high) \
+    vandq_u8(vcgeq_u8(chars, vdupq_n_u8(low)), vcleq_u8(chars, vdupq_n_u8(high)))
 
-        if (bigNibbleVal >= 0x0C)
+static size_t url_unreserved_run(const unsigned char* text, size_t length)
+{
+    size_t result = 0;
+    while (length - result >= 16)
+    {
+        uint8x16_t chars = vld1q_u8(text + result);
+        uint8x16_t unreserved = vorrq_u8(
+            vorrq_u8(
+                vorrq_u8(URL_NEON_IN_RANGE(chars, '0', '9'), URL_NEON_IN_RANGE(chars, 'A', 'Z')),
+                vorrq_u8(URL_NEON_IN_RANGE(chars, 'a', 'z'), URL_NEON_IN_RANGE(chars, '(', '*'))),
+            vorrq_u8(
+                vorrq_u8(URL_NEON_IN_RANGE(chars, '-', '.'), vceqq_u8(chars, vdupq_n_u8('_'))),
+                vceqq_u8(chars, vdupq_n_u8('!'))));
+        if (vminvq_u8(unreserved) != 0xFF)
         {
-            bigNibbleVal -= 0x04;
+            break;
         }
+        result += 16;
+    }
+    while ((result < length) && (urlEncodedSize[text[result]] == 1))
+    {
+        result++;
+    }
+    return result;
+}
+#else
+static size_t url_unreserved_run(const unsigned char* text, size_t length)
+{
+    size_t result = 0;
+    while ((result < length) && (urlEncodedSize[text[result]] == 1))
+    {
+        result++;
+    }
+    return result;
+}
+#endif
 
-        bigNibbleStr = NIBBLE_STR(bigNibbleVal);
-        littleNibbleStr = NIBBLE_STR(littleNibbleVal);
+/*writes the encoding of one character that is encoded, returns its size*/
+static size_t url_encode_char(unsigned char charVal, char* buffer)
+{
+    size_t size = urlEncodedSize[charVal];
+    buffer[0] = '%';
+    if (size == 3)
+    {
+        buffer[1] = urlHexDigits[charVal >> 4];
+        buffer[2] = urlHexDigits[charVal & 0x0F];
+    }
+    else
+    {
+        /*the UTF-8 encoding of the Latin-1 character*/
+        buffer[1] = 'c';
+        buffer[2] = (charVal < 0xC0) ? '2' : '3';
+        buffer[3] = '%';
+        buffer[4] = urlHexDigits[0x08 | ((charVal >> 4) & 0x03)];
+        buffer[5] = urlHexDigits[charVal & 0x0F];
+    }
+    return size;
+}
 
-        buffer[0] = '%';
+static int url_hex_value(char c)
+{
+    int result;
+    if ((c >= '0') && (c <= '9'))
+    {
+        result = c - '0';
+    }
+    else if ((c >= 'a') && (c <= 'f'))
+    {
+        result = c - 'a' + 10;
+    }
+    else if ((c >= 'A') && (c <= 'F'))
+    {
+        result = c - 'A' + 10;
+    }
+    else
+    {
+        result = -1;
+    }
+    return result;
+}
 
-        if (charVal < 0x80)
+size_t URL_Encode_Length(const char* text, size_t length)
+{
+    size_t result;
+    /*Codes_SRS_URL_ENCODE_99_001: [ If text is NULL, URL_Encode_Length shall return 0. ]*/
+    if (text == NULL)
+    {
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_URL_ENCODE_99_002: [ Otherwise URL_Encode_Length shall return the number of characters URL_Encode_Into writes for the length characters at text. ]*/
+        const unsigned char* position = (const unsigned char*)text;
+        size_t consumed = 0;
+        result = 0;
+        while (consumed < length)
         {
-            buffer[1] = bigNibbleStr;
-            buffer[2] = littleNibbleStr;
-            size = 3;
+            size_t run = url_unreserved_run(position + consumed, length - consumed);
+            result += run;
+            consumed += run;
+            if (consumed < length)
+            {
+                result += urlEncodedSize[position[consumed]];
+                consumed++;
+            }
         }
-        else
+    }
+    return result;
+}
+
+int URL_Encode_Into(const char* text, size_t length, char* destination, size_t destinationSize, size_t* encodedLength)
+{
+    int result;
+    /*Codes_SRS_URL_ENCODE_99_003: [ If text, destination or encodedLength is NULL, URL_Encode_Into shall fail and return a non-zero value. ]*/
+    if ((text == NULL) || (destination == NULL) || (encodedLength == NULL))
+    {
+        LogError("invalid argument const char* text=%p, char* destination=%p, size_t* encodedLength=%p", text, destination, encodedLength);
+        result = __FAILURE__;
+    }
+    else
+    {
+        const unsigned char* position = (const unsigned char*)text;
+        size_t consumed = 0;
+        size_t written = 0;
+        result = 0;
+
+        /*Codes_SRS_URL_ENCODE_99_004: [ URL_Encode_Into shall write in destination the length characters at text, each character encoded the way URL_Encode does, without a null terminator. ]*/
+        while (consumed < length)
         {
-            buffer[1] = 'c';
-            buffer[3] = '%';
-            buffer[4] = bigNibbleStr;
-            buffer[5] = littleNibbleStr;
-            if (charVal < 0xC0)
+            size_t run = url_unreserved_run(position + consumed, length - consumed);
+            /*Codes_SRS_URL_ENCODE_99_005: [ If destinationSize is smaller than the encoding, URL_Encode_Into shall fail and return a non-zero value. ]*/
+            if ((destinationSize - written < run) ||
+                ((consumed + run < length) && (destinationSize - written - run < urlEncodedSize[position[consumed + run]])))
             {
-                buffer[2] = '2';
+                LogError("destination too small: %lu characters available", (unsigned long)destinationSize);
+                result = __FAILURE__;
+                break;
             }
-            else
+            (void)memcpy(destination + written, position + consumed, run);
+            written += run;
+            consumed += run;
+            if (consumed < length)
             {
-                buffer[2] = '3';
+                written += url_encode_char(position[consumed], destination + written);
+                consumed++;
             }
-            size = 6;
         }
-    }
 
-    return size;
+        if (result == 0)
+        {
+            /*Codes_SRS_URL_ENCODE_99_006: [ On success URL_Encode_Into shall set encodedLength to the number of characters written and return 0. ]*/
+            *encodedLength = written;
+        }
+    }
+    return result;
 }
 
-static size_t URL_PrintableCharSize(unsigned char charVal)
+static STRING_HANDLE URL_Encode_Internal(const char* text)
 {
-    size_t size;
-    if (IS_PRINTABLE(charVal))
+    STRING_HANDLE result;
+    size_t length = strlen(text);
+    size_t encodedLength = URL_Encode_Length(text, length);
+    char* encodedURL;
+    if ((encodedURL = (char*)malloc(encodedLength + 1)) == NULL)
+    {
+        /*Codes_SRS_URL_ENCODE_06_002: [If an error occurs during the encoding of input then URL_Encode will return NULL.]*/
+        result = NULL;
+        LogError("URL_Encode:: MALLOC failure on encode.");
+    }
+    /*Codes_SRS_URL_ENCODE_06_003: [If input is a zero length string then URL_Encode will return a zero length string.]*/
+    else if (URL_Encode_Into(text, length, encodedURL, encodedLength, &encodedLength) != 0)
     {
-        size = 1;
+        /*Codes_SRS_URL_ENCODE_06_002: [If an error occurs during the encoding of input then URL_Encode will return NULL.]*/
+        result = NULL;
+        LogError("URL_Encode:: failure on encode.");
+        free(encodedURL);
     }
     else
     {
-        if (charVal < 0x80)
-        {
-            size = 3;
-        }
-        else
+        encodedURL[encodedLength] = '\0';
+        result = STRING_new_with_memory(encodedURL);
+        if (result == NULL)
         {
-            size = 6;
+            LogError("URL_Encode:: MALLOC failure on encode.");
+            free(encodedURL);
         }
     }
-    return size;
+    return result;
 }
 
 STRING_HANDLE URL_EncodeString(const char* textEncode)
@@ -103,65 +294,178 @@ STRING_HANDLE URL_EncodeString(const char* textEncode)
     }
     else
     {
-        STRING_HANDLE tempString = STRING_construct(textEncode);
-        if (tempString == NULL)
+        result = URL_Encode_Internal(textEncode);
+    }
+    return result;
+}
+
+STRING_HANDLE URL_Encode(STRING_HANDLE input)
+{
+    STRING_HANDLE result;
+    if (input == NULL)
+    {
+        /*Codes_SRS_URL_ENCODE_06_001: [If input is NULL then URL_Encode will return NULL.]*/
+        result = NULL;
+        LogError("URL_Encode:: NULL input");
+    }
+    else
+    {
+        result = URL_Encode_Internal(STRING_c_str(input));
+    }
+    return result;
+}
+
+int URL_EncodeAppend(STRING_HANDLE destination, const char* textEncode)
+{
+    int result;
+    /*Codes_SRS_URL_ENCODE_99_007: [ If destination or textEncode is NULL, URL_EncodeAppend shall fail and return a non-zero value. ]*/
+    if ((destination == NULL) || (textEncode == NULL))
+    {
+        LogError("invalid argument STRING_HANDLE destination=%p, const char* textEncode=%p", destination, textEncode);
+        result = __FAILURE__;
+    }
+    else
+    {
+        char stackBuffer[URL_ENCODE_APPEND_STACK_SIZE];
+        size_t length = strlen(textEncode);
+        size_t encodedLength = URL_Encode_Length(textEncode, length);
+        /*short texts, such as the parts of a SAS token, are encoded on the stack*/
+        char* encoded = (encodedLength < sizeof(stackBuffer)) ? stackBuffer : (char*)malloc(encodedLength + 1);
+        if (encoded == NULL)
         {
-            result = NULL;
+            /*Codes_SRS_URL_ENCODE_99_009: [ If any error occurs, URL_EncodeAppend shall fail, leave destination unchanged and return a non-zero value. ]*/
+            LogError("URL_EncodeAppend:: MALLOC failure on encode.");
+            result = __FAILURE__;
         }
         else
         {
-            result = URL_Encode(tempString);
-            STRING_delete(tempString);
+            /*Codes_SRS_URL_ENCODE_99_008: [ Otherwise URL_EncodeAppend shall append the encoding of textEncode, as URL_EncodeString produces it, to destination and return 0. ]*/
+            if (URL_Encode_Into(textEncode, length, encoded, encodedLength, &encodedLength) != 0)
+            {
+                /*Codes_SRS_URL_ENCODE_99_009: [ If any error occurs, URL_EncodeAppend shall fail, leave destination unchanged and return a non-zero value. ]*/
+                LogError("URL_EncodeAppend:: failure on encode.");
+                result = __FAILURE__;
+            }
+            else
+            {
+                encoded[encodedLength] = '\0';
+                if (STRING_concat(destination, encoded) != 0)
+                {
+                    /*Codes_SRS_URL_ENCODE_99_009: [ If any error occurs, URL_EncodeAppend shall fail, leave destination unchanged and return a non-zero value. ]*/
+                    LogError("URL_EncodeAppend:: STRING_concat failed.");
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    result = 0;
+                }
+            }
+
+            if (encoded != stackBuffer)
+            {
+                free(encoded);
+            }
         }
     }
     return result;
 }
 
-STRING_HANDLE URL_Encode(STRING_HANDLE input)
+static STRING_HANDLE URL_Decode_Internal(const char* text)
 {
     STRING_HANDLE result;
-    if (input == NULL)
+    size_t length = strlen(text);
+    /*the decoding is never longer than the encoding*/
+    char* decoded = (char*)malloc(length + 1);
+    if (decoded == NULL)
     {
-        /*Codes_SRS_URL_ENCODE_06_001: [If input is NULL then URL_Encode will return NULL.]*/
+        /*Codes_SRS_URL_ENCODE_99_012: [ If any error occurs, URL_Decode shall return NULL. ]*/
+        LogError("URL_Decode:: MALLOC failure on decode.");
         result = NULL;
-        LogError("URL_Encode:: NULL input");
     }
     else
     {
-        size_t lengthOfResult = 0;
-        char* encodedURL;
-        const char* currentInput;
-        unsigned char currentUnsignedChar;
-        currentInput = STRING_c_str(input);
-        /*Codes_SRS_URL_ENCODE_06_003: [If input is a zero length string then URL_Encode will return a zero length string.]*/
-        do
+        const char* position = text;
+        const char* end = text + length;
+        size_t written = 0;
+        int isValid = 1;
+
+        /*Codes_SRS_URL_ENCODE_99_011: [ URL_Decode shall return a new STRING with each "%xx" of input, xx being 2 hexadecimal digits in either case, replaced by the byte xx, and all the other characters copied. ]*/
+        while (position < end)
         {
-            currentUnsignedChar = (unsigned char)(*currentInput++);
-            lengthOfResult += URL_PrintableCharSize(currentUnsignedChar);
-        } while (currentUnsignedChar != 0);
-        if ((encodedURL = (char*)malloc(lengthOfResult)) == NULL)
+            /*the characters up to the next '%' are copied as they are*/
+            const char* percent = (const char*)memchr(position, '%', (size_t)(end - position));
+            size_t run = (percent == NULL) ? (size_t)(end - position) : (size_t)(percent - position);
+            (void)memcpy(decoded + written, position, run);
+            written += run;
+            position += run;
+            if (percent != NULL)
+            {
+                int high;
+                int low;
+                /*Codes_SRS_URL_ENCODE_99_013: [ If input has a '%' that is not followed by 2 hexadecimal digits, or a "%00", URL_Decode shall return NULL. ]*/
+                if ((end - percent < 3) ||
+                    ((high = url_hex_value(percent[1])) < 0) ||
+                    ((low = url_hex_value(percent[2])) < 0) ||
+                    ((high | low) == 0))
+                {
+                    isValid = 0;
+                    break;
+                }
+                decoded[written++] = (char)((high << 4) | low);
+                position += 3;
+            }
+        }
+
+        if (!isValid)
         {
-            /*Codes_SRS_URL_ENCODE_06_002: [If an error occurs during the encoding of input then URL_Encode will return NULL.]*/
+            LogError("URL_Decode:: invalid escape at position %lu.", (unsigned long)(position - text));
+            free(decoded);
             result = NULL;
-            LogError("URL_Encode:: MALLOC failure on encode.");
         }
         else
         {
-            size_t currentEncodePosition = 0;
-            currentInput = STRING_c_str(input);
-            do
-            {
-                currentUnsignedChar = (unsigned char)(*currentInput++);
-                currentEncodePosition += URL_PrintableChar(currentUnsignedChar, &encodedURL[currentEncodePosition]);
-            } while (currentUnsignedChar != 0);
-
-            result = STRING_new_with_memory(encodedURL);
+            decoded[written] = '\0';
+            result = STRING_new_with_memory(decoded);
             if (result == NULL)
             {
-                LogError("URL_Encode:: MALLOC failure on encode.");
-                free(encodedURL);
+                /*Codes_SRS_URL_ENCODE_99_012: [ If any error occurs, URL_Decode shall return NULL. ]*/
+                LogError("URL_Decode:: MALLOC failure on decode.");
+                free(decoded);
             }
         }
     }
     return result;
 }
+
+STRING_HANDLE URL_DecodeString(const char* textDecode)
+{
+    STRING_HANDLE result;
+    /*Codes_SRS_URL_ENCODE_99_014: [ If textDecode is NULL, URL_DecodeString shall return NULL. ]*/
+    if (textDecode == NULL)
+    {
+        LogError("URL_DecodeString:: NULL input");
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_URL_ENCODE_99_015: [ Otherwise URL_DecodeString shall decode textDecode the way URL_Decode does. ]*/
+        result = URL_Decode_Internal(textDecode);
+    }
+    return result;
+}
+
+STRING_HANDLE URL_Decode(STRING_HANDLE input)
+{
+    STRING_HANDLE result;
+    /*Codes_SRS_URL_ENCODE_99_010: [ If input is NULL, URL_Decode shall return NULL. ]*/
+    if (input == NULL)
+    {
+        LogError("URL_Decode:: NULL input");
+        result = NULL;
+    }
+    else
+    {
+        result = URL_Decode_Internal(STRING_c_str(input));
+    }
+    return result;
+}
@@ -1,4 +1,4 @@
- // Copyright (c) Microsoft. All rights reserved.
+// Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #ifdef __cplusplus
@@ -6,93 +6,88 @@
 #include <cstdbool>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #else
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #endif
 
 #include "azure_c_shared_utility/utf8_checker.h"
+#include "azure_c_shared_utility/xlogging.h"
 
-bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
-{
-    bool result;
+/* the vectorized validators are only compiled when the compiler can generate the instructions, and only used when the CPU has them */
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && \
+    ((defined(__GNUC__) && !defined(__clang__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || \
+     (defined(__clang__) && ((__clang_major__ > 3) || ((__clang_major__ == 3) && (__clang_minor__ >= 4)))) || \
+     (defined(_MSC_VER) && (_MSC_VER >= 1900)))
+#define UTF8_CHECKER_HAS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define UTF8_CHECKER_X86_TARGET(features)
+#else
+#include <cpuid.h>
+#define UTF8_CHECKER_X86_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
 
-    if (utf8_str == NULL)
-    {
-        /* Codes_SRS_UTF8_CHECKER_01_002: [ If `utf8_checker_is_valid_utf8` is called with NULL `utf8_str` it shall return false. ]*/
-        result = false;
-    }
-    else
-    {
-        size_t pos = 0;
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define UTF8_CHECKER_HAS_NEON
+#include <arm_neon.h>
+#endif
 
-        /* Codes_SRS_UTF8_CHECKER_01_003: [ If `length` is 0, `utf8_checker_is_valid_utf8` shall consider `utf8_str` to be valid UTF-8 and return true. ]*/
-        result = true;
+DEFINE_ENUM_STRINGS(UTF8_CHECKER_IMPLEMENTATION, UTF8_CHECKER_IMPLEMENTATION_VALUES);
 
-        while ((result == true) &&
-               (pos < length))
-        {
-            /* Codes_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
-            if ((utf8_str[pos] >> 3) == 0x1E)
-            {
-                /* 4 bytes */
-                /* Codes_SRS_UTF8_CHECKER_01_009: [ 000uuuuu zzzzyyyy yyxxxxxx 11110uuu 10uuzzzz 10yyyyyy 10xxxxxx ]*/
-                uint32_t code_point = (utf8_str[pos] & 0x07);
+/* validates length bytes; a sequence cut by the end of the bytes is invalid */
+typedef bool(*UTF8_CHECKER_VALIDATE)(const unsigned char* utf8_str, size_t length);
 
-                pos++;
-                if ((pos < length) &&
-                    ((utf8_str[pos] >> 6) == 0x02))
-                {
-                    code_point <<= 6;
-                    code_point += utf8_str[pos] & 0x3F;
+typedef struct UTF8_CHECKER_VALIDATOR_TAG
+{
+    UTF8_CHECKER_IMPLEMENTATION implementation;
+    UTF8_CHECKER_VALIDATE validate;
+} UTF8_CHECKER_VALIDATOR;
 
-                    pos++;
-                    if ((pos < length) &&
-                        ((utf8_str[pos] >> 6) == 0x02))
-                    {
-                        code_point <<= 6;
-                        code_point += utf8_str[pos] & 0x3F;
+/* the validator in use, picked on first use; concurrent first uses all store the same value */
+static const UTF8_CHECKER_VALIDATOR* utf8_checker_validator = NULL;
 
-                        pos++;
-                        if ((pos < length) &&
-                            ((utf8_str[pos] >> 6) == 0x02))
-                        {
-                            code_point <<= 6;
-                            code_point += utf8_str[pos] & 0x3F;
-
-                            if (code_point <= 0xFFFF)
-                            {
-                                result = false;
-                            }
-                            else
-                            {
-                                /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
-                                result = true;
-                                pos++;
-                            }
-                        }
-                        else
-                        {
-                            result = false;
-                        }
-                    }
-                    else
-                    {
-                        result = false;
-                    }
-                }
-                else
-                {
-                    result = false;
-                }
-            }
-            else if ((utf8_str[pos] >> 4) == 0x0E)
+static bool is_ascii_8(const unsigned char* bytes)
+{
+    uint64_t eight_bytes;
+    (void)memcpy(&eight_bytes, bytes, sizeof(eight_bytes));
+    return (eight_bytes & 0x8080808080808080ULL) == 0;
+}
+
+static bool validate_scalar(const unsigned char* utf8_str, size_t length)
+{
+    bool result = true;
+    size_t pos = 0;
+
+    while ((result == true) &&
+           (pos < length))
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_001: [ `utf8_checker_is_valid_utf8` shall skip runs of ASCII characters several bytes at a time. ]*/
+        if ((utf8_str[pos] < 0x80) &&
+            (length - pos >= 8) &&
+            is_ascii_8(utf8_str + pos))
+        {
+            pos += 8;
+        }
+        /* Codes_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
+        else if ((utf8_str[pos] >> 3) == 0x1E)
+        {
+            /* 4 bytes */
+            /* Codes_SRS_UTF8_CHECKER_01_009: [ 000uuuuu zzzzyyyy yyxxxxxx 11110uuu 10uuzzzz 10yyyyyy 10xxxxxx ]*/
+            uint32_t code_point = (utf8_str[pos] & 0x07);
+
+            pos++;
+            if ((pos < length) &&
+                ((utf8_str[pos] >> 6) == 0x02))
             {
-                /* 3 bytes */
-                /* Codes_SRS_UTF8_CHECKER_01_008: [ zzzzyyyy yyxxxxxx 1110zzzz 10yyyyyy 10xxxxxx ]*/
-                uint32_t code_point = (utf8_str[pos] & 0x0F);
+                code_point <<= 6;
+                code_point += utf8_str[pos] & 0x3F;
 
                 pos++;
                 if ((pos < length) &&
@@ -108,7 +103,7 @@ bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
                         code_point <<= 6;
                         code_point += utf8_str[pos] & 0x3F;
 
-                        if (code_point <= 0x7FF)
+                        if (code_point <= 0xFFFF)
                         {
                             result = false;
                         }
@@ -129,11 +124,23 @@ bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
                     result = false;
                 }
             }
-            else if ((utf8_str[pos] >> 5) == 0x06)
+            else
+            {
+                result = false;
+            }
+        }
+        else if ((utf8_str[pos] >> 4) == 0x0E)
+        {
+            /* 3 bytes */
+            /* Codes_SRS_UTF8_CHECKER_01_008: [ zzzzyyyy yyxxxxxx 1110zzzz 10yyyyyy 10xxxxxx ]*/
+            uint32_t code_point = (utf8_str[pos] & 0x0F);
+
+            pos++;
+            if ((pos < length) &&
+                ((utf8_str[pos] >> 6) == 0x02))
             {
-                /* 2 bytes */
-                /* Codes_SRS_UTF8_CHECKER_01_007: [ 00000yyy yyxxxxxx 110yyyyy 10xxxxxx ]*/
-                uint32_t code_point = (utf8_str[pos] & 0x1F);
+                code_point <<= 6;
+                code_point += utf8_str[pos] & 0x3F;
 
                 pos++;
                 if ((pos < length) &&
@@ -142,7 +149,7 @@ bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
                     code_point <<= 6;
                     code_point += utf8_str[pos] & 0x3F;
 
-                    if (code_point <= 0x7F)
+                    if (code_point <= 0x7FF)
                     {
                         result = false;
                     }
@@ -158,21 +165,603 @@ bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
                     result = false;
                 }
             }
-            else if ((utf8_str[pos] >> 7) == 0x00)
+            else
             {
-                /* 1 byte */
-                /* Codes_SRS_UTF8_CHECKER_01_006: [ 00000000 0xxxxxxx 0xxxxxxx ]*/
-                /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
-                result = true;
-                pos++;
+                result = false;
+            }
+        }
+        else if ((utf8_str[pos] >> 5) == 0x06)
+        {
+            /* 2 bytes */
+            /* Codes_SRS_UTF8_CHECKER_01_007: [ 00000yyy yyxxxxxx 110yyyyy 10xxxxxx ]*/
+            uint32_t code_point = (utf8_str[pos] & 0x1F);
+
+            pos++;
+            if ((pos < length) &&
+                ((utf8_str[pos] >> 6) == 0x02))
+            {
+                code_point <<= 6;
+                code_point += utf8_str[pos] & 0x3F;
+
+                if (code_point <= 0x7F)
+                {
+                    result = false;
+                }
+                else
+                {
+                    /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
+                    result = true;
+                    pos++;
+                }
             }
             else
             {
-                /* error */
                 result = false;
             }
         }
+        else if ((utf8_str[pos] >> 7) == 0x00)
+        {
+            /* 1 byte */
+            /* Codes_SRS_UTF8_CHECKER_01_006: [ 00000000 0xxxxxxx 0xxxxxxx ]*/
+            /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
+            result = true;
+            pos++;
+        }
+        else
+        {
+            /* error */
+            result = false;
+        }
     }
 
     return result;
 }
+
+static const UTF8_CHECKER_VALIDATOR utf8_checker_validator_scalar = { UTF8_CHECKER_IMPLEMENTATION_SCALAR, validate_scalar };
+
+/*
+ * The vectorized validators look each byte up together with the byte before it (J. Keiser, D. Lemire, "Validating UTF-8 In Less
+ * Than One Instruction Per Byte"). Three 16 entry tables, indexed by the high and the low nibble of the previous byte and by the
+ * high nibble of the byte, have a bit per kind of error; a byte is in error when the bit is set in all three. The tables follow
+ * the rules of validate_scalar: overlong forms are rejected, but surrogates and code points up to 0x1FFFFF (F5 to F7 leads) are
+ * accepted. Whether the 3rd and 4th bytes of a sequence are continuation bytes is checked apart, from the bytes 2 and 3 back.
+ */
+#define UTF8_TOO_SHORT      0x01    /* a lead byte not followed by a continuation byte */
+#define UTF8_TOO_LONG       0x02    /* a continuation byte after an ASCII character */
+#define UTF8_OVERLONG_2     0x04    /* C0 and C1 */
+#define UTF8_OVERLONG_3     0x08    /* E0 followed by 80 to 9F */
+#define UTF8_OVERLONG_4     0x10    /* F0 followed by 80 to 8F */
+#define UTF8_TOO_LARGE      0x20    /* F8 to FF */
+#define UTF8_TWO_CONTS      0x80    /* 2 continuation bytes in a row, an error unless the 2nd one is the 3rd or 4th byte of a sequence */
+
+#define UTF8_BYTE_1_HIGH                                                                        \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,                                 \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,                                 \
+    (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS,     \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2, UTF8_TOO_SHORT,                                           \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3, UTF8_TOO_SHORT | UTF8_OVERLONG_4 | UTF8_TOO_LARGE
+
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#define UTF8_BYTE_1_LOW                                                                                                 \
+    (char)(UTF8_CARRY | UTF8_OVERLONG_2 | UTF8_OVERLONG_3 | UTF8_OVERLONG_4), (char)(UTF8_CARRY | UTF8_OVERLONG_2),    \
+    (char)UTF8_CARRY, (char)UTF8_CARRY, (char)UTF8_CARRY, (char)UTF8_CARRY, (char)UTF8_CARRY, (char)UTF8_CARRY,         \
+    (char)(UTF8_CARRY | UTF8_TOO_LARGE), (char)(UTF8_CARRY | UTF8_TOO_LARGE),                                           \
+    (char)(UTF8_CARRY | UTF8_TOO_LARGE), (char)(UTF8_CARRY | UTF8_TOO_LARGE),                                           \
+    (char)(UTF8_CARRY | UTF8_TOO_LARGE), (char)(UTF8_CARRY | UTF8_TOO_LARGE),                                           \
+    (char)(UTF8_CARRY | UTF8_TOO_LARGE), (char)(UTF8_CARRY | UTF8_TOO_LARGE)
+
+#define UTF8_BYTE_2_HIGH                                                                                                            \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+    (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_OVERLONG_3 | UTF8_OVERLONG_4 | UTF8_TOO_LARGE | UTF8_TWO_CONTS),                  \
+    (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_OVERLONG_3 | UTF8_TOO_LARGE | UTF8_TWO_CONTS),                                    \
+    (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TOO_LARGE | UTF8_TWO_CONTS),                                                      \
+    (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TOO_LARGE | UTF8_TWO_CONTS),                                                      \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+/* subtracted with saturation from the last 3 bytes of a block, non zero when a sequence goes on in the next block */
+#define UTF8_INCOMPLETE_MAX_LAST_3 (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1)
+
+#ifdef UTF8_CHECKER_HAS_X86
+#define UTF8_CHECKER_X86_ECX1_SSSE3        (1u << 9)
+#define UTF8_CHECKER_X86_ECX1_OSXSAVE      (1u << 27)
+#define UTF8_CHECKER_X86_ECX1_AVX          (1u << 28)
+#define UTF8_CHECKER_X86_EBX7_AVX2         (1u << 5)
+#define UTF8_CHECKER_X86_XCR0_YMM          0x06u  /* SSE and AVX state */
+
+/* reads ECX of CPUID leaf 1, EBX of leaf 7 and, when the OS saves the extended states, XCR0 */
+static void utf8_checker_x86_get_features(unsigned int* ecx1, unsigned int* ebx7, unsigned int* xcr0)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        *ecx1 = *ebx7 = *xcr0 = 0;
+        return;
+    }
+    __cpuid(info, 1);
+    *ecx1 = (unsigned int)info[2];
+    __cpuidex(info, 7, 0);
+    *ebx7 = (unsigned int)info[1];
+    *xcr0 = ((*ecx1 & UTF8_CHECKER_X86_ECX1_OSXSAVE) != 0) ? (unsigned int)_xgetbv(0) : 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, NULL) < 7)
+    {
+        *ecx1 = *ebx7 = *xcr0 = 0;
+        return;
+    }
+    __cpuid_count(1, 0, eax, ebx, ecx, edx);
+    *ecx1 = ecx;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    *ebx7 = ebx;
+    if ((*ecx1 & UTF8_CHECKER_X86_ECX1_OSXSAVE) != 0)
+    {
+        /* xgetbv, spelled out for assemblers that do not know it */
+        __asm__ volatile (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+        *xcr0 = eax;
+    }
+    else
+    {
+        *xcr0 = 0;
+    }
+#endif
+}
+
+UTF8_CHECKER_X86_TARGET("ssse3")
+static __m128i check_block_ssse3(__m128i input, __m128i prev_input)
+{
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 16 - 1);
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 16 - 2);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 16 - 3);
+    __m128i low_nibble_mask = _mm_set1_epi8(0x0F);
+    __m128i special_cases = _mm_and_si128(_mm_and_si128(
+        _mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_1_HIGH), _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble_mask)),
+        _mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_1_LOW), _mm_and_si128(prev1, low_nibble_mask))),
+        _mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_2_HIGH), _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble_mask)));
+    /* 0x80 where the byte has to be the 3rd or 4th byte of a sequence */
+    __m128i must_be_2_3_continuation = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 1))), _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 1))));
+    __m128i must_2_3_80 = _mm_and_si128(_mm_cmpgt_epi8(must_be_2_3_continuation, _mm_setzero_si128()), _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must_2_3_80, special_cases);
+}
+
+UTF8_CHECKER_X86_TARGET("ssse3")
+static bool validate_ssse3(const unsigned char* utf8_str, size_t length)
+{
+    __m128i error = _mm_setzero_si128();
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    __m128i incomplete_max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, UTF8_INCOMPLETE_MAX_LAST_3);
+    unsigned char last_block[16];
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        __m128i input;
+        if (length - pos >= 16)
+        {
+            input = _mm_loadu_si128((const __m128i*)(utf8_str + pos));
+        }
+        else
+        {
+            /* the padding is ASCII, so that a sequence cut by the end is too short */
+            (void)memset(last_block, 0, sizeof(last_block));
+            (void)memcpy(last_block, utf8_str + pos, length - pos);
+            input = _mm_loadu_si128((const __m128i*)last_block);
+        }
+
+        if (_mm_movemask_epi8(input) == 0)
+        {
+            /* ASCII only, the block before must not have ended in the middle of a sequence */
+            error = _mm_or_si128(error, prev_incomplete);
+            prev_incomplete = _mm_setzero_si128();
+        }
+        else
+        {
+            error = _mm_or_si128(error, check_block_ssse3(input, prev_input));
+            prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+        }
+        prev_input = input;
+        pos += 16;
+    }
+
+    error = _mm_or_si128(error, prev_incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+static const UTF8_CHECKER_VALIDATOR utf8_checker_validator_ssse3 = { UTF8_CHECKER_IMPLEMENTATION_SSSE3, validate_ssse3 };
+
+static int utf8_checker_ssse3_supported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+    utf8_checker_x86_get_features(&ecx1, &ebx7, &xcr0);
+    return (ecx1 & UTF8_CHECKER_X86_ECX1_SSSE3) != 0;
+}
+
+UTF8_CHECKER_X86_TARGET("avx2")
+static __m256i check_block_avx2(__m256i input, __m256i prev_input)
+{
+    /* the last 16 bytes of the previous block, then the first 16 bytes of this one */
+    __m256i shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, shifted, 16 - 1);
+    __m256i prev2 = _mm256_alignr_epi8(input, shifted, 16 - 2);
+    __m256i prev3 = _mm256_alignr_epi8(input, shifted, 16 - 3);
+    __m256i low_nibble_mask = _mm256_set1_epi8(0x0F);
+    __m256i special_cases = _mm256_and_si256(_mm256_and_si256(
+        _mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_1_HIGH, UTF8_BYTE_1_HIGH), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble_mask)),
+        _mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_1_LOW, UTF8_BYTE_1_LOW), _mm256_and_si256(prev1, low_nibble_mask))),
+        _mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_2_HIGH, UTF8_BYTE_2_HIGH), _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble_mask)));
+    __m256i must_be_2_3_continuation = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 1))), _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 1))));
+    __m256i must_2_3_80 = _mm256_and_si256(_mm256_cmpgt_epi8(must_be_2_3_continuation, _mm256_setzero_si256()), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(must_2_3_80, special_cases);
+}
+
+UTF8_CHECKER_X86_TARGET("avx2")
+static bool validate_avx2(const unsigned char* utf8_str, size_t length)
+{
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    __m256i incomplete_max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, UTF8_INCOMPLETE_MAX_LAST_3);
+    unsigned char last_block[32];
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        __m256i input;
+        if (length - pos >= 32)
+        {
+            input = _mm256_loadu_si256((const __m256i*)(utf8_str + pos));
+        }
+        else
+        {
+            (void)memset(last_block, 0, sizeof(last_block));
+            (void)memcpy(last_block, utf8_str + pos, length - pos);
+            input = _mm256_loadu_si256((const __m256i*)last_block);
+        }
+
+        if (_mm256_movemask_epi8(input) == 0)
+        {
+            error = _mm256_or_si256(error, prev_incomplete);
+            prev_incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            error = _mm256_or_si256(error, check_block_avx2(input, prev_input));
+            prev_incomplete = _mm256_subs_epu8(input, incomplete_max);
+        }
+        prev_input = input;
+        pos += 32;
+    }
+
+    error = _mm256_or_si256(error, prev_incomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+static const UTF8_CHECKER_VALIDATOR utf8_checker_validator_avx2 = { UTF8_CHECKER_IMPLEMENTATION_AVX2, validate_avx2 };
+
+static int utf8_checker_avx2_supported(void)
+{
+    unsigned int ecx1, ebx7, xcr0;
+    utf8_checker_x86_get_features(&ecx1, &ebx7, &xcr0);
+    return ((ecx1 & UTF8_CHECKER_X86_ECX1_AVX) != 0) &&
+        ((xcr0 & UTF8_CHECKER_X86_XCR0_YMM) == UTF8_CHECKER_X86_XCR0_YMM) &&
+        ((ebx7 & UTF8_CHECKER_X86_EBX7_AVX2) != 0);
+}
+#endif /* UTF8_CHECKER_HAS_X86 */
+
+#ifdef UTF8_CHECKER_HAS_NEON
+static const uint8_t utf8_byte_1_high[16] = { UTF8_BYTE_1_HIGH };
+static const uint8_t utf8_byte_1_low[16] = { UTF8_BYTE_1_LOW };
+static const uint8_t utf8_byte_2_high[16] = { UTF8_BYTE_2_HIGH };
+static const uint8_t utf8_incomplete_max[16] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1 };
+
+static uint8x16_t check_block_neon(uint8x16_t input, uint8x16_t prev_input)
+{
+    uint8x16_t prev1 = vextq_u8(prev_input, input, 16 - 1);
+    uint8x16_t prev2 = vextq_u8(prev_input, input, 16 - 2);
+    uint8x16_t prev3 = vextq_u8(prev_input, input, 16 - 3);
+    uint8x16_t special_cases = vandq_u8(vandq_u8(
+        vqtbl1q_u8(vld1q_u8(utf8_byte_1_high), vshrq_n_u8(prev1, 4)),
+        vqtbl1q_u8(vld1q_u8(utf8_byte_1_low), vandq_u8(prev1, vdupq_n_u8(0x0F)))),
+        vqtbl1q_u8(vld1q_u8(utf8_byte_2_high), vshrq_n_u8(input, 4)));
+    uint8x16_t must_be_2_3_continuation = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 1)), vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 1)));
+    uint8x16_t must_2_3_80 = vandq_u8(vcgtq_u8(must_be_2_3_continuation, vdupq_n_u8(0)), vdupq_n_u8(0x80));
+    return veorq_u8(must_2_3_80, special_cases);
+}
+
+static bool validate_neon(const unsigned char* utf8_str, size_t length)
+{
+    uint8x16_t error = vdupq_n_u8(0);
+    uint8x16_t prev_input = vdupq_n_u8(0);
+    uint8x16_t prev_incomplete = vdupq_n_u8(0);
+    uint8x16_t incomplete_max = vld1q_u8(utf8_incomplete_max);
+    unsigned char last_block[16];
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        uint8x16_t input;
+        if (length - pos >= 16)
+        {
+            input = vld1q_u8(utf8_str + pos);
+        }
+        else
+        {
+            (void)memset(last_block, 0, sizeof(last_block));
+            (void)memcpy(last_block, utf8_str + pos, length - pos);
+            input = vld1q_u8(last_block);
+        }
+
+        if (vmaxvq_u8(input) < 0x80)
+        {
+            error = vorrq_u8(error, prev_incomplete);
+            prev_incomplete = vdupq_n_u8(0);
+        }
+        else
+        {
+            error = vorrq_u8(error, check_block_neon(input, prev_input));
+            prev_incomplete = vqsubq_u8(input, incomplete_max);
+        }
+        prev_input = input;
+        pos += 16;
+    }
+
+    error = vorrq_u8(error, prev_incomplete);
+    return vmaxvq_u8(error) == 0;
+}
+
+static const UTF8_CHECKER_VALIDATOR utf8_checker_validator_neon = { UTF8_CHECKER_IMPLEMENTATION_NEON, validate_neon };
+#endif /* UTF8_CHECKER_HAS_NEON */
+
+static const UTF8_CHECKER_VALIDATOR* get_supported_validator(UTF8_CHECKER_IMPLEMENTATION implementation)
+{
+    const UTF8_CHECKER_VALIDATOR* result;
+    switch (implementation)
+    {
+    case UTF8_CHECKER_IMPLEMENTATION_SCALAR:
+        result = &utf8_checker_validator_scalar;
+        break;
+#ifdef UTF8_CHECKER_HAS_X86
+    case UTF8_CHECKER_IMPLEMENTATION_SSSE3:
+        result = utf8_checker_ssse3_supported() ? &utf8_checker_validator_ssse3 : NULL;
+        break;
+    case UTF8_CHECKER_IMPLEMENTATION_AVX2:
+        result = utf8_checker_avx2_supported() ? &utf8_checker_validator_avx2 : NULL;
+        break;
+#endif
+#ifdef UTF8_CHECKER_HAS_NEON
+    case UTF8_CHECKER_IMPLEMENTATION_NEON:
+        result = &utf8_checker_validator_neon;
+        break;
+#endif
+    default:
+        result = NULL;
+        break;
+    }
+    return result;
+}
+
+static const UTF8_CHECKER_VALIDATOR* get_validator(void)
+{
+    if (utf8_checker_validator == NULL)
+    {
+        const UTF8_CHECKER_VALIDATOR* validator;
+        if (((validator = get_supported_validator(UTF8_CHECKER_IMPLEMENTATION_AVX2)) == NULL) &&
+            ((validator = get_supported_validator(UTF8_CHECKER_IMPLEMENTATION_SSSE3)) == NULL) &&
+            ((validator = get_supported_validator(UTF8_CHECKER_IMPLEMENTATION_NEON)) == NULL))
+        {
+            validator = &utf8_checker_validator_scalar;
+        }
+        utf8_checker_validator = validator;
+    }
+    return utf8_checker_validator;
+}
+
+/* the number of bytes of the sequence that lead starts, 0 for a continuation byte or a byte that never appears in UTF-8 */
+static size_t get_sequence_length(unsigned char lead)
+{
+    size_t result;
+    if (lead < 0x80)
+    {
+        result = 1;
+    }
+    else if (lead < 0xC0)
+    {
+        result = 0;
+    }
+    else if (lead < 0xE0)
+    {
+        result = 2;
+    }
+    else if (lead < 0xF0)
+    {
+        result = 3;
+    }
+    else if (lead < 0xF8)
+    {
+        result = 4;
+    }
+    else
+    {
+        result = 0;
+    }
+    return result;
+}
+
+bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
+{
+    bool result;
+
+    if (utf8_str == NULL)
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_002: [ If `utf8_checker_is_valid_utf8` is called with NULL `utf8_str` it shall return false. ]*/
+        result = false;
+    }
+    else
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_003: [ If `length` is 0, `utf8_checker_is_valid_utf8` shall consider `utf8_str` to be valid UTF-8 and return true. ]*/
+        /* Codes_SRS_UTF8_CHECKER_99_002: [ `utf8_checker_is_valid_utf8` shall validate with the implementation in use, which shall accept and reject exactly the same sequences as the byte by byte validation. ]*/
+        result = get_validator()->validate(utf8_str, length);
+    }
+
+    return result;
+}
+
+int utf8_checker_select_implementation(UTF8_CHECKER_IMPLEMENTATION implementation)
+{
+    int result;
+    const UTF8_CHECKER_VALIDATOR* validator = get_supported_validator(implementation);
+
+    /* Codes_SRS_UTF8_CHECKER_99_003: [ If `implementation` is not supported by this build or by this CPU, `utf8_checker_select_implementation` shall fail and return a non-zero value. ]*/
+    if (validator == NULL)
+    {
+        LogError("utf8_checker implementation %s is not supported", ENUM_TO_STRING(UTF8_CHECKER_IMPLEMENTATION, implementation));
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_004: [ Otherwise `utf8_checker_select_implementation` shall make all the validation functions use `implementation` and return 0. ]*/
+        utf8_checker_validator = validator;
+        result = 0;
+    }
+    return result;
+}
+
+UTF8_CHECKER_IMPLEMENTATION utf8_checker_get_implementation(void)
+{
+    /* Codes_SRS_UTF8_CHECKER_99_005: [ `utf8_checker_get_implementation` shall return the implementation in use, picking the fastest one supported by the CPU if none is selected yet. ]*/
+    return get_validator()->implementation;
+}
+
+int utf8_checker_init(UTF8_CHECKER_CONTEXT* context)
+{
+    int result;
+    /* Codes_SRS_UTF8_CHECKER_99_006: [ If `context` is NULL, `utf8_checker_init` shall fail and return a non-zero value. ]*/
+    if (context == NULL)
+    {
+        LogError("invalid argument UTF8_CHECKER_CONTEXT* context=%p", context);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_007: [ Otherwise `utf8_checker_init` shall start a validation with no bytes seen and return 0. ]*/
+        context->pending_length = 0;
+        context->is_valid = true;
+        result = 0;
+    }
+    return result;
+}
+
+bool utf8_checker_update(UTF8_CHECKER_CONTEXT* context, const unsigned char* utf8_str, size_t length)
+{
+    bool result;
+    if (context == NULL)
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_008: [ If `context` is NULL, `utf8_checker_update` shall return false. ]*/
+        LogError("invalid argument UTF8_CHECKER_CONTEXT* context=%p", context);
+        result = false;
+    }
+    else if ((utf8_str == NULL) && (length > 0))
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_009: [ If `utf8_str` is NULL and `length` is not 0, `utf8_checker_update` shall fail the whole validation and return false. ]*/
+        LogError("invalid argument const unsigned char* utf8_str=%p, size_t length=%lu", utf8_str, (unsigned long)length);
+        context->is_valid = false;
+        result = false;
+    }
+    else if (!context->is_valid)
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_010: [ Once a validation has failed, `utf8_checker_update` shall return false without looking at `utf8_str`. ]*/
+        result = false;
+    }
+    else
+    {
+        size_t pos = 0;
+        result = true;
+
+        if (context->pending_length > 0)
+        {
+            /* Codes_SRS_UTF8_CHECKER_99_011: [ A sequence cut by the end of the previous bytes shall be completed with the first bytes of `utf8_str` and validated as a whole. ]*/
+            unsigned char sequence[4];
+            size_t sequence_length = get_sequence_length(context->pending[0]);
+            size_t i;
+
+            (void)memcpy(sequence, context->pending, context->pending_length);
+            while ((context->pending_length < sequence_length) &&
+                (pos < length))
+            {
+                sequence[context->pending_length++] = utf8_str[pos++];
+            }
+
+            if (context->pending_length == sequence_length)
+            {
+                result = validate_scalar(sequence, sequence_length);
+                context->pending_length = 0;
+            }
+            else
+            {
+                /* still cut: what is there so far has to be continuation bytes */
+                for (i = 1; i < context->pending_length; i++)
+                {
+                    if ((sequence[i] & 0xC0) != 0x80)
+                    {
+                        result = false;
+                    }
+                }
+                (void)memcpy(context->pending, sequence, context->pending_length);
+            }
+        }
+
+        if ((result == true) &&
+            (pos < length))
+        {
+            /* Codes_SRS_UTF8_CHECKER_99_012: [ A sequence cut by the end of `utf8_str` shall be kept in `context` and validated when the next bytes arrive. ]*/
+            size_t end = length;
+            size_t back;
+            for (back = 1; (back <= 3) && (back <= length - pos); back++)
+            {
+                unsigned char c = utf8_str[length - back];
+                if ((c & 0xC0) != 0x80)
+                {
+                    if (get_sequence_length(c) > back)
+                    {
+                        end = length - back;
+                    }
+                    break;
+                }
+            }
+
+            /* Codes_SRS_UTF8_CHECKER_99_013: [ `utf8_checker_update` shall validate the rest of `utf8_str` with the implementation in use. ]*/
+            result = get_validator()->validate(utf8_str + pos, end - pos);
+            if (result == true)
+            {
+                context->pending_length = length - end;
+                (void)memcpy(context->pending, utf8_str + end, context->pending_length);
+            }
+        }
+
+        /* Codes_SRS_UTF8_CHECKER_99_014: [ `utf8_checker_update` shall return true if all the bytes seen so far can be the start of valid UTF-8 and false otherwise. ]*/
+        context->is_valid = result;
+    }
+    return result;
+}
+
+bool utf8_checker_final(UTF8_CHECKER_CONTEXT* context)
+{
+    bool result;
+    if (context == NULL)
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_015: [ If `context` is NULL, `utf8_checker_final` shall return false. ]*/
+        LogError("invalid argument UTF8_CHECKER_CONTEXT* context=%p", context);
+        result = false;
+    }
+    else
+    {
+        /* Codes_SRS_UTF8_CHECKER_99_016: [ `utf8_checker_final` shall return true if all the bytes passed to `utf8_checker_update` are valid UTF-8 and do not end in the middle of a sequence, and false otherwise. ]*/
+        result = context->is_valid && (context->pending_length == 0);
+    }
+    return result;
+}
@@ -3,16 +3,126 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/uuid.h"
 #include "azure_c_shared_utility/uniqueid.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 
-#define UUID_STRING_LENGTH          36
-#define UUID_STRING_SIZE            (UUID_STRING_LENGTH + 1)
 #define __SUCCESS__                 0
-#define UUID_FORMAT_STRING          "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x"
+
+/* UUID_generate_fast keeps its generator in thread local storage; without it, it falls back to UUID_generate */
+#if defined(_MSC_VER)
+#define UUID_THREAD_LOCAL           __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define UUID_THREAD_LOCAL           __thread
+#endif
+
+/* the generator takes a new seed from UniqueId_Generate after this many UUIDs */
+#define UUID_RESEED_INTERVAL        (1u << 20)
+
+static const char uuid_hex_digits[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+/* where the 2 hex digits of each byte go in the string */
+static const unsigned char uuid_string_positions[16] = { 0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34 };
+
+#ifdef UUID_THREAD_LOCAL
+/* xoshiro256** (D. Blackman, S. Vigna), fast and with a period long enough that a thread never sees the same 128 bits twice */
+typedef struct UUID_GENERATOR_TAG
+{
+    uint64_t state[4];
+    uint32_t remaining;
+} UUID_GENERATOR;
+
+static UUID_THREAD_LOCAL UUID_GENERATOR uuid_generator;
+
+static uint64_t rotate_left(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t splitmix64(uint64_t* x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t next_random(UUID_GENERATOR* generator)
+{
+    uint64_t* s = generator->state;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+
+    return result;
+}
+
+/* mixes 2 UUIDs from the platform and the address of the thread's generator into a new state */
+static int seed_generator(UUID_GENERATOR* generator)
+{
+    int result = __SUCCESS__;
+    uint64_t mix = (uint64_t)(uintptr_t)generator;
+    size_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        char seed_string[UUID_STRING_SIZE];
+        size_t j;
+
+        if (UniqueId_Generate(seed_string, sizeof(seed_string)) != UNIQUEID_OK)
+        {
+            LogError("Failed generating a seed UUID");
+            result = __FAILURE__;
+            break;
+        }
+
+        /* FNV-1a over the string, then spread over the 4 words */
+        for (j = 0; j < UUID_STRING_LENGTH; j++)
+        {
+            mix = (mix ^ (unsigned char)seed_string[j]) * 0x100000001B3ULL;
+        }
+        for (j = 0; j < 4; j++)
+        {
+            generator->state[j] ^= splitmix64(&mix);
+        }
+    }
+
+    if (result == __SUCCESS__)
+    {
+        generator->remaining = UUID_RESEED_INTERVAL;
+    }
+
+    return result;
+}
+
+static void fill_random_uuid(UUID_GENERATOR* generator, unsigned char* uuid_bytes)
+{
+    uint64_t high = next_random(generator);
+    uint64_t low = next_random(generator);
+    int i;
+
+    for (i = 0; i < 8; i++)
+    {
+        uuid_bytes[i] = (unsigned char)(high >> (56 - 8 * i));
+        uuid_bytes[8 + i] = (unsigned char)(low >> (56 - 8 * i));
+    }
+
+    /* RFC 4122 version 4 (random) and variant 10 */
+    uuid_bytes[6] = (unsigned char)((uuid_bytes[6] & 0x0F) | 0x40);
+    uuid_bytes[8] = (unsigned char)((uuid_bytes[8] & 0x3F) | 0x80);
+    generator->remaining--;
+}
+#endif /* UUID_THREAD_LOCAL */
 
 int UUID_from_string(const char* uuid_string, UUID* uuid)
 {
@@ -75,6 +185,40 @@ int UUID_from_string(const char* uuid_string, UUID* uuid)
     return result;
 }
 
+int UUID_to_string_into(UUID* uuid, char* uuid_string, size_t uuid_string_size)
+{
+    int result;
+
+    // Codes_SRS_UUID_99_001: [ If `uuid` or `uuid_string` are NULL, or `uuid_string_size` is less than UUID_STRING_SIZE, UUID_to_string_into shall return a non-zero value ]
+    if (uuid == NULL || uuid_string == NULL || uuid_string_size < UUID_STRING_SIZE)
+    {
+        LogError("Invalid argument (uuid=%p, uuid_string=%p, uuid_string_size=%lu)", uuid, uuid_string, (unsigned long)uuid_string_size);
+        result = __FAILURE__;
+    }
+    else
+    {
+        const unsigned char* uuid_bytes = (const unsigned char*)uuid;
+        size_t i;
+
+        // Codes_SRS_UUID_99_002: [ UUID_to_string_into shall write each byte of `uuid` as 2 lowercase HEX digits, with dashes after the 4th, 6th, 8th and 10th bytes, and a null terminator in `uuid_string` ]
+        for (i = 0; i < 16; i++)
+        {
+            uuid_string[uuid_string_positions[i]] = uuid_hex_digits[uuid_bytes[i] >> 4];
+            uuid_string[uuid_string_positions[i] + 1] = uuid_hex_digits[uuid_bytes[i] & 0x0F];
+        }
+        uuid_string[8] = '-';
+        uuid_string[13] = '-';
+        uuid_string[18] = '-';
+        uuid_string[23] = '-';
+        uuid_string[UUID_STRING_LENGTH] = '\0';
+
+        // Codes_SRS_UUID_99_003: [ If no failures occur, UUID_to_string_into shall return zero ]
+        result = __SUCCESS__;
+    }
+
+    return result;
+}
+
 char* UUID_to_string(UUID* uuid)
 {
     char* result;
@@ -91,28 +235,13 @@ char* UUID_to_string(UUID* uuid)
         // Codes_SRS_UUID_09_013: [ If `uuid_string` fails to be allocated, UUID_to_string shall return NULL ]  
         LogError("Failed allocating UUID string");
     }
-    else
+    // Codes_SRS_UUID_09_014: [ Each character in `uuid` shall be written in the respective positions of `uuid_string` as a 2-digit HEX value ]  
+    else if (UUID_to_string_into(uuid, result, UUID_STRING_SIZE) != 0)
     {
-        unsigned char* uuid_bytes;
-        int number_of_chars_written;
-
-        uuid_bytes = (unsigned char*)uuid;
-
-        // Codes_SRS_UUID_09_014: [ Each character in `uuid` shall be written in the respective positions of `uuid_string` as a 2-digit HEX value ]  
-        number_of_chars_written = sprintf(result, UUID_FORMAT_STRING,
-            uuid_bytes[0], uuid_bytes[1], uuid_bytes[2], uuid_bytes[3],
-            uuid_bytes[4], uuid_bytes[5],
-            uuid_bytes[6], uuid_bytes[7],
-            uuid_bytes[8], uuid_bytes[9],
-            uuid_bytes[10], uuid_bytes[11], uuid_bytes[12], uuid_bytes[13], uuid_bytes[14], uuid_bytes[15]);
-
-        if (number_of_chars_written != UUID_STRING_LENGTH)
-        {
-            // Tests_SRS_UUID_09_015: [ If `uuid_string` fails to be set, UUID_to_string shall return NULL ] 
-            LogError("Failed encoding UUID string");
-            free(result);
-            result = NULL;
-        }
+        // Codes_SRS_UUID_09_015: [ If `uuid_string` fails to be set, UUID_to_string shall return NULL ] 
+        LogError("Failed encoding UUID string");
+        free(result);
+        result = NULL;
     }
 
     // Codes_SRS_UUID_09_016: [ If no failures occur, UUID_to_string shall return `uuid_string` ]
@@ -169,3 +298,63 @@ int UUID_generate(UUID* uuid)
 
     return result;
 }
+
+int UUID_generate_fast(UUID* uuid)
+{
+    // Codes_SRS_UUID_99_004: [ If `uuid` is NULL, UUID_generate_fast shall return a non-zero value ]
+    // Codes_SRS_UUID_99_005: [ UUID_generate_fast shall fill `uuid` with a version 4 (random) UUID as per RFC 4122 ]
+    return UUID_generate_batch(uuid, 1);
+}
+
+int UUID_generate_batch(UUID* uuids, size_t count)
+{
+    int result;
+
+    // Codes_SRS_UUID_99_007: [ If `uuids` is NULL, UUID_generate_batch shall return a non-zero value ]
+    if (uuids == NULL)
+    {
+        LogError("Invalid argument (uuids is NULL)");
+        result = __FAILURE__;
+    }
+    else
+    {
+#ifdef UUID_THREAD_LOCAL
+        UUID_GENERATOR* generator = &uuid_generator;
+        size_t i;
+
+        result = __SUCCESS__;
+        for (i = 0; i < count; i++)
+        {
+            // Codes_SRS_UUID_99_009: [ The random bits shall come from a generator private to the calling thread, seeded from 2 UUIDs obtained from UniqueId_Generate on first use and again after every 2^20 UUIDs ]
+            if ((generator->remaining == 0) &&
+                (seed_generator(generator) != 0))
+            {
+                // Codes_SRS_UUID_99_010: [ If the generator fails to be seeded, UUID_generate_fast and UUID_generate_batch shall fail and return a non-zero value ]
+                LogError("Failed seeding the UUID generator");
+                result = __FAILURE__;
+                break;
+            }
+
+            // Codes_SRS_UUID_99_008: [ UUID_generate_batch shall fill the `count` UUIDs at `uuids` with version 4 (random) UUIDs as per RFC 4122 ]
+            fill_random_uuid(generator, uuids[i]);
+        }
+#else
+        size_t i;
+
+        result = __SUCCESS__;
+        for (i = 0; i < count; i++)
+        {
+            if (UUID_generate(&uuids[i]) != 0)
+            {
+                LogError("Failed generating UUID %lu", (unsigned long)i);
+                result = __FAILURE__;
+                break;
+            }
+        }
+#endif
+    }
+
+    // Codes_SRS_UUID_99_006: [ If no failures occur, UUID_generate_fast shall return zero ]
+    // Codes_SRS_UUID_99_011: [ If no failures occur, UUID_generate_batch shall return zero ]
+    return result;
+}
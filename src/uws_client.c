@@ -11,7 +11,7 @@
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/xio.h"
-#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/doublylinkedlist.h"
 #include "azure_c_shared_utility/socketio.h"
 #include "azure_c_shared_utility/platform.h"
 #include "azure_c_shared_utility/tlsio.h"
@@ -70,14 +70,19 @@ typedef struct WS_INSTANCE_PROTOCOL_TAG
 
 typedef struct WS_PENDING_SEND_TAG
 {
+    /* links the pending send in the pending_sends list, so queueing a frame costs no extra allocation */
+    DLIST_ENTRY entry;
     ON_WS_SEND_FRAME_COMPLETE on_ws_send_frame_complete;
     void* context;
-    UWS_CLIENT_HANDLE uws_client;
+    /* cleared when the send completes */
+    bool is_queued;
+    /* set while xio_send runs, the send then frees the pending send itself if the underlying IO completes it inline */
+    bool is_being_sent;
 } WS_PENDING_SEND;
 
 typedef struct UWS_CLIENT_INSTANCE_TAG
 {
-    SINGLYLINKEDLIST_HANDLE pending_sends;
+    DLIST_ENTRY pending_sends;
     XIO_HANDLE underlying_io;
     char* hostname;
     char* resource_name;
@@ -165,164 +170,150 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
                     }
                     else
                     {
-                        /* Codes_SRS_UWS_CLIENT_01_017: [ `uws_client_create` shall create a pending send IO list that is to be used to queue send packets by calling `singlylinkedlist_create`. ]*/
-                        result->pending_sends = singlylinkedlist_create();
-                        if (result->pending_sends == NULL)
-                        {
-                            /* Codes_SRS_UWS_CLIENT_01_018: [ If `singlylinkedlist_create` fails then `uws_client_create` shall fail and return NULL. ]*/
-                            LogError("Could not allocate pending send frames list");
-                            free(result->resource_name);
-                            free(result->hostname);
-                            free(result);
-                            result = NULL;
-                        }
-                        else
+                        /* Codes_SRS_UWS_CLIENT_01_017: [ `uws_client_create` shall initialize the pending send IO list that is to be used to queue send packets by calling `DList_InitializeListHead`. ]*/
+                        DList_InitializeListHead(&result->pending_sends);
+
+                        if (use_ssl == true)
                         {
-                            if (use_ssl == true)
-                            {
-                                TLSIO_CONFIG tlsio_config;
+                            TLSIO_CONFIG tlsio_config;
 
-                                /* Codes_SRS_UWS_CLIENT_01_006: [ If `use_ssl` is true then `uws_client_create` shall obtain the interface used to create a tlsio instance by calling `platform_get_default_tlsio`. ]*/
-                                /* Codes_SRS_UWS_CLIENT_01_076: [ If /secure/ is true, the client MUST perform a TLS handshake over the connection after opening the connection and before sending the handshake data [RFC2818]. ]*/
-                                const IO_INTERFACE_DESCRIPTION* tlsio_interface = platform_get_default_tlsio();
-                                if (tlsio_interface == NULL)
-                                {
-                                    /* Codes_SRS_UWS_CLIENT_01_007: [ If obtaining the underlying IO interface fails, then `uws_client_create` shall fail and return NULL. ]*/
-                                    LogError("NULL TLSIO interface description");
-                                    result->underlying_io = NULL;
-                                }
-                                else
-                                {
-                                    SOCKETIO_CONFIG socketio_config;
+                            /* Codes_SRS_UWS_CLIENT_01_006: [ If `use_ssl` is true then `uws_client_create` shall obtain the interface used to create a tlsio instance by calling `platform_get_default_tlsio`. ]*/
+                            /* Codes_SRS_UWS_CLIENT_01_076: [ If /secure/ is true, the client MUST perform a TLS handshake over the connection after opening the connection and before sending the handshake data [RFC2818]. ]*/
+                            const IO_INTERFACE_DESCRIPTION* tlsio_interface = platform_get_default_tlsio();
+                            if (tlsio_interface == NULL)
+                            {
+                                /* Codes_SRS_UWS_CLIENT_01_007: [ If obtaining the underlying IO interface fails, then `uws_client_create` shall fail and return NULL. ]*/
+                                LogError("NULL TLSIO interface description");
+                                result->underlying_io = NULL;
+                            }
+                            else
+                            {
+                                SOCKETIO_CONFIG socketio_config;
 
-                                    /* Codes_SRS_UWS_CLIENT_01_013: [ The create arguments for the tls IO (when `use_ssl` is 1) shall have: ]*/
-                                    /* Codes_SRS_UWS_CLIENT_01_014: [ - `hostname` set to the `hostname` argument passed to `uws_client_create`. ]*/
-                                    /* Codes_SRS_UWS_CLIENT_01_015: [ - `port` set to the `port` argument passed to `uws_client_create`. ]*/
-                                    socketio_config.hostname = hostname;
-                                    socketio_config.port = port;
-                                    socketio_config.accepted_socket = NULL;
+                                /* Codes_SRS_UWS_CLIENT_01_013: [ The create arguments for the tls IO (when `use_ssl` is 1) shall have: ]*/
+                                /* Codes_SRS_UWS_CLIENT_01_014: [ - `hostname` set to the `hostname` argument passed to `uws_client_create`. ]*/
+                                /* Codes_SRS_UWS_CLIENT_01_015: [ - `port` set to the `port` argument passed to `uws_client_create`. ]*/
+                                socketio_config.hostname = hostname;
+                                socketio_config.port = port;
+                                socketio_config.accepted_socket = NULL;
 
-                                    tlsio_config.underlying_io_interface = socketio_get_interface_description();
-                                    tlsio_config.underlying_io_parameters = &socketio_config;
+                                tlsio_config.underlying_io_interface = socketio_get_interface_description();
+                                tlsio_config.underlying_io_parameters = &socketio_config;
 
-                                    result->underlying_io = xio_create(tlsio_interface, &tlsio_config);
-                                    if (result->underlying_io == NULL)
-                                    {
-                                        LogError("Cannot create underlying TLS IO.");
-                                    }
+                                result->underlying_io = xio_create(tlsio_interface, &tlsio_config);
+                                if (result->underlying_io == NULL)
+                                {
+                                    LogError("Cannot create underlying TLS IO.");
                                 }
                             }
+                        }
+                        else
+                        {
+                            SOCKETIO_CONFIG socketio_config;
+                            /* Codes_SRS_UWS_CLIENT_01_005: [ If `use_ssl` is false then `uws_client_create` shall obtain the interface used to create a socketio instance by calling `socketio_get_interface_description`. ]*/
+                            const IO_INTERFACE_DESCRIPTION* socketio_interface = socketio_get_interface_description();
+                            if (socketio_interface == NULL)
+                            {
+                                /* Codes_SRS_UWS_CLIENT_01_007: [ If obtaining the underlying IO interface fails, then `uws_client_create` shall fail and return NULL. ]*/
+                                LogError("NULL socketio interface description");
+                                result->underlying_io = NULL;
+                            }
                             else
                             {
-                                SOCKETIO_CONFIG socketio_config;
-                                /* Codes_SRS_UWS_CLIENT_01_005: [ If `use_ssl` is false then `uws_client_create` shall obtain the interface used to create a socketio instance by calling `socketio_get_interface_description`. ]*/
-                                const IO_INTERFACE_DESCRIPTION* socketio_interface = socketio_get_interface_description();
-                                if (socketio_interface == NULL)
-                                {
-                                    /* Codes_SRS_UWS_CLIENT_01_007: [ If obtaining the underlying IO interface fails, then `uws_client_create` shall fail and return NULL. ]*/
-                                    LogError("NULL socketio interface description");
-                                    result->underlying_io = NULL;
-                                }
-                                else
+                                /* Codes_SRS_UWS_CLIENT_01_010: [ The create arguments for the socket IO (when `use_ssl` is 0) shall have: ]*/
+                                /* Codes_SRS_UWS_CLIENT_01_011: [ - `hostname` set to the `hostname` argument passed to `uws_client_create`. ]*/
+                                /* Codes_SRS_UWS_CLIENT_01_012: [ - `port` set to the `port` argument passed to `uws_client_create`. ]*/
+                                socketio_config.hostname = hostname;
+                                socketio_config.port = port;
+                                socketio_config.accepted_socket = NULL;
+
+                                /* Codes_SRS_UWS_CLIENT_01_008: [ The obtained interface shall be used to create the IO used as underlying IO by the newly created uws instance. ]*/
+                                /* Codes_SRS_UWS_CLIENT_01_009: [ The underlying IO shall be created by calling `xio_create`. ]*/
+                                result->underlying_io = xio_create(socketio_interface, &socketio_config);
+                                if (result->underlying_io == NULL)
                                 {
-                                    /* Codes_SRS_UWS_CLIENT_01_010: [ The create arguments for the socket IO (when `use_ssl` is 0) shall have: ]*/
-                                    /* Codes_SRS_UWS_CLIENT_01_011: [ - `hostname` set to the `hostname` argument passed to `uws_client_create`. ]*/
-                                    /* Codes_SRS_UWS_CLIENT_01_012: [ - `port` set to the `port` argument passed to `uws_client_create`. ]*/
-                                    socketio_config.hostname = hostname;
-                                    socketio_config.port = port;
-                                    socketio_config.accepted_socket = NULL;
-
-                                    /* Codes_SRS_UWS_CLIENT_01_008: [ The obtained interface shall be used to create the IO used as underlying IO by the newly created uws instance. ]*/
-                                    /* Codes_SRS_UWS_CLIENT_01_009: [ The underlying IO shall be created by calling `xio_create`. ]*/
-                                    result->underlying_io = xio_create(socketio_interface, &socketio_config);
-                                    if (result->underlying_io == NULL)
-                                    {
-                                        LogError("Cannot create underlying socket IO.");
-                                    }
+                                    LogError("Cannot create underlying socket IO.");
                                 }
                             }
+                        }
 
-                            if (result->underlying_io == NULL)
+                        if (result->underlying_io == NULL)
+                        {
+                            /* Codes_SRS_UWS_CLIENT_01_016: [ If `xio_create` fails, then `uws_client_create` shall fail and return NULL. ]*/
+                            free(result->resource_name);
+                            free(result->hostname);
+                            free(result);
+                            result = NULL;
+                        }
+                        else
+                        {
+                            result->uws_state = UWS_STATE_CLOSED;
+                            /* Codes_SRS_UWS_CLIENT_01_403: [ The argument `port` shall be copied for later use. ]*/
+                            result->port = port;
+
+                            result->on_ws_open_complete = NULL;
+                            result->on_ws_open_complete_context = NULL;
+                            result->on_ws_frame_received = NULL;
+                            result->on_ws_frame_received_context = NULL;
+                            result->on_ws_error = NULL;
+                            result->on_ws_error_context = NULL;
+                            result->on_ws_close_complete = NULL;
+                            result->on_ws_close_complete_context = NULL;
+                            result->received_bytes = NULL;
+                            result->received_bytes_count = 0;
+
+                            result->protocol_count = protocol_count;
+
+                            /* Codes_SRS_UWS_CLIENT_01_410: [ The `protocols` argument shall be allowed to be NULL, in which case no protocol is to be specified by the client in the upgrade request. ]*/
+                            if (protocols == NULL)
                             {
-                                /* Codes_SRS_UWS_CLIENT_01_016: [ If `xio_create` fails, then `uws_client_create` shall fail and return NULL. ]*/
-                                singlylinkedlist_destroy(result->pending_sends);
-                                free(result->resource_name);
-                                free(result->hostname);
-                                free(result);
-                                result = NULL;
+                                result->protocols = NULL;
                             }
                             else
                             {
-                                result->uws_state = UWS_STATE_CLOSED;
-                                /* Codes_SRS_UWS_CLIENT_01_403: [ The argument `port` shall be copied for later use. ]*/
-                                result->port = port;
-
-                                result->on_ws_open_complete = NULL;
-                                result->on_ws_open_complete_context = NULL;
-                                result->on_ws_frame_received = NULL;
-                                result->on_ws_frame_received_context = NULL;
-                                result->on_ws_error = NULL;
-                                result->on_ws_error_context = NULL;
-                                result->on_ws_close_complete = NULL;
-                                result->on_ws_close_complete_context = NULL;
-                                result->received_bytes = NULL;
-                                result->received_bytes_count = 0;
-
-                                result->protocol_count = protocol_count;
-
-                                /* Codes_SRS_UWS_CLIENT_01_410: [ The `protocols` argument shall be allowed to be NULL, in which case no protocol is to be specified by the client in the upgrade request. ]*/
-                                if (protocols == NULL)
+                                result->protocols = (WS_INSTANCE_PROTOCOL*)malloc(sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
+                                if (result->protocols == NULL)
                                 {
-                                    result->protocols = NULL;
+                                    /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
+                                    LogError("Cannot allocate memory for the protocols array.");
+                                    xio_destroy(result->underlying_io);
+                                            free(result->resource_name);
+                                    free(result->hostname);
+                                    free(result);
+                                    result = NULL;
                                 }
                                 else
                                 {
-                                    result->protocols = (WS_INSTANCE_PROTOCOL*)malloc(sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
-                                    if (result->protocols == NULL)
+                                    /* Codes_SRS_UWS_CLIENT_01_413: [ The protocol information indicated by `protocols` and `protocol_count` shall be copied for later use (for constructing the upgrade request). ]*/
+                                    for (i = 0; i < protocol_count; i++)
                                     {
-                                        /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
-                                        LogError("Cannot allocate memory for the protocols array.");
+                                        if (mallocAndStrcpy_s(&result->protocols[i].protocol, protocols[i].protocol) != 0)
+                                        {
+                                            /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
+                                            LogError("Cannot allocate memory for the protocol index %u.", (unsigned int)i);
+                                            break;
+                                        }
+                                    }
+
+                                    if (i < protocol_count)
+                                    {
+                                        size_t j;
+
+                                        for (j = 0; j < i; j++)
+                                        {
+                                            free(result->protocols[j].protocol);
+                                        }
+
+                                        free(result->protocols);
                                         xio_destroy(result->underlying_io);
-                                        singlylinkedlist_destroy(result->pending_sends);
-                                        free(result->resource_name);
+                                                    free(result->resource_name);
                                         free(result->hostname);
                                         free(result);
                                         result = NULL;
                                     }
                                     else
                                     {
-                                        /* Codes_SRS_UWS_CLIENT_01_413: [ The protocol information indicated by `protocols` and `protocol_count` shall be copied for later use (for constructing the upgrade request). ]*/
-                                        for (i = 0; i < protocol_count; i++)
-                                        {
-                                            if (mallocAndStrcpy_s(&result->protocols[i].protocol, protocols[i].protocol) != 0)
-                                            {
-                                                /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
-                                                LogError("Cannot allocate memory for the protocol index %u.", (unsigned int)i);
-                                                break;
-                                            }
-                                        }
-
-                                        if (i < protocol_count)
-                                        {
-                                            size_t j;
-
-                                            for (j = 0; j < i; j++)
-                                            {
-                                                free(result->protocols[j].protocol);
-                                            }
-
-                                            free(result->protocols);
-                                            xio_destroy(result->underlying_io);
-                                            singlylinkedlist_destroy(result->pending_sends);
-                                            free(result->resource_name);
-                                            free(result->hostname);
-                                            free(result);
-                                            result = NULL;
-                                        }
-                                        else
-                                        {
-                                            result->protocol_count = protocol_count;
-                                        }
+                                        result->protocol_count = protocol_count;
                                     }
                                 }
                             }
@@ -399,12 +390,15 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
                     }
                     else
                     {
-                        /* Codes_SRS_UWS_CLIENT_01_530: [ `uws_client_create_with_io` shall create a pending send IO list that is to be used to queue send packets by calling `singlylinkedlist_create`. ]*/
-                        result->pending_sends = singlylinkedlist_create();
-                        if (result->pending_sends == NULL)
+                        /* Codes_SRS_UWS_CLIENT_01_530: [ `uws_client_create_with_io` shall initialize the pending send IO list that is to be used to queue send packets by calling `DList_InitializeListHead`. ]*/
+                        DList_InitializeListHead(&result->pending_sends);
+
+                        /* Codes_SRS_UWS_CLIENT_01_521: [ The underlying IO shall be created by calling `xio_create`, while passing as arguments the `io_interface` and `io_create_parameters` argument values. ]*/
+                        result->underlying_io = xio_create(io_interface, io_create_parameters);
+                        if (result->underlying_io == NULL)
                         {
-                            /* Codes_SRS_UWS_CLIENT_01_531: [ If `singlylinkedlist_create` fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
-                            LogError("Could not allocate pending send frames list");
+                            /* Codes_SRS_UWS_CLIENT_01_522: [ If `xio_create` fails, then `uws_client_create_with_io` shall fail and return NULL. ]*/
+                            LogError("Cannot create underlying IO.");
                             free(result->resource_name);
                             free(result->hostname);
                             free(result);
@@ -412,91 +406,74 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
                         }
                         else
                         {
-                            /* Codes_SRS_UWS_CLIENT_01_521: [ The underlying IO shall be created by calling `xio_create`, while passing as arguments the `io_interface` and `io_create_parameters` argument values. ]*/
-                            result->underlying_io = xio_create(io_interface, io_create_parameters);
-                            if (result->underlying_io == NULL)
+                            result->uws_state = UWS_STATE_CLOSED;
+
+                            /* Codes_SRS_UWS_CLIENT_01_520: [ The argument `port` shall be copied for later use. ]*/
+                            result->port = port;
+
+                            result->on_ws_open_complete = NULL;
+                            result->on_ws_open_complete_context = NULL;
+                            result->on_ws_frame_received = NULL;
+                            result->on_ws_frame_received_context = NULL;
+                            result->on_ws_error = NULL;
+                            result->on_ws_error_context = NULL;
+                            result->on_ws_close_complete = NULL;
+                            result->on_ws_close_complete_context = NULL;
+                            result->received_bytes = NULL;
+                            result->received_bytes_count = 0;
+
+                            result->protocol_count = protocol_count;
+
+                            /* Codes_SRS_UWS_CLIENT_01_524: [ The `protocols` argument shall be allowed to be NULL, in which case no protocol is to be specified by the client in the upgrade request. ]*/
+                            if (protocols == NULL)
                             {
-                                /* Codes_SRS_UWS_CLIENT_01_522: [ If `xio_create` fails, then `uws_client_create_with_io` shall fail and return NULL. ]*/
-                                LogError("Cannot create underlying IO.");
-                                singlylinkedlist_destroy(result->pending_sends);
-                                free(result->resource_name);
-                                free(result->hostname);
-                                free(result);
-                                result = NULL;
+                                result->protocols = NULL;
                             }
                             else
                             {
-                                result->uws_state = UWS_STATE_CLOSED;
-
-                                /* Codes_SRS_UWS_CLIENT_01_520: [ The argument `port` shall be copied for later use. ]*/
-                                result->port = port;
-
-                                result->on_ws_open_complete = NULL;
-                                result->on_ws_open_complete_context = NULL;
-                                result->on_ws_frame_received = NULL;
-                                result->on_ws_frame_received_context = NULL;
-                                result->on_ws_error = NULL;
-                                result->on_ws_error_context = NULL;
-                                result->on_ws_close_complete = NULL;
-                                result->on_ws_close_complete_context = NULL;
-                                result->received_bytes = NULL;
-                                result->received_bytes_count = 0;
-
-                                result->protocol_count = protocol_count;
-
-                                /* Codes_SRS_UWS_CLIENT_01_524: [ The `protocols` argument shall be allowed to be NULL, in which case no protocol is to be specified by the client in the upgrade request. ]*/
-                                if (protocols == NULL)
+                                result->protocols = (WS_INSTANCE_PROTOCOL*)malloc(sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
+                                if (result->protocols == NULL)
                                 {
-                                    result->protocols = NULL;
+                                    /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
+                                    LogError("Cannot allocate memory for the protocols array.");
+                                    xio_destroy(result->underlying_io);
+                                            free(result->resource_name);
+                                    free(result->hostname);
+                                    free(result);
+                                    result = NULL;
                                 }
                                 else
                                 {
-                                    result->protocols = (WS_INSTANCE_PROTOCOL*)malloc(sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
-                                    if (result->protocols == NULL)
+                                    /* Codes_SRS_UWS_CLIENT_01_527: [ The protocol information indicated by `protocols` and `protocol_count` shall be copied for later use (for constructing the upgrade request). ]*/
+                                    for (i = 0; i < protocol_count; i++)
                                     {
-                                        /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
-                                        LogError("Cannot allocate memory for the protocols array.");
+                                        if (mallocAndStrcpy_s(&result->protocols[i].protocol, protocols[i].protocol) != 0)
+                                        {
+                                            /* Codes_SRS_UWS_CLIENT_01_528: [ If allocating memory for the copied protocol information fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
+                                            LogError("Cannot allocate memory for the protocol index %u.", (unsigned int)i);
+                                            break;
+                                        }
+                                    }
+
+                                    if (i < protocol_count)
+                                    {
+                                        size_t j;
+
+                                        for (j = 0; j < i; j++)
+                                        {
+                                            free(result->protocols[j].protocol);
+                                        }
+
+                                        free(result->protocols);
                                         xio_destroy(result->underlying_io);
-                                        singlylinkedlist_destroy(result->pending_sends);
-                                        free(result->resource_name);
+                                                    free(result->resource_name);
                                         free(result->hostname);
                                         free(result);
                                         result = NULL;
                                     }
                                     else
                                     {
-                                        /* Codes_SRS_UWS_CLIENT_01_527: [ The protocol information indicated by `protocols` and `protocol_count` shall be copied for later use (for constructing the upgrade request). ]*/
-                                        for (i = 0; i < protocol_count; i++)
-                                        {
-                                            if (mallocAndStrcpy_s(&result->protocols[i].protocol, protocols[i].protocol) != 0)
-                                            {
-                                                /* Codes_SRS_UWS_CLIENT_01_528: [ If allocating memory for the copied protocol information fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
-                                                LogError("Cannot allocate memory for the protocol index %u.", (unsigned int)i);
-                                                break;
-                                            }
-                                        }
-
-                                        if (i < protocol_count)
-                                        {
-                                            size_t j;
-
-                                            for (j = 0; j < i; j++)
-                                            {
-                                                free(result->protocols[j].protocol);
-                                            }
-
-                                            free(result->protocols);
-                                            xio_destroy(result->underlying_io);
-                                            singlylinkedlist_destroy(result->pending_sends);
-                                            free(result->resource_name);
-                                            free(result->hostname);
-                                            free(result);
-                                            result = NULL;
-                                        }
-                                        else
-                                        {
-                                            result->protocol_count = protocol_count;
-                                        }
+                                        result->protocol_count = protocol_count;
                                     }
                                 }
                             }
@@ -554,8 +531,6 @@ void uws_client_destroy(UWS_CLIENT_HANDLE uws_client)
             uws_client->underlying_io = NULL;
         }
 
-        /* Codes_SRS_UWS_CLIENT_01_024: [ `uws_client_destroy` shall free the list used to track the pending sends by calling `singlylinkedlist_destroy`. ]*/
-        singlylinkedlist_destroy(uws_client->pending_sends);
         free(uws_client->resource_name);
         free(uws_client->hostname);
         free(uws_client);
@@ -1484,32 +1459,23 @@ int uws_client_open_async(UWS_CLIENT_HANDLE uws_client, ON_WS_OPEN_COMPLETE on_w
     return result;
 }
 
-static int complete_send_frame(WS_PENDING_SEND* ws_pending_send, LIST_ITEM_HANDLE pending_send_frame_item, WS_SEND_FRAME_RESULT ws_send_frame_result)
+static void complete_send_frame(WS_PENDING_SEND* ws_pending_send, WS_SEND_FRAME_RESULT ws_send_frame_result)
 {
-    int result;
-    UWS_CLIENT_INSTANCE* uws_client = ws_pending_send->uws_client;
+    /* Codes_SRS_UWS_CLIENT_01_432: [ The indicated sent frame shall be removed from the list by calling `DList_RemoveEntryList`. ]*/
+    (void)DList_RemoveEntryList(&ws_pending_send->entry);
+    ws_pending_send->is_queued = false;
 
-    /* Codes_SRS_UWS_CLIENT_01_432: [ The indicated sent frame shall be removed from the list by calling `singlylinkedlist_remove`. ]*/
-    if (singlylinkedlist_remove(uws_client->pending_sends, pending_send_frame_item) != 0)
+    if (ws_pending_send->on_ws_send_frame_complete != NULL)
     {
-        LogError("Failed removing item from list");
-        result = __FAILURE__;
+        /* Codes_SRS_UWS_CLIENT_01_037: [ When indicating pending send frames as cancelled the callback context passed to the `on_ws_send_frame_complete` callback shall be the context given to `uws_client_send_frame_async`. ]*/
+        ws_pending_send->on_ws_send_frame_complete(ws_pending_send->context, ws_send_frame_result);
     }
-    else
-    {
-        if (ws_pending_send->on_ws_send_frame_complete != NULL)
-        {
-            /* Codes_SRS_UWS_CLIENT_01_037: [ When indicating pending send frames as cancelled the callback context passed to the `on_ws_send_frame_complete` callback shall be the context given to `uws_client_send_frame_async`. ]*/
-            ws_pending_send->on_ws_send_frame_complete(ws_pending_send->context, ws_send_frame_result);
-        }
 
+    if (!ws_pending_send->is_being_sent)
+    {
         /* Codes_SRS_UWS_CLIENT_01_434: [ The memory associated with the sent frame shall be freed. ]*/
         free(ws_pending_send);
-
-        result = 0;
     }
-
-    return result;
 }
 
 /* Codes_SRS_UWS_CLIENT_01_029: [ `uws_client_close_async` shall close the uws instance connection if an open action is either pending or has completed successfully (if the IO is open). ]*/
@@ -1556,15 +1522,11 @@ int uws_client_close_async(UWS_CLIENT_HANDLE uws_client, ON_WS_CLOSE_COMPLETE on
             else
             {
                 /* Codes_SRS_UWS_CLIENT_01_034: [ `uws_client_close_async` shall obtain all the pending send frames by repetitively querying for the head of the pending IO list and freeing that head item. ]*/
-                LIST_ITEM_HANDLE first_pending_send;
-
-                /* Codes_SRS_UWS_CLIENT_01_035: [ Obtaining the head of the pending send frames list shall be done by calling `singlylinkedlist_get_head_item`. ]*/
-                while ((first_pending_send = singlylinkedlist_get_head_item(uws_client->pending_sends)) != NULL)
+                /* Codes_SRS_UWS_CLIENT_01_035: [ `uws_client_close_async` shall stop when `DList_IsListEmpty` indicates that the pending send frames list is empty. ]*/
+                while (!DList_IsListEmpty(&uws_client->pending_sends))
                 {
-                    WS_PENDING_SEND* ws_pending_send = (WS_PENDING_SEND*)singlylinkedlist_item_get_value(first_pending_send);
-
                     /* Codes_SRS_UWS_CLIENT_01_036: [ For each pending send frame the send complete callback shall be called with `UWS_SEND_FRAME_CANCELLED`. ]*/
-                    complete_send_frame(ws_pending_send, first_pending_send, WS_SEND_FRAME_CANCELLED);
+                    complete_send_frame(containingRecord(uws_client->pending_sends.Flink, WS_PENDING_SEND, entry), WS_SEND_FRAME_CANCELLED);
                 }
 
                 /* Codes_SRS_UWS_CLIENT_01_396: [ On success `uws_client_close_async` shall return 0. ]*/
@@ -1620,13 +1582,9 @@ int uws_client_close_handshake_async(UWS_CLIENT_HANDLE uws_client, uint16_t clos
             }
             else
             {
-                LIST_ITEM_HANDLE first_pending_send;
-
-                while ((first_pending_send = singlylinkedlist_get_head_item(uws_client->pending_sends)) != NULL)
+                while (!DList_IsListEmpty(&uws_client->pending_sends))
                 {
-                    WS_PENDING_SEND* ws_pending_send = (WS_PENDING_SEND*)singlylinkedlist_item_get_value(first_pending_send);
-
-                    complete_send_frame(ws_pending_send, first_pending_send, WS_SEND_FRAME_CANCELLED);
+                    complete_send_frame(containingRecord(uws_client->pending_sends.Flink, WS_PENDING_SEND, entry), WS_SEND_FRAME_CANCELLED);
                 }
 
                 /* Codes_SRS_UWS_CLIENT_01_466: [ On success `uws_client_close_handshake_async` shall return 0. ]*/
@@ -1647,9 +1605,7 @@ static void on_underlying_io_send_complete(void* context, IO_SEND_RESULT send_re
     }
     else
     {
-        LIST_ITEM_HANDLE ws_pending_send_list_item = (LIST_ITEM_HANDLE)context;
-        WS_PENDING_SEND* ws_pending_send = (WS_PENDING_SEND*)singlylinkedlist_item_get_value(ws_pending_send_list_item);
-        UWS_CLIENT_HANDLE uws_client = ws_pending_send->uws_client;
+        WS_PENDING_SEND* ws_pending_send = (WS_PENDING_SEND*)context;
         WS_SEND_FRAME_RESULT ws_send_frame_result;
 
         switch (send_result)
@@ -1672,19 +1628,10 @@ static void on_underlying_io_send_complete(void* context, IO_SEND_RESULT send_re
             break;
         }
 
-        if (complete_send_frame(ws_pending_send, ws_pending_send_list_item, ws_send_frame_result) != 0)
-        {
-            /* Codes_SRS_UWS_CLIENT_01_433: [ If `singlylinkedlist_remove` fails an error shall be indicated by calling the `on_ws_error` callback with `WS_ERROR_CANNOT_REMOVE_SENT_ITEM_FROM_LIST`. ]*/
-            indicate_ws_error(uws_client, WS_ERROR_CANNOT_REMOVE_SENT_ITEM_FROM_LIST);
-        }
+        complete_send_frame(ws_pending_send, ws_send_frame_result);
     }
 }
 
-static bool find_list_node(LIST_ITEM_HANDLE list_item, const void* match_context)
-{
-    return list_item == (LIST_ITEM_HANDLE)match_context;
-}
-
 int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char frame_type, const unsigned char* buffer, size_t size, bool is_final, ON_WS_SEND_FRAME_COMPLETE on_ws_send_frame_complete, void* on_ws_send_frame_complete_context)
 {
     int result;
@@ -1739,7 +1686,7 @@ int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char fram
             {
                 const unsigned char* encoded_frame;
                 size_t encoded_frame_length;
-                LIST_ITEM_HANDLE new_pending_send_list_item;
+                PDLIST_ENTRY pending_send_entry = &ws_pending_send->entry;
 
                 /* Codes_SRS_UWS_CLIENT_01_428: [ The encoded frame buffer memory shall be obtained by calling `BUFFER_u_char` on the encode buffer. ]*/
                 encoded_frame = BUFFER_u_char(non_control_frame_buffer);
@@ -1752,46 +1699,47 @@ int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char fram
                 /* Codes_SRS_UWS_CLIENT_01_041: [ - the send complete callback context `on_ws_send_frame_complete_context` ]*/
                 ws_pending_send->on_ws_send_frame_complete = on_ws_send_frame_complete;
                 ws_pending_send->context = on_ws_send_frame_complete_context;
-                ws_pending_send->uws_client = uws_client;
 
-                /* Codes_SRS_UWS_CLIENT_01_048: [ Queueing shall be done by calling `singlylinkedlist_add`. ]*/
-                new_pending_send_list_item = singlylinkedlist_add(uws_client->pending_sends, ws_pending_send);
-                if (new_pending_send_list_item == NULL)
+                /* Codes_SRS_UWS_CLIENT_01_048: [ Queueing shall be done by calling `DList_InsertTailList`. ]*/
+                DList_InsertTailList(&uws_client->pending_sends, pending_send_entry);
+                ws_pending_send->is_queued = true;
+                ws_pending_send->is_being_sent = true;
+
+                /* Codes_SRS_UWS_CLIENT_01_431: [ Once encoded the frame shall be sent by using `xio_send` with the following arguments: ]*/
+                /* Codes_SRS_UWS_CLIENT_01_053: [ - the io handle shall be the underlyiong IO handle created in `uws_client_create`. ]*/
+                /* Codes_SRS_UWS_CLIENT_01_054: [ - the `buffer` argument shall point to the complete websocket frame to be sent. ]*/
+                /* Codes_SRS_UWS_CLIENT_01_055: [ - the `size` argument shall indicate the websocket frame length. ]*/
+                /* Codes_SRS_UWS_CLIENT_01_056: [ - the `send_complete` callback shall be the `on_underlying_io_send_complete` function. ]*/
+                /* Codes_SRS_UWS_CLIENT_01_057: [ - the `send_complete_context` argument shall identify the pending send. ]*/
+                /* Codes_SRS_UWS_CLIENT_01_276: [ The frame(s) that have been formed MUST be transmitted over the underlying network connection. ]*/
+                if (xio_send(uws_client->underlying_io, encoded_frame, encoded_frame_length, on_underlying_io_send_complete, ws_pending_send) != 0)
                 {
-                    /* Codes_SRS_UWS_CLIENT_01_049: [ If `singlylinkedlist_add` fails, `uws_client_send_frame_async` shall fail and return a non-zero value. ]*/
-                    LogError("Could not allocate memory for pending frames");
+                    /* Codes_SRS_UWS_CLIENT_01_058: [ If `xio_send` fails, `uws_client_send_frame_async` shall fail and return a non-zero value. ]*/
+                    LogError("Could not send bytes through the underlying IO");
+                    
+                    /* Codes_SRS_UWS_CLIENT_09_001: [ If `xio_send` fails and the message is still queued, it shall be de-queued and destroyed. ] */
+                    if (ws_pending_send->is_queued)
+                    {
+                        (void)DList_RemoveEntryList(pending_send_entry);
+                    }
                     free(ws_pending_send);
+
                     result = __FAILURE__;
                 }
                 else
                 {
-                    /* Codes_SRS_UWS_CLIENT_01_431: [ Once encoded the frame shall be sent by using `xio_send` with the following arguments: ]*/
-                    /* Codes_SRS_UWS_CLIENT_01_053: [ - the io handle shall be the underlyiong IO handle created in `uws_client_create`. ]*/
-                    /* Codes_SRS_UWS_CLIENT_01_054: [ - the `buffer` argument shall point to the complete websocket frame to be sent. ]*/
-                    /* Codes_SRS_UWS_CLIENT_01_055: [ - the `size` argument shall indicate the websocket frame length. ]*/
-                    /* Codes_SRS_UWS_CLIENT_01_056: [ - the `send_complete` callback shall be the `on_underlying_io_send_complete` function. ]*/
-                    /* Codes_SRS_UWS_CLIENT_01_057: [ - the `send_complete_context` argument shall identify the pending send. ]*/
-                    /* Codes_SRS_UWS_CLIENT_01_276: [ The frame(s) that have been formed MUST be transmitted over the underlying network connection. ]*/
-                    if (xio_send(uws_client->underlying_io, encoded_frame, encoded_frame_length, on_underlying_io_send_complete, new_pending_send_list_item) != 0)
+                    if (!ws_pending_send->is_queued)
                     {
-                        /* Codes_SRS_UWS_CLIENT_01_058: [ If `xio_send` fails, `uws_client_send_frame_async` shall fail and return a non-zero value. ]*/
-                        LogError("Could not send bytes through the underlying IO");
-                        
-                        /* Codes_SRS_UWS_CLIENT_09_001: [ If `xio_send` fails and the message is still queued, it shall be de-queued and destroyed. ] */
-                        if (singlylinkedlist_find(uws_client->pending_sends, find_list_node, new_pending_send_list_item) != NULL)
-                        {    
-                            // Guards against double free in case the underlying I/O invoked 'on_underlying_io_send_complete' within xio_send.
-                            (void)singlylinkedlist_remove(uws_client->pending_sends, new_pending_send_list_item);
-                            free(ws_pending_send);
-                        }
-
-			            result = __FAILURE__;
+                        /* Codes_SRS_UWS_CLIENT_99_001: [ If the underlying IO completes the send from within `xio_send`, the pending send shall be freed once `xio_send` returns. ]*/
+                        free(ws_pending_send);
                     }
                     else
                     {
-                        /* Codes_SRS_UWS_CLIENT_01_042: [ On success, `uws_client_send_frame_async` shall return 0. ]*/
-                        result = 0;
+                        ws_pending_send->is_being_sent = false;
                     }
+
+                    /* Codes_SRS_UWS_CLIENT_01_042: [ On success, `uws_client_send_frame_async` shall return 0. ]*/
+                    result = 0;
                 }
 
                 BUFFER_delete(non_control_frame_buffer);
@@ -3,6 +3,7 @@
 
 #include <stdlib.h>
 #include "azure_c_shared_utility/gballoc.h"
+#include <stdint.h>
 #include "azure_c_shared_utility/vector.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
@@ -32,6 +33,7 @@ VECTOR_HANDLE VECTOR_create(size_t elementSize)
             /* Codes_SRS_VECTOR_10_001: [VECTOR_create shall allocate a VECTOR_HANDLE that will contain an empty vector.The size of each element is given with the parameter elementSize.] */
             result->storage = NULL;
             result->count = 0;
+            result->capacity = 0;
             result->elementSize = elementSize;
         }
     }
@@ -74,16 +76,70 @@ VECTOR_HANDLE VECTOR_move(VECTOR_HANDLE handle)
         {
             /* Codes_SRS_VECTOR_10_004: [VECTOR_move shall allocate a VECTOR_HANDLE and move the data to it from the given handle.] */
             result->count = handle->count;
+            result->capacity = handle->capacity;
             result->elementSize = handle->elementSize;
             result->storage = handle->storage;
 
             handle->storage = NULL;
             handle->count = 0;
+            handle->capacity = 0;
         }
     }
     return result;
 }
 
+static int set_capacity(VECTOR_HANDLE handle, size_t capacity)
+{
+    int result;
+    void* temp;
+
+    if (capacity > SIZE_MAX / handle->elementSize)
+    {
+        LogError("capacity(%zd) too large.", capacity);
+        result = __FAILURE__;
+    }
+    else if ((temp = realloc(handle->storage, handle->elementSize * capacity)) == NULL)
+    {
+        LogError("realloc failed.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        handle->storage = temp;
+        handle->capacity = capacity;
+        result = 0;
+    }
+    return result;
+}
+
+/* Makes room for numElements more elements, at least doubling the capacity when it has to grow. */
+static int grow(VECTOR_HANDLE handle, size_t numElements)
+{
+    int result;
+
+    if (numElements > SIZE_MAX - handle->count)
+    {
+        LogError("numElements(%zd) too large.", numElements);
+        result = __FAILURE__;
+    }
+    else if (handle->count + numElements <= handle->capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t capacity = handle->count + numElements;
+        if ((handle->capacity <= (SIZE_MAX / handle->elementSize) / 2) &&
+            (capacity < handle->capacity * 2))
+        {
+            capacity = handle->capacity * 2;
+        }
+
+        result = set_capacity(handle, capacity);
+    }
+    return result;
+}
+
 /* insertion */
 
 int VECTOR_push_back(VECTOR_HANDLE handle, const void* elements, size_t numElements)
@@ -99,21 +155,18 @@ int VECTOR_push_back(VECTOR_HANDLE handle, const void* elements, size_t numEleme
     }
     else
     {
-        size_t curSize = handle->elementSize * handle->count;
-        size_t appendSize = handle->elementSize * numElements;
-
-        void* temp = realloc(handle->storage, curSize + appendSize);
-        if (temp == NULL)
+        /* Codes_SRS_VECTOR_99_001: [VECTOR_push_back shall grow the internal storage only when it has no room for `numElements` more elements.] */
+        /* Codes_SRS_VECTOR_99_002: [When it grows the internal storage, VECTOR_push_back shall at least double its capacity.] */
+        if (grow(handle, numElements) != 0)
         {
            /* Codes_SRS_VECTOR_10_012: [VECTOR_push_back shall fail and return non-zero if memory allocation fails.] */
-            LogError("realloc failed.");
+            LogError("failure growing the vector by %zd elements.", numElements);
             result = __FAILURE__;
         }
         else
         {
             /* Codes_SRS_VECTOR_10_013: [VECTOR_push_back shall append the given elements and return 0 indicating success.] */
-            (void)memcpy((unsigned char*)temp + curSize, elements, appendSize);
-            handle->storage = temp;
+            (void)memcpy((unsigned char*)handle->storage + (handle->elementSize * handle->count), elements, handle->elementSize * numElements);
             handle->count += numElements;
             result = 0;
         }
@@ -159,27 +212,10 @@ void VECTOR_erase(VECTOR_HANDLE handle, void* elements, size_t numElements)
                 }
                 else
                 {
-                    /* Codes_SRS_VECTOR_10_014: [VECTOR_erase shall remove the 'numElements' starting at 'elements' and reduce its internal storage.] */
+                    /* Codes_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements`.] */
+                    /* Codes_SRS_VECTOR_99_003: [VECTOR_erase shall keep the internal storage and the capacity of the vector.] */
+                    (void)memmove(elements, src, srcEnd - src);
                     handle->count -= numElements;
-                    if (handle->count == 0)
-                    {
-                        free(handle->storage);
-                        handle->storage = NULL;
-                    }
-                    else
-                    {
-                        void* tmp;
-                        (void)memmove(elements, src, srcEnd - src);
-                        tmp = realloc(handle->storage, (handle->elementSize * handle->count));
-                        if (tmp == NULL)
-                        {
-                            LogInfo("realloc failed. Keeping original internal storage pointer.");
-                        }
-                        else
-                        {
-                            handle->storage = tmp;
-                        }
-                    }
                 }
             }
         }
@@ -199,6 +235,23 @@ void VECTOR_clear(VECTOR_HANDLE handle)
         free(handle->storage);
         handle->storage = NULL;
         handle->count = 0;
+        handle->capacity = 0;
+    }
+}
+
+/* ordering */
+
+void VECTOR_sort(VECTOR_HANDLE handle, VECTOR_COMPARE_FUNCTION compare)
+{
+    if (handle == NULL || compare == NULL)
+    {
+        /* Codes_SRS_VECTOR_99_014: [VECTOR_sort shall return if `handle` or `compare` is NULL.] */
+        LogError("invalid argument - handle(%p), compare(%p).", handle, compare);
+    }
+    else if (handle->count > 1)
+    {
+        /* Codes_SRS_VECTOR_99_015: [VECTOR_sort shall sort the elements in place in the order defined by `compare`.] */
+        qsort(handle->storage, handle->count, handle->elementSize, compare);
     }
 }
 
@@ -318,6 +371,29 @@ void* VECTOR_find_if(VECTOR_HANDLE handle, PREDICATE_FUNCTION pred, const void*
     return result;
 }
 
+void* VECTOR_binary_search(VECTOR_HANDLE handle, const void* value, VECTOR_COMPARE_FUNCTION compare)
+{
+    void* result;
+    if (handle == NULL || value == NULL || compare == NULL)
+    {
+        /* Codes_SRS_VECTOR_99_016: [VECTOR_binary_search shall fail and return NULL if `handle`, `value` or `compare` is NULL.] */
+        LogError("invalid argument - handle(%p), value(%p), compare(%p).", handle, value, compare);
+        result = NULL;
+    }
+    else if (handle->count == 0)
+    {
+        /* Codes_SRS_VECTOR_99_018: [VECTOR_binary_search shall return NULL if no element compares equal to `value`.] */
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_99_017: [VECTOR_binary_search shall return an element of the vector, sorted in the order defined by `compare`, that compares equal to `value`.] */
+        /* Codes_SRS_VECTOR_99_018: [VECTOR_binary_search shall return NULL if no element compares equal to `value`.] */
+        result = bsearch(value, handle->storage, handle->count, handle->elementSize, compare);
+    }
+    return result;
+}
+
 /* capacity */
 
 size_t VECTOR_size(VECTOR_HANDLE handle)
@@ -336,3 +412,83 @@ size_t VECTOR_size(VECTOR_HANDLE handle)
     }
     return result;
 }
+
+size_t VECTOR_capacity(VECTOR_HANDLE handle)
+{
+    size_t result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_VECTOR_99_005: [VECTOR_capacity shall return 0 if the given handle is NULL.] */
+        LogError("invalid argument handle(NULL).");
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_99_004: [VECTOR_capacity shall return the number of elements the internal storage has room for.] */
+        result = handle->capacity;
+    }
+    return result;
+}
+
+int VECTOR_reserve(VECTOR_HANDLE handle, size_t numElements)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_VECTOR_99_006: [VECTOR_reserve shall fail and return non-zero if `handle` is NULL.] */
+        LogError("invalid argument handle(NULL).");
+        result = __FAILURE__;
+    }
+    else if (numElements <= handle->capacity)
+    {
+        /* Codes_SRS_VECTOR_99_007: [If the capacity is already at least `numElements`, VECTOR_reserve shall leave the vector unchanged and return 0.] */
+        result = 0;
+    }
+    else if (set_capacity(handle, numElements) != 0)
+    {
+        /* Codes_SRS_VECTOR_99_009: [VECTOR_reserve shall fail and return non-zero if memory allocation fails, leaving the vector unchanged.] */
+        LogError("failure reserving %zd elements.", numElements);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_99_008: [Otherwise VECTOR_reserve shall grow the internal storage to room for exactly `numElements` elements and return 0.] */
+        result = 0;
+    }
+    return result;
+}
+
+int VECTOR_shrink_to_fit(VECTOR_HANDLE handle)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_VECTOR_99_010: [VECTOR_shrink_to_fit shall fail and return non-zero if `handle` is NULL.] */
+        LogError("invalid argument handle(NULL).");
+        result = __FAILURE__;
+    }
+    else if (handle->count == handle->capacity)
+    {
+        result = 0;
+    }
+    else if (handle->count == 0)
+    {
+        /* Codes_SRS_VECTOR_99_011: [If the vector is empty, VECTOR_shrink_to_fit shall release the internal storage and return 0.] */
+        free(handle->storage);
+        handle->storage = NULL;
+        handle->capacity = 0;
+        result = 0;
+    }
+    else if (set_capacity(handle, handle->count) != 0)
+    {
+        /* Codes_SRS_VECTOR_99_013: [VECTOR_shrink_to_fit shall fail and return non-zero if memory allocation fails, leaving the vector unchanged.] */
+        LogError("failure shrinking to %zd elements.", handle->count);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_99_012: [Otherwise VECTOR_shrink_to_fit shall reduce the internal storage to room for exactly the elements of the vector and return 0.] */
+        result = 0;
+    }
+    return result;
+}
@@ -9,7 +9,7 @@
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/wsio.h"
 #include "azure_c_shared_utility/xlogging.h"
-#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/doublylinkedlist.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_c_shared_utility/xio.h"
 #include "azure_c_shared_utility/shared_util_options.h"
@@ -30,9 +30,13 @@ typedef enum IO_STATE_TAG
 
 typedef struct PENDING_IO_TAG
 {
+    DLIST_ENTRY entry;
     ON_SEND_COMPLETE on_send_complete;
     void* callback_context;
-    void* wsio;
+    /* cleared when the send completes */
+    bool is_queued;
+    /* set while uws_client_send_frame_async runs, wsio_send then frees the pending IO itself if the uws instance completes it inline */
+    bool is_being_sent;
 } PENDING_IO;
 
 typedef struct WSIO_INSTANCE_TAG
@@ -46,7 +50,7 @@ typedef struct WSIO_INSTANCE_TAG
     ON_IO_CLOSE_COMPLETE on_io_close_complete;
     void* on_io_close_complete_context;
     IO_STATE io_state;
-    SINGLYLINKEDLIST_HANDLE pending_io_list;
+    DLIST_ENTRY pending_io_list;
     UWS_CLIENT_HANDLE uws;
 } WSIO_INSTANCE;
 
@@ -61,16 +65,11 @@ static void indicate_open_complete(WSIO_INSTANCE* ws_io_instance, IO_OPEN_RESULT
     ws_io_instance->on_io_open_complete(ws_io_instance->on_io_open_complete_context, open_result);
 }
 
-static void complete_send_item(LIST_ITEM_HANDLE pending_io_list_item, IO_SEND_RESULT io_send_result)
+static void complete_send_item(PENDING_IO* pending_io, IO_SEND_RESULT io_send_result)
 {
-    PENDING_IO* pending_io = (PENDING_IO*)singlylinkedlist_item_get_value(pending_io_list_item);
-    WSIO_INSTANCE* wsio_instance = (WSIO_INSTANCE*)pending_io->wsio;
-
-    /* Codes_SRS_WSIO_01_145: [ Removing it from the list shall be done by calling `singlylinkedlist_remove`. ]*/
-    if (singlylinkedlist_remove(wsio_instance->pending_io_list, pending_io_list_item) != 0)
-    {
-        LogError("Failed removing pending IO from linked list.");
-    }
+    /* Codes_SRS_WSIO_01_145: [ Removing it from the list shall be done by calling `DList_RemoveEntryList`. ]*/
+    (void)DList_RemoveEntryList(&pending_io->entry);
+    pending_io->is_queued = false;
 
     /* Codes_SRS_WSIO_01_105: [ The argument `on_send_complete` shall be optional, if NULL is passed by the caller then no send complete callback shall be triggered. ]*/
     if (pending_io->on_send_complete != NULL)
@@ -78,8 +77,11 @@ static void complete_send_item(LIST_ITEM_HANDLE pending_io_list_item, IO_SEND_RE
         pending_io->on_send_complete(pending_io->callback_context, io_send_result);
     }
 
-    /* Codes_SRS_WSIO_01_144: [ Also the pending IO data shall be freed. ]*/
-    free(pending_io);
+    if (!pending_io->is_being_sent)
+    {
+        /* Codes_SRS_WSIO_01_144: [ Also the pending IO data shall be freed. ]*/
+        free(pending_io);
+    }
 }
 
 static void on_underlying_ws_send_frame_complete(void* context, WS_SEND_FRAME_RESULT ws_send_frame_result)
@@ -91,7 +93,7 @@ static void on_underlying_ws_send_frame_complete(void* context, WS_SEND_FRAME_RE
     else
     {
         IO_SEND_RESULT io_send_result;
-        LIST_ITEM_HANDLE list_item_handle = (LIST_ITEM_HANDLE)context;
+        PENDING_IO* pending_io = (PENDING_IO*)context;
 
         /* Codes_SRS_WSIO_01_143: [ When `on_underlying_ws_send_frame_complete` is called after sending a WebSocket frame, the pending IO shall be removed from the list. ]*/
         switch (ws_send_frame_result)
@@ -113,7 +115,7 @@ static void on_underlying_ws_send_frame_complete(void* context, WS_SEND_FRAME_RE
             break;
         }
 
-        complete_send_item(list_item_handle, io_send_result);
+        complete_send_item(pending_io, io_send_result);
     }
 }
 
@@ -184,13 +186,11 @@ static int internal_close(WSIO_INSTANCE* wsio_instance, ON_IO_CLOSE_COMPLETE on_
             else
             {
                 /* Codes_SRS_WSIO_01_085: [ `wsio_close` shall close the websockets IO if an open action is either pending or has completed successfully (if the IO is open).  ]*/
-                LIST_ITEM_HANDLE first_pending_io;
-
                 /* Codes_SRS_WSIO_01_091: [ `wsio_close` shall obtain all the pending IO items by repetitively querying for the head of the pending IO list and freeing that head item. ]*/
-                /* Codes_SRS_WSIO_01_092: [ Obtaining the head of the pending IO list shall be done by calling `singlylinkedlist_get_head_item`. ]*/
-                while ((first_pending_io = singlylinkedlist_get_head_item(wsio_instance->pending_io_list)) != NULL)
+                /* Codes_SRS_WSIO_01_092: [ `wsio_close` shall stop when `DList_IsListEmpty` indicates that the pending IO list is empty. ]*/
+                while (!DList_IsListEmpty(&wsio_instance->pending_io_list))
                 {
-                    complete_send_item(first_pending_io, IO_SEND_CANCELLED);
+                    complete_send_item(containingRecord(wsio_instance->pending_io_list.Flink, PENDING_IO, entry), IO_SEND_CANCELLED);
                 }
 
                 /* Codes_SRS_WSIO_01_133: [ On success `wsio_close` shall return 0. ]*/
@@ -242,6 +242,9 @@ CONCRETE_IO_HANDLE wsio_create(void* io_create_parameters)
             result->on_io_close_complete = NULL;
             result->on_io_close_complete_context = NULL;
 
+            /* Codes_SRS_WSIO_01_076: [ `wsio_create` shall initialize the pending send IO list that is to be used to queue send packets by calling `DList_InitializeListHead`. ]*/
+            DList_InitializeListHead(&result->pending_io_list);
+
             /* Codes_SRS_WSIO_01_070: [ The underlying uws instance shall be created by calling `uws_client_create_with_io`. ]*/
             /* Codes_SRS_WSIO_01_071: [ The arguments for `uws_client_create_with_io` shall be: ]*/
             /* Codes_SRS_WSIO_01_185: [ - `underlying_io_interface` shall be set to the `underlying_io_interface` field in the `io_create_parameters` passed to `wsio_create`. ]*/
@@ -260,20 +263,7 @@ CONCRETE_IO_HANDLE wsio_create(void* io_create_parameters)
             }
             else
             {
-                /* Codes_SRS_WSIO_01_076: [ `wsio_create` shall create a pending send IO list that is to be used to queue send packets by calling `singlylinkedlist_create`. ]*/
-                result->pending_io_list = singlylinkedlist_create();
-                if (result->pending_io_list == NULL)
-                {
-                    /* Codes_SRS_WSIO_01_077: [ If `singlylinkedlist_create` fails then `wsio_create` shall fail and return NULL. ]*/
-                    LogError("Cannot create singly linked list.");
-                    uws_client_destroy(result->uws);
-                    free(result);
-                    result = NULL;
-                }
-                else
-                {
-                    result->io_state = IO_STATE_NOT_OPEN;
-                }
+                result->io_state = IO_STATE_NOT_OPEN;
             }
         }
     }
@@ -300,8 +290,6 @@ void wsio_destroy(CONCRETE_IO_HANDLE ws_io)
         /* Codes_SRS_WSIO_01_078: [ `wsio_destroy` shall free all resources associated with the wsio instance. ]*/
         /* Codes_SRS_WSIO_01_080: [ `wsio_destroy` shall destroy the uws instance created in `wsio_create` by calling `uws_client_destroy`. ]*/
         uws_client_destroy(wsio_instance->uws);
-        /* Codes_SRS_WSIO_01_081: [ `wsio_destroy` shall free the list used to track the pending send IOs by calling `singlylinkedlist_destroy`. ]*/
-        singlylinkedlist_destroy(wsio_instance->pending_io_list);
         free(ws_io);
     }
 }
@@ -578,7 +566,6 @@ int wsio_send(CONCRETE_IO_HANDLE ws_io, const void* buffer, size_t size, ON_SEND
         }
         else
         {
-            LIST_ITEM_HANDLE new_item;
             PENDING_IO* pending_socket_io = (PENDING_IO*)malloc(sizeof(PENDING_IO));
             if (pending_socket_io == NULL)
             {
@@ -587,38 +574,48 @@ int wsio_send(CONCRETE_IO_HANDLE ws_io, const void* buffer, size_t size, ON_SEND
             }
             else
             {
+                PDLIST_ENTRY pending_io_entry = &pending_socket_io->entry;
+
                 /* Codes_SRS_WSIO_01_103: [ The entry shall contain the `on_send_complete` callback and its context. ]*/
                 pending_socket_io->on_send_complete = on_send_complete;
                 pending_socket_io->callback_context = callback_context;
-                pending_socket_io->wsio = wsio_instance;
 
-                /* Codes_SRS_WSIO_01_102: [ An entry shall be queued in the singly linked list by calling `singlylinkedlist_add`. ]*/
-                if ((new_item = singlylinkedlist_add(wsio_instance->pending_io_list, pending_socket_io)) == NULL)
+                /* Codes_SRS_WSIO_01_102: [ The entry shall be queued at the end of the pending IO list by calling `DList_InsertTailList`. ]*/
+                DList_InsertTailList(&wsio_instance->pending_io_list, pending_io_entry);
+                pending_socket_io->is_queued = true;
+                pending_socket_io->is_being_sent = true;
+
+                /* Codes_SRS_WSIO_01_095: [ `wsio_send` shall call `uws_client_send_frame_async`, passing the `buffer` and `size` arguments as they are: ]*/
+                /* Codes_SRS_WSIO_01_097: [ The `is_final` argument shall be set to true. ]*/
+                /* Codes_SRS_WSIO_01_096: [ The frame type used shall be `WS_FRAME_TYPE_BINARY`. ]*/
+                if (uws_client_send_frame_async(wsio_instance->uws, WS_FRAME_TYPE_BINARY, (const unsigned char*)buffer, size, true, on_underlying_ws_send_frame_complete, pending_socket_io) != 0)
                 {
-                    /* Codes_SRS_WSIO_01_104: [ If `singlylinkedlist_add` fails, `wsio_send` shall fail and return a non-zero value. ]*/
+                    LogError("Could not send the frame through the uws instance");
+
+                    /* Codes_SRS_WSIO_99_001: [ If `uws_client_send_frame_async` fails and the pending IO is still queued, it shall be removed from the list and freed. ]*/
+                    if (pending_socket_io->is_queued)
+                    {
+                        (void)DList_RemoveEntryList(pending_io_entry);
+                    }
                     free(pending_socket_io);
+
+                    /* Codes_SRS_WSIO_99_002: [ If `uws_client_send_frame_async` fails, `wsio_send` shall fail and return a non-zero value. ]*/
                     result = __FAILURE__;
                 }
                 else
                 {
-                    /* Codes_SRS_WSIO_01_095: [ `wsio_send` shall call `uws_client_send_frame_async`, passing the `buffer` and `size` arguments as they are: ]*/
-                    /* Codes_SRS_WSIO_01_097: [ The `is_final` argument shall be set to true. ]*/
-                    /* Codes_SRS_WSIO_01_096: [ The frame type used shall be `WS_FRAME_TYPE_BINARY`. ]*/
-                    if (uws_client_send_frame_async(wsio_instance->uws, WS_FRAME_TYPE_BINARY, (const unsigned char*)buffer, size, true, on_underlying_ws_send_frame_complete, new_item) != 0)
+                    if (!pending_socket_io->is_queued)
                     {
-                        if (singlylinkedlist_remove(wsio_instance->pending_io_list, new_item) != 0)
-                        {
-                            LogError("Failed removing pending IO from linked list.");
-                        }
-
+                        /* Codes_SRS_WSIO_99_003: [ If the uws instance completes the send from within `uws_client_send_frame_async`, the pending IO shall be freed once `uws_client_send_frame_async` returns. ]*/
                         free(pending_socket_io);
-                        result = __FAILURE__;
                     }
                     else
                     {
-                        /* Codes_SRS_WSIO_01_098: [ On success, `wsio_send` shall return 0. ]*/
-                        result = 0;
+                        pending_socket_io->is_being_sent = false;
                     }
+
+                    /* Codes_SRS_WSIO_01_098: [ On success, `wsio_send` shall return 0. ]*/
+                    result = 0;
                 }
             }
         }
@@ -0,0 +1,633 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/arena.h"
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/buffer_.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+#define TEST_CHUNK_SIZE 256
+
+static bool is_aligned(const void* ptr)
+{
+    return ((uintptr_t)ptr % 16) == 0;
+}
+
+BEGIN_TEST_SUITE(arena_unittests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* ARENA_create */
+
+/* Tests_SRS_ARENA_99_001: [ ARENA_create shall allocate the arena together with its first chunk of chunk_size bytes, rounded up to a multiple of 16, in a single allocation and return a handle to it. ]*/
+TEST_FUNCTION(ARENA_create_succeeds)
+{
+    // arrange
+
+    // act
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(arena);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_002: [ If chunk_size is 0, ARENA_create shall use a chunk size of 4096 bytes. ]*/
+TEST_FUNCTION(ARENA_create_with_0_chunk_size_serves_4096_bytes_from_the_first_chunk)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(0);
+    unsigned char* first;
+    unsigned char* second;
+
+    // act
+    first = (unsigned char*)ARENA_malloc(arena, 2048);
+    second = (unsigned char*)ARENA_malloc(arena, 2048);
+
+    // assert
+    ASSERT_IS_NOT_NULL(first);
+    ASSERT_IS_TRUE(second == first + 2048);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_003: [ If chunk_size is too large or the allocation fails, ARENA_create shall return NULL. ]*/
+TEST_FUNCTION(ARENA_create_with_a_huge_chunk_size_fails)
+{
+    // arrange
+
+    // act
+    ARENA_HANDLE arena = ARENA_create(SIZE_MAX - 8);
+
+    // assert
+    ASSERT_IS_NULL(arena);
+}
+
+/* ARENA_destroy */
+
+/* Tests_SRS_ARENA_99_004: [ If arena is NULL, ARENA_destroy shall do nothing. ]*/
+TEST_FUNCTION(ARENA_destroy_with_NULL_arena_does_nothing)
+{
+    // arrange
+
+    // act
+    ARENA_destroy(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+/* Tests_SRS_ARENA_99_005: [ ARENA_destroy shall free every chunk and the arena itself. ]*/
+TEST_FUNCTION(ARENA_destroy_frees_all_chunks)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    size_t i;
+    for (i = 0; i < 10; i++)
+    {
+        ASSERT_IS_NOT_NULL(ARENA_malloc(arena, TEST_CHUNK_SIZE / 2));
+    }
+    ASSERT_IS_NOT_NULL(ARENA_malloc(arena, TEST_CHUNK_SIZE * 4));
+
+    // act
+    ARENA_destroy(arena);
+
+    // assert
+    // no explicit assert, the memory checker of the test build catches leaks
+}
+
+/* ARENA_malloc */
+
+/* Tests_SRS_ARENA_99_006: [ If arena is NULL, ARENA_malloc shall return NULL. ]*/
+TEST_FUNCTION(ARENA_malloc_with_NULL_arena_fails)
+{
+    // arrange
+
+    // act
+    void* result = ARENA_malloc(NULL, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_ARENA_99_007: [ ARENA_malloc shall return the next free block of the current chunk, with size rounded up to a multiple of 16 bytes and aligned to 16 bytes. ]*/
+TEST_FUNCTION(ARENA_malloc_returns_consecutive_aligned_blocks)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* first;
+    unsigned char* second;
+    unsigned char* third;
+
+    // act
+    first = (unsigned char*)ARENA_malloc(arena, 1);
+    second = (unsigned char*)ARENA_malloc(arena, 17);
+    third = (unsigned char*)ARENA_malloc(arena, 0);
+
+    // assert
+    ASSERT_IS_NOT_NULL(first);
+    ASSERT_IS_TRUE(is_aligned(first));
+    ASSERT_IS_TRUE(second == first + 16);
+    ASSERT_IS_TRUE(third == second + 32);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_008: [ When the current chunk does not have room for the request, ARENA_malloc shall allocate a new chunk of the arena's chunk size and make it the current chunk. ]*/
+TEST_FUNCTION(ARENA_malloc_moves_to_a_new_chunk_when_the_current_one_is_full)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* first = (unsigned char*)ARENA_malloc(arena, TEST_CHUNK_SIZE - 16);
+    unsigned char* second;
+    unsigned char* third;
+
+    // act
+    second = (unsigned char*)ARENA_malloc(arena, 32);
+    third = (unsigned char*)ARENA_malloc(arena, 32);
+
+    // assert
+    ASSERT_IS_NOT_NULL(first);
+    ASSERT_IS_NOT_NULL(second);
+    ASSERT_IS_TRUE(is_aligned(second));
+    ASSERT_IS_FALSE((second >= first) && (second < first + TEST_CHUNK_SIZE));
+    ASSERT_IS_TRUE(third == second + 32);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_009: [ A request larger than the chunk size shall get a chunk of its own, and the current chunk shall stay current. ]*/
+TEST_FUNCTION(ARENA_malloc_serves_a_large_request_from_a_chunk_of_its_own)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* first = (unsigned char*)ARENA_malloc(arena, 16);
+    unsigned char* large;
+    unsigned char* next;
+
+    // act
+    large = (unsigned char*)ARENA_malloc(arena, TEST_CHUNK_SIZE * 4);
+    next = (unsigned char*)ARENA_malloc(arena, 16);
+
+    // assert
+    ASSERT_IS_NOT_NULL(large);
+    ASSERT_IS_TRUE(is_aligned(large));
+    (void)memset(large, 0x42, TEST_CHUNK_SIZE * 4);
+    ASSERT_IS_TRUE(next == first + 16);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_010: [ If size cannot be served, or allocating the chunk fails, ARENA_malloc shall return NULL. ]*/
+TEST_FUNCTION(ARENA_malloc_with_a_huge_size_fails)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+
+    // act
+    void* result = ARENA_malloc(arena, SIZE_MAX - 4);
+
+    // assert
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* ARENA_realloc */
+
+/* Tests_SRS_ARENA_99_011: [ If arena is NULL, ARENA_realloc shall return NULL. ]*/
+TEST_FUNCTION(ARENA_realloc_with_NULL_arena_fails)
+{
+    // arrange
+
+    // act
+    void* result = ARENA_realloc(NULL, NULL, 0, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_ARENA_99_012: [ If ptr is NULL, ARENA_realloc shall behave like ARENA_malloc. ]*/
+TEST_FUNCTION(ARENA_realloc_with_NULL_ptr_allocates)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* first = (unsigned char*)ARENA_malloc(arena, 16);
+
+    // act
+    unsigned char* result = (unsigned char*)ARENA_realloc(arena, NULL, 0, 16);
+
+    // assert
+    ASSERT_IS_TRUE(result == first + 16);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_013: [ If ptr is the last block served from the current chunk and new_size fits in what is left of the chunk, ARENA_realloc shall resize the block in place and return ptr. ]*/
+TEST_FUNCTION(ARENA_realloc_grows_the_last_block_in_place)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* block = (unsigned char*)ARENA_malloc(arena, 16);
+    unsigned char* result;
+    unsigned char* next;
+    (void)memcpy(block, "0123456789", 11);
+
+    // act
+    result = (unsigned char*)ARENA_realloc(arena, block, 16, 100);
+    next = (unsigned char*)ARENA_malloc(arena, 16);
+
+    // assert
+    ASSERT_IS_TRUE(result == block);
+    ASSERT_ARE_EQUAL(char_ptr, "0123456789", (const char*)result);
+    ASSERT_IS_TRUE(next == block + 112);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_013: [ If ptr is the last block served from the current chunk and new_size fits in what is left of the chunk, ARENA_realloc shall resize the block in place and return ptr. ]*/
+TEST_FUNCTION(ARENA_realloc_shrinking_the_last_block_gives_the_rest_back)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* block = (unsigned char*)ARENA_malloc(arena, 128);
+    unsigned char* result;
+    unsigned char* next;
+
+    // act
+    result = (unsigned char*)ARENA_realloc(arena, block, 128, 20);
+    next = (unsigned char*)ARENA_malloc(arena, 16);
+
+    // assert
+    ASSERT_IS_TRUE(result == block);
+    ASSERT_IS_TRUE(next == block + 32);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_014: [ Otherwise, if new_size is not larger than old_size, ARENA_realloc shall return ptr. ]*/
+TEST_FUNCTION(ARENA_realloc_shrinking_an_older_block_returns_ptr)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* block = (unsigned char*)ARENA_malloc(arena, 64);
+    (void)ARENA_malloc(arena, 16);
+
+    // act
+    unsigned char* result = (unsigned char*)ARENA_realloc(arena, block, 64, 10);
+
+    // assert
+    ASSERT_IS_TRUE(result == block);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_015: [ Otherwise ARENA_realloc shall take a new block of new_size bytes from the arena, copy old_size bytes from ptr to it and return it. ]*/
+TEST_FUNCTION(ARENA_realloc_growing_an_older_block_copies_it)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* block = (unsigned char*)ARENA_malloc(arena, 16);
+    unsigned char* other = (unsigned char*)ARENA_malloc(arena, 16);
+    unsigned char* result;
+    (void)memcpy(block, "abcdefghijklmno", 16);
+
+    // act
+    result = (unsigned char*)ARENA_realloc(arena, block, 16, 48);
+
+    // assert
+    ASSERT_IS_TRUE(result == other + 16);
+    ASSERT_ARE_EQUAL(char_ptr, "abcdefghijklmno", (const char*)result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_015: [ Otherwise ARENA_realloc shall take a new block of new_size bytes from the arena, copy old_size bytes from ptr to it and return it. ]*/
+TEST_FUNCTION(ARENA_realloc_growing_the_last_block_past_the_chunk_copies_it)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* block = (unsigned char*)ARENA_malloc(arena, 16);
+    unsigned char* result;
+    (void)memcpy(block, "abcdefghijklmno", 16);
+
+    // act
+    result = (unsigned char*)ARENA_realloc(arena, block, 16, TEST_CHUNK_SIZE * 2);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_TRUE(result != block);
+    ASSERT_ARE_EQUAL(char_ptr, "abcdefghijklmno", (const char*)result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_99_016: [ If the new block cannot be obtained, ARENA_realloc shall return NULL and leave ptr untouched. ]*/
+TEST_FUNCTION(ARENA_realloc_with_a_huge_size_fails_and_keeps_ptr)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* block = (unsigned char*)ARENA_malloc(arena, 16);
+    void* result;
+    (void)memcpy(block, "abc", 4);
+
+    // act
+    result = ARENA_realloc(arena, block, 16, SIZE_MAX - 4);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "abc", (const char*)block);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* ARENA_reset */
+
+/* Tests_SRS_ARENA_99_017: [ If arena is NULL, ARENA_reset shall do nothing. ]*/
+TEST_FUNCTION(ARENA_reset_with_NULL_arena_does_nothing)
+{
+    // arrange
+
+    // act
+    ARENA_reset(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+/* Tests_SRS_ARENA_99_018: [ ARENA_reset shall free every chunk but the first one and make the whole first chunk available again. ]*/
+TEST_FUNCTION(ARENA_reset_makes_the_first_chunk_available_again)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    unsigned char* first = (unsigned char*)ARENA_malloc(arena, 16);
+    size_t i;
+    for (i = 0; i < 10; i++)
+    {
+        ASSERT_IS_NOT_NULL(ARENA_malloc(arena, TEST_CHUNK_SIZE / 2));
+    }
+    ASSERT_IS_NOT_NULL(ARENA_malloc(arena, TEST_CHUNK_SIZE * 4));
+
+    // act
+    ARENA_reset(arena);
+
+    // assert
+    ASSERT_IS_TRUE(ARENA_malloc(arena, 16) == first);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* STRING and BUFFER built in an arena */
+
+/* Tests_SRS_STRING_99_001: [ STRING_new_in_arena shall take a new STRING pointing to an empty string from arena. ]*/
+/* Tests_SRS_STRING_99_005: [ The functions that change the content of a STRING built in an arena shall take the memory for the new content from that arena. ]*/
+/* Tests_SRS_STRING_99_006: [ STRING_delete shall not free a STRING built in an arena, its memory goes back to the arena when the arena is reset or destroyed. ]*/
+TEST_FUNCTION(STRING_new_in_arena_builds_a_STRING_that_works_like_any_other)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    STRING_HANDLE clone;
+
+    // act
+    STRING_HANDLE result = STRING_new_in_arena(arena);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "", STRING_c_str(result));
+    ASSERT_ARE_EQUAL(int, 0, STRING_concat(result, "sr=myhub.azure-devices.net"));
+    ASSERT_ARE_EQUAL(int, 0, STRING_concat(result, "&sig="));
+    ASSERT_ARE_EQUAL(int, 0, STRING_sprintf(result, "%d", 1234));
+    ASSERT_ARE_EQUAL(char_ptr, "sr=myhub.azure-devices.net&sig=1234", STRING_c_str(result));
+    ASSERT_ARE_EQUAL(int, 0, STRING_quote(result));
+    ASSERT_ARE_EQUAL(char_ptr, "\"sr=myhub.azure-devices.net&sig=1234\"", STRING_c_str(result));
+    ASSERT_ARE_EQUAL(int, 0, STRING_copy_n(result, "abcdef", 3));
+    ASSERT_ARE_EQUAL(char_ptr, "abc", STRING_c_str(result));
+    clone = STRING_clone(result);
+    ASSERT_ARE_EQUAL(char_ptr, "abc", STRING_c_str(clone));
+    ASSERT_ARE_EQUAL(int, 0, STRING_empty(result));
+    ASSERT_ARE_EQUAL(size_t, 0, STRING_length(result));
+
+    // cleanup
+    STRING_delete(result);
+    STRING_delete(clone);
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_STRING_99_002: [ If arena is NULL or taking memory from it fails, STRING_new_in_arena shall return NULL. ]*/
+TEST_FUNCTION(STRING_new_in_arena_with_NULL_arena_fails)
+{
+    // arrange
+
+    // act
+    STRING_HANDLE result = STRING_new_in_arena(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_STRING_99_003: [ STRING_construct_in_arena shall take a new STRING holding a copy of psz from arena. ]*/
+/* Tests_SRS_STRING_99_005: [ The functions that change the content of a STRING built in an arena shall take the memory for the new content from that arena. ]*/
+TEST_FUNCTION(STRING_construct_in_arena_copies_psz)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    STRING_HANDLE other;
+
+    // act
+    STRING_HANDLE result = STRING_construct_in_arena(arena, "SharedAccessSignature ");
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "SharedAccessSignature ", STRING_c_str(result));
+    other = STRING_construct_in_arena(arena, "sr=");
+    ASSERT_ARE_EQUAL(int, 0, STRING_concat_with_STRING(result, other));
+    ASSERT_ARE_EQUAL(int, 0, STRING_copy(other, "a string that no longer fits in the block it had"));
+    ASSERT_ARE_EQUAL(char_ptr, "SharedAccessSignature sr=", STRING_c_str(result));
+    ASSERT_ARE_EQUAL(char_ptr, "a string that no longer fits in the block it had", STRING_c_str(other));
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_STRING_99_004: [ If arena or psz is NULL, or taking memory from arena fails, STRING_construct_in_arena shall return NULL. ]*/
+TEST_FUNCTION(STRING_construct_in_arena_with_NULL_psz_fails)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+
+    // act
+    STRING_HANDLE result = STRING_construct_in_arena(arena, NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_BUFFER_99_001: [ BUFFER_new_in_arena shall take from arena a BUFFER_HANDLE that will contain a NULL unsigned char*. ]*/
+/* Tests_SRS_BUFFER_99_005: [ The functions that change the content of a BUFFER built in an arena shall take the memory for the new content from that arena. ]*/
+/* Tests_SRS_BUFFER_99_006: [ BUFFER_delete shall not free a BUFFER built in an arena, its memory goes back to the arena when the arena is reset or destroyed. ]*/
+TEST_FUNCTION(BUFFER_new_in_arena_builds_a_BUFFER_that_works_like_any_other)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    BUFFER_HANDLE other;
+    BUFFER_HANDLE clone;
+
+    // act
+    BUFFER_HANDLE result = BUFFER_new_in_arena(arena);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NULL(BUFFER_u_char(result));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_build(result, (const unsigned char*)"abc", 3));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_append_build(result, (const unsigned char*)"def", 3));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_enlarge(result, 300));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_shrink(result, 300, true));
+    other = BUFFER_create_in_arena(arena, (const unsigned char*)"<>", 2);
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_prepend(result, other));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_append(result, other));
+    ASSERT_ARE_EQUAL(size_t, 10, BUFFER_length(result));
+    ASSERT_IS_TRUE(memcmp(BUFFER_u_char(result), "<>abcdef<>", 10) == 0);
+    clone = BUFFER_clone(result);
+    ASSERT_IS_TRUE(memcmp(BUFFER_u_char(clone), "<>abcdef<>", 10) == 0);
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_unbuild(result));
+
+    // cleanup
+    BUFFER_delete(result);
+    BUFFER_delete(other);
+    BUFFER_delete(clone);
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_BUFFER_99_002: [ If arena is NULL or taking memory from it fails, BUFFER_new_in_arena shall return NULL. ]*/
+TEST_FUNCTION(BUFFER_new_in_arena_with_NULL_arena_fails)
+{
+    // arrange
+
+    // act
+    BUFFER_HANDLE result = BUFFER_new_in_arena(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_BUFFER_99_003: [ BUFFER_create_in_arena shall take size bytes from arena, copy size bytes from source into them and return a non-NULL handle. ]*/
+TEST_FUNCTION(BUFFER_create_in_arena_copies_source)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+
+    // act
+    BUFFER_HANDLE result = BUFFER_create_in_arena(arena, (const unsigned char*)"\x01\x02\x03", 3);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 3, BUFFER_length(result));
+    ASSERT_IS_TRUE(memcmp(BUFFER_u_char(result), "\x01\x02\x03", 3) == 0);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_BUFFER_99_004: [ If arena or source is NULL, or taking memory from arena fails, BUFFER_create_in_arena shall return NULL. ]*/
+TEST_FUNCTION(BUFFER_create_in_arena_with_NULL_source_fails)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+
+    // act
+    BUFFER_HANDLE result = BUFFER_create_in_arena(arena, NULL, 3);
+
+    // assert
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* Tests_SRS_BUFFER_99_009: [ The content of a BUFFER built in an arena shall be copied to memory obtained with malloc, since the arena memory cannot outlive the arena. ]*/
+/* Tests_SRS_BUFFER_99_011: [ On success BUFFER_detach shall leave the BUFFER empty and return zero. ]*/
+TEST_FUNCTION(BUFFER_detach_copies_the_content_of_a_BUFFER_built_in_an_arena)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_CHUNK_SIZE);
+    BUFFER_HANDLE buffer = BUFFER_create_in_arena(arena, (const unsigned char*)"\x01\x02\x03", 3);
+    unsigned char* arena_content = BUFFER_u_char(buffer);
+    unsigned char* content;
+    size_t size;
+
+    // act
+    int result = BUFFER_detach(buffer, &content, &size);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, arena_content, content);
+    ASSERT_ARE_EQUAL(size_t, 3, size);
+    ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(buffer));
+    ARENA_destroy(arena);
+    /* the content outlives the arena */
+    ASSERT_IS_TRUE(memcmp(content, "\x01\x02\x03", 3) == 0);
+
+    // cleanup
+    free(content);
+}
+
+END_TEST_SUITE(arena_unittests)
@@ -1806,5 +1806,591 @@ TEST_FUNCTION(Base64_Decoder_invalid_length_fails_6)
 
 }
 
+/*Tests_SRS_BASE64_99_017: [ If source has a character that is not in the base64 alphabet, other than 1 or 2 '=' padding characters at the end, Base64_Decoder shall return NULL. ]*/
+TEST_FUNCTION(Base64_Decoder_invalid_character_fails)
+{
+    ///Arrange
+    BUFFER_HANDLE result;
+
+    ///act
+    result = Base64_Decoder("AB-D");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_BASE64_99_017: [ If source has a character that is not in the base64 alphabet, other than 1 or 2 '=' padding characters at the end, Base64_Decoder shall return NULL. ]*/
+TEST_FUNCTION(Base64_Decoder_padding_not_at_the_end_fails)
+{
+    ///Arrange
+    BUFFER_HANDLE result;
+
+    ///act
+    result = Base64_Decoder("AA==AAAA");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_BASE64_99_001: [ Base64_Encode_Length shall return 4 characters for each started group of 3 bytes. ]*/
+TEST_FUNCTION(Base64_Encode_Length_succeeds)
+{
+    ///act
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, Base64_Encode_Length(0));
+    ASSERT_ARE_EQUAL(size_t, 4, Base64_Encode_Length(1));
+    ASSERT_ARE_EQUAL(size_t, 4, Base64_Encode_Length(2));
+    ASSERT_ARE_EQUAL(size_t, 4, Base64_Encode_Length(3));
+    ASSERT_ARE_EQUAL(size_t, 8, Base64_Encode_Length(4));
+}
+
+/*Tests_SRS_BASE64_99_002: [ If the encoding of size bytes does not fit in a size_t, Base64_Encode_Length shall return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Length_overflow_returns_0)
+{
+    ///act
+    size_t result = Base64_Encode_Length((size_t)-1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_003: [ If source is NULL or sourceLength is not a multiple of 4, Base64_Decode_Length shall return 0. ]*/
+TEST_FUNCTION(Base64_Decode_Length_with_invalid_arguments_returns_0)
+{
+    ///act
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, Base64_Decode_Length(NULL, 4));
+    ASSERT_ARE_EQUAL(size_t, 0, Base64_Decode_Length("AAA", 3));
+}
+
+/*Tests_SRS_BASE64_99_004: [ Otherwise Base64_Decode_Length shall return 3 bytes for each group of 4 characters, minus 1 byte for each '=' padding character at the end of source. ]*/
+TEST_FUNCTION(Base64_Decode_Length_succeeds)
+{
+    ///act
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, Base64_Decode_Length("", 0));
+    ASSERT_ARE_EQUAL(size_t, 1, Base64_Decode_Length("AA==", 4));
+    ASSERT_ARE_EQUAL(size_t, 2, Base64_Decode_Length("AAA=", 4));
+    ASSERT_ARE_EQUAL(size_t, 6, Base64_Decode_Length("AAAAAAAA", 8));
+}
+
+/*Tests_SRS_BASE64_99_005: [ If source, destination or encodedLength is NULL, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Into_with_NULL_arguments_fails)
+{
+    ///arrange
+    char destination[8];
+    size_t encodedLength;
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Into(NULL, 1, destination, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Into((const unsigned char*)"a", 1, NULL, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Into((const unsigned char*)"a", 1, destination, sizeof(destination), NULL));
+}
+
+/*Tests_SRS_BASE64_99_006: [ If destinationSize is smaller than Base64_Encode_Length(size), or if that length does not fit in a size_t, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Into_with_small_destination_fails)
+{
+    ///arrange
+    char destination[8];
+    size_t encodedLength;
+
+    ///act
+    int result = Base64_Encode_Into((const unsigned char*)"abcd", 4, destination, 7, &encodedLength);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_007: [ Base64_Encode_Into shall write the base64 encoding of the size bytes at source in destination, padded with '=', without a null terminator. ]*/
+/*Tests_SRS_BASE64_99_008: [ On success Base64_Encode_Into shall set encodedLength to the number of characters written and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Into_exhaustive_succeeds)
+{
+    size_t i;
+    for (i = 0; i < sizeof(testVector_BINARY_with_equal_signs) / sizeof(testVector_BINARY_with_equal_signs[0]); i++)
+    {
+        ///arrange
+        char destination[16 + 1];
+        size_t encodedLength;
+        int result;
+        (void)memset(destination, '#', sizeof(destination));
+
+        ///act
+        result = Base64_Encode_Into(testVector_BINARY_with_equal_signs[i].inputData, testVector_BINARY_with_equal_signs[i].inputLength, destination, sizeof(destination) - 1, &encodedLength);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, strlen(testVector_BINARY_with_equal_signs[i].expectedOutput), encodedLength);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(testVector_BINARY_with_equal_signs[i].expectedOutput, destination, encodedLength));
+        ASSERT_ARE_EQUAL(char, '#', destination[encodedLength]);
+    }
+}
+
+/*Tests_SRS_BASE64_99_009: [ If source, destination or decodedLength is NULL, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_NULL_arguments_fails)
+{
+    ///arrange
+    unsigned char destination[3];
+    size_t decodedLength;
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Into(NULL, 4, destination, sizeof(destination), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Into("AAAA", 4, NULL, sizeof(destination), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Into("AAAA", 4, destination, sizeof(destination), NULL));
+}
+
+/*Tests_SRS_BASE64_99_010: [ If sourceLength is not a multiple of 4, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_invalid_length_fails)
+{
+    ///arrange
+    unsigned char destination[3];
+    size_t decodedLength;
+
+    ///act
+    int result = Base64_Decode_Into("AAAAA", 5, destination, sizeof(destination), &decodedLength);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_011: [ If destinationSize is smaller than Base64_Decode_Length(source, sourceLength), Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_small_destination_fails)
+{
+    ///arrange
+    unsigned char destination[3];
+    size_t decodedLength;
+
+    ///act
+    int result = Base64_Decode_Into("AAAAAA==", 8, destination, sizeof(destination), &decodedLength);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_012: [ If source has a character that is not in the base64 alphabet, other than 1 or 2 '=' padding characters at the end, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_invalid_character_fails_for_every_implementation)
+{
+    /*long enough for every implementation to look at the bad character with its vector loop*/
+    char source[128 + 1];
+    unsigned char destination[96];
+    size_t position;
+    int implementation;
+
+    for (implementation = 0; implementation <= (int)BASE64_IMPLEMENTATION_NEON; implementation++)
+    {
+        if (Base64_SelectImplementation((BASE64_IMPLEMENTATION)implementation) == 0)
+        {
+            for (position = 0; position < sizeof(source) - 1; position++)
+            {
+                ///arrange
+                size_t decodedLength;
+                const char* badCharacter;
+                (void)memset(source, 'A', sizeof(source) - 1);
+                source[sizeof(source) - 1] = '\0';
+
+                /*'=' is only valid as padding at the end*/
+                for (badCharacter = (position < sizeof(source) - 2) ? "\x80\xff !-.:@[`{=" : "\x80\xff !-.:@[`{"; *badCharacter != '\0'; badCharacter++)
+                {
+                    source[position] = *badCharacter;
+
+                    ///act
+                    ///assert
+                    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Into(source, sizeof(source) - 1, destination, sizeof(destination), &decodedLength));
+                }
+            }
+        }
+    }
+
+    ///cleanup
+    (void)Base64_SelectImplementation(BASE64_IMPLEMENTATION_TABLE);
+}
+
+/*Tests_SRS_BASE64_99_013: [ Otherwise Base64_Decode_Into shall write the decoded bytes in destination, set decodedLength to their number and return 0. ]*/
+TEST_FUNCTION(Base64_Decode_Into_exhaustive_succeeds)
+{
+    size_t i;
+    for (i = 0; i < sizeof(testVector_BINARY_with_equal_signs) / sizeof(testVector_BINARY_with_equal_signs[0]); i++)
+    {
+        ///arrange
+        unsigned char destination[10];
+        size_t decodedLength;
+        int result;
+        const char* source = testVector_BINARY_with_equal_signs[i].expectedOutput;
+
+        ///act
+        result = Base64_Decode_Into(source, strlen(source), destination, testVector_BINARY_with_equal_signs[i].inputLength, &decodedLength);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, testVector_BINARY_with_equal_signs[i].inputLength, decodedLength);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(testVector_BINARY_with_equal_signs[i].inputData, destination, decodedLength));
+    }
+}
+
+/*Tests_SRS_BASE64_99_014: [ If implementation is not supported by this build or by this CPU, Base64_SelectImplementation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_SelectImplementation_with_unknown_implementation_fails)
+{
+    ///arrange
+    BASE64_IMPLEMENTATION before = Base64_GetImplementation();
+
+    ///act
+    int result = Base64_SelectImplementation((BASE64_IMPLEMENTATION)42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, (int)before, (int)Base64_GetImplementation());
+}
+
+/*Tests_SRS_BASE64_99_015: [ Otherwise Base64_SelectImplementation shall make all the encoding and decoding functions use implementation and return 0. ]*/
+/*Tests_SRS_BASE64_99_016: [ Base64_GetImplementation shall return the implementation in use, picking the fastest one supported by the CPU if none is selected yet. ]*/
+TEST_FUNCTION(Base64_every_implementation_matches_the_table_for_every_length)
+{
+    /*long enough for several iterations of the widest vector loop and every tail length*/
+    unsigned char input[300];
+    char expected[400];
+    char actual[400];
+    unsigned char decoded[300];
+    size_t length;
+    int implementation;
+
+    for (length = 0; length < sizeof(input); length++)
+    {
+        input[length] = (unsigned char)(length * 167 + 13);
+    }
+
+    ///act
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, Base64_SelectImplementation(BASE64_IMPLEMENTATION_TABLE));
+    ASSERT_ARE_EQUAL(int, (int)BASE64_IMPLEMENTATION_TABLE, (int)Base64_GetImplementation());
+
+    for (length = 0; length <= sizeof(input); length++)
+    {
+        size_t expectedLength;
+        (void)Base64_SelectImplementation(BASE64_IMPLEMENTATION_TABLE);
+        ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Into(input, length, expected, sizeof(expected), &expectedLength));
+
+        for (implementation = 0; implementation <= (int)BASE64_IMPLEMENTATION_NEON; implementation++)
+        {
+            if (Base64_SelectImplementation((BASE64_IMPLEMENTATION)implementation) == 0)
+            {
+                size_t actualLength;
+                size_t decodedLength;
+                ASSERT_ARE_EQUAL(int, implementation, (int)Base64_GetImplementation());
+
+                ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Into(input, length, actual, sizeof(actual), &actualLength));
+                ASSERT_ARE_EQUAL(size_t, expectedLength, actualLength);
+                ASSERT_ARE_EQUAL(int, 0, memcmp(expected, actual, actualLength));
+
+                ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Into(actual, actualLength, decoded, length, &decodedLength));
+                ASSERT_ARE_EQUAL(size_t, length, decodedLength);
+                ASSERT_ARE_EQUAL(int, 0, memcmp(input, decoded, length));
+            }
+        }
+    }
+
+    ///cleanup
+    (void)Base64_SelectImplementation(BASE64_IMPLEMENTATION_TABLE);
+}
+
+/*Tests_SRS_BASE64_99_018: [ If context is NULL, Base64_Encode_Init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Init_with_NULL_context_fails)
+{
+    ///act
+    int result = Base64_Encode_Init(NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_020: [ If context, destination or encodedLength is NULL, or if source is NULL and size is not 0, Base64_Encode_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Update_with_NULL_arguments_fails)
+{
+    ///arrange
+    BASE64_ENCODE_CONTEXT context;
+    char destination[8];
+    size_t encodedLength;
+    (void)Base64_Encode_Init(&context);
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Update(NULL, (const unsigned char*)"abc", 3, destination, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Update(&context, NULL, 3, destination, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Update(&context, (const unsigned char*)"abc", 3, NULL, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Update(&context, (const unsigned char*)"abc", 3, destination, sizeof(destination), NULL));
+}
+
+/*Tests_SRS_BASE64_99_021: [ If destinationSize is smaller than the number of characters for the whole groups of 3 made by the pending bytes and source, Base64_Encode_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Update_with_small_destination_fails)
+{
+    ///arrange
+    BASE64_ENCODE_CONTEXT context;
+    char destination[8];
+    size_t encodedLength;
+    int result;
+    (void)Base64_Encode_Init(&context);
+    ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Update(&context, (const unsigned char*)"ab", 2, destination, 0, &encodedLength));
+
+    ///act
+    result = Base64_Encode_Update(&context, (const unsigned char*)"c", 1, destination, 3, &encodedLength);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_019: [ Otherwise Base64_Encode_Init shall start a new encoding in context and return 0. ]*/
+/*Tests_SRS_BASE64_99_022: [ Base64_Encode_Update shall encode the bytes pending in context followed by the bytes at source, 3 at a time, in destination. ]*/
+/*Tests_SRS_BASE64_99_023: [ Base64_Encode_Update shall keep the bytes that do not make a whole group of 3 in context. ]*/
+/*Tests_SRS_BASE64_99_024: [ On success Base64_Encode_Update shall set encodedLength to the number of characters written and return 0. ]*/
+/*Tests_SRS_BASE64_99_026: [ Otherwise Base64_Encode_Final shall write the 4 characters of the padded encoding of the bytes pending in context, set encodedLength to 4 and return 0; it shall fail and return a non-zero value if destinationSize is smaller than 4. ]*/
+/*Tests_SRS_BASE64_99_027: [ If there are no bytes pending in context, Base64_Encode_Final shall set encodedLength to 0 and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_streaming_in_pieces_of_every_size_matches_Base64_Encode_Into)
+{
+    unsigned char input[200];
+    char expected[300];
+    char actual[300];
+    size_t expectedLength;
+    size_t length;
+    size_t pieceSize;
+
+    for (length = 0; length < sizeof(input); length++)
+    {
+        input[length] = (unsigned char)(length * 61 + 3);
+    }
+
+    for (length = 0; length <= sizeof(input); length += 7)
+    {
+        ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Into(input, length, expected, sizeof(expected), &expectedLength));
+
+        for (pieceSize = 1; pieceSize <= 70; pieceSize++)
+        {
+            ///arrange
+            BASE64_ENCODE_CONTEXT context;
+            size_t actualLength = 0;
+            size_t consumed;
+            size_t encodedLength;
+            ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Init(&context));
+
+            ///act
+            for (consumed = 0; consumed < length; consumed += pieceSize)
+            {
+                size_t size = (length - consumed < pieceSize) ? length - consumed : pieceSize;
+                ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Update(&context, input + consumed, size, actual + actualLength, Base64_Encode_Length(size), &encodedLength));
+                actualLength += encodedLength;
+            }
+            ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Final(&context, actual + actualLength, 4, &encodedLength));
+            actualLength += encodedLength;
+
+            ///assert
+            ASSERT_ARE_EQUAL(size_t, expectedLength, actualLength);
+            ASSERT_ARE_EQUAL(int, 0, memcmp(expected, actual, actualLength));
+        }
+    }
+}
+
+/*Tests_SRS_BASE64_99_025: [ If context, destination or encodedLength is NULL, Base64_Encode_Final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Final_with_NULL_arguments_fails)
+{
+    ///arrange
+    BASE64_ENCODE_CONTEXT context;
+    char destination[4];
+    size_t encodedLength;
+    (void)Base64_Encode_Init(&context);
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Final(NULL, destination, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Final(&context, NULL, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Final(&context, destination, sizeof(destination), NULL));
+}
+
+/*Tests_SRS_BASE64_99_026: [ Otherwise Base64_Encode_Final shall write the 4 characters of the padded encoding of the bytes pending in context, set encodedLength to 4 and return 0; it shall fail and return a non-zero value if destinationSize is smaller than 4. ]*/
+TEST_FUNCTION(Base64_Encode_Final_with_small_destination_fails)
+{
+    ///arrange
+    BASE64_ENCODE_CONTEXT context;
+    char destination[4];
+    size_t encodedLength;
+    int result;
+    (void)Base64_Encode_Init(&context);
+    ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Update(&context, (const unsigned char*)"a", 1, destination, sizeof(destination), &encodedLength));
+
+    ///act
+    result = Base64_Encode_Final(&context, destination, 3, &encodedLength);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_028: [ If context is NULL, Base64_Decode_Init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Init_with_NULL_context_fails)
+{
+    ///act
+    int result = Base64_Decode_Init(NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_030: [ If context, destination or decodedLength is NULL, or if source is NULL and sourceLength is not 0, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Update_with_NULL_arguments_fails)
+{
+    ///arrange
+    BASE64_DECODE_CONTEXT context;
+    unsigned char destination[3];
+    size_t decodedLength;
+    (void)Base64_Decode_Init(&context);
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Update(NULL, "AAAA", 4, destination, sizeof(destination), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Update(&context, NULL, 4, destination, sizeof(destination), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Update(&context, "AAAA", 4, NULL, sizeof(destination), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Update(&context, "AAAA", 4, destination, sizeof(destination), NULL));
+}
+
+/*Tests_SRS_BASE64_99_031: [ If the padding was already decoded and sourceLength is not 0, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Update_after_the_padding_fails)
+{
+    ///arrange
+    BASE64_DECODE_CONTEXT context;
+    unsigned char destination[3];
+    size_t decodedLength;
+    int result;
+    (void)Base64_Decode_Init(&context);
+    ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Update(&context, "AA=", 3, destination, sizeof(destination), &decodedLength));
+    ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Update(&context, "=", 1, destination, sizeof(destination), &decodedLength));
+    ASSERT_ARE_EQUAL(size_t, 1, decodedLength);
+
+    ///act
+    result = Base64_Decode_Update(&context, "A", 1, destination, sizeof(destination), &decodedLength);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_032: [ If destinationSize is smaller than 3 bytes for each whole group of 4 made by the pending characters and source, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Update_with_small_destination_fails)
+{
+    ///arrange
+    BASE64_DECODE_CONTEXT context;
+    unsigned char destination[3];
+    size_t decodedLength;
+    int result;
+    (void)Base64_Decode_Init(&context);
+    ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Update(&context, "AA", 2, destination, 0, &decodedLength));
+
+    ///act
+    result = Base64_Decode_Update(&context, "AA", 2, destination, 2, &decodedLength);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_034: [ If source has a character that is not in the base64 alphabet, or if '=' is anywhere but at the end of a group of 4 that ends the encoding, Base64_Decode_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Update_with_invalid_characters_fails)
+{
+    static const char* const invalidEncodings[] = { "AB-D", "A=AA", "AA==AAAA", "AA==A", "=AAA" };
+    size_t i;
+    for (i = 0; i < sizeof(invalidEncodings) / sizeof(invalidEncodings[0]); i++)
+    {
+        size_t split;
+        for (split = 0; split <= strlen(invalidEncodings[i]); split++)
+        {
+            ///arrange
+            BASE64_DECODE_CONTEXT context;
+            unsigned char destination[6];
+            size_t decodedLength;
+            int result;
+            (void)Base64_Decode_Init(&context);
+
+            ///act
+            result = Base64_Decode_Update(&context, invalidEncodings[i], split, destination, sizeof(destination), &decodedLength);
+            if (result == 0)
+            {
+                result = Base64_Decode_Update(&context, invalidEncodings[i] + split, strlen(invalidEncodings[i]) - split, destination, sizeof(destination), &decodedLength);
+            }
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        }
+    }
+}
+
+/*Tests_SRS_BASE64_99_029: [ Otherwise Base64_Decode_Init shall start a new decoding in context and return 0. ]*/
+/*Tests_SRS_BASE64_99_033: [ Base64_Decode_Update shall decode the characters pending in context followed by the characters at source, 4 at a time, in destination. ]*/
+/*Tests_SRS_BASE64_99_035: [ Base64_Decode_Update shall keep the characters that do not make a whole group of 4 in context. ]*/
+/*Tests_SRS_BASE64_99_036: [ On success Base64_Decode_Update shall set decodedLength to the number of bytes written and return 0. ]*/
+/*Tests_SRS_BASE64_99_039: [ Otherwise Base64_Decode_Final shall return 0. ]*/
+TEST_FUNCTION(Base64_Decode_streaming_in_pieces_of_every_size_matches_the_input)
+{
+    unsigned char input[200];
+    char encoded[300];
+    unsigned char actual[200];
+    size_t encodedLength;
+    size_t length;
+    size_t pieceSize;
+
+    for (length = 0; length < sizeof(input); length++)
+    {
+        input[length] = (unsigned char)(length * 61 + 3);
+    }
+
+    for (length = 0; length <= sizeof(input); length += 7)
+    {
+        ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Into(input, length, encoded, sizeof(encoded), &encodedLength));
+
+        for (pieceSize = 1; pieceSize <= 70; pieceSize++)
+        {
+            ///arrange
+            BASE64_DECODE_CONTEXT context;
+            size_t actualLength = 0;
+            size_t consumed;
+            size_t decodedLength;
+            ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Init(&context));
+
+            ///act
+            for (consumed = 0; consumed < encodedLength; consumed += pieceSize)
+            {
+                size_t sourceLength = (encodedLength - consumed < pieceSize) ? encodedLength - consumed : pieceSize;
+                ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Update(&context, encoded + consumed, sourceLength, actual + actualLength, (sourceLength + 3) / 4 * 3, &decodedLength));
+                actualLength += decodedLength;
+            }
+
+            ///assert
+            ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Final(&context));
+            ASSERT_ARE_EQUAL(size_t, length, actualLength);
+            ASSERT_ARE_EQUAL(int, 0, memcmp(input, actual, actualLength));
+        }
+    }
+}
+
+/*Tests_SRS_BASE64_99_037: [ If context is NULL, Base64_Decode_Final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Final_with_NULL_context_fails)
+{
+    ///act
+    int result = Base64_Decode_Final(NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_99_038: [ If characters that do not make a whole group of 4 are pending in context, Base64_Decode_Final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Final_with_an_incomplete_group_fails)
+{
+    ///arrange
+    BASE64_DECODE_CONTEXT context;
+    unsigned char destination[3];
+    size_t decodedLength;
+    int result;
+    (void)Base64_Decode_Init(&context);
+    ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Update(&context, "AAAAA", 5, destination, sizeof(destination), &decodedLength));
+
+    ///act
+    result = Base64_Decode_Final(&context);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
 
 END_TEST_SUITE(base64_unittests);
@@ -1564,6 +1564,152 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         BUFFER_delete(res);
     }
 
+    /* BUFFER_create_inline */
+
+    /* Tests_SRS_BUFFER_99_013: [ If source is NULL, size is too large or allocating memory fails, BUFFER_create_inline shall return NULL. ]*/
+    TEST_FUNCTION(BUFFER_create_inline_with_NULL_source_fails)
+    {
+        ///arrange
+
+        ///act
+        BUFFER_HANDLE res = BUFFER_create_inline(NULL, BUFFER_TEST1_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(res);
+    }
+
+    /* Tests_SRS_BUFFER_99_014: [ BUFFER_create_inline shall allocate the BUFFER and room for at least 32 bytes of content, or size bytes when size is larger, in a single allocation. ]*/
+    /* Tests_SRS_BUFFER_99_015: [ BUFFER_create_inline shall copy size bytes from source into the room that follows the BUFFER and return a non-NULL handle. ]*/
+    TEST_FUNCTION(BUFFER_create_inline_succeeds_with_a_single_allocation)
+    {
+        ///arrange
+        BUFFER_HANDLE res;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        res = BUFFER_create_inline(BUFFER_Test1, BUFFER_TEST1_SIZE);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        ASSERT_ARE_EQUAL(size_t, BUFFER_TEST1_SIZE, BUFFER_length(res));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(res), BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        BUFFER_delete(res);
+    }
+
+    /* Tests_SRS_BUFFER_99_013: [ If source is NULL, size is too large or allocating memory fails, BUFFER_create_inline shall return NULL. ]*/
+    TEST_FUNCTION(BUFFER_create_inline_fails_when_gballoc_fails)
+    {
+        ///arrange
+        BUFFER_HANDLE res;
+
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        res = BUFFER_create_inline(BUFFER_Test1, BUFFER_TEST1_SIZE);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BUFFER_99_016: [ The functions that change the content of a BUFFER made by BUFFER_create_inline shall keep the content in the allocation of the BUFFER while it fits and move it to memory of its own when it does not. ]*/
+    TEST_FUNCTION(BUFFER_append_build_to_an_inline_BUFFER_that_fits_does_not_allocate)
+    {
+        ///arrange
+        int result;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create_inline(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = BUFFER_append_build(g_hBuffer, ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, TOTAL_ALLOCATION_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_99_016: [ The functions that change the content of a BUFFER made by BUFFER_create_inline shall keep the content in the allocation of the BUFFER while it fits and move it to memory of its own when it does not. ]*/
+    TEST_FUNCTION(BUFFER_append_build_to_an_inline_BUFFER_that_does_not_fit_moves_the_content)
+    {
+        ///arrange
+        int result;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create_inline(TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(TOTAL_ALLOCATION_SIZE + BUFFER_TEST1_SIZE));
+
+        ///act
+        result = BUFFER_append_build(g_hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, TOTAL_ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer) + TOTAL_ALLOCATION_SIZE, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_07_003: [BUFFER_delete shall delete the data associated with the BUFFER_HANDLE along with the Buffer.] */
+    TEST_FUNCTION(BUFFER_delete_of_an_inline_BUFFER_frees_a_single_block)
+    {
+        ///arrange
+        BUFFER_HANDLE g_hBuffer = BUFFER_create_inline(BUFFER_Test1, BUFFER_TEST1_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(g_hBuffer));
+
+        ///act
+        BUFFER_delete(g_hBuffer);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BUFFER_99_017: [ Content kept in the allocation of a BUFFER made by BUFFER_create_inline shall be copied to memory obtained with malloc as well. ]*/
+    TEST_FUNCTION(BUFFER_detach_copies_the_content_of_an_inline_BUFFER)
+    {
+        ///arrange
+        unsigned char* content;
+        size_t size;
+        int result;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create_inline(BUFFER_Test1, BUFFER_TEST1_SIZE);
+        unsigned char* inline_content = BUFFER_u_char(g_hBuffer);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(BUFFER_TEST1_SIZE));
+
+        ///act
+        result = BUFFER_detach(g_hBuffer, &content, &size);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_NOT_EQUAL(void_ptr, inline_content, content);
+        ASSERT_ARE_EQUAL(size_t, BUFFER_TEST1_SIZE, size);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        my_gballoc_free(content);
+        BUFFER_delete(g_hBuffer);
+    }
+
     /* BUFFER_fill */
 
     /* Tests_SRS_BUFFER_07_001: [ BUFFER_fill shall fill the supplied BUFFER_HANDLE with the supplied fill character. ] */
@@ -1635,4 +1781,148 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         BUFFER_delete(buffer);
     }
 
+    /* BUFFER_detach */
+
+    /* Tests_SRS_BUFFER_99_007: [ If handle, content or size is NULL, BUFFER_detach shall return a nonzero value. ]*/
+    TEST_FUNCTION(BUFFER_detach_with_NULL_handle_fails)
+    {
+        ///arrange
+        unsigned char* content;
+        size_t size;
+
+        ///act
+        int result = BUFFER_detach(NULL, &content, &size);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BUFFER_99_007: [ If handle, content or size is NULL, BUFFER_detach shall return a nonzero value. ]*/
+    TEST_FUNCTION(BUFFER_detach_with_NULL_content_fails)
+    {
+        ///arrange
+        size_t size;
+        int result;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_Test1, BUFFER_TEST1_SIZE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = BUFFER_detach(g_hBuffer, NULL, &size);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, BUFFER_TEST1_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_99_007: [ If handle, content or size is NULL, BUFFER_detach shall return a nonzero value. ]*/
+    TEST_FUNCTION(BUFFER_detach_with_NULL_size_fails)
+    {
+        ///arrange
+        unsigned char* content;
+        int result;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_Test1, BUFFER_TEST1_SIZE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = BUFFER_detach(g_hBuffer, &content, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, BUFFER_TEST1_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_99_008: [ BUFFER_detach shall hand the memory of the BUFFER over to the caller, who frees it with free, without copying it, and set *size to the size of the BUFFER. ]*/
+    /* Tests_SRS_BUFFER_99_011: [ On success BUFFER_detach shall leave the BUFFER empty and return zero. ]*/
+    TEST_FUNCTION(BUFFER_detach_hands_over_the_memory_without_copying_it)
+    {
+        ///arrange
+        unsigned char* content;
+        size_t size;
+        int result;
+        unsigned char* expected_content;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_Test1, BUFFER_TEST1_SIZE);
+        expected_content = BUFFER_u_char(g_hBuffer);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = BUFFER_detach(g_hBuffer, &content, &size);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(void_ptr, expected_content, content);
+        ASSERT_ARE_EQUAL(size_t, BUFFER_TEST1_SIZE, size);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(g_hBuffer));
+        ASSERT_IS_NULL(BUFFER_u_char(g_hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        my_gballoc_free(content);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_99_011: [ On success BUFFER_detach shall leave the BUFFER empty and return zero. ]*/
+    TEST_FUNCTION(BUFFER_detach_leaves_a_BUFFER_that_can_be_built_again)
+    {
+        ///arrange
+        unsigned char* content;
+        size_t size;
+        int result;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_Test1, BUFFER_TEST1_SIZE);
+        (void)BUFFER_detach(g_hBuffer, &content, &size);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(NULL, BUFFER_TEST2_SIZE));
+
+        ///act
+        result = BUFFER_build(g_hBuffer, BUFFER_Test2, BUFFER_TEST2_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, BUFFER_TEST2_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_Test2, BUFFER_TEST2_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        my_gballoc_free(content);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_99_010: [ If the BUFFER is empty, BUFFER_detach shall set *content to NULL and *size to 0 and release whatever memory the BUFFER holds. ]*/
+    TEST_FUNCTION(BUFFER_detach_of_an_empty_BUFFER_frees_its_memory)
+    {
+        ///arrange
+        unsigned char* content = (unsigned char*)0x1;
+        size_t size = 1;
+        int result;
+        char c = '3';
+        BUFFER_HANDLE g_hBuffer = BUFFER_create((const unsigned char*)&c, 0);
+        umock_c_reset_all_calls();
+
+        /*BUFFER_create took 1 byte for the empty content*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        result = BUFFER_detach(g_hBuffer, &content, &size);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_IS_NULL(content);
+        ASSERT_ARE_EQUAL(size_t, 0, size);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
 END_TEST_SUITE(Buffer_UnitTests)
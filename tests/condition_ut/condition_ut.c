@@ -399,6 +399,8 @@ END_TEST_SUITE(Condition_UnitTests);
 #define gballoc_realloc real_gballoc_realloc
 #define gballoc_calloc real_gballoc_calloc
 #define gballoc_free real_gballoc_free
+/*the allocator functions declared by gballoc_allocator.h are defined by gballoc.c, they must not be mocked*/
+#undef ENABLE_MOCKS
 #include "gballoc.c"
 #undef Lock
 #undef Unlock
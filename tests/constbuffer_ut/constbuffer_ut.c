@@ -47,6 +47,8 @@ void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/gballoc.h"
 
+MOCKABLE_FUNCTION(, void, test_free_func, void*, context);
+
 #undef ENABLE_MOCKS
 #include "azure_c_shared_utility/constbuffer.h"
 
@@ -69,6 +71,12 @@ static const char* buffer3 = "three";
 #define BUFFER3_u_char ((unsigned char*)buffer3)
 #define BUFFER3_length ((size_t)0)
 
+#define TEST_CUSTOM_FREE_CONTEXT ((void*)0x4242)
+
+/*what BUFFER_detach hands over for BUFFER1_HANDLE*/
+static unsigned char* detached_content;
+static int detach_result;
+
 unsigned char* my_BUFFER_u_char(BUFFER_HANDLE handle)
 {
     unsigned char* result;
@@ -99,6 +107,20 @@ size_t my_BUFFER_length(BUFFER_HANDLE handle)
     return result;
 }
 
+int my_BUFFER_detach(BUFFER_HANDLE handle, unsigned char** content, size_t* size)
+{
+    if (handle != BUFFER1_HANDLE)
+    {
+        ASSERT_FAIL("who am I?");
+    }
+    if (detach_result == 0)
+    {
+        *content = detached_content;
+        *size = BUFFER1_length;
+    }
+    return detach_result;
+}
+
 DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
@@ -124,6 +146,7 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
         REGISTER_GLOBAL_MOCK_HOOK(BUFFER_u_char, my_BUFFER_u_char);
         REGISTER_GLOBAL_MOCK_HOOK(BUFFER_length, my_BUFFER_length);
+        REGISTER_GLOBAL_MOCK_HOOK(BUFFER_detach, my_BUFFER_detach);
     }
 
     TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -145,6 +168,8 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
 
         currentmalloc_call = 0;
         whenShallmalloc_fail = 0;
+        detached_content = NULL;
+        detach_result = 0;
 
     }
 
@@ -608,4 +633,485 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         ///cleanup
     }
 
+    /*Tests_SRS_CONSTBUFFER_99_016: [If buffer is NULL then CONSTBUFFER_CreateFromBufferWithMove shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferWithMove_with_NULL_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+
+        ///act
+        handle = CONSTBUFFER_CreateFromBufferWithMove(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_017: [Otherwise CONSTBUFFER_CreateFromBufferWithMove shall take the content of buffer by calling BUFFER_detach and return a non-NULL handle whose content is that memory.]*/
+    /*Tests_SRS_CONSTBUFFER_99_019: [The non-NULL handle returned by CONSTBUFFER_CreateFromBufferWithMove shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferWithMove_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+        detached_content = (unsigned char*)my_gballoc_malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(detached_content);
+        (void)memcpy(detached_content, BUFFER1_u_char, BUFFER1_length);
+
+        /*this is the handle, the content is not copied*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(BUFFER_detach(BUFFER1_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument(2)
+            .IgnoreArgument(3);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromBufferWithMove(BUFFER1_HANDLE);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(void_ptr, detached_content, content->buffer);
+        ASSERT_ARE_EQUAL(size_t, BUFFER1_length, content->size);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_018: [If allocating the handle or BUFFER_detach fails, CONSTBUFFER_CreateFromBufferWithMove shall return NULL and leave buffer unchanged.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferWithMove_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        whenShallmalloc_fail = 1;
+
+        /*the buffer is not touched*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromBufferWithMove(BUFFER1_HANDLE);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_018: [If allocating the handle or BUFFER_detach fails, CONSTBUFFER_CreateFromBufferWithMove shall return NULL and leave buffer unchanged.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferWithMove_fails_when_BUFFER_detach_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        detach_result = 1;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(BUFFER_detach(BUFFER1_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument(2)
+            .IgnoreArgument(3);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromBufferWithMove(BUFFER1_HANDLE);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_02_017: [If the refcount reaches zero, then CONSTBUFFER_Destroy shall deallocate all resources used by the CONSTBUFFER_HANDLE.]*/
+    TEST_FUNCTION(CONSTBUFFER_Destroy_frees_the_memory_taken_from_the_buffer)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        detached_content = (unsigned char*)my_gballoc_malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(detached_content);
+        handle = CONSTBUFFER_CreateFromBufferWithMove(BUFFER1_HANDLE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(detached_content));
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+
+        ///act
+        CONSTBUFFER_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_001: [If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithMoveMemory shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_with_NULL_source_and_size_different_than_0_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+
+        ///act
+        handle = CONSTBUFFER_CreateWithMoveMemory(NULL, 1);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_002: [Otherwise CONSTBUFFER_CreateWithMoveMemory shall return a non-NULL handle whose content is the memory pointed to by source, without copying it, and take ownership of source.]*/
+    /*Tests_SRS_CONSTBUFFER_99_004: [The non-NULL handle returned by CONSTBUFFER_CreateWithMoveMemory shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+        unsigned char* source = (unsigned char*)my_gballoc_malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        (void)memcpy(source, BUFFER1_u_char, BUFFER1_length);
+
+        /*this is the handle, the content is not copied*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithMoveMemory(source, BUFFER1_length);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(void_ptr, source, content->buffer);
+        ASSERT_ARE_EQUAL(size_t, BUFFER1_length, content->size);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_003: [If allocating the handle fails, CONSTBUFFER_CreateWithMoveMemory shall return NULL and leave source to the caller.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        unsigned char* source = (unsigned char*)my_gballoc_malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        currentmalloc_call = 0;
+        whenShallmalloc_fail = 1;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithMoveMemory(source, BUFFER1_length);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        my_gballoc_free(source);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_02_017: [If the refcount reaches zero, then CONSTBUFFER_Destroy shall deallocate all resources used by the CONSTBUFFER_HANDLE.]*/
+    TEST_FUNCTION(CONSTBUFFER_Destroy_frees_the_moved_memory)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        unsigned char* source = (unsigned char*)my_gballoc_malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        handle = CONSTBUFFER_CreateWithMoveMemory(source, BUFFER1_length);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(source));
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+
+        ///act
+        CONSTBUFFER_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_005: [If source is NULL and size is different than 0, or customFreeFunc is NULL, then CONSTBUFFER_CreateWithCustomFree shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_with_NULL_source_and_size_different_than_0_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+
+        ///act
+        handle = CONSTBUFFER_CreateWithCustomFree(NULL, 1, test_free_func, TEST_CUSTOM_FREE_CONTEXT);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_005: [If source is NULL and size is different than 0, or customFreeFunc is NULL, then CONSTBUFFER_CreateWithCustomFree shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_with_NULL_customFreeFunc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+
+        ///act
+        handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, NULL, TEST_CUSTOM_FREE_CONTEXT);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_006: [Otherwise CONSTBUFFER_CreateWithCustomFree shall return a non-NULL handle whose content is the memory pointed to by source, without copying it, and remember customFreeFunc and customFreeFuncContext.]*/
+    /*Tests_SRS_CONSTBUFFER_99_008: [The non-NULL handle returned by CONSTBUFFER_CreateWithCustomFree shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+
+        /*this is the handle, the content is not copied*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, test_free_func, TEST_CUSTOM_FREE_CONTEXT);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(void_ptr, BUFFER1_u_char, content->buffer);
+        ASSERT_ARE_EQUAL(size_t, BUFFER1_length, content->size);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_007: [If allocating the handle fails, CONSTBUFFER_CreateWithCustomFree shall return NULL and not call customFreeFunc.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        whenShallmalloc_fail = 1;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, test_free_func, TEST_CUSTOM_FREE_CONTEXT);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_014: [If the constbuffer was created with CONSTBUFFER_CreateWithCustomFree, CONSTBUFFER_Destroy shall call customFreeFunc with customFreeFuncContext instead of freeing the content.]*/
+    TEST_FUNCTION(CONSTBUFFER_Destroy_calls_the_custom_free_function)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, test_free_func, TEST_CUSTOM_FREE_CONTEXT);
+        CONSTBUFFER_HANDLE clone = CONSTBUFFER_Clone(handle);
+        CONSTBUFFER_Destroy(clone); /*only a dec_Ref is expected here, so no effects*/
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(test_free_func(TEST_CUSTOM_FREE_CONTEXT));
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+
+        ///act
+        CONSTBUFFER_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_009: [If handle is NULL, or offset + size is larger than the size of handle, then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_NULL_handle_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE result;
+
+        ///act
+        result = CONSTBUFFER_CreateFromOffsetAndSize(NULL, 0, 0);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_009: [If handle is NULL, or offset + size is larger than the size of handle, then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_offset_larger_than_the_size_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE result;
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = CONSTBUFFER_CreateFromOffsetAndSize(handle, BUFFER1_length + 1, 0);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_009: [If handle is NULL, or offset + size is larger than the size of handle, then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_a_range_past_the_end_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE result1;
+        CONSTBUFFER_HANDLE result2;
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        umock_c_reset_all_calls();
+
+        ///act
+        result1 = CONSTBUFFER_CreateFromOffsetAndSize(handle, 1, BUFFER1_length);
+        result2 = CONSTBUFFER_CreateFromOffsetAndSize(handle, 1, (size_t)-1);
+
+        ///assert
+        ASSERT_IS_NULL(result1);
+        ASSERT_IS_NULL(result2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_010: [If offset is 0 and size is the size of handle, CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle and return handle.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_for_the_whole_content_returns_handle)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE result;
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = CONSTBUFFER_CreateFromOffsetAndSize(handle, 0, BUFFER1_length);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, handle, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(result);
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_011: [Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall return a non-NULL handle whose content is the size bytes at offset of the content of handle, without copying them, and hold a reference to the constbuffer that owns that memory until it is destroyed.]*/
+    /*Tests_SRS_CONSTBUFFER_99_013: [The non-NULL handle returned by CONSTBUFFER_CreateFromOffsetAndSize shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE result;
+        const CONSTBUFFER* original;
+        const CONSTBUFFER* content;
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        original = CONSTBUFFER_GetContent(handle);
+        umock_c_reset_all_calls();
+
+        /*this is the handle, the content is not copied*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        result = CONSTBUFFER_CreateFromOffsetAndSize(handle, 3, 6);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_NOT_EQUAL(void_ptr, handle, result);
+        content = CONSTBUFFER_GetContent(result);
+        ASSERT_ARE_EQUAL(void_ptr, original->buffer + 3, content->buffer);
+        ASSERT_ARE_EQUAL(size_t, 6, content->size);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(result);
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_012: [If allocating the handle fails, CONSTBUFFER_CreateFromOffsetAndSize shall return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE result;
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        umock_c_reset_all_calls();
+        currentmalloc_call = 0;
+        whenShallmalloc_fail = 1;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        result = CONSTBUFFER_CreateFromOffsetAndSize(handle, 3, 6);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        /*the reference of handle is untouched, this frees it*/
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+        CONSTBUFFER_Destroy(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_011: [Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall return a non-NULL handle whose content is the size bytes at offset of the content of handle, without copying them, and hold a reference to the constbuffer that owns that memory until it is destroyed.]*/
+    /*Tests_SRS_CONSTBUFFER_99_015: [If the constbuffer was created with CONSTBUFFER_CreateFromOffsetAndSize, CONSTBUFFER_Destroy shall release its reference to the constbuffer that owns the content instead of freeing the content.]*/
+    TEST_FUNCTION(CONSTBUFFER_Destroy_of_the_last_range_frees_the_original)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE range;
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        range = CONSTBUFFER_CreateFromOffsetAndSize(handle, 3, 6);
+        CONSTBUFFER_Destroy(handle); /*the range still holds a reference, so no effects*/
+        umock_c_reset_all_calls();
+
+        /*this is the content of the original*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+        STRICT_EXPECTED_CALL(gballoc_free(range));
+
+        ///act
+        CONSTBUFFER_Destroy(range);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_99_011: [Otherwise CONSTBUFFER_CreateFromOffsetAndSize shall return a non-NULL handle whose content is the size bytes at offset of the content of handle, without copying them, and hold a reference to the constbuffer that owns that memory until it is destroyed.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_of_a_range_refers_to_the_original)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE range;
+        CONSTBUFFER_HANDLE subrange;
+        const CONSTBUFFER* content;
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        range = CONSTBUFFER_CreateFromOffsetAndSize(handle, 3, 6);
+
+        ///act
+        subrange = CONSTBUFFER_CreateFromOffsetAndSize(range, 1, 2);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(subrange);
+        content = CONSTBUFFER_GetContent(subrange);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER1_u_char + 4, content->buffer, 2));
+        ASSERT_ARE_EQUAL(size_t, 2, content->size);
+
+        /*the range and the original go away, the subrange keeps the original alive*/
+        CONSTBUFFER_Destroy(range);
+        CONSTBUFFER_Destroy(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+        STRICT_EXPECTED_CALL(gballoc_free(subrange));
+
+        CONSTBUFFER_Destroy(subrange);
+
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
 END_TEST_SUITE(constbuffer_unittests)
@@ -0,0 +1,693 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/gballoc_pool.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+/* more blocks of the 16 bytes class than one 16 KB slab holds */
+#define MORE_THAN_A_SLAB_COUNT 600
+/* each short lived thread fills its cache of the 32 bytes class, enough threads to need many slabs if the caches were stranded */
+#define SHORT_LIVED_THREAD_COUNT 200
+#define SHORT_LIVED_THREAD_BLOCK_COUNT 40
+
+static GBALLOC_POOL_CLASS_STATISTICS get_class_statistics(size_t class_index)
+{
+    GBALLOC_POOL_STATISTICS statistics;
+    ASSERT_ARE_EQUAL(int, 0, gballoc_pool_get_statistics(&statistics));
+    return statistics.classes[class_index];
+}
+
+static int allocate_and_free_32_byte_blocks(void* arg)
+{
+    void* blocks[SHORT_LIVED_THREAD_BLOCK_COUNT];
+    size_t i;
+    int result = 0;
+    (void)arg;
+
+    for (i = 0; i < SHORT_LIVED_THREAD_BLOCK_COUNT; i++)
+    {
+        blocks[i] = gballoc_pool_malloc(32);
+        if (blocks[i] == NULL)
+        {
+            result = 1;
+        }
+    }
+    for (i = 0; i < SHORT_LIVED_THREAD_BLOCK_COUNT; i++)
+    {
+        gballoc_pool_free(blocks[i]);
+    }
+
+    return result;
+}
+
+BEGIN_TEST_SUITE(gballoc_pool_unittests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* gballoc_pool_init */
+
+/* Tests_SRS_GBALLOC_POOL_99_001: [ gballoc_pool_init shall create the lock protecting the shared free lists, reset the statistics and return 0. ]*/
+TEST_FUNCTION(gballoc_pool_init_succeeds_and_starts_with_empty_classes)
+{
+    // arrange
+    GBALLOC_POOL_STATISTICS statistics;
+    size_t i;
+
+    // act
+    int result = gballoc_pool_init();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, gballoc_pool_get_statistics(&statistics));
+    for (i = 0; i < GBALLOC_POOL_CLASS_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(size_t, 0, statistics.classes[i].slab_count);
+        ASSERT_ARE_EQUAL(size_t, 0, statistics.classes[i].block_count);
+        ASSERT_ARE_EQUAL(size_t, 0, statistics.classes[i].allocation_count);
+    }
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.large_allocation_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_002: [ If the pool is already initialized, gballoc_pool_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(gballoc_pool_init_after_init_fails)
+{
+    // arrange
+    (void)gballoc_pool_init();
+
+    // act
+    int result = gballoc_pool_init();
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* gballoc_pool_deinit */
+
+/* Tests_SRS_GBALLOC_POOL_99_004: [ gballoc_pool_deinit shall give the blocks held by every thread cache back to the shared free lists and free the caches. ]*/
+/* Tests_SRS_GBALLOC_POOL_99_005: [ gballoc_pool_deinit shall free the slabs of every class whose blocks have all been given back. ]*/
+/* Tests_SRS_GBALLOC_POOL_99_007: [ gballoc_pool_deinit shall free the lock created by gballoc_pool_init, unless slabs were kept. ]*/
+TEST_FUNCTION(gballoc_pool_deinit_frees_the_slabs_and_allows_a_new_init)
+{
+    // arrange
+    void* block;
+    (void)gballoc_pool_init();
+    block = gballoc_pool_malloc(10);
+    gballoc_pool_free(block);
+
+    // act
+    gballoc_pool_deinit();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, gballoc_pool_init());
+    ASSERT_ARE_EQUAL(size_t, 0, get_class_statistics(0).slab_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_006: [ The slabs of a class that still has blocks in use shall be kept, so that those blocks stay valid. ]*/
+/* Tests_SRS_GBALLOC_POOL_99_025: [ If gballoc_pool_deinit kept the lock for the slabs still in use, gballoc_pool_init shall use that lock. ]*/
+/* Tests_SRS_GBALLOC_POOL_99_026: [ The slabs kept by gballoc_pool_deinit shall stay in their classes, so that their free blocks are reused. ]*/
+TEST_FUNCTION(gballoc_pool_init_after_deinit_reuses_the_slabs_of_blocks_still_in_use)
+{
+    // arrange
+    GBALLOC_POOL_CLASS_STATISTICS class_statistics;
+    unsigned char* block;
+    void* other_block;
+    (void)gballoc_pool_init();
+    block = (unsigned char*)gballoc_pool_malloc(40);
+    block[39] = 0x5A;
+
+    // act
+    gballoc_pool_deinit();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0x5A, (int)block[39]);
+    ASSERT_ARE_EQUAL(int, 0, gballoc_pool_init());
+    class_statistics = get_class_statistics(2);
+    ASSERT_ARE_EQUAL(size_t, 1, class_statistics.slab_count);
+    ASSERT_ARE_EQUAL(size_t, 1, class_statistics.used_block_count);
+    ASSERT_ARE_EQUAL(size_t, 40, class_statistics.requested_bytes);
+    ASSERT_ARE_EQUAL(size_t, 0, class_statistics.allocation_count);
+    other_block = gballoc_pool_malloc(40);
+    ASSERT_ARE_EQUAL(size_t, 1, get_class_statistics(2).slab_count);
+    gballoc_pool_free(other_block);
+    gballoc_pool_free(block);
+    ASSERT_ARE_EQUAL(size_t, 0, get_class_statistics(2).used_block_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_021: [ A pooled block freed after gballoc_pool_deinit shall go back to the shared free list of its class, and the slabs of the class shall be freed once all its blocks are back. ]*/
+TEST_FUNCTION(gballoc_pool_free_after_deinit_frees_the_kept_slabs_once_all_their_blocks_are_back)
+{
+    // arrange
+    void* block1;
+    void* block2;
+    (void)gballoc_pool_init();
+    block1 = gballoc_pool_malloc(40);
+    block2 = gballoc_pool_malloc(40);
+    gballoc_pool_deinit();
+
+    // act
+    gballoc_pool_free(block1);
+    gballoc_pool_free(block2);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, gballoc_pool_init());
+    ASSERT_ARE_EQUAL(size_t, 0, get_class_statistics(2).slab_count);
+    ASSERT_ARE_EQUAL(size_t, 0, get_class_statistics(2).block_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+TEST_FUNCTION(gballoc_pool_deinit_without_init_does_nothing)
+{
+    // act
+    gballoc_pool_deinit();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, gballoc_pool_init());
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* gballoc_pool_malloc */
+
+/* Tests_SRS_GBALLOC_POOL_99_008: [ While the pool is initialized, gballoc_pool_malloc shall serve requests of up to 256 bytes from the smallest size class that fits them, taking the block from the thread cache when it has one. ]*/
+TEST_FUNCTION(gballoc_pool_malloc_serves_small_requests_from_the_smallest_class_that_fits)
+{
+    // arrange
+    static const size_t sizes[] = { 1, 16, 17, 33, 64, 65, 129, 193, 256 };
+    static const size_t expected_classes[] = { 0, 0, 1, 2, 3, 4, 6, 7, 7 };
+    void* blocks[sizeof(sizes) / sizeof(sizes[0])];
+    size_t i;
+    (void)gballoc_pool_init();
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        size_t allocation_count = get_class_statistics(expected_classes[i]).allocation_count;
+
+        // act
+        blocks[i] = gballoc_pool_malloc(sizes[i]);
+
+        // assert
+        ASSERT_IS_NOT_NULL(blocks[i]);
+        ASSERT_ARE_EQUAL(size_t, allocation_count + 1, get_class_statistics(expected_classes[i]).allocation_count);
+        (void)memset(blocks[i], 0x5A, sizes[i]);
+    }
+
+    // cleanup
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        gballoc_pool_free(blocks[i]);
+    }
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_024: [ gballoc_pool_get_statistics shall fill in, for every class, the slab and block counts, the blocks in use and free, the bytes requested by the blocks in use and the bytes lost to rounding, and return 0. ]*/
+TEST_FUNCTION(gballoc_pool_malloc_counts_the_requested_and_the_wasted_bytes)
+{
+    // arrange
+    GBALLOC_POOL_CLASS_STATISTICS class_statistics;
+    void* block1;
+    void* block2;
+    (void)gballoc_pool_init();
+
+    // act
+    block1 = gballoc_pool_malloc(40);
+    block2 = gballoc_pool_malloc(48);
+
+    // assert
+    class_statistics = get_class_statistics(2);
+    ASSERT_ARE_EQUAL(size_t, 48, class_statistics.block_size);
+    ASSERT_ARE_EQUAL(size_t, 1, class_statistics.slab_count);
+    ASSERT_ARE_EQUAL(size_t, 2, class_statistics.used_block_count);
+    ASSERT_ARE_EQUAL(size_t, class_statistics.block_count - 2, class_statistics.free_block_count);
+    ASSERT_ARE_EQUAL(size_t, 88, class_statistics.requested_bytes);
+    ASSERT_ARE_EQUAL(size_t, 8, class_statistics.wasted_bytes);
+    ASSERT_ARE_EQUAL(size_t, 2, class_statistics.allocation_count);
+
+    // cleanup
+    gballoc_pool_free(block1);
+    gballoc_pool_free(block2);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_020: [ gballoc_pool_free shall put a pooled block in the thread cache, moving half of the cache to the shared free list when the cache is full. ]*/
+TEST_FUNCTION(gballoc_pool_free_makes_the_block_available_again)
+{
+    // arrange
+    GBALLOC_POOL_CLASS_STATISTICS class_statistics;
+    void* block;
+    (void)gballoc_pool_init();
+    block = gballoc_pool_malloc(40);
+
+    // act
+    gballoc_pool_free(block);
+
+    // assert
+    class_statistics = get_class_statistics(2);
+    ASSERT_ARE_EQUAL(size_t, 0, class_statistics.used_block_count);
+    ASSERT_ARE_EQUAL(size_t, class_statistics.block_count, class_statistics.free_block_count);
+    ASSERT_ARE_EQUAL(size_t, 0, class_statistics.requested_bytes);
+    ASSERT_ARE_EQUAL(size_t, 0, class_statistics.wasted_bytes);
+    ASSERT_IS_TRUE(gballoc_pool_malloc(40) == block);
+
+    // cleanup
+    gballoc_pool_free(block);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_009: [ When the class has no free block left, a new slab shall be allocated and carved into blocks of the class. ]*/
+/* Tests_SRS_GBALLOC_POOL_99_020: [ gballoc_pool_free shall put a pooled block in the thread cache, moving half of the cache to the shared free list when the cache is full. ]*/
+TEST_FUNCTION(gballoc_pool_malloc_adds_a_slab_when_the_class_is_exhausted)
+{
+    // arrange
+    void* blocks[MORE_THAN_A_SLAB_COUNT];
+    GBALLOC_POOL_CLASS_STATISTICS class_statistics;
+    size_t i;
+    (void)gballoc_pool_init();
+
+    // act
+    for (i = 0; i < MORE_THAN_A_SLAB_COUNT; i++)
+    {
+        blocks[i] = gballoc_pool_malloc(16);
+        ASSERT_IS_NOT_NULL(blocks[i]);
+        (void)memset(blocks[i], (int)i, 16);
+    }
+
+    // assert
+    class_statistics = get_class_statistics(0);
+    ASSERT_ARE_EQUAL(size_t, 2, class_statistics.slab_count);
+    ASSERT_ARE_EQUAL(size_t, MORE_THAN_A_SLAB_COUNT, class_statistics.used_block_count);
+    for (i = 0; i < MORE_THAN_A_SLAB_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)(unsigned char)i, (int)((unsigned char*)blocks[i])[15]);
+    }
+
+    for (i = 0; i < MORE_THAN_A_SLAB_COUNT; i++)
+    {
+        gballoc_pool_free(blocks[i]);
+    }
+    class_statistics = get_class_statistics(0);
+    ASSERT_ARE_EQUAL(size_t, 0, class_statistics.used_block_count);
+    ASSERT_ARE_EQUAL(size_t, MORE_THAN_A_SLAB_COUNT, class_statistics.allocation_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_029: [ When a thread exits, the blocks held by its cache shall go back to the shared free lists and the cache shall be freed. ]*/
+TEST_FUNCTION(blocks_cached_by_exited_threads_are_reused_by_the_next_threads)
+{
+    // arrange
+    GBALLOC_POOL_CLASS_STATISTICS class_statistics;
+    size_t i;
+    (void)gballoc_pool_init();
+
+    // act
+    for (i = 0; i < SHORT_LIVED_THREAD_COUNT; i++)
+    {
+        THREAD_HANDLE thread;
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&thread, allocate_and_free_32_byte_blocks, NULL));
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(thread, &thread_result));
+        ASSERT_ARE_EQUAL(int, 0, thread_result);
+    }
+
+    // assert
+    class_statistics = get_class_statistics(1);
+    ASSERT_ARE_EQUAL(size_t, 1, class_statistics.slab_count);
+    ASSERT_ARE_EQUAL(size_t, 0, class_statistics.used_block_count);
+    ASSERT_ARE_EQUAL(size_t, class_statistics.block_count, class_statistics.free_block_count);
+    ASSERT_ARE_EQUAL(size_t, SHORT_LIVED_THREAD_COUNT * SHORT_LIVED_THREAD_BLOCK_COUNT, class_statistics.allocation_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_010: [ Larger requests, and every request while the pool is not initialized, shall be served by malloc with room for the block header. ]*/
+/* Tests_SRS_GBALLOC_POOL_99_019: [ gballoc_pool_free shall give a block that came from malloc back to free. ]*/
+TEST_FUNCTION(gballoc_pool_malloc_serves_large_requests_from_malloc)
+{
+    // arrange
+    GBALLOC_POOL_STATISTICS statistics;
+    void* block;
+    (void)gballoc_pool_init();
+
+    // act
+    block = gballoc_pool_malloc(257);
+
+    // assert
+    ASSERT_IS_NOT_NULL(block);
+    (void)memset(block, 0x5A, 257);
+    ASSERT_ARE_EQUAL(int, 0, gballoc_pool_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.large_allocation_count);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.classes[GBALLOC_POOL_CLASS_COUNT - 1].allocation_count);
+
+    // cleanup
+    gballoc_pool_free(block);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_010: [ Larger requests, and every request while the pool is not initialized, shall be served by malloc with room for the block header. ]*/
+TEST_FUNCTION(gballoc_pool_malloc_without_init_serves_small_requests_from_malloc)
+{
+    // arrange
+    void* block;
+
+    // act
+    block = gballoc_pool_malloc(16);
+
+    // assert
+    ASSERT_IS_NOT_NULL(block);
+    (void)memset(block, 0x5A, 16);
+
+    // cleanup
+    gballoc_pool_free(block);
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_011: [ If getting the memory fails, gballoc_pool_malloc shall return NULL. ]*/
+TEST_FUNCTION(gballoc_pool_malloc_with_a_size_that_overflows_the_header_fails)
+{
+    // act
+    void* result = gballoc_pool_malloc((size_t)~(size_t)0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* gballoc_pool_calloc */
+
+/* Tests_SRS_GBALLOC_POOL_99_012: [ gballoc_pool_calloc shall allocate nmemb * size bytes like gballoc_pool_malloc and zero them. ]*/
+TEST_FUNCTION(gballoc_pool_calloc_zeroes_a_reused_block)
+{
+    // arrange
+    unsigned char* block;
+    size_t i;
+    (void)gballoc_pool_init();
+    block = (unsigned char*)gballoc_pool_malloc(32);
+    (void)memset(block, 0x5A, 32);
+    gballoc_pool_free(block);
+
+    // act
+    block = (unsigned char*)gballoc_pool_calloc(4, 8);
+
+    // assert
+    ASSERT_IS_NOT_NULL(block);
+    for (i = 0; i < 32; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, (int)block[i]);
+    }
+
+    // cleanup
+    gballoc_pool_free(block);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_013: [ If nmemb * size overflows, gballoc_pool_calloc shall return NULL. ]*/
+TEST_FUNCTION(gballoc_pool_calloc_with_overflowing_size_fails)
+{
+    // arrange
+    (void)gballoc_pool_init();
+
+    // act
+    void* result = gballoc_pool_calloc(((size_t)~(size_t)0) / 2, 4);
+
+    // assert
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* gballoc_pool_realloc */
+
+/* Tests_SRS_GBALLOC_POOL_99_014: [ If ptr is NULL, gballoc_pool_realloc shall behave like gballoc_pool_malloc. ]*/
+TEST_FUNCTION(gballoc_pool_realloc_with_NULL_ptr_allocates)
+{
+    // arrange
+    void* block;
+    (void)gballoc_pool_init();
+
+    // act
+    block = gballoc_pool_realloc(NULL, 20);
+
+    // assert
+    ASSERT_IS_NOT_NULL(block);
+    ASSERT_ARE_EQUAL(size_t, 1, get_class_statistics(1).used_block_count);
+
+    // cleanup
+    gballoc_pool_free(block);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_016: [ When the new size is served by the class of the block, gballoc_pool_realloc shall return ptr. ]*/
+TEST_FUNCTION(gballoc_pool_realloc_within_the_class_keeps_the_block)
+{
+    // arrange
+    void* block;
+    void* result;
+    (void)gballoc_pool_init();
+    block = gballoc_pool_malloc(20);
+
+    // act
+    result = gballoc_pool_realloc(block, 30);
+
+    // assert
+    ASSERT_IS_TRUE(result == block);
+    ASSERT_ARE_EQUAL(size_t, 30, get_class_statistics(1).requested_bytes);
+
+    // cleanup
+    gballoc_pool_free(result);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_017: [ Otherwise gballoc_pool_realloc shall allocate a new block, copy the contents that fit and free ptr. ]*/
+TEST_FUNCTION(gballoc_pool_realloc_to_another_class_moves_the_contents)
+{
+    // arrange
+    unsigned char* block;
+    unsigned char* result;
+    size_t i;
+    (void)gballoc_pool_init();
+    block = (unsigned char*)gballoc_pool_malloc(20);
+    for (i = 0; i < 20; i++)
+    {
+        block[i] = (unsigned char)i;
+    }
+
+    // act
+    result = (unsigned char*)gballoc_pool_realloc(block, 100);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < 20; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)i, (int)result[i]);
+    }
+    ASSERT_ARE_EQUAL(size_t, 0, get_class_statistics(1).used_block_count);
+    ASSERT_ARE_EQUAL(size_t, 1, get_class_statistics(5).used_block_count);
+
+    // cleanup
+    gballoc_pool_free(result);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_015: [ A block that came from malloc shall be resized with realloc. ]*/
+/* Tests_SRS_GBALLOC_POOL_99_017: [ Otherwise gballoc_pool_realloc shall allocate a new block, copy the contents that fit and free ptr. ]*/
+TEST_FUNCTION(gballoc_pool_realloc_of_a_large_block_keeps_the_contents)
+{
+    // arrange
+    unsigned char* block;
+    unsigned char* result;
+    size_t i;
+    (void)gballoc_pool_init();
+    block = (unsigned char*)gballoc_pool_malloc(300);
+    for (i = 0; i < 300; i++)
+    {
+        block[i] = (unsigned char)i;
+    }
+
+    // act
+    block = (unsigned char*)gballoc_pool_realloc(block, 1000);
+    result = (unsigned char*)gballoc_pool_realloc(block, 10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < 10; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)i, (int)result[i]);
+    }
+
+    // cleanup
+    gballoc_pool_free(result);
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_018: [ If the new memory cannot be obtained, gballoc_pool_realloc shall return NULL and leave ptr untouched. ]*/
+TEST_FUNCTION(gballoc_pool_realloc_failure_leaves_the_block_untouched)
+{
+    // arrange
+    unsigned char* block;
+    void* result;
+    (void)gballoc_pool_init();
+    block = (unsigned char*)gballoc_pool_malloc(20);
+    block[19] = 0x5A;
+
+    // act
+    result = gballoc_pool_realloc(block, (size_t)~(size_t)0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0x5A, (int)block[19]);
+    ASSERT_ARE_EQUAL(size_t, 1, get_class_statistics(1).used_block_count);
+
+    // cleanup
+    gballoc_pool_free(block);
+    gballoc_pool_deinit();
+}
+
+/* gballoc_pool_free */
+
+TEST_FUNCTION(gballoc_pool_free_with_NULL_does_nothing)
+{
+    // arrange
+    (void)gballoc_pool_init();
+
+    // act
+    gballoc_pool_free(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, get_class_statistics(0).block_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* gballoc_pool_get_statistics */
+
+/* Tests_SRS_GBALLOC_POOL_99_022: [ If statistics is NULL, gballoc_pool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(gballoc_pool_get_statistics_with_NULL_statistics_fails)
+{
+    // arrange
+    (void)gballoc_pool_init();
+
+    // act
+    int result = gballoc_pool_get_statistics(NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_023: [ If the pool is not initialized, gballoc_pool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(gballoc_pool_get_statistics_without_init_fails)
+{
+    // arrange
+    GBALLOC_POOL_STATISTICS statistics;
+
+    // act
+    int result = gballoc_pool_get_statistics(&statistics);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* gballoc_pool_getAllocator */
+
+/* Tests_SRS_GBALLOC_POOL_99_027: [ If allocator is NULL, gballoc_pool_getAllocator shall do nothing. ]*/
+TEST_FUNCTION(gballoc_pool_getAllocator_with_NULL_does_nothing)
+{
+    // act
+    gballoc_pool_getAllocator(NULL);
+}
+
+/* Tests_SRS_GBALLOC_POOL_99_028: [ gballoc_pool_getAllocator shall fill in allocator with functions that call gballoc_pool_malloc, gballoc_pool_calloc, gballoc_pool_realloc and gballoc_pool_free, without aligned functions and with a NULL context. ]*/
+TEST_FUNCTION(gballoc_pool_getAllocator_gives_an_allocator_that_serves_blocks_from_the_pools)
+{
+    // arrange
+    GBALLOC_ALLOCATOR allocator;
+    unsigned char* block;
+    size_t i;
+    (void)gballoc_pool_init();
+
+    // act
+    gballoc_pool_getAllocator(&allocator);
+
+    // assert
+    ASSERT_IS_NULL(allocator.aligned_malloc_function);
+    ASSERT_IS_NULL(allocator.aligned_free_function);
+    ASSERT_IS_NULL(allocator.context);
+    block = (unsigned char*)allocator.calloc_function(allocator.context, 2, 10);
+    ASSERT_IS_NOT_NULL(block);
+    for (i = 0; i < 20; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, (int)block[i]);
+    }
+    ASSERT_ARE_EQUAL(size_t, 1, get_class_statistics(1).used_block_count);
+    block = (unsigned char*)allocator.realloc_function(allocator.context, block, 100);
+    ASSERT_IS_NOT_NULL(block);
+    ASSERT_ARE_EQUAL(size_t, 1, get_class_statistics(5).used_block_count);
+    allocator.free_function(allocator.context, block);
+    block = (unsigned char*)allocator.malloc_function(allocator.context, 10);
+    ASSERT_ARE_EQUAL(size_t, 1, get_class_statistics(0).used_block_count);
+    allocator.free_function(allocator.context, block);
+    ASSERT_ARE_EQUAL(size_t, 0, get_class_statistics(0).used_block_count);
+
+    // cleanup
+    gballoc_pool_deinit();
+}
+
+END_TEST_SUITE(gballoc_pool_unittests)
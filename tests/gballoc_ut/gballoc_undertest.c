@@ -13,4 +13,14 @@ extern void* mock_realloc(void* ptr, size_t size);
 extern void mock_free(void* ptr);
 
 #undef _CRTDBG_MAP_ALLOC
+#undef GB_USE_POOL
 #include "../src/gballoc.c"
+
+/* the tests give gballoc tracking tables they free themselves, gballoc has to forget them before gballoc_deinit would keep them */
+void gballoc_undertest_forget_tracking_table(void)
+{
+    allocations = NULL;
+    allocationsCapacity = 0;
+    allocationsCount = 0;
+    allocationsKept = false;
+}
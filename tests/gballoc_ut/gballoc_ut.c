@@ -7,8 +7,17 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstdint>
 #else
 #include <stdlib.h>
+#include <stdint.h>
+#endif
+#ifdef __cplusplus
+#include <cstdio>
+#include <cstring>
+#else
+#include <stdio.h>
+#include <string.h>
 #endif
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/gballoc.h"
@@ -21,14 +30,23 @@
 
 static TEST_MUTEX_HANDLE g_testByTest;
 
+/* defined in gballoc_undertest.c */
+extern void gballoc_undertest_forget_tracking_table(void);
+
 TEST_DEFINE_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
 
 static void* TEST_ALLOC_PTR1 = (void*)0x4242;
 static void* TEST_ALLOC_PTR2 = (void*)0x4243;
 static void* TEST_REALLOC_PTR = (void*)0x4245;
+static void* TEST_ALLOCATOR_CONTEXT = (void*)0x4246;
 
 #define OVERHEAD_SIZE	4096
+
+/* the tracking table starts with 64 entries and is grown when it would become more than half full, so the 33rd block grows it */
+#define TRACKED_BLOCK_COUNT 33
+#define TEST_BLOCK_BASE ((uintptr_t)0x10000)
 static const LOCK_HANDLE TEST_LOCK_HANDLE = (LOCK_HANDLE)0x4244;
+#define TEST_DUMP_SIZE 1024
 
 #define ENABLE_MOCKS
 
@@ -45,6 +63,13 @@ extern "C" {
     MOCKABLE_FUNCTION(, void*, mock_realloc, void*, ptr, size_t, size);
     MOCKABLE_FUNCTION(, void, mock_free, void*, ptr);
 
+    MOCKABLE_FUNCTION(, void*, test_allocator_malloc, void*, context, size_t, size);
+    MOCKABLE_FUNCTION(, void*, test_allocator_calloc, void*, context, size_t, nmemb, size_t, size);
+    MOCKABLE_FUNCTION(, void*, test_allocator_realloc, void*, context, void*, ptr, size_t, size);
+    MOCKABLE_FUNCTION(, void, test_allocator_free, void*, context, void*, ptr);
+    MOCKABLE_FUNCTION(, void*, test_allocator_aligned_malloc, void*, context, size_t, alignment, size_t, size);
+    MOCKABLE_FUNCTION(, void, test_allocator_aligned_free, void*, context, void*, ptr);
+
     MOCKABLE_FUNCTION(, LOCK_HANDLE, Lock_Init);
     MOCKABLE_FUNCTION(, LOCK_RESULT, Lock_Deinit, LOCK_HANDLE, handle);
     MOCKABLE_FUNCTION(, LOCK_RESULT, Lock, LOCK_HANDLE, handle);
@@ -64,6 +89,46 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+/* reads back what a dump function wrote to a temporary file */
+static void read_dump(FILE* dump, char* text)
+{
+    size_t length;
+    rewind(dump);
+    length = fread(text, 1, TEST_DUMP_SIZE - 1, dump);
+    text[length] = '\0';
+    (void)fclose(dump);
+}
+
+/* an allocator made of the test_allocator_xxx mocks, calloc_function and the aligned functions are left out */
+static GBALLOC_ALLOCATOR make_test_allocator(void)
+{
+    GBALLOC_ALLOCATOR result;
+    result.malloc_function = test_allocator_malloc;
+    result.realloc_function = test_allocator_realloc;
+    result.free_function = test_allocator_free;
+    result.calloc_function = NULL;
+    result.aligned_malloc_function = NULL;
+    result.aligned_free_function = NULL;
+    result.context = TEST_ALLOCATOR_CONTEXT;
+    return result;
+}
+
+/* starts site profiling and allocates a 3 byte block accounted to a site, using overhead for the tracking and site tables */
+static void* malloc_profiled_block(void* tracking_table, void* site_table)
+{
+    void* result;
+    (void)gballoc_startSiteProfiling();
+    STRICT_EXPECTED_CALL(mock_malloc(3))
+        .SetReturn((void*)TEST_BLOCK_BASE);
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(tracking_table);
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(site_table);
+    result = gballoc_malloc(3);
+    umock_c_reset_all_calls();
+    return result;
+}
+
 BEGIN_TEST_SUITE(GBAlloc_UnitTests)
 
 TEST_SUITE_INITIALIZE(TestClassInitialize)
@@ -84,6 +149,10 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_RETURN(mock_malloc, TEST_ALLOC_PTR1);
     REGISTER_GLOBAL_MOCK_RETURN(mock_realloc, TEST_ALLOC_PTR1);
     REGISTER_GLOBAL_MOCK_RETURN(mock_calloc, TEST_ALLOC_PTR1);
+    REGISTER_GLOBAL_MOCK_RETURN(test_allocator_malloc, TEST_ALLOC_PTR2);
+    REGISTER_GLOBAL_MOCK_RETURN(test_allocator_calloc, TEST_ALLOC_PTR2);
+    REGISTER_GLOBAL_MOCK_RETURN(test_allocator_realloc, TEST_ALLOC_PTR2);
+    REGISTER_GLOBAL_MOCK_RETURN(test_allocator_aligned_malloc, TEST_ALLOC_PTR2);
 
     REGISTER_GLOBAL_MOCK_RETURN(Lock_Init, TEST_LOCK_HANDLE);
     REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
@@ -110,7 +179,9 @@ TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
 
 TEST_FUNCTION_CLEANUP(TestMethodCleanup)
 {
+    gballoc_undertest_forget_tracking_table();
     gballoc_deinit();
+    (void)gballoc_setAllocator(NULL);
 
     TEST_MUTEX_RELEASE(g_testByTest);
 }
@@ -125,6 +196,7 @@ TEST_FUNCTION(gballoc_init_resets_memory_used)
     gballoc_init();
     allocation = malloc(OVERHEAD_SIZE);
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     gballoc_free(gballoc_malloc(1));
@@ -208,6 +280,65 @@ TEST_FUNCTION(gballoc_deinit_frees_the_lock_when_the_module_was_initialized)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* Tests_SRS_GBALLOC_99_003: [gballoc_deinit shall free the table used for tracking allocations when it tracks no block.] */
+TEST_FUNCTION(gballoc_deinit_frees_the_tracking_table)
+{
+    // arrange
+    void* allocation;
+    gballoc_init();
+    umock_c_reset_all_calls();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    STRICT_EXPECTED_CALL(mock_malloc(1));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    gballoc_free(gballoc_malloc(1));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_free(allocation));
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+
+    // act
+    gballoc_deinit();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_99_042: [The blocks still tracked shall stay in the table, so that gballoc_free and gballoc_realloc recognize them after the next gballoc_init, and shall no longer count towards the memory used.] */
+TEST_FUNCTION(gballoc_deinit_keeps_the_tracking_table_while_it_tracks_a_block)
+{
+    // arrange
+    void* allocation;
+    void* block;
+    gballoc_init();
+    umock_c_reset_all_calls();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    STRICT_EXPECTED_CALL(mock_malloc(1));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    block = gballoc_malloc(1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+
+    // act
+    gballoc_deinit();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    gballoc_init();
+    gballoc_free(block);
+    gballoc_deinit();
+    free(allocation);
+}
+
 /* Tests_SRS_GBALLOC_01_029: [if gballoc is not initialized gballoc_deinit shall do nothing.] */
 TEST_FUNCTION(gballoc_deinit_after_gballoc_deinit_doesnot_free_lock)
 {
@@ -223,6 +354,7 @@ TEST_FUNCTION(gballoc_deinit_after_gballoc_deinit_doesnot_free_lock)
 /* gballoc_malloc */
 
 /* Tests_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
+/* Tests_SRS_GBALLOC_99_040: [If the block cannot be tracked, gballoc_malloc and gballoc_calloc shall give it back to the underlying allocator.] */
 TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_malloc_fails)
 {
     // arrange
@@ -230,8 +362,10 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_malloc_fails)
     gballoc_init();
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
         .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
 
     // act
     result = gballoc_malloc(1);
@@ -244,6 +378,7 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_malloc_fails)
 /* Tests_SRS_GBALLOC_01_003: [gballoc_malloc shall call the C99 malloc function and return its result.] */
 /* Tests_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gballoc_malloc shall increment the total memory used with the amount indicated by size.] */
 /* Tests_SRS_GBALLOC_01_030: [gballoc_malloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+/* Tests_SRS_GBALLOC_99_039: [gballoc_malloc and gballoc_calloc shall call the underlying allocator before acquiring the lock, so that only the tracking of the block is serialized.] */
 TEST_FUNCTION(gballoc_malloc_with_0_Size_Calls_Underlying_malloc)
 {
     // arrange
@@ -253,12 +388,12 @@ TEST_FUNCTION(gballoc_malloc_with_0_Size_Calls_Underlying_malloc)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    /* This is the call to the underlying malloc with the size we want to allocate */
+    STRICT_EXPECTED_CALL(mock_malloc(0));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
-    STRICT_EXPECTED_CALL(mock_malloc(0));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -286,12 +421,12 @@ TEST_FUNCTION(gballoc_malloc_with_1_Size_Calls_Underlying_malloc_And_Increases_M
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    /* This is the call to the underlying malloc with the size we want to allocate */
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
-    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -312,20 +447,12 @@ TEST_FUNCTION(When_malloc_Fails_Then_gballoc_malloc_fails_too)
 {
     // arrange
     void* result;
-    void* allocation;
     gballoc_init();
     umock_c_reset_all_calls();
-    allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_malloc(1))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(mock_free(allocation));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_malloc(1);
@@ -334,12 +461,10 @@ TEST_FUNCTION(When_malloc_Fails_Then_gballoc_malloc_fails_too)
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(size_t, 0, gballoc_getMaximumMemoryUsed());
-
-    // cleanup
-    free(allocation);
 }
 
 /* Tests_SRS_GBALLOC_01_013: [When gballoc_malloc fails allocating memory for its internal use, gballoc_malloc shall return NULL.] */
+/* Tests_SRS_GBALLOC_99_040: [If the block cannot be tracked, gballoc_malloc and gballoc_calloc shall give it back to the underlying allocator.] */
 TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc_malloc_fails_too)
 {
     // arrange
@@ -347,11 +472,13 @@ TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc
     gballoc_init();
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
 
     // act
     result = gballoc_malloc(1);
@@ -380,6 +507,7 @@ TEST_FUNCTION(gballoc_malloc_after_deinit_calls_crt_malloc)
 /* gballoc_calloc */
 
 /* Tests_SRS_GBALLOC_01_046: [If acquiring the lock fails, gballoc_calloc shall return NULL.] */
+/* Tests_SRS_GBALLOC_99_040: [If the block cannot be tracked, gballoc_malloc and gballoc_calloc shall give it back to the underlying allocator.] */
 TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_calloc_fails)
 {
     // arrange
@@ -387,8 +515,10 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_calloc_fails)
     gballoc_init();
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(mock_calloc(1, 1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
-    .SetReturn(LOCK_ERROR);
+        .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
 
     // act
     result = gballoc_calloc(1,1);
@@ -401,6 +531,7 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_calloc_fails)
 /* Tests_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
 /* Tests_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
 /* Tests_SRS_GBALLOC_01_031: [gballoc_calloc shall ensure thread safety by using the lock created by gballoc_Init] */
+/* Tests_SRS_GBALLOC_99_039: [gballoc_malloc and gballoc_calloc shall call the underlying allocator before acquiring the lock, so that only the tracking of the block is serialized.] */
 TEST_FUNCTION(gballoc_calloc_with_0_Size_And_ItemCount_Calls_Underlying_calloc)
 {
     // arrange
@@ -410,12 +541,12 @@ TEST_FUNCTION(gballoc_calloc_with_0_Size_And_ItemCount_Calls_Underlying_calloc)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    /* This is the call to the underlying calloc with the size we want to allocate */
+    STRICT_EXPECTED_CALL(mock_calloc(0, 0));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
-    STRICT_EXPECTED_CALL(mock_calloc(0, 0));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -442,12 +573,12 @@ TEST_FUNCTION(gballoc_calloc_with_1_Item_Of_1_Size_Calls_Underlying_malloc_And_I
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    /* This is the call to the underlying calloc with the size we want to allocate */
+    STRICT_EXPECTED_CALL(mock_calloc(1, 1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
-    STRICT_EXPECTED_CALL(mock_calloc(1, 1));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -474,12 +605,12 @@ TEST_FUNCTION(gballoc_calloc_with_1_Item_Of_0_Size_Calls_Underlying_malloc_And_D
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    /* This is the call to the underlying calloc with the size we want to allocate */
+    STRICT_EXPECTED_CALL(mock_calloc(1, 0));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
-    STRICT_EXPECTED_CALL(mock_calloc(1, 0));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -506,12 +637,12 @@ TEST_FUNCTION(gballoc_calloc_with_0_Items_Of_1_Size_Calls_Underlying_malloc_And_
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    /* This is the call to the underlying calloc with the size we want to allocate */
+    STRICT_EXPECTED_CALL(mock_calloc(0, 1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
-    STRICT_EXPECTED_CALL(mock_calloc(0, 1));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -538,12 +669,12 @@ TEST_FUNCTION(gballoc_calloc_with_42_Items_Of_2_Size_Calls_Underlying_malloc_And
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    /* This is the call to the underlying calloc with the size we want to allocate */
+    STRICT_EXPECTED_CALL(mock_calloc(42, 2));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
-    STRICT_EXPECTED_CALL(mock_calloc(42, 2));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -564,20 +695,12 @@ TEST_FUNCTION(When_calloc_Fails_Then_gballoc_calloc_fails_too)
 {
     // arrange
     void* result;
-    void* allocation;
     gballoc_init();
     umock_c_reset_all_calls();
-    allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation);
-    /* This is the call to the underlying malloc with the size we want to allocate */
+    /* This is the call to the underlying calloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_calloc(1, 1))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(mock_free(allocation));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_calloc(1, 1);
@@ -586,12 +709,10 @@ TEST_FUNCTION(When_calloc_Fails_Then_gballoc_calloc_fails_too)
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(size_t, 0, gballoc_getMaximumMemoryUsed());
-
-    // cleanup
-    free(allocation);
 }
 
 /* Tests_SRS_GBALLOC_01_023: [When gballoc_calloc fails allocating memory for its internal use, gballoc_calloc shall return NULL.] */
+/* Tests_SRS_GBALLOC_99_040: [If the block cannot be tracked, gballoc_malloc and gballoc_calloc shall give it back to the underlying allocator.] */
 TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc_calloc_fails_too)
 {
     // arrange
@@ -599,11 +720,13 @@ TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc
     gballoc_init();
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(mock_calloc(1, 1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
 
     // act
     result = gballoc_calloc(1, 1);
@@ -679,7 +802,7 @@ TEST_FUNCTION(gballoc_realloc_with_NULL_Arg_And_0_Size_Calls_Underlying_realloc)
     allocation = malloc(OVERHEAD_SIZE);
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
@@ -711,7 +834,7 @@ TEST_FUNCTION(gballoc_realloc_with_NULL_Arg_And_1_Size_Calls_Underlying_realloc)
     allocation = malloc(OVERHEAD_SIZE);
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
@@ -743,7 +866,7 @@ TEST_FUNCTION(gballoc_realloc_with_Previous_1_Byte_Block_Ptr_And_2_Size_Calls_Un
     allocation = malloc(OVERHEAD_SIZE);
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
@@ -780,7 +903,7 @@ TEST_FUNCTION(When_realloc_fails_then_gballoc_realloc_Fails_Too_And_No_Change_Is
     allocation = malloc(OVERHEAD_SIZE);
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
@@ -815,7 +938,7 @@ TEST_FUNCTION(When_Allocating_Memory_For_tracking_fails_gballoc_realloc_fails)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
@@ -841,7 +964,7 @@ TEST_FUNCTION(When_The_Pointer_Is_Not_Tracked_gballoc_realloc_Returns_NULL)
     allocation = malloc(OVERHEAD_SIZE);
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
@@ -866,7 +989,7 @@ TEST_FUNCTION(When_The_Pointer_Is_Not_Tracked_gballoc_realloc_Returns_NULL)
 }
 
 /* Tests_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
-TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_the_memory_used_for_tracking_is_freed)
+TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_nothing_is_tracked)
 {
     // arrange
     void* result;
@@ -876,13 +999,12 @@ TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_the_memory_
     allocation = malloc(OVERHEAD_SIZE);
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 1))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(mock_free(allocation));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -892,6 +1014,7 @@ TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_the_memory_
     ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(size_t, 0, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getAllocationCount());
 
     // cleanup
     free(allocation);
@@ -922,7 +1045,7 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_then_gballoc_free_does_nothing)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
@@ -949,6 +1072,7 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_then_gballoc_free_does_nothing)
 /* Tests_SRS_GBALLOC_01_010: [gballoc_getMaximumMemoryUsed shall return the maximum amount of total memory used recorded since the module initialization.] */
 /* Tests_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
 /* Tests_SRS_GBALLOC_01_033: [gballoc_free shall ensure thread safety by using the lock created by gballoc_Init.] */
+/* Tests_SRS_GBALLOC_99_041: [gballoc_free shall call the underlying free after releasing the lock, once the block is no longer tracked.] */
 TEST_FUNCTION(gballoc_free_calls_the_underlying_free)
 {
     // arrange
@@ -958,7 +1082,7 @@ TEST_FUNCTION(gballoc_free_calls_the_underlying_free)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
@@ -967,9 +1091,8 @@ TEST_FUNCTION(gballoc_free_calls_the_underlying_free)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
-    STRICT_EXPECTED_CALL(mock_free(allocation));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
 
     // act
     gballoc_free(block);
@@ -996,24 +1119,19 @@ TEST_FUNCTION(gballoc_malloc_free_2_times_with_1_byte_yields_1_byte_as_max)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
     block = gballoc_realloc(NULL, 1);
     gballoc_free(block);
 
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation);
     block = gballoc_realloc(NULL, 1);
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
-    STRICT_EXPECTED_CALL(mock_free(allocation));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
 
     // act
     gballoc_free(block);
@@ -1035,7 +1153,7 @@ TEST_FUNCTION(gballoc_free_with_an_untracked_pointer_does_not_alter_total_memory
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
+    /* the table used for tracking is allocated on the first tracked allocation */
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
@@ -1059,114 +1177,296 @@ TEST_FUNCTION(gballoc_free_with_an_untracked_pointer_does_not_alter_total_memory
     free(allocation);
 }
 
-/* gballoc_getMaximumMemoryUsed */
-
-
-/* Tests_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.] */
-TEST_FUNCTION(when_gballoc_getMaximumMemoryUsed_called_It_Shall_Lock_And_Unlock)
+/* Tests_SRS_GBALLOC_99_042: [The blocks still tracked shall stay in the table, so that gballoc_free and gballoc_realloc recognize them after the next gballoc_init, and shall no longer count towards the memory used.] */
+TEST_FUNCTION(gballoc_free_frees_a_block_allocated_before_gballoc_deinit_and_gballoc_init)
 {
     // arrange
+    void* block;
+    void* allocation;
     gballoc_init();
     umock_c_reset_all_calls();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    /* the table used for tracking is allocated on the first tracked allocation */
+    STRICT_EXPECTED_CALL(mock_malloc(1));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    block = gballoc_malloc(1);
+    gballoc_deinit();
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(block));
+
     // act
-    (void)gballoc_getMaximumMemoryUsed();
+    gballoc_free(block);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    free(allocation);
 }
 
-/* Tests_SRS_GBALLOC_01_050: [If the lock cannot be acquired, gballoc_getMaximumMemoryUsed shall return SIZE_MAX.] */
-TEST_FUNCTION(when_acquiring_the_lock_fails_then_gballoc_getMaximumMemoryUsed_fails)
+/* Tests_SRS_GBALLOC_99_043: [A kept block freed while gballoc is not initialized shall be dropped from the table when its address is tracked again.] */
+TEST_FUNCTION(gballoc_malloc_drops_a_kept_block_freed_while_gballoc_was_not_initialized)
 {
     // arrange
-    size_t result;
+    void* block;
+    void* allocation;
     gballoc_init();
     umock_c_reset_all_calls();
+    allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
-        .SetReturn(LOCK_ERROR);
+    /* the table used for tracking is allocated on the first tracked allocation */
+    STRICT_EXPECTED_CALL(mock_malloc(1));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    block = gballoc_malloc(1);
+    gballoc_deinit();
+    gballoc_free(block);
+    (void)gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(2));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
-    result = gballoc_getMaximumMemoryUsed();
+    ASSERT_ARE_EQUAL(void_ptr, block, gballoc_malloc(2));
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
+    gballoc_free(block);
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 2, gballoc_getMaximumMemoryUsed());
+
+    // cleanup
+    free(allocation);
 }
 
-/* Tests_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.]  */
-TEST_FUNCTION(gballoc_getMaximumMemoryUsed_after_deinit_fails)
+/* Tests_SRS_GBALLOC_99_001: [gballoc shall look up tracked blocks in a hash table indexed by the block address.] */
+/* Tests_SRS_GBALLOC_99_002: [Before tracking a new block gballoc shall make sure the tracking table is at most half full, allocating it on first use and doubling its size when needed.] */
+TEST_FUNCTION(gballoc_malloc_grows_the_tracking_table_when_it_is_half_full)
 {
     // arrange
+    void* allocation1;
+    void* allocation2;
+    void* blocks[TRACKED_BLOCK_COUNT];
+    size_t i;
+    gballoc_init();
+    umock_c_reset_all_calls();
+    allocation1 = malloc(OVERHEAD_SIZE);
+    allocation2 = malloc(OVERHEAD_SIZE);
+
+    for (i = 0; i < TRACKED_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(mock_malloc(i + 1))
+            .SetReturn((void*)(TEST_BLOCK_BASE + i * 0x10));
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        if (i == 0)
+        {
+            EXPECTED_CALL(mock_malloc(0))
+                .SetReturn(allocation1);
+        }
+        else if (i == TRACKED_BLOCK_COUNT - 1)
+        {
+            EXPECTED_CALL(mock_malloc(0))
+                .SetReturn(allocation2);
+            STRICT_EXPECTED_CALL(mock_free(allocation1));
+        }
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    }
 
     // act
-    size_t result = gballoc_getMaximumMemoryUsed();
+    for (i = 0; i < TRACKED_BLOCK_COUNT; i++)
+    {
+        blocks[i] = gballoc_malloc(i + 1);
+    }
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-}
+    ASSERT_ARE_EQUAL(size_t, TRACKED_BLOCK_COUNT * (TRACKED_BLOCK_COUNT + 1) / 2, gballoc_getCurrentMemoryUsed());
 
-/* gballoc_getCurrentMemoryUsed */
+    /* every block is still found after the table was grown, also when removing entries shifts others around */
+    umock_c_reset_all_calls();
+    for (i = 0; i < TRACKED_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(mock_free(blocks[(i * 7) % TRACKED_BLOCK_COUNT]));
+    }
+    for (i = 0; i < TRACKED_BLOCK_COUNT; i++)
+    {
+        gballoc_free(blocks[(i * 7) % TRACKED_BLOCK_COUNT]);
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
 
-/*Tests_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
-TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_returns_1)
+    // cleanup
+    free(allocation1);
+    free(allocation2);
+}
+
+/* Tests_SRS_GBALLOC_01_013: [When gballoc_malloc fails allocating memory for its internal use, gballoc_malloc shall return NULL.] */
+TEST_FUNCTION(when_growing_the_tracking_table_fails_gballoc_malloc_fails)
 {
     // arrange
     void* allocation;
-    void* toBeFreed;
-    size_t result;
+    void* result;
+    size_t i;
     gballoc_init();
     umock_c_reset_all_calls();
-
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation);
-    STRICT_EXPECTED_CALL(mock_malloc(1));
-    toBeFreed = gballoc_malloc(1);
+    for (i = 0; i < TRACKED_BLOCK_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(mock_malloc(1))
+            .SetReturn((void*)(TEST_BLOCK_BASE + i * 0x10));
+        if (i == 0)
+        {
+            EXPECTED_CALL(mock_malloc(0))
+                .SetReturn(allocation);
+        }
+        (void)gballoc_malloc(1);
+    }
     umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(1))
+        .SetReturn((void*)(TEST_BLOCK_BASE + (TRACKED_BLOCK_COUNT - 1) * 0x10));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free((void*)(TEST_BLOCK_BASE + (TRACKED_BLOCK_COUNT - 1) * 0x10)));
 
     // act
-    result = gballoc_getCurrentMemoryUsed();
+    result = gballoc_malloc(1);
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, 1, result);
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, TRACKED_BLOCK_COUNT - 1, gballoc_getCurrentMemoryUsed());
 
-    ///cleanup
-    gballoc_free(toBeFreed);
+    // cleanup
+    for (i = 0; i < TRACKED_BLOCK_COUNT - 1; i++)
+    {
+        gballoc_free((void*)(TEST_BLOCK_BASE + i * 0x10));
+    }
     free(allocation);
-    umock_c_reset_all_calls(); //this is just for mathematics, not for functionality
 }
 
-/*Tests_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
-TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_2x3_byte_calloc_returns_6)
+/* gballoc_getMaximumMemoryUsed */
+
+
+/* Tests_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.] */
+TEST_FUNCTION(when_gballoc_getMaximumMemoryUsed_called_It_Shall_Lock_And_Unlock)
 {
     // arrange
-    void* allocation;
-    void* toBeFreed;
-    size_t result;
     gballoc_init();
     umock_c_reset_all_calls();
-    allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation);
-    toBeFreed = gballoc_calloc(2, 3);
-    umock_c_reset_all_calls();
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
-
     // act
-    result = gballoc_getCurrentMemoryUsed();
+    (void)gballoc_getMaximumMemoryUsed();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_01_050: [If the lock cannot be acquired, gballoc_getMaximumMemoryUsed shall return SIZE_MAX.] */
+TEST_FUNCTION(when_acquiring_the_lock_fails_then_gballoc_getMaximumMemoryUsed_fails)
+{
+    // arrange
+    size_t result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+
+    // act
+    result = gballoc_getMaximumMemoryUsed();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
+}
+
+/* Tests_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.]  */
+TEST_FUNCTION(gballoc_getMaximumMemoryUsed_after_deinit_fails)
+{
+    // arrange
+
+    // act
+    size_t result = gballoc_getMaximumMemoryUsed();
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* gballoc_getCurrentMemoryUsed */
+
+/*Tests_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
+TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_returns_1)
+{
+    // arrange
+    void* allocation;
+    void* toBeFreed;
+    size_t result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    allocation = malloc(OVERHEAD_SIZE);
+
+    STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    toBeFreed = gballoc_malloc(1);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_getCurrentMemoryUsed();
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    gballoc_free(toBeFreed);
+    free(allocation);
+    umock_c_reset_all_calls(); //this is just for mathematics, not for functionality
+}
+
+/*Tests_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
+TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_2x3_byte_calloc_returns_6)
+{
+    // arrange
+    void* allocation;
+    void* toBeFreed;
+    size_t result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    toBeFreed = gballoc_calloc(2, 3);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_getCurrentMemoryUsed();
 
     // assert
     ASSERT_ARE_EQUAL(size_t, 6, result);
@@ -1189,10 +1489,10 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_3_bytes_reall
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed = gballoc_malloc(1);
@@ -1225,10 +1525,10 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_free_returns_
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed = gballoc_malloc(1);
@@ -1294,10 +1594,10 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_realloc_and_free_returns_0)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed = gballoc_malloc(1);
@@ -1323,26 +1623,22 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_realloc_and_free_returns_0)
 TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc_returns_2)
 {
     // arrange
-    void* allocation1;
-    void* allocation2;
+    void* allocation;
     void* toBeFreed1;
     void* toBeFreed2;
     size_t result;
     gballoc_init();
     umock_c_reset_all_calls();
 
-    allocation1 = malloc(OVERHEAD_SIZE);
-    allocation2 = malloc(OVERHEAD_SIZE);
+    allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation2);
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
@@ -1361,8 +1657,7 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     ///cleanup
     gballoc_free(toBeFreed1);
     gballoc_free(toBeFreed2);
-    free(allocation1);
-    free(allocation2);
+    free(allocation);
     umock_c_reset_all_calls(); //this is just for mathematics, not for functionality
 }
 
@@ -1370,26 +1665,22 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
 TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc_and_3_realloc_returns_4)
 {
     // arrange
-    void* allocation1;
-    void* allocation2;
+    void* allocation;
     void* toBeFreed1;
     void* toBeFreed2;
     size_t result;
     gballoc_init();
     umock_c_reset_all_calls();
 
-    allocation1 = malloc(OVERHEAD_SIZE);
-    allocation2 = malloc(OVERHEAD_SIZE);
+    allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation2);
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
@@ -1409,8 +1700,7 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     ///cleanup
     gballoc_free(toBeFreed1);
     gballoc_free(toBeFreed2);
-    free(allocation1);
-    free(allocation2);
+    free(allocation);
     umock_c_reset_all_calls(); //this is just for mathematics, not for functionality
 }
 
@@ -1418,26 +1708,22 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
 TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_6_byte_calloc_returns_7)
 {
     // arrange
-    void* allocation1;
-    void* allocation2;
+    void* allocation;
     void* toBeFreed1;
     void* toBeFreed2;
     size_t result;
     gballoc_init();
     umock_c_reset_all_calls();
 
-    allocation1 = malloc(OVERHEAD_SIZE);
-    allocation2 = malloc(OVERHEAD_SIZE);
+    allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation2);
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_calloc(2, 3));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
@@ -1456,8 +1742,7 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_6_byte_calloc
     ///cleanup
     gballoc_free(toBeFreed1);
     gballoc_free(toBeFreed2);
-    free(allocation1);
-    free(allocation2);
+    free(allocation);
     umock_c_reset_all_calls(); //this is just for mathematics, not for functionality
 }
 
@@ -1475,17 +1760,15 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_6_byte_calloc
     allocation1 = malloc(OVERHEAD_SIZE);
     allocation2 = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1))
         .SetReturn((char*)allocation1 + OVERHEAD_SIZE / 2); /*somewhere in the middle of allocation*/
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation2);
+        .SetReturn(allocation1);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_calloc(2, 3))
         .SetReturn((char*)allocation2 + OVERHEAD_SIZE / 2);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
@@ -1523,15 +1806,13 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     allocation1 = malloc(OVERHEAD_SIZE);
     allocation2 = malloc(OVERHEAD_SIZE);
 
+    STRICT_EXPECTED_CALL(mock_malloc(1))
+        .SetReturn((char*)allocation1 + OVERHEAD_SIZE / 2); /*somewhere in the middle of allocation*/
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation1);
-    STRICT_EXPECTED_CALL(mock_malloc(1))
-        .SetReturn((char*)allocation1 + OVERHEAD_SIZE / 2); /*somewhere in the middle of allocation*/
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    EXPECTED_CALL(mock_malloc(0))
-        .SetReturn(allocation2);
     STRICT_EXPECTED_CALL(mock_realloc(IGNORED_PTR_ARG, 3))
         .IgnoreArgument(1)
         .SetReturn((char*)allocation2 + OVERHEAD_SIZE / 2); /*somewhere in the middle of allocation*/
@@ -1656,10 +1937,10 @@ TEST_FUNCTION(gballoc_getAllocationCount_success)
 
     allocation = malloc(OVERHEAD_SIZE);
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    STRICT_EXPECTED_CALL(mock_malloc(1));
     toBeFreed = gballoc_malloc(1);
     umock_c_reset_all_calls();
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
@@ -1719,10 +2000,10 @@ TEST_FUNCTION(gballoc_resetMetrics_success)
 
     allocation = malloc(OVERHEAD_SIZE);
 
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    STRICT_EXPECTED_CALL(mock_malloc(1));
     toBeFreed = gballoc_malloc(1);
     umock_c_reset_all_calls();
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
@@ -1754,4 +2035,705 @@ TEST_FUNCTION(gballoc_resetMetrics_success)
     free(allocation);
 }
 
+/* gballoc_startSiteProfiling */
+
+/* Tests_SRS_GBALLOC_99_007: [If gballoc was not initialized gballoc_startSiteProfiling shall fail and return a non-zero value.] */
+TEST_FUNCTION(gballoc_startSiteProfiling_without_init_fails)
+{
+    // act
+    int result = gballoc_startSiteProfiling();
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_008: [If the lock cannot be acquired, gballoc_startSiteProfiling shall fail and return a non-zero value.] */
+TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_startSiteProfiling_fails)
+{
+    // arrange
+    int result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+
+    // act
+    result = gballoc_startSiteProfiling();
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_009: [gballoc_startSiteProfiling shall discard the sites recorded so far, start recording allocation sites and return 0.] */
+TEST_FUNCTION(gballoc_startSiteProfiling_succeeds)
+{
+    // arrange
+    int result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_startSiteProfiling();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_010: [While site profiling is on, every block tracked by gballoc_malloc, gballoc_calloc or gballoc_realloc shall be accounted to the code address that called them: one more allocation of size bytes and size more live bytes in one more live block.] */
+/* Tests_SRS_GBALLOC_99_018: [gballoc_dumpSiteReport shall write to destination the totals and, for every site sorted by live bytes, its live bytes, live blocks, allocations, allocated bytes, allocations per second and code address, and return 0.] */
+TEST_FUNCTION(gballoc_malloc_with_site_profiling_accounts_the_block_to_its_site)
+{
+    // arrange
+    void* tracking_table;
+    void* site_table;
+    void* sorted_sites;
+    char text[TEST_DUMP_SIZE];
+    FILE* dump = tmpfile();
+    int result;
+    ASSERT_IS_NOT_NULL(dump);
+    gballoc_init();
+    tracking_table = malloc(OVERHEAD_SIZE);
+    site_table = malloc(OVERHEAD_SIZE);
+    sorted_sites = malloc(OVERHEAD_SIZE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_malloc(3))
+        .SetReturn((void*)TEST_BLOCK_BASE);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(tracking_table);
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(site_table);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(sorted_sites);
+    STRICT_EXPECTED_CALL(mock_free(sorted_sites));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    (void)gballoc_startSiteProfiling();
+    (void)gballoc_malloc(3);
+    result = gballoc_dumpSiteReport(dump);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    read_dump(dump, text);
+    ASSERT_IS_NOT_NULL(strstr(text, "3 live bytes in 1 blocks, 1 allocations of 3 bytes"));
+
+    // cleanup
+    gballoc_free((void*)TEST_BLOCK_BASE);
+    free(tracking_table);
+    free(site_table);
+    free(sorted_sites);
+}
+
+/* Tests_SRS_GBALLOC_99_011: [When a block accounted to a site is freed or reallocated, its size and the block shall be removed from the live bytes and live blocks of that site.] */
+TEST_FUNCTION(gballoc_free_removes_the_block_from_the_live_bytes_of_its_site)
+{
+    // arrange
+    void* tracking_table;
+    void* site_table;
+    void* sorted_sites;
+    char text[TEST_DUMP_SIZE];
+    FILE* dump = tmpfile();
+    ASSERT_IS_NOT_NULL(dump);
+    gballoc_init();
+    tracking_table = malloc(OVERHEAD_SIZE);
+    site_table = malloc(OVERHEAD_SIZE);
+    sorted_sites = malloc(OVERHEAD_SIZE);
+    (void)malloc_profiled_block(tracking_table, site_table);
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free((void*)TEST_BLOCK_BASE));
+
+    // act
+    gballoc_free((void*)TEST_BLOCK_BASE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(sorted_sites);
+    ASSERT_ARE_EQUAL(int, 0, gballoc_dumpSiteReport(dump));
+    read_dump(dump, text);
+    ASSERT_IS_NOT_NULL(strstr(text, "0 live bytes in 0 blocks, 1 allocations of 3 bytes"));
+
+    // cleanup
+    free(tracking_table);
+    free(site_table);
+    free(sorted_sites);
+}
+
+/* Tests_SRS_GBALLOC_99_012: [If the site table cannot be grown, the block shall be tracked without a site.] */
+TEST_FUNCTION(when_the_site_table_cannot_be_allocated_gballoc_malloc_still_tracks_the_block)
+{
+    // arrange
+    void* tracking_table;
+    void* result;
+    gballoc_init();
+    (void)gballoc_startSiteProfiling();
+    tracking_table = malloc(OVERHEAD_SIZE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(3))
+        .SetReturn((void*)TEST_BLOCK_BASE);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(tracking_table);
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn((void*)NULL);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_malloc(3);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, (void*)TEST_BLOCK_BASE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 3, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_free(result);
+    free(tracking_table);
+}
+
+/* gballoc_stopSiteProfiling */
+
+/* Tests_SRS_GBALLOC_99_013: [gballoc_stopSiteProfiling shall stop recording allocation sites and free the site table.] */
+TEST_FUNCTION(gballoc_stopSiteProfiling_frees_the_site_table)
+{
+    // arrange
+    void* tracking_table;
+    void* site_table;
+    FILE* dump = tmpfile();
+    ASSERT_IS_NOT_NULL(dump);
+    gballoc_init();
+    tracking_table = malloc(OVERHEAD_SIZE);
+    site_table = malloc(OVERHEAD_SIZE);
+    (void)malloc_profiled_block(tracking_table, site_table);
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(site_table));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    gballoc_stopSiteProfiling();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, gballoc_dumpSiteReport(dump));
+
+    // cleanup
+    (void)fclose(dump);
+    gballoc_free((void*)TEST_BLOCK_BASE);
+    free(tracking_table);
+    free(site_table);
+}
+
+/* Tests_SRS_GBALLOC_99_014: [If gballoc was not initialized gballoc_stopSiteProfiling shall do nothing.] */
+TEST_FUNCTION(gballoc_stopSiteProfiling_without_init_does_nothing)
+{
+    // act
+    gballoc_stopSiteProfiling();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_021: [gballoc_deinit shall stop site profiling and free the site table.] */
+TEST_FUNCTION(gballoc_deinit_frees_the_site_table)
+{
+    // arrange
+    void* tracking_table;
+    void* site_table;
+    gballoc_init();
+    tracking_table = malloc(OVERHEAD_SIZE);
+    site_table = malloc(OVERHEAD_SIZE);
+    (void)malloc_profiled_block(tracking_table, site_table);
+
+    /* the profiled block is still allocated, so only the site table goes */
+    STRICT_EXPECTED_CALL(mock_free(site_table));
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+
+    // act
+    gballoc_deinit();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    free(tracking_table);
+    free(site_table);
+}
+
+/* gballoc_dumpSiteReport / gballoc_dumpHeapProfile */
+
+/* Tests_SRS_GBALLOC_99_015: [If destination is NULL, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+TEST_FUNCTION(gballoc_dumpSiteReport_with_NULL_destination_fails)
+{
+    // arrange
+    int result;
+    gballoc_init();
+    (void)gballoc_startSiteProfiling();
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_dumpSiteReport(NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_016: [If gballoc was not initialized or site profiling is not on, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+TEST_FUNCTION(gballoc_dumpHeapProfile_without_site_profiling_fails)
+{
+    // arrange
+    int result;
+    FILE* dump = tmpfile();
+    ASSERT_IS_NOT_NULL(dump);
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_dumpHeapProfile(dump);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    (void)fclose(dump);
+}
+
+/* Tests_SRS_GBALLOC_99_017: [If the lock cannot be acquired, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_dumpSiteReport_fails)
+{
+    // arrange
+    int result;
+    FILE* dump = tmpfile();
+    ASSERT_IS_NOT_NULL(dump);
+    gballoc_init();
+    (void)gballoc_startSiteProfiling();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+
+    // act
+    result = gballoc_dumpSiteReport(dump);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    (void)fclose(dump);
+}
+
+/* Tests_SRS_GBALLOC_99_020: [If the memory needed to sort the sites cannot be allocated, gballoc_dumpSiteReport and gballoc_dumpHeapProfile shall fail and return a non-zero value.] */
+TEST_FUNCTION(when_allocating_the_sorted_sites_fails_gballoc_dumpSiteReport_fails)
+{
+    // arrange
+    int result;
+    FILE* dump = tmpfile();
+    ASSERT_IS_NOT_NULL(dump);
+    gballoc_init();
+    (void)gballoc_startSiteProfiling();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn((void*)NULL);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_dumpSiteReport(dump);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    (void)fclose(dump);
+}
+
+/* Tests_SRS_GBALLOC_99_019: [gballoc_dumpHeapProfile shall write the sites to destination in the legacy heap profile format read by pprof, followed on Linux by the memory mappings of the process, and return 0.] */
+TEST_FUNCTION(gballoc_dumpHeapProfile_writes_a_pprof_heap_profile)
+{
+    // arrange
+    void* tracking_table;
+    void* site_table;
+    void* sorted_sites;
+    char text[TEST_DUMP_SIZE];
+    int result;
+    FILE* dump = tmpfile();
+    ASSERT_IS_NOT_NULL(dump);
+    gballoc_init();
+    tracking_table = malloc(OVERHEAD_SIZE);
+    site_table = malloc(OVERHEAD_SIZE);
+    sorted_sites = malloc(OVERHEAD_SIZE);
+    (void)malloc_profiled_block(tracking_table, site_table);
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(sorted_sites);
+    STRICT_EXPECTED_CALL(mock_free(sorted_sites));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_dumpHeapProfile(dump);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    read_dump(dump, text);
+    ASSERT_IS_TRUE(strncmp(text, "heap profile: 1: 3 [1: 3] @ heapprofile\n1: 3 [1: 3] @ 0x", 56) == 0);
+
+    // cleanup
+    gballoc_free((void*)TEST_BLOCK_BASE);
+    free(tracking_table);
+    free(site_table);
+    free(sorted_sites);
+}
+
+/* gballoc_setAllocator */
+
+/* Tests_SRS_GBALLOC_99_024: [Otherwise gballoc_setAllocator shall copy allocator, use it for every later allocation and return 0.] */
+/* Tests_SRS_GBALLOC_99_027: [gballoc_allocatorMalloc, gballoc_allocatorRealloc and gballoc_allocatorFree shall call the malloc_function, realloc_function and free_function of the installed allocator with its context.] */
+TEST_FUNCTION(gballoc_malloc_without_init_uses_the_installed_allocator)
+{
+    // arrange
+    int result;
+    void* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+
+    STRICT_EXPECTED_CALL(test_allocator_malloc(TEST_ALLOCATOR_CONTEXT, 3));
+
+    // act
+    result = gballoc_setAllocator(&allocator);
+    block = gballoc_malloc(3);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR2, block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_024: [Otherwise gballoc_setAllocator shall copy allocator, use it for every later allocation and return 0.] */
+/* Tests_SRS_GBALLOC_99_027: [gballoc_allocatorMalloc, gballoc_allocatorRealloc and gballoc_allocatorFree shall call the malloc_function, realloc_function and free_function of the installed allocator with its context.] */
+TEST_FUNCTION(tracked_blocks_come_from_and_go_back_to_the_installed_allocator)
+{
+    // arrange
+    void* tracking_table;
+    void* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    (void)gballoc_setAllocator(&allocator);
+    gballoc_init();
+    tracking_table = malloc(OVERHEAD_SIZE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_allocator_malloc(TEST_ALLOCATOR_CONTEXT, 3))
+        .SetReturn(TEST_ALLOC_PTR1);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(tracking_table);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(test_allocator_realloc(TEST_ALLOCATOR_CONTEXT, TEST_ALLOC_PTR1, 5))
+        .SetReturn(TEST_REALLOC_PTR);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(test_allocator_free(TEST_ALLOCATOR_CONTEXT, TEST_REALLOC_PTR));
+
+    // act
+    block = gballoc_malloc(3);
+    block = gballoc_realloc(block, 5);
+    gballoc_free(block);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_REALLOC_PTR, block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    free(tracking_table);
+}
+
+/* Tests_SRS_GBALLOC_99_022: [If allocator is NULL, gballoc_setAllocator shall install the default allocator, which calls the C99 malloc, calloc, realloc and free, and return 0.] */
+TEST_FUNCTION(gballoc_setAllocator_with_NULL_installs_the_default_allocator)
+{
+    // arrange
+    int result;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    (void)gballoc_setAllocator(&allocator);
+
+    STRICT_EXPECTED_CALL(mock_malloc(3));
+
+    // act
+    result = gballoc_setAllocator(NULL);
+    (void)gballoc_malloc(3);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_023: [If malloc_function, realloc_function or free_function is NULL, or only one of aligned_malloc_function and aligned_free_function is NULL, gballoc_setAllocator shall fail, keep the installed allocator and return a non-zero value.] */
+TEST_FUNCTION(gballoc_setAllocator_without_malloc_function_fails)
+{
+    // arrange
+    int result;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    allocator.malloc_function = NULL;
+
+    STRICT_EXPECTED_CALL(mock_malloc(3));
+
+    // act
+    result = gballoc_setAllocator(&allocator);
+    (void)gballoc_malloc(3);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_023: [If malloc_function, realloc_function or free_function is NULL, or only one of aligned_malloc_function and aligned_free_function is NULL, gballoc_setAllocator shall fail, keep the installed allocator and return a non-zero value.] */
+TEST_FUNCTION(gballoc_setAllocator_without_realloc_function_fails)
+{
+    // arrange
+    int result;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    allocator.realloc_function = NULL;
+
+    // act
+    result = gballoc_setAllocator(&allocator);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_GBALLOC_99_023: [If malloc_function, realloc_function or free_function is NULL, or only one of aligned_malloc_function and aligned_free_function is NULL, gballoc_setAllocator shall fail, keep the installed allocator and return a non-zero value.] */
+TEST_FUNCTION(gballoc_setAllocator_without_free_function_fails)
+{
+    // arrange
+    int result;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    allocator.free_function = NULL;
+
+    // act
+    result = gballoc_setAllocator(&allocator);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_GBALLOC_99_023: [If malloc_function, realloc_function or free_function is NULL, or only one of aligned_malloc_function and aligned_free_function is NULL, gballoc_setAllocator shall fail, keep the installed allocator and return a non-zero value.] */
+TEST_FUNCTION(gballoc_setAllocator_with_aligned_malloc_function_only_fails)
+{
+    // arrange
+    int result;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    allocator.aligned_malloc_function = test_allocator_aligned_malloc;
+
+    // act
+    result = gballoc_setAllocator(&allocator);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* gballoc_getAllocator */
+
+/* Tests_SRS_GBALLOC_99_026: [gballoc_getAllocator shall copy the installed allocator to allocator.] */
+TEST_FUNCTION(gballoc_getAllocator_returns_the_installed_allocator)
+{
+    // arrange
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    GBALLOC_ALLOCATOR installed;
+    (void)gballoc_setAllocator(&allocator);
+
+    // act
+    gballoc_getAllocator(&installed);
+
+    // assert
+    ASSERT_IS_TRUE(installed.malloc_function == test_allocator_malloc);
+    ASSERT_IS_TRUE(installed.realloc_function == test_allocator_realloc);
+    ASSERT_IS_TRUE(installed.free_function == test_allocator_free);
+    ASSERT_IS_NULL(installed.calloc_function);
+    ASSERT_IS_NULL(installed.aligned_malloc_function);
+    ASSERT_IS_NULL(installed.aligned_free_function);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOCATOR_CONTEXT, installed.context);
+}
+
+/* Tests_SRS_GBALLOC_99_025: [If allocator is NULL, gballoc_getAllocator shall do nothing.] */
+TEST_FUNCTION(gballoc_getAllocator_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    gballoc_getAllocator(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* gballoc_allocatorCalloc */
+
+/* Tests_SRS_GBALLOC_99_028: [gballoc_allocatorCalloc shall call the calloc_function of the installed allocator with its context.] */
+TEST_FUNCTION(gballoc_allocatorCalloc_calls_the_calloc_function)
+{
+    // arrange
+    void* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    allocator.calloc_function = test_allocator_calloc;
+    (void)gballoc_setAllocator(&allocator);
+
+    STRICT_EXPECTED_CALL(test_allocator_calloc(TEST_ALLOCATOR_CONTEXT, 2, 3));
+
+    // act
+    block = gballoc_allocatorCalloc(2, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR2, block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_029: [If the installed allocator has no calloc_function, gballoc_allocatorCalloc shall get nmemb * size bytes from its malloc_function and set them to 0.] */
+TEST_FUNCTION(gballoc_allocatorCalloc_without_calloc_function_clears_a_block_from_malloc_function)
+{
+    // arrange
+    unsigned char memory[6] = { 1, 2, 3, 4, 5, 6 };
+    unsigned char* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    (void)gballoc_setAllocator(&allocator);
+
+    STRICT_EXPECTED_CALL(test_allocator_malloc(TEST_ALLOCATOR_CONTEXT, 6))
+        .SetReturn(memory);
+
+    // act
+    block = (unsigned char*)gballoc_allocatorCalloc(2, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, memory, block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, block[0]);
+    ASSERT_ARE_EQUAL(int, 0, block[5]);
+}
+
+/* Tests_SRS_GBALLOC_99_030: [If nmemb * size overflows, gballoc_allocatorCalloc shall return NULL.] */
+TEST_FUNCTION(gballoc_allocatorCalloc_without_calloc_function_fails_when_the_size_overflows)
+{
+    // arrange
+    void* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    (void)gballoc_setAllocator(&allocator);
+
+    // act
+    block = gballoc_allocatorCalloc(SIZE_MAX / 2, 3);
+
+    // assert
+    ASSERT_IS_NULL(block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* gballoc_allocatorAlignedMalloc */
+
+/* Tests_SRS_GBALLOC_99_031: [If alignment is not a power of 2, gballoc_allocatorAlignedMalloc shall return NULL.] */
+TEST_FUNCTION(gballoc_allocatorAlignedMalloc_with_an_alignment_that_is_not_a_power_of_2_fails)
+{
+    // arrange
+    void* block;
+
+    // act
+    block = gballoc_allocatorAlignedMalloc(48, 100);
+
+    // assert
+    ASSERT_IS_NULL(block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_032: [gballoc_allocatorAlignedMalloc shall call the aligned_malloc_function of the installed allocator with its context.] */
+/* Tests_SRS_GBALLOC_99_035: [gballoc_allocatorAlignedFree shall call the aligned_free_function of the installed allocator with its context.] */
+TEST_FUNCTION(gballoc_allocatorAlignedMalloc_calls_the_aligned_functions)
+{
+    // arrange
+    void* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    allocator.aligned_malloc_function = test_allocator_aligned_malloc;
+    allocator.aligned_free_function = test_allocator_aligned_free;
+    (void)gballoc_setAllocator(&allocator);
+
+    STRICT_EXPECTED_CALL(test_allocator_aligned_malloc(TEST_ALLOCATOR_CONTEXT, 64, 100));
+    STRICT_EXPECTED_CALL(test_allocator_aligned_free(TEST_ALLOCATOR_CONTEXT, TEST_ALLOC_PTR2));
+
+    // act
+    block = gballoc_allocatorAlignedMalloc(64, 100);
+    gballoc_allocatorAlignedFree(block);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR2, block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_99_033: [If the installed allocator has no aligned_malloc_function, gballoc_allocatorAlignedMalloc shall get size + alignment + sizeof(void*) bytes from its malloc_function and return the first address in them that is aligned and leaves room for a pointer before it.] */
+/* Tests_SRS_GBALLOC_99_036: [If the installed allocator has no aligned_free_function, gballoc_allocatorAlignedFree shall do nothing when ptr is NULL and otherwise give the block that was really allocated back to its free_function.] */
+TEST_FUNCTION(gballoc_allocatorAlignedMalloc_without_aligned_functions_aligns_a_block_from_malloc_function)
+{
+    // arrange
+    unsigned char* memory = (unsigned char*)malloc(100 + 64 + sizeof(void*));
+    unsigned char* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    (void)gballoc_setAllocator(&allocator);
+
+    STRICT_EXPECTED_CALL(test_allocator_malloc(TEST_ALLOCATOR_CONTEXT, 100 + 64 + sizeof(void*)))
+        .SetReturn(memory);
+    STRICT_EXPECTED_CALL(test_allocator_free(TEST_ALLOCATOR_CONTEXT, memory));
+
+    // act
+    block = (unsigned char*)gballoc_allocatorAlignedMalloc(64, 100);
+    gballoc_allocatorAlignedFree(block);
+    gballoc_allocatorAlignedFree(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, (size_t)((uintptr_t)block % 64));
+    ASSERT_IS_TRUE(block >= memory + sizeof(void*));
+    ASSERT_IS_TRUE(block + 100 <= memory + 100 + 64 + sizeof(void*));
+
+    // cleanup
+    free(memory);
+}
+
+/* Tests_SRS_GBALLOC_99_034: [If size is too large, gballoc_allocatorAlignedMalloc shall return NULL.] */
+TEST_FUNCTION(gballoc_allocatorAlignedMalloc_without_aligned_functions_fails_when_the_size_is_too_large)
+{
+    // arrange
+    void* block;
+    GBALLOC_ALLOCATOR allocator = make_test_allocator();
+    (void)gballoc_setAllocator(&allocator);
+
+    // act
+    block = gballoc_allocatorAlignedMalloc(64, SIZE_MAX - 8);
+
+    // assert
+    ASSERT_IS_NULL(block);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(GBAlloc_UnitTests)
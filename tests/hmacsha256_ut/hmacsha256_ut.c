@@ -170,4 +170,296 @@ TEST_FUNCTION(HMACSHA256_ComputeHash_Succeeds)
     ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hash), expectedHash, 8));
 }
 
+/* HMACSHA256_CreateKey */
+
+TEST_FUNCTION(HMACSHA256_CreateKey_With_NULL_Key_Fails)
+{
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(NULL, 3);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(HMACSHA256_CreateKey_With_Zero_Key_Buffer_Size_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(key, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(HMACSHA256_CreateKey_Succeeds)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    HMACSHA256_DestroyKey(result);
+}
+
+TEST_FUNCTION(HMACSHA256_CreateKey_When_malloc_Fails_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* HMACSHA256_DestroyKey */
+
+TEST_FUNCTION(HMACSHA256_DestroyKey_With_NULL_Does_Nothing)
+{
+    // arrange
+    umock_c_reset_all_calls();
+
+    // act
+    HMACSHA256_DestroyKey(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(HMACSHA256_DestroyKey_Frees_The_Key)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    HMACSHA256_KEY_HANDLE keyHandle = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(keyHandle));
+
+    // act
+    HMACSHA256_DestroyKey(keyHandle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* HMACSHA256_ComputeHashWithKey */
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_NULL_Key_Fails)
+{
+    // arrange
+    static const unsigned char buffer[] = "testPayload";
+    unsigned char digest[HMACSHA256_HASH_SIZE];
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(NULL, buffer, sizeof(buffer) - 1, digest);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_NULL_Payload_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    unsigned char digest[HMACSHA256_HASH_SIZE];
+    HMACSHA256_KEY_HANDLE keyHandle = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(keyHandle, NULL, sizeof(buffer) - 1, digest);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+
+    // cleanup
+    HMACSHA256_DestroyKey(keyHandle);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_Zero_Payload_Buffer_Size_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    unsigned char digest[HMACSHA256_HASH_SIZE];
+    HMACSHA256_KEY_HANDLE keyHandle = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(keyHandle, buffer, 0, digest);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+
+    // cleanup
+    HMACSHA256_DestroyKey(keyHandle);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_NULL_Hash_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    HMACSHA256_KEY_HANDLE keyHandle = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(keyHandle, buffer, sizeof(buffer) - 1, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+
+    // cleanup
+    HMACSHA256_DestroyKey(keyHandle);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_Succeeds_Repeatedly)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    unsigned char expectedHash[32] = { 108, 7, 130, 47, 104, 233, 39, 188, 126, 122, 134, 187, 63, 19, 52, 120, 172, 7, 43, 25, 133, 60, 92, 217, 59, 59, 69, 116, 85, 104, 55, 224 };
+    unsigned char digest[HMACSHA256_HASH_SIZE];
+    HMACSHA256_KEY_HANDLE keyHandle = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        // act
+        HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(keyHandle, buffer, sizeof(buffer) - 1, digest);
+
+        // assert
+        ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(digest, expectedHash, sizeof(expectedHash)));
+    }
+
+    // cleanup
+    HMACSHA256_DestroyKey(keyHandle);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_Key_Longer_Than_A_Block_Matches_ComputeHash)
+{
+    // arrange
+    unsigned char key[131];
+    static const unsigned char buffer[] = "Test Using Larger Than Block-Size Key - Hash Key First";
+    unsigned char digest[HMACSHA256_HASH_SIZE];
+    HMACSHA256_KEY_HANDLE keyHandle;
+    HMACSHA256_RESULT result;
+    (void)memset(key, 0xaa, sizeof(key));
+    keyHandle = HMACSHA256_CreateKey(key, sizeof(key));
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, HMACSHA256_ComputeHash(key, sizeof(key), buffer, sizeof(buffer) - 1, hash));
+
+    // act
+    result = HMACSHA256_ComputeHashWithKey(keyHandle, buffer, sizeof(buffer) - 1, digest);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(digest, BUFFER_u_char(hash), HMACSHA256_HASH_SIZE));
+
+    // cleanup
+    HMACSHA256_DestroyKey(keyHandle);
+}
+
+/* HMACSHA256_ComputeHashBatch */
+
+TEST_FUNCTION(HMACSHA256_ComputeHashBatch_With_NULL_Items_Fails)
+{
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashBatch(NULL, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashBatch_With_Zero_Items_Fails)
+{
+    // arrange
+    HMACSHA256_BATCH_ITEM item;
+    item.key = (const unsigned char*)"key";
+    item.keyLen = 3;
+    item.payload = (const unsigned char*)"testPayload";
+    item.payloadLen = 11;
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashBatch(&item, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashBatch_With_An_Invalid_Item_Fails)
+{
+    // arrange
+    HMACSHA256_BATCH_ITEM items[2];
+    items[0].key = (const unsigned char*)"key";
+    items[0].keyLen = 3;
+    items[0].payload = (const unsigned char*)"testPayload";
+    items[0].payloadLen = 11;
+    items[1] = items[0];
+    items[1].payloadLen = 0;
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashBatch(items, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashBatch_Matches_ComputeHash_For_Every_Batch_Implementation)
+{
+    // arrange
+    static const SHA256BatchImplementation implementations[] = { sha256BatchSerial, sha256BatchAvx2, sha256BatchAvx512 };
+    HMACSHA256_BATCH_ITEM items[45];
+    unsigned char keys[45][100];
+    unsigned char payloads[45][150];
+    size_t i, j;
+
+    for (i = 0; i < sizeof(items) / sizeof(items[0]); i++)
+    {
+        for (j = 0; j < sizeof(keys[i]); j++)
+        {
+            keys[i][j] = (unsigned char)(i * 7 + j);
+        }
+        for (j = 0; j < sizeof(payloads[i]); j++)
+        {
+            payloads[i][j] = (unsigned char)(i * 13 + j * 3);
+        }
+        items[i].key = keys[i];
+        items[i].keyLen = 1 + (i * 11) % sizeof(keys[i]);
+        items[i].payload = payloads[i];
+        items[i].payloadLen = 1 + (i * 17) % sizeof(payloads[i]);
+    }
+
+    for (j = 0; j < sizeof(implementations) / sizeof(implementations[0]); j++)
+    {
+        if (SHA256BatchSelectImplementation(implementations[j]) == shaSuccess)
+        {
+            // act
+            HMACSHA256_RESULT result = HMACSHA256_ComputeHashBatch(items, sizeof(items) / sizeof(items[0]));
+
+            // assert
+            ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result);
+            for (i = 0; i < sizeof(items) / sizeof(items[0]); i++)
+            {
+                BUFFER_HANDLE expected = BUFFER_new();
+                ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, HMACSHA256_ComputeHash(items[i].key, items[i].keyLen, items[i].payload, items[i].payloadLen, expected));
+                ASSERT_ARE_EQUAL(int, 0, memcmp(items[i].hash, BUFFER_u_char(expected), HMACSHA256_HASH_SIZE));
+                BUFFER_delete(expected);
+            }
+        }
+    }
+}
+
 END_TEST_SUITE(HMACSHA256_UnitTests)
@@ -85,6 +85,7 @@ void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/threadapi.h"
 #include "azure_c_shared_utility/platform.h"
 #include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/agenttime.h"
 #undef ENABLE_MOCKS
 #include "azure_c_shared_utility/httpapi.h"
 #include "azure_c_shared_utility/shared_util_options.h"
@@ -153,6 +154,8 @@ static const int xio_send_0_e[4] = { 0, 123, 0, 0 };
 static const int xio_send_00_e[4] = { 0, 0, 123, 0 };
 static const int xio_send_7x0[7] = { 0, 0, 0, 0, 0, 0, 0 };
 static const int xio_send_6x0_e[7] = { 0, 0, 0, 0, 0, 0, 123 };
+static const int xio_send_14x0[14] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const int xio_send_e_7x0[8] = { 123, 0, 0, 0, 0, 0, 0, 0 };
 static const xio_dowork_job doworkjob_end[1] = { XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_oe[2] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_4none_oe[6] = { XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_END };
@@ -162,12 +165,15 @@ static const xio_dowork_job doworkjob_oee[3] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK
 static const xio_dowork_job doworkjob_ose[3] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_ee[2] = { XIO_DOWORK_JOB_ERROR, XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_o_re[3] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_END };
-static const xio_dowork_job doworkjob_o_rce[8] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_END };
-static const xio_dowork_job doworkjob_o_rc_error[9] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_ERROR, XIO_DOWORK_JOB_END };
+static const xio_dowork_job doworkjob_o_rce[4] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_END };
+static const xio_dowork_job doworkjob_o_rc_error[5] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_ERROR, XIO_DOWORK_JOB_END };
+static const xio_dowork_job doworkjob_o_2none_re[5] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_NONE, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_END };
+static const xio_dowork_job doworkjob_e_o_re[4] = { XIO_DOWORK_JOB_ERROR, XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_END };
+static const xio_dowork_job doworkjob_re[2] = { XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_END };
 static const xio_dowork_job doworkjob_o_rre[4] = { XIO_DOWORK_JOB_OPEN, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_END };
-static const xio_dowork_job doworkjob_o_sre[15] = { XIO_DOWORK_JOB_OPEN, 
+static const xio_dowork_job doworkjob_o_sre[11] = { XIO_DOWORK_JOB_OPEN, 
     XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND, XIO_DOWORK_JOB_SEND,
-    XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_END };
+    XIO_DOWORK_JOB_RECEIVED, XIO_DOWORK_JOB_CLOSE, XIO_DOWORK_JOB_END };
 
 static const IO_OPEN_RESULT openresult_ok[1] = { IO_OPEN_OK };
 static const IO_OPEN_RESULT openresult_error[1] = { IO_OPEN_ERROR };
@@ -580,27 +586,8 @@ static void setupAllCallBeforeReceiveHTTPsequenceWithSuccess()
 {
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, DoworkJobsReceivedBuffer_size[0])).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", "10")).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "transfer-encoding", "")).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).IgnoreAllArguments();
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).IgnoreAllArguments();
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-        .IgnoreArgument(1);
 }
 
 static void setupAllCallBeforeSendHTTPsequenceWithSuccess(HTTP_HEADERS_HANDLE requestHttpHeaders)
@@ -635,9 +622,80 @@ static void setupAllCallBeforeSendHTTPsequenceWithSuccess(HTTP_HEADERS_HANDLE re
 static const IO_OPEN_RESULT* DoworkJobsOpenResult_ReceiveHead = (const IO_OPEN_RESULT*)openresult_ok;
 static const IO_SEND_RESULT* DoworkJobsSendResult_ReceiveHead = (const IO_SEND_RESULT*) sendresult_7ok;
 
-static void PrepareReceiveHead(HTTP_HEADERS_HANDLE requestHttpHeaders, size_t bufferSize[], int doworkReduction[], int countSizes)
+#define TEST_KEEP_ALIVE_ANSWER (const unsigned char*)"HTTP/1.1 200 OK\r\ncontent-length: 0\r\n\r\n"
+
+/* executes a first GET request that leaves the connection open, and prepares the xio simulator for the next request */
+static void executeFirstRequestOnConnection(HTTP_HANDLE httpHandle, HTTP_HEADERS_HANDLE requestHttpHeaders, HTTP_HEADERS_HANDLE responseHttpHeaders, const unsigned char* response, const xio_dowork_job* nextDoworkJobs)
+{
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+
+    DoworkJobsReceivedBuffer = response;
+    DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
+    DoworkJobsReceivedBuffer_counter = 0;
+    DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
+    DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
+    DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
+    HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
+
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        NULL);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+
+    umock_c_reset_all_calls();
+    DoworkJobsReceivedBuffer_counter = 0;
+    DoworkJobs = nextDoworkJobs;
+    DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
+    DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
+    xio_send_shallReturn_counter = 0;
+}
+
+static void setupAllCallReopenHTTPsequence(void)
+{
+    STRICT_EXPECTED_CALL(xio_close(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(xio_setoption(IGNORED_PTR_ARG, "TrustedCerts", TEST_SETOPTIONS_CERTIFICATE))
+        .IgnoreArgument(1)
+        .IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(xio_open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+}
+
+/* the receive wait starts at 1 millisecond and doubles up to 100 milliseconds, for 20 seconds in total */
+static unsigned int NextReceiveWait(unsigned int wait)
+{
+    return ((wait * 2) < 100) ? (wait * 2) : 100;
+}
+
+static void setupReceiveTimeoutSequence(void)
+{
+    unsigned int idleTime = 0;
+    unsigned int wait = 1;
+
+    while (idleTime < 20000)
+    {
+        STRICT_EXPECTED_CALL(ThreadAPI_Sleep(wait));
+        STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        idleTime += wait;
+        wait = NextReceiveWait(wait);
+    }
+}
+
+static void PrepareReceiveHead(HTTP_HEADERS_HANDLE requestHttpHeaders, size_t bufferSize[], int countSizes)
 {
 	int countBuffer;
+    unsigned int wait = 1;
     DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
     DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
 
@@ -646,21 +704,18 @@ static void PrepareReceiveHead(HTTP_HEADERS_HANDLE requestHttpHeaders, size_t bu
 
     for (countBuffer = 0; countBuffer < countSizes; countBuffer++)
     {
-		int countChar;
-        if (countBuffer > 0)
-        {
-            STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-        }
         STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, bufferSize[countBuffer])).IgnoreArgument(1);
-        for (countChar = 0; countChar < doworkReduction[countBuffer]; countChar++)
+        if (bufferSize[countBuffer] == 0)
         {
-            STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-                .IgnoreArgument(1);
+            /* nothing was received, so the response parser did not make any progress */
+            STRICT_EXPECTED_CALL(ThreadAPI_Sleep(wait));
+            wait = NextReceiveWait(wait);
+        }
+        else
+        {
+            wait = 1;
         }
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
     }
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
@@ -711,6 +766,7 @@ TEST_SUITE_INITIALIZE(setsBufferTempSize)
     REGISTER_UMOCK_ALIAS_TYPE(ON_BYTES_RECEIVED, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_ERROR, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
 
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
@@ -1758,6 +1814,48 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__certificate_succeed)
 
 
 
+/*Tests_SRS_HTTPAPI_COMPACT_21_094: [ If the optionName is `OPTION_HTTP_KEEP_ALIVE`, the HTTPAPI_SetOption shall enable or disable the reuse of the connection according to the provided `bool` value. ]*/
+TEST_FUNCTION(HTTPAPI_SetOption__keep_alive_succeed)
+{
+    /// arrange
+    HTTPAPI_RESULT result;
+    bool keepAlive = false;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+
+    /// act
+    result = HTTPAPI_SetOption(httpHandle, OPTION_HTTP_KEEP_ALIVE, &keepAlive);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 2, currentmalloc_call);
+
+    /// cleanup
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 2 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_095: [ If the optionName is `OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT`, the HTTPAPI_SetOption shall store the provided `unsigned int` value as the maximum idle time, in seconds, of a reused connection. ]*/
+TEST_FUNCTION(HTTPAPI_SetOption__keep_alive_idle_timeout_succeed)
+{
+    /// arrange
+    HTTPAPI_RESULT result;
+    unsigned int idleTimeout = 30;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+
+    /// act
+    result = HTTPAPI_SetOption(httpHandle, OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT, &idleTimeout);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 2, currentmalloc_call);
+
+    /// cleanup
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 2 */
+    HTTPAPI_Deinit();
+}
+
 /*Tests_SRS_HTTPAPI_COMPACT_21_059: [ If the handle is NULL, the HTTPAPI_SetOption shall return HTTPAPI_INVALID_ARG. ]*/
 TEST_FUNCTION(HTTPAPI_ExecuteRequest__certificate_NULL_handle_failed)
 {
@@ -1884,6 +1982,29 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__clone_certificate_succeed)
     free((void*)cloneCertificate);
 }
 
+/*Tests_SRS_HTTPAPI_COMPACT_21_072: [ If the HTTPAPI_CloneOption get success setting the option, it shall return HTTPAPI_OK. ]*/
+TEST_FUNCTION(HTTPAPI_CloneOption__keep_alive_idle_timeout_succeed)
+{
+    /// arrange
+    HTTPAPI_RESULT result;
+    unsigned int idleTimeout = 30;
+    unsigned int* cloneIdleTimeout;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(unsigned int)));
+
+    /// act
+    result = HTTPAPI_CloneOption(OPTION_HTTP_KEEP_ALIVE_IDLE_TIMEOUT, &idleTimeout, (const void**)&cloneIdleTimeout);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(int, 30, *cloneIdleTimeout);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, currentmalloc_call);
+
+    /// cleanup
+    free((void*)cloneIdleTimeout);
+}
+
 /*Tests_SRS_HTTPAPI_COMPACT_21_067: [ If the optionName is NULL, the HTTPAPI_CloneOption shall return HTTPAPI_INVALID_ARG. ]*/
 TEST_FUNCTION(HTTPAPI_ExecuteRequest__clone_certificate_NULL_optionName_failed)
 {
@@ -2750,9 +2871,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_not_HTTP_header_failed)
 
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, DoworkJobsReceivedBuffer_size[0])).IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-        .IgnoreArgument(1);
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
 
@@ -2787,7 +2905,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_wrong_URL_header_failed)
     HTTPAPI_RESULT result;
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
-    int doworkReduction[1] = { 0 };
     HTTP_HANDLE httpHandle = createHttpConnection();
     createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
     setHttpCertificate(httpHandle);
@@ -2795,7 +2912,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_wrong_URL_header_failed)
     DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111222 433 555\r\n";
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
     DoworkJobsReceivedBuffer_counter = 0;
-    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, doworkReduction, 1);
+    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, 1);
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
 
     /// act
@@ -2829,7 +2946,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_header_with_no_statusCode_failed)
     HTTPAPI_RESULT result;
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
-    int doworkReduction[1] = { 0 };
     HTTP_HANDLE httpHandle = createHttpConnection();
     createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
     setHttpCertificate(httpHandle);
@@ -2837,7 +2953,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_header_with_no_statusCode_failed)
     DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222\r\n";
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
     DoworkJobsReceivedBuffer_counter = 0;
-    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, doworkReduction, 1);
+    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, 1);
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
 
     /// act
@@ -2869,7 +2985,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_header_incomplete_failed)
     /// arrange
     unsigned int statusCode;
     HTTPAPI_RESULT result;
-    int doworkReduction[1] = { 0 };
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
@@ -2879,7 +2994,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_header_incomplete_failed)
     DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111\r\n";
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
     DoworkJobsReceivedBuffer_counter = 0;
-    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, doworkReduction, 1);
+    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, 1);
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
 
     /// act
@@ -2911,7 +3026,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_multi_header_with_size_0_and_error
     /// arrange
     unsigned int statusCode;
     HTTPAPI_RESULT result;
-    int doworkReduction[2] = { 0, 0 };
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
@@ -2922,7 +3036,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__on_read_multi_header_with_size_0_and_error
     DoworkJobsReceivedBuffer_size[0] = 0;
     DoworkJobsReceivedBuffer_size[1] = strlen((const char*)DoworkJobsReceivedBuffer);
     DoworkJobsReceivedBuffer_counter = 0;
-    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, doworkReduction, 2);
+    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, 2);
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_rre;
 
     /// act
@@ -2955,7 +3069,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__read_huge_header_failed)
 	HTTP_HANDLE httpHandle;
     unsigned int statusCode;
     HTTPAPI_RESULT result;
-    int doworkReduction[1] = { 0 };
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     size_t i;
@@ -2977,7 +3090,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__read_huge_header_failed)
     DoworkJobsReceivedBuffer = (const unsigned char*)hugeBuffer;
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
     DoworkJobsReceivedBuffer_counter = 0;
-    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, doworkReduction, 1);
+    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, 1);
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
 
     /// act
@@ -3009,7 +3122,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__content_length_without_value_failed)
     /// arrange
     unsigned int statusCode;
     HTTPAPI_RESULT result;
-    int doworkReduction[1] = { 1 };
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
@@ -3018,7 +3130,7 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__content_length_without_value_failed)
 
     DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 433 555\r\ncontent-length:\r\n\r\n";
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
-    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, doworkReduction, 1);
+    PrepareReceiveHead(requestHttpHeaders, DoworkJobsReceivedBuffer_size, 1);
     DoworkJobsReceivedBuffer_counter = 0;
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
 
@@ -3862,19 +3974,6 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_no_responseHeadersHandle_s
         .IgnoreAllArguments();
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, DoworkJobsReceivedBuffer_size[0])).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-        .IgnoreArgument(1);
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
 
@@ -3951,22 +4050,20 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_responseContent_NULL_succe
     HTTPAPI_Deinit();
 }
 
-/*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_content_failed)
+/*Tests_SRS_HTTPAPI_COMPACT_21_088: [ If the xio delivered bytes during the last dowork, the HTTPAPI_ExecuteRequest shall call the xio dowork again without waiting. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_089: [ The HTTPAPI_ExecuteRequest shall parse the response incrementally, as the bytes are delivered by the xio, including bytes received while the request is still being sent. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_chunked_response_in_one_receive_succeed)
 {
     /// arrange
-	int i;
     unsigned int statusCode;
     HTTPAPI_RESULT result;
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
     createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
-    setHttpCertificate(httpHandle);
 
-    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 433 555\r\ncontent-length:10\r\ntransfer-encoding:\r\n\r\n0123";
+    setHttpCertificate(httpHandle);
+    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n";
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
     DoworkJobsReceivedBuffer_counter = 0;
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
@@ -3975,33 +4072,9 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_content_fai
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
     setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, DoworkJobsReceivedBuffer_size[0])).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", "10")).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "transfer-encoding", "")).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-
-    for (i = 0; i < 200; i++)
-    {
-        STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-        STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
-    }
-
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "transfer-encoding", " chunked")).IgnoreArgument(1);
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
 
@@ -4015,10 +4088,11 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_content_fai
         TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
         &statusCode,
         responseHttpHeaders,
-        TestBufferHandle);
+        NULL);
 
     /// assert
-    ASSERT_ARE_EQUAL(int, HTTPAPI_READ_DATA_FAILED, result);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(int, 200, statusCode);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
 
@@ -4028,22 +4102,19 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_content_fai
     HTTPAPI_Deinit();
 }
 
-/*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_parameter_failed)
+/*Tests_SRS_HTTPAPI_COMPACT_21_090: [ If the response contains the header `Connection: close`, the HTTPAPI_ExecuteRequest shall close the connection before the next request. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_connection_close_response_succeed)
 {
     /// arrange
-	int i;
     unsigned int statusCode;
     HTTPAPI_RESULT result;
     HTTP_HEADERS_HANDLE requestHttpHeaders;
     HTTP_HEADERS_HANDLE responseHttpHeaders;
     HTTP_HANDLE httpHandle = createHttpConnection();
     createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
-    setHttpCertificate(httpHandle);
 
-    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 433 555\r\ncontent-length:10\r\ntransfer-enc";
+    setHttpCertificate(httpHandle);
+    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/1.1 200 OK\r\nconnection: close\r\ncontent-length: 0\r\n\r\n";
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
     DoworkJobsReceivedBuffer_counter = 0;
     DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
@@ -4052,27 +4123,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_parameter_f
 
     setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
     setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, DoworkJobsReceivedBuffer_size[0])).IgnoreArgument(1);
-
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", "10")).IgnoreArgument(1);
-
-    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-        .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-        .IgnoreArgument(1);
-
-    for (i = 0; i < 200; i++)
-    {
-        STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-        STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
-    }
-
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "connection", " close")).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", " 0")).IgnoreArgument(1);
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
 
@@ -4086,10 +4140,11 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_parameter_f
         TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
         &statusCode,
         responseHttpHeaders,
-        TestBufferHandle);
+        NULL);
 
     /// assert
-    ASSERT_ARE_EQUAL(int, HTTPAPI_READ_DATA_FAILED, result);
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(int, 200, statusCode);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
 
@@ -4099,13 +4154,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_parameter_f
     HTTPAPI_Deinit();
 }
 
-/*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
-/*Tests_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
-TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_header_failed)
+/*Tests_SRS_HTTPAPI_COMPACT_21_090: [ If the response contains the header `Connection: close`, the HTTPAPI_ExecuteRequest shall close the connection before the next request. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_after_connection_close_response_reopens_connection_succeed)
 {
     /// arrange
-	int i;
     unsigned int statusCode;
     HTTPAPI_RESULT result;
     HTTP_HEADERS_HANDLE requestHttpHeaders;
@@ -4113,31 +4165,491 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_header_fail
     HTTP_HANDLE httpHandle = createHttpConnection();
     createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
     setHttpCertificate(httpHandle);
-
-    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 ";
+    executeFirstRequestOnConnection(httpHandle, requestHttpHeaders, responseHttpHeaders, (const unsigned char*)"HTTP/1.1 200 OK\r\nconnection: close\r\ncontent-length: 0\r\n\r\n", (const xio_dowork_job*)doworkjob_o_re);
+    DoworkJobsReceivedBuffer = TEST_KEEP_ALIVE_ANSWER;
     DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
-    DoworkJobsReceivedBuffer_counter = 0;
-    DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
-    DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
-    DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
 
-    setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(requestHttpHeaders, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    setupAllCallReopenHTTPsequence();
     setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
-
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_NUM_ARG, DoworkJobsReceivedBuffer_size[0])).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", " 0")).IgnoreArgument(1);
 
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_091: [ If the response contains a `Keep-Alive` header with a `timeout` parameter, the HTTPAPI_ExecuteRequest shall not reuse the connection once it was idle for that many seconds. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_reuses_kept_alive_connection_succeed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+    executeFirstRequestOnConnection(httpHandle, requestHttpHeaders, responseHttpHeaders, (const unsigned char*)"HTTP/1.1 200 OK\r\nkeep-alive: timeout=5\r\ncontent-length: 0\r\n\r\n", (const xio_dowork_job*)doworkjob_re);
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(requestHttpHeaders, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(get_difftime(IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .IgnoreAllArguments()
+        .SetReturn(4.0);
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "keep-alive", " timeout=5")).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", " 0")).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(get_time(NULL));
 
-    for (i = 0; i < 200; i++)
-    {
-        STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
-        STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
-    }
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_091: [ If the response contains a `Keep-Alive` header with a `timeout` parameter, the HTTPAPI_ExecuteRequest shall not reuse the connection once it was idle for that many seconds. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_after_keep_alive_timeout_reopens_connection_succeed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+    executeFirstRequestOnConnection(httpHandle, requestHttpHeaders, responseHttpHeaders, (const unsigned char*)"HTTP/1.1 200 OK\r\nkeep-alive: timeout=5\r\ncontent-length: 0\r\n\r\n", (const xio_dowork_job*)doworkjob_o_re);
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(requestHttpHeaders, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(get_difftime(IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .IgnoreAllArguments()
+        .SetReturn(5.0);
+    setupAllCallReopenHTTPsequence();
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "keep-alive", " timeout=5")).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", " 0")).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(get_time(NULL));
+
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_093: [ If a reused connection fails to send the request or to receive the response before any byte of the response arrived, the HTTPAPI_ExecuteRequest shall close it and retry the request once on a new connection. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_098: [ If the request was completely sent, the HTTPAPI_ExecuteRequest shall only retry it when the request type is `GET` or `DELETE`. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_get_request_retries_on_new_connection_when_reused_connection_fails_to_receive_succeed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+    executeFirstRequestOnConnection(httpHandle, requestHttpHeaders, responseHttpHeaders, TEST_KEEP_ALIVE_ANSWER, (const xio_dowork_job*)doworkjob_e_o_re);
+    xio_send_shallReturn = (const int*)xio_send_14x0;
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(requestHttpHeaders, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    setupAllCallReopenHTTPsequence();
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", " 0")).IgnoreArgument(1);
+
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_098: [ If the request was completely sent, the HTTPAPI_ExecuteRequest shall only retry it when the request type is `GET` or `DELETE`. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_post_request_does_not_retry_when_reused_connection_fails_to_receive_failed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+    executeFirstRequestOnConnection(httpHandle, requestHttpHeaders, responseHttpHeaders, TEST_KEEP_ALIVE_ANSWER, (const xio_dowork_job*)doworkjob_e_o_re);
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(requestHttpHeaders, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_POST,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_READ_DATA_FAILED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_093: [ If a reused connection fails to send the request or to receive the response before any byte of the response arrived, the HTTPAPI_ExecuteRequest shall close it and retry the request once on a new connection. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_098: [ If the request was completely sent, the HTTPAPI_ExecuteRequest shall only retry it when the request type is `GET` or `DELETE`. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_post_request_retries_on_new_connection_when_reused_connection_fails_to_send_succeed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+    executeFirstRequestOnConnection(httpHandle, requestHttpHeaders, responseHttpHeaders, TEST_KEEP_ALIVE_ANSWER, (const xio_dowork_job*)doworkjob_o_re);
+    xio_send_shallReturn = (const int*)xio_send_e_7x0;
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(requestHttpHeaders, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(xio_send(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreAllArguments();
+    setupAllCallReopenHTTPsequence();
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", " 0")).IgnoreArgument(1);
+
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_POST,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_096: [ While waiting for the response, the HTTPAPI_ExecuteRequest shall wait 1 millisecond after a dowork that delivered no bytes, and double the wait after each further such dowork, up to 100 milliseconds. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_content_failed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+
+    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 433 555\r\ncontent-length:10\r\ntransfer-encoding:\r\n\r\n0123";
+    DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
+    DoworkJobsReceivedBuffer_counter = 0;
+    DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
+    DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
+    DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
+
+    setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", "10")).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "transfer-encoding", "")).IgnoreArgument(1);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+
+    setupReceiveTimeoutSequence();
+
+    HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
+
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        TestBufferHandle);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_READ_DATA_FAILED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_096: [ While waiting for the response, the HTTPAPI_ExecuteRequest shall wait 1 millisecond after a dowork that delivered no bytes, and double the wait after each further such dowork, up to 100 milliseconds. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_parameter_failed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+
+    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 433 555\r\ncontent-length:10\r\ntransfer-enc";
+    DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
+    DoworkJobsReceivedBuffer_counter = 0;
+    DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
+    DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
+    DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
+
+    setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_AddHeaderNameValuePair(IGNORED_PTR_ARG, "content-length", "10")).IgnoreArgument(1);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+
+    setupReceiveTimeoutSequence();
+
+
+    HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
+
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        TestBufferHandle);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_READ_DATA_FAILED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_081: [ The HTTPAPI_ExecuteRequest shall try to read the message with the response up to 20 seconds. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_082: [ If the HTTPAPI_ExecuteRequest retries 20 seconds to receive the message without success, it shall fail and return HTTPAPI_READ_DATA_FAILED. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_096: [ While waiting for the response, the HTTPAPI_ExecuteRequest shall wait 1 millisecond after a dowork that delivered no bytes, and double the wait after each further such dowork, up to 100 milliseconds. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_with_truncated_header_failed)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+
+    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 ";
+    DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
+    DoworkJobsReceivedBuffer_counter = 0;
+    DoworkJobs = (const xio_dowork_job*)doworkjob_o_re;
+    DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
+    DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
+
+    setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+
+    setupReceiveTimeoutSequence();
+
+
+    HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
+
+    /// act
+    result = HTTPAPI_ExecuteRequest(
+        httpHandle,
+        HTTPAPI_REQUEST_GET,
+        TEST_EXECUTE_REQUEST_RELATIVE_PATH,
+        requestHttpHeaders,
+        TEST_EXECUTE_REQUEST_CONTENT,
+        TEST_EXECUTE_REQUEST_CONTENT_LENGTH,
+        &statusCode,
+        responseHttpHeaders,
+        TestBufferHandle);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_READ_DATA_FAILED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 5, currentmalloc_call);
+
+    /// cleanup
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders); /* currentmalloc_call -= 2 */
+    HTTPAPI_CloseConnection(httpHandle);	/* currentmalloc_call -= 3 */
+    HTTPAPI_Deinit();
+}
+
+/*Tests_SRS_HTTPAPI_COMPACT_21_096: [ While waiting for the response, the HTTPAPI_ExecuteRequest shall wait 1 millisecond after a dowork that delivered no bytes, and double the wait after each further such dowork, up to 100 milliseconds. ]*/
+/*Tests_SRS_HTTPAPI_COMPACT_21_097: [ Once the xio delivered bytes, the HTTPAPI_ExecuteRequest shall restart both the wait and the 20 seconds receive timeout. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_received_bytes_restart_receive_wait)
+{
+    /// arrange
+    unsigned int statusCode;
+    HTTPAPI_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    HTTP_HANDLE httpHandle = createHttpConnection();
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    setHttpCertificate(httpHandle);
+
+    DoworkJobsReceivedBuffer = (const unsigned char*)"HTTP/111.222 ";
+    DoworkJobsReceivedBuffer_size[0] = strlen((const char*)DoworkJobsReceivedBuffer);
+    DoworkJobsReceivedBuffer_counter = 0;
+    DoworkJobs = (const xio_dowork_job*)doworkjob_o_2none_re;
+    DoworkJobsOpenResult = DoworkJobsOpenResult_ReceiveHead;
+    DoworkJobsSendResult = DoworkJobsSendResult_ReceiveHead;
+
+    setupAllCallBeforeOpenHTTPsequence(requestHttpHeaders, 1, false);
+    setupAllCallBeforeSendHTTPsequenceWithSuccess(requestHttpHeaders);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(1));
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(2));
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
 
+    setupReceiveTimeoutSequence();
 
     HTTPHeaders_GetHeader_shallReturn = HTTP_HEADERS_OK;
 
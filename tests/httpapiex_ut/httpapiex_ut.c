@@ -77,6 +77,9 @@ void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/gb_rand.h"
 
 static size_t currentHTTPAPI_SaveOption_call;
 static size_t whenShallHTTPAPI_SaveOption_fail;
@@ -193,6 +196,16 @@ void my_HTTPAPI_CloseConnection(HTTP_HANDLE handle)
     free(handle);
 }
 
+#define TEST_TICK_COUNTER_HANDLE (TICK_COUNTER_HANDLE)0x4444
+static tickcounter_ms_t g_current_ms;
+
+int my_tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_t* current_ms)
+{
+    (void)tick_counter;
+    *current_ms = g_current_ms;
+    return 0;
+}
+
 HTTPAPI_RESULT my_HTTPAPI_CloneOption(const char* optionName, const void* value, const void** savedValue)
 {
     HTTPAPI_RESULT result2;
@@ -280,6 +293,17 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 TEST_DEFINE_ENUM_TYPE(HTTPAPI_REQUEST_TYPE, HTTPAPI_REQUEST_TYPE_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPI_REQUEST_TYPE, HTTPAPI_REQUEST_TYPE_VALUES);
 
+static size_t g_on_execute_complete_calls;
+static HTTPAPIEX_RESULT g_on_execute_complete_result;
+
+static void test_on_execute_complete(void* context, HTTPAPIEX_RESULT result, unsigned int statusCode)
+{
+    (void)context;
+    (void)statusCode;
+    g_on_execute_complete_calls++;
+    g_on_execute_complete_result = result;
+}
+
 #define TEST_HOSTNAME "aaa"
 #define TEST_RELATIVE_PATH "nothing/to/see/here/devices"
 #define TEST_REQUEST_HTTP_HEADERS (HTTP_HEADERS_HANDLE) 0x42
@@ -444,6 +468,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HEADERS_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(const unsigned char*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
@@ -478,6 +503,9 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(VECTOR_size, real_VECTOR_size);
     REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, real_mallocAndStrcpy_s);
     REGISTER_GLOBAL_MOCK_HOOK(size_tToString, real_size_tToString);
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_create, TEST_TICK_COUNTER_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_get_current_ms, my_tickcounter_get_current_ms);
+    REGISTER_GLOBAL_MOCK_RETURN(gb_rand, 0);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -520,6 +548,10 @@ TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
     currentHTTPAPI_Init_call = 0;
     for (i = 0; i<N_MAX_FAILS; i++) whenShallHTTPAPI_Init_fail[i] = 0;
 
+    g_current_ms = 0;
+    g_on_execute_complete_calls = 0;
+    g_on_execute_complete_result = HTTPAPIEX_ERROR;
+
     umock_c_reset_all_calls();
 }
 
@@ -3339,4 +3371,364 @@ TEST_FUNCTION(HTTPAPIEX_Destroy_with_NULL_argument_does_nothing)
     ///destroy
 }
 
+
+/*Tests_SRS_HTTPAPIEX_02_045: [If parameter handle or retryPolicy is NULL, or if retryPolicy has max_attempts 0, a max_delay_ms lower than initial_delay_ms or a jitter_percent greater than 100, then HTTPAPIEX_SetRetryPolicy shall return HTTPAPIEX_INVALID_ARG.]*/
+TEST_FUNCTION(HTTPAPIEX_SetRetryPolicy_with_NULL_handle_fails)
+{
+    /// arrange
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 3, 100, 1000, 50, 0 };
+    HTTPAPIEX_RESULT result;
+
+    /// act
+    result = HTTPAPIEX_SetRetryPolicy(NULL, &retryPolicy);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_02_045: [If parameter handle or retryPolicy is NULL, or if retryPolicy has max_attempts 0, a max_delay_ms lower than initial_delay_ms or a jitter_percent greater than 100, then HTTPAPIEX_SetRetryPolicy shall return HTTPAPIEX_INVALID_ARG.]*/
+TEST_FUNCTION(HTTPAPIEX_SetRetryPolicy_with_invalid_policy_fails)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RETRY_POLICY noAttempts = { 0, 100, 1000, 50, 0 };
+    HTTPAPIEX_RETRY_POLICY maxDelayTooLow = { 3, 100, 10, 50, 0 };
+    HTTPAPIEX_RETRY_POLICY jitterTooHigh = { 3, 100, 1000, 101, 0 };
+    umock_c_reset_all_calls();
+
+    /// act
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SetRetryPolicy(httpapiexhandle, NULL));
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &noAttempts));
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &maxDelayTooLow));
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &jitterTooHigh));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_046: [HTTPAPIEX_SetRetryPolicy shall create a tick counter if none exists.]*/
+/*Tests_SRS_HTTPAPIEX_02_053: [Otherwise HTTPAPIEX_SetRetryPolicy shall copy retryPolicy and return HTTPAPIEX_OK.]*/
+TEST_FUNCTION(HTTPAPIEX_SetRetryPolicy_succeeds)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 3, 100, 1000, 50, 0 };
+    HTTPAPIEX_RESULT result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_create());
+
+    /// act
+    result = HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &retryPolicy);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_047: [If creating the tick counter fails then HTTPAPIEX_SetRetryPolicy shall return HTTPAPIEX_ERROR.]*/
+TEST_FUNCTION(HTTPAPIEX_SetRetryPolicy_fails_when_tickcounter_create_fails)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 3, 100, 1000, 50, 0 };
+    HTTPAPIEX_RESULT result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_create())
+        .SetReturn(NULL);
+
+    /// act
+    result = HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &retryPolicy);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_048: [If the recovery sequence fails, HTTPAPIEX_ExecuteRequest shall wait for the delay given by the retry policy and start it again.]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_retry_policy_waits_before_retrying)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 2, 100, 1000, 0, 0 };
+    HTTPAPIEX_RESULT result;
+
+    unsigned int httpStatusCode;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &retryPolicy);
+    umock_c_reset_all_calls();
+
+    setupAllCallBeforeHTTPsequence();
+    whenShallHTTPAPI_Init_fail[0] = 1;
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
+
+    setupAllCallBeforeHTTPsequence();
+    setupAllCallForHTTPsequence(TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, responseHttpHeaders, responseHttpBody);
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, &httpStatusCode, responseHttpHeaders, responseHttpBody);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_049: [No more than max_attempts attempts shall be made.]*/
+/*Tests_SRS_HTTPAPIEX_02_050: [The delay before an attempt shall be initial_delay_ms doubled for every attempt after the second one, and shall not exceed max_delay_ms.]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_retry_policy_doubles_the_delay_up_to_max_delay)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 4, 100, 300, 0, 0 };
+    HTTPAPIEX_RESULT result;
+
+    unsigned int httpStatusCode;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &retryPolicy);
+    umock_c_reset_all_calls();
+
+    whenShallHTTPAPI_Init_fail[0] = 1;
+    whenShallHTTPAPI_Init_fail[1] = 2;
+    whenShallHTTPAPI_Init_fail[2] = 3;
+    whenShallHTTPAPI_Init_fail[3] = 4;
+    setupAllCallBeforeHTTPsequence();
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
+    setupAllCallBeforeHTTPsequence();
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(200));
+    setupAllCallBeforeHTTPsequence();
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(300));
+    setupAllCallBeforeHTTPsequence();
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, &httpStatusCode, responseHttpHeaders, responseHttpBody);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_RECOVERYFAILED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_052: [If deadline_ms is not 0, no attempt shall start later than deadline_ms milliseconds after the first one.]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_retry_policy_does_not_retry_past_the_deadline)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 3, 100, 1000, 0, 50 };
+    HTTPAPIEX_RESULT result;
+
+    unsigned int httpStatusCode;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &retryPolicy);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    setupAllCallBeforeHTTPsequence();
+    whenShallHTTPAPI_Init_fail[0] = 1;
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, &httpStatusCode, responseHttpHeaders, responseHttpBody);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_RECOVERYFAILED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_054: [If parameter handle or on_execute_complete is NULL, or if requestType is not valid, then HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_INVALID_ARG.]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequestAsync_with_NULL_on_execute_complete_fails)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RESULT result;
+    umock_c_reset_all_calls();
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequestAsync(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, TEST_REQUEST_HTTP_HEADERS, TEST_REQUEST_BODY, TEST_RESPONSE_HTTP_HEADERS, TEST_RESPONSE_BODY, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_055: [If a request is already pending then HTTPAPIEX_ExecuteRequestAsync shall return HTTPAPIEX_ERROR.]*/
+/*Tests_SRS_HTTPAPIEX_02_064: [If a request is pending, HTTPAPIEX_Destroy shall call its on_execute_complete with HTTPAPIEX_ERROR.]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequestAsync_with_a_pending_request_fails)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RESULT result;
+    (void)HTTPAPIEX_ExecuteRequestAsync(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, TEST_REQUEST_HTTP_HEADERS, TEST_REQUEST_BODY, TEST_RESPONSE_HTTP_HEADERS, TEST_RESPONSE_BODY, test_on_execute_complete, NULL);
+    umock_c_reset_all_calls();
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequestAsync(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, TEST_REQUEST_HTTP_HEADERS, TEST_REQUEST_BODY, TEST_RESPONSE_HTTP_HEADERS, TEST_RESPONSE_BODY, test_on_execute_complete, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, g_on_execute_complete_calls);
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+    ASSERT_ARE_EQUAL(size_t, 1, g_on_execute_complete_calls);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_ERROR, g_on_execute_complete_result);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_056: [HTTPAPIEX_ExecuteRequestAsync shall create a tick counter if none exists.]*/
+/*Tests_SRS_HTTPAPIEX_02_057: [HTTPAPIEX_ExecuteRequestAsync shall save a copy of relativePath and the other parameters, and shall schedule the first attempt immediately.]*/
+/*Tests_SRS_HTTPAPIEX_02_061: [When the next attempt is due, HTTPAPIEX_DoWork shall execute the request the same way HTTPAPIEX_ExecuteRequest executes one attempt.]*/
+/*Tests_SRS_HTTPAPIEX_02_063: [Otherwise HTTPAPIEX_DoWork shall call on_execute_complete with the result of the attempt and the HTTP status code. If getting the current time fails, HTTPAPIEX_DoWork shall complete the request with HTTPAPIEX_ERROR.]*/
+TEST_FUNCTION(HTTPAPIEX_DoWork_executes_the_pending_request_succeeds)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RESULT result;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_create());
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_RELATIVE_PATH))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequestAsync(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, responseHttpHeaders, responseHttpBody, test_on_execute_complete, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, g_on_execute_complete_calls);
+
+    /// arrange
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    setupAllCallBeforeHTTPsequence();
+    setupAllCallForHTTPsequence(TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, responseHttpHeaders, responseHttpBody);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+
+    /// act
+    HTTPAPIEX_DoWork(httpapiexhandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, g_on_execute_complete_calls);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, g_on_execute_complete_result);
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_02_060: [HTTPAPIEX_DoWork shall not do anything before the next attempt of the pending request is due.]*/
+/*Tests_SRS_HTTPAPIEX_02_062: [If the attempt failed and the retry policy allows another one, HTTPAPIEX_DoWork shall schedule it after the delay given by the retry policy.]*/
+TEST_FUNCTION(HTTPAPIEX_DoWork_does_not_retry_before_the_delay_elapsed)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 2, 1000, 1000, 0, 0 };
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_SetRetryPolicy(httpapiexhandle, &retryPolicy);
+    (void)HTTPAPIEX_ExecuteRequestAsync(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, responseHttpHeaders, responseHttpBody, test_on_execute_complete, NULL);
+    whenShallHTTPAPI_Init_fail[0] = 1;
+    HTTPAPIEX_DoWork(httpapiexhandle);
+    g_current_ms = 999;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    /// act
+    HTTPAPIEX_DoWork(httpapiexhandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, g_on_execute_complete_calls);
+
+    /// arrange
+    g_current_ms = 1000;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    setupAllCallBeforeHTTPsequence();
+    setupAllCallForHTTPsequence(TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, responseHttpHeaders, responseHttpBody);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+
+    /// act
+    HTTPAPIEX_DoWork(httpapiexhandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, g_on_execute_complete_calls);
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, g_on_execute_complete_result);
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
 END_TEST_SUITE(httpapiex_unittests)
@@ -0,0 +1,734 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#endif
+
+void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/vector.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/httpapiex.h"
+
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/httpapiexpool.h"
+
+TEST_DEFINE_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+
+#define TEST_TICK_COUNTER_HANDLE (TICK_COUNTER_HANDLE)0x4242
+#define TEST_LOCK_HANDLE (LOCK_HANDLE)0x4243
+#define TEST_HOSTNAME "aaa.net"
+#define TEST_OTHER_HOSTNAME "bbb.net"
+#define TEST_IDLE_TIMEOUT_MS ((tickcounter_ms_t)1000)
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static tickcounter_ms_t g_current_ms;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    VECTOR_HANDLE real_VECTOR_create(size_t elementSize);
+    void real_VECTOR_destroy(VECTOR_HANDLE handle);
+    int real_VECTOR_push_back(VECTOR_HANDLE handle, const void* elements, size_t numElements);
+    void real_VECTOR_erase(VECTOR_HANDLE handle, void* elements, size_t numElements);
+    void* real_VECTOR_element(const VECTOR_HANDLE handle, size_t index);
+    void* real_VECTOR_find_if(const VECTOR_HANDLE handle, PREDICATE_FUNCTION pred, const void* value);
+    size_t real_VECTOR_size(const VECTOR_HANDLE handle);
+
+    int real_mallocAndStrcpy_s(char** destination, const char* source);
+
+#ifdef __cplusplus
+}
+#endif
+
+static HTTPAPIEX_HANDLE my_HTTPAPIEX_Create(const char* hostName)
+{
+    (void)hostName;
+    return (HTTPAPIEX_HANDLE)malloc(1);
+}
+
+static void my_HTTPAPIEX_Destroy(HTTPAPIEX_HANDLE handle)
+{
+    free(handle);
+}
+
+static int my_tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_t* current_ms)
+{
+    (void)tick_counter;
+    *current_ms = g_current_ms;
+    return 0;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+/*expectations of a checkout that creates a handle, in a pool with no idle timeout that already has entryCount handles*/
+static void setup_checkout_new_handle_expectations(const char* hostName, size_t entryCount)
+{
+    size_t i;
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    for (i = 0; i < entryCount; i++)
+    {
+        STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, i));
+    }
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, hostName));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create(hostName));
+    STRICT_EXPECTED_CALL(VECTOR_push_back(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+}
+
+BEGIN_TEST_SUITE(httpapiexpool_unittests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    int result;
+
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    result = umocktypes_charptr_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    REGISTER_TYPE(LOCK_RESULT, LOCK_RESULT);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(HTTPAPIEX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(VECTOR_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const VECTOR_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PREDICATE_FUNCTION, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+    REGISTER_GLOBAL_MOCK_HOOK(VECTOR_create, real_VECTOR_create);
+    REGISTER_GLOBAL_MOCK_HOOK(VECTOR_destroy, real_VECTOR_destroy);
+    REGISTER_GLOBAL_MOCK_HOOK(VECTOR_push_back, real_VECTOR_push_back);
+    REGISTER_GLOBAL_MOCK_HOOK(VECTOR_erase, real_VECTOR_erase);
+    REGISTER_GLOBAL_MOCK_HOOK(VECTOR_element, real_VECTOR_element);
+    REGISTER_GLOBAL_MOCK_HOOK(VECTOR_find_if, real_VECTOR_find_if);
+    REGISTER_GLOBAL_MOCK_HOOK(VECTOR_size, real_VECTOR_size);
+    REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, real_mallocAndStrcpy_s);
+    REGISTER_GLOBAL_MOCK_HOOK(HTTPAPIEX_Create, my_HTTPAPIEX_Create);
+    REGISTER_GLOBAL_MOCK_HOOK(HTTPAPIEX_Destroy, my_HTTPAPIEX_Destroy);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_get_current_ms, my_tickcounter_get_current_ms);
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_create, TEST_TICK_COUNTER_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Init, TEST_LOCK_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Deinit, LOCK_OK);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+    g_current_ms = 0;
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_001: [If maxHandlesPerHost is 0 then HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Create_with_0_maxHandlesPerHost_fails)
+{
+    ///arrange
+
+    ///act
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(0, TEST_IDLE_TIMEOUT_MS);
+
+    ///assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_002: [HTTPAPIEX_POOL_Create shall create a tick counter, a lock and an empty set of pooled handles.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Create_succeeds)
+{
+    ///arrange
+    HTTPAPIEX_POOL_HANDLE pool;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
+    STRICT_EXPECTED_CALL(Lock_Init());
+    STRICT_EXPECTED_CALL(VECTOR_create(IGNORED_NUM_ARG));
+
+    ///act
+    pool = HTTPAPIEX_POOL_Create(2, TEST_IDLE_TIMEOUT_MS);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_003: [If any failure occurs, HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Create_fails_when_Lock_Init_fails)
+{
+    ///arrange
+    HTTPAPIEX_POOL_HANDLE pool;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
+    STRICT_EXPECTED_CALL(Lock_Init())
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    ///act
+    pool = HTTPAPIEX_POOL_Create(2, TEST_IDLE_TIMEOUT_MS);
+
+    ///assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_003: [If any failure occurs, HTTPAPIEX_POOL_Create shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Create_fails_when_VECTOR_create_fails)
+{
+    ///arrange
+    HTTPAPIEX_POOL_HANDLE pool;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
+    STRICT_EXPECTED_CALL(Lock_Init());
+    STRICT_EXPECTED_CALL(VECTOR_create(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    ///act
+    pool = HTTPAPIEX_POOL_Create(2, TEST_IDLE_TIMEOUT_MS);
+
+    ///assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_004: [If pool is NULL then HTTPAPIEX_POOL_Destroy shall do nothing.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Destroy_with_NULL_pool_does_nothing)
+{
+    ///arrange
+
+    ///act
+    HTTPAPIEX_POOL_Destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_005: [HTTPAPIEX_POOL_Destroy shall destroy all the pooled handles and free all the resources used by the pool.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Destroy_destroys_the_pooled_handles)
+{
+    ///arrange
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(2, 0);
+    HTTPAPIEX_HANDLE handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    HTTPAPIEX_POOL_Checkin(pool, handle, true);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(handle));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*the host name*/
+    STRICT_EXPECTED_CALL(VECTOR_destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    ///act
+    HTTPAPIEX_POOL_Destroy(pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_006: [If pool or hostName is NULL then HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_with_NULL_pool_fails)
+{
+    ///arrange
+
+    ///act
+    HTTPAPIEX_HANDLE handle = HTTPAPIEX_POOL_Checkout(NULL, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_006: [If pool or hostName is NULL then HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_with_NULL_hostName_fails)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(2, 0);
+    umock_c_reset_all_calls();
+
+    ///act
+    handle = HTTPAPIEX_POOL_Checkout(pool, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_009: [Otherwise HTTPAPIEX_POOL_Checkout shall create a new handle by calling HTTPAPIEX_Create, add it to the pool as checked out and return it.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_creates_a_handle_when_none_is_pooled)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(2, 0);
+    umock_c_reset_all_calls();
+
+    setup_checkout_new_handle_expectations(TEST_HOSTNAME, 0);
+
+    ///act
+    handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_009: [Otherwise HTTPAPIEX_POOL_Checkout shall create a new handle by calling HTTPAPIEX_Create, add it to the pool as checked out and return it.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_creates_a_second_handle_while_the_first_is_checked_out)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle1;
+    HTTPAPIEX_HANDLE handle2;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(2, 0);
+    handle1 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    setup_checkout_new_handle_expectations(TEST_HOSTNAME, 1);
+
+    ///act
+    handle2 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle2);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, handle1, handle2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle1, true);
+    HTTPAPIEX_POOL_Checkin(pool, handle2, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_008: [If a handle for hostName is checked in, HTTPAPIEX_POOL_Checkout shall check out and return the most recently checked in one.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_reuses_a_checked_in_handle)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle1;
+    HTTPAPIEX_HANDLE handle2;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(2, 0);
+    handle1 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    HTTPAPIEX_POOL_Checkin(pool, handle1, true);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    ///act
+    handle2 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, handle1, handle2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle2, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_008: [If a handle for hostName is checked in, HTTPAPIEX_POOL_Checkout shall check out and return the most recently checked in one.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_returns_the_most_recently_checked_in_handle)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle1;
+    HTTPAPIEX_HANDLE handle2;
+    HTTPAPIEX_HANDLE handle3;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(2, 0);
+    handle1 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    handle2 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    g_current_ms = 10;
+    HTTPAPIEX_POOL_Checkin(pool, handle2, true);
+    g_current_ms = 20;
+    HTTPAPIEX_POOL_Checkin(pool, handle1, true);
+    umock_c_reset_all_calls();
+
+    ///act
+    handle3 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, handle1, handle3);
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle3, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_009: [Otherwise HTTPAPIEX_POOL_Checkout shall create a new handle by calling HTTPAPIEX_Create, add it to the pool as checked out and return it.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_does_not_return_a_handle_of_another_host)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle1;
+    HTTPAPIEX_HANDLE handle2;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    handle1 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    HTTPAPIEX_POOL_Checkin(pool, handle1, true);
+    umock_c_reset_all_calls();
+
+    setup_checkout_new_handle_expectations(TEST_OTHER_HOSTNAME, 1);
+
+    ///act
+    handle2 = HTTPAPIEX_POOL_Checkout(pool, TEST_OTHER_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle2);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, handle1, handle2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle2, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_010: [If maxHandlesPerHost handles for hostName are already checked out, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_fails_when_all_the_handles_of_the_host_are_checked_out)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle1;
+    HTTPAPIEX_HANDLE handle2;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    handle1 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    ///act
+    handle2 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NULL(handle2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle1, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_011: [If any failure occurs, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_fails_when_HTTPAPIEX_Create_fails)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_HOSTNAME));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create(TEST_HOSTNAME))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    ///act
+    handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_011: [If any failure occurs, HTTPAPIEX_POOL_Checkout shall fail and return NULL.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_fails_when_VECTOR_push_back_fails)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_HOSTNAME));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create(TEST_HOSTNAME));
+    STRICT_EXPECTED_CALL(VECTOR_push_back(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1))
+        .SetReturn(__FAILURE__);
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    ///act
+    handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_007: [HTTPAPIEX_POOL_Checkout shall first evict the idle handles as HTTPAPIEX_POOL_EvictIdle does.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkout_does_not_return_a_handle_that_was_idle_for_too_long)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle1;
+    HTTPAPIEX_HANDLE handle2;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, TEST_IDLE_TIMEOUT_MS);
+    handle1 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    HTTPAPIEX_POOL_Checkin(pool, handle1, true);
+    g_current_ms = TEST_IDLE_TIMEOUT_MS;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0));
+    STRICT_EXPECTED_CALL(VECTOR_erase(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(handle1));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    setup_checkout_new_handle_expectations(TEST_HOSTNAME, 0);
+
+    ///act
+    handle2 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle2, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_012: [If pool or handle is NULL then HTTPAPIEX_POOL_Checkin shall do nothing.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkin_with_NULL_handle_does_nothing)
+{
+    ///arrange
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    umock_c_reset_all_calls();
+
+    ///act
+    HTTPAPIEX_POOL_Checkin(pool, NULL, true);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_013: [If handle is not checked out from pool, HTTPAPIEX_POOL_Checkin shall do nothing.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkin_of_a_handle_that_is_not_checked_out_does_nothing)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    HTTPAPIEX_POOL_Checkin(pool, handle, true);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_find_if(IGNORED_PTR_ARG, IGNORED_PTR_ARG, handle));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    ///act
+    HTTPAPIEX_POOL_Checkin(pool, handle, false);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_014: [If isHealthy is false, HTTPAPIEX_POOL_Checkin shall remove the handle from the pool and destroy it.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkin_of_an_unhealthy_handle_destroys_it)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_find_if(IGNORED_PTR_ARG, IGNORED_PTR_ARG, handle));
+    STRICT_EXPECTED_CALL(VECTOR_erase(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(handle));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    ///act
+    HTTPAPIEX_POOL_Checkin(pool, handle, false);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_015: [Otherwise HTTPAPIEX_POOL_Checkin shall mark the handle as checked in and record the time of the checkin.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_Checkin_of_a_healthy_handle_keeps_it)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_find_if(IGNORED_PTR_ARG, IGNORED_PTR_ARG, handle));
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    ///act
+    HTTPAPIEX_POOL_Checkin(pool, handle, true);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_016: [If pool is NULL or if its idleTimeoutInMs is 0, HTTPAPIEX_POOL_EvictIdle shall do nothing.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_EvictIdle_without_idle_timeout_does_nothing)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(1, 0);
+    handle = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    HTTPAPIEX_POOL_Checkin(pool, handle, true);
+    g_current_ms = 1000000;
+    umock_c_reset_all_calls();
+
+    ///act
+    HTTPAPIEX_POOL_EvictIdle(pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_HTTPAPIEX_POOL_99_017: [HTTPAPIEX_POOL_EvictIdle shall destroy all the handles that were checked in at least idleTimeoutInMs milliseconds ago and not checked out since.]*/
+TEST_FUNCTION(HTTPAPIEX_POOL_EvictIdle_destroys_only_the_expired_handles)
+{
+    ///arrange
+    HTTPAPIEX_HANDLE handle1;
+    HTTPAPIEX_HANDLE handle2;
+    HTTPAPIEX_HANDLE handle3;
+    HTTPAPIEX_POOL_HANDLE pool = HTTPAPIEX_POOL_Create(3, TEST_IDLE_TIMEOUT_MS);
+    handle1 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    handle2 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    handle3 = HTTPAPIEX_POOL_Checkout(pool, TEST_HOSTNAME);
+    HTTPAPIEX_POOL_Checkin(pool, handle1, true);
+    g_current_ms = 500;
+    HTTPAPIEX_POOL_Checkin(pool, handle2, true);
+    g_current_ms = TEST_IDLE_TIMEOUT_MS;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0));
+    STRICT_EXPECTED_CALL(VECTOR_erase(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(handle1));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0));
+    STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    ///act
+    HTTPAPIEX_POOL_EvictIdle(pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    HTTPAPIEX_POOL_Checkin(pool, handle3, true);
+    HTTPAPIEX_POOL_Destroy(pool);
+}
+
+END_TEST_SUITE(httpapiexpool_unittests)
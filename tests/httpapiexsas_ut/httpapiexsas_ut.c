@@ -53,6 +53,7 @@ void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/sastoken.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/httpapiex.h"
+#include "azure_c_shared_utility/lock.h"
 #include "azure_c_shared_utility/gballoc.h"
 
 #undef ENABLE_MOCKS
@@ -65,6 +66,9 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
 TEST_DEFINE_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 
+TEST_DEFINE_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+
 #define TEST_STRING_HANDLE (STRING_HANDLE)0x46
 #define TEST_NULL_STRING_HANDLE (STRING_HANDLE)0x00
 #define TEST_KEYNAME_HANDLE (STRING_HANDLE)0x48
@@ -81,6 +85,8 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 #define TEST_RESPONSE_CONTENT (BUFFER_HANDLE)0x59
 #define TEST_CONST_CHAR_STAR_NULL (const char*)NULL
 #define TEST_SASTOKEN_HANDLE (STRING_HANDLE)0x60
+#define TEST_CLONED_SASTOKEN_HANDLE (STRING_HANDLE)0x61
+#define TEST_LOCK_HANDLE (LOCK_HANDLE)0x62
 #define TEST_EXPIRY ((size_t)7200)
 #define TEST_TIME_T ((time_t)-1)
 
@@ -112,6 +118,7 @@ static void setupSAS_Create_happy_path(void)
     STRICT_EXPECTED_CALL(STRING_clone(TEST_KEY_HANDLE)).SetReturn(TEST_CLONED_KEY_HANDLE);
     STRICT_EXPECTED_CALL(STRING_clone(TEST_URIRESOURCE_HANDLE)).SetReturn(TEST_CLONED_URIRESOURCE_HANDLE);
     STRICT_EXPECTED_CALL(STRING_clone(TEST_KEYNAME_HANDLE)).SetReturn(TEST_CLONED_KEYNAME_HANDLE);
+    STRICT_EXPECTED_CALL(Lock_Init());
 }
 
 DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
@@ -187,6 +194,8 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
 
     REGISTER_TYPE(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT);
     REGISTER_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT);
+    REGISTER_TYPE(LOCK_RESULT, LOCK_RESULT);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HEADERS_HANDLE, void*);
     REGISTER_TYPE(time_t, time_t);
@@ -205,6 +214,10 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_RETURN(HTTPHeaders_FindHeaderValue, TEST_CONST_CHAR_STAR_NULL);
     REGISTER_GLOBAL_MOCK_RETURN(HTTPHeaders_ReplaceHeaderNameValuePair, HTTP_HEADERS_ERROR);
     REGISTER_GLOBAL_MOCK_RETURN(get_time, TEST_TIME_T);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Init, TEST_LOCK_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Deinit, LOCK_OK);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -386,6 +399,31 @@ TEST_FUNCTION(HTTPAPIEX_SAS_Create_third_string_clone_fails)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/*Tests_SRS_HTTPAPIEXSAS_06_004: [If there are any other errors in the instantiation of this handle then HTTPAPIEX_SAS_Create shall return NULL.]*/
+/*Tests_SRS_HTTPAPIEXSAS_06_027: [HTTPAPIEX_SAS_Create shall create a lock by calling Lock_Init, which guards the kept token.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_Create_Lock_Init_fails)
+{
+    // arrange
+    HTTPAPIEX_SAS_HANDLE handle;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)).IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_KEY_HANDLE)).SetReturn(TEST_CLONED_KEY_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_URIRESOURCE_HANDLE)).SetReturn(TEST_CLONED_URIRESOURCE_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_KEYNAME_HANDLE)).SetReturn(TEST_CLONED_KEYNAME_HANDLE);
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_URIRESOURCE_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_KEYNAME_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)).IgnoreArgument(1);
+
+    // act
+    handle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+
+    // assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 /*Tests_SRS_HTTPAPIEXSAS_06_006: [HTTAPIEX_SAS_Destroy shall deallocate any structures denoted by the parameter handle.]*/
 TEST_FUNCTION(HTTPAPIEX_SAS_Destroy_frees_underlying_strings)
 {
@@ -399,6 +437,7 @@ TEST_FUNCTION(HTTPAPIEX_SAS_Destroy_frees_underlying_strings)
     STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_KEY_HANDLE));
     STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_URIRESOURCE_HANDLE));
     STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_KEYNAME_HANDLE));
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)).IgnoreArgument(1);
 
     // act
@@ -533,7 +572,9 @@ TEST_FUNCTION(HTTPAPIEX_SAS_invoke_executerequest_sastoken_create_returns_null_s
 
     STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
     STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(3600);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, TEST_EXPIRY)).SetReturn(TEST_NULL_STRING_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
 
     // act
@@ -549,7 +590,6 @@ TEST_FUNCTION(HTTPAPIEX_SAS_invoke_executerequest_sastoken_create_returns_null_s
 
 /*Tests_SRS_HTTPAPIEXSAS_06_013: [HTTPHeaders_ReplaceHeaderNameValuePair shall be invoked with "Authorization" as its second argument and STRING_c_str (newSASToken) as its third argument.]*/
 /*Tests_SRS_HTTPAPIEXSAS_06_014: [If the result of the invocation of HTTPHeaders_ReplaceHeaderNameValuePair is NOT HTTP_HEADERS_OK then fallthrough.]*/
-/*Tests_SRS_HTTPAPIEXSAS_06_015: [STRING_delete(newSASToken) will be invoked.]*/
 TEST_FUNCTION(HTTPAPIEX_SAS_invoke_executerequest_replace_header_name_value_pair_fails_succeeds)
 {
 
@@ -564,10 +604,13 @@ TEST_FUNCTION(HTTPAPIEX_SAS_invoke_executerequest_replace_header_name_value_pair
 
     STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
     STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(3600);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, TEST_EXPIRY)).SetReturn(TEST_SASTOKEN_HANDLE);
-    STRICT_EXPECTED_CALL(STRING_c_str(TEST_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_SASTOKEN_HANDLE)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
     STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_ERROR);
-    STRICT_EXPECTED_CALL(STRING_delete(TEST_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
     STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
 
     // act
@@ -596,10 +639,13 @@ TEST_FUNCTION(HTTPAPIEX_SAS_invoke_executerequest_replace_header_name_value_pair
 
     STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
     STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)3600);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, TEST_EXPIRY)).SetReturn(TEST_SASTOKEN_HANDLE);
-    STRICT_EXPECTED_CALL(STRING_c_str(TEST_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_SASTOKEN_HANDLE)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
     STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
-    STRICT_EXPECTED_CALL(STRING_delete(TEST_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
     STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
 
     // act
@@ -613,4 +659,450 @@ TEST_FUNCTION(HTTPAPIEX_SAS_invoke_executerequest_replace_header_name_value_pair
     HTTPAPIEX_SAS_Destroy(sasHandle);
 }
 
+static void execute_request_with_new_token(HTTPAPIEX_SAS_HANDLE sasHandle, time_t currentTime, STRING_HANDLE newToken)
+{
+    unsigned int statusCode;
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(currentTime);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, IGNORED_NUM_ARG)).SetReturn(newToken);
+    STRICT_EXPECTED_CALL(STRING_clone(newToken)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, IGNORED_PTR_ARG, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+}
+
+static void setup_execute_request_with_kept_token_expectations(time_t currentTime, STRING_HANDLE keptToken, unsigned int* statusCode)
+{
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(currentTime);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_clone(keptToken)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_020: [HTTPAPIEX_SAS_Create shall set the token lifetime to 3600 seconds and the refresh percentage to 80.]*/
+/*Tests_SRS_HTTPAPIEXSAS_06_021: [If a token was created less than refreshPercent percent of the token lifetime ago, it shall be used instead of creating a new one.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_executerequest_reuses_the_token_before_80_percent_of_its_lifetime)
+{
+    HTTPAPIEX_RESULT result;
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    execute_request_with_new_token(sasHandle, (time_t)3600, TEST_SASTOKEN_HANDLE);
+    umock_c_reset_all_calls();
+
+    setup_execute_request_with_kept_token_expectations((time_t)(3600 + 2879), TEST_SASTOKEN_HANDLE, &statusCode);
+
+    // act
+    result = HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_011: [SASToken_Create shall be invoked.]*/
+/*Tests_SRS_HTTPAPIEXSAS_06_015: [The new SAS token shall replace, and STRING_delete, the previously kept one.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_executerequest_creates_a_new_token_after_80_percent_of_its_lifetime)
+{
+    HTTPAPIEX_RESULT result;
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    execute_request_with_new_token(sasHandle, (time_t)3600, TEST_SASTOKEN_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)(3600 + 2880));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, 3600 + 2880 + 3600)).SetReturn(TEST_STRING_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_STRING_HANDLE)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+
+    // act
+    result = HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_021: [If a token was created less than refreshPercent percent of the token lifetime ago, it shall be used instead of creating a new one.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_executerequest_creates_a_new_token_when_the_clock_went_backwards)
+{
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    execute_request_with_new_token(sasHandle, (time_t)3600, TEST_SASTOKEN_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)3599);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, 3599 + 3600)).SetReturn(TEST_STRING_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_STRING_HANDLE)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+
+    // act
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_026: [If SASToken_Create fails while the kept token has not expired yet, the kept token shall be used.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_executerequest_uses_the_kept_token_when_sastoken_create_fails_before_expiry)
+{
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    execute_request_with_new_token(sasHandle, (time_t)3600, TEST_SASTOKEN_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)(3600 + 3000));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, IGNORED_NUM_ARG)).SetReturn(TEST_NULL_STRING_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_SASTOKEN_HANDLE)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+
+    // act
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_028: [The kept token shall only be read or replaced while holding the lock.]*/
+/*Tests_SRS_HTTPAPIEXSAS_06_029: [If Lock fails then fallthrough.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_executerequest_Lock_fails_falls_through)
+{
+    HTTPAPIEX_RESULT result;
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)3600);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE)).SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+
+    // act
+    result = HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_030: [The token used by the request shall be a STRING_clone of the kept token taken while holding the lock, so that a concurrent request replacing the kept token cannot delete it while it is in use.]*/
+/*Tests_SRS_HTTPAPIEXSAS_06_031: [If STRING_clone fails then fallthrough.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_executerequest_STRING_clone_fails_keeps_the_token_and_falls_through)
+{
+    HTTPAPIEX_RESULT result;
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)3600);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, TEST_EXPIRY)).SetReturn(TEST_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_SASTOKEN_HANDLE)).SetReturn(TEST_NULL_STRING_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+    setup_execute_request_with_kept_token_expectations((time_t)3601, TEST_SASTOKEN_HANDLE, &statusCode);
+
+    // act
+    result = HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_006: [HTTAPIEX_SAS_Destroy shall deallocate any structures denoted by the parameter handle.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_Destroy_frees_the_kept_token)
+{
+    // arrange
+    HTTPAPIEX_SAS_HANDLE handle;
+
+    setupSAS_Create_happy_path();
+    handle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    execute_request_with_new_token(handle, (time_t)3600, TEST_SASTOKEN_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_URIRESOURCE_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_KEYNAME_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)).IgnoreArgument(1);
+
+    // act
+    HTTPAPIEX_SAS_Destroy(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_022: [If sasHandle is NULL, tokenLifetimeInSeconds is 0 or refreshPercent is greater than 100 then HTTPAPIEX_SAS_SetTokenLifetime shall return HTTPAPIEX_INVALID_ARG.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_SetTokenLifetime_with_invalid_arguments_fails)
+{
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    umock_c_reset_all_calls();
+
+    // act
+    // assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SAS_SetTokenLifetime(NULL, 3600, 50));
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SAS_SetTokenLifetime(sasHandle, 0, 50));
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SAS_SetTokenLifetime(sasHandle, 3600, 101));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_023: [HTTPAPIEX_SAS_SetTokenLifetime shall save tokenLifetimeInSeconds and refreshPercent, discard the kept token and return HTTPAPIEX_OK.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_SetTokenLifetime_discards_the_kept_token)
+{
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    execute_request_with_new_token(sasHandle, (time_t)3600, TEST_SASTOKEN_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = HTTPAPIEX_SAS_SetTokenLifetime(sasHandle, 600, 50);
+
+    // assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_023: [HTTPAPIEX_SAS_SetTokenLifetime shall save tokenLifetimeInSeconds and refreshPercent, discard the kept token and return HTTPAPIEX_OK.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_SetTokenLifetime_changes_the_expiry_and_the_refresh_time)
+{
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    (void)HTTPAPIEX_SAS_SetTokenLifetime(sasHandle, 600, 50);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)3600);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, 3600 + 600)).SetReturn(TEST_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_SASTOKEN_HANDLE)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+    setup_execute_request_with_kept_token_expectations((time_t)(3600 + 299), TEST_SASTOKEN_HANDLE, &statusCode);
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization")).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn((time_t)(3600 + 300));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Create(TEST_CLONED_KEY_HANDLE, TEST_CLONED_URIRESOURCE_HANDLE, TEST_CLONED_KEYNAME_HANDLE, 3600 + 300 + 600)).SetReturn(TEST_STRING_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_clone(TEST_STRING_HANDLE)).SetReturn(TEST_CLONED_SASTOKEN_HANDLE);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_CLONED_SASTOKEN_HANDLE)).SetReturn(TEST_CHAR_ARRAY);
+    STRICT_EXPECTED_CALL(HTTPHeaders_ReplaceHeaderNameValuePair(TEST_REQUEST_HTTP_HEADERS_HANDLE, "Authorization", TEST_CHAR_ARRAY)).SetReturn(HTTP_HEADERS_OK);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_CLONED_SASTOKEN_HANDLE));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT)).SetReturn(HTTPAPIEX_OK);
+
+    // act
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_032: [If Lock fails then HTTPAPIEX_SAS_SetTokenLifetime shall return HTTPAPIEX_ERROR.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_SetTokenLifetime_Lock_fails)
+{
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE)).SetReturn(LOCK_ERROR);
+
+    // act
+    result = HTTPAPIEX_SAS_SetTokenLifetime(sasHandle, 600, 50);
+
+    // assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_024: [If sasHandle or statistics is NULL then HTTPAPIEX_SAS_GetTokenStatistics shall return HTTPAPIEX_INVALID_ARG.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_GetTokenStatistics_with_invalid_arguments_fails)
+{
+    HTTPAPIEX_SAS_TOKEN_STATISTICS statistics;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    umock_c_reset_all_calls();
+
+    // act
+    // assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SAS_GetTokenStatistics(NULL, &statistics));
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, HTTPAPIEX_SAS_GetTokenStatistics(sasHandle, NULL));
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_025: [HTTPAPIEX_SAS_GetTokenStatistics shall copy the number of tokens created and the number of tokens reused by HTTPAPIEX_SAS_ExecuteRequest to statistics and return HTTPAPIEX_OK.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_GetTokenStatistics_counts_the_created_and_reused_tokens)
+{
+    HTTPAPIEX_RESULT result;
+    unsigned int statusCode;
+    HTTPAPIEX_SAS_TOKEN_STATISTICS statistics;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    execute_request_with_new_token(sasHandle, (time_t)3600, TEST_SASTOKEN_HANDLE);
+    setup_execute_request_with_kept_token_expectations((time_t)3601, TEST_SASTOKEN_HANDLE, &statusCode);
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+    setup_execute_request_with_kept_token_expectations((time_t)3602, TEST_SASTOKEN_HANDLE, &statusCode);
+    (void)HTTPAPIEX_SAS_ExecuteRequest(sasHandle, TEST_HTTPAPIEX_HANDLE, TEST_HTTPAPI_REQUEST_TYPE, TEST_CHAR_ARRAY, TEST_REQUEST_HTTP_HEADERS_HANDLE, TEST_REQUEST_CONTENT, &statusCode, TEST_RESPONSE_HTTP_HEADERS_HANDLE, TEST_RESPONSE_CONTENT);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = HTTPAPIEX_SAS_GetTokenStatistics(sasHandle, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.regenerations);
+    ASSERT_ARE_EQUAL(size_t, 2, statistics.reuses);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
+/*Tests_SRS_HTTPAPIEXSAS_06_033: [If Lock fails then HTTPAPIEX_SAS_GetTokenStatistics shall return HTTPAPIEX_ERROR.]*/
+TEST_FUNCTION(HTTPAPIEX_SAS_GetTokenStatistics_Lock_fails)
+{
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_SAS_TOKEN_STATISTICS statistics;
+    HTTPAPIEX_SAS_HANDLE sasHandle;
+
+    // arrange
+    setupSAS_Create_happy_path();
+    sasHandle = HTTPAPIEX_SAS_Create(TEST_KEY_HANDLE, TEST_URIRESOURCE_HANDLE, TEST_KEYNAME_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE)).SetReturn(LOCK_ERROR);
+
+    // act
+    result = HTTPAPIEX_SAS_GetTokenStatistics(sasHandle, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    HTTPAPIEX_SAS_Destroy(sasHandle);
+}
+
 END_TEST_SUITE(httpapiexsas_unittests)
@@ -3,9 +3,13 @@
 
 #define BUFFER_new real_BUFFER_new
 #define BUFFER_create real_BUFFER_create
+#define BUFFER_new_in_arena real_BUFFER_new_in_arena
+#define BUFFER_create_in_arena real_BUFFER_create_in_arena
+#define BUFFER_create_inline real_BUFFER_create_inline
 #define BUFFER_pre_build real_BUFFER_pre_build
 #define BUFFER_build real_BUFFER_build
 #define BUFFER_unbuild real_BUFFER_unbuild
+#define BUFFER_detach real_BUFFER_detach
 #define BUFFER_append real_BUFFER_append
 #define BUFFER_prepend real_BUFFER_prepend
 #define BUFFER_u_char real_BUFFER_u_char
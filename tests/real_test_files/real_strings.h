@@ -11,6 +11,12 @@
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_clone, NULL); \
     REGISTER_GLOBAL_MOCK_HOOK(STRING_construct, real_STRING_construct); \
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_construct, NULL); \
+    REGISTER_GLOBAL_MOCK_HOOK(STRING_new_in_arena, real_STRING_new_in_arena); \
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_new_in_arena, NULL); \
+    REGISTER_GLOBAL_MOCK_HOOK(STRING_construct_in_arena, real_STRING_construct_in_arena); \
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_construct_in_arena, NULL); \
+    REGISTER_GLOBAL_MOCK_HOOK(STRING_construct_inline, real_STRING_construct_inline); \
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_construct_inline, NULL); \
     REGISTER_GLOBAL_MOCK_HOOK(STRING_construct_n, real_STRING_construct_n); \
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_construct_n, NULL); \
     REGISTER_GLOBAL_MOCK_HOOK(STRING_new_with_memory, real_STRING_new_with_memory); \
@@ -43,6 +49,9 @@
 #define STRING_new                      real_STRING_new 
 #define STRING_clone                    real_STRING_clone 
 #define STRING_construct                real_STRING_construct 
+#define STRING_new_in_arena             real_STRING_new_in_arena
+#define STRING_construct_in_arena       real_STRING_construct_in_arena
+#define STRING_construct_inline         real_STRING_construct_inline
 #define STRING_construct_n              real_STRING_construct_n 
 #define STRING_new_with_memory          real_STRING_new_with_memory 
 #define STRING_new_quoted               real_STRING_new_quoted 
@@ -69,6 +78,9 @@
 #undef STRING_new                  
 #undef STRING_clone                
 #undef STRING_construct            
+#undef STRING_new_in_arena
+#undef STRING_construct_in_arena
+#undef STRING_construct_inline
 #undef STRING_construct_n          
 #undef STRING_new_with_memory      
 #undef STRING_new_quoted           
@@ -3,8 +3,10 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstdint>
 #else
 #include <stdlib.h>
+#include <stdint.h>
 #endif
 
 static void* my_gballoc_malloc(size_t size)
@@ -74,6 +76,19 @@ BUFFER_HANDLE my_Base64_Decoder(const char* source)
     return (BUFFER_HANDLE)malloc(1);
 }
 
+STRING_HANDLE my_STRING_construct(const char* psz)
+{
+    (void)psz;
+    return (STRING_HANDLE)malloc(1);
+}
+
+STRING_HANDLE my_Base64_Encode_Bytes(const unsigned char* source, size_t size)
+{
+    (void)source;
+    (void)size;
+    return (STRING_HANDLE)malloc(1);
+}
+
 STRING_HANDLE my_URL_Encode(STRING_HANDLE input)
 {
     (void)input;
@@ -147,6 +162,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned int);
     REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(HMACSHA256_BATCH_ITEM*, void*);
 
     result = umocktypes_charptr_register_types();
     ASSERT_ARE_EQUAL(int, 0, result);
@@ -157,6 +173,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
 
     REGISTER_GLOBAL_MOCK_HOOK(STRING_new, my_STRING_new);
+    REGISTER_GLOBAL_MOCK_HOOK(STRING_construct, my_STRING_construct);
     REGISTER_GLOBAL_MOCK_RETURN(STRING_concat, 0);
     REGISTER_GLOBAL_MOCK_RETURN(STRING_concat_with_STRING, 0);
     REGISTER_GLOBAL_MOCK_RETURN(STRING_c_str, &TEST_CHAR_ARRAY[0]);
@@ -169,8 +186,10 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
 
     REGISTER_GLOBAL_MOCK_HOOK(Base64_Encoder, my_Base64_Encode);
     REGISTER_GLOBAL_MOCK_HOOK(Base64_Decoder, my_Base64_Decoder);
+    REGISTER_GLOBAL_MOCK_HOOK(Base64_Encode_Bytes, my_Base64_Encode_Bytes);
     REGISTER_GLOBAL_MOCK_HOOK(URL_Encode, my_URL_Encode);
     REGISTER_GLOBAL_MOCK_RETURN(HMACSHA256_ComputeHash, HMACSHA256_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(HMACSHA256_ComputeHashBatch, HMACSHA256_OK);
     REGISTER_GLOBAL_MOCK_RETURN(size_tToString, 0);
 
     REGISTER_GLOBAL_MOCK_RETURN(get_time, TEST_TIME_T);
@@ -1763,4 +1782,294 @@ TEST_FUNCTION(SASToken_CreateString_succeeds)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+static void setup_batch_item(SASTOKEN_BATCH_ITEM* item)
+{
+    item->key = TEST_CHAR_ARRAY;
+    item->scope = TEST_STRING_VALUE;
+    item->keyName = TEST_STRING_VALUE;
+    item->expiry = TEST_EXPIRY;
+    item->token = NULL;
+}
+
+static void setup_batch_prepare_expectations(void)
+{
+    STRICT_EXPECTED_CALL(Base64_Decoder(&TEST_CHAR_ARRAY[0])).SetReturn(TEST_DECODEDKEY_HANDLE);
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, sizeof(TEST_TOKEN_EXPIRATION_TIME), TEST_EXPIRY)).IgnoreArgument(1).CopyOutArgumentBuffer(1, TEST_TOKEN_EXPIRATION_TIME, sizeof(TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(STRING_new()).SetReturn(TEST_TOBEHASHED_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_TOBEHASHED_HANDLE, TEST_STRING_VALUE));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_TOBEHASHED_HANDLE, "\n"));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_TOBEHASHED_HANDLE, TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(BUFFER_u_char(TEST_DECODEDKEY_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_length(TEST_DECODEDKEY_HANDLE)).SetReturn(TEST_LENGTH_DECODEDKEY);
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_TOBEHASHED_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_length(TEST_TOBEHASHED_HANDLE)).SetReturn(TEST_LENGTH_TOBEHASHED);
+}
+
+/*Tests_SRS_SASTOKEN_99_001: [ If items is NULL or itemCount is 0 then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_with_NULL_items_fails)
+{
+    // act
+    int result = SASToken_CreateBatch(NULL, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_001: [ If items is NULL or itemCount is 0 then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_with_0_items_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    setup_batch_item(&item);
+
+    // act
+    int result = SASToken_CreateBatch(&item, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_009: [ If the working memory for itemCount items cannot be sized without overflowing then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_with_too_many_items_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    setup_batch_item(&item);
+
+    // act
+    int result = SASToken_CreateBatch(&item, SIZE_MAX);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_010: [ SASToken_CreateBatch shall set the token of every item to NULL before checking the items. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_with_an_invalid_item_sets_all_tokens_to_NULL)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM items[2];
+    setup_batch_item(&items[0]);
+    setup_batch_item(&items[1]);
+    items[0].keyName = NULL;
+    items[0].token = TEST_RESULT_HANDLE;
+    items[1].token = TEST_RESULT_HANDLE;
+
+    // act
+    int result = SASToken_CreateBatch(items, 2);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(items[0].token);
+    ASSERT_IS_NULL(items[1].token);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_002: [ If the key, scope or keyName of any item is NULL then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_with_NULL_key_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM items[2];
+    setup_batch_item(&items[0]);
+    setup_batch_item(&items[1]);
+    items[1].key = NULL;
+
+    // act
+    int result = SASToken_CreateBatch(items, 2);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_002: [ If the key, scope or keyName of any item is NULL then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_with_NULL_scope_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    setup_batch_item(&item);
+    item.scope = NULL;
+
+    // act
+    int result = SASToken_CreateBatch(&item, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_002: [ If the key, scope or keyName of any item is NULL then SASToken_CreateBatch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_with_NULL_keyName_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    setup_batch_item(&item);
+    item.keyName = NULL;
+
+    // act
+    int result = SASToken_CreateBatch(&item, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_003: [ SASToken_CreateBatch shall allocate the working memory for all the items at once. ]*/
+/*Tests_SRS_SASTOKEN_99_004: [ For each item SASToken_CreateBatch shall decode the key from base64, convert expiry to a string and build scope + "\n" + expiry, as SASToken_Create does. ]*/
+/*Tests_SRS_SASTOKEN_99_005: [ SASToken_CreateBatch shall compute all the HMAC-SHA256 hashes with one call to HMACSHA256_ComputeHashBatch. ]*/
+/*Tests_SRS_SASTOKEN_99_006: [ Each token shall be built from its hash as SASToken_Create builds it. ]*/
+/*Tests_SRS_SASTOKEN_99_008: [ Otherwise SASToken_CreateBatch shall store each token in its item and return 0. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_succeeds)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    int result;
+    setup_batch_item(&item);
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    setup_batch_prepare_expectations();
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashBatch(IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 32)).SetReturn(TEST_BASE64SIGNATURE_HANDLE);
+    STRICT_EXPECTED_CALL(URL_Encode(TEST_BASE64SIGNATURE_HANDLE)).SetReturn(TEST_URLENCODEDSIGNATURE_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_construct("SharedAccessSignature sr=")).SetReturn(TEST_RESULT_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, TEST_STRING_VALUE));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, "&sig="));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(TEST_RESULT_HANDLE, TEST_URLENCODEDSIGNATURE_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, "&se="));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, "&skn="));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, TEST_STRING_VALUE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_BASE64SIGNATURE_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_URLENCODEDSIGNATURE_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_TOBEHASHED_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_DECODEDKEY_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_CreateBatch(&item, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_RESULT_HANDLE, item.token);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_007: [ If any failure occurs, SASToken_CreateBatch shall delete the tokens it created, set all the tokens to NULL and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_when_malloc_fails_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    int result;
+    setup_batch_item(&item);
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)).SetReturn(NULL);
+
+    // act
+    result = SASToken_CreateBatch(&item, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_007: [ If any failure occurs, SASToken_CreateBatch shall delete the tokens it created, set all the tokens to NULL and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_when_decoding_a_key_fails_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    int result;
+    setup_batch_item(&item);
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(Base64_Decoder(&TEST_CHAR_ARRAY[0])).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_CreateBatch(&item, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(item.token);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_007: [ If any failure occurs, SASToken_CreateBatch shall delete the tokens it created, set all the tokens to NULL and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_when_HMACSHA256_ComputeHashBatch_fails_fails)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM item;
+    int result;
+    setup_batch_item(&item);
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    setup_batch_prepare_expectations();
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashBatch(IGNORED_PTR_ARG, 1)).SetReturn(HMACSHA256_ERROR);
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_TOBEHASHED_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_DECODEDKEY_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_CreateBatch(&item, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(item.token);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_99_007: [ If any failure occurs, SASToken_CreateBatch shall delete the tokens it created, set all the tokens to NULL and return a non-zero value. ]*/
+TEST_FUNCTION(SASToken_CreateBatch_when_building_the_second_token_fails_deletes_the_first_one)
+{
+    // arrange
+    SASTOKEN_BATCH_ITEM items[2];
+    int result;
+    setup_batch_item(&items[0]);
+    setup_batch_item(&items[1]);
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    setup_batch_prepare_expectations();
+    setup_batch_prepare_expectations();
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashBatch(IGNORED_PTR_ARG, 2));
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 32)).SetReturn(TEST_BASE64SIGNATURE_HANDLE);
+    STRICT_EXPECTED_CALL(URL_Encode(TEST_BASE64SIGNATURE_HANDLE)).SetReturn(TEST_URLENCODEDSIGNATURE_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_construct("SharedAccessSignature sr=")).SetReturn(TEST_RESULT_HANDLE);
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, TEST_STRING_VALUE));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, "&sig="));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(TEST_RESULT_HANDLE, TEST_URLENCODEDSIGNATURE_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, "&se="));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, "&skn="));
+    STRICT_EXPECTED_CALL(STRING_concat(TEST_RESULT_HANDLE, TEST_STRING_VALUE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_BASE64SIGNATURE_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_URLENCODEDSIGNATURE_HANDLE));
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 32)).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(STRING_delete(NULL));
+    STRICT_EXPECTED_CALL(STRING_delete(NULL));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_RESULT_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_TOBEHASHED_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_DECODEDKEY_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_delete(TEST_TOBEHASHED_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_DECODEDKEY_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_CreateBatch(items, 2);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(items[0].token);
+    ASSERT_IS_NULL(items[1].token);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(sastoken_unittests)
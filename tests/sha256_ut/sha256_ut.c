@@ -0,0 +1,455 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#else
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/sha.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static const SHA256Implementation all_implementations[] = { sha256Portable, sha256X86ShaExtensions, sha256ArmV8Crypto };
+#define IMPLEMENTATION_COUNT (sizeof(all_implementations) / sizeof(all_implementations[0]))
+
+static const SHA256BatchImplementation all_batch_implementations[] = { sha256BatchSerial, sha256BatchAvx2, sha256BatchAvx512 };
+#define BATCH_IMPLEMENTATION_COUNT (sizeof(all_batch_implementations) / sizeof(all_batch_implementations[0]))
+
+static const char* batch_implementation_name(SHA256BatchImplementation implementation)
+{
+    const char* result;
+    switch (implementation)
+    {
+    case sha256BatchSerial:
+        result = "serial";
+        break;
+    case sha256BatchAvx2:
+        result = "AVX2 8 lanes";
+        break;
+    case sha256BatchAvx512:
+        result = "AVX-512 16 lanes";
+        break;
+    default:
+        result = "unknown";
+        break;
+    }
+    return result;
+}
+
+static const char* implementation_name(SHA256Implementation implementation)
+{
+    const char* result;
+    switch (implementation)
+    {
+    case sha256Portable:
+        result = "portable";
+        break;
+    case sha256X86ShaExtensions:
+        result = "x86 SHA extensions";
+        break;
+    case sha256ArmV8Crypto:
+        result = "ARMv8 crypto";
+        break;
+    default:
+        result = "unknown";
+        break;
+    }
+    return result;
+}
+
+static void to_hex(const uint8_t* digest, size_t digest_size, char* hex)
+{
+    size_t i;
+    for (i = 0; i < digest_size; i++)
+    {
+        (void)sprintf(hex + 2 * i, "%02x", digest[i]);
+    }
+}
+
+static void assert_sha256_of_repeated_input(const uint8_t* input, size_t input_length, size_t repeat_count, const char* expected_hex)
+{
+    SHA256Context context;
+    uint8_t digest[SHA256HashSize];
+    char hex[2 * SHA256HashSize + 1];
+    size_t i;
+
+    ASSERT_ARE_EQUAL(int, shaSuccess, SHA256Reset(&context));
+    for (i = 0; i < repeat_count; i++)
+    {
+        ASSERT_ARE_EQUAL(int, shaSuccess, SHA256Input(&context, input, (unsigned int)input_length));
+    }
+    ASSERT_ARE_EQUAL(int, shaSuccess, SHA256Result(&context, digest));
+
+    to_hex(digest, SHA256HashSize, hex);
+    ASSERT_ARE_EQUAL(char_ptr, expected_hex, hex);
+}
+
+static void assert_sha256_of(const char* input, const char* expected_hex)
+{
+    assert_sha256_of_repeated_input((const uint8_t*)input, strlen(input), 1, expected_hex);
+}
+
+BEGIN_TEST_SUITE(SHA256_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    (void)SHA256SelectImplementation(sha256Portable);
+    (void)SHA256BatchSelectImplementation(sha256BatchSerial);
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* SHA256IsImplementationSupported */
+
+TEST_FUNCTION(SHA256IsImplementationSupported_portable_is_always_supported)
+{
+    // act
+    int result = SHA256IsImplementationSupported(sha256Portable);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 1, result);
+}
+
+TEST_FUNCTION(SHA256IsImplementationSupported_unknown_implementation_is_not_supported)
+{
+    // act
+    int result = SHA256IsImplementationSupported((SHA256Implementation)42);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+}
+
+/* SHA256SelectImplementation */
+
+TEST_FUNCTION(SHA256SelectImplementation_with_unsupported_implementation_fails)
+{
+    // arrange
+    SHA256Implementation before = SHA256GetImplementation();
+
+    // act
+    int result = SHA256SelectImplementation((SHA256Implementation)42);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, shaBadParam, result);
+    ASSERT_ARE_EQUAL(int, (int)before, (int)SHA256GetImplementation());
+}
+
+TEST_FUNCTION(SHA256SelectImplementation_selects_every_supported_implementation)
+{
+    size_t i;
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        // act
+        int result = SHA256SelectImplementation(all_implementations[i]);
+
+        // assert
+        if (SHA256IsImplementationSupported(all_implementations[i]))
+        {
+            ASSERT_ARE_EQUAL(int, shaSuccess, result);
+            ASSERT_ARE_EQUAL(int, (int)all_implementations[i], (int)SHA256GetImplementation());
+        }
+        else
+        {
+            ASSERT_ARE_EQUAL(int, shaBadParam, result);
+        }
+    }
+}
+
+/* Known answer tests (FIPS 180-2, appendix B) */
+
+TEST_FUNCTION(SHA256_known_answers_for_every_supported_implementation)
+{
+    size_t i;
+    uint8_t* million_a = (uint8_t*)malloc(1000000);
+    ASSERT_IS_NOT_NULL(million_a);
+    (void)memset(million_a, 'a', 1000000);
+
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (SHA256SelectImplementation(all_implementations[i]) == shaSuccess)
+        {
+            assert_sha256_of("", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+            assert_sha256_of("abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+            assert_sha256_of("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+            // whole blocks hashed straight from the input, one byte at a time and in odd sized pieces
+            assert_sha256_of_repeated_input(million_a, 1000000, 1, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+            assert_sha256_of_repeated_input(million_a, 1, 1000000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+            assert_sha256_of_repeated_input(million_a, 1000, 1000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+        }
+    }
+
+    free(million_a);
+}
+
+TEST_FUNCTION(SHA224_known_answer_for_every_supported_implementation)
+{
+    size_t i;
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (SHA256SelectImplementation(all_implementations[i]) == shaSuccess)
+        {
+            // arrange
+            SHA224Context context;
+            uint8_t digest[SHA224HashSize];
+            char hex[2 * SHA224HashSize + 1];
+
+            // act
+            (void)SHA224Reset(&context);
+            (void)SHA224Input(&context, (const uint8_t*)"abc", 3);
+            (void)SHA224Result(&context, digest);
+
+            // assert
+            to_hex(digest, SHA224HashSize, hex);
+            ASSERT_ARE_EQUAL(char_ptr, "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7", hex);
+        }
+    }
+}
+
+TEST_FUNCTION(SHA256_every_supported_implementation_matches_portable_for_every_length)
+{
+    uint8_t input[300];
+    uint8_t expected[SHA256HashSize];
+    uint8_t actual[SHA256HashSize];
+    size_t length;
+    size_t i;
+
+    for (i = 0; i < sizeof(input); i++)
+    {
+        input[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    for (length = 0; length <= sizeof(input); length++)
+    {
+        SHA256Context context;
+        (void)SHA256SelectImplementation(sha256Portable);
+        (void)SHA256Reset(&context);
+        (void)SHA256Input(&context, input, (unsigned int)length);
+        (void)SHA256Result(&context, expected);
+
+        for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+        {
+            if (SHA256SelectImplementation(all_implementations[i]) == shaSuccess)
+            {
+                // split in 2 so that both the block aligned and the unaligned paths run
+                (void)SHA256Reset(&context);
+                (void)SHA256Input(&context, input, (unsigned int)(length / 3));
+                (void)SHA256Input(&context, input + length / 3, (unsigned int)(length - length / 3));
+                (void)SHA256Result(&context, actual);
+
+                ASSERT_ARE_EQUAL(int, 0, memcmp(expected, actual, SHA256HashSize));
+            }
+        }
+    }
+}
+
+/* Throughput, reported only */
+
+TEST_FUNCTION(SHA256_throughput_of_every_supported_implementation)
+{
+    const size_t buffer_size = 1024 * 1024;
+    const size_t iterations = 32;
+    uint8_t* buffer = (uint8_t*)malloc(buffer_size);
+    size_t i;
+    ASSERT_IS_NOT_NULL(buffer);
+    (void)memset(buffer, 0x5A, buffer_size);
+
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (SHA256SelectImplementation(all_implementations[i]) == shaSuccess)
+        {
+            SHA256Context context;
+            uint8_t digest[SHA256HashSize];
+            size_t j;
+            clock_t start = clock();
+            double seconds;
+
+            (void)SHA256Reset(&context);
+            for (j = 0; j < iterations; j++)
+            {
+                (void)SHA256Input(&context, buffer, (unsigned int)buffer_size);
+            }
+            (void)SHA256Result(&context, digest);
+
+            seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+            (void)printf("SHA-256 %s: %.1f MB/s\r\n", implementation_name(all_implementations[i]),
+                (seconds > 0) ? (double)iterations / seconds : 0.0);
+        }
+    }
+
+    free(buffer);
+}
+
+/* SHA256HashBatch */
+
+TEST_FUNCTION(SHA256HashBatch_with_NULL_messages_fails)
+{
+    // arrange
+    unsigned int lengths[1] = { 3 };
+    uint8_t digests[1][SHA256HashSize];
+
+    // act
+    int result = SHA256HashBatch(NULL, lengths, 1, digests);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, shaNull, result);
+}
+
+TEST_FUNCTION(SHA256HashBatch_with_NULL_message_and_non_zero_length_fails)
+{
+    // arrange
+    const uint8_t* messages[2] = { (const uint8_t*)"abc", NULL };
+    unsigned int lengths[2] = { 3, 1 };
+    uint8_t digests[2][SHA256HashSize];
+
+    // act
+    int result = SHA256HashBatch(messages, lengths, 2, digests);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, shaNull, result);
+}
+
+TEST_FUNCTION(SHA256BatchSelectImplementation_with_unsupported_implementation_fails)
+{
+    // act
+    int result = SHA256BatchSelectImplementation((SHA256BatchImplementation)42);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, shaBadParam, result);
+    ASSERT_ARE_EQUAL(int, 0, SHA256BatchIsImplementationSupported((SHA256BatchImplementation)42));
+    ASSERT_ARE_EQUAL(int, 1, SHA256BatchIsImplementationSupported(sha256BatchSerial));
+}
+
+TEST_FUNCTION(SHA256HashBatch_every_supported_implementation_matches_SHA256Input)
+{
+    // arrange
+    enum { MESSAGE_COUNT = 100, MAX_LENGTH = 300 };
+    uint8_t* data = (uint8_t*)malloc(MESSAGE_COUNT * MAX_LENGTH);
+    const uint8_t* messages[MESSAGE_COUNT];
+    unsigned int lengths[MESSAGE_COUNT];
+    uint8_t (*digests)[SHA256HashSize] = (uint8_t(*)[SHA256HashSize])malloc(MESSAGE_COUNT * SHA256HashSize);
+    size_t i, j;
+    ASSERT_IS_NOT_NULL(data);
+    ASSERT_IS_NOT_NULL(digests);
+
+    for (i = 0; i < MESSAGE_COUNT * MAX_LENGTH; i++)
+    {
+        data[i] = (uint8_t)(i * 31 + 11);
+    }
+    for (i = 0; i < MESSAGE_COUNT; i++)
+    {
+        // lengths around the 55/56 and 64 byte padding boundaries, and longer ones
+        messages[i] = data + i * MAX_LENGTH;
+        lengths[i] = (unsigned int)((i * 37) % MAX_LENGTH);
+    }
+    lengths[0] = 0;
+    messages[0] = NULL;
+    lengths[1] = 55;
+    lengths[2] = 56;
+    lengths[3] = 64;
+
+    for (j = 0; j < BATCH_IMPLEMENTATION_COUNT; j++)
+    {
+        if (SHA256BatchSelectImplementation(all_batch_implementations[j]) == shaSuccess)
+        {
+            // act
+            int result = SHA256HashBatch(messages, lengths, MESSAGE_COUNT, digests);
+
+            // assert
+            ASSERT_ARE_EQUAL(int, shaSuccess, result);
+            for (i = 0; i < MESSAGE_COUNT; i++)
+            {
+                SHA256Context context;
+                uint8_t expected[SHA256HashSize];
+                (void)SHA256Reset(&context);
+                (void)SHA256Input(&context, data + i * MAX_LENGTH, lengths[i]);
+                (void)SHA256Result(&context, expected);
+                ASSERT_ARE_EQUAL(int, 0, memcmp(expected, digests[i], SHA256HashSize));
+            }
+        }
+    }
+
+    free(digests);
+    free(data);
+}
+
+/* Batch against serial throughput, reported only */
+
+TEST_FUNCTION(SHA256HashBatch_throughput_of_every_supported_implementation)
+{
+    // about the size of what a SAS token signs
+    enum { MESSAGE_COUNT = 4096, MESSAGE_LENGTH = 120, ITERATIONS = 10 };
+    uint8_t* data = (uint8_t*)malloc(MESSAGE_COUNT * MESSAGE_LENGTH);
+    const uint8_t** messages = (const uint8_t**)malloc(MESSAGE_COUNT * sizeof(const uint8_t*));
+    unsigned int* lengths = (unsigned int*)malloc(MESSAGE_COUNT * sizeof(unsigned int));
+    uint8_t (*digests)[SHA256HashSize] = (uint8_t(*)[SHA256HashSize])malloc(MESSAGE_COUNT * SHA256HashSize);
+    size_t i, j;
+    ASSERT_IS_NOT_NULL(data);
+    ASSERT_IS_NOT_NULL(messages);
+    ASSERT_IS_NOT_NULL(lengths);
+    ASSERT_IS_NOT_NULL(digests);
+
+    (void)memset(data, 0x5A, MESSAGE_COUNT * MESSAGE_LENGTH);
+    for (i = 0; i < MESSAGE_COUNT; i++)
+    {
+        messages[i] = data + i * MESSAGE_LENGTH;
+        lengths[i] = MESSAGE_LENGTH;
+    }
+
+    for (j = 0; j < BATCH_IMPLEMENTATION_COUNT; j++)
+    {
+        if (SHA256BatchSelectImplementation(all_batch_implementations[j]) == shaSuccess)
+        {
+            clock_t start = clock();
+            double seconds;
+
+            for (i = 0; i < ITERATIONS; i++)
+            {
+                (void)SHA256HashBatch(messages, lengths, MESSAGE_COUNT, digests);
+            }
+
+            seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+            (void)printf("SHA-256 batch %s: %.0f messages of %d bytes/s\r\n", batch_implementation_name(all_batch_implementations[j]),
+                (seconds > 0) ? (double)(MESSAGE_COUNT * ITERATIONS) / seconds : 0.0, (int)MESSAGE_LENGTH);
+        }
+    }
+
+    free(digests);
+    free(lengths);
+    free(messages);
+    free(data);
+}
+
+END_TEST_SUITE(SHA256_UnitTests)
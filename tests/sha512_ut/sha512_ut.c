@@ -0,0 +1,295 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#else
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/sha.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static const SHA512Implementation all_implementations[] = { sha512Portable, sha512Unrolled, sha512X86Avx2 };
+#define IMPLEMENTATION_COUNT (sizeof(all_implementations) / sizeof(all_implementations[0]))
+
+static const char* implementation_name(SHA512Implementation implementation)
+{
+    const char* result;
+    switch (implementation)
+    {
+    case sha512Portable:
+        result = "portable";
+        break;
+    case sha512Unrolled:
+        result = "unrolled";
+        break;
+    case sha512X86Avx2:
+        result = "AVX2";
+        break;
+    default:
+        result = "unknown";
+        break;
+    }
+    return result;
+}
+
+static void to_hex(const uint8_t* digest, size_t digest_size, char* hex)
+{
+    size_t i;
+    for (i = 0; i < digest_size; i++)
+    {
+        (void)sprintf(hex + 2 * i, "%02x", digest[i]);
+    }
+}
+
+static void assert_sha512_of_repeated_input(const uint8_t* input, size_t input_length, size_t repeat_count, const char* expected_hex)
+{
+    SHA512Context context;
+    uint8_t digest[SHA512HashSize];
+    char hex[2 * SHA512HashSize + 1];
+    size_t i;
+
+    ASSERT_ARE_EQUAL(int, shaSuccess, SHA512Reset(&context));
+    for (i = 0; i < repeat_count; i++)
+    {
+        ASSERT_ARE_EQUAL(int, shaSuccess, SHA512Input(&context, input, (unsigned int)input_length));
+    }
+    ASSERT_ARE_EQUAL(int, shaSuccess, SHA512Result(&context, digest));
+
+    to_hex(digest, SHA512HashSize, hex);
+    ASSERT_ARE_EQUAL(char_ptr, expected_hex, hex);
+}
+
+static void assert_sha512_of(const char* input, const char* expected_hex)
+{
+    assert_sha512_of_repeated_input((const uint8_t*)input, strlen(input), 1, expected_hex);
+}
+
+BEGIN_TEST_SUITE(SHA512_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    (void)SHA512SelectImplementation(sha512Unrolled);
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* SHA512IsImplementationSupported */
+
+TEST_FUNCTION(SHA512IsImplementationSupported_portable_and_unrolled_are_always_supported)
+{
+    // act
+    int portable = SHA512IsImplementationSupported(sha512Portable);
+    int unrolled = SHA512IsImplementationSupported(sha512Unrolled);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 1, portable);
+    ASSERT_ARE_EQUAL(int, 1, unrolled);
+}
+
+TEST_FUNCTION(SHA512IsImplementationSupported_unknown_implementation_is_not_supported)
+{
+    // act
+    int result = SHA512IsImplementationSupported((SHA512Implementation)42);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+}
+
+/* SHA512SelectImplementation */
+
+TEST_FUNCTION(SHA512SelectImplementation_with_unsupported_implementation_fails)
+{
+    // arrange
+    SHA512Implementation before = SHA512GetImplementation();
+
+    // act
+    int result = SHA512SelectImplementation((SHA512Implementation)42);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, shaBadParam, result);
+    ASSERT_ARE_EQUAL(int, (int)before, (int)SHA512GetImplementation());
+}
+
+TEST_FUNCTION(SHA512SelectImplementation_selects_every_supported_implementation)
+{
+    size_t i;
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        // act
+        int result = SHA512SelectImplementation(all_implementations[i]);
+
+        // assert
+        if (SHA512IsImplementationSupported(all_implementations[i]))
+        {
+            ASSERT_ARE_EQUAL(int, shaSuccess, result);
+            ASSERT_ARE_EQUAL(int, (int)all_implementations[i], (int)SHA512GetImplementation());
+        }
+        else
+        {
+            ASSERT_ARE_EQUAL(int, shaBadParam, result);
+        }
+    }
+}
+
+/* Known answer tests (FIPS 180-2, appendix C and D) */
+
+TEST_FUNCTION(SHA512_known_answers_for_every_supported_implementation)
+{
+    size_t i;
+    uint8_t* million_a = (uint8_t*)malloc(1000000);
+    ASSERT_IS_NOT_NULL(million_a);
+    (void)memset(million_a, 'a', 1000000);
+
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (SHA512SelectImplementation(all_implementations[i]) == shaSuccess)
+        {
+            assert_sha512_of("", "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e");
+            assert_sha512_of("abc", "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+            assert_sha512_of("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+                "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909");
+
+            // whole blocks hashed straight from the input, one byte at a time and in odd sized pieces
+            assert_sha512_of_repeated_input(million_a, 1000000, 1, "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b");
+            assert_sha512_of_repeated_input(million_a, 1, 1000000, "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b");
+            assert_sha512_of_repeated_input(million_a, 1000, 1000, "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b");
+        }
+    }
+
+    free(million_a);
+}
+
+TEST_FUNCTION(SHA384_known_answer_for_every_supported_implementation)
+{
+    size_t i;
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (SHA512SelectImplementation(all_implementations[i]) == shaSuccess)
+        {
+            // arrange
+            SHA384Context context;
+            uint8_t digest[SHA384HashSize];
+            char hex[2 * SHA384HashSize + 1];
+
+            // act
+            (void)SHA384Reset(&context);
+            (void)SHA384Input(&context, (const uint8_t*)"abc", 3);
+            (void)SHA384Result(&context, digest);
+
+            // assert
+            to_hex(digest, SHA384HashSize, hex);
+            ASSERT_ARE_EQUAL(char_ptr, "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7", hex);
+        }
+    }
+}
+
+TEST_FUNCTION(SHA512_every_supported_implementation_matches_portable_for_every_length)
+{
+    // up to 5 whole blocks, so that the AVX2 code hashes 4 blocks at once and then a lone one
+    uint8_t input[5 * SHA512_Message_Block_Size + 100];
+    uint8_t expected[SHA512HashSize];
+    uint8_t actual[SHA512HashSize];
+    size_t length;
+    size_t i;
+
+    for (i = 0; i < sizeof(input); i++)
+    {
+        input[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    for (length = 0; length <= sizeof(input); length++)
+    {
+        SHA512Context context;
+        (void)SHA512SelectImplementation(sha512Portable);
+        (void)SHA512Reset(&context);
+        (void)SHA512Input(&context, input, (unsigned int)length);
+        (void)SHA512Result(&context, expected);
+
+        for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+        {
+            if (SHA512SelectImplementation(all_implementations[i]) == shaSuccess)
+            {
+                // split in 2 so that both the block aligned and the unaligned paths run
+                (void)SHA512Reset(&context);
+                (void)SHA512Input(&context, input, (unsigned int)(length / 3));
+                (void)SHA512Input(&context, input + length / 3, (unsigned int)(length - length / 3));
+                (void)SHA512Result(&context, actual);
+
+                ASSERT_ARE_EQUAL(int, 0, memcmp(expected, actual, SHA512HashSize));
+            }
+        }
+    }
+}
+
+/* Throughput, reported only */
+
+TEST_FUNCTION(SHA512_throughput_of_every_supported_implementation)
+{
+    // about the size of a firmware image
+    const size_t buffer_size = 4 * 1024 * 1024;
+    const size_t iterations = 8;
+    uint8_t* buffer = (uint8_t*)malloc(buffer_size);
+    size_t i;
+    ASSERT_IS_NOT_NULL(buffer);
+    (void)memset(buffer, 0x5A, buffer_size);
+
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (SHA512SelectImplementation(all_implementations[i]) == shaSuccess)
+        {
+            SHA512Context context;
+            uint8_t digest[SHA512HashSize];
+            size_t j;
+            clock_t start = clock();
+            double seconds;
+
+            (void)SHA512Reset(&context);
+            for (j = 0; j < iterations; j++)
+            {
+                (void)SHA512Input(&context, buffer, (unsigned int)buffer_size);
+            }
+            (void)SHA512Result(&context, digest);
+
+            seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+            (void)printf("SHA-512 %s: %.1f MB/s\r\n", implementation_name(all_implementations[i]),
+                (seconds > 0) ? (double)(iterations * (buffer_size / (1024 * 1024))) / seconds : 0.0);
+        }
+    }
+
+    free(buffer);
+}
+
+END_TEST_SUITE(SHA512_UnitTests)
@@ -298,6 +298,137 @@ BEGIN_TEST_SUITE(strings_unittests)
         ASSERT_IS_NULL(g_hString);
     }
 
+    /* Tests_SRS_STRING_99_007: [ If psz is NULL, or allocating memory fails, STRING_construct_inline shall return NULL. ]*/
+    TEST_FUNCTION(STRING_construct_inline_with_NULL_fails)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+
+        ///act
+        g_hString = STRING_construct_inline(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(g_hString);
+    }
+
+    /* Tests_SRS_STRING_99_008: [ STRING_construct_inline shall allocate the STRING and room for at least 32 characters, or for psz and its terminating '\0' when it is longer, in a single allocation. ]*/
+    /* Tests_SRS_STRING_99_009: [ STRING_construct_inline shall copy psz into the room that follows the STRING and return a non-NULL handle. ]*/
+    TEST_FUNCTION(STRING_construct_inline_succeeds_with_a_single_allocation)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        g_hString = STRING_construct_inline(TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(g_hString);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_99_007: [ If psz is NULL, or allocating memory fails, STRING_construct_inline shall return NULL. ]*/
+    TEST_FUNCTION(STRING_construct_inline_fails_when_malloc_fails)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1)
+            .SetReturn(NULL);
+
+        ///act
+        g_hString = STRING_construct_inline(TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_IS_NULL(g_hString);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_STRING_99_010: [ The functions that change the content of a STRING made by STRING_construct_inline shall keep the characters in the allocation of the STRING while they fit and move them to memory of their own when they do not. ]*/
+    TEST_FUNCTION(STRING_concat_to_an_inline_STRING_that_fits_does_not_allocate)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString = STRING_construct_inline(INITIAL_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, COMBINED_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_99_010: [ The functions that change the content of a STRING made by STRING_construct_inline shall keep the characters in the allocation of the STRING while they fit and move them to memory of their own when they do not. ]*/
+    TEST_FUNCTION(STRING_concat_to_an_inline_STRING_that_does_not_fit_moves_the_characters)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString = STRING_construct_inline(COMBINED_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(COMBINED_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1));
+
+        ///act
+        nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, "Initial_DataValueTestDataValueTest", STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_07_010: [STRING_delete will free the memory allocated by the STRING_HANDLE.] */
+    TEST_FUNCTION(STRING_delete_of_an_inline_STRING_frees_a_single_block)
+    {
+        ///arrange
+        STRING_HANDLE g_hString = STRING_construct_inline(TEST_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(g_hString));
+
+        ///act
+        STRING_delete(g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_STRING_07_010: [STRING_delete will free the memory allocated by the STRING_HANDLE.] */
+    TEST_FUNCTION(STRING_delete_of_an_inline_STRING_whose_characters_moved_frees_them)
+    {
+        ///arrange
+        STRING_HANDLE g_hString = STRING_construct_inline(COMBINED_STRING_VALUE);
+        (void)STRING_concat(g_hString, TEST_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(g_hString));
+
+        ///act
+        STRING_delete(g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
     /* Tests_SRS_STRING_07_008: [STRING_new_quoted shall return a valid STRING_HANDLE Copying the supplied const char* value surrounded by quotes.] */
     TEST_FUNCTION(STRING_new_quoted_Succeed)
     {
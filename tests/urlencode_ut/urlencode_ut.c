@@ -5,10 +5,12 @@
 #include <cstdlib>
 #include <cstdio>
 #include <cstddef>
+#include <cstring>
 #else
 #include <stdlib.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
 #endif
 
 #include "testrunnerswitcher.h"
@@ -584,4 +586,291 @@ TEST_FUNCTION(URL_Exhaustive_chars)
     }
 }
 
+/*Tests_SRS_URL_ENCODE_99_001: [ If text is NULL, URL_Encode_Length shall return 0. ]*/
+TEST_FUNCTION(URL_Encode_Length_with_NULL_text_returns_0)
+{
+    // act
+    size_t result = URL_Encode_Length(NULL, 3);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/*Tests_SRS_URL_ENCODE_99_002: [ Otherwise URL_Encode_Length shall return the number of characters URL_Encode_Into writes for the length characters at text. ]*/
+TEST_FUNCTION(URL_Encode_Length_Exhaustive_chars)
+{
+    size_t i;
+    size_t numberOfTests = sizeof(testVector) / sizeof(testVector[i]);
+    for (i = 0; i < numberOfTests; i++)
+    {
+        // act
+        size_t result = URL_Encode_Length(testVector[i].inputData, strlen(testVector[i].inputData));
+
+        //assert
+        ASSERT_ARE_EQUAL(size_t, strlen(testVector[i].expectedOutput), result);
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_99_003: [ If text, destination or encodedLength is NULL, URL_Encode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_Encode_Into_with_NULL_arguments_fails)
+{
+    // arrange
+    char destination[8];
+    size_t encodedLength;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_Encode_Into(NULL, 1, destination, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_Encode_Into("a", 1, NULL, sizeof(destination), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_Encode_Into("a", 1, destination, sizeof(destination), NULL));
+}
+
+/*Tests_SRS_URL_ENCODE_99_005: [ If destinationSize is smaller than the encoding, URL_Encode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_Encode_Into_with_small_destination_fails)
+{
+    // arrange
+    char destination[8];
+    size_t encodedLength;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_Encode_Into("abc", 3, destination, 2, &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_Encode_Into("a/", 2, destination, 3, &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_Encode_Into("a\xe9", 2, destination, 6, &encodedLength));
+}
+
+/*Tests_SRS_URL_ENCODE_99_004: [ URL_Encode_Into shall write in destination the length characters at text, each character encoded the way URL_Encode does, without a null terminator. ]*/
+/*Tests_SRS_URL_ENCODE_99_006: [ On success URL_Encode_Into shall set encodedLength to the number of characters written and return 0. ]*/
+TEST_FUNCTION(URL_Encode_Into_Exhaustive_chars)
+{
+    size_t i;
+    size_t numberOfTests = sizeof(testVector) / sizeof(testVector[i]);
+    for (i = 0; i < numberOfTests; i++)
+    {
+        // arrange
+        char destination[8];
+        size_t encodedLength;
+        size_t expectedLength = strlen(testVector[i].expectedOutput);
+        (void)memset(destination, '#', sizeof(destination));
+
+        // act
+        int result = URL_Encode_Into(testVector[i].inputData, strlen(testVector[i].inputData), destination, expectedLength, &encodedLength);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, expectedLength, encodedLength);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(testVector[i].expectedOutput, destination, encodedLength));
+        ASSERT_ARE_EQUAL(char, '#', destination[encodedLength]);
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_99_004: [ URL_Encode_Into shall write in destination the length characters at text, each character encoded the way URL_Encode does, without a null terminator. ]*/
+TEST_FUNCTION(URL_Encode_Into_reserved_char_at_every_position_of_a_long_text)
+{
+    // long enough for several 16 character steps of the vectorized run
+    char text[70];
+    char expected[70 + 6];
+    char destination[70 + 6];
+    size_t position;
+    size_t i;
+    for (i = 0; i < sizeof(testVector) / sizeof(testVector[0]); i++)
+    {
+        unsigned char reserved = (unsigned char)testVector[i].inputData[0];
+        if (strlen(testVector[i].inputData) == 1 && strlen(testVector[i].expectedOutput) > 1)
+        {
+            size_t reservedSize = strlen(testVector[i].expectedOutput);
+            for (position = 0; position < sizeof(text); position++)
+            {
+                // arrange
+                size_t encodedLength;
+                int result;
+                (void)memset(text, 'a', sizeof(text));
+                text[position] = (char)reserved;
+                (void)memset(expected, 'a', sizeof(expected));
+                (void)memcpy(expected + position, testVector[i].expectedOutput, reservedSize);
+
+                // act
+                result = URL_Encode_Into(text, sizeof(text), destination, sizeof(text) - 1 + reservedSize, &encodedLength);
+
+                //assert
+                ASSERT_ARE_EQUAL(int, 0, result);
+                ASSERT_ARE_EQUAL(size_t, sizeof(text) - 1 + reservedSize, encodedLength);
+                ASSERT_ARE_EQUAL(int, 0, memcmp(expected, destination, encodedLength));
+            }
+        }
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_99_007: [ If destination or textEncode is NULL, URL_EncodeAppend shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_EncodeAppend_with_NULL_arguments_fails)
+{
+    // arrange
+    STRING_HANDLE destination = STRING_construct("x");
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeAppend(NULL, "a"));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeAppend(destination, NULL));
+    ASSERT_ARE_EQUAL(char_ptr, "x", STRING_c_str(destination));
+
+    // cleanup
+    STRING_delete(destination);
+}
+
+/*Tests_SRS_URL_ENCODE_99_008: [ Otherwise URL_EncodeAppend shall append the encoding of textEncode, as URL_EncodeString produces it, to destination and return 0. ]*/
+TEST_FUNCTION(URL_EncodeAppend_appends_the_encoding)
+{
+    // arrange
+    STRING_HANDLE destination = STRING_construct("sr=");
+
+    // act
+    int result = URL_EncodeAppend(destination, "myhub.azure-devices.net/devices/d1");
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "sr=myhub.azure-devices.net%2fdevices%2fd1", STRING_c_str(destination));
+
+    // cleanup
+    STRING_delete(destination);
+}
+
+/*Tests_SRS_URL_ENCODE_99_008: [ Otherwise URL_EncodeAppend shall append the encoding of textEncode, as URL_EncodeString produces it, to destination and return 0. ]*/
+TEST_FUNCTION(URL_EncodeAppend_appends_a_long_encoding)
+{
+    // arrange
+    char text[400];
+    STRING_HANDLE destination = STRING_construct("x");
+    STRING_HANDLE expected;
+    int result;
+    (void)memset(text, '/', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    expected = URL_EncodeString(text);
+
+    // act
+    result = URL_EncodeAppend(destination, text);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, STRING_c_str(expected), STRING_c_str(destination) + 1);
+
+    // cleanup
+    STRING_delete(expected);
+    STRING_delete(destination);
+}
+
+/*Tests_SRS_URL_ENCODE_99_010: [ If input is NULL, URL_Decode shall return NULL. ]*/
+TEST_FUNCTION(URL_Decode_with_NULL_input_returns_NULL)
+{
+    // act
+    STRING_HANDLE result = URL_Decode(NULL);
+
+    //assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_URL_ENCODE_99_011: [ URL_Decode shall return a new STRING with each "%xx" of input, xx being 2 hexadecimal digits in either case, replaced by the byte xx, and all the other characters copied. ]*/
+TEST_FUNCTION(URL_Decode_decodes_every_ASCII_char)
+{
+    size_t i;
+    size_t numberOfTests = sizeof(testVector) / sizeof(testVector[i]);
+    for (i = 0; i < numberOfTests; i++)
+    {
+        if ((unsigned char)testVector[i].inputData[0] < 0x80)
+        {
+            // arrange
+            STRING_HANDLE encoded = STRING_construct(testVector[i].expectedOutput);
+
+            // act
+            STRING_HANDLE decoded = URL_Decode(encoded);
+
+            //assert
+            ASSERT_IS_NOT_NULL(decoded);
+            ASSERT_ARE_EQUAL(char_ptr, testVector[i].inputData, STRING_c_str(decoded));
+
+            // cleanup
+            STRING_delete(decoded);
+            STRING_delete(encoded);
+        }
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_99_011: [ URL_Decode shall return a new STRING with each "%xx" of input, xx being 2 hexadecimal digits in either case, replaced by the byte xx, and all the other characters copied. ]*/
+TEST_FUNCTION(URL_Decode_decodes_uppercase_hex_UTF8_and_leaves_plus)
+{
+    // act
+    STRING_HANDLE decoded = URL_DecodeString("a%2Fb%2fc+d%c3%a9");
+
+    //assert
+    ASSERT_IS_NOT_NULL(decoded);
+    ASSERT_ARE_EQUAL(char_ptr, "a/b/c+d\xc3\xa9", STRING_c_str(decoded));
+
+    // cleanup
+    STRING_delete(decoded);
+}
+
+/*Tests_SRS_URL_ENCODE_99_011: [ URL_Decode shall return a new STRING with each "%xx" of input, xx being 2 hexadecimal digits in either case, replaced by the byte xx, and all the other characters copied. ]*/
+TEST_FUNCTION(URL_Decode_gives_the_UTF8_encoding_of_the_Latin1_chars_URL_Encode_encoded)
+{
+    // arrange
+    STRING_HANDLE input = STRING_construct("caf\xe9 \xff");
+    STRING_HANDLE encoded = URL_Encode(input);
+
+    // act
+    STRING_HANDLE decoded = URL_Decode(encoded);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "caf%c3%a9%20%c3%bf", STRING_c_str(encoded));
+    ASSERT_IS_NOT_NULL(decoded);
+    ASSERT_ARE_EQUAL(char_ptr, "caf\xc3\xa9 \xc3\xbf", STRING_c_str(decoded));
+
+    // cleanup
+    STRING_delete(decoded);
+    STRING_delete(encoded);
+    STRING_delete(input);
+}
+
+/*Tests_SRS_URL_ENCODE_99_013: [ If input has a '%' that is not followed by 2 hexadecimal digits, or a "%00", URL_Decode shall return NULL. ]*/
+TEST_FUNCTION(URL_Decode_with_invalid_escapes_returns_NULL)
+{
+    static const char* const invalidEncodings[] = { "%", "a%", "a%2", "%2g", "%g2", "%%41", "a%00b" };
+    size_t i;
+    for (i = 0; i < sizeof(invalidEncodings) / sizeof(invalidEncodings[0]); i++)
+    {
+        // act
+        STRING_HANDLE decoded = URL_DecodeString(invalidEncodings[i]);
+
+        //assert
+        ASSERT_IS_NULL(decoded);
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_99_014: [ If textDecode is NULL, URL_DecodeString shall return NULL. ]*/
+TEST_FUNCTION(URL_DecodeString_with_NULL_input_returns_NULL)
+{
+    // act
+    STRING_HANDLE result = URL_DecodeString(NULL);
+
+    //assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_URL_ENCODE_99_015: [ Otherwise URL_DecodeString shall decode textDecode the way URL_Decode does. ]*/
+TEST_FUNCTION(URL_DecodeString_reverses_URL_EncodeString)
+{
+    // arrange
+    const char* fullUrl = "https://one.two.three.four-five.com/six/Seven('EightNine1234567890.Ten_Eleven')?twelve-thirteen=2015-11-31 HTTP/1.1";
+    STRING_HANDLE encoded = URL_EncodeString(fullUrl);
+
+    // act
+    STRING_HANDLE decoded = URL_DecodeString(STRING_c_str(encoded));
+
+    //assert
+    ASSERT_IS_NOT_NULL(decoded);
+    ASSERT_ARE_EQUAL(char_ptr, fullUrl, STRING_c_str(decoded));
+
+    // cleanup
+    STRING_delete(decoded);
+    STRING_delete(encoded);
+}
+
 END_TEST_SUITE(URLEncode_UnitTests)
@@ -14,9 +14,11 @@
 #ifdef __cplusplus
 #include <cstddef>
 #include <cstdbool>
+#include <cstring>
 #else
 #include <stddef.h>
 #include <stdbool.h>
+#include <string.h>
 #endif
 
 #include "testrunnerswitcher.h"
@@ -25,6 +27,76 @@
 static TEST_MUTEX_HANDLE g_testByTest;
 static TEST_MUTEX_HANDLE g_dllByDll;
 
+static const UTF8_CHECKER_IMPLEMENTATION all_implementations[] =
+{
+    UTF8_CHECKER_IMPLEMENTATION_SCALAR,
+    UTF8_CHECKER_IMPLEMENTATION_SSSE3,
+    UTF8_CHECKER_IMPLEMENTATION_AVX2,
+    UTF8_CHECKER_IMPLEMENTATION_NEON
+};
+#define IMPLEMENTATION_COUNT (sizeof(all_implementations) / sizeof(all_implementations[0]))
+
+/* sequences at the edges of what is accepted, valid or not */
+static const char* const edge_cases[] =
+{
+    "\xC2\x80", "\xDF\xBF", "\xE0\xA0\x80", "\xED\xA0\x80", "\xEF\xBF\xBF", "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF", "\xF7\xBF\xBF\xBF",
+    "\xC0\x80", "\xC1\xBF", "\xE0\x9F\xBF", "\xF0\x8F\xBF\xBF", "\xF8\x88\x80\x80\x80", "\xFF", "\x80", "\xBF",
+    "\xC2", "\xE0\xA0", "\xF0\x90\x80", "\xC2\x41", "\xE1\x80\x41", "\xF1\x80\x80\x41", "\xC2\x80\x80", "\xE1\x80\x80\x80"
+};
+#define EDGE_CASE_COUNT (sizeof(edge_cases) / sizeof(edge_cases[0]))
+
+static unsigned int random_state;
+
+static unsigned char next_random_byte(void)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (unsigned char)(random_state >> 16);
+}
+
+/* bytes that are mostly valid UTF-8, so that the errors are not all found in the first few bytes */
+static void fill_with_mostly_valid_utf8(unsigned char* buffer, size_t length)
+{
+    static const char* const pieces[] = { "a", "0", " ", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xED\x9F\xBF" };
+    size_t pos = 0;
+    while (pos < length)
+    {
+        unsigned char r = next_random_byte();
+        if (r < 4)
+        {
+            buffer[pos++] = next_random_byte();
+        }
+        else
+        {
+            const char* piece = pieces[r % (sizeof(pieces) / sizeof(pieces[0]))];
+            size_t i;
+            for (i = 0; (piece[i] != '\0') && (pos < length); i++)
+            {
+                buffer[pos++] = (unsigned char)piece[i];
+            }
+        }
+    }
+}
+
+static bool is_valid_with(UTF8_CHECKER_IMPLEMENTATION implementation, const unsigned char* utf8_str, size_t length)
+{
+    (void)utf8_checker_select_implementation(implementation);
+    return utf8_checker_is_valid_utf8(utf8_str, length);
+}
+
+static bool is_valid_incrementally(const unsigned char* utf8_str, size_t length, size_t piece_length)
+{
+    UTF8_CHECKER_CONTEXT context;
+    size_t pos = 0;
+    (void)utf8_checker_init(&context);
+    while (pos < length)
+    {
+        size_t this_piece = (length - pos < piece_length) ? length - pos : piece_length;
+        (void)utf8_checker_update(&context, utf8_str + pos, this_piece);
+        pos += this_piece;
+    }
+    return utf8_checker_final(&context);
+}
+
 BEGIN_TEST_SUITE(utf8_checker_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -562,4 +634,361 @@ TEST_FUNCTION(utf8_checker_with_4th_char_bad_fails)
     ASSERT_IS_FALSE(result);
 }
 
+/* utf8_checker_select_implementation */
+
+/* Tests_SRS_UTF8_CHECKER_99_003: [ If `implementation` is not supported by this build or by this CPU, `utf8_checker_select_implementation` shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(utf8_checker_select_implementation_with_unknown_implementation_fails)
+{
+    // arrange
+    UTF8_CHECKER_IMPLEMENTATION before = utf8_checker_get_implementation();
+    int result;
+
+    // act
+    result = utf8_checker_select_implementation((UTF8_CHECKER_IMPLEMENTATION)42);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, (int)before, (int)utf8_checker_get_implementation());
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_004: [ Otherwise `utf8_checker_select_implementation` shall make all the validation functions use `implementation` and return 0. ]*/
+/* Tests_SRS_UTF8_CHECKER_99_005: [ `utf8_checker_get_implementation` shall return the implementation in use, picking the fastest one supported by the CPU if none is selected yet. ]*/
+TEST_FUNCTION(utf8_checker_select_implementation_selects_every_supported_implementation)
+{
+    size_t i;
+
+    // act
+    int result = utf8_checker_select_implementation(UTF8_CHECKER_IMPLEMENTATION_SCALAR);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, (int)UTF8_CHECKER_IMPLEMENTATION_SCALAR, (int)utf8_checker_get_implementation());
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (utf8_checker_select_implementation(all_implementations[i]) == 0)
+        {
+            ASSERT_ARE_EQUAL(int, (int)all_implementations[i], (int)utf8_checker_get_implementation());
+        }
+    }
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_001: [ `utf8_checker_is_valid_utf8` shall skip runs of ASCII characters several bytes at a time. ]*/
+/* Tests_SRS_UTF8_CHECKER_99_002: [ `utf8_checker_is_valid_utf8` shall validate with the implementation in use, which shall accept and reject exactly the same sequences as the byte by byte validation. ]*/
+TEST_FUNCTION(utf8_checker_every_implementation_matches_scalar_for_edge_cases_at_every_offset)
+{
+    // arrange
+    unsigned char buffer[100];
+    size_t edge_case;
+    size_t offset;
+    size_t i;
+
+    for (edge_case = 0; edge_case < EDGE_CASE_COUNT; edge_case++)
+    {
+        size_t edge_case_length = strlen(edge_cases[edge_case]);
+        for (offset = 0; offset + edge_case_length <= sizeof(buffer); offset++)
+        {
+            size_t lengths[2];
+            size_t l;
+            (void)memset(buffer, 'a', sizeof(buffer));
+            (void)memcpy(buffer + offset, edge_cases[edge_case], edge_case_length);
+
+            // the edge case right at the end of the text and in its middle
+            lengths[0] = offset + edge_case_length;
+            lengths[1] = sizeof(buffer);
+            for (l = 0; l < 2; l++)
+            {
+                bool expected = is_valid_with(UTF8_CHECKER_IMPLEMENTATION_SCALAR, buffer, lengths[l]);
+                for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+                {
+                    if (utf8_checker_select_implementation(all_implementations[i]) == 0)
+                    {
+                        // act
+                        bool result = utf8_checker_is_valid_utf8(buffer, lengths[l]);
+
+                        // assert
+                        ASSERT_ARE_EQUAL(int, (int)expected, (int)result);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_FUNCTION(utf8_checker_edge_cases_are_accepted_and_rejected_as_before)
+{
+    size_t i;
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (utf8_checker_select_implementation(all_implementations[i]) == 0)
+        {
+            // surrogates and code points up to 0x1FFFFF are accepted
+            ASSERT_IS_TRUE(utf8_checker_is_valid_utf8((const unsigned char*)"\xED\xA0\x80", 3));
+            ASSERT_IS_TRUE(utf8_checker_is_valid_utf8((const unsigned char*)"\xF7\xBF\xBF\xBF", 4));
+            // overlong forms, bytes that never appear, lone continuation bytes and cut sequences are not
+            ASSERT_IS_FALSE(utf8_checker_is_valid_utf8((const unsigned char*)"\xC1\xBF", 2));
+            ASSERT_IS_FALSE(utf8_checker_is_valid_utf8((const unsigned char*)"\xE0\x9F\xBF", 3));
+            ASSERT_IS_FALSE(utf8_checker_is_valid_utf8((const unsigned char*)"\xF0\x8F\xBF\xBF", 4));
+            ASSERT_IS_FALSE(utf8_checker_is_valid_utf8((const unsigned char*)"\xF8\x88\x80\x80\x80", 5));
+            ASSERT_IS_FALSE(utf8_checker_is_valid_utf8((const unsigned char*)"abc\x80", 4));
+            ASSERT_IS_FALSE(utf8_checker_is_valid_utf8((const unsigned char*)"abc\xE2\x82", 5));
+        }
+    }
+}
+
+TEST_FUNCTION(utf8_checker_every_implementation_matches_scalar_for_random_text)
+{
+    // arrange
+    unsigned char buffer[300];
+    size_t length;
+    size_t round;
+    size_t i;
+
+    random_state = 42;
+    for (round = 0; round < 20; round++)
+    {
+        for (length = 0; length <= sizeof(buffer); length++)
+        {
+            bool expected;
+            fill_with_mostly_valid_utf8(buffer, length);
+            expected = is_valid_with(UTF8_CHECKER_IMPLEMENTATION_SCALAR, buffer, length);
+
+            for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+            {
+                if (utf8_checker_select_implementation(all_implementations[i]) == 0)
+                {
+                    // act
+                    bool result = utf8_checker_is_valid_utf8(buffer, length);
+
+                    // assert
+                    ASSERT_ARE_EQUAL(int, (int)expected, (int)result);
+                }
+            }
+        }
+    }
+}
+
+TEST_FUNCTION(utf8_checker_every_implementation_finds_a_bad_byte_anywhere_in_valid_text)
+{
+    // arrange
+    static const unsigned char bad_bytes[] = { 0x80, 0xBF, 0xC0, 0xE0, 0xF0, 0xF8, 0xFF };
+    unsigned char text[200];
+    size_t pos;
+    size_t b;
+    size_t i;
+
+    for (pos = 0; pos + 3 <= sizeof(text); pos += 3)
+    {
+        (void)memcpy(text + pos, "\xE2\x82\xAC", 3);
+    }
+    text[198] = 'a';
+    text[199] = 'b';
+
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (utf8_checker_select_implementation(all_implementations[i]) == 0)
+        {
+            ASSERT_IS_TRUE(utf8_checker_is_valid_utf8(text, sizeof(text)));
+            for (pos = 0; pos < sizeof(text); pos++)
+            {
+                for (b = 0; b < sizeof(bad_bytes); b++)
+                {
+                    unsigned char saved = text[pos];
+                    bool expected;
+                    text[pos] = bad_bytes[b];
+                    expected = is_valid_with(UTF8_CHECKER_IMPLEMENTATION_SCALAR, text, sizeof(text));
+                    (void)utf8_checker_select_implementation(all_implementations[i]);
+
+                    ASSERT_ARE_EQUAL(int, (int)expected, (int)utf8_checker_is_valid_utf8(text, sizeof(text)));
+                    text[pos] = saved;
+                }
+            }
+        }
+    }
+}
+
+/* utf8_checker_init */
+
+/* Tests_SRS_UTF8_CHECKER_99_006: [ If `context` is NULL, `utf8_checker_init` shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(utf8_checker_init_with_NULL_context_fails)
+{
+    // act
+    int result = utf8_checker_init(NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_007: [ Otherwise `utf8_checker_init` shall start a validation with no bytes seen and return 0. ]*/
+TEST_FUNCTION(utf8_checker_init_then_final_succeeds)
+{
+    // arrange
+    UTF8_CHECKER_CONTEXT context;
+
+    // act
+    int result = utf8_checker_init(&context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(utf8_checker_final(&context));
+}
+
+/* utf8_checker_update */
+
+/* Tests_SRS_UTF8_CHECKER_99_008: [ If `context` is NULL, `utf8_checker_update` shall return false. ]*/
+TEST_FUNCTION(utf8_checker_update_with_NULL_context_fails)
+{
+    // act
+    bool result = utf8_checker_update(NULL, (const unsigned char*)"a", 1);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_009: [ If `utf8_str` is NULL and `length` is not 0, `utf8_checker_update` shall fail the whole validation and return false. ]*/
+TEST_FUNCTION(utf8_checker_update_with_NULL_string_fails_the_validation)
+{
+    // arrange
+    UTF8_CHECKER_CONTEXT context;
+    bool result;
+    (void)utf8_checker_init(&context);
+
+    // act
+    result = utf8_checker_update(&context, NULL, 1);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+    ASSERT_IS_FALSE(utf8_checker_final(&context));
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_010: [ Once a validation has failed, `utf8_checker_update` shall return false without looking at `utf8_str`. ]*/
+TEST_FUNCTION(utf8_checker_update_after_a_failure_fails)
+{
+    // arrange
+    UTF8_CHECKER_CONTEXT context;
+    bool result;
+    (void)utf8_checker_init(&context);
+    ASSERT_IS_FALSE(utf8_checker_update(&context, (const unsigned char*)"a\x80", 2));
+
+    // act
+    result = utf8_checker_update(&context, (const unsigned char*)"abc", 3);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+    ASSERT_IS_FALSE(utf8_checker_final(&context));
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_011: [ A sequence cut by the end of the previous bytes shall be completed with the first bytes of `utf8_str` and validated as a whole. ]*/
+/* Tests_SRS_UTF8_CHECKER_99_012: [ A sequence cut by the end of `utf8_str` shall be kept in `context` and validated when the next bytes arrive. ]*/
+/* Tests_SRS_UTF8_CHECKER_99_014: [ `utf8_checker_update` shall return true if all the bytes seen so far can be the start of valid UTF-8 and false otherwise. ]*/
+TEST_FUNCTION(utf8_checker_update_with_a_sequence_cut_in_pieces_succeeds)
+{
+    // arrange
+    UTF8_CHECKER_CONTEXT context;
+    (void)utf8_checker_init(&context);
+
+    // act
+    ASSERT_IS_TRUE(utf8_checker_update(&context, (const unsigned char*)"a\xF0", 2));
+    ASSERT_IS_TRUE(utf8_checker_update(&context, (const unsigned char*)"\x9F", 1));
+    ASSERT_IS_TRUE(utf8_checker_update(&context, (const unsigned char*)"", 0));
+    ASSERT_IS_TRUE(utf8_checker_update(&context, (const unsigned char*)"\x98\x80" "b", 3));
+
+    // assert
+    ASSERT_IS_TRUE(utf8_checker_final(&context));
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_011: [ A sequence cut by the end of the previous bytes shall be completed with the first bytes of `utf8_str` and validated as a whole. ]*/
+TEST_FUNCTION(utf8_checker_update_with_an_overlong_sequence_cut_in_pieces_fails)
+{
+    // arrange
+    UTF8_CHECKER_CONTEXT context;
+    bool result;
+    (void)utf8_checker_init(&context);
+    ASSERT_IS_TRUE(utf8_checker_update(&context, (const unsigned char*)"\xE0", 1));
+
+    // act
+    result = utf8_checker_update(&context, (const unsigned char*)"\x9F\xBF", 2);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+    ASSERT_IS_FALSE(utf8_checker_final(&context));
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_014: [ `utf8_checker_update` shall return true if all the bytes seen so far can be the start of valid UTF-8 and false otherwise. ]*/
+TEST_FUNCTION(utf8_checker_update_with_a_cut_sequence_followed_by_ascii_fails)
+{
+    // arrange
+    UTF8_CHECKER_CONTEXT context;
+    bool result;
+    (void)utf8_checker_init(&context);
+    ASSERT_IS_TRUE(utf8_checker_update(&context, (const unsigned char*)"\xF0\x9F", 2));
+
+    // act
+    result = utf8_checker_update(&context, (const unsigned char*)"a", 1);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_013: [ `utf8_checker_update` shall validate the rest of `utf8_str` with the implementation in use. ]*/
+TEST_FUNCTION(utf8_checker_update_matches_utf8_checker_is_valid_utf8_for_every_split)
+{
+    // arrange
+    unsigned char buffer[150];
+    size_t round;
+    size_t piece_length;
+    size_t i;
+
+    random_state = 7;
+    for (i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (utf8_checker_select_implementation(all_implementations[i]) == 0)
+        {
+            for (round = 0; round < 50; round++)
+            {
+                size_t length = next_random_byte() % sizeof(buffer);
+                bool expected;
+                fill_with_mostly_valid_utf8(buffer, length);
+                expected = utf8_checker_is_valid_utf8(buffer, length);
+
+                for (piece_length = 1; piece_length <= length; piece_length++)
+                {
+                    // act
+                    bool result = is_valid_incrementally(buffer, length, piece_length);
+
+                    // assert
+                    ASSERT_ARE_EQUAL(int, (int)expected, (int)result);
+                }
+            }
+        }
+    }
+}
+
+/* utf8_checker_final */
+
+/* Tests_SRS_UTF8_CHECKER_99_015: [ If `context` is NULL, `utf8_checker_final` shall return false. ]*/
+TEST_FUNCTION(utf8_checker_final_with_NULL_context_fails)
+{
+    // act
+    bool result = utf8_checker_final(NULL);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_99_016: [ `utf8_checker_final` shall return true if all the bytes passed to `utf8_checker_update` are valid UTF-8 and do not end in the middle of a sequence, and false otherwise. ]*/
+TEST_FUNCTION(utf8_checker_final_with_a_cut_sequence_fails)
+{
+    // arrange
+    UTF8_CHECKER_CONTEXT context;
+    bool result;
+    (void)utf8_checker_init(&context);
+    ASSERT_IS_TRUE(utf8_checker_update(&context, (const unsigned char*)"abc\xE2\x82", 5));
+
+    // act
+    result = utf8_checker_final(&context);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
 END_TEST_SUITE(utf8_checker_ut)
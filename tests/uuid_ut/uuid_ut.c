@@ -3,8 +3,10 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstring>
 #else
 #include <stdlib.h>
+#include <string.h>
 #endif
 
 #include "testrunnerswitcher.h"
@@ -34,8 +36,6 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 
 
 #define UUID_OCTET_COUNT    16
-#define UUID_STRING_LENGTH  36
-#define UUID_STRING_SIZE    (UUID_STRING_LENGTH + 1)
 
 static UUID TEST_UUID = { 222, 193, 74, 152, 197, 252, 67, 14, 180, 227, 51, 193, 196, 52, 220, 175 };
 static char* TEST_UUID_STRING = "dec14a98-c5fc-430e-b4e3-33c1c434dcaf";
@@ -47,6 +47,11 @@ static UNIQUEID_RESULT mock_UniqueId_Generate(char* uid, size_t bufferSize)
     return mock_UniqueId_Generate_result;
 }
 
+static int compare_uuids(const void* left, const void* right)
+{
+    return memcmp(left, right, sizeof(UUID));
+}
+
 static void initialize_variables()
 {
     mock_UniqueId_Generate_result = UNIQUEID_OK;
@@ -328,4 +333,167 @@ TEST_FUNCTION(UUID_from_string_succeed)
 // Tests_SRS_UUID_09_009: [ If `uuid` fails to be generated, UUID_from_string shall return a non-zero value ]
 // To be implemented once sscanf mock is implemented.
 
+// Tests_SRS_UUID_99_001: [ If `uuid` or `uuid_string` are NULL, or `uuid_string_size` is less than UUID_STRING_SIZE, UUID_to_string_into shall return a non-zero value ]
+TEST_FUNCTION(UUID_to_string_into_invalid_arguments)
+{
+    //Arrange
+    char buffer[UUID_STRING_SIZE];
+
+    umock_c_reset_all_calls();
+
+    //Act
+    //Assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, UUID_to_string_into(NULL, buffer, sizeof(buffer)));
+    ASSERT_ARE_NOT_EQUAL(int, 0, UUID_to_string_into(&TEST_UUID, NULL, sizeof(buffer)));
+    ASSERT_ARE_NOT_EQUAL(int, 0, UUID_to_string_into(&TEST_UUID, buffer, UUID_STRING_LENGTH));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+// Tests_SRS_UUID_99_002: [ UUID_to_string_into shall write each byte of `uuid` as 2 lowercase HEX digits, with dashes after the 4th, 6th, 8th and 10th bytes, and a null terminator in `uuid_string` ]
+// Tests_SRS_UUID_99_003: [ If no failures occur, UUID_to_string_into shall return zero ]
+TEST_FUNCTION(UUID_to_string_into_succeed)
+{
+    //Arrange
+    int result;
+    char buffer[UUID_STRING_SIZE + 1];
+    (void)memset(buffer, 'x', sizeof(buffer));
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_to_string_into(&TEST_UUID, buffer, sizeof(buffer));
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, TEST_UUID_STRING, buffer);
+    ASSERT_ARE_EQUAL(int, 'x', buffer[UUID_STRING_SIZE]);
+}
+
+TEST_FUNCTION(UUID_to_string_into_then_UUID_from_string_round_trips_every_byte_value)
+{
+    //Arrange
+    UUID uuid;
+    UUID parsed;
+    char buffer[UUID_STRING_SIZE];
+    int i;
+    int j;
+
+    for (i = 0; i < 256; i += 16)
+    {
+        for (j = 0; j < UUID_OCTET_COUNT; j++)
+        {
+            uuid[j] = (unsigned char)(i + j);
+        }
+
+        //Act
+        ASSERT_ARE_EQUAL(int, 0, UUID_to_string_into(&uuid, buffer, sizeof(buffer)));
+        ASSERT_ARE_EQUAL(int, 0, UUID_from_string(buffer, &parsed));
+
+        //Assert
+        ASSERT_ARE_EQUAL(int, 0, memcmp(uuid, parsed, sizeof(UUID)));
+    }
+}
+
+// Tests_SRS_UUID_99_004: [ If `uuid` is NULL, UUID_generate_fast shall return a non-zero value ]
+TEST_FUNCTION(UUID_generate_fast_NULL_uuid)
+{
+    //Arrange
+    int result;
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_generate_fast(NULL);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_99_005: [ UUID_generate_fast shall fill `uuid` with a version 4 (random) UUID as per RFC 4122 ]
+// Tests_SRS_UUID_99_006: [ If no failures occur, UUID_generate_fast shall return zero ]
+// Tests_SRS_UUID_99_009: [ The random bits shall come from a generator private to the calling thread, seeded from 2 UUIDs obtained from UniqueId_Generate on first use and again after every 2^20 UUIDs ]
+TEST_FUNCTION(UUID_generate_fast_succeed)
+{
+    //Arrange
+    UUID previous;
+    int i;
+
+    (void)memset(previous, 0, sizeof(previous));
+
+    for (i = 0; i < 100; i++)
+    {
+        UUID uuid;
+
+        //Act
+        int result = UUID_generate_fast(&uuid);
+
+        //Assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(int, 0x40, uuid[6] & 0xF0);
+        ASSERT_ARE_EQUAL(int, 0x80, uuid[8] & 0xC0);
+        ASSERT_ARE_NOT_EQUAL(int, 0, memcmp(previous, uuid, sizeof(UUID)));
+        (void)memcpy(previous, uuid, sizeof(UUID));
+    }
+}
+
+// Tests_SRS_UUID_99_007: [ If `uuids` is NULL, UUID_generate_batch shall return a non-zero value ]
+TEST_FUNCTION(UUID_generate_batch_NULL_uuids)
+{
+    //Arrange
+    int result;
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_generate_batch(NULL, 1);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_99_011: [ If no failures occur, UUID_generate_batch shall return zero ]
+TEST_FUNCTION(UUID_generate_batch_with_0_count_succeeds)
+{
+    //Arrange
+    UUID uuid;
+    int result;
+
+    //Act
+    result = UUID_generate_batch(&uuid, 0);
+
+    //Assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_99_008: [ UUID_generate_batch shall fill the `count` UUIDs at `uuids` with version 4 (random) UUIDs as per RFC 4122 ]
+// Tests_SRS_UUID_99_011: [ If no failures occur, UUID_generate_batch shall return zero ]
+TEST_FUNCTION(UUID_generate_batch_generates_distinct_uuids)
+{
+    //Arrange
+    // malloc is mocked in this suite
+    static UUID uuids[10000];
+    const size_t count = sizeof(uuids) / sizeof(uuids[0]);
+    size_t i;
+    int result;
+
+    //Act
+    result = UUID_generate_batch(uuids, count);
+
+    //Assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    qsort(uuids, count, sizeof(UUID), compare_uuids);
+    for (i = 0; i < count; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0x40, uuids[i][6] & 0xF0);
+        ASSERT_ARE_EQUAL(int, 0x80, uuids[i][8] & 0xC0);
+        if (i > 0)
+        {
+            ASSERT_ARE_NOT_EQUAL(int, 0, memcmp(uuids[i - 1], uuids[i], sizeof(UUID)));
+        }
+    }
+}
+
 END_TEST_SUITE(uuid_unittests)
@@ -58,6 +58,14 @@ static bool VECTOR_UNITTEST_isEqual(const void* left_hand_side, const void* righ
     return (rhs->nValue1 == lhs->nValue1 && rhs->lValue2 == lhs->lValue2);
 }
 
+static int VECTOR_UNITTEST_compare(const void* left, const void* right)
+{
+    const VECTOR_UNITTEST* lhs = (const VECTOR_UNITTEST*)left;
+    const VECTOR_UNITTEST* rhs = (const VECTOR_UNITTEST*)right;
+
+    return (lhs->nValue1 < rhs->nValue1) ? -1 : ((lhs->nValue1 > rhs->nValue1) ? 1 : 0);
+}
+
 #define NUM_ITEM_PUSH_BACK      128
 
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -169,6 +177,8 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         ASSERT_IS_NOT_NULL(test);
         ASSERT_ARE_EQUAL(size_t, VECTOR_size(test), 2);
         ASSERT_ARE_EQUAL(size_t, VECTOR_size(handle), 0);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(test));
+        ASSERT_ARE_EQUAL(size_t, 0, VECTOR_capacity(handle));
         current = (VECTOR_UNITTEST *)VECTOR_element(test, 0);
         ASSERT_ARE_EQUAL(int, sItem1.nValue1, current->nValue1);
         ASSERT_ARE_EQUAL(long, sItem1.lValue2, current->lValue2);
@@ -352,6 +362,110 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
+    /* Tests_SRS_VECTOR_99_001: [VECTOR_push_back shall grow the internal storage only when it has no room for `numElements` more elements.] */
+    TEST_FUNCTION(VECTOR_push_back_does_not_allocate_when_there_is_room)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_reserve(handle, 2);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_push_back(handle, &sItem, 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_002: [When it grows the internal storage, VECTOR_push_back shall at least double its capacity.] */
+    TEST_FUNCTION(VECTOR_push_back_doubles_the_capacity)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 4 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_push_back(handle, &sItem, 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 3, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 4, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_002: [When it grows the internal storage, VECTOR_push_back shall at least double its capacity.] */
+    TEST_FUNCTION(VECTOR_push_back_of_many_elements_grows_to_fit_them)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItems[5] = { {1, 2}, {3, 4}, {5, 6}, {7, 8}, {9, 10} };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItems[0], 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 6 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_push_back(handle, sItems, 5);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 6, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 6, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(int, 9, ((VECTOR_UNITTEST*)VECTOR_back(handle))->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_10_012: [VECTOR_push_back shall fail and return non - zero if memory allocation fails.] */
+    TEST_FUNCTION(VECTOR_push_back_keeps_the_elements_if_growing_fails)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem1 = {1, 2};
+        VECTOR_UNITTEST sItem2 = {3, 4};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem1, 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr()
+            .SetReturn(NULL);
+
+        ///act
+        result = VECTOR_push_back(handle, &sItem2, 1);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(int, 1, ((VECTOR_UNITTEST*)VECTOR_front(handle))->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
     /* Tests_SRS_VECTOR_10_026: [VECTOR_size shall return 0 if the given handle is NULL.] */
     TEST_FUNCTION(VECTOR_size_fails_if_handle_is_NULL)
     {
@@ -484,6 +598,128 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
+    /* Tests_SRS_VECTOR_99_016: [VECTOR_binary_search shall fail and return NULL if `handle`, `value` or `compare` is NULL.] */
+    TEST_FUNCTION(VECTOR_binary_search_fails_if_handle_is_NULL)
+    {
+        ///arrange
+        void* result;
+        VECTOR_UNITTEST sItem = {1, 2};
+
+        ///act
+        result = VECTOR_binary_search(NULL, &sItem, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_99_016: [VECTOR_binary_search shall fail and return NULL if `handle`, `value` or `compare` is NULL.] */
+    TEST_FUNCTION(VECTOR_binary_search_fails_if_value_is_NULL)
+    {
+        ///arrange
+        void* result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_binary_search(handle, NULL, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_016: [VECTOR_binary_search shall fail and return NULL if `handle`, `value` or `compare` is NULL.] */
+    TEST_FUNCTION(VECTOR_binary_search_fails_if_compare_is_NULL)
+    {
+        ///arrange
+        void* result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_binary_search(handle, &sItem, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_017: [VECTOR_binary_search shall return an element of the vector, sorted in the order defined by `compare`, that compares equal to `value`.] */
+    TEST_FUNCTION(VECTOR_binary_search_succeeds)
+    {
+        ///arrange
+        VECTOR_UNITTEST* result;
+        VECTOR_UNITTEST sItems[4] = { {1, 2}, {3, 4}, {5, 6}, {7, 8} };
+        VECTOR_UNITTEST sKey = {5, 0};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 4);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = (VECTOR_UNITTEST*)VECTOR_binary_search(handle, &sKey, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, VECTOR_element(handle, 2), result);
+        ASSERT_ARE_EQUAL(long, 6, result->lValue2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_018: [VECTOR_binary_search shall return NULL if no element compares equal to `value`.] */
+    TEST_FUNCTION(VECTOR_binary_search_return_null_if_no_match)
+    {
+        ///arrange
+        void* result;
+        VECTOR_UNITTEST sItems[4] = { {1, 2}, {3, 4}, {5, 6}, {7, 8} };
+        VECTOR_UNITTEST sKey = {4, 0};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 4);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_binary_search(handle, &sKey, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_018: [VECTOR_binary_search shall return NULL if no element compares equal to `value`.] */
+    TEST_FUNCTION(VECTOR_binary_search_return_null_if_vector_is_empty)
+    {
+        ///arrange
+        void* result;
+        VECTOR_UNITTEST sKey = {1, 0};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_binary_search(handle, &sKey, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
     /* Tests_SRS_VECTOR_10_017: [VECTOR_clear shall if the object is NULL or empty.] */
     TEST_FUNCTION(VECTOR_clear_fails_if_handle_is_NULL)
     {
@@ -541,6 +777,65 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
+    /* Tests_SRS_VECTOR_99_014: [VECTOR_sort shall return if `handle` or `compare` is NULL.] */
+    TEST_FUNCTION(VECTOR_sort_fails_if_handle_is_NULL)
+    {
+        ///arrange
+
+        ///act
+        VECTOR_sort(NULL, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_99_014: [VECTOR_sort shall return if `handle` or `compare` is NULL.] */
+    TEST_FUNCTION(VECTOR_sort_fails_if_compare_is_NULL)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItems[2] = { {3, 4}, {1, 2} };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 2);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_sort(handle, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 3, ((VECTOR_UNITTEST*)VECTOR_element(handle, 0))->nValue1);
+        ASSERT_ARE_EQUAL(int, 1, ((VECTOR_UNITTEST*)VECTOR_element(handle, 1))->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_015: [VECTOR_sort shall sort the elements in place in the order defined by `compare`.] */
+    TEST_FUNCTION(VECTOR_sort_succeeds)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItems[4] = { {7, 8}, {1, 2}, {5, 6}, {3, 4} };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 4);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_sort(handle, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 4, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(int, 1, ((VECTOR_UNITTEST*)VECTOR_element(handle, 0))->nValue1);
+        ASSERT_ARE_EQUAL(long, 2, ((VECTOR_UNITTEST*)VECTOR_element(handle, 0))->lValue2);
+        ASSERT_ARE_EQUAL(int, 3, ((VECTOR_UNITTEST*)VECTOR_element(handle, 1))->nValue1);
+        ASSERT_ARE_EQUAL(int, 5, ((VECTOR_UNITTEST*)VECTOR_element(handle, 2))->nValue1);
+        ASSERT_ARE_EQUAL(int, 7, ((VECTOR_UNITTEST*)VECTOR_element(handle, 3))->nValue1);
+        ASSERT_ARE_EQUAL(long, 8, ((VECTOR_UNITTEST*)VECTOR_element(handle, 3))->lValue2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
     /* Tests_SRS_VECTOR_10_018: [VECTOR_element shall return a pointer to the element at the given index.] */
     TEST_FUNCTION(VECTOR_element_succeeds)
     {
@@ -776,7 +1071,8 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
-    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements` and reduce its internal storage.] */
+    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements`.] */
+    /* Tests_SRS_VECTOR_99_003: [VECTOR_erase shall keep the internal storage and the capacity of the vector.] */
     TEST_FUNCTION(VECTOR_erase_succeeds_case_1)
     {
         ///arrange
@@ -789,8 +1085,6 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         (void)VECTOR_push_back(handle, &sItem2, 1);
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         umock_c_reset_all_calls();
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, sizeof(VECTOR_UNITTEST)))
-            .IgnoreArgument_ptr();
 
         ///act
         VECTOR_erase(handle, pfindItem, 1);
@@ -798,6 +1092,7 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         ///assert
         num = VECTOR_size(handle);
         ASSERT_ARE_EQUAL(size_t, 1, num);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(handle));
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         ASSERT_IS_NULL(pfindItem);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -806,7 +1101,8 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
-    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements` and reduce its internal storage.] */
+    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements`.] */
+    /* Tests_SRS_VECTOR_99_003: [VECTOR_erase shall keep the internal storage and the capacity of the vector.] */
     TEST_FUNCTION(VECTOR_erase_succeeds_case_2)
     {
         ///arrange
@@ -819,8 +1115,6 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         (void)VECTOR_push_back(handle, &sItem2, 1);
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         umock_c_reset_all_calls();
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument_ptr();
 
         ///act
         VECTOR_erase(handle, pfindItem, 2);
@@ -828,6 +1122,7 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         ///assert
         num = VECTOR_size(handle);
         ASSERT_ARE_EQUAL(size_t, 0, num);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(handle));
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         ASSERT_IS_NULL(pfindItem);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -836,23 +1131,22 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
-    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements` and reduce its internal storage.] */
+    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements`.] */
+    /* Tests_SRS_VECTOR_99_003: [VECTOR_erase shall keep the internal storage and the capacity of the vector.] */
     TEST_FUNCTION(VECTOR_erase_succeeds_case_3)
     {
         ///arrange
 		size_t num;
 		VECTOR_UNITTEST* pfindItem;
+		void* storage;
         VECTOR_UNITTEST sItem1 = {1, 2};
         VECTOR_UNITTEST sItem2 = {3, 4};
         VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
         (void)VECTOR_push_back(handle, &sItem1, 1);
         (void)VECTOR_push_back(handle, &sItem2, 1);
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
+        storage = VECTOR_front(handle);
         umock_c_reset_all_calls();
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG))
-            .IgnoreArgument_ptr()
-            .IgnoreArgument_size()
-            .SetReturn(NULL);
 
         ///act
         VECTOR_erase(handle, pfindItem, 1);
@@ -864,6 +1158,7 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         ASSERT_IS_NULL(pfindItem);
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem2);
         ASSERT_IS_NOT_NULL(pfindItem);
+        ASSERT_ARE_EQUAL(void_ptr, storage, pfindItem);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -998,6 +1293,7 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
+    /* Tests_SRS_VECTOR_99_002: [When it grows the internal storage, VECTOR_push_back shall at least double its capacity.] */
     TEST_FUNCTION(VECTOR_push_back_multiple_elements_succeeds)
     {
         ///arrange
@@ -1007,9 +1303,9 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_UNITTEST sItem1 = {1, 2};
         VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
         umock_c_reset_all_calls();
-        for (nIndex = 0; nIndex < NUM_ITEM_PUSH_BACK; nIndex++)
+        for (nIndex = 1; nIndex <= NUM_ITEM_PUSH_BACK; nIndex *= 2)
         {
-            STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, (nIndex + 1) * sizeof(VECTOR_UNITTEST)))
+            STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, nIndex * sizeof(VECTOR_UNITTEST)))
                 .IgnoreArgument_ptr();
         }
 
@@ -1033,6 +1329,223 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
+    /* Tests_SRS_VECTOR_99_005: [VECTOR_capacity shall return 0 if the given handle is NULL.] */
+    TEST_FUNCTION(VECTOR_capacity_fails_if_handle_is_NULL)
+    {
+        ///arrange
+        size_t num;
+
+        ///act
+        num = VECTOR_capacity(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, num);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_99_004: [VECTOR_capacity shall return the number of elements the internal storage has room for.] */
+    TEST_FUNCTION(VECTOR_capacity_succeeds)
+    {
+        ///arrange
+        size_t num;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        num = VECTOR_capacity(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 4, num);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_006: [VECTOR_reserve shall fail and return non-zero if `handle` is NULL.] */
+    TEST_FUNCTION(VECTOR_reserve_fails_if_handle_is_NULL)
+    {
+        ///arrange
+        int result;
+
+        ///act
+        result = VECTOR_reserve(NULL, 4);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_99_008: [Otherwise VECTOR_reserve shall grow the internal storage to room for exactly `numElements` elements and return 0.] */
+    TEST_FUNCTION(VECTOR_reserve_succeeds)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 10 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_reserve(handle, 10);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 10, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(int, 1, ((VECTOR_UNITTEST*)VECTOR_front(handle))->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_007: [If the capacity is already at least `numElements`, VECTOR_reserve shall leave the vector unchanged and return 0.] */
+    TEST_FUNCTION(VECTOR_reserve_does_nothing_if_capacity_is_enough)
+    {
+        ///arrange
+        int result;
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_reserve(handle, 10);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_reserve(handle, 5);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 10, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_009: [VECTOR_reserve shall fail and return non-zero if memory allocation fails, leaving the vector unchanged.] */
+    TEST_FUNCTION(VECTOR_reserve_fails_if_realloc_fails)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 10 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr()
+            .SetReturn(NULL);
+
+        ///act
+        result = VECTOR_reserve(handle, 10);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_010: [VECTOR_shrink_to_fit shall fail and return non-zero if `handle` is NULL.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_fails_if_handle_is_NULL)
+    {
+        ///arrange
+        int result;
+
+        ///act
+        result = VECTOR_shrink_to_fit(NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_99_012: [Otherwise VECTOR_shrink_to_fit shall reduce the internal storage to room for exactly the elements of the vector and return 0.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_succeeds)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_reserve(handle, 10);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_shrink_to_fit(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_011: [If the vector is empty, VECTOR_shrink_to_fit shall release the internal storage and return 0.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_releases_the_storage_of_an_empty_vector)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        VECTOR_erase(handle, VECTOR_front(handle), 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_shrink_to_fit(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 0, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_99_013: [VECTOR_shrink_to_fit shall fail and return non-zero if memory allocation fails, leaving the vector unchanged.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_fails_if_realloc_fails)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = {1, 2};
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_reserve(handle, 10);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr()
+            .SetReturn(NULL);
+
+        ///act
+        result = VECTOR_shrink_to_fit(handle);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 10, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
     /* Vector_Tests END */
 
 END_TEST_SUITE(Vector_UnitTests)
@@ -21,18 +21,13 @@
 
 #include "azure_c_shared_utility/xio.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
-#include "azure_c_shared_utility/singlylinkedlist.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_c_shared_utility/uws_client.h"
 
-static const void** list_items = NULL;
-static size_t list_item_count = 0;
 static const char* TEST_HOST_ADDRESS = "host_address.com";
 static const char* TEST_RESOURCE_NAME = "/test_resource";
 static const char* TEST_PROTOCOL = "test_proto";
 
-static const SINGLYLINKEDLIST_HANDLE TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE = (SINGLYLINKEDLIST_HANDLE)0x4242;
-static const LIST_ITEM_HANDLE TEST_LIST_ITEM_HANDLE = (LIST_ITEM_HANDLE)0x11;
 static const UWS_CLIENT_HANDLE TEST_UWS_HANDLE = (UWS_CLIENT_HANDLE)0x4243;
 static const XIO_HANDLE TEST_UNDERLYING_IO_HANDLE = (XIO_HANDLE)0x4244;
 static const OPTIONHANDLER_HANDLE TEST_OPTIONHANDLER_HANDLE = (OPTIONHANDLER_HANDLE)0x4246;
@@ -81,75 +76,6 @@ static void my_gballoc_free(void* ptr)
     free(ptr);
 }
 
-static LIST_ITEM_HANDLE add_to_list(const void* item)
-{
-    const void** items = (const void**)realloc((void*)list_items, (list_item_count + 1) * sizeof(item));
-    if (items != NULL)
-    {
-        list_items = items;
-        list_items[list_item_count++] = item;
-    }
-    return (LIST_ITEM_HANDLE)list_item_count;
-}
-
-static int singlylinkedlist_remove_result;
-
-static int my_singlylinkedlist_remove(SINGLYLINKEDLIST_HANDLE list, LIST_ITEM_HANDLE item)
-{
-    size_t index = (size_t)item - 1;
-    (void)list;
-    (void)memmove((void*)&list_items[index], &list_items[index + 1], sizeof(const void*) * (list_item_count - index - 1));
-    list_item_count--;
-    if (list_item_count == 0)
-    {
-        free((void*)list_items);
-        list_items = NULL;
-    }
-    return singlylinkedlist_remove_result;
-}
-
-static LIST_ITEM_HANDLE my_singlylinkedlist_get_head_item(SINGLYLINKEDLIST_HANDLE list)
-{
-    LIST_ITEM_HANDLE list_item_handle = NULL;
-    (void)list;
-    if (list_item_count > 0)
-    {
-        list_item_handle = (LIST_ITEM_HANDLE)1;
-    }
-    else
-    {
-        list_item_handle = NULL;
-    }
-    return list_item_handle;
-}
-
-static LIST_ITEM_HANDLE my_singlylinkedlist_add(SINGLYLINKEDLIST_HANDLE list, const void* item)
-{
-    (void)list;
-    return add_to_list(item);
-}
-
-static const void* my_singlylinkedlist_item_get_value(LIST_ITEM_HANDLE item_handle)
-{
-    return (const void*)list_items[(size_t)item_handle - 1];
-}
-
-static LIST_ITEM_HANDLE my_singlylinkedlist_find(SINGLYLINKEDLIST_HANDLE handle, LIST_MATCH_FUNCTION match_function, const void* match_context)
-{
-    size_t i;
-    const void* found_item = NULL;
-    (void)handle;
-    for (i = 0; i < list_item_count; i++)
-    {
-        if (match_function((LIST_ITEM_HANDLE)list_items[i], match_context))
-        {
-            found_item = list_items[i];
-            break;
-        }
-    }
-    return (LIST_ITEM_HANDLE)found_item;
-}
-
 int my_mallocAndStrcpy_s(char** destination, const char* source)
 {
     *destination = (char*)malloc(strlen(source) + 1);
@@ -223,6 +149,9 @@ static int my_uws_close_async(UWS_CLIENT_HANDLE uws, ON_WS_CLOSE_COMPLETE on_ws_
     return 0;
 }
 
+static int g_uws_send_frame_async_result;
+static bool g_uws_send_frame_completes_inline;
+
 static int my_uws_send_frame_async(UWS_CLIENT_HANDLE uws, unsigned char frame_type, const unsigned char* buffer, size_t size, bool is_final, ON_WS_SEND_FRAME_COMPLETE on_ws_send_frame_complete, void* on_ws_send_frame_complete_context)
 {
     (void)uws;
@@ -232,7 +161,11 @@ static int my_uws_send_frame_async(UWS_CLIENT_HANDLE uws, unsigned char frame_ty
     (void)frame_type;
     g_on_ws_send_frame_complete = on_ws_send_frame_complete;
     g_on_ws_send_frame_complete_context = on_ws_send_frame_complete_context;
-    return 0;
+    if (g_uws_send_frame_completes_inline)
+    {
+        on_ws_send_frame_complete(on_ws_send_frame_complete_context, WS_SEND_FRAME_ERROR);
+    }
+    return g_uws_send_frame_async_result;
 }
 
 static WSIO_CONFIG default_wsio_config;
@@ -275,12 +208,6 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
-    REGISTER_GLOBAL_MOCK_RETURN(singlylinkedlist_create, TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE);
-    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_remove, my_singlylinkedlist_remove);
-    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_get_head_item, my_singlylinkedlist_get_head_item);
-    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_add, my_singlylinkedlist_add);
-    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_item_get_value, my_singlylinkedlist_item_get_value);
-    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_find, my_singlylinkedlist_find);
     REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, my_mallocAndStrcpy_s);
     REGISTER_GLOBAL_MOCK_HOOK(uws_client_open_async, my_uws_open_async);
     REGISTER_GLOBAL_MOCK_HOOK(uws_client_close_async, my_uws_close_async);
@@ -296,8 +223,6 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_TYPE(IO_SEND_RESULT, IO_SEND_RESULT);
     REGISTER_TYPE(OPTIONHANDLER_RESULT, OPTIONHANDLER_RESULT);
 
-    REGISTER_UMOCK_ALIAS_TYPE(SINGLYLINKEDLIST_HANDLE, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(LIST_ITEM_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(UWS_CLIENT_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_WS_OPEN_COMPLETE, void*);
@@ -331,7 +256,8 @@ TEST_FUNCTION_INITIALIZE(method_init)
 
     currentmalloc_call = 0;
     whenShallmalloc_fail = 0;
-    singlylinkedlist_remove_result = 0;
+    g_uws_send_frame_async_result = 0;
+    g_uws_send_frame_completes_inline = false;
 }
 
 TEST_FUNCTION_CLEANUP(method_cleanup)
@@ -351,7 +277,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 /* Tests_SRS_WSIO_01_130: [ - `port` set to the `port` field in the `io_create_parameters` passed to `wsio_create`. ]*/
 /* Tests_SRS_WSIO_01_128: [ - `resource_name` set to the `resource_name` field in the `io_create_parameters` passed to `wsio_create`. ]*/
 /* Tests_SRS_WSIO_01_129: [ - `protocols` shall be filled with only one structure, that shall have the `protocol` set to the value of the `protocol` field in the `io_create_parameters` passed to `wsio_create`. ]*/
-/* Tests_SRS_WSIO_01_076: [ `wsio_create` shall create a pending send IO list that is to be used to queue send packets by calling `singlylinkedlist_create`. ]*/
+/* Tests_SRS_WSIO_01_076: [ `wsio_create` shall initialize the pending send IO list that is to be used to queue send packets by calling `DList_InitializeListHead`. ]*/
 TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds)
 {
 	// arrange
@@ -359,7 +285,6 @@ TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds)
     
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(uws_client_create_with_io(TEST_UNDERLYING_IO_INTERFACE, TEST_UNDERLYING_IO_PARAMETERS, TEST_HOST_ADDRESS, 443, TEST_RESOURCE_NAME, IGNORED_PTR_ARG, 1));
-    STRICT_EXPECTED_CALL(singlylinkedlist_create());
 
 	// act
     wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
@@ -485,27 +410,6 @@ TEST_FUNCTION(when_uws_create_fails_then_wsio_create_fails)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_WSIO_01_077: [ If `singlylinkedlist_create` fails then `wsio_create` shall fail and return NULL. ]*/
-TEST_FUNCTION(when_singlylinkedlist_create_fails_then_wsio_create_fails)
-{
-    // arrange
-    CONCRETE_IO_HANDLE wsio;
-
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
-    STRICT_EXPECTED_CALL(uws_client_create_with_io(TEST_UNDERLYING_IO_INTERFACE, TEST_UNDERLYING_IO_PARAMETERS, TEST_HOST_ADDRESS, 443, TEST_RESOURCE_NAME, IGNORED_PTR_ARG, 1));
-    STRICT_EXPECTED_CALL(singlylinkedlist_create())
-        .SetReturn(NULL);
-    STRICT_EXPECTED_CALL(uws_client_destroy(TEST_UWS_HANDLE));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
-
-    // act
-    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
-
-    // assert
-    ASSERT_IS_NULL(wsio);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-}
-
 /* Tests_SRS_WSIO_01_071: [ The arguments for `uws_client_create_with_io` shall be: ]*/
 /* Tests_SRS_WSIO_01_185: [ - `underlying_io_interface` shall be set to the `underlying_io_interface` field in the `io_create_parameters` passed to `wsio_create`. ]*/
 /* Tests_SRS_WSIO_01_186: [ - `underlying_io_parameters` shall be set to the `underlying_io_parameters` field in the `io_create_parameters` passed to `wsio_create`. ]*/
@@ -528,7 +432,6 @@ TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds_2)
 
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(uws_client_create_with_io(TEST_UNDERLYING_IO_INTERFACE, NULL, "another.com", 80, "haga", IGNORED_PTR_ARG, 1));
-    STRICT_EXPECTED_CALL(singlylinkedlist_create());
 
     // act
     wsio = wsio_get_interface_description()->concrete_io_create(&wsio_config);
@@ -545,7 +448,6 @@ TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds_2)
 
 /* Tests_SRS_WSIO_01_078: [ `wsio_destroy` shall free all resources associated with the wsio instance. ]*/
 /* Tests_SRS_WSIO_01_080: [ `wsio_destroy` shall destroy the uws instance created in `wsio_create` by calling `uws_client_destroy`. ]*/
-/* Tests_SRS_WSIO_01_081: [ `wsio_destroy` shall free the list used to track the pending send IOs by calling `singlylinkedlist_destroy`. ]*/
 TEST_FUNCTION(wsio_destroy_frees_all_resources)
 {
     // arrange
@@ -554,7 +456,6 @@ TEST_FUNCTION(wsio_destroy_frees_all_resources)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(uws_client_destroy(TEST_UWS_HANDLE));
-    STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
@@ -797,7 +698,7 @@ TEST_FUNCTION(wsio_open_when_closing_fails)
 /* Tests_SRS_WSIO_01_133: [ On success `wsio_close` shall return 0. ]*/
 /* Tests_SRS_WSIO_01_091: [ `wsio_close` shall obtain all the pending IO items by repetitively querying for the head of the pending IO list and freeing that head item. ]*/
 /* Tests_SRS_WSIO_01_087: [ `wsio_close` shall call `uws_client_close_async` while passing as argument the IO handle created in `wsio_create`.  ]*/
-/* Tests_SRS_WSIO_01_092: [ Obtaining the head of the pending IO list shall be done by calling `singlylinkedlist_get_head_item`. ]*/
+/* Tests_SRS_WSIO_01_092: [ `wsio_close` shall stop when `DList_IsListEmpty` indicates that the pending IO list is empty. ]*/
 /* Tests_SRS_WSIO_01_094: [ The callback context passed to the `on_send_complete` callback shall be the context given to `wsio_send`.  ]*/
 TEST_FUNCTION(wsio_close_when_IO_is_open_closes_the_uws)
 {
@@ -810,7 +711,6 @@ TEST_FUNCTION(wsio_close_when_IO_is_open_closes_the_uws)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(uws_client_close_async(TEST_UWS_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
     result = wsio_get_interface_description()->concrete_io_close(wsio, test_on_io_close_complete, (void*)0x4245);
@@ -916,7 +816,6 @@ TEST_FUNCTION(when_uws_close_fails_then_wsio_close_fails)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(uws_client_close_async(TEST_UWS_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
     result = wsio_get_interface_description()->concrete_io_close(wsio, test_on_io_close_complete, (void*)0x4245);
@@ -941,7 +840,6 @@ TEST_FUNCTION(wsio_close_with_NULL_close_complete_callback_succeeds)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(uws_client_close_async(TEST_UWS_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
     result = wsio_get_interface_description()->concrete_io_close(wsio, NULL, NULL);
@@ -969,12 +867,8 @@ TEST_FUNCTION(wsio_close_indicates_a_pending_send_as_CANCELLED)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(uws_client_close_async(TEST_UWS_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
-    EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
     result = wsio_get_interface_description()->concrete_io_close(wsio, NULL, NULL);
@@ -1003,17 +897,10 @@ TEST_FUNCTION(wsio_close_indicates_2_pending_sends_as_CANCELLED)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(uws_client_close_async(TEST_UWS_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
-    EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
-    EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
     result = wsio_get_interface_description()->concrete_io_close(wsio, NULL, NULL);
@@ -1031,7 +918,7 @@ TEST_FUNCTION(wsio_close_indicates_2_pending_sends_as_CANCELLED)
 /* Tests_SRS_WSIO_01_095: [ `wsio_send` shall call `uws_client_send_frame_async`, passing the `buffer` and `size` arguments as they are: ]*/
 /* Tests_SRS_WSIO_01_097: [ The `is_final` argument shall be set to true. ]*/
 /* Tests_SRS_WSIO_01_098: [ On success, `wsio_send` shall return 0. ]*/
-/* Tests_SRS_WSIO_01_102: [ An entry shall be queued in the singly linked list by calling `singlylinkedlist_add`. ]*/
+/* Tests_SRS_WSIO_01_102: [ The entry shall be queued at the end of the pending IO list by calling `DList_InsertTailList`. ]*/
 /* Tests_SRS_WSIO_01_103: [ The entry shall contain the `on_send_complete` callback and its context. ]*/
 /* Tests_SRS_WSIO_01_096: [ The frame type used shall be `WS_FRAME_TYPE_BINARY`. ]*/
 TEST_FUNCTION(wsio_send_with_1_byte_calls_uws_send_frame)
@@ -1047,7 +934,6 @@ TEST_FUNCTION(wsio_send_with_1_byte_calls_uws_send_frame)
     umock_c_reset_all_calls();
 
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(uws_client_send_frame_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, IGNORED_PTR_ARG, sizeof(test_buffer), true, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .ValidateArgumentBuffer(3, test_buffer, sizeof(test_buffer));
 
@@ -1223,8 +1109,9 @@ TEST_FUNCTION(when_allocating_memory_for_the_pending_send_fails_wsio_send_fails)
     wsio_get_interface_description()->concrete_io_destroy(wsio);
 }
 
-/* Tests_SRS_WSIO_01_104: [ If `singlylinkedlist_add` fails, `wsio_send` shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(when_adding_the_pending_item_to_the_list_fails_wsio_send_fails)
+/* Tests_SRS_WSIO_99_001: [ If `uws_client_send_frame_async` fails and the pending IO is still queued, it shall be removed from the list and freed. ]*/
+/* Tests_SRS_WSIO_99_002: [ If `uws_client_send_frame_async` fails, `wsio_send` shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_uws_client_send_frame_async_fails_wsio_send_fails)
 {
     // arrange
     CONCRETE_IO_HANDLE wsio;
@@ -1237,10 +1124,46 @@ TEST_FUNCTION(when_adding_the_pending_item_to_the_list_fails_wsio_send_fails)
     umock_c_reset_all_calls();
 
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
-        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(uws_client_send_frame_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, IGNORED_PTR_ARG, sizeof(test_buffer), true, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .ValidateArgumentBuffer(3, test_buffer, sizeof(test_buffer));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    g_uws_send_frame_async_result = 1;
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send(wsio, test_buffer, sizeof(test_buffer), test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
+/* Tests_SRS_WSIO_99_001: [ If `uws_client_send_frame_async` fails and the pending IO is still queued, it shall be removed from the list and freed. ]*/
+/* Tests_SRS_WSIO_99_002: [ If `uws_client_send_frame_async` fails, `wsio_send` shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_uws_client_send_frame_async_completes_the_send_and_fails_wsio_send_frees_the_pending_io_only_once)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+    unsigned char test_buffer[] = { 42 };
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    (void)wsio_get_interface_description()->concrete_io_open(wsio, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(uws_client_send_frame_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, IGNORED_PTR_ARG, sizeof(test_buffer), true, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .ValidateArgumentBuffer(3, test_buffer, sizeof(test_buffer));
+    STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_ERROR));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
+    g_uws_send_frame_async_result = 1;
+    g_uws_send_frame_completes_inline = true;
+
     // act
     result = wsio_get_interface_description()->concrete_io_send(wsio, test_buffer, sizeof(test_buffer), test_on_send_complete, (void*)0x4343);
 
@@ -1252,6 +1175,38 @@ TEST_FUNCTION(when_adding_the_pending_item_to_the_list_fails_wsio_send_fails)
     wsio_get_interface_description()->concrete_io_destroy(wsio);
 }
 
+/* Tests_SRS_WSIO_99_003: [ If the uws instance completes the send from within `uws_client_send_frame_async`, the pending IO shall be freed once `uws_client_send_frame_async` returns. ]*/
+TEST_FUNCTION(when_uws_client_send_frame_async_completes_the_send_inline_wsio_send_frees_the_pending_io_after_it)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+    int result;
+    unsigned char test_buffer[] = { 42 };
+
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+    (void)wsio_get_interface_description()->concrete_io_open(wsio, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(uws_client_send_frame_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, IGNORED_PTR_ARG, sizeof(test_buffer), true, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .ValidateArgumentBuffer(3, test_buffer, sizeof(test_buffer));
+    STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_ERROR));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    g_uws_send_frame_completes_inline = true;
+
+    // act
+    result = wsio_get_interface_description()->concrete_io_send(wsio, test_buffer, sizeof(test_buffer), test_on_send_complete, (void*)0x4343);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
 /* Tests_SRS_WSIO_01_105: [ The argument `on_send_complete` shall be optional, if NULL is passed by the caller then no send complete callback shall be triggered. ]*/
 TEST_FUNCTION(wsio_send_with_NULL_send_complete_callback_succeeds)
 {
@@ -1266,7 +1221,6 @@ TEST_FUNCTION(wsio_send_with_NULL_send_complete_callback_succeeds)
     umock_c_reset_all_calls();
 
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(uws_client_send_frame_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, IGNORED_PTR_ARG, sizeof(test_buffer), true, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .ValidateArgumentBuffer(3, test_buffer, sizeof(test_buffer));
 
@@ -1828,7 +1782,7 @@ TEST_FUNCTION(when_on_underlying_ws_frame_received_is_called_with_positive_size_
 /* on_underlying_ws_send_frame_complete */
 
 /* Tests_SRS_WSIO_01_143: [ When `on_underlying_ws_send_frame_complete` is called after sending a WebSocket frame, the pending IO shall be removed from the list. ]*/
-/* Tests_SRS_WSIO_01_145: [ Removing it from the list shall be done by calling `singlylinkedlist_remove`. ]*/
+/* Tests_SRS_WSIO_01_145: [ Removing it from the list shall be done by calling `DList_RemoveEntryList`. ]*/
 /* Tests_SRS_WSIO_01_144: [ Also the pending IO data shall be freed. ]*/
 /* Tests_SRS_WSIO_01_146: [ When `on_underlying_ws_send_frame_complete` is called with `WS_SEND_OK`, the callback `on_send_complete` shall be called with `IO_SEND_OK`. ]*/
 TEST_FUNCTION(wsio_send_with_1_byte_completed_indicates_the_completion_up)
@@ -1843,8 +1797,6 @@ TEST_FUNCTION(wsio_send_with_1_byte_completed_indicates_the_completion_up)
     (void)wsio_get_interface_description()->concrete_io_send(wsio, test_buffer, sizeof(test_buffer), test_on_send_complete, (void*)0x4343);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_OK));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
@@ -1871,8 +1823,6 @@ TEST_FUNCTION(wsio_send_with_1_byte_completed_with_CANCELLED_indicates_the_compl
     (void)wsio_get_interface_description()->concrete_io_send(wsio, test_buffer, sizeof(test_buffer), test_on_send_complete, (void*)0x4343);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
@@ -1899,8 +1849,6 @@ TEST_FUNCTION(wsio_send_with_1_byte_completed_with_ERROR_indicates_the_completio
     (void)wsio_get_interface_description()->concrete_io_send(wsio, test_buffer, sizeof(test_buffer), test_on_send_complete, (void*)0x4343);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_ERROR));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 